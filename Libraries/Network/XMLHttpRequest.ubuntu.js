@@ -31,6 +31,10 @@ class XMLHttpRequest extends XMLHttpRequestBase {
       data = {string: data};
     } else if (data instanceof FormData) {
       data = {formData: data.getParts()};
+    } else if (data && typeof data.uri === 'string') {
+      // File uploads reference a native path; the body streams from disk on
+      // the native side instead of crossing the bridge.
+      data = {file: data.uri.replace(/^file:\/\//, '')};
     }
 
     RCTNetworking.sendRequest(
@@ -61,10 +61,16 @@ class MessageQueue {
     this._lastFlush = 0;
     this._eventLoopStartTime = new Date().getTime();
 
+    this._surfaces = {};
+    this._surfaceId = null;
+
     [
       'invokeCallbackAndReturnFlushedQueue',
       'callFunctionReturnFlushedQueue',
+      'processBatchReturnFlushedQueue',
       'flushedQueue',
+      'callFunctionReturnFlushedQueueForSurface',
+      'invokeCallbackAndReturnFlushedQueueForSurface',
     ].forEach((fn) => this[fn] = this[fn].bind(this));
 
     let modulesConfig = this._genModulesConfig(remoteModules);
@@ -93,6 +99,20 @@ class MessageQueue {
     return this.flushedQueue();
   }
 
+  processBatchReturnFlushedQueue(batch) {
+    // batch is an array of [module, method, args] triples. Executors that pay
+    // a fixed cost per call into JS (e.g. the proxy executor's JNI hop) use
+    // this to land a whole batch in one crossing.
+    guard(() => {
+      batch.forEach(
+        (call) => this.__callFunction(call[0], call[1], call[2])
+      );
+      this.__callImmediates();
+    });
+
+    return this.flushedQueue();
+  }
+
   invokeCallbackAndReturnFlushedQueue(cbID, args) {
     guard(() => {
       this.__invokeCallback(cbID, args);
@@ -110,6 +130,45 @@ class MessageQueue {
     return queue[0].length ? queue : null;
   }
 
+  /**
+   * Shared-VM surfaces: a surface is another MessageQueue living in this VM
+   * with its own module registries, registered here under the surface id
+   * native assigned it. Native addresses a surface through the ...ForSurface
+   * entry points below and routes each returned queue to that surface's own
+   * bridge callback, so two React roots share one VM without sharing module
+   * tables or callbacks.
+   */
+  registerSurface(surfaceId, queue) {
+    this._surfaces[surfaceId] = queue;
+    queue._surfaceId = surfaceId;
+  }
+
+  unregisterSurface(surfaceId) {
+    const queue = this._surfaces[surfaceId];
+    if (queue) {
+      queue._surfaceId = null;
+    }
+    delete this._surfaces[surfaceId];
+  }
+
+  callFunctionReturnFlushedQueueForSurface(surfaceId, module, method, args) {
+    const queue = this._surfaces[surfaceId];
+    if (!queue) {
+      // Calls can be in flight while a surface registers or tears down;
+      // native treats a null queue as an empty batch.
+      return null;
+    }
+    return queue.callFunctionReturnFlushedQueue(module, method, args);
+  }
+
+  invokeCallbackAndReturnFlushedQueueForSurface(surfaceId, cbID, args) {
+    const queue = this._surfaces[surfaceId];
+    if (!queue) {
+      return null;
+    }
+    return queue.invokeCallbackAndReturnFlushedQueue(cbID, args);
+  }
+
   processModuleConfig(config, moduleID) {
     const module = this._genModule(config, moduleID);
     this._genLookup(config, moduleID, this._remoteModuleTable, this._remoteMethodTable);
@@ -147,14 +206,29 @@ class MessageQueue {
       global.nativeTraceBeginAsyncFlow(TRACE_TAG_REACT_APPS, 'native', this._callID);
     this._callID++;
 
+    let queueWasEmpty = this._queue[MODULE_IDS].length === 0;
     this._queue[MODULE_IDS].push(module);
     this._queue[METHOD_IDS].push(method);
     this._queue[PARAMS].push(params);
 
+    // Tell native there's work queued so it can skip flushedQueue()
+    // evaluations while the queue stays empty; only the empty -> non-empty
+    // transition needs signaling. Surface queues aren't drained by
+    // flushedQueue(), so only the host queue signals.
+    if (queueWasEmpty && this._surfaceId == null &&
+        global.nativeCallQueueHasPending) {
+      global.nativeCallQueueHasPending();
+    }
+
     var now = new Date().getTime();
     if (global.nativeFlushQueueImmediate &&
         now - this._lastFlush >= MIN_TIME_BETWEEN_FLUSHES_MS) {
-      global.nativeFlushQueueImmediate(this._queue);
+      if (this._surfaceId != null) {
+        // Tagged flush so native routes the batch to this surface's bridge.
+        global.nativeFlushQueueImmediate(this._queue, this._surfaceId);
+      } else {
+        global.nativeFlushQueueImmediate(this._queue);
+      }
       this._queue = [[], [], [], this._callID];
       this._lastFlush = now;
     }
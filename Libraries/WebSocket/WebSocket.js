@@ -149,16 +149,25 @@ class WebSocket extends EventTarget(...WEBSOCKET_EVENTS) {
     this._subscriptions = [];
   }
 
+  _handleMessage(ev: any): void {
+    if (ev.id !== this._socketId) {
+      return;
+    }
+    var event = new WebSocketEvent('message', {
+      data: (ev.type === 'binary') ? base64.toByteArray(ev.data).buffer : ev.data
+    });
+    this.dispatchEvent(event);
+  }
+
   _registerEvents(): void {
     this._subscriptions = [
       RCTDeviceEventEmitter.addListener('websocketMessage', ev => {
-        if (ev.id !== this._socketId) {
-          return;
-        }
-        var event = new WebSocketEvent('message', {
-          data: (ev.type === 'binary') ? base64.toByteArray(ev.data).buffer : ev.data
-        });
-        this.dispatchEvent(event);
+        this._handleMessage(ev);
+      }),
+      // Platforms that batch receive-side frames deliver a burst of messages
+      // as one coalesced event to save bridge crossings.
+      RCTDeviceEventEmitter.addListener('websocketMessages', evs => {
+        evs.forEach(ev => this._handleMessage(ev));
       }),
       RCTDeviceEventEmitter.addListener('websocketOpen', ev => {
         if (ev.id !== this._socketId) {
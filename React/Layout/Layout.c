@@ -24,6 +24,21 @@
  #include <stdlib.h>
  #include <string.h>
 
+ #if defined(__SSE__)
+ #include <xmmintrin.h>
+ #elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+ #include <arm_neon.h>
+ #endif
+
+ #if !defined(__STDC_NO_ATOMICS__) && !defined(_MSC_VER)
+ #include <stdatomic.h>
+ #endif
+
+ #if defined(__unix__) || defined(__APPLE__)
+ #define CSS_HAS_PTHREADS 1
+ #include <pthread.h>
+ #endif
+
  // in concatenated header, don't include Layout.h it's already at the top
  #ifndef CSS_LAYOUT_IMPLEMENTATION
  #include "Layout.h"
@@ -41,8 +56,13 @@
  #endif
  #endif
 
+ // The undefined sentinel is NaN, and every NaN has an all-ones exponent, so
+ // the check compiles to one integer compare instead of an FP-pipeline isnan
+ // call; this runs on every style read in the hot loops.
  bool isUndefined(float value) {
-   return isnan(value);
+   unsigned int bits;
+   memcpy(&bits, &value, sizeof(bits));
+   return (bits & 0x7FFFFFFFu) > 0x7F800000u;
  }
 
  static bool eq(float a, float b) {
@@ -91,6 +111,11 @@
    node->layout.last_parent_max_height = -1;
    node->layout.last_direction = (css_direction_t)-1;
    node->layout.should_update = true;
+
+   // Undefined applied dimensions guarantee the first computed geometry
+   // always lands in the change list.
+   node->layout.applied_dimensions[CSS_WIDTH] = CSS_UNDEFINED;
+   node->layout.applied_dimensions[CSS_HEIGHT] = CSS_UNDEFINED;
  }
 
  css_node_t *new_css_node() {
@@ -103,6 +128,257 @@
    free(node);
  }
 
+ typedef struct css_arena_slab {
+   struct css_arena_slab *next;
+   int capacity;
+   int used;
+   css_node_t nodes[];
+ } css_arena_slab_t;
+
+ struct css_arena {
+   css_arena_slab_t *slabs;
+   int next_capacity;
+ };
+
+ static css_arena_slab_t *new_css_arena_slab(int capacity) {
+   css_arena_slab_t *slab = (css_arena_slab_t *)malloc(
+     sizeof(css_arena_slab_t) + capacity * sizeof(css_node_t));
+   slab->next = NULL;
+   slab->capacity = capacity;
+   slab->used = 0;
+   return slab;
+ }
+
+ css_arena_t *new_css_arena(int initial_capacity) {
+   css_arena_t *arena = (css_arena_t *)malloc(sizeof(css_arena_t));
+   if (initial_capacity < 1) {
+     initial_capacity = 64;
+   }
+   arena->slabs = new_css_arena_slab(initial_capacity);
+   arena->next_capacity = initial_capacity * 2;
+   return arena;
+ }
+
+ css_node_t *css_arena_new_node(css_arena_t *arena) {
+   if (arena->slabs->used == arena->slabs->capacity) {
+     // Full slabs stay where they are; the nodes in them remain valid.
+     css_arena_slab_t *slab = new_css_arena_slab(arena->next_capacity);
+     arena->next_capacity *= 2;
+     slab->next = arena->slabs;
+     arena->slabs = slab;
+   }
+   css_node_t *node = &arena->slabs->nodes[arena->slabs->used++];
+   memset(node, 0, sizeof(*node));
+   init_css_node(node);
+   return node;
+ }
+
+ void reset_css_arena(css_arena_t *arena) {
+   for (css_arena_slab_t *slab = arena->slabs; slab != NULL; slab = slab->next) {
+     slab->used = 0;
+   }
+ }
+
+ void free_css_arena(css_arena_t *arena) {
+   css_arena_slab_t *slab = arena->slabs;
+   while (slab != NULL) {
+     css_arena_slab_t *next = slab->next;
+     free(slab);
+     slab = next;
+   }
+   free(arena);
+ }
+
+ typedef struct css_flat_ctx {
+   css_flat_tree_t *tree;
+   int first_child;
+   bool dirty;
+   css_dim_t (*measure)(void *context, float width, css_measure_mode_t widthMode, float height, css_measure_mode_t heightMode);
+   void *measure_context;
+ } css_flat_ctx_t;
+
+ struct css_flat_tree {
+   int count;
+   css_node_t *nodes;        // breadth-first; a node's children are contiguous
+   css_flat_ctx_t *contexts; // parallel to nodes
+   css_node_t **originals;   // parallel to nodes
+   css_layout_change_t *changes;
+   int change_count;
+ };
+
+ static css_node_t *css_flat_get_child(void *context, int i) {
+   css_flat_ctx_t *ctx = (css_flat_ctx_t *)context;
+   return &ctx->tree->nodes[ctx->first_child + i];
+ }
+
+ static bool css_flat_is_dirty(void *context) {
+   return ((css_flat_ctx_t *)context)->dirty;
+ }
+
+ // Measure callbacks belong to the original node's owner; forward with the
+ // original context.
+ static css_dim_t css_flat_measure(void *context, float width, css_measure_mode_t widthMode, float height, css_measure_mode_t heightMode) {
+   css_flat_ctx_t *ctx = (css_flat_ctx_t *)context;
+   return ctx->measure(ctx->measure_context, width, widthMode, height, heightMode);
+ }
+
+ static int css_count_nodes(css_node_t *node) {
+   int count = 1;
+   for (int i = 0; i < node->children_count; i++) {
+     count += css_count_nodes(node->get_child(node->context, i));
+   }
+   return count;
+ }
+
+ css_flat_tree_t *new_css_flat_tree(css_node_t *root) {
+   css_flat_tree_t *tree = (css_flat_tree_t *)malloc(sizeof(css_flat_tree_t));
+   tree->count = css_count_nodes(root);
+   tree->nodes = (css_node_t *)malloc(tree->count * sizeof(css_node_t));
+   tree->contexts = (css_flat_ctx_t *)malloc(tree->count * sizeof(css_flat_ctx_t));
+   tree->originals = (css_node_t **)malloc(tree->count * sizeof(css_node_t *));
+   tree->changes = (css_layout_change_t *)malloc(tree->count * sizeof(css_layout_change_t));
+   tree->change_count = 0;
+
+   // Breadth-first placement: walking the array in order visits each node
+   // before its children, and every node's children end up adjacent.
+   tree->originals[0] = root;
+   int used = 1;
+   for (int i = 0; i < used; i++) {
+     css_node_t *original = tree->originals[i];
+     tree->contexts[i].tree = tree;
+     tree->contexts[i].first_child = used;
+     for (int c = 0; c < original->children_count; c++) {
+       tree->originals[used++] = original->get_child(original->context, c);
+     }
+   }
+   return tree;
+ }
+
+ void layout_css_flat_tree(css_flat_tree_t *tree, float maxWidth, float maxHeight, css_direction_t parentDirection) {
+   for (int i = 0; i < tree->count; i++) {
+     css_node_t *original = tree->originals[i];
+     css_node_t *node = &tree->nodes[i];
+     css_flat_ctx_t *ctx = &tree->contexts[i];
+
+     node->style = original->style;
+     node->layout = original->layout;
+     node->children_count = original->children_count;
+     node->line_index = original->line_index;
+     node->memoizable = original->memoizable;
+     node->next_absolute_child = NULL;
+     node->next_flex_child = NULL;
+     node->print = NULL;
+     node->get_child = css_flat_get_child;
+     node->is_dirty = css_flat_is_dirty;
+     node->context = ctx;
+     node->measure = original->measure ? css_flat_measure : NULL;
+     node->measure_thread_safe = original->measure_thread_safe;
+     memcpy(node->measure_cache, original->measure_cache, sizeof(node->measure_cache));
+     node->measure_cache_count = original->measure_cache_count;
+     ctx->measure = original->measure;
+     ctx->measure_context = original->context;
+     ctx->dirty = original->is_dirty ? original->is_dirty(original->context) : false;
+   }
+
+   layoutNodeBatched(&tree->nodes[0], maxWidth, maxHeight, parentDirection);
+   css_round_layout_results(&tree->nodes[0]);
+
+   // Copying the whole layout struct back keeps the incremental-layout cache
+   // fields coherent on the original nodes for the next pass; measure caches
+   // go back too so later passes keep their remembered results. Along the
+   // way the freshly computed geometry of every node this pass visited is
+   // diffed against the applied buffer to build the change list; unvisited
+   // nodes carry reset geometry and must not be diffed. Geometry on the
+   // originals then starts the next pass reset, as the old per-node apply
+   // walk left it.
+   tree->change_count = 0;
+   for (int i = 0; i < tree->count; i++) {
+     css_node_t *original = tree->originals[i];
+     css_node_t *node = &tree->nodes[i];
+     if (node->layout.should_update &&
+         (!eq(node->layout.position[CSS_LEFT], node->layout.applied_position[CSS_LEFT]) ||
+          !eq(node->layout.position[CSS_TOP], node->layout.applied_position[CSS_TOP]) ||
+          !eq(node->layout.dimensions[CSS_WIDTH], node->layout.applied_dimensions[CSS_WIDTH]) ||
+          !eq(node->layout.dimensions[CSS_HEIGHT], node->layout.applied_dimensions[CSS_HEIGHT]))) {
+       css_layout_change_t *change = &tree->changes[tree->change_count++];
+       change->node = original;
+       change->position[CSS_LEFT] = node->layout.position[CSS_LEFT];
+       change->position[CSS_TOP] = node->layout.position[CSS_TOP];
+       change->dimensions[CSS_WIDTH] = node->layout.dimensions[CSS_WIDTH];
+       change->dimensions[CSS_HEIGHT] = node->layout.dimensions[CSS_HEIGHT];
+     }
+     original->layout = node->layout;
+     original->layout.should_update = false;
+     original->layout.position[CSS_LEFT] = 0;
+     original->layout.position[CSS_TOP] = 0;
+     original->layout.dimensions[CSS_WIDTH] = CSS_UNDEFINED;
+     original->layout.dimensions[CSS_HEIGHT] = CSS_UNDEFINED;
+     memcpy(original->measure_cache, node->measure_cache, sizeof(node->measure_cache));
+     original->measure_cache_count = node->measure_cache_count;
+   }
+ }
+
+ // Units per pixel for grid rounding; 0 leaves geometry untouched.
+ static float css_layout_scale_factor = 0;
+
+ void css_layout_set_scale_factor(float scale) {
+   css_layout_scale_factor = scale;
+ }
+
+ static float roundToScale(float value, float scale) {
+   return roundf(value * scale) / scale;
+ }
+
+ // Edges are rounded in absolute coordinates rather than per-node local
+ // values: a node's right edge and its neighbour's left edge then land on
+ // the same grid line, so rounding never opens 1px seams between siblings
+ // and never lets local rounding errors accumulate down the tree.
+ static void roundLayoutResults(css_node_t *node, float absoluteLeft, float absoluteTop, float scale) {
+   float absLeft = absoluteLeft + node->layout.position[CSS_LEFT];
+   float absTop = absoluteTop + node->layout.position[CSS_TOP];
+   float absRight = absLeft + node->layout.dimensions[CSS_WIDTH];
+   float absBottom = absTop + node->layout.dimensions[CSS_HEIGHT];
+
+   node->layout.position[CSS_LEFT] =
+     roundToScale(absLeft, scale) - roundToScale(absoluteLeft, scale);
+   node->layout.position[CSS_TOP] =
+     roundToScale(absTop, scale) - roundToScale(absoluteTop, scale);
+   node->layout.dimensions[CSS_WIDTH] =
+     roundToScale(absRight, scale) - roundToScale(absLeft, scale);
+   node->layout.dimensions[CSS_HEIGHT] =
+     roundToScale(absBottom, scale) - roundToScale(absTop, scale);
+
+   for (int i = 0; i < node->children_count; i++) {
+     roundLayoutResults(node->get_child(node->context, i), absLeft, absTop, scale);
+   }
+ }
+
+ void css_round_layout_results(css_node_t *node) {
+   if (css_layout_scale_factor > 0) {
+     roundLayoutResults(node, 0, 0, css_layout_scale_factor);
+   }
+ }
+
+ void free_css_flat_tree(css_flat_tree_t *tree) {
+   free(tree->nodes);
+   free(tree->contexts);
+   free(tree->originals);
+   free(tree->changes);
+   free(tree);
+ }
+
+ int css_flat_tree_changes(css_flat_tree_t *tree, css_layout_change_t **changes) {
+   *changes = tree->changes;
+   return tree->change_count;
+ }
+
+ void css_node_set_applied(css_node_t *node, float left, float top, float width, float height) {
+   node->layout.applied_position[CSS_LEFT] = left;
+   node->layout.applied_position[CSS_TOP] = top;
+   node->layout.applied_dimensions[CSS_WIDTH] = width;
+   node->layout.applied_dimensions[CSS_HEIGHT] = height;
+ }
+
  static void indent(int n) {
    for (int i = 0; i < n; ++i) {
      printf("  ");
@@ -297,76 +573,92 @@
           flex_direction == CSS_FLEX_DIRECTION_COLUMN_REVERSE;
  }
 
- static float getLeadingMargin(css_node_t *node, css_flex_direction_t axis) {
-   if (isRowDirection(axis) && !isUndefined(node->style.margin[CSS_START])) {
-     return node->style.margin[CSS_START];
+ static css_flex_direction_t resolveAxis(css_flex_direction_t flex_direction, css_direction_t direction);
+
+ // Resolves margin, padding and border for all four physical edges in one
+ // shot, so the per-axis getters below collapse into array reads. Padding and
+ // border clamp negative and undefined values to zero across the four lanes
+ // with a branchless compare/select (the compare is false for NaN); the
+ // start/end overrides only touch the two row edges and stay scalar. Queries
+ // against a node must resolve with the same direction the node lays out
+ // with, which holds because every query in a pass uses the one resolved row
+ // axis.
+ static void resolveEdges(css_node_t *node, css_direction_t direction) {
+   css_style_t *style = &node->style;
+
+ #if defined(__SSE__)
+   __m128 zero = _mm_setzero_ps();
+   __m128 margin = _mm_loadu_ps(style->margin);
+   __m128 padding = _mm_loadu_ps(style->padding);
+   __m128 border = _mm_loadu_ps(style->border);
+   padding = _mm_and_ps(_mm_cmpge_ps(padding, zero), padding);
+   border = _mm_and_ps(_mm_cmpge_ps(border, zero), border);
+   _mm_storeu_ps(node->resolved_margin, margin);
+   _mm_storeu_ps(node->resolved_padding, padding);
+   _mm_storeu_ps(node->resolved_border, border);
+ #elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+   float32x4_t zero = vdupq_n_f32(0);
+   float32x4_t margin = vld1q_f32(style->margin);
+   float32x4_t padding = vld1q_f32(style->padding);
+   float32x4_t border = vld1q_f32(style->border);
+   padding = vbslq_f32(vcgeq_f32(padding, zero), padding, zero);
+   border = vbslq_f32(vcgeq_f32(border, zero), border, zero);
+   vst1q_f32(node->resolved_margin, margin);
+   vst1q_f32(node->resolved_padding, padding);
+   vst1q_f32(node->resolved_border, border);
+ #else
+   for (int i = 0; i < 4; i++) {
+     node->resolved_margin[i] = style->margin[i];
+     node->resolved_padding[i] = style->padding[i] >= 0 ? style->padding[i] : 0;
+     node->resolved_border[i] = style->border[i] >= 0 ? style->border[i] : 0;
    }
+ #endif
 
-   return node->style.margin[leading[axis]];
+   css_flex_direction_t rowAxis = resolveAxis(CSS_FLEX_DIRECTION_ROW, direction);
+   int lead = leading[rowAxis];
+   int trail = trailing[rowAxis];
+   if (!isUndefined(style->margin[CSS_START])) {
+     node->resolved_margin[lead] = style->margin[CSS_START];
+   }
+   if (!isUndefined(style->margin[CSS_END])) {
+     node->resolved_margin[trail] = style->margin[CSS_END];
+   }
+   if (style->padding[CSS_START] >= 0) {
+     node->resolved_padding[lead] = style->padding[CSS_START];
+   }
+   if (style->padding[CSS_END] >= 0) {
+     node->resolved_padding[trail] = style->padding[CSS_END];
+   }
+   if (style->border[CSS_START] >= 0) {
+     node->resolved_border[lead] = style->border[CSS_START];
+   }
+   if (style->border[CSS_END] >= 0) {
+     node->resolved_border[trail] = style->border[CSS_END];
+   }
  }
 
- static float getTrailingMargin(css_node_t *node, css_flex_direction_t axis) {
-   if (isRowDirection(axis) && !isUndefined(node->style.margin[CSS_END])) {
-     return node->style.margin[CSS_END];
-   }
+ static float getLeadingMargin(css_node_t *node, css_flex_direction_t axis) {
+   return node->resolved_margin[leading[axis]];
+ }
 
-   return node->style.margin[trailing[axis]];
+ static float getTrailingMargin(css_node_t *node, css_flex_direction_t axis) {
+   return node->resolved_margin[trailing[axis]];
  }
 
  static float getLeadingPadding(css_node_t *node, css_flex_direction_t axis) {
-   if (isRowDirection(axis) &&
-       !isUndefined(node->style.padding[CSS_START]) &&
-       node->style.padding[CSS_START] >= 0) {
-     return node->style.padding[CSS_START];
-   }
-
-   if (node->style.padding[leading[axis]] >= 0) {
-     return node->style.padding[leading[axis]];
-   }
-
-   return 0;
+   return node->resolved_padding[leading[axis]];
  }
 
  static float getTrailingPadding(css_node_t *node, css_flex_direction_t axis) {
-   if (isRowDirection(axis) &&
-       !isUndefined(node->style.padding[CSS_END]) &&
-       node->style.padding[CSS_END] >= 0) {
-     return node->style.padding[CSS_END];
-   }
-
-   if (node->style.padding[trailing[axis]] >= 0) {
-     return node->style.padding[trailing[axis]];
-   }
-
-   return 0;
+   return node->resolved_padding[trailing[axis]];
  }
 
  static float getLeadingBorder(css_node_t *node, css_flex_direction_t axis) {
-   if (isRowDirection(axis) &&
-       !isUndefined(node->style.border[CSS_START]) &&
-       node->style.border[CSS_START] >= 0) {
-     return node->style.border[CSS_START];
-   }
-
-   if (node->style.border[leading[axis]] >= 0) {
-     return node->style.border[leading[axis]];
-   }
-
-   return 0;
+   return node->resolved_border[leading[axis]];
  }
 
  static float getTrailingBorder(css_node_t *node, css_flex_direction_t axis) {
-   if (isRowDirection(axis) &&
-       !isUndefined(node->style.border[CSS_END]) &&
-       node->style.border[CSS_END] >= 0) {
-     return node->style.border[CSS_END];
-   }
-
-   if (node->style.border[trailing[axis]] >= 0) {
-     return node->style.border[trailing[axis]];
-   }
-
-   return 0;
+   return node->resolved_border[trailing[axis]];
  }
 
  static float getLeadingPaddingAndBorder(css_node_t *node, css_flex_direction_t axis) {
@@ -534,6 +826,260 @@
    return -getPosition(node, trailing[axis]);
  }
 
+ // ---- Parallel layout of independent subtrees ----
+ //
+ // Absolutely positioned children have no layout dependency on their
+ // siblings: their recursive passes only read constraints the parent fixed
+ // before its child loop, and their results are not consumed until the
+ // final positioning passes. In parallel mode those passes are deferred
+ // during the child loop and run together on worker threads before the
+ // dimensions are needed.
+
+ static bool css_parallel_enabled = false;
+
+ void css_layout_set_parallel(bool enabled) {
+   css_parallel_enabled = enabled;
+ }
+
+ enum { CSS_MAX_DEFERRED = 32, CSS_MAX_LAYOUT_WORKERS = 4 };
+
+ // Measure functions may call back into the owner's world (text shaping,
+ // UI toolkit objects); those subtrees stay on the calling thread.
+ static bool canLayoutDetached(css_node_t *node) {
+   if (node->measure) {
+     return false;
+   }
+   for (int i = 0; i < node->children_count; i++) {
+     if (!canLayoutDetached(node->get_child(node->context, i))) {
+       return false;
+     }
+   }
+   return true;
+ }
+
+ #if defined(CSS_HAS_PTHREADS) && !defined(__STDC_NO_ATOMICS__)
+
+ // Workers must not themselves fan out; a deep tree would otherwise spawn a
+ // thread per level.
+ static _Thread_local bool css_in_layout_worker = false;
+
+ typedef struct {
+   css_node_t **nodes;
+   const float *max_widths;
+   const float *max_heights;
+   css_direction_t direction;
+   int count;
+   atomic_int next;
+ } css_parallel_job_t;
+
+ static void drainParallelJob(css_parallel_job_t *job) {
+   for (;;) {
+     int i = atomic_fetch_add(&job->next, 1);
+     if (i >= job->count) {
+       break;
+     }
+     layoutNode(job->nodes[i], job->max_widths[i], job->max_heights[i], job->direction);
+   }
+ }
+
+ // Persistent worker pool. Workers are created on the first parallel flush
+ // and park on a condvar between flushes; spawning and joining per flush
+ // costs tens of microseconds per thread, which can exceed the layout time
+ // of the deferred subtrees themselves during the layout storms this is
+ // meant to help.
+ static pthread_mutex_t css_pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+ static pthread_cond_t css_pool_wake = PTHREAD_COND_INITIALIZER;
+ static pthread_cond_t css_pool_done = PTHREAD_COND_INITIALIZER;
+ static css_parallel_job_t *css_pool_job = NULL;
+ static unsigned css_pool_generation = 0;
+ static int css_pool_threads = 0;
+ static int css_pool_active = 0;
+
+ static void *parallelLayoutWorker(void *arg) {
+   (void)arg;
+   css_in_layout_worker = true;
+   unsigned seen = 0;
+   pthread_mutex_lock(&css_pool_mutex);
+   for (;;) {
+     while (css_pool_generation == seen) {
+       pthread_cond_wait(&css_pool_wake, &css_pool_mutex);
+     }
+     seen = css_pool_generation;
+     css_parallel_job_t *job = css_pool_job;
+     pthread_mutex_unlock(&css_pool_mutex);
+
+     drainParallelJob(job);
+
+     pthread_mutex_lock(&css_pool_mutex);
+     if (--css_pool_active == 0) {
+       pthread_cond_signal(&css_pool_done);
+     }
+   }
+   return NULL;
+ }
+
+ static void flushDeferredLayout(css_node_t **nodes, const float *maxWidths, const float *maxHeights,
+                                 int count, css_direction_t direction) {
+   if (count > 1 && !css_in_layout_worker) {
+     css_parallel_job_t job;
+     job.nodes = nodes;
+     job.max_widths = maxWidths;
+     job.max_heights = maxHeights;
+     job.direction = direction;
+     job.count = count;
+     atomic_init(&job.next, 0);
+
+     pthread_mutex_lock(&css_pool_mutex);
+     int wanted = (count < CSS_MAX_LAYOUT_WORKERS ? count : CSS_MAX_LAYOUT_WORKERS) - 1;
+     while (css_pool_threads < wanted) {
+       pthread_t thread;
+       if (pthread_create(&thread, NULL, parallelLayoutWorker, NULL) != 0) {
+         break;
+       }
+       pthread_detach(thread);
+       css_pool_threads++;
+     }
+     if (css_pool_threads > 0) {
+       // A pool larger than this flush needs is woken whole; the surplus
+       // workers find the queue drained and go straight back to sleep.
+       css_pool_job = &job;
+       css_pool_generation++;
+       css_pool_active = css_pool_threads;
+       pthread_cond_broadcast(&css_pool_wake);
+       pthread_mutex_unlock(&css_pool_mutex);
+
+       // The calling thread drains the queue alongside the workers.
+       bool wasWorker = css_in_layout_worker;
+       css_in_layout_worker = true;
+       drainParallelJob(&job);
+       css_in_layout_worker = wasWorker;
+
+       // The job lives on this stack, so wait until every worker is done
+       // with it before returning.
+       pthread_mutex_lock(&css_pool_mutex);
+       while (css_pool_active != 0) {
+         pthread_cond_wait(&css_pool_done, &css_pool_mutex);
+       }
+       css_pool_job = NULL;
+       pthread_mutex_unlock(&css_pool_mutex);
+       return;
+     }
+     pthread_mutex_unlock(&css_pool_mutex);
+   }
+   for (int i = 0; i < count; i++) {
+     layoutNode(nodes[i], maxWidths[i], maxHeights[i], direction);
+   }
+ }
+
+ #else
+
+ static void flushDeferredLayout(css_node_t **nodes, const float *maxWidths, const float *maxHeights,
+                                 int count, css_direction_t direction) {
+   for (int i = 0; i < count; i++) {
+     layoutNode(nodes[i], maxWidths[i], maxHeights[i], direction);
+   }
+ }
+
+ #endif
+
+ // The batched measure protocol. Each measure-bearing node keeps a small ring
+ // of recent results keyed on the exact constraints layout asks with. When a
+ // bulk callback is registered and a collector is active (the speculative
+ // pass of layoutNodeBatched), cache misses are recorded instead of calling
+ // the measure function, so all of a pass's measurements cross into the
+ // owner's world in one trip.
+
+ static css_batch_measure_t css_batch_measure = NULL;
+ static void *css_batch_measure_context = NULL;
+
+ void css_layout_set_batch_measure(css_batch_measure_t measure, void *context) {
+   css_batch_measure = measure;
+   css_batch_measure_context = context;
+ }
+
+ void css_node_clear_measure_cache(css_node_t *node) {
+   node->measure_cache_count = 0;
+ }
+
+ enum { CSS_MAX_MEASURE_BATCH = 128 };
+
+ typedef struct {
+   css_measure_request_t requests[CSS_MAX_MEASURE_BATCH];
+   int count;
+ } css_measure_collector_t;
+
+ #if defined(_MSC_VER)
+ static __declspec(thread) css_measure_collector_t *css_measure_collector = NULL;
+ #else
+ static _Thread_local css_measure_collector_t *css_measure_collector = NULL;
+ #endif
+
+ // Constraints are compared as bit patterns so CSS_UNDEFINED matches itself.
+ static bool measureConstraintsEqual(float aWidth, css_measure_mode_t aWidthMode,
+                                     float aHeight, css_measure_mode_t aHeightMode,
+                                     float bWidth, css_measure_mode_t bWidthMode,
+                                     float bHeight, css_measure_mode_t bHeightMode) {
+   return
+     memcmp(&aWidth, &bWidth, sizeof(float)) == 0 &&
+     memcmp(&aHeight, &bHeight, sizeof(float)) == 0 &&
+     aWidthMode == bWidthMode &&
+     aHeightMode == bHeightMode;
+ }
+
+ static void measureCacheInsert(css_node_t *node, float width, css_measure_mode_t widthMode,
+                                float height, css_measure_mode_t heightMode, css_dim_t result) {
+   css_measure_cache_t *entry = &node->measure_cache[node->measure_cache_count % CSS_MEASURE_CACHE_SIZE];
+   entry->width = width;
+   entry->height = height;
+   entry->width_mode = widthMode;
+   entry->height_mode = heightMode;
+   entry->result = result;
+   node->measure_cache_count++;
+ }
+
+ static css_dim_t nodeMeasure(css_node_t *node, float width, css_measure_mode_t widthMode,
+                              float height, css_measure_mode_t heightMode) {
+   int cached = node->measure_cache_count < CSS_MEASURE_CACHE_SIZE ?
+     node->measure_cache_count : CSS_MEASURE_CACHE_SIZE;
+   for (int i = 0; i < cached; i++) {
+     css_measure_cache_t *entry = &node->measure_cache[i];
+     if (measureConstraintsEqual(entry->width, entry->width_mode, entry->height, entry->height_mode,
+                                 width, widthMode, height, heightMode)) {
+       return entry->result;
+     }
+   }
+
+   css_measure_collector_t *collector = css_measure_collector;
+   if (collector != NULL) {
+     for (int i = 0; i < collector->count; i++) {
+       css_measure_request_t *request = &collector->requests[i];
+       if (request->node == node &&
+           measureConstraintsEqual(request->width, request->width_mode, request->height, request->height_mode,
+                                   width, widthMode, height, heightMode)) {
+         // Already requested during this speculative pass; return the same
+         // placeholder so the pass stays deterministic.
+         return request->result;
+       }
+     }
+     if (collector->count < CSS_MAX_MEASURE_BATCH) {
+       css_measure_request_t *request = &collector->requests[collector->count++];
+       request->node = node;
+       request->width = width;
+       request->width_mode = widthMode;
+       request->height = height;
+       request->height_mode = heightMode;
+       request->result.dimensions[CSS_WIDTH] = 0;
+       request->result.dimensions[CSS_HEIGHT] = 0;
+       return request->result;
+     }
+     // Collector full; fall through to a synchronous measure.
+   }
+
+   css_dim_t result = node->measure(node->context, width, widthMode, height, heightMode);
+   measureCacheInsert(node, width, widthMode, height, heightMode, result);
+   return result;
+ }
+
  static void layoutNodeImpl(css_node_t *node, float parentMaxWidth, float parentMaxHeight, css_direction_t parentDirection) {
    /** START_GENERATED **/
    css_direction_t direction = resolveDirection(node, parentDirection);
@@ -541,6 +1087,15 @@
    css_flex_direction_t crossAxis = getCrossFlexDirection(mainAxis, direction);
    css_flex_direction_t resolvedRowAxis = resolveAxis(CSS_FLEX_DIRECTION_ROW, direction);
 
+   // Fill in the resolved edge tables the margin/padding/border getters read.
+   // The children are resolved here as well because this pass queries their
+   // margins before recursing into them.
+   resolveEdges(node, direction);
+   for (int rei = 0; rei < node->children_count; rei++) {
+     css_node_t *resolveChild = node->get_child(node->context, rei);
+     resolveEdges(resolveChild, resolveDirection(resolveChild, direction));
+   }
+
    // Handle width and height style attributes
    setDimensionFromStyle(node, mainAxis);
    setDimensionFromStyle(node, crossAxis);
@@ -613,8 +1168,8 @@
 
      // Let's not measure the text if we already know both dimensions
      if (isRowUndefined || isColumnUndefined) {
-       css_dim_t measureDim = node->measure(
-         node->context,
+       css_dim_t measureDim = nodeMeasure(
+         node,
 
          width,
          widthMode,
@@ -656,6 +1211,13 @@
    css_node_t* firstAbsoluteChild = NULL;
    css_node_t* currentAbsoluteChild = NULL;
 
+   // Absolute subtrees deferred for the worker pool; flushed before the
+   // cross-axis passes read their dimensions.
+   css_node_t* deferredNodes[CSS_MAX_DEFERRED];
+   float deferredMaxWidths[CSS_MAX_DEFERRED];
+   float deferredMaxHeights[CSS_MAX_DEFERRED];
+   int deferredCount = 0;
+
    float definedMainDim = CSS_UNDEFINED;
    if (isMainDimDefined) {
      definedMainDim = node->layout.dimensions[dim[mainAxis]] - paddingAndBorderAxisMain;
@@ -813,7 +1375,17 @@
 
          // This is the main recursive call. We layout non flexible children.
          if (alreadyComputedNextLayout == 0) {
-           layoutNode(child, maxWidth, maxHeight, direction);
+           if (css_parallel_enabled &&
+               child->style.position_type == CSS_POSITION_ABSOLUTE &&
+               deferredCount < CSS_MAX_DEFERRED &&
+               canLayoutDetached(child)) {
+             deferredNodes[deferredCount] = child;
+             deferredMaxWidths[deferredCount] = maxWidth;
+             deferredMaxHeights[deferredCount] = maxHeight;
+             deferredCount++;
+           } else {
+             layoutNode(child, maxWidth, maxHeight, direction);
+           }
          }
 
          // Absolute positioned elements do not take part of the layout, so we
@@ -879,6 +1451,12 @@
        endLine = i + 1;
      }
 
+     // The positioning passes below read and overwrite the deferred
+     // children's geometry, so the worker pool drains here.
+     flushDeferredLayout(deferredNodes, deferredMaxWidths, deferredMaxHeights,
+                         deferredCount, direction);
+     deferredCount = 0;
+
      // <Loop B> Layout flexible children and allocate empty space
 
      // In order to position the elements in the main axis, we have two
@@ -1289,6 +1867,173 @@
    /** END_GENERATED **/
  }
 
+ // ---- Subtree memoization ----
+ //
+ // List rows tend to share style and shape; once one such subtree has been
+ // laid out at a set of constraints, the result geometry can be replayed
+ // onto the next structurally identical one. Subtrees opt in through the
+ // memoizable flag on their root.
+
+ typedef struct {
+   unsigned int hash;
+   int node_count;
+   float max_width;
+   float max_height;
+   css_direction_t direction;
+   float *geometry; // x, y, width, height per node, depth-first
+ } css_memo_entry_t;
+
+ enum { CSS_MEMO_ENTRIES = 256 };
+ static css_memo_entry_t css_memo_entries[CSS_MEMO_ENTRIES];
+
+ #if !defined(__STDC_NO_ATOMICS__) && !defined(_MSC_VER)
+ // Async layout workers share the cache with the main thread; entries are
+ // small and copied out, so a spin lock is enough.
+ static atomic_flag css_memo_lock = ATOMIC_FLAG_INIT;
+ static void memoLock(void) {
+   while (atomic_flag_test_and_set(&css_memo_lock)) {
+   }
+ }
+ static void memoUnlock(void) {
+   atomic_flag_clear(&css_memo_lock);
+ }
+ #else
+ static void memoLock(void) {}
+ static void memoUnlock(void) {}
+ #endif
+
+ void css_memo_cache_clear(void) {
+   memoLock();
+   for (int i = 0; i < CSS_MEMO_ENTRIES; i++) {
+     free(css_memo_entries[i].geometry);
+     css_memo_entries[i].geometry = NULL;
+   }
+   memoUnlock();
+ }
+
+ static unsigned int memoHashBytes(const void *data, int len, unsigned int hash) {
+   const unsigned char *bytes = (const unsigned char *)data;
+   for (int i = 0; i < len; i++) {
+     hash = (hash ^ bytes[i]) * 16777619u;
+   }
+   return hash;
+ }
+
+ // Returns false when the subtree contains a measure function: the measured
+ // content is not visible to the hash, so such subtrees never hit the cache.
+ static bool memoHashSubtree(css_node_t *node, unsigned int *hash, int *count) {
+   if (node->measure) {
+     return false;
+   }
+   *hash = memoHashBytes(&node->style, sizeof(css_style_t), *hash);
+   *hash = memoHashBytes(&node->children_count, sizeof(int), *hash);
+   (*count)++;
+   for (int i = 0; i < node->children_count; i++) {
+     if (!memoHashSubtree(node->get_child(node->context, i), hash, count)) {
+       return false;
+     }
+   }
+   return true;
+ }
+
+ static int memoCollectGeometry(css_node_t *node, float *geometry, int index) {
+   geometry[index * 4] = node->layout.position[CSS_LEFT];
+   geometry[index * 4 + 1] = node->layout.position[CSS_TOP];
+   geometry[index * 4 + 2] = node->layout.dimensions[CSS_WIDTH];
+   geometry[index * 4 + 3] = node->layout.dimensions[CSS_HEIGHT];
+   index++;
+   for (int i = 0; i < node->children_count; i++) {
+     index = memoCollectGeometry(node->get_child(node->context, i), geometry, index);
+   }
+   return index;
+ }
+
+ static int memoApplyGeometry(css_node_t *node, const float *geometry, int index) {
+   if (index > 0) {
+     // The root keeps the position its parent gives it.
+     node->layout.position[CSS_LEFT] = geometry[index * 4];
+     node->layout.position[CSS_TOP] = geometry[index * 4 + 1];
+   }
+   node->layout.dimensions[CSS_WIDTH] = geometry[index * 4 + 2];
+   node->layout.dimensions[CSS_HEIGHT] = geometry[index * 4 + 3];
+   node->layout.should_update = true;
+   index++;
+   for (int i = 0; i < node->children_count; i++) {
+     index = memoApplyGeometry(node->get_child(node->context, i), geometry, index);
+   }
+   return index;
+ }
+
+ static bool applyMemoizedLayout(css_node_t *node, float maxWidth, float maxHeight, css_direction_t parentDirection) {
+   unsigned int hash = 2166136261u;
+   int count = 0;
+   if (!memoHashSubtree(node, &hash, &count)) {
+     return false;
+   }
+   css_direction_t direction = resolveDirection(node, parentDirection);
+
+   memoLock();
+   css_memo_entry_t *entry = &css_memo_entries[hash % CSS_MEMO_ENTRIES];
+   // Float compares go through memcmp so undefined (NaN) constraints still
+   // match themselves.
+   bool hit = entry->geometry != NULL &&
+     entry->hash == hash &&
+     entry->node_count == count &&
+     entry->direction == direction &&
+     memcmp(&entry->max_width, &maxWidth, sizeof(float)) == 0 &&
+     memcmp(&entry->max_height, &maxHeight, sizeof(float)) == 0;
+   float *geometry = NULL;
+   if (hit) {
+     // Copy out so the tree walk below runs without the lock held.
+     geometry = (float *)malloc(count * 4 * sizeof(float));
+     memcpy(geometry, entry->geometry, count * 4 * sizeof(float));
+   }
+   memoUnlock();
+   if (geometry == NULL) {
+     return false;
+   }
+
+   memoApplyGeometry(node, geometry, 0);
+   free(geometry);
+
+   // Replay the prologue's position completion for the root; the cached
+   // offsets only cover the interior of the subtree.
+   resolveEdges(node, direction);
+   css_flex_direction_t mainAxis = resolveAxis(getFlexDirection(node), direction);
+   css_flex_direction_t crossAxis = getCrossFlexDirection(mainAxis, direction);
+   node->layout.position[leading[mainAxis]] += getLeadingMargin(node, mainAxis) +
+     getRelativePosition(node, mainAxis);
+   node->layout.position[trailing[mainAxis]] += getTrailingMargin(node, mainAxis) +
+     getRelativePosition(node, mainAxis);
+   node->layout.position[leading[crossAxis]] += getLeadingMargin(node, crossAxis) +
+     getRelativePosition(node, crossAxis);
+   node->layout.position[trailing[crossAxis]] += getTrailingMargin(node, crossAxis) +
+     getRelativePosition(node, crossAxis);
+   node->layout.direction = direction;
+   return true;
+ }
+
+ static void storeMemoizedLayout(css_node_t *node, float maxWidth, float maxHeight, css_direction_t parentDirection) {
+   unsigned int hash = 2166136261u;
+   int count = 0;
+   if (!memoHashSubtree(node, &hash, &count)) {
+     return;
+   }
+   float *geometry = (float *)malloc(count * 4 * sizeof(float));
+   memoCollectGeometry(node, geometry, 0);
+
+   memoLock();
+   css_memo_entry_t *entry = &css_memo_entries[hash % CSS_MEMO_ENTRIES];
+   free(entry->geometry);
+   entry->hash = hash;
+   entry->node_count = count;
+   entry->max_width = maxWidth;
+   entry->max_height = maxHeight;
+   entry->direction = resolveDirection(node, parentDirection);
+   entry->geometry = geometry;
+   memoUnlock();
+ }
+
  void layoutNode(css_node_t *node, float parentMaxWidth, float parentMaxHeight, css_direction_t parentDirection) {
    css_layout_t *layout = &node->layout;
    css_direction_t direction = node->style.direction;
@@ -1318,7 +2063,13 @@
        resetNodeLayout(node->get_child(node->context, i));
      }
 
-     layoutNodeImpl(node, parentMaxWidth, parentMaxHeight, parentDirection);
+     if (!node->memoizable ||
+         !applyMemoizedLayout(node, parentMaxWidth, parentMaxHeight, parentDirection)) {
+       layoutNodeImpl(node, parentMaxWidth, parentMaxHeight, parentDirection);
+       if (node->memoizable) {
+         storeMemoizedLayout(node, parentMaxWidth, parentMaxHeight, parentDirection);
+       }
+     }
 
      layout->last_dimensions[CSS_WIDTH] = layout->dimensions[CSS_WIDTH];
      layout->last_dimensions[CSS_HEIGHT] = layout->dimensions[CSS_HEIGHT];
@@ -1333,3 +2084,50 @@
    node->layout.position[CSS_LEFT] = 0;
    node->layout.position[CSS_TOP] = 0;
  }
+
+ // Clears the incremental-layout cache so the second pass of
+ // layoutNodeBatched recomputes everything against the filled measure
+ // caches instead of replaying the speculative pass's results.
+ static void invalidateLayoutCache(css_node_t *node) {
+   node->layout.last_requested_dimensions[CSS_WIDTH] = -1;
+   node->layout.last_requested_dimensions[CSS_HEIGHT] = -1;
+   node->layout.last_parent_max_width = -1;
+   node->layout.last_parent_max_height = -1;
+   for (int i = 0; i < node->children_count; i++) {
+     invalidateLayoutCache(node->get_child(node->context, i));
+   }
+ }
+
+ void layoutNodeBatched(css_node_t *node, float parentMaxWidth, float parentMaxHeight, css_direction_t parentDirection) {
+   if (css_batch_measure == NULL || css_measure_collector != NULL) {
+     layoutNode(node, parentMaxWidth, parentMaxHeight, parentDirection);
+     return;
+   }
+
+   // Speculative pass: lay out against the measure caches, recording every
+   // miss with the exact constraints layout asked with. The root layout is
+   // saved so the real pass starts from the same state.
+   css_layout_t rootLayout = node->layout;
+   css_measure_collector_t collector;
+   collector.count = 0;
+   css_measure_collector = &collector;
+   layoutNode(node, parentMaxWidth, parentMaxHeight, parentDirection);
+   css_measure_collector = NULL;
+
+   if (collector.count == 0) {
+     // Every measure was cached; the speculative pass was the real one.
+     return;
+   }
+
+   // One trip into the owner's world for the whole pass.
+   css_batch_measure(css_batch_measure_context, collector.requests, collector.count);
+   for (int i = 0; i < collector.count; i++) {
+     css_measure_request_t *request = &collector.requests[i];
+     measureCacheInsert(request->node, request->width, request->width_mode,
+                        request->height, request->height_mode, request->result);
+   }
+
+   node->layout = rootLayout;
+   invalidateLayoutCache(node);
+   layoutNode(node, parentMaxWidth, parentMaxHeight, parentDirection);
+ }
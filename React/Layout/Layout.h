@@ -113,12 +113,29 @@
    float last_dimensions[2];
    float last_position[2];
    css_direction_t last_direction;
+
+   // Geometry as last pushed to the owning view (css_node_set_applied); the
+   // other half of the double buffer that layout_css_flat_tree diffs freshly
+   // computed results against to produce its change list.
+   float applied_position[2];
+   float applied_dimensions[2];
  } css_layout_t;
 
  typedef struct {
    float dimensions[2];
  } css_dim_t;
 
+ // One remembered measure result: the exact constraints the measure function
+ // was called with and the dimensions it returned.
+ enum { CSS_MEASURE_CACHE_SIZE = 4 };
+ typedef struct {
+   float width;
+   float height;
+   css_measure_mode_t width_mode;
+   css_measure_mode_t height_mode;
+   css_dim_t result;
+ } css_measure_cache_t;
+
  typedef struct {
    css_direction_t direction;
    css_flex_direction_t flex_direction;
@@ -158,6 +175,29 @@
    css_node_t *next_absolute_child;
    css_node_t *next_flex_child;
 
+   // Style values resolved per physical edge (left, top, right, bottom) with
+   // start/end overrides and clamping applied; filled in for each node at the
+   // start of its layout visit.
+   float resolved_margin[4];
+   float resolved_padding[4];
+   float resolved_border[4];
+
+   // Opts this subtree into the memoization cache: its result geometry is
+   // keyed on a structural hash of style and shape plus the incoming
+   // constraints, and replayed onto structurally identical subtrees instead
+   // of recomputing them. Subtrees containing measure functions never hit
+   // the cache since the measured content is invisible to the hash.
+   bool memoizable;
+
+   // Ring of recent measure results keyed on the exact constraints; filled
+   // either by direct measure calls or by the batched measure protocol.
+   css_measure_cache_t measure_cache[CSS_MEASURE_CACHE_SIZE];
+   int measure_cache_count;
+
+   // Set by the owner when the measure callback may be invoked off the
+   // calling thread; the batch servicer uses it to fan requests out.
+   bool measure_thread_safe;
+
    css_dim_t (*measure)(void *context, float width, css_measure_mode_t widthMode, float height, css_measure_mode_t heightMode);
    void (*print)(void *context);
    struct css_node* (*get_child)(void *context, int i);
@@ -170,6 +210,78 @@
  void init_css_node(css_node_t *node);
  void free_css_node(css_node_t *node);
 
+ // Arena-allocated nodes: all nodes of a tree come out of one slab chain, so
+ // they sit contiguously in memory and are released in bulk instead of one
+ // free per node. Nodes from an arena must not be passed to free_css_node.
+ typedef struct css_arena css_arena_t;
+ css_arena_t *new_css_arena(int initial_capacity);
+ css_node_t *css_arena_new_node(css_arena_t *arena);
+ // Discards all nodes but keeps the slabs for the next tree.
+ void reset_css_arena(css_arena_t *arena);
+ void free_css_arena(css_arena_t *arena);
+
+ // Flattened tree: the nodes are packed into parallel arrays in breadth-first
+ // order, so each node's children are contiguous in memory and child access
+ // during layout is index arithmetic instead of a get_child callback. Style
+ // and layout state is copied in from the original nodes when the tree is
+ // laid out and the results (including the incremental-layout cache fields)
+ // are copied back afterwards. Rebuild the tree when children change.
+ typedef struct css_flat_tree css_flat_tree_t;
+ css_flat_tree_t *new_css_flat_tree(css_node_t *root);
+ void layout_css_flat_tree(css_flat_tree_t *tree, float maxWidth, float maxHeight, css_direction_t parentDirection);
+ void free_css_flat_tree(css_flat_tree_t *tree);
+
+ // After layout_css_flat_tree, the nodes whose computed geometry differs
+ // from what the owner last applied; the apply pass then visits only these
+ // instead of walking the whole tree. The owner reports each application
+ // back through css_node_set_applied so the next diff has a baseline.
+ typedef struct {
+   css_node_t *node;
+   float position[2];
+   float dimensions[2];
+ } css_layout_change_t;
+ int css_flat_tree_changes(css_flat_tree_t *tree, css_layout_change_t **changes);
+ void css_node_set_applied(css_node_t *node, float left, float top, float width, float height);
+
+ // Drops every cached subtree result; call when cached geometry could have
+ // gone stale for reasons the structural hash cannot see.
+ void css_memo_cache_clear(void);
+
+ // Grid rounding: when a scale factor is set (units per pixel, e.g. 64 for a
+ // 1/64px grid), css_round_layout_results snaps the computed geometry onto
+ // that grid after a layout pass. Accumulated float rounding then cannot make
+ // geometry differ between machines, so snapshot comparisons can be exact
+ // instead of tolerance-based. A scale of 0 (the default) disables rounding.
+ void css_layout_set_scale_factor(float scale);
+ void css_round_layout_results(css_node_t *node);
+
+ // When enabled, absolutely positioned subtrees - which have no layout
+ // dependency on their siblings - are laid out on a small worker pool
+ // instead of inline in the parent's pass. Subtrees containing measure
+ // functions always stay on the calling thread.
+ void css_layout_set_parallel(bool enabled);
+
+ // Batched measure protocol: instead of calling each node's measure function
+ // synchronously mid-layout, layoutNodeBatched runs a speculative pass that
+ // collects every measure miss together with the exact constraints layout
+ // would have used, hands them to one bulk callback, then reruns layout
+ // against the filled per-node caches. The callback must fill in result for
+ // every request; it may service thread-safe measures concurrently.
+ typedef struct {
+   css_node_t *node;
+   float width;
+   css_measure_mode_t width_mode;
+   float height;
+   css_measure_mode_t height_mode;
+   css_dim_t result;
+ } css_measure_request_t;
+ typedef void (*css_batch_measure_t)(void *context, css_measure_request_t *requests, int count);
+ void css_layout_set_batch_measure(css_batch_measure_t measure, void *context);
+
+ // Drops a node's remembered measure results; call when the measured content
+ // (e.g. the text) changes, since the cache is keyed on constraints only.
+ void css_node_clear_measure_cache(css_node_t *node);
+
  // Print utilities
  typedef enum {
    CSS_PRINT_LAYOUT = 1,
@@ -183,6 +295,11 @@
  // Function that computes the layout!
  void layoutNode(css_node_t *node, float maxWidth, float maxHeight, css_direction_t parentDirection);
 
+ // Like layoutNode, but resolves measure functions through the batched
+ // measure protocol when a bulk callback is registered; falls back to
+ // layoutNode otherwise.
+ void layoutNodeBatched(css_node_t *node, float maxWidth, float maxHeight, css_direction_t parentDirection);
+
  // Reset the calculated layout values for a given node. You should call this before `layoutNode`.
  void resetNodeLayout(css_node_t *node);
 
@@ -0,0 +1,443 @@
+/**
+ * Copyright (c) 2014, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+// Standalone benchmark for the layout engine. Builds Layout.c directly (see
+// the Makefile next to this file) and times full and incremental layout over
+// synthetic deep, wide and grid trees, plus any serialized tree dumps passed
+// on the command line. Results print as a table by default; --csv writes a
+// machine-readable file and --compare diffs two such files, so a regression
+// shows up as a percentage against the previous commit's run instead of a
+// jank report.
+//
+// Dump format: one node per line, pre-order, whitespace-separated:
+//   <depth> <flex_direction> <flex> <width> <height>
+// with -1 for an undefined dimension. Lines starting with '#' are skipped.
+
+#define _POSIX_C_SOURCE 199309L // clock_gettime under -std=c11
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "Layout.h"
+
+#define MAX_BENCH_NODES 65536
+#define WARMUP_DIVISOR 10
+
+typedef struct bench_ctx {
+  css_node_t *node;
+  css_node_t **children;
+  struct bench_ctx *parent;
+  bool dirty;
+} bench_ctx_t;
+
+typedef struct {
+  css_arena_t *arena;
+  css_node_t *nodes[MAX_BENCH_NODES];
+  bench_ctx_t contexts[MAX_BENCH_NODES];
+  css_node_t *child_storage[MAX_BENCH_NODES];
+  int count;
+  int children_used;
+} bench_tree_t;
+
+// Counts layoutNode entries: a node whose incremental cache is still valid
+// never has its children visited, so visited/total is a direct read on how
+// much of the tree a pass actually recomputed.
+static long bench_nodes_visited;
+
+static css_node_t *bench_get_child(void *context, int i) {
+  return ((bench_ctx_t *)context)->children[i];
+}
+
+static bool bench_is_dirty(void *context) {
+  bench_nodes_visited++;
+  return ((bench_ctx_t *)context)->dirty;
+}
+
+static css_node_t *bench_new_node(bench_tree_t *tree) {
+  if (tree->count == MAX_BENCH_NODES) {
+    fprintf(stderr, "benchmark tree exceeds %d nodes\n", MAX_BENCH_NODES);
+    exit(1);
+  }
+  css_node_t *node = css_arena_new_node(tree->arena);
+  bench_ctx_t *ctx = &tree->contexts[tree->count];
+  ctx->node = node;
+  ctx->children = NULL;
+  ctx->parent = NULL;
+  ctx->dirty = true;
+  node->context = ctx;
+  node->get_child = bench_get_child;
+  node->is_dirty = bench_is_dirty;
+  tree->nodes[tree->count++] = node;
+  return node;
+}
+
+// Children are attached after all of a node's children exist, so each child
+// list is one contiguous slice of child_storage.
+static void bench_attach_children(bench_tree_t *tree, css_node_t *node,
+                                  css_node_t **children, int count) {
+  if (tree->children_used + count > MAX_BENCH_NODES) {
+    fprintf(stderr, "benchmark tree exceeds %d child slots\n", MAX_BENCH_NODES);
+    exit(1);
+  }
+  css_node_t **slice = &tree->child_storage[tree->children_used];
+  memcpy(slice, children, count * sizeof(css_node_t *));
+  tree->children_used += count;
+  ((bench_ctx_t *)node->context)->children = slice;
+  node->children_count = count;
+  for (int i = 0; i < count; i++) {
+    ((bench_ctx_t *)children[i]->context)->parent = (bench_ctx_t *)node->context;
+  }
+}
+
+static bench_tree_t *bench_new_tree(void) {
+  bench_tree_t *tree = (bench_tree_t *)calloc(1, sizeof(bench_tree_t));
+  tree->arena = new_css_arena(1024);
+  return tree;
+}
+
+static void bench_free_tree(bench_tree_t *tree) {
+  free_css_arena(tree->arena);
+  free(tree);
+}
+
+static void bench_set_dirty(bench_tree_t *tree, bool dirty) {
+  for (int i = 0; i < tree->count; i++) {
+    tree->contexts[i].dirty = dirty;
+  }
+}
+
+// A chain: each node has one child. Stresses recursion depth and the
+// per-node constant costs.
+static bench_tree_t *build_deep_tree(int depth) {
+  bench_tree_t *tree = bench_new_tree();
+  css_node_t *node = bench_new_node(tree);
+  node->style.dimensions[CSS_WIDTH] = 1000;
+  node->style.dimensions[CSS_HEIGHT] = 1000;
+  for (int i = 1; i < depth; i++) {
+    css_node_t *child = bench_new_node(tree);
+    child->style.flex = 1;
+    bench_attach_children(tree, node, &child, 1);
+    node = child;
+  }
+  return tree;
+}
+
+// One row with many children. Stresses the per-line loops and child access.
+static bench_tree_t *build_wide_tree(int breadth) {
+  bench_tree_t *tree = bench_new_tree();
+  css_node_t *root = bench_new_node(tree);
+  root->style.dimensions[CSS_WIDTH] = 1000;
+  root->style.dimensions[CSS_HEIGHT] = 1000;
+  root->style.flex_direction = CSS_FLEX_DIRECTION_ROW;
+  root->style.flex_wrap = CSS_WRAP;
+  css_node_t **children = (css_node_t **)malloc(breadth * sizeof(css_node_t *));
+  for (int i = 0; i < breadth; i++) {
+    css_node_t *child = bench_new_node(tree);
+    child->style.dimensions[CSS_WIDTH] = 10;
+    child->style.dimensions[CSS_HEIGHT] = 10;
+    child->style.margin[CSS_LEFT] = 1;
+    child->style.margin[CSS_TOP] = 1;
+    children[i] = child;
+  }
+  bench_attach_children(tree, root, children, breadth);
+  free(children);
+  return tree;
+}
+
+static css_node_t *build_grid_level(bench_tree_t *tree, int depth, int fanout) {
+  css_node_t *node = bench_new_node(tree);
+  node->style.flex = 1;
+  node->style.flex_direction =
+    (depth & 1) ? CSS_FLEX_DIRECTION_ROW : CSS_FLEX_DIRECTION_COLUMN;
+  if (depth == 0) {
+    return node;
+  }
+  css_node_t *children[16];
+  for (int i = 0; i < fanout; i++) {
+    children[i] = build_grid_level(tree, depth - 1, fanout);
+  }
+  bench_attach_children(tree, node, children, fanout);
+  return node;
+}
+
+// Alternating row/column levels; the closest synthetic stand-in for a real
+// screen of nested views.
+static bench_tree_t *build_grid_tree(int depth, int fanout) {
+  bench_tree_t *tree = bench_new_tree();
+  css_node_t *root = build_grid_level(tree, depth, fanout);
+  root->style.dimensions[CSS_WIDTH] = 1000;
+  root->style.dimensions[CSS_HEIGHT] = 1000;
+  return tree;
+}
+
+// Loads the pre-order dump format described at the top of the file. Returns
+// NULL (with a message) rather than exiting so one bad capture does not kill
+// the whole run.
+static bench_tree_t *load_dump_tree(const char *path) {
+  FILE *file = fopen(path, "r");
+  if (file == NULL) {
+    fprintf(stderr, "cannot open dump %s\n", path);
+    return NULL;
+  }
+
+  bench_tree_t *tree = bench_new_tree();
+  static int depths[MAX_BENCH_NODES];
+
+  char line[256];
+  while (fgets(line, sizeof(line), file) != NULL) {
+    if (line[0] == '#' || line[0] == '\n') {
+      continue;
+    }
+    int depth, flex_direction;
+    float flex, width, height;
+    if (sscanf(line, "%d %d %f %f %f",
+               &depth, &flex_direction, &flex, &width, &height) != 5 ||
+        depth < 0 ||
+        (tree->count == 0 ? depth != 0 : depth > depths[tree->count - 1] + 1)) {
+      fprintf(stderr, "bad dump line in %s: %s", path, line);
+      fclose(file);
+      bench_free_tree(tree);
+      return NULL;
+    }
+    depths[tree->count] = depth;
+    css_node_t *node = bench_new_node(tree);
+    node->style.flex_direction = (css_flex_direction_t)flex_direction;
+    node->style.flex = flex;
+    node->style.dimensions[CSS_WIDTH] = width < 0 ? CSS_UNDEFINED : width;
+    node->style.dimensions[CSS_HEIGHT] = height < 0 ? CSS_UNDEFINED : height;
+  }
+  fclose(file);
+  if (tree->count == 0) {
+    fprintf(stderr, "empty dump %s\n", path);
+    bench_free_tree(tree);
+    return NULL;
+  }
+
+  // In pre-order, node i's children are the depth[i] + 1 entries between i
+  // and the next entry at depth[i] or shallower.
+  static css_node_t *children[MAX_BENCH_NODES];
+  for (int i = 0; i < tree->count; i++) {
+    int child_count = 0;
+    for (int j = i + 1; j < tree->count && depths[j] > depths[i]; j++) {
+      if (depths[j] == depths[i] + 1) {
+        children[child_count++] = tree->nodes[j];
+      }
+    }
+    if (child_count > 0) {
+      bench_attach_children(tree, tree->nodes[i], children, child_count);
+    }
+  }
+
+  return tree;
+}
+
+static double now_ms(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+static int compare_doubles(const void *a, const void *b) {
+  double da = *(const double *)a, db = *(const double *)b;
+  return (da > db) - (da < db);
+}
+
+typedef struct {
+  const char *tree_name;
+  const char *mode;   // "full" or "incremental"
+  double mean_ms;
+  double p50_ms;
+  double p99_ms;
+  long visited;
+  int total;
+} bench_result_t;
+
+static bench_result_t results[64];
+static int result_count;
+
+// Full layout dirties every node; incremental dirties one deep leaf, which
+// is the common steady-state shape (one text or image finished loading).
+static void run_benchmark(const char *tree_name, bench_tree_t *tree,
+                          bool incremental, int iterations) {
+  double samples[512];
+  if (iterations > 512) {
+    iterations = 512;
+  }
+  int warmup = iterations / WARMUP_DIVISOR;
+  if (warmup < 1) {
+    warmup = 1;
+  }
+
+  // One clean pass so incremental runs start from a fully cached tree.
+  bench_set_dirty(tree, true);
+  layoutNode(tree->nodes[0], CSS_UNDEFINED, CSS_UNDEFINED, CSS_DIRECTION_INHERIT);
+
+  long visited = 0;
+  for (int i = -warmup; i < iterations; i++) {
+    if (incremental) {
+      // The UI manager dirties a changed item and the path above it, so a
+      // relayout can find its way down; everything off the path stays cached.
+      bench_set_dirty(tree, false);
+      for (bench_ctx_t *ctx = &tree->contexts[tree->count - 1];
+           ctx != NULL; ctx = ctx->parent) {
+        ctx->dirty = true;
+      }
+    } else {
+      bench_set_dirty(tree, true);
+    }
+    bench_nodes_visited = 0;
+    double start = now_ms();
+    layoutNode(tree->nodes[0], CSS_UNDEFINED, CSS_UNDEFINED, CSS_DIRECTION_INHERIT);
+    double elapsed = now_ms() - start;
+    if (i >= 0) {
+      samples[i] = elapsed;
+      visited = bench_nodes_visited;
+    }
+  }
+
+  qsort(samples, iterations, sizeof(double), compare_doubles);
+  double mean = 0;
+  for (int i = 0; i < iterations; i++) {
+    mean += samples[i];
+  }
+  mean /= iterations;
+
+  bench_result_t *result = &results[result_count++];
+  result->tree_name = tree_name;
+  result->mode = incremental ? "incremental" : "full";
+  result->mean_ms = mean;
+  result->p50_ms = samples[iterations / 2];
+  result->p99_ms = samples[(iterations * 99) / 100];
+  result->visited = visited;
+  result->total = tree->count;
+}
+
+static void print_results(void) {
+  printf("%-24s %-12s %10s %10s %10s %10s\n",
+         "tree", "mode", "mean(ms)", "p50(ms)", "p99(ms)", "visited");
+  for (int i = 0; i < result_count; i++) {
+    bench_result_t *r = &results[i];
+    printf("%-24s %-12s %10.3f %10.3f %10.3f %6ld/%d\n",
+           r->tree_name, r->mode, r->mean_ms, r->p50_ms, r->p99_ms,
+           r->visited, r->total);
+  }
+}
+
+static void write_csv(const char *path) {
+  FILE *file = fopen(path, "w");
+  if (file == NULL) {
+    fprintf(stderr, "cannot write %s\n", path);
+    exit(1);
+  }
+  fprintf(file, "tree,mode,mean_ms,p50_ms,p99_ms,visited,total\n");
+  for (int i = 0; i < result_count; i++) {
+    bench_result_t *r = &results[i];
+    fprintf(file, "%s,%s,%f,%f,%f,%ld,%d\n",
+            r->tree_name, r->mode, r->mean_ms, r->p50_ms, r->p99_ms,
+            r->visited, r->total);
+  }
+  fclose(file);
+}
+
+// Diffs two CSV files from --csv runs by (tree, mode) key; the usual flow is
+// one file per commit and a compare between neighbours.
+static int compare_csv(const char *before_path, const char *after_path) {
+  FILE *before = fopen(before_path, "r");
+  FILE *after = fopen(after_path, "r");
+  if (before == NULL || after == NULL) {
+    fprintf(stderr, "cannot open %s or %s\n", before_path, after_path);
+    return 1;
+  }
+
+  char before_lines[64][256];
+  int before_count = 0;
+  char line[256];
+  fgets(line, sizeof(line), before); // header
+  while (before_count < 64 && fgets(before_lines[before_count], 256, before)) {
+    before_count++;
+  }
+  fclose(before);
+
+  printf("%-24s %-12s %12s %12s %8s\n",
+         "tree", "mode", "before(ms)", "after(ms)", "delta");
+  fgets(line, sizeof(line), after); // header
+  while (fgets(line, sizeof(line), after)) {
+    char tree_name[64], mode[32];
+    double mean;
+    if (sscanf(line, "%63[^,],%31[^,],%lf", tree_name, mode, &mean) != 3) {
+      continue;
+    }
+    for (int i = 0; i < before_count; i++) {
+      char before_tree[64], before_mode[32];
+      double before_mean;
+      if (sscanf(before_lines[i], "%63[^,],%31[^,],%lf",
+                 before_tree, before_mode, &before_mean) != 3 ||
+          strcmp(before_tree, tree_name) != 0 ||
+          strcmp(before_mode, mode) != 0) {
+        continue;
+      }
+      double delta = before_mean > 0 ? (mean - before_mean) / before_mean * 100 : 0;
+      printf("%-24s %-12s %12.3f %12.3f %+7.1f%%\n",
+             tree_name, mode, before_mean, mean, delta);
+      break;
+    }
+  }
+  fclose(after);
+  return 0;
+}
+
+int main(int argc, char **argv) {
+  const char *csv_path = NULL;
+  int iterations = 100;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--compare") == 0 && i + 2 < argc) {
+      return compare_csv(argv[i + 1], argv[i + 2]);
+    }
+  }
+
+  bench_tree_t *trees[16];
+  const char *names[16];
+  int tree_count = 0;
+
+  trees[tree_count] = build_deep_tree(200);
+  names[tree_count++] = "deep-200";
+  trees[tree_count] = build_wide_tree(2000);
+  names[tree_count++] = "wide-2000";
+  trees[tree_count] = build_grid_tree(6, 4);
+  names[tree_count++] = "grid-4x6";
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc) {
+      csv_path = argv[++i];
+    } else if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+      iterations = atoi(argv[++i]);
+    } else if (argv[i][0] != '-' && tree_count < 16) {
+      bench_tree_t *tree = load_dump_tree(argv[i]);
+      if (tree != NULL) {
+        trees[tree_count] = tree;
+        names[tree_count++] = argv[i];
+      }
+    }
+  }
+
+  for (int i = 0; i < tree_count; i++) {
+    run_benchmark(names[i], trees[i], false, iterations);
+    run_benchmark(names[i], trees[i], true, iterations);
+    bench_free_tree(trees[i]);
+  }
+
+  print_results();
+  if (csv_path != NULL) {
+    write_csv(csv_path);
+  }
+  return 0;
+}
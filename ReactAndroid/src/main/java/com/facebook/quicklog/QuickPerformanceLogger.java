@@ -85,6 +85,33 @@ public class QuickPerformanceLogger {
       String tag) {
   }
 
+  /**
+   * Bulk replay of markers buffered in native code, one JNI call per bridge
+   * batch; see JSCPerfLogging.cpp for the packing. Each marker occupies six
+   * longs: kind (0 start, 1 end, 2 note, 3 cancel), markerId, instanceKey,
+   * actionId, timestamp, and the bridge batch id that triggered it.
+   * Implementations interested in attribution can record the batch id;
+   * this stub just dispatches to the single-marker methods.
+   */
+  public void markerBatch(long[] markers) {
+    for (int i = 0; i + 6 <= markers.length; i += 6) {
+      long kind = markers[i];
+      int markerId = (int) markers[i + 1];
+      int instanceKey = (int) markers[i + 2];
+      short actionId = (short) markers[i + 3];
+      long timestamp = markers[i + 4];
+      if (kind == 0) {
+        markerStart(markerId, instanceKey, timestamp);
+      } else if (kind == 1) {
+        markerEnd(markerId, instanceKey, actionId, timestamp);
+      } else if (kind == 2) {
+        markerNote(markerId, instanceKey, actionId, timestamp);
+      } else if (kind == 3) {
+        markerCancel(markerId, instanceKey);
+      }
+    }
+  }
+
   public long currentMonotonicTimestamp() {
     return 0L;
   }
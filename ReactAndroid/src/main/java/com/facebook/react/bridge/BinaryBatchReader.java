@@ -0,0 +1,199 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+package com.facebook.react.bridge;
+
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.charset.Charset;
+import java.util.Iterator;
+
+import org.json.JSONArray;
+import org.json.JSONException;
+import org.json.JSONObject;
+import org.json.JSONTokener;
+
+/**
+ * Decodes a binary-encoded batch of native module calls entirely in Java.
+ * The wire layout is produced by the native bridge and documented in
+ * react/MethodCall.h; delivering a batch through this reader costs a single
+ * JNI crossing, instead of one per call plus one per argument read through
+ * {@link ReadableNativeArray}.
+ *
+ * The buffer wraps native memory that is only valid for the duration of the
+ * {@link ReactCallback#callBatch} invocation and must not be retained.
+ */
+/* package */ class BinaryBatchReader {
+
+  // "RNB\x01" read as a little-endian uint32.
+  private static final int MAGIC = 0x01424E52;
+
+  private static final byte TAG_NULL = 0;
+  private static final byte TAG_FALSE = 1;
+  private static final byte TAG_TRUE = 2;
+  private static final byte TAG_DOUBLE = 3;
+  private static final byte TAG_INT32 = 4;
+  private static final byte TAG_STRING = 5;
+  private static final byte TAG_JSON = 6;
+  private static final byte TAG_BLOB = 7;
+
+  private static final Charset UTF8 = Charset.forName("UTF-8");
+
+  private final ByteBuffer mBuffer;
+
+  // Fields of the record most recently decoded by next().
+  /* package */ int moduleId;
+  /* package */ int methodId;
+  /* package */ int callId;
+  /* package */ JavaOnlyArray arguments;
+
+  /* package */ BinaryBatchReader(ByteBuffer buffer) {
+    mBuffer = buffer;
+    mBuffer.order(ByteOrder.LITTLE_ENDIAN);
+    if (mBuffer.remaining() < 4 || mBuffer.getInt() != MAGIC) {
+      throw new UnexpectedNativeTypeException("Payload is not a binary batch");
+    }
+  }
+
+  /* package */ boolean hasNext() {
+    return mBuffer.remaining() >= 4;
+  }
+
+  /* package */ void next() {
+    int recordLength = mBuffer.getInt();
+    int recordEnd = mBuffer.position() + recordLength;
+    moduleId = mBuffer.getInt();
+    methodId = mBuffer.getInt();
+    callId = mBuffer.getInt();
+    int argumentCount = mBuffer.getInt();
+    JavaOnlyArray args = new JavaOnlyArray();
+    for (int i = 0; i < argumentCount; i++) {
+      readArgument(args);
+    }
+    // The length prefix is authoritative; skip any suffix a newer encoder
+    // may have appended to the record.
+    mBuffer.position(recordEnd);
+    arguments = args;
+  }
+
+  private void readArgument(JavaOnlyArray out) {
+    byte tag = mBuffer.get();
+    switch (tag) {
+      case TAG_NULL:
+        out.pushNull();
+        break;
+      case TAG_FALSE:
+        out.pushBoolean(false);
+        break;
+      case TAG_TRUE:
+        out.pushBoolean(true);
+        break;
+      case TAG_DOUBLE:
+        out.pushDouble(mBuffer.getDouble());
+        break;
+      case TAG_INT32:
+        // JS numbers are doubles; stored as such so getDouble/getInt behave
+        // the same as on the JSON path.
+        out.pushDouble(mBuffer.getInt());
+        break;
+      case TAG_STRING:
+        out.pushString(readString());
+        break;
+      case TAG_JSON:
+        pushJson(out, readString());
+        break;
+      case TAG_BLOB:
+        JavaOnlyMap blob = new JavaOnlyMap();
+        blob.putString("type", "blob");
+        blob.putDouble("blobId", mBuffer.getLong());
+        blob.putDouble("offset", mBuffer.getInt());
+        blob.putDouble("size", mBuffer.getInt());
+        out.pushMap(blob);
+        break;
+      default:
+        throw new UnexpectedNativeTypeException("Unknown binary argument tag: " + tag);
+    }
+  }
+
+  private String readString() {
+    int length = mBuffer.getInt();
+    byte[] utf8 = new byte[length];
+    mBuffer.get(utf8);
+    return new String(utf8, UTF8);
+  }
+
+  private static void pushJson(JavaOnlyArray out, String json) {
+    try {
+      pushValue(out, fromJson(new JSONTokener(json).nextValue()));
+    } catch (JSONException e) {
+      throw new UnexpectedNativeTypeException("Malformed JSON argument: " + e.getMessage());
+    }
+  }
+
+  private static Object fromJson(Object value) throws JSONException {
+    if (value == null || value == JSONObject.NULL) {
+      return null;
+    }
+    if (value instanceof JSONObject) {
+      JSONObject object = (JSONObject) value;
+      JavaOnlyMap map = new JavaOnlyMap();
+      Iterator<String> keys = object.keys();
+      while (keys.hasNext()) {
+        String key = keys.next();
+        putValue(map, key, fromJson(object.get(key)));
+      }
+      return map;
+    }
+    if (value instanceof JSONArray) {
+      JSONArray jsonArray = (JSONArray) value;
+      JavaOnlyArray array = new JavaOnlyArray();
+      for (int i = 0; i < jsonArray.length(); i++) {
+        pushValue(array, fromJson(jsonArray.get(i)));
+      }
+      return array;
+    }
+    if (value instanceof Number) {
+      return ((Number) value).doubleValue();
+    }
+    // Boolean or String
+    return value;
+  }
+
+  private static void pushValue(JavaOnlyArray out, Object value) {
+    if (value == null) {
+      out.pushNull();
+    } else if (value instanceof Boolean) {
+      out.pushBoolean((Boolean) value);
+    } else if (value instanceof Double) {
+      out.pushDouble((Double) value);
+    } else if (value instanceof String) {
+      out.pushString((String) value);
+    } else if (value instanceof JavaOnlyMap) {
+      out.pushMap((JavaOnlyMap) value);
+    } else {
+      out.pushArray((JavaOnlyArray) value);
+    }
+  }
+
+  private static void putValue(JavaOnlyMap out, String key, Object value) {
+    if (value == null) {
+      out.putNull(key);
+    } else if (value instanceof Boolean) {
+      out.putBoolean(key, (Boolean) value);
+    } else if (value instanceof Double) {
+      out.putDouble(key, (Double) value);
+    } else if (value instanceof String) {
+      out.putString(key, (String) value);
+    } else if (value instanceof JavaOnlyMap) {
+      out.putMap(key, (JavaOnlyMap) value);
+    } else {
+      out.putArray(key, (JavaOnlyArray) value);
+    }
+  }
+}
@@ -13,6 +13,7 @@ import javax.annotation.Nullable;
 
 import java.io.IOException;
 import java.io.StringWriter;
+import java.nio.ByteBuffer;
 import java.util.Collection;
 import java.util.concurrent.Callable;
 import java.util.concurrent.CopyOnWriteArrayList;
@@ -433,6 +434,31 @@ public class CatalystInstanceImpl implements CatalystInstance {
       }
     }
 
+    @Override
+    public void callBatch(ExecutorToken executorToken, ByteBuffer batch) {
+      mReactQueueConfiguration.getNativeModulesQueueThread().assertIsOnThread();
+
+      synchronized (mJSToJavaCallsTeardownLock) {
+        // Suppress any callbacks if destroyed - will only lead to sadness.
+        if (mDestroyed) {
+          return;
+        }
+
+        // Decoded here rather than native-side so the whole batch costs one
+        // JNI transition; the buffer is dead once this method returns.
+        BinaryBatchReader reader = new BinaryBatchReader(batch);
+        while (reader.hasNext()) {
+          reader.next();
+          mJavaRegistry.call(
+              CatalystInstanceImpl.this,
+              executorToken,
+              reader.moduleId,
+              reader.methodId,
+              reader.arguments);
+        }
+      }
+    }
+
     @Override
     public void onBatchComplete() {
       mReactQueueConfiguration.getNativeModulesQueueThread().assertIsOnThread();
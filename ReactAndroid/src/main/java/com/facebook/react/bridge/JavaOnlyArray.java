@@ -60,12 +60,14 @@ public class JavaOnlyArray implements ReadableArray, WritableArray {
 
   @Override
   public double getDouble(int index) {
-    return (Double) mBackingList.get(index);
+    // Batches decoded by BinaryBatchReader store every JS number as a
+    // Double; accept any boxed Number like the native-backed array does.
+    return ((Number) mBackingList.get(index)).doubleValue();
   }
 
   @Override
   public int getInt(int index) {
-    return (Integer) mBackingList.get(index);
+    return ((Number) mBackingList.get(index)).intValue();
   }
 
   @Override
@@ -90,7 +92,20 @@ public class JavaOnlyArray implements ReadableArray, WritableArray {
 
   @Override
   public ReadableType getType(int index) {
-    return null;
+    Object value = mBackingList.get(index);
+    if (value == null) {
+      return ReadableType.Null;
+    } else if (value instanceof Boolean) {
+      return ReadableType.Boolean;
+    } else if (value instanceof Number) {
+      return ReadableType.Number;
+    } else if (value instanceof String) {
+      return ReadableType.String;
+    } else if (value instanceof ReadableMap) {
+      return ReadableType.Map;
+    } else {
+      return ReadableType.Array;
+    }
   }
 
   @Override
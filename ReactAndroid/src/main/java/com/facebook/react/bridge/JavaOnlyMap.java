@@ -65,12 +65,14 @@ public class JavaOnlyMap implements ReadableMap, WritableMap {
 
   @Override
   public double getDouble(String name) {
-    return (Double) mBackingMap.get(name);
+    // Batches decoded by BinaryBatchReader store every JS number as a
+    // Double; accept any boxed Number like the native-backed map does.
+    return ((Number) mBackingMap.get(name)).doubleValue();
   }
 
   @Override
   public int getInt(String name) {
-    return (Integer) mBackingMap.get(name);
+    return ((Number) mBackingMap.get(name)).intValue();
   }
 
   @Override
@@ -90,7 +92,20 @@ public class JavaOnlyMap implements ReadableMap, WritableMap {
 
   @Override
   public ReadableType getType(String name) {
-    throw new UnsupportedOperationException("Method not implemented");
+    Object value = mBackingMap.get(name);
+    if (value == null) {
+      return ReadableType.Null;
+    } else if (value instanceof Boolean) {
+      return ReadableType.Boolean;
+    } else if (value instanceof Number) {
+      return ReadableType.Number;
+    } else if (value instanceof String) {
+      return ReadableType.String;
+    } else if (value instanceof ReadableMap) {
+      return ReadableType.Map;
+    } else {
+      return ReadableType.Array;
+    }
   }
 
   @Override
@@ -29,6 +29,13 @@ public abstract class NativeArray {
   @Override
   public native String toString();
 
+  /**
+   * Writes the array as a compact typed binary encoding into a direct
+   * ByteBuffer; see NativeArray.cpp for the format. Returns the number of
+   * bytes written, or the negated required size if the buffer is too small.
+   */
+  public native int writeTypedPayload(java.nio.ByteBuffer byteBuffer);
+
   @DoNotStrip
   private HybridData mHybridData;
 }
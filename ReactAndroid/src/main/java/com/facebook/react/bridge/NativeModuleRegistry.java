@@ -54,7 +54,7 @@ public class NativeModuleRegistry {
       ExecutorToken executorToken,
       int moduleId,
       int methodId,
-      ReadableNativeArray parameters) {
+      ReadableArray parameters) {
     ModuleDefinition definition = mModuleTable.get(moduleId);
     if (definition == null) {
       throw new RuntimeException("Call to unknown module: " + moduleId);
@@ -180,7 +180,7 @@ public class NativeModuleRegistry {
         CatalystInstance catalystInstance,
         ExecutorToken executorToken,
         int methodId,
-        ReadableNativeArray parameters) {
+        ReadableArray parameters) {
       MethodRegistration method = this.methods.get(methodId);
       Systrace.beginSection(Systrace.TRACE_TAG_REACT_JAVA_BRIDGE, method.tracingName);
       try {
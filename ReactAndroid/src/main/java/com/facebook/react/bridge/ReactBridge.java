@@ -79,6 +79,24 @@ public class ReactBridge extends Countable {
    */
   public native void loadScriptFromAssets(AssetManager assetManager, String assetName);
   public native void loadScriptFromFile(@Nullable String fileName, @Nullable String sourceURL);
+
+  /**
+   * Starts reading, page-warming and hashing the given bundle file on a
+   * native background thread, overlapping with bridge construction. Safe to
+   * call before any ReactBridge instance exists; a later loadScriptFromFile
+   * with the same path picks the result up instead of loading synchronously.
+   */
+  public static native void preloadScriptFromFile(String fileName);
+  /**
+   * Applies a binary delta downloaded by an OTA update against the cached
+   * previous bundle, writing the patched bundle to outputFileName. Both the
+   * base and the patched result are hash-verified; returns false (and leaves
+   * outputFileName untouched) on any mismatch, in which case the caller
+   * should fall back to downloading the full bundle. On success the output is
+   * an ordinary bundle file for loadScriptFromFile/preloadScriptFromFile.
+   */
+  public static native boolean applyScriptDelta(
+      String baseFileName, String deltaFileName, String outputFileName);
   public native void callFunction(ExecutorToken executorToken, int moduleId, int methodId, NativeArray arguments, String tracingName);
   public native void invokeCallback(ExecutorToken executorToken, int callbackID, NativeArray arguments);
   public native void setGlobalVariable(String propertyName, String jsonEncodedArgument);
@@ -9,6 +9,8 @@
 
 package com.facebook.react.bridge;
 
+import java.nio.ByteBuffer;
+
 import com.facebook.proguard.annotations.DoNotStrip;
 
 @DoNotStrip
@@ -17,6 +19,14 @@ public interface ReactCallback {
   @DoNotStrip
   void call(ExecutorToken executorToken, int moduleId, int methodId, ReadableNativeArray parameters);
 
+  /**
+   * Delivers a whole binary-encoded batch in one JNI crossing; the records
+   * are decoded locally by {@link BinaryBatchReader}. The buffer wraps
+   * native memory and is only valid for the duration of this call.
+   */
+  @DoNotStrip
+  void callBatch(ExecutorToken executorToken, ByteBuffer batch);
+
   @DoNotStrip
   void onBatchComplete();
 
@@ -13,7 +13,11 @@ import com.facebook.jni.HybridData;
 import com.facebook.proguard.annotations.DoNotStrip;
 import com.facebook.soloader.SoLoader;
 
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.charset.Charset;
 import java.util.ArrayList;
+import java.util.HashMap;
 
 /**
  * Implementation of a NativeArray that allows read-only access to its members. This will generally
@@ -49,33 +53,87 @@ public class ReadableNativeArray extends NativeArray implements ReadableArray {
   @Override
   public native ReadableType getType(int index);
 
+  /**
+   * Bulk export of the whole array into a pinned byte[]; see
+   * ReadableNativeArray::exportTypedPayload. Returns bytes written, or the
+   * negated required size if the buffer is too small.
+   */
+  private native int exportTypedPayload(byte[] buffer);
+
+  private static final Charset UTF_8 = Charset.forName("UTF-8");
+  private static final int INITIAL_EXPORT_BUFFER_SIZE = 8 * 1024;
+
+  // Tags of the typed payload encoding; keep in sync with NativeArray.cpp.
+  private static final byte TAG_NULL = 0;
+  private static final byte TAG_FALSE = 1;
+  private static final byte TAG_TRUE = 2;
+  private static final byte TAG_DOUBLE = 3;
+  private static final byte TAG_INT32 = 4;
+  private static final byte TAG_STRING = 5;
+  private static final byte TAG_ARRAY = 6;
+  private static final byte TAG_MAP = 7;
+
+  /**
+   * Converts the whole array with one JNI crossing: the native side encodes
+   * types, sizes and primitive data into a pinned byte[] and everything is
+   * decoded locally here, instead of one accessor call (and often one fresh
+   * Java object) per element.
+   */
+  @SuppressWarnings("unchecked")
   public ArrayList<Object> toArrayList() {
-    ArrayList<Object> arrayList = new ArrayList<>();
+    byte[] buffer = new byte[INITIAL_EXPORT_BUFFER_SIZE];
+    int written = exportTypedPayload(buffer);
+    if (written < 0) {
+      buffer = new byte[-written];
+      written = exportTypedPayload(buffer);
+    }
+    ByteBuffer payload = ByteBuffer.wrap(buffer, 0, written).order(ByteOrder.LITTLE_ENDIAN);
+    return (ArrayList<Object>) decodeValue(payload);
+  }
 
-    for (int i = 0; i < this.size(); i++) {
-      switch (getType(i)) {
-        case Null:
-          arrayList.add(null);
-          break;
-        case Boolean:
-          arrayList.add(getBoolean(i));
-          break;
-        case Number:
-          arrayList.add(getDouble(i));
-          break;
-        case String:
-          arrayList.add(getString(i));
-          break;
-        case Map:
-          arrayList.add(getMap(i).toHashMap());
-          break;
-        case Array:
-          arrayList.add(getArray(i).toArrayList());
-          break;
-        default:
-          throw new IllegalArgumentException("Could not convert object at index: " + i + ".");
+  private static Object decodeValue(ByteBuffer payload) {
+    byte tag = payload.get();
+    switch (tag) {
+      case TAG_NULL:
+        return null;
+      case TAG_FALSE:
+        return Boolean.FALSE;
+      case TAG_TRUE:
+        return Boolean.TRUE;
+      case TAG_DOUBLE:
+        return payload.getDouble();
+      case TAG_INT32:
+        // Numbers always surfaced as Double, matching the accessor-based
+        // conversion this replaced.
+        return (double) payload.getInt();
+      case TAG_STRING:
+        return decodeString(payload);
+      case TAG_ARRAY: {
+        int count = payload.getInt();
+        ArrayList<Object> array = new ArrayList<>(count);
+        for (int i = 0; i < count; i++) {
+          array.add(decodeValue(payload));
+        }
+        return array;
+      }
+      case TAG_MAP: {
+        int count = payload.getInt();
+        HashMap<String, Object> map = new HashMap<>();
+        for (int i = 0; i < count; i++) {
+          String key = decodeString(payload);
+          map.put(key, decodeValue(payload));
+        }
+        return map;
       }
+      default:
+        throw new IllegalArgumentException("Unknown typed payload tag: " + tag);
     }
-    return arrayList;
+  }
+
+  private static String decodeString(ByteBuffer payload) {
+    int length = payload.getInt();
+    String value = new String(payload.array(), payload.position(), length, UTF_8);
+    payload.position(payload.position() + length);
+    return value;
   }
 }
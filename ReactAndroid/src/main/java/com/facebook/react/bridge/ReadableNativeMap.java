@@ -13,6 +13,10 @@ import com.facebook.jni.Countable;
 import com.facebook.proguard.annotations.DoNotStrip;
 import com.facebook.soloader.SoLoader;
 
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.charset.Charset;
+import java.util.ArrayList;
 import java.util.HashMap;
 
 
@@ -51,36 +55,103 @@ public class ReadableNativeMap extends NativeMap implements ReadableMap {
     return new ReadableNativeMapKeySetIterator(this);
   }
 
-  public HashMap<String, Object>toHashMap() {
-    ReadableMapKeySetIterator iterator = keySetIterator();
-    HashMap<String, Object> hashMap = new HashMap<>();
-
-    while (iterator.hasNextKey()) {
-      String key = iterator.nextKey();
-      switch (getType(key)) {
-        case Null:
-          hashMap.put(key, null);
-          break;
-        case Boolean:
-          hashMap.put(key, getBoolean(key));
-          break;
-        case Number:
-          hashMap.put(key, getDouble(key));
-          break;
-        case String:
-          hashMap.put(key, getString(key));
-          break;
-        case Map:
-          hashMap.put(key, getMap(key).toHashMap());
-          break;
-        case Array:
-          hashMap.put(key, getArray(key).toArrayList());
-          break;
-        default:
-          throw new IllegalArgumentException("Could not convert object with key: " + key + ".");
+  /**
+   * Bulk export of the whole map into a pinned byte[]; see
+   * map::readable::exportKeyedPayload in OnLoad.cpp. Keys are uint32 ids
+   * into a process-wide dictionary, and the payload is prefixed with the
+   * entries assigned past knownKeys. Returns bytes written, or the negated
+   * required size if the buffer is too small.
+   */
+  private native int exportKeyedPayload(byte[] buffer, int knownKeys);
+
+  private static final Charset UTF_8 = Charset.forName("UTF-8");
+  private static final int INITIAL_EXPORT_BUFFER_SIZE = 8 * 1024;
+
+  // Tags of the typed payload encoding; keep in sync with NativeArray.cpp.
+  private static final byte TAG_NULL = 0;
+  private static final byte TAG_FALSE = 1;
+  private static final byte TAG_TRUE = 2;
+  private static final byte TAG_DOUBLE = 3;
+  private static final byte TAG_INT32 = 4;
+  private static final byte TAG_STRING = 5;
+  private static final byte TAG_ARRAY = 6;
+  private static final byte TAG_KEYED_MAP = 8;
+
+  // Mirror of the native interned-key dictionary; ids are assigned in
+  // first-appearance order and never reused. Guards the whole
+  // export-and-decode so the reported size always matches what the native
+  // side prefixes against.
+  private static final ArrayList<String> sKeyDictionary = new ArrayList<>();
+
+  /**
+   * Converts the whole map with one JNI crossing: keys cross as dictionary
+   * ids (the property names repeated by every style and config map cross
+   * once per process), values as the same typed encoding the array bulk
+   * export uses, and everything is decoded locally here instead of one
+   * accessor call and one fresh jstring per key.
+   */
+  @SuppressWarnings("unchecked")
+  public HashMap<String, Object> toHashMap() {
+    synchronized (sKeyDictionary) {
+      byte[] buffer = new byte[INITIAL_EXPORT_BUFFER_SIZE];
+      int written = exportKeyedPayload(buffer, sKeyDictionary.size());
+      if (written < 0) {
+        buffer = new byte[-written];
+        written = exportKeyedPayload(buffer, sKeyDictionary.size());
       }
+      ByteBuffer payload = ByteBuffer.wrap(buffer, 0, written).order(ByteOrder.LITTLE_ENDIAN);
+      int newKeys = payload.getInt();
+      for (int i = 0; i < newKeys; i++) {
+        sKeyDictionary.add(decodeString(payload));
+      }
+      return (HashMap<String, Object>) decodeValue(payload);
+    }
+  }
+
+  private static Object decodeValue(ByteBuffer payload) {
+    byte tag = payload.get();
+    switch (tag) {
+      case TAG_NULL:
+        return null;
+      case TAG_FALSE:
+        return Boolean.FALSE;
+      case TAG_TRUE:
+        return Boolean.TRUE;
+      case TAG_DOUBLE:
+        return payload.getDouble();
+      case TAG_INT32:
+        // Numbers always surfaced as Double, matching the accessor-based
+        // conversion this replaced.
+        return (double) payload.getInt();
+      case TAG_STRING:
+        return decodeString(payload);
+      case TAG_ARRAY: {
+        int count = payload.getInt();
+        ArrayList<Object> array = new ArrayList<>(count);
+        for (int i = 0; i < count; i++) {
+          array.add(decodeValue(payload));
+        }
+        return array;
+      }
+      case TAG_KEYED_MAP: {
+        int count = payload.getInt();
+        HashMap<String, Object> map = new HashMap<>();
+        for (int i = 0; i < count; i++) {
+          String key = sKeyDictionary.get(payload.getInt());
+          map.put(key, decodeValue(payload));
+        }
+        return map;
+      }
+      default:
+        throw new IllegalArgumentException("Unknown typed payload tag: " + tag);
     }
-    return hashMap;
+  }
+
+  private static String decodeString(ByteBuffer payload) {
+    int length = payload.getInt();
+    String value = new String(payload.array(), payload.position(), length, UTF_8);
+    payload.position(payload.position() + length);
+    return value;
   }
 
   /**
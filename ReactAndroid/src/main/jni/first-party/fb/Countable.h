@@ -9,6 +9,9 @@
 
 #pragma once
 #include <atomic>
+#ifndef NDEBUG
+#include <thread>
+#endif
 #include <fb/assert.h>
 #include <fb/noncopyable.h>
 #include <fb/nonmovable.h>
@@ -44,4 +47,55 @@ private:
   std::atomic<int> m_refcount;
 };
 
+// Refcount base for objects whose references are only ever taken and dropped
+// on one thread, so increments can be plain instead of atomic. RefPtr works
+// with it unchanged. The owning thread is whichever thread takes the first
+// reference; in debug builds every ref/unref asserts it runs there. Note that
+// objects attached to Java via setCountableForJava must keep using Countable:
+// that plumbing type-erases through RefPtr<Countable>, and the Java side can
+// touch the object from any thread.
+class ThreadAffineCountable : public noncopyable, public nonmovable {
+public:
+  // RefPtr expects refcount to start at 0
+  ThreadAffineCountable() : m_refcount(0) {}
+  virtual ~ThreadAffineCountable()
+  {
+    FBASSERT(m_refcount == 0);
+  }
+
+private:
+  void ref() {
+    debugCheckThread();
+    ++m_refcount;
+  }
+
+  void unref() {
+    debugCheckThread();
+    if (0 == --m_refcount) {
+      delete this;
+    }
+  }
+
+  bool hasOnlyOneRef() const {
+    return m_refcount == 1;
+  }
+
+#ifdef NDEBUG
+  void debugCheckThread() {}
+#else
+  void debugCheckThread() {
+    if (m_owner == std::thread::id()) {
+      m_owner = std::this_thread::get_id();
+    }
+    FBASSERTMSGF(
+        m_owner == std::this_thread::get_id(),
+        "ThreadAffineCountable ref'd from a second thread; use Countable");
+  }
+  std::thread::id m_owner;
+#endif
+
+  template <typename T> friend class RefPtr;
+  int m_refcount;
+};
+
 }
@@ -33,6 +33,12 @@ namespace facebook {
  *
  * So, syntax-wise it's similar to pointers. T can be primitive types, and if
  * it's a class, there has to be a default constructor.
+ *
+ * Reads are served from a C++11 thread_local cache (a single TLS slot read),
+ * validated against the owning instance; the pthread key is kept only so the
+ * cleanup function still runs at thread exit. On Android pthread_getspecific
+ * is an out-of-line call, and hot wrappers like jni::Environment::current()
+ * hit this on effectively every JNI boundary crossing.
  */
 template<typename T>
 class ThreadLocal {
@@ -69,27 +75,65 @@ public:
   }
 
   T *get() const {
-    return (T*)pthread_getspecific(m_key);
+    if (tl_cacheOwner == this) {
+      return tl_cachedValue;
+    }
+    return getSlow();
   }
 
   T* release() {
-    T* obj = get();
-    pthread_setspecific(m_key, NULL);
+    Node* node = (Node*)pthread_getspecific(m_key);
+    T* obj = node ? node->value : NULL;
+    if (node) {
+      pthread_setspecific(m_key, NULL);
+      delete node;
+    }
+    cache(NULL);
     return obj;
   }
 
   void reset(T* other = NULL) {
-    T* old = (T*)pthread_getspecific(m_key);
+    Node* node = (Node*)pthread_getspecific(m_key);
+    T* old = node ? node->value : NULL;
     if (old != other) {
       FBASSERT(m_cleanup);
       m_cleanup(old);
-      pthread_setspecific(m_key, other);
+      if (other == NULL) {
+        pthread_setspecific(m_key, NULL);
+        delete node;
+      } else if (node) {
+        node->value = other;
+      } else {
+        pthread_setspecific(m_key, new Node(other, m_cleanup));
+      }
     }
+    cache(other);
   }
 
 private:
+  // What actually sits in the pthread slot: carrying the cleanup function
+  // along lets the thread-exit trampoline below stay static, so it can drop
+  // the thread_local cache before user cleanup runs on the value.
+  struct Node {
+    Node(T* value, CleanupFunction cleanup) : value(value), cleanup(cleanup) {}
+    T* value;
+    CleanupFunction cleanup;
+  };
+
+  T* getSlow() const {
+    Node* node = (Node*)pthread_getspecific(m_key);
+    T* value = node ? node->value : NULL;
+    cache(value);
+    return value;
+  }
+
+  void cache(T* value) const {
+    tl_cacheOwner = this;
+    tl_cachedValue = value;
+  }
+
   void initialize() {
-    int ret = pthread_key_create(&m_key, m_cleanup);
+    int ret = pthread_key_create(&m_key, OnThreadExitTrampoline);
     if (ret != 0) {
       const char *msg = "(unknown error)";
       switch (ret) {
@@ -111,8 +155,27 @@ private:
     }
   }
 
+  static void OnThreadExitTrampoline(void* data) {
+    Node* node = (Node*)data;
+    // This thread is going away; whatever instance populated the cache here,
+    // the cached value must not outlive user cleanup.
+    tl_cacheOwner = NULL;
+    tl_cachedValue = NULL;
+    node->cleanup(node->value);
+    delete node;
+  }
+
+  static thread_local const ThreadLocal* tl_cacheOwner;
+  static thread_local T* tl_cachedValue;
+
   pthread_key_t m_key;
   CleanupFunction m_cleanup;
 };
 
+template<typename T>
+thread_local const ThreadLocal<T>* ThreadLocal<T>::tl_cacheOwner = NULL;
+
+template<typename T>
+thread_local T* ThreadLocal<T>::tl_cachedValue = NULL;
+
 }
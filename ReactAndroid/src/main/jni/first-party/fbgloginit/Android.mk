@@ -2,6 +2,7 @@ LOCAL_PATH:= $(call my-dir)
 include $(CLEAR_VARS)
 
 LOCAL_SRC_FILES:= \
+       async_log_sink.cpp \
        glog_init.cpp
 
 LOCAL_C_INCLUDES := $(LOCAL_PATH)
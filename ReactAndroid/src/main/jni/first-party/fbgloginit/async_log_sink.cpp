@@ -0,0 +1,188 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "fb/async_log_sink.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace facebook { namespace gloginit {
+
+namespace {
+
+/**
+ * A copied log message. Fixed-size so enqueueing never allocates; messages
+ * longer than the slot are truncated, which for logcat-bound output is
+ * already the platform's behavior.
+ */
+struct LogRecord {
+  google::LogSeverity severity;
+  int line;
+  struct ::tm tmTime;
+  unsigned short messageLen;
+  char filename[64];
+  char message[256];
+};
+
+size_t copyTruncated(char* dst, size_t dstSize, const char* src, size_t srcLen) {
+  size_t len = srcLen < dstSize - 1 ? srcLen : dstSize - 1;
+  memcpy(dst, src, len);
+  dst[len] = '\0';
+  return len;
+}
+
+// Power of two; at ~340 bytes/record this is ~43KB per logging thread.
+const uint32_t kSlots = 128;
+
+/**
+ * Single-producer (the owning thread) single-consumer (the drainer) ring.
+ * The producer only writes head, the consumer only writes tail; each reads
+ * the other's index with acquire to pair with the release store.
+ */
+struct ThreadRing {
+  bool push(
+      google::LogSeverity severity,
+      const char* filename,
+      int line,
+      const struct ::tm* tmTime,
+      const char* message,
+      size_t messageLen) {
+    uint32_t head = this->head.load(std::memory_order_relaxed);
+    uint32_t tail = this->tail.load(std::memory_order_acquire);
+    if (head - tail >= kSlots) {
+      dropped.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    LogRecord& slot = slots[head & (kSlots - 1)];
+    slot.severity = severity;
+    slot.line = line;
+    if (tmTime) {
+      slot.tmTime = *tmTime;
+    } else {
+      memset(&slot.tmTime, 0, sizeof(slot.tmTime));
+    }
+    copyTruncated(slot.filename, sizeof(slot.filename), filename, strlen(filename));
+    slot.messageLen = (unsigned short)copyTruncated(
+        slot.message, sizeof(slot.message), message, messageLen);
+    this->head.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Drainer only.
+  void drainTo(google::LogSink* downstream) {
+    uint32_t tail = this->tail.load(std::memory_order_relaxed);
+    uint32_t head = this->head.load(std::memory_order_acquire);
+    while (tail != head) {
+      const LogRecord& slot = slots[tail & (kSlots - 1)];
+      downstream->send(
+          slot.severity,
+          slot.filename,
+          slot.filename,
+          slot.line,
+          &slot.tmTime,
+          slot.message,
+          slot.messageLen);
+      ++tail;
+      this->tail.store(tail, std::memory_order_release);
+    }
+
+    // Only report drops once the ring has headroom again, so the report
+    // itself isn't fighting the storm that caused them.
+    uint64_t droppedNow = dropped.exchange(0, std::memory_order_relaxed);
+    if (droppedNow != 0) {
+      char buf[80];
+      int len = snprintf(
+          buf, sizeof(buf),
+          "async log sink dropped %llu messages",
+          (unsigned long long)droppedNow);
+      struct ::tm zeroTime;
+      memset(&zeroTime, 0, sizeof(zeroTime));
+      downstream->send(
+          google::GLOG_WARNING,
+          "async_log_sink.cpp",
+          "async_log_sink.cpp",
+          0,
+          &zeroTime,
+          buf,
+          (size_t)len);
+    }
+  }
+
+  std::atomic<uint32_t> head{0};
+  std::atomic<uint32_t> tail{0};
+  std::atomic<uint64_t> dropped{0};
+  LogRecord slots[kSlots];
+};
+
+// Guards the ring registry; never taken on the logging fast path. Rings are
+// registered once and deliberately never freed, so a message logged during
+// thread teardown still drains. Bounded by thread count.
+std::mutex s_registryMutex;
+std::vector<ThreadRing*> s_rings;
+
+ThreadRing* ringForThisThread() {
+  static thread_local ThreadRing* ring = nullptr;
+  if (!ring) {
+    ring = new ThreadRing();
+    std::lock_guard<std::mutex> lock(s_registryMutex);
+    s_rings.push_back(ring);
+  }
+  return ring;
+}
+
+class AsyncLogSink : public google::LogSink {
+ public:
+  explicit AsyncLogSink(google::LogSink* downstream)
+      : m_downstream(downstream) {
+    std::thread([this] { drainLoop(); }).detach();
+  }
+
+  void send(
+      google::LogSeverity severity,
+      const char* full_filename,
+      const char* base_filename,
+      int line,
+      const struct ::tm* tm_time,
+      const char* message,
+      size_t message_len) override {
+    if (severity >= google::GLOG_FATAL) {
+      // The process aborts once glog finishes with this message; the
+      // drainer won't get to run, so write it through synchronously.
+      m_downstream->send(
+          severity, full_filename, base_filename, line, tm_time,
+          message, message_len);
+      return;
+    }
+    ringForThisThread()->push(
+        severity, base_filename, line, tm_time, message, message_len);
+  }
+
+ private:
+  void drainLoop() {
+    std::vector<ThreadRing*> rings;
+    for (;;) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+      {
+        std::lock_guard<std::mutex> lock(s_registryMutex);
+        rings = s_rings;
+      }
+      for (ThreadRing* ring : rings) {
+        ring->drainTo(m_downstream);
+      }
+    }
+  }
+
+  google::LogSink* m_downstream;
+};
+
+} // namespace
+
+google::LogSink* makeAsyncSink(google::LogSink* downstream) {
+  return new AsyncLogSink(downstream);
+}
+
+}}
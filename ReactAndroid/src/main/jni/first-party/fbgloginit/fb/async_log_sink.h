@@ -0,0 +1,28 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include <glog/logging.h>
+
+namespace facebook { namespace gloginit {
+
+/**
+ * Wraps a LogSink so LOG() callers never block on formatting or I/O.
+ *
+ * glog invokes sinks synchronously on the logging thread, with its global
+ * lock held; a slow downstream (logcat writes, file I/O) therefore stalls
+ * every concurrent logger. The returned sink instead copies each message
+ * into a lock-free per-thread ring buffer and returns; a single drainer
+ * thread forwards the records to `downstream`. When a thread's ring is
+ * full the message is dropped and counted, never blocked on, and the
+ * drainer reports the drop count downstream once the storm subsides.
+ *
+ * FATAL messages bypass the ring and go straight to `downstream`: the
+ * process is about to abort and the drainer would not get to run.
+ *
+ * Takes ownership of `downstream`. The sink and its drainer thread live
+ * for the rest of the process.
+ */
+google::LogSink* makeAsyncSink(google::LogSink* downstream);
+
+}}
@@ -2,6 +2,8 @@
 
 #include "fb/glog_init.h"
 
+#include "fb/async_log_sink.h"
+
 #include <iostream>
 #include <mutex>
 #include <stdexcept>
@@ -86,7 +88,10 @@ static google::LogSink* make_sink(const std::string& tag) {
 }
 
 static void sendGlogOutputToLogcat(const char* tag) {
-  google::AddLogSink(make_sink(tag));
+  // Logcat writes are synchronous and happen under glog's global lock, so
+  // warning storms on hot paths (e.g. bridge queue drops) stall every
+  // logging thread. The async wrapper moves them off the callers' threads.
+  google::AddLogSink(facebook::gloginit::makeAsyncSink(make_sink(tag)));
 
   // Disable logging to files
   for (auto i = 0; i < google::NUM_SEVERITIES; ++i) {
@@ -31,6 +31,14 @@ struct HybridData : public JavaClass<HybridData> {
   static local_ref<HybridData> create();
 };
 
+// Pre-resolved field ids for the hybrid dispatch path, so every registered
+// native method doesn't re-walk the field wrappers per call; see
+// HybridClass::JavaPart::hybridFieldIds().
+struct HybridFieldIds {
+  jfieldID hybridData;
+  jfieldID nativePointer;
+};
+
 template <typename Base, typename Enabled = void>
 struct HybridTraits {
   // This static assert should actually always fail if we don't use one of the
@@ -106,6 +114,10 @@ public:
     // the mHybridData and return it.
     T* cthis();
 
+    // The dispatch field ids for this class, resolved once (registerHybrid
+    // warms them at class load) so cthis() is two raw JNI field reads.
+    static const detail::HybridFieldIds& hybridFieldIds();
+
     friend class HybridClass;
   };
 
@@ -131,7 +143,11 @@ protected:
   using detail::HybridTraits<Base>::CxxBase::CxxBase;
 
   static void registerHybrid(std::initializer_list<NativeMethod> methods) {
+    // One RegisterNatives batch for the whole method table, then resolve the
+    // dispatch field ids while we're still in class load so the first hybrid
+    // call doesn't pay for it.
     javaClassStatic()->registerNatives(methods);
+    JavaPart::hybridFieldIds();
   }
 
   static local_ref<detail::HybridData> makeHybridData(std::unique_ptr<T> cxxPart) {
@@ -190,16 +206,33 @@ public:
   static void mapException(const std::exception& ex) {}
 };
 
+template <typename T, typename B>
+const detail::HybridFieldIds& HybridClass<T, B>::JavaPart::hybridFieldIds() {
+  static const detail::HybridFieldIds ids = {
+    HybridClass<T, B>::JavaPart::javaClassStatic()
+        ->template getField<detail::HybridData::javaobject>("mHybridData").getId(),
+    detail::HybridData::javaClassStatic()->getField<jlong>("mNativePointer").getId(),
+  };
+  return ids;
+}
+
 template <typename T, typename B>
 inline T* HybridClass<T, B>::JavaPart::cthis() {
-  static auto field =
-    HybridClass<T, B>::JavaPart::javaClassStatic()->template getField<detail::HybridData::javaobject>("mHybridData");
-  auto hybridData = this->getFieldValue(field);
+  // Raw reads through the pre-resolved field ids: no wrapper local_ref for
+  // the HybridData hop and no second guarded-static check per call.
+  const detail::HybridFieldIds& ids = hybridFieldIds();
+  const auto env = internal::getEnv();
+  jobject hybridData = env->GetObjectField(this->self(), ids.hybridData);
   if (!hybridData) {
     throwNewJavaException("java/lang/NullPointerException", "java.lang.NullPointerException");
   }
+  jlong pointer = env->GetLongField(hybridData, ids.nativePointer);
+  env->DeleteLocalRef(hybridData);
+  if (!pointer) {
+    throwNewJavaException("java/lang/NullPointerException", "java.lang.NullPointerException");
+  }
   // I'd like to use dynamic_cast here, but -fno-rtti is the default.
-  T* value = static_cast<T*>(hybridData->getNativePointer());
+  T* value = static_cast<T*>(reinterpret_cast<detail::BaseHybridClass*>(pointer));
   // This would require some serious programmer error.
   FBASSERTMSGF(value != 0, "Incorrect C++ type in hybrid field");
   return value;
@@ -5,12 +5,29 @@ include $(CLEAR_VARS)
 LOCAL_MODULE := libreactnative
 
 LOCAL_SRC_FILES := \
+  BlobRegistry.cpp \
   Bridge.cpp \
+  BridgeMetrics.cpp \
+  BundleDelta.cpp \
+  CallNameTable.cpp \
+  HMRUpdateCache.cpp \
   JSCExecutor.cpp \
+  JSCHeapTuning.cpp \
   JSCHelpers.cpp \
+  JSCPerfSampler.cpp \
+  JSCSamplingProfiler.cpp \
+  JSCSourceCache.cpp \
   MethodCall.cpp \
+  MetricsRing.cpp \
+  NativeMessageQueueThread.cpp \
+  PackedUnbundle.cpp \
+  ParallelJson.cpp \
   Platform.cpp \
+  ThreadScheduling.cpp \
+  TraceRecorder.cpp \
+  UnbundlePrefetcher.cpp \
   Value.cpp \
+  WorkerScriptCache.cpp \
 
 LOCAL_C_INCLUDES := $(LOCAL_PATH)/..
 LOCAL_EXPORT_C_INCLUDES := $(LOCAL_C_INCLUDES)
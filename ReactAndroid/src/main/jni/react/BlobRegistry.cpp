@@ -0,0 +1,48 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "BlobRegistry.h"
+
+#include <mutex>
+#include <unordered_map>
+
+namespace facebook {
+namespace react {
+namespace BlobRegistry {
+
+namespace {
+
+// One mutex for the handful of store/get/release calls per payload; blob
+// traffic is measured in frames per second, not calls per microsecond.
+std::mutex s_mutex;
+std::unordered_map<uint64_t, std::shared_ptr<const std::string>>& blobs() {
+  static std::unordered_map<uint64_t, std::shared_ptr<const std::string>> map;
+  return map;
+}
+uint64_t s_nextBlobId = 1;
+
+} // namespace
+
+uint64_t store(std::string&& bytes) {
+  auto blob = std::make_shared<const std::string>(std::move(bytes));
+  std::lock_guard<std::mutex> lock(s_mutex);
+  uint64_t blobId = s_nextBlobId++;
+  blobs().emplace(blobId, std::move(blob));
+  return blobId;
+}
+
+std::shared_ptr<const std::string> get(uint64_t blobId) {
+  std::lock_guard<std::mutex> lock(s_mutex);
+  auto it = blobs().find(blobId);
+  if (it == blobs().end()) {
+    return nullptr;
+  }
+  return it->second;
+}
+
+bool release(uint64_t blobId) {
+  std::lock_guard<std::mutex> lock(s_mutex);
+  return blobs().erase(blobId) != 0;
+}
+
+} // namespace BlobRegistry
+} }
@@ -0,0 +1,45 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace facebook {
+namespace react {
+
+/**
+ * Process-wide store for binary payloads crossing the bridge by reference.
+ *
+ * Instead of base64-encoding bytes into JSON arguments, a producer stores
+ * them here and sends only the id (see BinaryArgument::Blob in MethodCall.h);
+ * the consumer resolves the id back to the bytes on its side of the bridge —
+ * on the JS side as a zero-copy Uint8Array view via nativeBlobTypedArray.
+ *
+ * Blobs are refcounted by the returned shared_ptr: release() drops the
+ * registry's reference, but outstanding views (e.g. a typed array JS hasn't
+ * collected yet) keep the bytes alive. Whichever side consumes a blob is
+ * responsible for releasing it; an unreleased blob leaks for the process
+ * lifetime, so ids should not be treated as durable handles.
+ */
+namespace BlobRegistry {
+
+/**
+ * Stores the bytes and returns their id (never 0).
+ */
+uint64_t store(std::string&& bytes);
+
+/**
+ * Returns the bytes for an id, or null if the id is unknown or released.
+ */
+std::shared_ptr<const std::string> get(uint64_t blobId);
+
+/**
+ * Drops the registry's reference; returns whether the id was live.
+ */
+bool release(uint64_t blobId);
+
+} // namespace BlobRegistry
+
+} }
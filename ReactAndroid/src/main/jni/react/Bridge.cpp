@@ -2,6 +2,15 @@
 
 #include "Bridge.h"
 
+#include <chrono>
+#include <new>
+#include <thread>
+#include <type_traits>
+
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
 #ifdef WITH_FBSYSTRACE
 #include <fbsystrace.h>
 using fbsystrace::FbSystraceSection;
@@ -9,11 +18,148 @@ using fbsystrace::FbSystraceAsyncFlow;
 #endif
 #include <folly/Memory.h>
 
+#include "MetricsRing.h"
 #include "Platform.h"
+#include "TraceRecorder.h"
 
 namespace facebook {
 namespace react {
 
+#ifdef WITH_FBSYSTRACE
+namespace {
+
+// Async-flow cookies only need process-wide uniqueness, so each thread grabs
+// a block at a time: the steady-state cost is a thread-local increment
+// instead of a contended RMW on a cache line shared with other bridge state.
+int nextSystraceCookie() {
+  static const int kCookieBlock = 256;
+  static std::atomic<int> s_nextCookieBlock(0);
+  static thread_local int tl_next = 0;
+  static thread_local int tl_limit = 0;
+  if (tl_next == tl_limit) {
+    tl_next = s_nextCookieBlock.fetch_add(kCookieBlock, std::memory_order_relaxed);
+    tl_limit = tl_next + kCookieBlock;
+  }
+  return tl_next++;
+}
+
+// FbSystraceSection whose construction is skipped entirely when tracing was
+// off at enqueue time; the begin/end flow pair already carries that decision
+// in the cookie, so dispatch lambdas pay nothing when atrace is disabled.
+class TracedSection {
+public:
+  TracedSection(bool enabled, uint64_t tag, const char* name) : enabled_(enabled) {
+    if (enabled_) {
+      new (&storage_) FbSystraceSection(tag, name);
+    }
+  }
+  ~TracedSection() {
+    if (enabled_) {
+      reinterpret_cast<FbSystraceSection*>(&storage_)->~FbSystraceSection();
+    }
+  }
+private:
+  bool enabled_;
+  typename std::aligned_storage<sizeof(FbSystraceSection), alignof(FbSystraceSection)>::type storage_;
+};
+
+}
+#endif
+
+namespace {
+
+// Nice level for the headless task thread; matches
+// android.os.Process.THREAD_PRIORITY_BACKGROUND.
+const int kHeadlessTaskNice = 10;
+
+/**
+ * MessageQueueThread backed by a plain std::thread, for executors that have
+ * no Java looper behind them. The thread drops itself to background priority
+ * before running anything, so queued work never competes with the
+ * interactive JS thread for CPU.
+ */
+class HeadlessTaskThread : public MessageQueueThread {
+public:
+  HeadlessTaskThread() {
+    m_thread = std::thread([this] {
+      setpriority(PRIO_PROCESS, syscall(SYS_gettid), kHeadlessTaskNice);
+      runLoop();
+    });
+  }
+
+  ~HeadlessTaskThread() override {
+    quitSynchronous();
+  }
+
+  void runOnQueue(MessageQueueTask&& task) override {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (m_quitting) {
+        // Posts to a quit queue drop, like posts to a dead Java looper.
+        return;
+      }
+      m_tasks.push_back(std::move(task));
+    }
+    m_cv.notify_one();
+  }
+
+  bool isOnThread() override {
+    return std::this_thread::get_id() == m_thread.get_id();
+  }
+
+  void quitSynchronous() override {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_quitting = true;
+    }
+    m_cv.notify_one();
+    if (m_thread.joinable()) {
+      m_thread.join();
+    }
+  }
+
+private:
+  void runLoop() {
+    for (;;) {
+      MessageQueueTask task;
+      {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_cv.wait(lock, [this] { return m_quitting || !m_tasks.empty(); });
+        // Already-queued work drains before the quit takes effect, so a
+        // destroy() posted just before quitSynchronous still runs.
+        if (m_tasks.empty()) {
+          return;
+        }
+        task = std::move(m_tasks.front());
+        m_tasks.pop_front();
+      }
+      task();
+    }
+  }
+
+  std::thread m_thread;
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  std::deque<MessageQueueTask> m_tasks;
+  bool m_quitting = false;
+};
+
+// Runs an unregistered executor's teardown off the caller. Once an executor
+// is out of the registry nothing dispatches to it anymore, so the full JSC
+// teardown (context release plus its final GC) can happen while a fresh
+// bridge is already booting. destroy() still hops to the executor's VM
+// thread internally, so the reaper blocks there in the caller's place; the
+// VM thread has to keep pumping until the teardown task runs.
+void reapExecutor(std::unique_ptr<JSExecutor> executor) {
+  std::thread([executor = std::move(executor)] () mutable {
+    setpriority(PRIO_PROCESS, syscall(SYS_gettid), kHeadlessTaskNice);
+    executor->destroy();
+    executor.reset();
+  }).detach();
+}
+
+} // namespace
+
 Bridge::Bridge(
     JSExecutorFactory* jsExecutorFactory,
     std::unique_ptr<ExecutorTokenFactory> executorTokenFactory,
@@ -21,12 +167,33 @@ Bridge::Bridge(
   m_callback(std::move(callback)),
   m_destroyed(std::make_shared<std::atomic_bool>(false)),
   m_executorTokenFactory(std::move(executorTokenFactory)) {
+  // Retained for startHeadlessTaskExecutor; factories outlive their bridges.
+  m_executorFactory = jsExecutorFactory;
   std::unique_ptr<JSExecutor> mainExecutor = jsExecutorFactory->createJSExecutor(this);
-  // cached to avoid locked map lookup in the common case
+  // cached to avoid locked map lookups in the common case
   m_mainExecutor = mainExecutor.get();
+  m_mainMessageQueueThread = MessageQueues::getCurrentMessageQueueThread();
   m_mainExecutorToken = folly::make_unique<ExecutorToken>(registerExecutor(
       std::move(mainExecutor),
-      MessageQueues::getCurrentMessageQueueThread()));
+      m_mainMessageQueueThread));
+}
+
+Bridge::Bridge(
+    Bridge* hostBridge,
+    std::unique_ptr<ExecutorTokenFactory> executorTokenFactory,
+    std::unique_ptr<BridgeCallback> callback) :
+  m_callback(std::move(callback)),
+  m_destroyed(std::make_shared<std::atomic_bool>(false)),
+  m_executorTokenFactory(std::move(executorTokenFactory)) {
+  // A surface has no executor of its own: it shares the host's VM and JS
+  // thread, keeps a token only for the callback protocol, and gets a surface
+  // id for routing flushed queues back here.
+  m_hostBridge = hostBridge;
+  m_mainExecutor = hostBridge->m_mainExecutor;
+  m_mainMessageQueueThread = hostBridge->m_mainMessageQueueThread;
+  m_mainExecutorToken = folly::make_unique<ExecutorToken>(
+      m_executorTokenFactory->createExecutorToken());
+  m_surfaceId = hostBridge->registerSurface(this);
 }
 
 // This must be called on the same thread on which the constructor was called.
@@ -40,69 +207,214 @@ void Bridge::loadApplicationScript(const std::string& script, const std::string&
   });
 }
 
+void Bridge::loadApplicationScript(
+    std::unique_ptr<const JSBigString> script,
+    const std::string& sourceURL) {
+  // The buffer is retained (shared, not copied) so a headless task executor
+  // started later can evaluate the same bytes; see startHeadlessTaskExecutor.
+  std::shared_ptr<const JSBigString> shared(std::move(script));
+  {
+    std::lock_guard<std::mutex> lock(m_headlessMutex);
+    m_bundleScript = shared;
+    m_bundleSourceURL = sourceURL;
+  }
+  runOnExecutorQueue(
+      *m_mainExecutorToken,
+      [shared, sourceURL] (JSExecutor* executor) {
+    executor->loadApplicationScript(
+        folly::make_unique<JSBigSharedString>(shared), sourceURL);
+  });
+}
+
 void Bridge::loadApplicationUnbundle(
     std::unique_ptr<JSModulesUnbundle> unbundle,
     const std::string& startupCode,
     const std::string& sourceURL) {
   runOnExecutorQueue(
       *m_mainExecutorToken,
-      [holder=std::make_shared<std::unique_ptr<JSModulesUnbundle>>(std::move(unbundle)), startupCode, sourceURL]
+      [unbundle=std::move(unbundle), startupCode, sourceURL]
         (JSExecutor* executor) mutable {
-    executor->loadApplicationUnbundle(std::move(*holder), startupCode, sourceURL);
+    executor->loadApplicationUnbundle(std::move(unbundle), startupCode, sourceURL);
+  });
+}
+
+void Bridge::callFunctionBatch(ExecutorToken executorToken, std::vector<JSFunctionCall>&& calls) {
+  if (calls.empty()) {
+    return;
+  }
+  if (m_surfaceId != 0) {
+    // The executor's batch entry point flushes through the plain (host)
+    // path; keep surface calls on the surface-tagged dispatch instead.
+    for (auto& call : calls) {
+      callFunction(executorToken, call.moduleId, call.methodId, call.arguments,
+                   "JSCall__" + call.moduleId + "_" + call.methodId);
+    }
+    return;
+  }
+  runOnExecutorQueue(
+      executorToken,
+      [calls=std::move(calls)] (JSExecutor* executor) mutable {
+    executor->callFunctionBatch(std::move(calls));
   });
 }
 
+void Bridge::setCallCoalescingEnabled(bool enabled) {
+  m_callCoalescingEnabled.store(enabled, std::memory_order_relaxed);
+  if (!enabled) {
+    // Flush anything already gathered so calls aren't stranded.
+    std::vector<JSFunctionCall> pending;
+    {
+      std::lock_guard<std::mutex> lock(m_pendingCallsMutex);
+      pending.swap(m_pendingCalls);
+      m_pendingCallFlushScheduled = false;
+    }
+    callFunctionBatch(*m_mainExecutorToken, std::move(pending));
+  }
+}
+
 void Bridge::callFunction(
     ExecutorToken executorToken,
     const std::string& moduleId,
     const std::string& methodId,
     const folly::dynamic& arguments,
     const std::string& tracingName) {
-  #ifdef WITH_FBSYSTRACE
-  int systraceCookie = m_systraceCookie++;
-  FbSystraceAsyncFlow::begin(
-      TRACE_TAG_REACT_CXX_BRIDGE,
-      tracingName.c_str(),
-      systraceCookie);
-  #endif
+  if (m_hostBridge == nullptr &&
+      m_callCoalescingEnabled.load(std::memory_order_relaxed) &&
+      m_mainExecutorToken && executorToken == *m_mainExecutorToken) {
+    bool shouldSchedule;
+    {
+      std::lock_guard<std::mutex> lock(m_pendingCallsMutex);
+      m_pendingCalls.push_back(JSFunctionCall{moduleId, methodId, arguments});
+      shouldSchedule = !m_pendingCallFlushScheduled;
+      m_pendingCallFlushScheduled = true;
+    }
+    if (shouldSchedule) {
+      // All calls that land before the executor thread runs this task ride
+      // along in the same batch.
+      runOnExecutorQueue(executorToken, [this] (JSExecutor* executor) {
+        std::vector<JSFunctionCall> pending;
+        {
+          std::lock_guard<std::mutex> lock(m_pendingCallsMutex);
+          pending.swap(m_pendingCalls);
+          m_pendingCallFlushScheduled = false;
+        }
+        executor->callFunctionBatch(std::move(pending));
+      });
+    }
+    return;
+  }
 
   #ifdef WITH_FBSYSTRACE
-  runOnExecutorQueue(executorToken, [moduleId, methodId, arguments, tracingName, systraceCookie] (JSExecutor* executor) {
-    FbSystraceAsyncFlow::end(
+  // One relaxed enabled probe up front: with atrace off, no cookie is
+  // allocated and no flow/section objects are built on either side of the
+  // queue.
+  int systraceCookie = -1;
+  if (fbsystrace_is_tracing(TRACE_TAG_REACT_CXX_BRIDGE)) {
+    systraceCookie = nextSystraceCookie();
+    FbSystraceAsyncFlow::begin(
         TRACE_TAG_REACT_CXX_BRIDGE,
         tracingName.c_str(),
         systraceCookie);
-    FbSystraceSection s(TRACE_TAG_REACT_CXX_BRIDGE, tracingName.c_str());
+  }
+  #endif
+
+  uint64_t enqueueMicros = BridgeMetrics::nowMicros();
+  #ifdef WITH_FBSYSTRACE
+  runOnExecutorQueue(executorToken, [this, moduleId, methodId, arguments, tracingName, enqueueMicros, systraceCookie] (JSExecutor* executor) {
+    if (systraceCookie != -1) {
+      FbSystraceAsyncFlow::end(
+          TRACE_TAG_REACT_CXX_BRIDGE,
+          tracingName.c_str(),
+          systraceCookie);
+    }
+    TracedSection s(systraceCookie != -1, TRACE_TAG_REACT_CXX_BRIDGE, tracingName.c_str());
   #else
-  runOnExecutorQueue(executorToken, [moduleId, methodId, arguments, tracingName] (JSExecutor* executor) {
+  runOnExecutorQueue(executorToken, [this, moduleId, methodId, arguments, tracingName, enqueueMicros] (JSExecutor* executor) {
   #endif
+    m_metrics.record(tracingName, BridgeMetrics::nowMicros() - enqueueMicros);
+    TraceRecorder::Section ts(tracingName.c_str());
     // This is safe because we are running on the executor's thread: it won't
     // destruct until after it's been unregistered (which we check above) and
     // that will happen on this thread
-    executor->callFunction(moduleId, methodId, arguments);
+    if (m_surfaceId != 0) {
+      executor->callFunctionOnSurface(m_surfaceId, moduleId, methodId, arguments);
+    } else {
+      executor->callFunction(moduleId, methodId, arguments);
+    }
   });
 }
 
-void Bridge::invokeCallback(ExecutorToken executorToken, const double callbackId, const folly::dynamic& arguments) {
-  #ifdef WITH_FBSYSTRACE
-  int systraceCookie = m_systraceCookie++;
-  FbSystraceAsyncFlow::begin(
-      TRACE_TAG_REACT_CXX_BRIDGE,
-      "<callback>",
-      systraceCookie);
-  #endif
+uint32_t Bridge::internCallName(
+    const std::string& moduleId,
+    const std::string& methodId,
+    const std::string& tracingName) {
+  return m_callNames.intern(moduleId, methodId, tracingName);
+}
+
+void Bridge::callFunction(
+    ExecutorToken executorToken,
+    uint32_t callHandle,
+    const folly::dynamic& arguments) {
+  if (m_surfaceId != 0) {
+    // Surface dispatch needs the surface-tagged entry point, which only the
+    // string path knows how to take; surfaces are not the hot main bridge,
+    // so losing the handle optimization there is fine.
+    const CallName& name = m_callNames.lookup(callHandle);
+    callFunction(executorToken, name.moduleId, name.methodId, arguments, name.tracingName);
+    return;
+  }
+  if (m_callCoalescingEnabled.load(std::memory_order_relaxed) &&
+      m_mainExecutorToken && executorToken == *m_mainExecutorToken) {
+    // Pending batches own their strings, so the coalescing path still copies
+    // the resolved names; only the direct dispatch below is copy-free.
+    const CallName& name = m_callNames.lookup(callHandle);
+    callFunction(executorToken, name.moduleId, name.methodId, arguments, name.tracingName);
+    return;
+  }
+
+  uint64_t enqueueMicros = BridgeMetrics::nowMicros();
+  runOnExecutorQueue(executorToken, [this, callHandle, arguments, enqueueMicros] (JSExecutor* executor) {
+    const CallName& name = m_callNames.lookup(callHandle);
+    m_metrics.record(name.tracingName, BridgeMetrics::nowMicros() - enqueueMicros);
+    TraceRecorder::Section ts(name.tracingName.c_str());
+    executor->callFunction(callHandle, name.moduleId, name.methodId, arguments);
+  });
+}
 
+void Bridge::invokeCallback(ExecutorToken executorToken, const double callbackId, const folly::dynamic& arguments) {
   #ifdef WITH_FBSYSTRACE
-  runOnExecutorQueue(executorToken, [callbackId, arguments, systraceCookie] (JSExecutor* executor) {
-    FbSystraceAsyncFlow::end(
+  // Same enabled-probe scheme as callFunction; callbacks are the tightest
+  // loop we have, so the disabled path must stay allocation- and RMW-free.
+  int systraceCookie = -1;
+  if (fbsystrace_is_tracing(TRACE_TAG_REACT_CXX_BRIDGE)) {
+    systraceCookie = nextSystraceCookie();
+    FbSystraceAsyncFlow::begin(
         TRACE_TAG_REACT_CXX_BRIDGE,
         "<callback>",
         systraceCookie);
-    FbSystraceSection s(TRACE_TAG_REACT_CXX_BRIDGE, "Bridge.invokeCallback");
+  }
+  #endif
+
+  uint64_t enqueueMicros = BridgeMetrics::nowMicros();
+  #ifdef WITH_FBSYSTRACE
+  runOnExecutorQueue(executorToken, [this, callbackId, arguments, enqueueMicros, systraceCookie] (JSExecutor* executor) {
+    if (systraceCookie != -1) {
+      FbSystraceAsyncFlow::end(
+          TRACE_TAG_REACT_CXX_BRIDGE,
+          "<callback>",
+          systraceCookie);
+    }
+    TracedSection s(systraceCookie != -1, TRACE_TAG_REACT_CXX_BRIDGE, "Bridge.invokeCallback");
   #else
-  runOnExecutorQueue(executorToken, [callbackId, arguments] (JSExecutor* executor) {
+  runOnExecutorQueue(executorToken, [this, callbackId, arguments, enqueueMicros] (JSExecutor* executor) {
   #endif
-    executor->invokeCallback(callbackId, arguments);
+    m_metrics.record("<callback>", BridgeMetrics::nowMicros() - enqueueMicros);
+    TraceRecorder::Section ts("Bridge.invokeCallback");
+    if (m_surfaceId != 0) {
+      executor->invokeCallbackOnSurface(m_surfaceId, callbackId, arguments);
+    } else {
+      executor->invokeCallback(callbackId, arguments);
+    }
   });
 }
 
@@ -112,6 +424,14 @@ void Bridge::setGlobalVariable(const std::string& propName, const std::string& j
   });
 }
 
+void Bridge::setGlobalVariable(std::string propName, std::unique_ptr<const std::string> jsonValue) {
+  runOnExecutorQueue(
+      *m_mainExecutorToken,
+      [propName=std::move(propName), jsonValue=std::move(jsonValue)] (JSExecutor* executor) mutable {
+    executor->setGlobalVariable(propName, std::move(jsonValue));
+  });
+}
+
 void* Bridge::getJavaScriptContext() {
   // TODO(cjhopman): this seems unsafe unless we require that it is only called on the main js queue.
   return m_mainExecutor->getJavaScriptContext();
@@ -134,40 +454,225 @@ void Bridge::stopProfiler(const std::string& title, const std::string& filename)
   });
 }
 
+void Bridge::setIdleGCPolicy(const IdleGCPolicy& policy) {
+  m_idleGCPolicy = policy;
+}
+
 void Bridge::handleMemoryPressureModerate() {
+  int slices = m_idleGCPolicy.moderateSlices;
   runOnExecutorQueue(*m_mainExecutorToken, [=] (JSExecutor* executor) {
-    executor->handleMemoryPressureModerate();
+    if (slices > 0) {
+      executor->scheduleIdleGC(slices);
+    } else {
+      executor->handleMemoryPressureModerate();
+    }
   });
 }
 
 void Bridge::handleMemoryPressureCritical() {
+  int slices = m_idleGCPolicy.criticalSlices;
   runOnExecutorQueue(*m_mainExecutorToken, [=] (JSExecutor* executor) {
-    executor->handleMemoryPressureCritical();
+    if (slices > 0) {
+      executor->scheduleIdleGC(slices);
+    } else {
+      executor->handleMemoryPressureCritical();
+    }
   });
 }
 
+void Bridge::registerSyncNativeHook(const std::string& name, SyncNativeHook hook) {
+  folly::RWSpinLock::WriteHolder guard(m_syncHookLock);
+  m_syncHooks[name] = std::move(hook);
+}
+
+bool Bridge::callSyncNativeHook(const std::string& name, const folly::dynamic& args, folly::dynamic* result) {
+  uint64_t startMicros = BridgeMetrics::nowMicros();
+  folly::RWSpinLock::ReadHolder guard(m_syncHookLock);
+  auto it = m_syncHooks.find(name);
+  if (it == m_syncHooks.end()) {
+    return false;
+  }
+  // Runs under the read lock; handlers declared themselves non-blocking, and
+  // registration (the only writer) happens at startup.
+  *result = it->second(args);
+  m_metrics.record("callSyncNativeHook", BridgeMetrics::nowMicros() - startMicros);
+  return true;
+}
+
 void Bridge::callNativeModules(JSExecutor& executor, const std::string& callJSON, bool isEndOfBatch) {
+  uint64_t startMicros = BridgeMetrics::nowMicros();
+  TraceRecorder::Section ts("Bridge.callNativeModules");
   m_callback->onCallNativeModules(getTokenForExecutor(executor), callJSON, isEndOfBatch);
+  if (isEndOfBatch) {
+    // Flush the perf markers buffered during this batch and tag the calling
+    // JS thread with the next batch id; both hooks run on the thread the
+    // markers were recorded on.
+    if (PerfLogging::flushMarkers) {
+      PerfLogging::flushMarkers();
+    }
+    if (PerfLogging::setCurrentBatchId) {
+      PerfLogging::setCurrentBatchId(
+          m_nextPerfBatchId.fetch_add(1, std::memory_order_relaxed));
+    }
+  }
+  m_metrics.record("callNativeModules", BridgeMetrics::nowMicros() - startMicros);
+}
+
+void Bridge::callNativeModulesFromSurface(uint32_t surfaceId, const std::string& callJSON, bool isEndOfBatch) {
+  uint64_t startMicros = BridgeMetrics::nowMicros();
+  TraceRecorder::Section ts("Bridge.callNativeModulesFromSurface");
+  Bridge* surface = nullptr;
+  {
+    folly::RWSpinLock::ReadHolder guard(m_surfaceLock);
+    auto* entry = m_surfaces.find(surfaceId);
+    if (entry) {
+      surface = *entry;
+    }
+  }
+  if (surface == nullptr) {
+    // The surface detached with a batch still in flight; drop the calls the
+    // same way posts to a dead executor are dropped.
+    LOG(WARNING) << "Dropping native calls for detached surface " << surfaceId;
+    m_metrics.record("taskDroppedDeadExecutor", 0);
+    return;
+  }
+  // Safe without holding the lock: surfaces detach (and are only then torn
+  // down) on this same JS thread, so the bridge can't go away under us.
+  surface->m_callback->onCallNativeModules(*surface->m_mainExecutorToken, callJSON, isEndOfBatch);
+  m_metrics.record("callNativeModules", BridgeMetrics::nowMicros() - startMicros);
+}
+
+uint32_t Bridge::registerSurface(Bridge* surface) {
+  folly::RWSpinLock::WriteHolder guard(m_surfaceLock);
+  uint32_t surfaceId = m_nextSurfaceId++;
+  m_surfaces.emplace(surfaceId, std::move(surface));
+  return surfaceId;
+}
+
+void Bridge::unregisterSurface(uint32_t surfaceId) {
+  folly::RWSpinLock::WriteHolder guard(m_surfaceLock);
+  m_surfaces.erase(surfaceId);
+}
+
+folly::dynamic Bridge::getBridgeMetrics() const {
+  folly::dynamic metrics = m_metrics.toDynamic();
+  // The checksummed records earlier sessions left in the persistent ring —
+  // including the tail leading into a crash. drainPrevious is one-shot, so
+  // only the first snapshot after launch carries them.
+  folly::dynamic previous = MetricsRing::drainPrevious();
+  if (!previous.empty()) {
+    metrics["previousSessionRing"] = std::move(previous);
+  }
+  return metrics;
+}
+
+folly::dynamic Bridge::getStartupTimings() const {
+  // Intentionally doesn't post to jsqueue: the markers are atomics, so like
+  // supportsProfiling() this can be called from any thread.
+  return m_mainExecutor->getStartupTimings();
 }
 
 ExecutorToken Bridge::getMainExecutorToken() const {
   return *m_mainExecutorToken.get();
 }
 
+ExecutorToken Bridge::startHeadlessTaskExecutor() {
+  if (m_hostBridge) {
+    // Surfaces share everything through their host, background tasks included.
+    return m_hostBridge->startHeadlessTaskExecutor();
+  }
+
+  std::lock_guard<std::mutex> lock(m_headlessMutex);
+  if (m_headlessToken) {
+    return *m_headlessToken;
+  }
+
+  auto thread = std::make_shared<HeadlessTaskThread>();
+  std::unique_ptr<JSExecutor> executor;
+  thread->runOnQueueSync([&] {
+    // JSC contexts must be created on the thread they will run on, like the
+    // web worker executors.
+    executor = m_executorFactory->createJSExecutor(this);
+    // The executor's init applies the interactive JS placement from
+    // jscConfig to its thread; this one is explicitly background, so drop
+    // back down afterwards.
+    setpriority(PRIO_PROCESS, syscall(SYS_gettid), kHeadlessTaskNice);
+  });
+
+  ExecutorToken token = registerExecutor(std::move(executor), thread);
+  m_headlessThread = std::move(thread);
+  m_headlessToken = folly::make_unique<ExecutorToken>(token);
+
+  if (m_bundleScript) {
+    runOnExecutorQueue(
+        token,
+        [script=m_bundleScript, sourceURL=m_bundleSourceURL] (JSExecutor* executor) {
+      executor->loadApplicationScript(
+          folly::make_unique<JSBigSharedString>(script), sourceURL);
+    });
+  } else {
+    LOG(WARNING) << "Headless task executor started before a shareable bundle "
+                 << "was loaded; tasks will run against an empty context";
+  }
+
+  return token;
+}
+
+void Bridge::postHeadlessTask(
+    const std::string& moduleId,
+    const std::string& methodId,
+    const folly::dynamic& args) {
+  callFunction(startHeadlessTaskExecutor(), moduleId, methodId, args, "headlessTask");
+}
+
+void Bridge::stopHeadlessTaskExecutor() {
+  if (m_hostBridge) {
+    // The host owns the headless executor and tears it down with the VM.
+    return;
+  }
+
+  std::unique_ptr<ExecutorToken> token;
+  std::shared_ptr<MessageQueueThread> thread;
+  {
+    std::lock_guard<std::mutex> lock(m_headlessMutex);
+    token = std::move(m_headlessToken);
+    thread = std::move(m_headlessThread);
+  }
+  if (!token) {
+    return;
+  }
+
+  std::unique_ptr<JSExecutor> executor = unregisterExecutor(*token);
+  // JSC teardown happens on the VM's own thread, like the main executor's
+  // destroy on the main JS thread; the wait for it (and for the thread to
+  // quit) moves to a reaper so stopping background tasks doesn't stall the
+  // caller. The headless thread is private to this lambda once moved, so
+  // nothing else can queue to it.
+  std::thread([executor = std::move(executor), thread = std::move(thread)] () mutable {
+    thread->runOnQueueSync([&executor] {
+      executor->destroy();
+      executor.reset();
+    });
+    thread->quitSynchronous();
+  }).detach();
+}
+
 ExecutorToken Bridge::registerExecutor(
     std::unique_ptr<JSExecutor> executor,
     std::shared_ptr<MessageQueueThread> messageQueueThread) {
   auto token = m_executorTokenFactory->createExecutorToken();
 
-  std::lock_guard<std::mutex> registrationGuard(m_registrationMutex);
+  folly::RWSpinLock::WriteHolder registrationGuard(m_registrationLock);
 
-  CHECK(m_executorTokenMap.find(executor.get()) == m_executorTokenMap.end())
-      << "Trying to register an already registered executor!";
+  JSExecutor* rawExecutor = executor.get();
+  m_executorMap.forEach([rawExecutor] (uint32_t, std::unique_ptr<ExecutorRegistration>& registration) {
+    CHECK(registration->executor_.get() != rawExecutor)
+        << "Trying to register an already registered executor!";
+  });
 
-  m_executorTokenMap.emplace(executor.get(), token);
   m_executorMap.emplace(
-      token,
-      folly::make_unique<ExecutorRegistration>(std::move(executor), std::move(messageQueueThread)));
+      token.getId(),
+      folly::make_unique<ExecutorRegistration>(token, std::move(executor), std::move(messageQueueThread)));
 
   return token;
 }
@@ -176,15 +681,14 @@ std::unique_ptr<JSExecutor> Bridge::unregisterExecutor(ExecutorToken executorTok
   std::unique_ptr<JSExecutor> executor;
 
   {
-    std::lock_guard<std::mutex> registrationGuard(m_registrationMutex);
+    folly::RWSpinLock::WriteHolder registrationGuard(m_registrationLock);
 
-    auto it = m_executorMap.find(executorToken);
-    CHECK(it != m_executorMap.end())
+    auto* registration = m_executorMap.find(executorToken.getId());
+    CHECK(registration != nullptr)
         << "Trying to unregister an executor that was never registered!";
 
-    executor = std::move(it->second->executor_);
-    m_executorMap.erase(it);
-    m_executorTokenMap.erase(executor.get());
+    executor = std::move((*registration)->executor_);
+    m_executorMap.erase(executorToken.getId());
   }
 
   m_callback->onExecutorUnregistered(executorToken);
@@ -193,43 +697,267 @@ std::unique_ptr<JSExecutor> Bridge::unregisterExecutor(ExecutorToken executorTok
 }
 
 MessageQueueThread* Bridge::getMessageQueueThread(const ExecutorToken& executorToken) {
-  std::lock_guard<std::mutex> registrationGuard(m_registrationMutex);
-  auto it = m_executorMap.find(executorToken);
-  if (it == m_executorMap.end()) {
+  // Fast path for the main executor, which handles nearly all dispatches.
+  if (m_mainExecutorToken && executorToken == *m_mainExecutorToken && m_mainExecutor) {
+    return m_mainMessageQueueThread.get();
+  }
+  folly::RWSpinLock::ReadHolder registrationGuard(m_registrationLock);
+  auto* registration = m_executorMap.find(executorToken.getId());
+  if (!registration) {
     return nullptr;
   }
-  return it->second->messageQueueThread_.get();
+  return (*registration)->messageQueueThread_.get();
 }
 
 JSExecutor* Bridge::getExecutor(const ExecutorToken& executorToken) {
-  std::lock_guard<std::mutex> registrationGuard(m_registrationMutex);
-  auto it = m_executorMap.find(executorToken);
-  if (it == m_executorMap.end()) {
+  folly::RWSpinLock::ReadHolder registrationGuard(m_registrationLock);
+  auto* registration = m_executorMap.find(executorToken.getId());
+  if (!registration) {
     return nullptr;
   }
-  return it->second->executor_.get();
+  return (*registration)->executor_.get();
 }
 
 ExecutorToken Bridge::getTokenForExecutor(JSExecutor& executor) {
-  std::lock_guard<std::mutex> registrationGuard(m_registrationMutex);
-  return m_executorTokenMap.at(&executor);
+  // Fast path: the main executor's token never changes after construction
+  // and this is called on every batch flush.
+  if (&executor == m_mainExecutor && m_mainExecutorToken) {
+    return *m_mainExecutorToken;
+  }
+  // Workers are the slow path: scan the registry's few contiguous slots for
+  // the owning registration instead of keeping a second pointer-keyed map.
+  folly::RWSpinLock::ReadHolder registrationGuard(m_registrationLock);
+  const ExecutorToken* token = nullptr;
+  JSExecutor* rawExecutor = &executor;
+  m_executorMap.forEach([rawExecutor, &token] (uint32_t, std::unique_ptr<ExecutorRegistration>& registration) {
+    if (registration->executor_.get() == rawExecutor) {
+      token = &registration->token_;
+    }
+  });
+  CHECK(token != nullptr) << "Executor is not registered with this bridge!";
+  return *token;
 }
 
 void Bridge::destroy() {
+  if (m_hostBridge) {
+    // Surface teardown: detach from the host's routing table and notify the
+    // callback. The shared VM stays up for the host and any other surfaces.
+    m_destroyed->store(true, std::memory_order_release);
+    m_mainExecutor = nullptr;
+    m_hostBridge->unregisterSurface(m_surfaceId);
+    m_callback->onExecutorUnregistered(*m_mainExecutorToken);
+    return;
+  }
+  {
+    folly::RWSpinLock::ReadHolder guard(m_surfaceLock);
+    if (m_surfaces.size() != 0) {
+      // Surfaces are expected to be destroyed before their host; after this
+      // their calls drop like posts to a dead executor.
+      LOG(WARNING) << "Destroying a shared-VM bridge with "
+                   << m_surfaces.size() << " surface(s) still attached";
+    }
+  }
+  // Background tasks go first so the headless executor can't flush into a
+  // half-torn-down bridge.
+  stopHeadlessTaskExecutor();
   m_destroyed->store(true, std::memory_order_release);
   m_mainExecutor = nullptr;
   std::unique_ptr<JSExecutor> mainExecutor = unregisterExecutor(*m_mainExecutorToken);
-  mainExecutor->destroy();
+  // Reload and surface close used to stall here for the full teardown; the
+  // reaper takes over so the replacement bridge can begin booting
+  // immediately. The caller must keep this Bridge alive until the JS thread
+  // has drained (the Java side holds it until its queue quits).
+  reapExecutor(std::move(mainExecutor));
+}
+
+namespace {
+
+// Free list backing ExecutorRegistration's class-level new/delete. Blocks
+// are never returned to malloc: the pool's high-water mark is the peak
+// number of live executors (main plus workers), a handful at most.
+std::mutex s_registrationPoolMutex;
+std::vector<void*> s_registrationPool;
+
+} // namespace
+
+void* ExecutorRegistration::operator new(size_t size) {
+  DCHECK(size == sizeof(ExecutorRegistration));
+  {
+    std::lock_guard<std::mutex> lock(s_registrationPoolMutex);
+    if (!s_registrationPool.empty()) {
+      void* block = s_registrationPool.back();
+      s_registrationPool.pop_back();
+      return block;
+    }
+  }
+  return ::operator new(size);
+}
+
+void ExecutorRegistration::operator delete(void* ptr) {
+  std::lock_guard<std::mutex> lock(s_registrationPoolMutex);
+  s_registrationPool.push_back(ptr);
+}
+
+void Bridge::setTaskBatchingWindow(ExecutorToken executorToken, uint64_t windowMicros) {
+  ExecutorRegistration* registration = getRegistration(executorToken);
+  if (registration) {
+    registration->batchingWindowMicros_.store(windowMicros, std::memory_order_relaxed);
+  }
+}
+
+void Bridge::setExecutorQueueBound(
+    ExecutorToken executorToken,
+    uint32_t maxDepth,
+    QueueOverflowPolicy policy) {
+  ExecutorRegistration* registration = getRegistration(executorToken);
+  if (registration) {
+    registration->overflowPolicy_.store(
+        static_cast<uint32_t>(policy), std::memory_order_relaxed);
+    registration->maxQueueDepth_.store(maxDepth, std::memory_order_relaxed);
+  }
 }
 
-void Bridge::runOnExecutorQueue(ExecutorToken executorToken, std::function<void(JSExecutor*)> task) {
+ExecutorRegistration* Bridge::getRegistration(const ExecutorToken& executorToken) {
+  folly::RWSpinLock::ReadHolder registrationGuard(m_registrationLock);
+  auto* registration = m_executorMap.find(executorToken.getId());
+  if (!registration) {
+    return nullptr;
+  }
+  return registration->get();
+}
+
+void Bridge::runOnExecutorQueue(ExecutorToken executorToken, ExecutorQueueTask task) {
   if (m_destroyed->load(std::memory_order_acquire)) {
     return;
   }
 
+  if (m_hostBridge && m_mainExecutorToken && executorToken == *m_mainExecutorToken) {
+    // A surface's "main executor" is the host's shared VM; its token has no
+    // registration here, so hand the task to the host's queue machinery
+    // (which applies the host's batching/backpressure configuration).
+    m_hostBridge->runOnExecutorQueue(m_hostBridge->getMainExecutorToken(), std::move(task));
+    return;
+  }
+
+  ExecutorRegistration* registration = getRegistration(executorToken);
+  if (registration &&
+      registration->maxQueueDepth_.load(std::memory_order_relaxed) > 0) {
+    postToBoundedQueue(registration, executorToken, std::move(task));
+    return;
+  }
+  uint64_t window = registration
+      ? registration->batchingWindowMicros_.load(std::memory_order_relaxed)
+      : 0;
+  if (window > 0) {
+    uint64_t now = BridgeMetrics::nowMicros();
+    uint64_t last = registration->lastPostMicros_.exchange(now, std::memory_order_relaxed);
+    bool batched = false;
+    bool scheduleFlush = false;
+    {
+      std::lock_guard<std::mutex> lock(registration->pendingTasksMutex_);
+      if (registration->pendingFlushScheduled_) {
+        // A flush is already queued; ride along with it regardless of
+        // timing so tasks can't overtake the batch.
+        registration->pendingTasks_.push_back(std::move(task));
+        batched = true;
+      } else if (now - last <= window) {
+        registration->pendingTasks_.push_back(std::move(task));
+        registration->pendingFlushScheduled_ = true;
+        batched = true;
+        scheduleFlush = true;
+      }
+      // Idle gap: fall through and dispatch directly, zero added latency.
+    }
+    if (batched) {
+      if (scheduleFlush) {
+        postToExecutorQueue(executorToken, [this, registration] (JSExecutor* executor) {
+          std::vector<ExecutorQueueTask> tasks;
+          {
+            std::lock_guard<std::mutex> lock(registration->pendingTasksMutex_);
+            tasks.swap(registration->pendingTasks_);
+            registration->pendingFlushScheduled_ = false;
+          }
+          for (ExecutorQueueTask& pending : tasks) {
+            pending(executor);
+          }
+        });
+      }
+      return;
+    }
+  }
+
+  postToExecutorQueue(executorToken, std::move(task));
+}
+
+void Bridge::postToBoundedQueue(
+    ExecutorRegistration* registration,
+    ExecutorToken executorToken,
+    ExecutorQueueTask task) {
+  uint32_t maxDepth = registration->maxQueueDepth_.load(std::memory_order_relaxed);
+  auto policy = static_cast<QueueOverflowPolicy>(
+      registration->overflowPolicy_.load(std::memory_order_relaxed));
+  bool scheduleDrain = false;
+  {
+    std::unique_lock<std::mutex> lock(registration->boundedTasksMutex_);
+    if (registration->boundedTasks_.size() >= maxDepth) {
+      if (policy == QueueOverflowPolicy::Block) {
+        auto mqt = getMessageQueueThread(executorToken);
+        if (mqt != nullptr && !mqt->isOnThread()) {
+          // Timed waits so a producer can't hang forever across teardown;
+          // each wakeup re-checks both space and destruction.
+          while (registration->boundedTasks_.size() >= maxDepth) {
+            if (m_destroyed->load(std::memory_order_acquire)) {
+              m_metrics.record("taskDroppedQueueOverflow", 0);
+              return;
+            }
+            registration->boundedSpaceCv_.wait_for(
+                lock, std::chrono::milliseconds(50));
+          }
+        } else {
+          // Blocking the executor's own thread would deadlock on itself;
+          // degrade to evicting the oldest task.
+          policy = QueueOverflowPolicy::DropOldest;
+        }
+      }
+      if (policy == QueueOverflowPolicy::DropOldest &&
+          registration->boundedTasks_.size() >= maxDepth) {
+        registration->boundedTasks_.pop_front();
+        registration->overflowDrops_.fetch_add(1, std::memory_order_relaxed);
+        m_metrics.record("taskDroppedQueueOverflow", 0);
+      }
+      // Coalesce: accept over the bound; the single pending drain flushes
+      // the whole backlog in one wakeup so the executor can catch up.
+    }
+    registration->boundedTasks_.push_back(std::move(task));
+    if (!registration->boundedDrainScheduled_) {
+      registration->boundedDrainScheduled_ = true;
+      scheduleDrain = true;
+    }
+  }
+  if (scheduleDrain) {
+    postToExecutorQueue(executorToken, [this, registration] (JSExecutor* executor) {
+      std::deque<ExecutorQueueTask> tasks;
+      {
+        std::lock_guard<std::mutex> lock(registration->boundedTasksMutex_);
+        tasks.swap(registration->boundedTasks_);
+        registration->boundedDrainScheduled_ = false;
+      }
+      registration->boundedSpaceCv_.notify_all();
+      // The depth histogram doubles as a backlog distribution: each drain
+      // records how many tasks had piled up since the previous one.
+      m_metrics.record("boundedQueueDepth", tasks.size());
+      for (ExecutorQueueTask& pending : tasks) {
+        pending(executor);
+      }
+    });
+  }
+}
+
+void Bridge::postToExecutorQueue(ExecutorToken executorToken, ExecutorQueueTask task) {
   auto executorMessageQueueThread = getMessageQueueThread(executorToken);
   if (executorMessageQueueThread == nullptr) {
     LOG(WARNING) << "Dropping JS action for executor that has been unregistered...";
+    m_metrics.record("taskDroppedDeadExecutor", 0);
     return;
   }
 
@@ -242,6 +970,7 @@ void Bridge::runOnExecutorQueue(ExecutorToken executorToken, std::function<void(
     JSExecutor *executor = getExecutor(executorToken);
     if (executor == nullptr) {
       LOG(WARNING) << "Dropping JS call for executor that has been unregistered...";
+      m_metrics.record("taskDroppedDeadExecutor", 0);
       return;
     }
 
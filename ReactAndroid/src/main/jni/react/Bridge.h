@@ -3,10 +3,20 @@
 #pragma once
 
 #include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <functional>
 #include <map>
+#include <mutex>
+#include <unordered_map>
 #include <vector>
 
+#include <folly/RWSpinLock.h>
+
+#include "BridgeMetrics.h"
+#include "CallNameTable.h"
+#include "FlatIdMap.h"
+#include "InlineTask.h"
 #include "ExecutorToken.h"
 #include "ExecutorTokenFactory.h"
 #include "Executor.h"
@@ -37,16 +47,54 @@ public:
 };
 
 class Bridge;
+
+/**
+ * Dispatch closure for runOnExecutorQueue. Inline storage sized for the
+ * largest bridge dispatch capture (callFunction with its names, arguments
+ * and timing), so enqueueing a call allocates nothing for the closure.
+ */
+using ExecutorQueueTask = InlineTask<void(JSExecutor*), 224>;
+
 class ExecutorRegistration {
 public:
   ExecutorRegistration(
+      ExecutorToken token,
       std::unique_ptr<JSExecutor> executor,
       std::shared_ptr<MessageQueueThread> executorMessageQueueThread) :
+    token_(std::move(token)),
     executor_(std::move(executor)),
     messageQueueThread_(executorMessageQueueThread) {}
 
+  // Registrations churn with every web worker start/stop; they come from a
+  // small static free list instead of malloc.
+  static void* operator new(size_t size);
+  static void operator delete(void* ptr);
+
+  ExecutorToken token_;
   std::unique_ptr<JSExecutor> executor_;
   std::shared_ptr<MessageQueueThread> messageQueueThread_;
+
+  // Adaptive task batching (see Bridge::setTaskBatchingWindow). Tasks posted
+  // within the window of the previous post are gathered here and drained by
+  // a single queued flush; the first post after an idle gap bypasses the
+  // batch entirely.
+  std::atomic<uint64_t> batchingWindowMicros_ = ATOMIC_VAR_INIT(0);
+  std::atomic<uint64_t> lastPostMicros_ = ATOMIC_VAR_INIT(0);
+  std::mutex pendingTasksMutex_;
+  std::vector<ExecutorQueueTask> pendingTasks_;
+  bool pendingFlushScheduled_ = false;
+
+  // Bounded-queue backpressure (see Bridge::setExecutorQueueBound). When
+  // maxQueueDepth_ is non-zero, tasks route through boundedTasks_ and one
+  // queued drain instead of one MessageQueueThread post each, so the bridge
+  // owns the backlog and can evict or count it.
+  std::atomic<uint32_t> maxQueueDepth_ = ATOMIC_VAR_INIT(0);
+  std::atomic<uint32_t> overflowPolicy_ = ATOMIC_VAR_INIT(0);
+  std::atomic<uint64_t> overflowDrops_ = ATOMIC_VAR_INIT(0);
+  std::mutex boundedTasksMutex_;
+  std::condition_variable boundedSpaceCv_;
+  std::deque<ExecutorQueueTask> boundedTasks_;
+  bool boundedDrainScheduled_ = false;
 };
 
 class Bridge {
@@ -58,6 +106,21 @@ public:
       JSExecutorFactory* jsExecutorFactory,
       std::unique_ptr<ExecutorTokenFactory> executorTokenFactory,
       std::unique_ptr<BridgeCallback> callback);
+
+  /**
+   * Shared-VM surface constructor: instead of creating its own main executor
+   * (a second full VM), this bridge attaches to hostBridge's main executor as
+   * a logical surface. Calls dispatch through the shared VM tagged with a
+   * surface id, and the runtime routes flushed queues for that id back to
+   * this bridge's callback (see JSExecutor::callFunctionOnSurface), so a
+   * second React root view costs a routing entry rather than a JS heap.
+   * Must be called on the host's main JS thread, and the surface must be
+   * destroy()ed there before the host.
+   */
+  Bridge(
+      Bridge* hostBridge,
+      std::unique_ptr<ExecutorTokenFactory> executorTokenFactory,
+      std::unique_ptr<BridgeCallback> callback);
   virtual ~Bridge();
 
   /**
@@ -71,11 +134,66 @@ public:
     const folly::dynamic& args,
     const std::string& tracingName);
 
+  /**
+   * Interns a call name triple, returning a handle for the callFunction
+   * overload below. Call once per call site (e.g. at module registration)
+   * and reuse the handle on the hot path.
+   */
+  uint32_t internCallName(
+    const std::string& moduleId,
+    const std::string& methodId,
+    const std::string& tracingName);
+
+  /**
+   * Handle-based variant of callFunction: the dispatch lambda carries only
+   * the handle and arguments, and the names are resolved to stable
+   * references on the executor thread — no string copies per call.
+   */
+  void callFunction(
+    ExecutorToken executorToken,
+    uint32_t callHandle,
+    const folly::dynamic& args);
+
+  /**
+   * Executes a burst of JS module calls with a single executor-thread wakeup
+   * instead of one queued closure per call.
+   */
+  void callFunctionBatch(ExecutorToken executorToken, std::vector<JSFunctionCall>&& calls);
+
+  /**
+   * When enabled, callFunction calls for the main executor are gathered into
+   * a pending batch and flushed with one wakeup once the executor thread gets
+   * to run, coalescing the dozens of per-frame hops we see during gestures.
+   */
+  void setCallCoalescingEnabled(bool enabled);
+
   /**
    * Invokes a callback with the cbID, and optional additional arguments in JS.
    */
   void invokeCallback(ExecutorToken executorToken, const double callbackId, const folly::dynamic& args);
 
+  /**
+   * Handler for registerSyncNativeHook. By registering, a handler declares
+   * itself thread-safe and non-blocking: it runs inline on whichever JS
+   * thread calls it, with no queue hop in either direction.
+   */
+  using SyncNativeHook = std::function<folly::dynamic(const folly::dynamic& args)>;
+
+  /**
+   * Registers a synchronous handler callable from JS as
+   * nativeCallSyncHook(name, args). Round-trip getters (device info, layout
+   * measurements) answered this way skip both bridge queue hops and the
+   * callback machinery entirely. Register at startup; re-registering a name
+   * replaces the handler.
+   */
+  void registerSyncNativeHook(const std::string& name, SyncNativeHook hook);
+
+  /**
+   * Runs the named sync hook inline. Returns false if no handler is
+   * registered under that name. Called by executors on their JS threads.
+   */
+  bool callSyncNativeHook(const std::string& name, const folly::dynamic& args, folly::dynamic* result);
+
   /**
    * Starts the JS application from an "bundle", i.e. a JavaScript file that
    * contains code for all modules and a runtime that resolves and
@@ -83,6 +201,14 @@ public:
    */
   void loadApplicationScript(const std::string& script, const std::string& sourceURL);
 
+  /**
+   * Same, but takes ownership of an immutable (possibly mmap-backed) buffer
+   * so the bundle is never copied on its way to the executor.
+   */
+  void loadApplicationScript(
+      std::unique_ptr<const JSBigString> script,
+      const std::string& sourceURL);
+
   /**
    * Starts the JS application from an "unbundle", i.e. a backend that stores
    * and injects each module as individual file.
@@ -92,6 +218,14 @@ public:
     const std::string& startupCode,
     const std::string& sourceURL);
   void setGlobalVariable(const std::string& propName, const std::string& jsonValue);
+
+  /**
+   * Adopting variant of setGlobalVariable: the JSON payload moves through
+   * the queue into the executor instead of being copied into the dispatch
+   * lambda — the startup config blobs we inject run to hundreds of KB.
+   * Executors may additionally defer parsing until first JS access.
+   */
+  void setGlobalVariable(std::string propName, std::unique_ptr<const std::string> jsonValue);
   void* getJavaScriptContext();
   bool supportsProfiling();
   void startProfiler(const std::string& title);
@@ -99,6 +233,52 @@ public:
   void handleMemoryPressureModerate();
   void handleMemoryPressureCritical();
 
+  /**
+   * Sets how much collection work each memory pressure level schedules; see
+   * IdleGCPolicy in Executor.h. Zero-slice levels collect synchronously.
+   */
+  void setIdleGCPolicy(const IdleGCPolicy& policy);
+
+  /**
+   * Enables adaptive task batching for the given executor: a task posted
+   * within windowMicros of the previous post joins a pending batch that
+   * drains in one executor wakeup instead of waking the thread itself.
+   * The first post after an idle gap always dispatches immediately, so
+   * single latency-sensitive calls pay nothing; only bursts (touch move
+   * storms and the like) coalesce. Zero (the default) disables batching.
+   */
+  void setTaskBatchingWindow(ExecutorToken executorToken, uint64_t windowMicros);
+
+  /**
+   * What happens to a task posted to an executor whose bounded queue is
+   * already at its limit; see setExecutorQueueBound.
+   */
+  enum class QueueOverflowPolicy : uint32_t {
+    // Accept the task anyway: the backlog keeps growing but drains in a
+    // single executor wakeup, giving a stalled JS thread one chance to
+    // catch up. Bounds wakeups, not memory.
+    Coalesce = 0,
+    // Evict the oldest queued task and count the drop in the bridge
+    // metrics ("taskDroppedQueueOverflow").
+    DropOldest = 1,
+    // The producer thread waits for space. Posts from the executor's own
+    // thread fall back to DropOldest instead of deadlocking on themselves.
+    Block = 2,
+  };
+
+  /**
+   * Bounds the task queue for the given executor so a stalled JS thread
+   * can't let producers accumulate an unbounded backlog of captured
+   * arguments. maxDepth zero (the default) leaves the queue unbounded with
+   * the original direct-post dispatch. Queue depth at each drain and
+   * overflow drops are recorded in the bridge metrics ("boundedQueueDepth",
+   * "taskDroppedQueueOverflow") so producers can adapt.
+   */
+  void setExecutorQueueBound(
+      ExecutorToken executorToken,
+      uint32_t maxDepth,
+      QueueOverflowPolicy policy);
+
   /**
    * Invokes a set of native module calls on behalf of the given executor.
    *
@@ -106,11 +286,67 @@ public:
    */
   void callNativeModules(JSExecutor& executor, const std::string& callJSON, bool isEndOfBatch);
 
+  /**
+   * Routes a flushed queue from the shared VM to the surface bridge
+   * registered under surfaceId; calls for a surface that has detached are
+   * dropped like posts to a dead executor. Called by executors on the main
+   * JS thread.
+   */
+  void callNativeModulesFromSurface(uint32_t surfaceId, const std::string& callJSON, bool isEndOfBatch);
+
+  /**
+   * Snapshot of the always-on per-call invocation counts and latency
+   * histograms; see BridgeMetrics. Safe to call from any thread.
+   */
+  folly::dynamic getBridgeMetrics() const;
+
+  /**
+   * Timestamped phase markers from the main executor's bundle load (source
+   * materialization, evaluation, first queue flush), in microseconds on the
+   * BridgeMetrics clock; zero for phases that haven't happened. Safe to call
+   * from any thread.
+   */
+  folly::dynamic getStartupTimings() const;
+
   /**
    * Returns the ExecutorToken corresponding to the main JSExecutor.
    */
   ExecutorToken getMainExecutorToken() const;
 
+  /**
+   * Headless task mode: a second lightweight executor created from the same
+   * factory as the main one, evaluating the bundle the bridge already loaded
+   * on its own background-priority native thread. The bundle buffer is
+   * shared rather than copied, and evaluating identical source hits the same
+   * prepared-source cache, so the second context skips the parse; what it
+   * costs is a JS heap, not a second bundle. Native-module calls it flushes
+   * reach the callback tagged with this token, so hosts can route them to a
+   * restricted module registry instead of the full UI-oriented set.
+   *
+   * Requires the bundle to have been loaded through the buffer-taking
+   * loadApplicationScript; otherwise the executor starts against an empty
+   * context and a warning is logged. Idempotent: later calls return the
+   * token of the already-running executor. On a surface bridge this
+   * delegates to the host, which owns the VM and the bundle.
+   */
+  ExecutorToken startHeadlessTaskExecutor();
+
+  /**
+   * Queues a JS call on the headless task executor, starting it on first
+   * use. Periodic background work (sync passes, push handling) dispatched
+   * this way never occupies the interactive JS thread.
+   */
+  void postHeadlessTask(
+      const std::string& moduleId,
+      const std::string& methodId,
+      const folly::dynamic& args);
+
+  /**
+   * Synchronously tears down the headless executor and its thread, if one
+   * was started. destroy() calls this itself before the main teardown.
+   */
+  void stopHeadlessTaskExecutor();
+
   /**
    * Registers the given JSExecutor which runs on the given MessageQueueThread
    * with the Bridge. Part of this registration is transfering ownership of this
@@ -134,25 +370,75 @@ public:
   std::unique_ptr<JSExecutor> unregisterExecutor(ExecutorToken executorToken);
 
   /**
-   * Synchronously tears down the bridge and the main executor.
+   * Tears down the bridge. The main executor is unregistered synchronously
+   * (no further calls reach it after this returns) but its JSC teardown is
+   * handed to a background reaper thread, so a replacement bridge can begin
+   * booting immediately instead of waiting out the old VM's destruction.
    */
   void destroy();
 private:
-  void runOnExecutorQueue(ExecutorToken token, std::function<void(JSExecutor*)> task);
+  uint32_t registerSurface(Bridge* surface);
+  void unregisterSurface(uint32_t surfaceId);
+  void runOnExecutorQueue(ExecutorToken token, ExecutorQueueTask task);
+  void postToExecutorQueue(ExecutorToken token, ExecutorQueueTask task);
+  void postToBoundedQueue(
+      ExecutorRegistration* registration,
+      ExecutorToken token,
+      ExecutorQueueTask task);
+  ExecutorRegistration* getRegistration(const ExecutorToken& token);
   std::unique_ptr<BridgeCallback> m_callback;
   // This is used to avoid a race condition where a proxyCallback gets queued after ~Bridge(),
   // on the same thread. In that case, the callback will try to run the task on m_callback which
   // will have been destroyed within ~Bridge(), thus causing a SIGSEGV.
   std::shared_ptr<std::atomic_bool> m_destroyed;
   JSExecutor* m_mainExecutor;
+  std::shared_ptr<MessageQueueThread> m_mainMessageQueueThread;
   std::unique_ptr<ExecutorToken> m_mainExecutorToken;
   std::unique_ptr<ExecutorTokenFactory> m_executorTokenFactory;
-  std::unordered_map<JSExecutor*, ExecutorToken> m_executorTokenMap;
-  std::unordered_map<ExecutorToken, std::unique_ptr<ExecutorRegistration>> m_executorMap;
-  std::mutex m_registrationMutex;
-  #ifdef WITH_FBSYSTRACE
-  std::atomic_uint_least32_t m_systraceCookie = ATOMIC_VAR_INIT();
-  #endif
+  // Keyed by the dense ExecutorToken id (see ExecutorToken::getId): one
+  // contiguous probe instead of a hashed pointer chase per lookup. Reverse
+  // executor-to-token lookups scan the same handful of slots; each
+  // registration carries its token for that.
+  FlatIdMap<std::unique_ptr<ExecutorRegistration>> m_executorMap;
+  // Executors register and unregister extremely rarely but the registry is
+  // consulted on every bridge call from multiple threads, so reads take a
+  // shared (spin) lock and only (un)registration writes exclusively.
+  folly::RWSpinLock m_registrationLock;
+  std::atomic_bool m_callCoalescingEnabled = ATOMIC_VAR_INIT(false);
+  std::mutex m_pendingCallsMutex;
+  std::vector<JSFunctionCall> m_pendingCalls;
+  bool m_pendingCallFlushScheduled = false;
+  BridgeMetrics m_metrics;
+  // Id handed to PerfLogging::setCurrentBatchId at each end-of-batch so
+  // buffered perf markers can be attributed to the bridge traffic that
+  // triggered them. Atomic because every executor thread advances it.
+  std::atomic<int64_t> m_nextPerfBatchId = ATOMIC_VAR_INIT(1);
+  IdleGCPolicy m_idleGCPolicy;
+  CallNameTable m_callNames;
+  // Sync hooks register once at startup and are read on every inline call
+  // from JS threads, so the same read-mostly locking as the registry.
+  std::unordered_map<std::string, SyncNativeHook> m_syncHooks;
+  folly::RWSpinLock m_syncHookLock;
+  // Shared-VM mode. On a surface bridge, m_hostBridge points at the bridge
+  // owning the VM and m_surfaceId is its routing id there (0 = not a
+  // surface). On a host, m_surfaces maps live surface ids to their bridges;
+  // registration is rare and routing happens on every surface batch, so the
+  // same read-mostly locking as the executor registry.
+  Bridge* m_hostBridge = nullptr;
+  uint32_t m_surfaceId = 0;
+  FlatIdMap<Bridge*> m_surfaces;
+  uint32_t m_nextSurfaceId = 1;
+  folly::RWSpinLock m_surfaceLock;
+  // Headless task mode (see startHeadlessTaskExecutor). The factory and the
+  // loaded bundle buffer are retained so the headless executor can be spun
+  // up long after startup from the bytes the main executor already mapped.
+  // Null factory on surface bridges, which delegate to their host.
+  JSExecutorFactory* m_executorFactory = nullptr;
+  std::shared_ptr<const JSBigString> m_bundleScript;
+  std::string m_bundleSourceURL;
+  std::mutex m_headlessMutex;
+  std::unique_ptr<ExecutorToken> m_headlessToken;
+  std::shared_ptr<MessageQueueThread> m_headlessThread;
 
   MessageQueueThread* getMessageQueueThread(const ExecutorToken& executorToken);
   JSExecutor* getExecutor(const ExecutorToken& executorToken);
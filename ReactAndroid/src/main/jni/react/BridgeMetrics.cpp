@@ -0,0 +1,70 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "BridgeMetrics.h"
+
+#include <chrono>
+
+#include "MetricsRing.h"
+
+namespace facebook {
+namespace react {
+
+static size_t bucketForMicros(uint64_t micros) {
+  if (micros == 0) {
+    return 0;
+  }
+  size_t bucket = 64 - __builtin_clzll(micros);
+  return bucket < BridgeMetrics::kNumBuckets ? bucket : BridgeMetrics::kNumBuckets - 1;
+}
+
+uint64_t BridgeMetrics::nowMicros() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+BridgeMetrics::MethodStats* BridgeMetrics::statsFor(const std::string& name) {
+  {
+    folly::RWSpinLock::ReadHolder guard(m_lock);
+    auto it = m_stats.find(name);
+    if (it != m_stats.end()) {
+      return it->second.get();
+    }
+  }
+
+  folly::RWSpinLock::WriteHolder guard(m_lock);
+  auto& stats = m_stats[name];
+  if (!stats) {
+    stats.reset(new MethodStats());
+  }
+  return stats.get();
+}
+
+void BridgeMetrics::record(const std::string& name, uint64_t micros) {
+  MethodStats* stats = statsFor(name);
+  stats->count.fetch_add(1, std::memory_order_relaxed);
+  stats->totalMicros.fetch_add(micros, std::memory_order_relaxed);
+  stats->buckets[bucketForMicros(micros)].fetch_add(1, std::memory_order_relaxed);
+  // Mirrored into the persistent ring so the calls leading into a crash are
+  // readable at the next launch; a no-op store sequence when the ring isn't
+  // mapped.
+  MetricsRing::record(name.c_str(), micros);
+}
+
+folly::dynamic BridgeMetrics::toDynamic() const {
+  folly::dynamic result = folly::dynamic::object();
+
+  folly::RWSpinLock::ReadHolder guard(m_lock);
+  for (auto& entry : m_stats) {
+    folly::dynamic buckets = folly::dynamic::array();
+    for (size_t i = 0; i < kNumBuckets; i++) {
+      buckets.push_back(entry.second->buckets[i].load(std::memory_order_relaxed));
+    }
+    result[entry.first] = folly::dynamic::object
+        ("count", entry.second->count.load(std::memory_order_relaxed))
+        ("totalMicros", entry.second->totalMicros.load(std::memory_order_relaxed))
+        ("buckets", std::move(buckets));
+  }
+  return result;
+}
+
+} }
@@ -0,0 +1,177 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "BundleDelta.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <unistd.h>
+
+#include <glog/logging.h>
+
+#include "JSBigString.h"
+#include "JSCSourceCache.h"
+
+namespace facebook {
+namespace react {
+namespace BundleDelta {
+
+namespace {
+
+const uint32_t BUNDLE_DELTA_MAGIC = 0xFB0BDE17;
+
+const uint8_t OP_COPY = 0;
+const uint8_t OP_INSERT = 1;
+
+// Little-endian reads off an unaligned byte cursor; the delta header and ops
+// are packed with no padding.
+struct Cursor {
+  const uint8_t* pos;
+  const uint8_t* end;
+
+  bool has(size_t bytes) const {
+    return (size_t)(end - pos) >= bytes;
+  }
+
+  uint8_t readU8() {
+    return *pos++;
+  }
+
+  uint32_t readU32() {
+    uint32_t value;
+    memcpy(&value, pos, sizeof(value));
+    pos += sizeof(value);
+    return value;
+  }
+
+  uint64_t readU64() {
+    uint64_t value;
+    memcpy(&value, pos, sizeof(value));
+    pos += sizeof(value);
+    return value;
+  }
+};
+
+} // namespace
+
+bool apply(
+    const std::string& basePath,
+    const std::string& deltaPath,
+    const std::string& outputPath) {
+  // Map the base rather than reading it: copy ops touch it mostly
+  // sequentially and a typical delta only needs a fraction of its pages.
+  // fromPath refuses page-multiple files (no guaranteed NUL tail), so fall
+  // back to a copying read for those.
+  std::string baseCopy;
+  const char* baseData;
+  size_t baseSize;
+  auto base = JSBigFileString::fromPath(basePath);
+  if (base) {
+    baseData = base->c_str();
+    baseSize = base->size();
+  } else {
+    std::ifstream baseFile(basePath, std::ios::binary);
+    if (!baseFile) {
+      LOG(WARNING) << "Bundle delta: couldn't open base bundle " << basePath;
+      return false;
+    }
+    baseCopy.assign(
+        (std::istreambuf_iterator<char>(baseFile)),
+        std::istreambuf_iterator<char>());
+    baseData = baseCopy.data();
+    baseSize = baseCopy.size();
+  }
+
+  std::string delta;
+  {
+    std::ifstream deltaFile(deltaPath, std::ios::binary);
+    if (!deltaFile) {
+      LOG(WARNING) << "Bundle delta: couldn't open delta " << deltaPath;
+      return false;
+    }
+    delta.assign(
+        (std::istreambuf_iterator<char>(deltaFile)),
+        std::istreambuf_iterator<char>());
+  }
+
+  Cursor cursor{
+      reinterpret_cast<const uint8_t*>(delta.data()),
+      reinterpret_cast<const uint8_t*>(delta.data()) + delta.size()};
+  if (!cursor.has(sizeof(uint32_t) + 3 * sizeof(uint64_t)) ||
+      cursor.readU32() != BUNDLE_DELTA_MAGIC) {
+    LOG(WARNING) << "Bundle delta: bad header in " << deltaPath;
+    return false;
+  }
+  uint64_t baseHash = cursor.readU64();
+  uint64_t resultHash = cursor.readU64();
+  uint64_t resultSize = cursor.readU64();
+
+  // The cached base may be from a different release than the delta was cut
+  // against (a skipped update, a wiped cache); refuse up front rather than
+  // producing garbage that only fails the result check after a full build.
+  if (JSCSourceCache::hashBundle(baseData, baseSize) != baseHash) {
+    LOG(WARNING) << "Bundle delta: base bundle doesn't match delta's base hash";
+    return false;
+  }
+
+  std::string output;
+  output.reserve(resultSize);
+  while (cursor.pos < cursor.end) {
+    if (!cursor.has(1)) {
+      return false;
+    }
+    uint8_t op = cursor.readU8();
+    if (op == OP_COPY) {
+      if (!cursor.has(sizeof(uint64_t) + sizeof(uint32_t))) {
+        return false;
+      }
+      uint64_t offset = cursor.readU64();
+      uint32_t length = cursor.readU32();
+      if (offset > baseSize || length > baseSize - offset) {
+        LOG(WARNING) << "Bundle delta: copy op out of base bounds";
+        return false;
+      }
+      output.append(baseData + offset, length);
+    } else if (op == OP_INSERT) {
+      if (!cursor.has(sizeof(uint32_t))) {
+        return false;
+      }
+      uint32_t length = cursor.readU32();
+      if (!cursor.has(length)) {
+        return false;
+      }
+      output.append(reinterpret_cast<const char*>(cursor.pos), length);
+      cursor.pos += length;
+    } else {
+      LOG(WARNING) << "Bundle delta: unknown op " << (int)op;
+      return false;
+    }
+  }
+
+  if (output.size() != resultSize ||
+      JSCSourceCache::hashBundle(output.data(), output.size()) != resultHash) {
+    LOG(WARNING) << "Bundle delta: patched output failed verification";
+    return false;
+  }
+
+  // Write-then-rename so a kill mid-apply never leaves a torn bundle at the
+  // output path.
+  std::string tmpPath = outputPath + ".tmp";
+  {
+    std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+    if (!out || !out.write(output.data(), output.size())) {
+      LOG(WARNING) << "Bundle delta: couldn't write " << tmpPath;
+      return false;
+    }
+  }
+  if (rename(tmpPath.c_str(), outputPath.c_str()) != 0) {
+    unlink(tmpPath.c_str());
+    LOG(WARNING) << "Bundle delta: couldn't move patched bundle into place";
+    return false;
+  }
+  return true;
+}
+
+} // namespace BundleDelta
+} }
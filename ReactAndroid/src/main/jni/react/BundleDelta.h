@@ -0,0 +1,42 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include <string>
+
+namespace facebook {
+namespace react {
+
+/**
+ * Block-level binary deltas between bundle releases, so an OTA update ships
+ * only what changed instead of re-downloading the whole bundle (consecutive
+ * releases are typically >90% identical).
+ *
+ * Delta file layout (all integers little-endian):
+ *
+ *   [uint32]  magic 0xFB0BDE17
+ *   [uint64]  base hash    (JSCSourceCache::hashBundle of the base bundle)
+ *   [uint64]  result hash  (same hash of the patched output)
+ *   [uint64]  result size in bytes
+ *   ops until end of file:
+ *     [uint8 0][uint64 baseOffset][uint32 length]   copy from the base bundle
+ *     [uint8 1][uint32 length][length bytes]        insert literal bytes
+ *
+ * Deltas are produced at release time by the update packer; the runtime only
+ * applies them. apply() verifies the cached base against the recorded base
+ * hash, builds the output, verifies that against the recorded result hash,
+ * and only then renames it into place — a failed or torn apply never
+ * replaces the output path. The patched file is an ordinary bundle: it goes
+ * through the usual mmap load path, and the startup source cache keys off
+ * its bytes exactly as for a full download.
+ */
+namespace BundleDelta {
+
+bool apply(
+    const std::string& basePath,
+    const std::string& deltaPath,
+    const std::string& outputPath);
+
+} // namespace BundleDelta
+
+} }
@@ -0,0 +1,52 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include <folly/dynamic.h>
+
+namespace facebook {
+namespace react {
+
+/**
+ * Reusable argument list for the bridge call paths. The arguments end up in
+ * a folly::dynamic array either way (JSON-encoded or converted value by
+ * value), so the builder appends straight into one and clear() empties it
+ * while keeping the backing storage. An executor that owns one of these
+ * recycles a single allocation across all the callFunction/invokeCallback
+ * calls it serves, instead of building a fresh std::vector<folly::dynamic>
+ * per call.
+ *
+ * append takes rvalues only; callers that genuinely need a copy make it
+ * explicitly at the call site.
+ *
+ * Not thread-safe: an instance belongs to one executor thread.
+ */
+class CallArgsBuilder {
+public:
+  CallArgsBuilder() : args_(folly::dynamic::array()) {}
+
+  void append(folly::dynamic&& arg) {
+    args_.push_back(std::move(arg));
+  }
+
+  /**
+   * Empties the list for the next call; the backing array keeps its
+   * capacity.
+   */
+  void clear() {
+    args_.resize(0);
+  }
+
+  size_t size() const {
+    return args_.size();
+  }
+
+  const folly::dynamic& args() const {
+    return args_;
+  }
+
+private:
+  folly::dynamic args_;
+};
+
+} }
@@ -0,0 +1,43 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "CallNameTable.h"
+
+#include <folly/Memory.h>
+#include <glog/logging.h>
+
+namespace facebook {
+namespace react {
+
+uint32_t CallNameTable::intern(
+    const std::string& moduleId,
+    const std::string& methodId,
+    const std::string& tracingName) {
+  std::string key = moduleId + "." + methodId;
+
+  {
+    folly::RWSpinLock::ReadHolder guard(m_lock);
+    auto it = m_handles.find(key);
+    if (it != m_handles.end()) {
+      return it->second;
+    }
+  }
+
+  folly::RWSpinLock::WriteHolder guard(m_lock);
+  auto it = m_handles.find(key);
+  if (it != m_handles.end()) {
+    return it->second;
+  }
+  uint32_t handle = (uint32_t)m_names.size();
+  m_names.push_back(folly::make_unique<CallName>(
+      CallName{moduleId, methodId, tracingName}));
+  m_handles.emplace(std::move(key), handle);
+  return handle;
+}
+
+const CallName& CallNameTable::lookup(uint32_t handle) const {
+  folly::RWSpinLock::ReadHolder guard(m_lock);
+  CHECK(handle < m_names.size()) << "Unknown call name handle " << handle;
+  return *m_names[handle];
+}
+
+} }
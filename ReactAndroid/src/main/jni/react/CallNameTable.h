@@ -0,0 +1,57 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <folly/RWSpinLock.h>
+
+namespace facebook {
+namespace react {
+
+struct CallName {
+  std::string moduleId;
+  std::string methodId;
+  std::string tracingName;
+};
+
+/**
+ * Interning table for JS call names.
+ *
+ * The set of module/method names crossing the bridge is small and fixed
+ * shortly after startup, but callFunction used to copy all three strings into
+ * the dispatch lambda on every call. Interning maps each name triple to a
+ * small handle once; the hot path then carries just the handle and resolves
+ * it to stable const references on the executor thread.
+ *
+ * Handles are only valid for the lifetime of the table that issued them.
+ */
+class CallNameTable {
+public:
+  /**
+   * Returns the handle for the given name triple, creating one on first
+   * sight. Thread-safe; lookups after the first take a shared spin lock.
+   */
+  uint32_t intern(
+      const std::string& moduleId,
+      const std::string& methodId,
+      const std::string& tracingName);
+
+  /**
+   * Resolves a handle. The reference stays valid (and its address stable)
+   * for the lifetime of the table.
+   */
+  const CallName& lookup(uint32_t handle) const;
+
+private:
+  mutable folly::RWSpinLock m_lock;
+  // unique_ptr so vector growth doesn't move the CallNames lookup() handed out.
+  std::vector<std::unique_ptr<CallName>> m_names;
+  std::unordered_map<std::string, uint32_t> m_handles;
+};
+
+} }
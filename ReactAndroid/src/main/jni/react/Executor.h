@@ -2,11 +2,14 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <memory>
 
+#include "JSBigString.h"
 #include "JSModulesUnbundle.h"
+#include "MethodCall.h"
 
 namespace folly {
 
@@ -19,6 +22,19 @@ namespace react {
 
 class Bridge;
 class JSExecutor;
+
+/**
+ * Controls how memory-pressure GC work is sliced. Each slice is one bounded
+ * reclamation step posted to the executor's MessageQueueThread, so queued
+ * bridge traffic interleaves between steps instead of stalling behind one
+ * synchronous full collection. A zero count falls back to the old
+ * synchronous handleMemoryPressure* behavior for that level.
+ */
+struct IdleGCPolicy {
+  int moderateSlices = 3;
+  int criticalSlices = 8;
+};
+
 class JSExecutorFactory {
 public:
   virtual std::unique_ptr<JSExecutor> createJSExecutor(Bridge *bridge) = 0;
@@ -34,6 +50,18 @@ public:
     const std::string& script,
     const std::string& sourceURL) = 0;
 
+  /**
+   * Execute an application script bundle held in an immutable (possibly
+   * mmap-backed) buffer. Ownership of the buffer moves to the executor so the
+   * bundle bytes exist exactly once during startup. The default falls back to
+   * the copying string overload for executors that haven't adopted buffers.
+   */
+  virtual void loadApplicationScript(
+      std::unique_ptr<const JSBigString> script,
+      const std::string& sourceURL) {
+    loadApplicationScript(std::string(script->c_str(), script->size()), sourceURL);
+  }
+
   /**
    * Add an application "unbundle" file
    */
@@ -49,6 +77,32 @@ public:
    */
   virtual void callFunction(const std::string& moduleId, const std::string& methodId, const folly::dynamic& arguments) = 0;
 
+  /**
+   * Same as callFunction, but keyed by an interned handle from the bridge's
+   * CallNameTable, so implementations can cache per-call-site artifacts
+   * (e.g. JSC string refs) instead of rebuilding them every call. The name
+   * references stay valid for the bridge's lifetime. The default ignores the
+   * handle.
+   */
+  virtual void callFunction(
+      uint32_t callHandle,
+      const std::string& moduleId,
+      const std::string& methodId,
+      const folly::dynamic& arguments) {
+    callFunction(moduleId, methodId, arguments);
+  }
+
+  /**
+   * Executes a burst of JS module calls that arrived together, flushing the
+   * native call queue once at the end of the batch. The default simply
+   * dispatches them one at a time.
+   */
+  virtual void callFunctionBatch(std::vector<JSFunctionCall>&& calls) {
+    for (auto& call : calls) {
+      callFunction(call.moduleId, call.methodId, call.arguments);
+    }
+  }
+
   /**
    * Executes BatchedBridge.invokeCallbackAndReturnFlushedQueue with the cbID,
    * and optional additional arguments in JS and returns the next queue. The executor
@@ -57,21 +111,69 @@ public:
    */
   virtual void invokeCallback(const double callbackId, const folly::dynamic& arguments) = 0;
 
+  /**
+   * Surface-addressed variants of callFunction/invokeCallback for shared-VM
+   * mode (see Bridge's surface constructor): the surface id travels into the
+   * batched protocol so the runtime can dispatch into the right logical
+   * bridge and the returned queue routes back to that surface's callback.
+   * Executors without surface support treat the VM as a single surface.
+   */
+  virtual void callFunctionOnSurface(
+      uint32_t surfaceId,
+      const std::string& moduleId,
+      const std::string& methodId,
+      const folly::dynamic& arguments) {
+    callFunction(moduleId, methodId, arguments);
+  }
+
+  virtual void invokeCallbackOnSurface(
+      uint32_t surfaceId,
+      const double callbackId,
+      const folly::dynamic& arguments) {
+    invokeCallback(callbackId, arguments);
+  }
+
   virtual void setGlobalVariable(
     const std::string& propName,
     const std::string& jsonValue) = 0;
+
+  /**
+   * Adopting variant of setGlobalVariable: takes ownership of the JSON
+   * payload so the injected blob is never copied on its way to the VM. The
+   * default falls back to the copying overload for executors that haven't
+   * adopted it.
+   */
+  virtual void setGlobalVariable(
+      const std::string& propName,
+      std::unique_ptr<const std::string> jsonValue) {
+    setGlobalVariable(propName, *jsonValue);
+  }
   virtual void* getJavaScriptContext() {
     return nullptr;
   };
   virtual bool supportsProfiling() {
     return false;
   };
+  /**
+   * Timestamped phase markers recorded while the application bundle loaded;
+   * see Bridge::getStartupTimings. Executors without phase instrumentation
+   * return an empty object.
+   */
+  virtual folly::dynamic getStartupTimings() {
+    return folly::dynamic::object();
+  }
   virtual void startProfiler(const std::string &titleString) {};
   virtual void stopProfiler(const std::string &titleString, const std::string &filename) {};
   virtual void handleMemoryPressureModerate() {};
   virtual void handleMemoryPressureCritical() {
     handleMemoryPressureModerate();
   };
+  /**
+   * Queues the given number of incremental collection slices onto the
+   * executor's own queue; see IdleGCPolicy. Executors without incremental
+   * reclamation ignore this and callers should use handleMemoryPressure*.
+   */
+  virtual void scheduleIdleGC(int slices) {};
   virtual void destroy() {};
   virtual ~JSExecutor() {};
 };
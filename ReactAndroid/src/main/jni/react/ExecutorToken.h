@@ -2,6 +2,9 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+
 #include "Executor.h"
 
 namespace facebook {
@@ -9,11 +12,26 @@ namespace react {
 
 /**
  * This class exists so that we have a type for the shared_ptr on ExecutorToken
- * that implements a virtual destructor.
+ * that implements a virtual destructor. Each instance also carries a dense
+ * process-wide id so registries can key executors by a small integer instead
+ * of hashing the shared_ptr identity; see FlatIdMap.h.
  */
 class PlatformExecutorToken {
 public:
+  PlatformExecutorToken() : id_(nextId()) {}
   virtual ~PlatformExecutorToken() {}
+
+  uint32_t id() const {
+    return id_;
+  }
+
+private:
+  static uint32_t nextId() {
+    static std::atomic<uint32_t> next(0);
+    return next++;
+  }
+
+  uint32_t id_;
 };
 
 /**
@@ -38,6 +56,14 @@ public:
     return platformToken_.get() == other.platformToken_.get();
   }
 
+  /**
+   * Dense integer identity of the underlying platform token; stable for the
+   * token's lifetime and cheap to hash or index by.
+   */
+  uint32_t getId() const {
+    return platformToken_->id();
+  }
+
 private:
   std::shared_ptr<PlatformExecutorToken> platformToken_;
 };
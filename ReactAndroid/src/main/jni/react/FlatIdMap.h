@@ -0,0 +1,151 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace facebook {
+namespace react {
+
+/**
+ * Minimal open-addressing map keyed by small dense integer ids (executor
+ * token ids and the like). Slots live in one contiguous power-of-two array
+ * probed linearly, so the common lookup touches a single cache line instead
+ * of chasing node pointers the way std::unordered_map does. Deletion closes
+ * probe chains by backward shifting, so there are no tombstones to scan.
+ *
+ * Values must be default-constructible and movable. The id 0xffffffff is
+ * reserved as the empty-slot marker. Not thread-safe; callers synchronize
+ * (the Bridge registry wraps it in its registration lock).
+ */
+template <typename V>
+class FlatIdMap {
+public:
+  static const uint32_t kEmptyKey = 0xffffffffu;
+
+  FlatIdMap() : slots_(kInitialCapacity), size_(0) {}
+
+  /**
+   * Returns a pointer to the value for key, or null. Invalidated by any
+   * mutation of the map.
+   */
+  V* find(uint32_t key) {
+    const size_t mask = slots_.size() - 1;
+    for (size_t i = key & mask;; i = (i + 1) & mask) {
+      Slot& slot = slots_[i];
+      if (slot.key == key) {
+        return &slot.value;
+      }
+      if (slot.key == kEmptyKey) {
+        return nullptr;
+      }
+    }
+  }
+
+  /**
+   * Inserts or overwrites the value for key.
+   */
+  void emplace(uint32_t key, V&& value) {
+    if ((size_ + 1) * 4 > slots_.size() * 3) {
+      grow();
+    }
+    const size_t mask = slots_.size() - 1;
+    for (size_t i = key & mask;; i = (i + 1) & mask) {
+      Slot& slot = slots_[i];
+      if (slot.key == key) {
+        slot.value = std::move(value);
+        return;
+      }
+      if (slot.key == kEmptyKey) {
+        slot.key = key;
+        slot.value = std::move(value);
+        size_++;
+        return;
+      }
+    }
+  }
+
+  /**
+   * Removes the entry for key; returns whether it existed.
+   */
+  bool erase(uint32_t key) {
+    const size_t mask = slots_.size() - 1;
+    size_t hole;
+    for (size_t i = key & mask;; i = (i + 1) & mask) {
+      if (slots_[i].key == key) {
+        hole = i;
+        break;
+      }
+      if (slots_[i].key == kEmptyKey) {
+        return false;
+      }
+    }
+
+    // Backward-shift any entry whose probe chain runs through the hole so
+    // chains stay gap-free.
+    for (size_t j = (hole + 1) & mask; slots_[j].key != kEmptyKey;
+         j = (j + 1) & mask) {
+      size_t home = slots_[j].key & mask;
+      if (((j - home) & mask) >= ((j - hole) & mask)) {
+        slots_[hole].key = slots_[j].key;
+        slots_[hole].value = std::move(slots_[j].value);
+        hole = j;
+      }
+    }
+    slots_[hole].key = kEmptyKey;
+    slots_[hole].value = V();
+    size_--;
+    return true;
+  }
+
+  /**
+   * Calls fn(key, value&) for every live entry. The handful of entries sit
+   * in one contiguous array, so scanning them all is itself cheap.
+   */
+  template <typename F>
+  void forEach(F&& fn) {
+    for (Slot& slot : slots_) {
+      if (slot.key != kEmptyKey) {
+        fn(slot.key, slot.value);
+      }
+    }
+  }
+
+  size_t size() const {
+    return size_;
+  }
+
+private:
+  struct Slot {
+    uint32_t key = kEmptyKey;
+    V value{};
+  };
+
+  static const size_t kInitialCapacity = 8;
+
+  void grow() {
+    std::vector<Slot> old;
+    old.swap(slots_);
+    slots_.resize(old.size() * 2);
+    size_ = 0;
+    for (Slot& slot : old) {
+      if (slot.key != kEmptyKey) {
+        emplace(slot.key, std::move(slot.value));
+      }
+    }
+  }
+
+  std::vector<Slot> slots_;
+  size_t size_;
+};
+
+template <typename V>
+const uint32_t FlatIdMap<V>::kEmptyKey;
+
+template <typename V>
+const size_t FlatIdMap<V>::kInitialCapacity;
+
+} }
@@ -0,0 +1,88 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include <atomic>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#include <condition_variable>
+#include <mutex>
+#endif
+
+#include "noncopyable.h"
+
+namespace facebook {
+namespace react {
+
+/**
+ * A one-shot event with a single signaler and a single waiter, sized for the
+ * runOnQueueSync handshake. On Linux (i.e. Android) the waiter parks directly
+ * on a futex word: if the task finishes before the waiter gets around to
+ * parking, neither side makes a syscall at all, and a signal with nobody
+ * parked skips the wake syscall too. Elsewhere it degrades to the classic
+ * mutex/condvar pair.
+ *
+ * The waiter may return (and destroy the event) as soon as the signaler has
+ * stored the signaled state; a FUTEX_WAKE on the stale address is harmless,
+ * the same benign race pthread primitives live with.
+ */
+class FutexEvent : public noncopyable {
+public:
+#ifdef __linux__
+  void wait() {
+    int state = m_state.load(std::memory_order_acquire);
+    while (state != kSignaled) {
+      if (state == kUnsignaled) {
+        // Announce the waiter so signal() knows a wake syscall is needed.
+        if (!m_state.compare_exchange_weak(
+            state, kWaiting,
+            std::memory_order_acq_rel, std::memory_order_acquire)) {
+          continue;
+        }
+        state = kWaiting;
+      }
+      // Returns on wake, EINTR, or if the word no longer reads kWaiting;
+      // the loop re-checks either way.
+      syscall(SYS_futex, &m_state, FUTEX_WAIT_PRIVATE, kWaiting,
+              nullptr, nullptr, 0);
+      state = m_state.load(std::memory_order_acquire);
+    }
+  }
+
+  void signal() {
+    if (m_state.exchange(kSignaled, std::memory_order_acq_rel) == kWaiting) {
+      syscall(SYS_futex, &m_state, FUTEX_WAKE_PRIVATE, 1,
+              nullptr, nullptr, 0);
+    }
+  }
+
+private:
+  static const int kUnsignaled = 0;
+  static const int kWaiting = 1;
+  static const int kSignaled = 2;
+
+  std::atomic<int> m_state{kUnsignaled};
+#else
+  void wait() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cv.wait(lock, [this] { return m_signaled; });
+  }
+
+  void signal() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_signaled = true;
+    m_cv.notify_one();
+  }
+
+private:
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  bool m_signaled{false};
+#endif
+};
+
+} }
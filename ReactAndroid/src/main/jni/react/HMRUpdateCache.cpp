@@ -0,0 +1,62 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "HMRUpdateCache.h"
+
+#include <vector>
+
+#include "JSCSourceCache.h"
+
+namespace facebook {
+namespace react {
+
+namespace {
+
+// After this many tracked modules the set is cleared rather than evicted
+// piecemeal; the next update re-evaluates everything once and re-seeds.
+const size_t kMaxTrackedModules = 8192;
+
+} // namespace
+
+std::string HMRUpdateCache::filterChangedModules(const std::string& script) {
+  // Module boundaries: a __d( define at the start of the script or of a
+  // line. Everything between two boundaries (or before the first) is one
+  // chunk; glue code around the defines gets chunked and deduplicated the
+  // same way.
+  std::vector<size_t> boundaries;
+  if (script.compare(0, 4, "__d(") == 0) {
+    boundaries.push_back(0);
+  }
+  for (size_t pos = script.find("\n__d(");
+       pos != std::string::npos;
+       pos = script.find("\n__d(", pos + 1)) {
+    boundaries.push_back(pos + 1);
+  }
+
+  if (boundaries.empty()) {
+    // Not a module bundle; deduplicate the script as a whole.
+    return checkAndRecord(script.data(), script.size()) ? script : std::string();
+  }
+
+  if (boundaries.front() != 0) {
+    boundaries.insert(boundaries.begin(), 0);
+  }
+
+  std::string changed;
+  for (size_t i = 0; i < boundaries.size(); i++) {
+    size_t begin = boundaries[i];
+    size_t end = i + 1 < boundaries.size() ? boundaries[i + 1] : script.size();
+    if (checkAndRecord(script.data() + begin, end - begin)) {
+      changed.append(script, begin, end - begin);
+    }
+  }
+  return changed;
+}
+
+bool HMRUpdateCache::checkAndRecord(const char* data, size_t size) {
+  if (m_seenModules.size() >= kMaxTrackedModules) {
+    m_seenModules.clear();
+  }
+  return m_seenModules.insert(JSCSourceCache::hashBundle(data, size)).second;
+}
+
+} }
@@ -0,0 +1,45 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_set>
+
+namespace facebook {
+namespace react {
+
+/**
+ * Incremental filter for HMR updates (dev only).
+ *
+ * nativeInjectHMRUpdate used to re-evaluate the full injected script on
+ * every hot update, which takes seconds per edit on the larger apps. The
+ * packager concatenates one __d(...) definition per module, so the update
+ * splits cleanly on those boundaries: this cache hashes each module chunk
+ * and filters out chunks whose content was already evaluated in this
+ * context, leaving only the modules that actually changed (plus any
+ * non-module glue around them).
+ *
+ * The cache tracks content hashes, not compiled code -- the public JSC API
+ * has no way to serialize a compiled script, and skipping unchanged modules
+ * captures the same win. Hashes are per-context state and die with the
+ * executor; a bounded set keeps long dev sessions from growing it without
+ * limit (overflow clears the set, costing one full re-evaluation).
+ */
+class HMRUpdateCache {
+public:
+  /**
+   * Returns the subset of script that still needs evaluating: module chunks
+   * with unseen content plus surrounding non-module code. Returns an empty
+   * string when nothing changed. Scripts without __d( module boundaries are
+   * deduplicated whole.
+   */
+  std::string filterChangedModules(const std::string& script);
+
+private:
+  bool checkAndRecord(const char* data, size_t size);
+
+  std::unordered_set<uint64_t> m_seenModules;
+};
+
+} }
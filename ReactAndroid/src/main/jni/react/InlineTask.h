@@ -0,0 +1,130 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace facebook {
+namespace react {
+
+/**
+ * A move-only callable with fixed inline storage: like std::function but the
+ * closure always lives in the task object itself, so constructing one never
+ * allocates. Closures larger than Capacity are rejected at compile time
+ * (raise the capacity at the typedef that failed rather than shrinking the
+ * capture). Dispatch goes through a per-closure-type operations table, the
+ * same type-erasure std::function uses, minus the heap fallback.
+ *
+ * Unlike std::function, captures only need to be movable, so buffers and
+ * unique_ptrs can ride along without the shared_ptr-holder workaround.
+ */
+template <typename Signature, size_t Capacity>
+class InlineTask;
+
+template <typename Ret, typename... Args, size_t Capacity>
+class InlineTask<Ret(Args...), Capacity> {
+public:
+  InlineTask() {}
+  InlineTask(std::nullptr_t) {}
+
+  template <
+    typename Fn,
+    typename = typename std::enable_if<
+      !std::is_same<typename std::decay<Fn>::type, InlineTask>::value>::type>
+  /* implicit */ InlineTask(Fn&& fn) {
+    using Closure = typename std::decay<Fn>::type;
+    static_assert(
+        sizeof(Closure) <= Capacity,
+        "Closure does not fit InlineTask storage; raise the Capacity");
+    new (&m_storage) Closure(std::forward<Fn>(fn));
+    m_ops = OpsFor<Closure>::get();
+  }
+
+  InlineTask(InlineTask&& other) {
+    if (other.m_ops) {
+      other.m_ops->moveConstruct(&m_storage, &other.m_storage);
+      m_ops = other.m_ops;
+      other.reset();
+    }
+  }
+
+  InlineTask& operator=(InlineTask&& other) {
+    if (this != &other) {
+      reset();
+      if (other.m_ops) {
+        other.m_ops->moveConstruct(&m_storage, &other.m_storage);
+        m_ops = other.m_ops;
+        other.reset();
+      }
+    }
+    return *this;
+  }
+
+  InlineTask(const InlineTask&) = delete;
+  InlineTask& operator=(const InlineTask&) = delete;
+
+  ~InlineTask() {
+    reset();
+  }
+
+  explicit operator bool() const {
+    return m_ops != nullptr;
+  }
+
+  Ret operator()(Args... args) {
+    return m_ops->call(&m_storage, std::forward<Args>(args)...);
+  }
+
+  /**
+   * Destroys the held closure (releasing its captures) and leaves the task
+   * empty. Used by task queues to drop captures as soon as a task has run
+   * rather than when its slot is reused.
+   */
+  void reset() {
+    if (m_ops) {
+      m_ops->destroy(&m_storage);
+      m_ops = nullptr;
+    }
+  }
+
+private:
+  struct Ops {
+    Ret (*call)(void*, Args&&...);
+    void (*moveConstruct)(void*, void*);
+    void (*destroy)(void*);
+  };
+
+  template <typename Closure>
+  struct OpsFor {
+    static Ret call(void* storage, Args&&... args) {
+      return (*static_cast<Closure*>(storage))(std::forward<Args>(args)...);
+    }
+    static void moveConstruct(void* dst, void* src) {
+      new (dst) Closure(std::move(*static_cast<Closure*>(src)));
+    }
+    static void destroy(void* storage) {
+      static_cast<Closure*>(storage)->~Closure();
+    }
+    static const Ops* get() {
+      static const Ops ops = {&call, &moveConstruct, &destroy};
+      return &ops;
+    }
+  };
+
+  typename std::aligned_storage<Capacity, alignof(std::max_align_t)>::type m_storage;
+  const Ops* m_ops{nullptr};
+};
+
+/**
+ * Task type shared by MessageQueueThread and MpscTaskQueue. The capacity is
+ * sized for the bridge's biggest dispatch closure (a callFunction capture
+ * nested in its queue wrapper) so posting to a queue never heap-allocates
+ * for the closure itself; a plain std::function still converts (and carries
+ * its own allocation) for cold callers.
+ */
+using MessageQueueTask = InlineTask<void(), 320>;
+
+} }
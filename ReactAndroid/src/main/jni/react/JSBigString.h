@@ -0,0 +1,211 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include <cstdint>
+#include <fcntl.h>
+#include <memory>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "noncopyable.h"
+
+namespace facebook {
+namespace react {
+
+/**
+ * An immutable, large script blob. Abstracts over plain std::string storage
+ * and mmap-backed storage so a multi-megabyte bundle can be handed to JSC
+ * without being copied through intermediate strings.
+ */
+class JSBigString : public noncopyable {
+public:
+  JSBigString() = default;
+  virtual ~JSBigString() {}
+
+  // The contents must be null-terminated: JSStringCreateWithUTF8CString
+  // has no length-taking variant in this JSC.
+  virtual const char* c_str() const = 0;
+
+  // Length in bytes, excluding the null terminator.
+  virtual size_t size() const = 0;
+
+  // Loaders that already hashed the contents (e.g. the pre-download
+  // pipeline in JSLoader) report the bundle hash here so the JSC source
+  // cache doesn't rehash a multi-megabyte bundle on the JS thread. Returns
+  // false when no precomputed hash is attached.
+  virtual bool precomputedHash(uint64_t* hash) const {
+    return false;
+  }
+};
+
+/**
+ * JSBigString backed by a std::string. Used as the fallback when a bundle
+ * cannot be mapped (e.g. compressed assets).
+ */
+class JSBigStdString : public JSBigString {
+public:
+  explicit JSBigStdString(std::string str) :
+    m_str(std::move(str)) {}
+
+  const char* c_str() const override {
+    return m_str.c_str();
+  }
+
+  size_t size() const override {
+    return m_str.size();
+  }
+
+private:
+  std::string m_str;
+};
+
+/**
+ * Decorates another JSBigString with a hash computed off the JS thread,
+ * typically by JSLoader's bundle pre-load pipeline.
+ */
+class JSBigPreHashedString : public JSBigString {
+public:
+  JSBigPreHashedString(std::unique_ptr<const JSBigString> script, uint64_t hash) :
+    m_script(std::move(script)),
+    m_hash(hash) {}
+
+  const char* c_str() const override {
+    return m_script->c_str();
+  }
+
+  size_t size() const override {
+    return m_script->size();
+  }
+
+  bool precomputedHash(uint64_t* hash) const override {
+    *hash = m_hash;
+    return true;
+  }
+
+private:
+  std::unique_ptr<const JSBigString> m_script;
+  uint64_t m_hash;
+};
+
+/**
+ * Non-owning view of another JSBigString kept alive through a shared_ptr.
+ * Lets a second executor (e.g. the bridge's headless task executor)
+ * evaluate the same mmap-backed bundle the main executor loaded, without
+ * either a copy or a transfer of ownership.
+ */
+class JSBigSharedString : public JSBigString {
+public:
+  explicit JSBigSharedString(std::shared_ptr<const JSBigString> script) :
+    m_script(std::move(script)) {}
+
+  const char* c_str() const override {
+    return m_script->c_str();
+  }
+
+  size_t size() const override {
+    return m_script->size();
+  }
+
+  bool precomputedHash(uint64_t* hash) const override {
+    return m_script->precomputedHash(hash);
+  }
+
+private:
+  std::shared_ptr<const JSBigString> m_script;
+};
+
+/**
+ * JSBigString backed by a read-only private mapping of a file (or of a file
+ * descriptor region, for uncompressed assets). The kernel zero-fills the tail
+ * of the last page past EOF, which provides the null terminator as long as
+ * the region reaches EOF and its end is not an exact multiple of the page
+ * size; fromDescriptor refuses to map otherwise so callers can fall back to
+ * a copying load. A region ending before EOF (an asset inside the APK,
+ * which is always followed by more zip data) has the file's next bytes
+ * after it, not zeroes.
+ */
+class JSBigFileString : public JSBigString {
+public:
+  ~JSBigFileString() override {
+    if (m_map) {
+      munmap(m_map, m_mapSize);
+    }
+  }
+
+  const char* c_str() const override {
+    return static_cast<const char*>(m_map) + m_slop;
+  }
+
+  size_t size() const override {
+    return m_size;
+  }
+
+  /**
+   * Maps [offset, offset + size) of the given fd. Does not take ownership of
+   * the fd. Returns nullptr if the region can't be mapped with a guaranteed
+   * null terminator.
+   */
+  static std::unique_ptr<const JSBigFileString> fromDescriptor(
+      int fd,
+      off_t offset,
+      size_t size) {
+    static const size_t kPageSize = sysconf(_SC_PAGESIZE);
+    if (size == 0 || (offset + size) % kPageSize == 0) {
+      // No zero-filled tail byte available for the terminator.
+      return nullptr;
+    }
+
+    // The zero-filled tail only exists past EOF; a region that ends before
+    // EOF is followed by whatever the file contains next.
+    struct stat fileInfo;
+    if (::fstat(fd, &fileInfo) == -1 ||
+        static_cast<off_t>(offset + size) != fileInfo.st_size) {
+      return nullptr;
+    }
+
+    // mmap requires a page-aligned offset; adjust and skip the slop.
+    off_t alignedOffset = offset & ~(kPageSize - 1);
+    size_t slop = offset - alignedOffset;
+    size_t mapSize = size + slop;
+
+    void* mapped = mmap(nullptr, mapSize, PROT_READ, MAP_PRIVATE, fd, alignedOffset);
+    if (mapped == MAP_FAILED) {
+      return nullptr;
+    }
+
+    return std::unique_ptr<const JSBigFileString>(
+        new JSBigFileString(mapped, mapSize, slop, size));
+  }
+
+  static std::unique_ptr<const JSBigFileString> fromPath(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd == -1) {
+      return nullptr;
+    }
+
+    struct stat fileInfo;
+    std::unique_ptr<const JSBigFileString> result;
+    if (::fstat(fd, &fileInfo) != -1) {
+      result = fromDescriptor(fd, 0, fileInfo.st_size);
+    }
+    ::close(fd);
+    return result;
+  }
+
+private:
+  JSBigFileString(void* map, size_t mapSize, size_t slop, size_t size) :
+    m_map(map),
+    m_mapSize(mapSize),
+    m_slop(slop),
+    m_size(size) {}
+
+  void* m_map;
+  size_t m_mapSize;
+  size_t m_slop;
+  size_t m_size;
+};
+
+} }
@@ -3,20 +3,31 @@
 #include "JSCExecutor.h"
 
 #include <algorithm>
+#include <chrono>
 #include <condition_variable>
+#include <cstring>
 #include <mutex>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <glog/logging.h>
 #include <folly/json.h>
 #include <folly/Memory.h>
 #include <folly/String.h>
 #include <sys/time.h>
 
+#include "BlobRegistry.h"
 #include "Bridge.h"
+#include "JSCHeapTuning.h"
+#include "ThreadScheduling.h"
 #include "JSCHelpers.h"
+#include "JSCSourceCache.h"
+#include "MetricsRing.h"
+#include "ParallelJson.h"
 #include "Platform.h"
+#include "TraceRecorder.h"
 #include "Value.h"
+#include "WorkerScriptCache.h"
 
 #ifdef WITH_JSC_EXTRA_TRACING
 #include "JSCTracing.h"
@@ -45,13 +56,68 @@ using fbsystrace::FbSystraceSection;
 #include "JSCPerfStats.h"
 #endif
 
+#ifdef JSC_HAS_TYPED_ARRAY_API
+#include <JavaScriptCore/JSTypedArray.h>
+#endif
+
 static const int64_t NANOSECONDS_IN_SECOND = 1000000000LL;
 static const int64_t NANOSECONDS_IN_MILLISECOND = 1000000LL;
+static const double NANOSECONDS_TO_MILLISECONDS = 1.0 / NANOSECONDS_IN_MILLISECOND;
 
 namespace facebook {
 namespace react {
 
-static std::unordered_map<JSContextRef, JSCExecutor*> s_globalContextRefToJSCExecutor;
+// The owning executor rides in the global object's private data slot (see
+// initOnJSVMThread), so every JS->native crossing resolves its executor with
+// a pointer load instead of the shared hash map lookup this used to be —
+// which was also unsynchronized across worker threads. The slot only exists
+// because contexts are created with this (otherwise empty) global class.
+static JSClassRef globalObjectClass() {
+  static JSClassRef cls = [] {
+    JSClassDefinition definition = kJSClassDefinitionEmpty;
+    definition.className = "GlobalObject";
+    return JSClassCreate(&definition);
+  }();
+  return cls;
+}
+
+static JSCExecutor* executorForContext(JSContextRef ctx) {
+  return static_cast<JSCExecutor*>(Object::getGlobalObject(ctx).getPrivate());
+}
+
+// Pool of pre-created, pre-configured contexts; see prewarmContextPool().
+static std::mutex s_warmContextMutex;
+static std::vector<JSGlobalContextRef> s_warmContexts;
+
+// Parked worker threads with their reset VMs. Terminated web workers land
+// here (up to the cap) instead of being torn down, and the next
+// nativeStartWorker adopts a parked thread + context instead of paying full
+// thread and VM boot; see addWebWorker/terminateOwnedWebWorker.
+struct PooledWorker {
+  std::shared_ptr<MessageQueueThread> thread;
+  JSGlobalContextRef context;
+};
+static const size_t kMaxPooledWorkers = 2;
+static std::mutex s_workerPoolMutex;
+static std::vector<PooledWorker> s_workerPool;
+
+static int64_t monotonicNanos() {
+  // CLOCK_MONOTONIC is serviced from the vDSO; CLOCK_MONOTONIC_RAW takes a
+  // syscall per read on our kernels, which matters at the call rates the
+  // animation and telemetry code drives through nativePerformanceNow.
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec * NANOSECONDS_IN_SECOND + now.tv_nsec;
+}
+
+static double performanceNowMillis() {
+  // Measured against a per-process origin captured on first use, so the
+  // returned double stays small enough to keep sub-microsecond resolution
+  // instead of degrading with device uptime, and the ns->ms conversion is a
+  // single multiply by a precomputed scale.
+  static const int64_t s_timeOriginNanos = monotonicNanos();
+  return (monotonicNanos() - s_timeOriginNanos) * NANOSECONDS_TO_MILLISECONDS;
+}
 
 static JSValueRef nativePerformanceNow(
     JSContextRef ctx,
@@ -60,29 +126,21 @@ static JSValueRef nativePerformanceNow(
     size_t argumentCount,
     const JSValueRef arguments[],
     JSValueRef *exception);
-static JSValueRef nativeInjectHMRUpdate(
-    JSContextRef ctx,
-    JSObjectRef function,
-    JSObjectRef thisObject,
-    size_t argumentCount,
-    const JSValueRef arguments[],
-    JSValueRef *exception);
-
 static std::string executeJSCallWithJSC(
     JSGlobalContextRef ctx,
     const std::string& methodName,
-    const std::vector<folly::dynamic>& arguments) {
+    const folly::dynamic& jsonArgs) {
   #ifdef WITH_FBSYSTRACE
   FbSystraceSection s(
       TRACE_TAG_REACT_CXX_BRIDGE, "JSCExecutor.executeJSCall",
       "method", methodName);
   #endif
 
-  // Evaluate script with JSC
-  folly::dynamic jsonArgs(arguments.begin(), arguments.end());
+  // Evaluate script with JSC. Large argument arrays (feed deliveries etc.)
+  // are encoded across the worker pool instead of single-threaded here.
   auto js = folly::to<std::string>(
       "__fbBatchedBridge.", methodName, ".apply(null, ",
-      folly::toJson(jsonArgs), ")");
+      ParallelJson::toJson(jsonArgs), ")");
   auto result = evaluateScript(ctx, String(js.c_str()), nullptr);
   return Value(ctx, result).toJSONString();
 }
@@ -96,6 +154,9 @@ JSCExecutor::JSCExecutor(Bridge *bridge, const std::string& cacheDir, const foll
     m_deviceCacheDir(cacheDir),
     m_messageQueueThread(MessageQueues::getCurrentMessageQueueThread()),
     m_jscConfig(jscConfig) {
+  // Maps the crash-safe metrics ring beside the executor caches; idempotent
+  // across executors sharing the dir (workers, headless tasks).
+  MetricsRing::initialize(cacheDir);
   initOnJSVMThread();
 }
 
@@ -103,9 +164,11 @@ JSCExecutor::JSCExecutor(
     Bridge *bridge,
     int workerId,
     JSCExecutor *owner,
+    JSGlobalContextRef reusedContext,
     const std::string& script,
     const std::unordered_map<std::string, std::string>& globalObjAsJSON,
     const folly::dynamic& jscConfig) :
+    m_context(reusedContext),
     m_bridge(bridge),
     m_workerId(workerId),
     m_owner(owner),
@@ -123,17 +186,11 @@ JSCExecutor::JSCExecutor(
       setGlobalVariable(it.first, it.second);
     }
 
-    // Try to load the script from the network if script is a URL
-    // NB: For security, this will only work in debug builds
-    std::string scriptSrc;
-    if (script.find("http://") == 0 || script.find("https://") == 0) {
-      std::stringstream outfileBuilder;
-      outfileBuilder << m_deviceCacheDir << "/workerScript" << m_workerId << ".js";
-      scriptSrc = WebWorkerUtil::loadScriptFromNetworkSync(script, outfileBuilder.str());
-    } else {
-      // TODO(9604438): Protect against script does not exist
-      scriptSrc = WebWorkerUtil::loadScriptFromAssets(script);
-    }
+    // Scripts with a URL come from the network (debug builds only, for
+    // security) through the persistent worker script cache, so a relaunched
+    // worker starts from warm bytes and concurrent launches of the same
+    // script share one download.
+    std::string scriptSrc = WorkerScriptCache::loadScript(script, m_deviceCacheDir);
 
     // TODO(9994180): Throw on error
     loadApplicationScript(scriptSrc, script);
@@ -146,6 +203,9 @@ JSCExecutor::~JSCExecutor() {
 
 void JSCExecutor::destroy() {
   *m_isDestroyed = true;
+  if (m_perfSamplingActive) {
+    m_perfSamplingActive->store(false);
+  }
   if (m_messageQueueThread->isOnThread()) {
     terminateOnJSVMThread();
   } else {
@@ -155,41 +215,125 @@ void JSCExecutor::destroy() {
   }
 }
 
-void JSCExecutor::initOnJSVMThread() {
-  #if defined(WITH_FB_JSC_TUNING)
-  configureJSCForAndroid(m_jscConfig);
-  #endif
-  m_context = JSGlobalContextCreateInGroup(nullptr, nullptr);
-  s_globalContextRefToJSCExecutor[m_context] = this;
-  installGlobalFunction(m_context, "nativeFlushQueueImmediate", nativeFlushQueueImmediate);
-  installGlobalFunction(m_context, "nativePerformanceNow", nativePerformanceNow);
-  installGlobalFunction(m_context, "nativeStartWorker", nativeStartWorker);
-  installGlobalFunction(m_context, "nativePostMessageToWorker", nativePostMessageToWorker);
-  installGlobalFunction(m_context, "nativeTerminateWorker", nativeTerminateWorker);
-  installGlobalFunction(m_context, "nativeInjectHMRUpdate", nativeInjectHMRUpdate);
-
-  installGlobalFunction(m_context, "nativeLoggingHook", JSLogging::nativeHook);
+// Creates a context with every executor-independent global already
+// installed. The native hooks all resolve their executor through the global
+// object's private data slot at call time (null until an executor adopts the
+// context), so this can run before (and on a different thread than) the
+// executor that eventually adopts the context.
+JSGlobalContextRef JSCExecutor::createPreparedContext() {
+  JSGlobalContextRef context = JSGlobalContextCreateInGroup(nullptr, globalObjectClass());
+  installGlobalFunction(context, "nativeFlushQueueImmediate", nativeFlushQueueImmediate);
+  installGlobalFunction(context, "nativeFlushQueueBinary", nativeFlushQueueBinary);
+  installGlobalFunction(context, "nativeCallQueueHasPending", nativeCallQueueHasPending);
+  installGlobalFunction(context, "nativePerformanceNow", nativePerformanceNow);
+  installGlobalFunction(context, "nativeBatchTimeOrigin", nativeBatchTimeOrigin);
+  installGlobalFunction(context, "nativeCreateBlob", nativeCreateBlob);
+  installGlobalFunction(context, "nativeBlobTypedArray", nativeBlobTypedArray);
+  installGlobalFunction(context, "nativeReleaseBlob", nativeReleaseBlob);
+  installGlobalFunction(context, "nativeStartWorker", nativeStartWorker);
+  installGlobalFunction(context, "nativePostMessageToWorker", nativePostMessageToWorker);
+  installGlobalFunction(context, "nativeTerminateWorker", nativeTerminateWorker);
+  installGlobalFunction(context, "nativeInjectHMRUpdate", nativeInjectHMRUpdate);
+  installGlobalFunction(context, "nativeCallSyncHook", nativeCallSyncHook);
+  installGlobalFunction(context, "nativeGetLazyGlobal", nativeGetLazyGlobal);
+
+  installGlobalFunction(context, "nativeLoggingHook", JSLogging::nativeHook);
+
+  // Advertise the binary batch protocol so MessageQueue can emit
+  // length-prefixed binary batches instead of JSON; see MethodCall.h.
+  String binaryVersionProp("__fbBridgeBinaryVersion");
+  String binaryVersionJson("1");
+  JSObjectSetProperty(
+      context,
+      JSContextGetGlobalObject(context),
+      binaryVersionProp,
+      JSValueMakeFromJSONString(context, binaryVersionJson),
+      0,
+      NULL);
 
   #ifdef WITH_JSC_EXTRA_TRACING
-  addNativeTracingHooks(m_context);
-  addNativeProfilingHooks(m_context);
-  PerfLogging::installNativeHooks(m_context);
+  addNativeTracingHooks(context);
+  addNativeProfilingHooks(context);
+  installGlobalFunction(context, "nativeStartSamplingProfiler", nativeStartSamplingProfiler);
+  installGlobalFunction(context, "nativeStopSamplingProfiler", nativeStopSamplingProfiler);
+  PerfLogging::installNativeHooks(context);
   #endif
 
   #ifdef WITH_FB_MEMORY_PROFILING
-  addNativeMemoryHooks(m_context);
+  addNativeMemoryHooks(context);
   #endif
 
   #ifdef JSC_HAS_PERF_STATS_API
-  addJSCPerfStatsHooks(m_context);
+  addJSCPerfStatsHooks(context);
   #endif
 
+  addThreadPlacementHooks(context);
+
+  return context;
+}
+
+/* static */
+void JSCExecutor::prewarmContextPool(size_t poolSize) {
+  std::thread prewarmThread([poolSize] {
+    for (size_t i = 0; i < poolSize; i++) {
+      JSGlobalContextRef context = createPreparedContext();
+      std::lock_guard<std::mutex> lock(s_warmContextMutex);
+      s_warmContexts.push_back(context);
+    }
+  });
+  prewarmThread.detach();
+}
+
+/* static */
+JSGlobalContextRef JSCExecutor::takeWarmContext() {
+  std::lock_guard<std::mutex> lock(s_warmContextMutex);
+  if (s_warmContexts.empty()) {
+    return nullptr;
+  }
+  JSGlobalContextRef context = s_warmContexts.back();
+  s_warmContexts.pop_back();
+  return context;
+}
+
+void prewarmJSCContextPool(size_t poolSize) {
+  JSCExecutor::prewarmContextPool(poolSize);
+}
+
+void JSCExecutor::initOnJSVMThread() {
+  // Pin and prioritize this thread before any JS runs so the placement
+  // holds for the whole session; see ThreadScheduling.h for the config.
+  applyJSThreadScheduling(m_jscConfig);
+  #if defined(WITH_FB_JSC_TUNING)
+  // Expand any heap tuning preset into the explicit dials the tuning layer
+  // consumes before handing the config over; see JSCHeapTuning.h.
+  m_jscConfig = expandHeapTuningConfig(m_jscConfig);
+  configureJSCForAndroid(m_jscConfig);
+  #endif
+  // A pooled worker arrives here with its reused context already set;
+  // otherwise adopt a pre-warmed context when one is available, since
+  // time-to-first-JS is dominated by context creation and hook installation.
+  if (!m_context) {
+    m_context = takeWarmContext();
+  }
+  if (!m_context) {
+    m_context = createPreparedContext();
+  }
+  Object::getGlobalObject(m_context).setPrivate(this);
+
   #if defined(WITH_FB_JSC_TUNING)
   configureJSContextForAndroid(m_context, m_jscConfig, m_deviceCacheDir);
   #endif
 }
 
 void JSCExecutor::terminateOnJSVMThread() {
+  // Stop background module warming (and persist this run's require order)
+  // before anything starts tearing down the unbundle.
+  m_unbundlePrefetcher.shutdown();
+
+  // The sampling profiler aims signals at this thread and captures from this
+  // context; it has to be fully stopped before the context goes away.
+  stopSamplingProfiler();
+
   // terminateOwnedWebWorker mutates m_ownedWorkers so collect all the workers
   // to terminate first
   std::vector<int> workerIds;
@@ -202,21 +346,102 @@ void JSCExecutor::terminateOnJSVMThread() {
 
   m_batchedBridge.reset();
   m_flushedQueueObj.reset();
+  m_callFunctionObj.reset();
+  m_invokeCallbackObj.reset();
+  m_callFunctionSurfaceObj.reset();
+  m_invokeCallbackSurfaceObj.reset();
 
-  s_globalContextRefToJSCExecutor.erase(m_context);
+  Object::getGlobalObject(m_context).setPrivate(nullptr);
   JSGlobalContextRelease(m_context);
   m_context = nullptr;
 }
 
+JSGlobalContextRef JSCExecutor::resetForReuse() {
+  *m_isDestroyed = true;
+
+  // Same worker cleanup as terminateOnJSVMThread; terminateOwnedWebWorker
+  // mutates m_ownedWorkers so collect the ids first.
+  std::vector<int> workerIds;
+  for (auto& it : m_ownedWorkers) {
+    workerIds.push_back(it.first);
+  }
+  for (int workerId : workerIds) {
+    terminateOwnedWebWorker(workerId);
+  }
+
+  m_batchedBridge.reset();
+  m_flushedQueueObj.reset();
+  m_callFunctionObj.reset();
+  m_invokeCallbackObj.reset();
+  m_callFunctionSurfaceObj.reset();
+  m_invokeCallbackSurfaceObj.reset();
+  m_internedCallNames.clear();
+  m_lazyGlobals.clear();
+
+  // Strip the enumerable globals the worker script added. Everything
+  // installed by createPreparedContext is "native"-prefixed (plus the binary
+  // bridge version marker), so anything else is worker state; postMessage is
+  // reinstalled by the next worker's constructor.
+  JSObjectRef globalObj = JSContextGetGlobalObject(m_context);
+  JSPropertyNameArrayRef names = JSObjectCopyPropertyNames(m_context, globalObj);
+  size_t count = JSPropertyNameArrayGetCount(names);
+  for (size_t i = 0; i < count; i++) {
+    JSStringRef name = JSPropertyNameArrayGetNameAtIndex(names, i);
+    if (JSStringIsEqualToUTF8CString(name, "__fbBridgeBinaryVersion")) {
+      continue;
+    }
+    char prefix[7] = {0};
+    JSStringGetUTF8CString(name, prefix, sizeof(prefix));
+    if (strncmp(prefix, "native", 6) == 0) {
+      continue;
+    }
+    JSObjectDeleteProperty(m_context, globalObj, name, nullptr);
+  }
+  JSPropertyNameArrayRelease(names);
+  JSGarbageCollect(m_context);
+
+  Object::getGlobalObject(m_context).setPrivate(nullptr);
+  JSGlobalContextRef context = m_context;
+  m_context = nullptr;
+  return context;
+}
+
 // Checks if the user is in the pre-parsing cache & StringRef QE.
 // Should be removed when these features are no longer gated.
 bool JSCExecutor::usePreparsingAndStringRef(){
   return m_jscConfig.getDefault("PreparsingStringRef", true).getBool();
 }
 
+// Sets up the hash-keyed startup cache for this bundle and, on JSC builds
+// with the pre-parsing cache, points the context's cache at the per-bundle
+// directory so warm starts with an unchanged bundle skip the full parse.
+void JSCExecutor::prepareSourceCache(const char* script, size_t size) {
+  prepareSourceCacheForHash(JSCSourceCache::hashBundle(script, size));
+}
+
+void JSCExecutor::prepareSourceCache(const JSBigString& script) {
+  uint64_t bundleHash;
+  if (!script.precomputedHash(&bundleHash)) {
+    bundleHash = JSCSourceCache::hashBundle(script.c_str(), script.size());
+  }
+  prepareSourceCacheForHash(bundleHash);
+}
+
+void JSCExecutor::prepareSourceCacheForHash(uint64_t bundleHash) {
+  std::string bundleCacheDir =
+      JSCSourceCache::prepareBundleCacheDir(m_deviceCacheDir, bundleHash);
+  #if defined(WITH_FB_JSC_TUNING)
+  if (!bundleCacheDir.empty()) {
+    configureJSContextForAndroid(m_context, m_jscConfig, bundleCacheDir);
+  }
+  #endif
+}
+
 void JSCExecutor::loadApplicationScript(
     const std::string& script,
     const std::string& sourceURL) {
+  m_startupTimings.loadStart = BridgeMetrics::nowMicros();
+  prepareSourceCache(script.c_str(), script.size());
   ReactMarker::logMarker("loadApplicationScript_startStringConvert");
 #if WITH_FBJSCEXTENSIONS
   JSStringRef jsScriptRef;
@@ -232,18 +457,90 @@ void JSCExecutor::loadApplicationScript(
 #endif
 
   ReactMarker::logMarker("loadApplicationScript_endStringConvert");
+  m_startupTimings.sourceReady = BridgeMetrics::nowMicros();
 
   String jsSourceURL(sourceURL.c_str());
   #ifdef WITH_FBSYSTRACE
   FbSystraceSection s(TRACE_TAG_REACT_CXX_BRIDGE, "JSCExecutor::loadApplicationScript",
     "sourceURL", sourceURL);
   #endif
+  // The stock JSC C API gives no parse/execute split inside evaluateScript;
+  // this phase covers both, and on warm starts the source cache set up above
+  // absorbs most of the parse anyway.
+  m_startupTimings.evaluateStart = BridgeMetrics::nowMicros();
   evaluateScript(m_context, jsScript, jsSourceURL);
+  m_startupTimings.evaluateEnd = BridgeMetrics::nowMicros();
   flush();
+  m_startupTimings.firstFlushEnd = BridgeMetrics::nowMicros();
   ReactMarker::logMarker("RUN_JS_BUNDLE_END");
   ReactMarker::logMarker("CREATE_REACT_CONTEXT_END");
 }
 
+void JSCExecutor::loadApplicationScript(
+    std::unique_ptr<const JSBigString> script,
+    const std::string& sourceURL) {
+  m_startupTimings.loadStart = BridgeMetrics::nowMicros();
+  prepareSourceCache(*script);
+  ReactMarker::logMarker("loadApplicationScript_startStringConvert");
+#if WITH_FBJSCEXTENSIONS
+  JSStringRef jsScriptRef;
+  if (usePreparsingAndStringRef()) {
+    jsScriptRef = JSStringCreateWithUTF8CStringExpectAscii(script->c_str(), script->size());
+  } else {
+    jsScriptRef = JSStringCreateWithUTF8CString(script->c_str());
+  }
+
+  String jsScript = String::adopt(jsScriptRef);
+#else
+  String jsScript(script->c_str());
+#endif
+  // The JSString holds its own copy now; release the buffer (and any mapping
+  // behind it) before evaluation rather than holding both alive.
+  script.reset();
+
+  ReactMarker::logMarker("loadApplicationScript_endStringConvert");
+  m_startupTimings.sourceReady = BridgeMetrics::nowMicros();
+
+  String jsSourceURL(sourceURL.c_str());
+  #ifdef WITH_FBSYSTRACE
+  FbSystraceSection s(TRACE_TAG_REACT_CXX_BRIDGE, "JSCExecutor::loadApplicationScript",
+    "sourceURL", sourceURL);
+  #endif
+  m_startupTimings.evaluateStart = BridgeMetrics::nowMicros();
+  evaluateScript(m_context, jsScript, jsSourceURL);
+  m_startupTimings.evaluateEnd = BridgeMetrics::nowMicros();
+  flush();
+  m_startupTimings.firstFlushEnd = BridgeMetrics::nowMicros();
+  ReactMarker::logMarker("RUN_JS_BUNDLE_END");
+  ReactMarker::logMarker("CREATE_REACT_CONTEXT_END");
+}
+
+namespace {
+
+// Startup segments below this size aren't worth a queue yield; boundaries
+// closer together are merged into the running segment.
+const size_t kMinStartupSegmentBytes = 128 * 1024;
+
+// Splits unbundle startup code at top-of-line __d( module boundaries (the
+// same boundaries the packager emitted it with) into segments of at least
+// kMinStartupSegmentBytes, each independently evaluatable.
+std::vector<std::string> splitStartupSegments(const std::string& startupCode) {
+  std::vector<std::string> segments;
+  size_t segmentStart = 0;
+  for (size_t pos = startupCode.find("\n__d(");
+       pos != std::string::npos;
+       pos = startupCode.find("\n__d(", pos + 1)) {
+    if (pos + 1 - segmentStart >= kMinStartupSegmentBytes) {
+      segments.push_back(startupCode.substr(segmentStart, pos + 1 - segmentStart));
+      segmentStart = pos + 1;
+    }
+  }
+  segments.push_back(startupCode.substr(segmentStart));
+  return segments;
+}
+
+} // namespace
+
 void JSCExecutor::loadApplicationUnbundle(
     std::unique_ptr<JSModulesUnbundle> unbundle,
     const std::string& startupCode,
@@ -252,7 +549,53 @@ void JSCExecutor::loadApplicationUnbundle(
     installGlobalFunction(m_context, "nativeRequire", nativeRequire);
   }
   m_unbundle = std::move(unbundle);
+
+  auto segments = std::make_shared<std::vector<std::string>>(
+      splitStartupSegments(startupCode));
+  if (segments->size() > 1) {
+    // Evaluate the first segment now and the rest as queued tasks, so early
+    // bridge traffic gets to interleave with startup evaluation instead of
+    // waiting out the whole multi-hundred-millisecond shot. The final
+    // segment's task takes care of the end markers and the prefetcher.
+    prepareSourceCache(startupCode.c_str(), startupCode.size());
+    evaluateStartupSegments(segments, 0, std::make_shared<std::string>(sourceURL));
+    return;
+  }
+
   loadApplicationScript(startupCode, sourceURL);
+  // Startup is done evaluating; warm the modules last run required first so
+  // upcoming nativeRequires find them already in memory.
+  m_unbundlePrefetcher.start(
+      m_unbundle.get(), UnbundlePrefetcher::profilePathFor(m_deviceCacheDir));
+}
+
+void JSCExecutor::evaluateStartupSegments(
+    std::shared_ptr<std::vector<std::string>> segments,
+    size_t index,
+    std::shared_ptr<std::string> sourceURL) {
+  #ifdef WITH_FBSYSTRACE
+  FbSystraceSection s(TRACE_TAG_REACT_CXX_BRIDGE, "JSCExecutor::evaluateStartupSegment",
+    "sourceURL", *sourceURL);
+  #endif
+  String jsSourceURL(sourceURL->c_str());
+  String jsScript = String::createExpectingAscii((*segments)[index]);
+  evaluateScript(m_context, jsScript, jsSourceURL);
+
+  if (index + 1 < segments->size()) {
+    std::shared_ptr<bool> isDestroyed = m_isDestroyed;
+    m_messageQueueThread->runOnQueue([this, isDestroyed, segments, index, sourceURL] {
+      if (*isDestroyed) {
+        return;
+      }
+      evaluateStartupSegments(segments, index + 1, sourceURL);
+    });
+  } else {
+    flush();
+    ReactMarker::logMarker("RUN_JS_BUNDLE_END");
+    ReactMarker::logMarker("CREATE_REACT_CONTEXT_END");
+    m_unbundlePrefetcher.start(
+        m_unbundle.get(), UnbundlePrefetcher::profilePathFor(m_deviceCacheDir));
+  }
 }
 
 bool JSCExecutor::ensureBatchedBridgeObject() {
@@ -266,20 +609,83 @@ bool JSCExecutor::ensureBatchedBridgeObject() {
   }
   m_batchedBridge = folly::make_unique<Object>(batchedBridgeValue.asObject());
   m_flushedQueueObj = folly::make_unique<Object>(m_batchedBridge->getProperty("flushedQueue").asObject());
+
+  // Resolve the hot bridge entry points once so per-call dispatch is a plain
+  // JSObjectCallAsFunction instead of a parse+compile of a fresh script.
+  Value callFunctionValue = m_batchedBridge->getProperty("callFunctionReturnFlushedQueue");
+  if (!callFunctionValue.isUndefined()) {
+    m_callFunctionObj = folly::make_unique<Object>(callFunctionValue.asObject());
+  }
+  Value invokeCallbackValue = m_batchedBridge->getProperty("invokeCallbackAndReturnFlushedQueue");
+  if (!invokeCallbackValue.isUndefined()) {
+    m_invokeCallbackObj = folly::make_unique<Object>(invokeCallbackValue.asObject());
+  }
+
+  // Surface-addressed entry points, exported only by runtimes built for
+  // shared-VM mode; their absence just means every call takes the plain path.
+  Value callSurfaceValue = m_batchedBridge->getProperty("callFunctionReturnFlushedQueueForSurface");
+  if (!callSurfaceValue.isUndefined()) {
+    m_callFunctionSurfaceObj = folly::make_unique<Object>(callSurfaceValue.asObject());
+  }
+  Value invokeSurfaceValue = m_batchedBridge->getProperty("invokeCallbackAndReturnFlushedQueueForSurface");
+  if (!invokeSurfaceValue.isUndefined()) {
+    m_invokeCallbackSurfaceObj = folly::make_unique<Object>(invokeSurfaceValue.asObject());
+  }
   return true;
 }
 
+std::string JSCExecutor::callCachedBridgeMethod(
+    Object* method,
+    const std::string& methodName,
+    const CallArgsBuilder& arguments) {
+  if (!method || !method->isFunction()) {
+    // Unknown or non-function bridge member: keep the script-eval fallback.
+    return executeJSCallWithJSC(m_context, methodName, arguments.args());
+  }
+
+  #ifdef WITH_FBSYSTRACE
+  FbSystraceSection s(
+      TRACE_TAG_REACT_CXX_BRIDGE, "JSCExecutor.callCachedBridgeMethod",
+      "method", methodName);
+  #endif
+  TraceRecorder::Section ts("JSCExecutor.callCachedBridgeMethod");
+  m_batchTimeOrigin = performanceNowMillis();
+
+  std::vector<JSValueRef> args;
+  args.reserve(arguments.size());
+  for (const auto& arg : arguments.args()) {
+    args.push_back(Value::fromDynamic(m_context, arg));
+  }
+  auto result = method->callAsFunction(args.size(), args.data());
+  // The returned value is the flushed queue, so whatever JS enqueued during
+  // the call has been drained along with it.
+  m_hasPendingJSCalls = false;
+  return result.toJSONString();
+}
+
 void JSCExecutor::flush() {
   #ifdef WITH_FBSYSTRACE
   FbSystraceSection s(
       TRACE_TAG_REACT_CXX_BRIDGE, "JSCExecutor.flush");
   #endif
+  TraceRecorder::Section ts("JSCExecutor.flush");
 
   if (!ensureBatchedBridgeObject()) {
     throwJSExecutionException(
         "Couldn't get the native call queue: bridge configuration isn't available. This shouldn't be possible. Congratulations.");
   }
 
+  // Once MessageQueue has started signaling enqueues through
+  // nativeCallQueueHasPending, a clear flag means flushedQueue() would come
+  // back null; skip the script invocation and JSON round trip and just mark
+  // the batch complete. Traces show most flushes fall in this bucket.
+  if (m_pendingFlagInUse && !m_hasPendingJSCalls) {
+    m_bridge->callNativeModules(*this, "null", true);
+    return;
+  }
+
+  m_hasPendingJSCalls = false;
+  m_batchTimeOrigin = performanceNowMillis();
   std::string calls = m_flushedQueueObj->callAsFunction().toJSONString();
   m_bridge->callNativeModules(*this, calls, true);
 }
@@ -293,26 +699,148 @@ void JSCExecutor::callFunction(const std::string& moduleId, const std::string& m
         methodId.c_str());
   }
 
-  std::vector<folly::dynamic> call {
-      moduleId,
-      methodId,
-      std::move(arguments),
-  };
-  std::string calls = executeJSCallWithJSC(m_context, "callFunctionReturnFlushedQueue", std::move(call));
+  m_callArgs.clear();
+  m_callArgs.append(moduleId);
+  m_callArgs.append(methodId);
+  m_callArgs.append(folly::dynamic(arguments));
+  std::string calls = callCachedBridgeMethod(
+      m_callFunctionObj.get(), "callFunctionReturnFlushedQueue", m_callArgs);
   m_bridge->callNativeModules(*this, calls, true);
 }
 
+void JSCExecutor::callFunction(
+    uint32_t callHandle,
+    const std::string& moduleId,
+    const std::string& methodId,
+    const folly::dynamic& arguments) {
+  if (!ensureBatchedBridgeObject()) {
+    throwJSExecutionException(
+        "Couldn't call JS module %s, method %s: bridge configuration isn't available. This "
+        "probably means you're calling a JS module method before bridge setup has completed or without a JS bundle loaded.",
+        moduleId.c_str(),
+        methodId.c_str());
+  }
+  if (!m_callFunctionObj || !m_callFunctionObj->isFunction()) {
+    // No cached bridge method to feed the raw JSValueRefs to; take the
+    // generic path.
+    callFunction(moduleId, methodId, arguments);
+    return;
+  }
+
+  auto it = m_internedCallNames.find(callHandle);
+  if (it == m_internedCallNames.end()) {
+    // First call through this handle: build the JSStringRefs once. They are
+    // context-independent UTF-16 buffers, so JSValueMakeString below is just
+    // a wrap, not a transcode.
+    it = m_internedCallNames.emplace(
+        callHandle,
+        std::make_pair(String(moduleId.c_str()), String(methodId.c_str()))).first;
+  }
+
+  TraceRecorder::Section ts("JSCExecutor.callFunction");
+  m_batchTimeOrigin = performanceNowMillis();
+  Value argsValue = Value::fromDynamic(m_context, arguments);
+  JSValueRef args[3] = {
+      JSValueMakeString(m_context, it->second.first),
+      JSValueMakeString(m_context, it->second.second),
+      argsValue,
+  };
+  auto result = m_callFunctionObj->callAsFunction(3, args);
+  m_hasPendingJSCalls = false;
+  m_bridge->callNativeModules(*this, result.toJSONString(), true);
+}
+
+void JSCExecutor::callFunctionBatch(std::vector<JSFunctionCall>&& calls) {
+  if (!ensureBatchedBridgeObject()) {
+    throwJSExecutionException(
+        "Couldn't call JS module batch: bridge configuration isn't available. This "
+        "probably means you're calling a JS module method before bridge setup has completed or without a JS bundle loaded.");
+  }
+
+  #ifdef WITH_FBSYSTRACE
+  FbSystraceSection s(
+      TRACE_TAG_REACT_CXX_BRIDGE, "JSCExecutor.callFunctionBatch");
+  #endif
+  TraceRecorder::Section ts("JSCExecutor.callFunctionBatch");
+
+  // Only the final flush is marked end-of-batch so the native side signals
+  // onBatchComplete once for the whole burst.
+  for (size_t i = 0; i < calls.size(); i++) {
+    m_callArgs.clear();
+    m_callArgs.append(std::move(calls[i].moduleId));
+    m_callArgs.append(std::move(calls[i].methodId));
+    m_callArgs.append(std::move(calls[i].arguments));
+    std::string nativeCalls = callCachedBridgeMethod(
+        m_callFunctionObj.get(), "callFunctionReturnFlushedQueue", m_callArgs);
+    m_bridge->callNativeModules(*this, nativeCalls, i == calls.size() - 1);
+  }
+}
+
+void JSCExecutor::callFunctionOnSurface(
+    uint32_t surfaceId,
+    const std::string& moduleId,
+    const std::string& methodId,
+    const folly::dynamic& arguments) {
+  if (!ensureBatchedBridgeObject()) {
+    throwJSExecutionException(
+        "Couldn't call JS module %s, method %s on surface %d: bridge configuration isn't available. This "
+        "probably means you're calling a JS module method before bridge setup has completed or without a JS bundle loaded.",
+        moduleId.c_str(),
+        methodId.c_str(),
+        (int) surfaceId);
+  }
+  if (!m_callFunctionSurfaceObj) {
+    // Runtime without surface support: single-surface dispatch, returns
+    // route to the host bridge's callback.
+    callFunction(moduleId, methodId, arguments);
+    return;
+  }
+
+  m_callArgs.clear();
+  m_callArgs.append((double) surfaceId);
+  m_callArgs.append(moduleId);
+  m_callArgs.append(methodId);
+  m_callArgs.append(folly::dynamic(arguments));
+  std::string calls = callCachedBridgeMethod(
+      m_callFunctionSurfaceObj.get(), "callFunctionReturnFlushedQueueForSurface", m_callArgs);
+  m_bridge->callNativeModulesFromSurface(surfaceId, calls, true);
+}
+
+void JSCExecutor::invokeCallbackOnSurface(
+    uint32_t surfaceId,
+    const double callbackId,
+    const folly::dynamic& arguments) {
+  if (!ensureBatchedBridgeObject()) {
+    throwJSExecutionException(
+        "Couldn't invoke JS callback %d on surface %d: bridge configuration isn't available. This shouldn't be possible. Congratulations.",
+        (int) callbackId,
+        (int) surfaceId);
+  }
+  if (!m_invokeCallbackSurfaceObj) {
+    invokeCallback(callbackId, arguments);
+    return;
+  }
+
+  m_callArgs.clear();
+  m_callArgs.append((double) surfaceId);
+  m_callArgs.append((double) callbackId);
+  m_callArgs.append(folly::dynamic(arguments));
+  std::string calls = callCachedBridgeMethod(
+      m_invokeCallbackSurfaceObj.get(), "invokeCallbackAndReturnFlushedQueueForSurface", m_callArgs);
+  m_bridge->callNativeModulesFromSurface(surfaceId, calls, true);
+}
+
 void JSCExecutor::invokeCallback(const double callbackId, const folly::dynamic& arguments) {
   if (!ensureBatchedBridgeObject()) {
     throwJSExecutionException(
         "Couldn't invoke JS callback %d: bridge configuration isn't available. This shouldn't be possible. Congratulations.", (int) callbackId);
   }
 
-  std::vector<folly::dynamic> call {
-      (double) callbackId,
-      std::move(arguments)
-  };
-  std::string calls = executeJSCallWithJSC(m_context, "invokeCallbackAndReturnFlushedQueue", std::move(call));
+  m_callArgs.clear();
+  m_callArgs.append((double) callbackId);
+  m_callArgs.append(folly::dynamic(arguments));
+  std::string calls = callCachedBridgeMethod(
+      m_invokeCallbackObj.get(), "invokeCallbackAndReturnFlushedQueue", m_callArgs);
   m_bridge->callNativeModules(*this, calls, true);
 }
 
@@ -326,10 +854,38 @@ void JSCExecutor::setGlobalVariable(const std::string& propName, const std::stri
   JSObjectSetProperty(m_context, globalObject, jsPropertyName, valueToInject, 0, NULL);
 }
 
+void JSCExecutor::setGlobalVariable(
+    const std::string& propName,
+    std::unique_ptr<const std::string> jsonValue) {
+  // Park the payload and put a self-replacing getter in its place: the JSON
+  // is parsed the first time JS reads the global, and for globals the bundle
+  // never touches it isn't parsed at all. The getter redefines the property
+  // as a plain value so later reads cost nothing.
+  m_lazyGlobals[propName] = std::move(jsonValue);
+  auto js = folly::to<std::string>(
+      "Object.defineProperty(this, \"", propName, "\", {"
+      "configurable: true, enumerable: true, get: function() {"
+      "var value = nativeGetLazyGlobal(\"", propName, "\");"
+      "Object.defineProperty(this, \"", propName, "\", {"
+      "configurable: true, enumerable: true, writable: true, value: value});"
+      "return value;"
+      "}})");
+  evaluateScript(m_context, String(js.c_str()), nullptr);
+}
+
 void* JSCExecutor::getJavaScriptContext() {
   return m_context;
 }
 
+folly::dynamic JSCExecutor::getStartupTimings() {
+  return folly::dynamic::object
+      ("loadStartMicros", m_startupTimings.loadStart.load())
+      ("sourceReadyMicros", m_startupTimings.sourceReady.load())
+      ("evaluateStartMicros", m_startupTimings.evaluateStart.load())
+      ("evaluateEndMicros", m_startupTimings.evaluateEnd.load())
+      ("firstFlushEndMicros", m_startupTimings.firstFlushEnd.load());
+}
+
 bool JSCExecutor::supportsProfiling() {
   #ifdef WITH_FBSYSTRACE
   return true;
@@ -370,17 +926,182 @@ void JSCExecutor::handleMemoryPressureCritical() {
   #endif
 }
 
-void JSCExecutor::flushQueueImmediate(std::string queueJSON) {
+void JSCExecutor::scheduleIdleGC(int slices) {
+  if (slices <= 0) {
+    return;
+  }
+  auto isDestroyed = m_isDestroyed;
+  // Each slice is its own queued task, so bridge traffic that is already
+  // waiting runs between reclamation steps instead of stacking up behind one
+  // long synchronous collection.
+  m_messageQueueThread->runOnQueue([this, isDestroyed, slices] {
+    if (*isDestroyed) {
+      return;
+    }
+#ifdef WITH_JSC_MEMORY_PRESSURE
+    // A moderate-pressure release is a bounded partial reclamation; repeated
+    // slices converge on what one critical (full) collection would free.
+    JSHandleMemoryPressure(this, m_context, JSMemoryPressure::MODERATE);
+#else
+    // Without the pressure API the only lever is a full collect; run it on
+    // the final slice only, so the deferral still lets queued work go first.
+    if (slices == 1) {
+      JSGarbageCollect(m_context);
+    }
+#endif
+    scheduleIdleGC(slices - 1);
+  });
+}
+
+void JSCExecutor::startPerfStatsSampling(int intervalMs) {
+  stopPerfStatsSampling();
+  if (!m_perfSampler) {
+    m_perfSampler = std::make_shared<JSCPerfSampler>();
+  }
+
+  auto active = std::make_shared<std::atomic<bool>>(true);
+  m_perfSamplingActive = active;
+
+  // The timer thread only sleeps and posts; the actual snapshot runs on the
+  // VM thread where JSC's stats APIs are safe to call. Captured shared_ptrs
+  // keep the sampler and queue alive if the executor dies mid-interval.
+  auto sampler = m_perfSampler;
+  auto queueThread = m_messageQueueThread;
+  auto isDestroyed = m_isDestroyed;
+  std::thread([this, active, sampler, queueThread, isDestroyed, intervalMs] {
+    while (active->load()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(intervalMs));
+      if (!active->load()) {
+        break;
+      }
+      queueThread->runOnQueue([this, active, sampler, isDestroyed] {
+        if (*isDestroyed || !active->load()) {
+          return;
+        }
+        sampler->sample(m_context);
+      });
+    }
+  }).detach();
+}
+
+void JSCExecutor::stopPerfStatsSampling() {
+  if (m_perfSamplingActive) {
+    m_perfSamplingActive->store(false);
+    m_perfSamplingActive.reset();
+  }
+}
+
+void JSCExecutor::startSamplingProfiler(int intervalMs, const std::string& outputPath) {
+  if (!m_samplingProfiler) {
+    m_samplingProfiler.reset(new JSCSamplingProfiler());
+  }
+  m_samplingProfiler->start(
+      m_context, m_messageQueueThread, m_isDestroyed, outputPath, intervalMs);
+}
+
+void JSCExecutor::stopSamplingProfiler() {
+  if (m_samplingProfiler) {
+    m_samplingProfiler->stop();
+  }
+}
+
+folly::dynamic JSCExecutor::getPerfStatsSamples() {
+  if (!m_perfSampler) {
+    return folly::dynamic::array();
+  }
+  return m_perfSampler->drain();
+}
+
+void JSCExecutor::flushQueueImmediate(std::string queueJSON, uint32_t surfaceId) {
+  if (surfaceId != 0) {
+    // Surface queues don't participate in the host's has-pending protocol;
+    // hand the batch straight to the surface's bridge.
+    m_bridge->callNativeModulesFromSurface(surfaceId, queueJSON, false);
+    return;
+  }
+  // MessageQueue resets its queue right after this immediate flush returns.
+  m_hasPendingJSCalls = false;
   m_bridge->callNativeModules(*this, queueJSON, false);
 }
 
+void JSCExecutor::flushQueueBinary(JSStringRef batch) {
+  // Binary batches ride in a JS string with one byte per UTF-16 unit. Read
+  // the characters straight out of JSC's internal buffer and narrow them into
+  // the reusable channel buffer: after warmup no allocation happens here,
+  // unlike toJSONString which materializes a fresh UTF-8 copy per flush.
+  m_hasPendingJSCalls = false;
+  const JSChar* chars = JSStringGetCharactersPtr(batch);
+  size_t length = JSStringGetLength(batch);
+  m_flushChannelBuffer.resize(length);
+  for (size_t i = 0; i < length; i++) {
+    m_flushChannelBuffer[i] = (char)(chars[i] & 0xff);
+  }
+  m_bridge->callNativeModules(*this, m_flushChannelBuffer, false);
+}
+
 void JSCExecutor::loadModule(uint32_t moduleId) {
+  m_unbundlePrefetcher.recordRequire(moduleId);
+
+  // Mapped unbundles can lend us the module source directly; only fall back
+  // to the copying getModule() for backends that read per-module files.
+  JSModulesUnbundle::ModuleRef moduleRef;
+  if (m_unbundle->getModuleRef(moduleId, &moduleRef)) {
+    auto sourceUrl = String::createExpectingAscii(moduleRef.name);
+    String source(moduleRef.code);
+    evaluateScript(m_context, source, sourceUrl);
+    return;
+  }
+
   auto module = m_unbundle->getModule(moduleId);
   auto sourceUrl = String::createExpectingAscii(module.name);
   auto source = String::createExpectingAscii(module.code);
   evaluateScript(m_context, source, sourceUrl);
 }
 
+#ifdef JSC_HAS_TYPED_ARRAY_API
+static void releaseTransferredBytes(void* bytes, void* deallocatorContext) {
+  delete[] static_cast<uint8_t*>(bytes);
+}
+
+// Detaches the bytes of each typed array in listRef into native buffers.
+// The C API can't neuter the source views, so the source's copy lives until
+// its VM collects it, but the payload itself crosses VMs as raw bytes with
+// no JSON round trip.
+static bool collectTransferables(
+    JSContextRef ctx,
+    JSValueRef listRef,
+    TransferList& out,
+    JSValueRef *exception) {
+  Value listValue(ctx, listRef);
+  if (!listValue.isObject()) {
+    *exception = makeJSCException(ctx, "Transfer list must be an array of typed arrays");
+    return false;
+  }
+  Object listObj = listValue.asObject();
+  size_t length = (size_t) listObj.getProperty("length").asNumber();
+  for (size_t i = 0; i < length; i++) {
+    Value elem = listObj.getPropertyAtIndex(i);
+    if (!elem.isObject()) {
+      *exception = makeJSCException(ctx, "Transfer list entries must be typed arrays");
+      return false;
+    }
+    JSObjectRef elemObj = (JSObjectRef) elem.asObject();
+    size_t size = JSObjectGetTypedArrayByteLength(ctx, elemObj, exception);
+    void* data = JSObjectGetTypedArrayBytesPtr(ctx, elemObj, exception);
+    if (!data) {
+      *exception = makeJSCException(ctx, "Transfer list entries must be typed arrays");
+      return false;
+    }
+    TransferableBuffer buffer;
+    buffer.bytes.reset(new uint8_t[size]);
+    buffer.size = size;
+    memcpy(buffer.bytes.get(), data, size);
+    out.push_back(std::move(buffer));
+  }
+  return true;
+}
+#endif
+
 int JSCExecutor::addWebWorker(
     const std::string& script,
     JSValueRef workerRef,
@@ -390,10 +1111,25 @@ int JSCExecutor::addWebWorker(
 
   Object globalObj = Value(m_context, globalObjRef).asObject();
 
-  auto workerMQT = WebWorkerUtil::createWebWorkerThread(workerId, m_messageQueueThread.get());
+  // Adopt a parked worker thread and its reset VM when one is available;
+  // only a fresh spawn pays for thread creation and VM boot.
+  std::shared_ptr<MessageQueueThread> workerMQT;
+  JSGlobalContextRef pooledContext = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(s_workerPoolMutex);
+    if (!s_workerPool.empty()) {
+      workerMQT = std::move(s_workerPool.back().thread);
+      pooledContext = s_workerPool.back().context;
+      s_workerPool.pop_back();
+    }
+  }
+  if (!workerMQT) {
+    workerMQT = WebWorkerUtil::createWebWorkerThread(workerId, m_messageQueueThread.get());
+  }
   std::unique_ptr<JSCExecutor> worker;
-  workerMQT->runOnQueueSync([this, &worker, &script, &globalObj, workerId] () {
-    worker.reset(new JSCExecutor(m_bridge, workerId, this, script, globalObj.toJSONMap(), m_jscConfig));
+  workerMQT->runOnQueueSync([this, &worker, &script, &globalObj, workerId, pooledContext] () {
+    worker.reset(new JSCExecutor(
+        m_bridge, workerId, this, pooledContext, script, globalObj.toJSONMap(), m_jscConfig));
   });
 
   Object workerObj = Value(m_context, workerRef).asObject();
@@ -413,31 +1149,37 @@ int JSCExecutor::addWebWorker(
   return workerId;
 }
 
-void JSCExecutor::postMessageToOwnedWebWorker(int workerId, JSValueRef message, JSValueRef *exn) {
+void JSCExecutor::postMessageToOwnedWebWorker(
+    int workerId,
+    JSValueRef message,
+    TransferList&& transfer,
+    JSValueRef *exn) {
   auto worker = m_ownedWorkers.at(workerId).executor;
   std::string msgString = Value(m_context, message).toJSONString();
 
   std::shared_ptr<bool> isWorkerDestroyed = worker->m_isDestroyed;
-  worker->m_messageQueueThread->runOnQueue([isWorkerDestroyed, worker, msgString] () {
+  worker->m_messageQueueThread->runOnQueue(
+      [isWorkerDestroyed, worker, msgString, transfer=std::move(transfer)] () mutable {
     if (*isWorkerDestroyed) {
       return;
     }
-    worker->receiveMessageFromOwner(msgString);
+    worker->receiveMessageFromOwner(msgString, std::move(transfer));
   });
 }
 
-void JSCExecutor::postMessageToOwner(JSValueRef msg) {
+void JSCExecutor::postMessageToOwner(JSValueRef msg, TransferList&& transfer) {
   std::string msgString = Value(m_context, msg).toJSONString();
   std::shared_ptr<bool> ownerIsDestroyed = m_owner->m_isDestroyed;
-  m_owner->m_messageQueueThread->runOnQueue([workerId=m_workerId, owner=m_owner, ownerIsDestroyed, msgString] () {
+  m_owner->m_messageQueueThread->runOnQueue(
+      [workerId=m_workerId, owner=m_owner, ownerIsDestroyed, msgString, transfer=std::move(transfer)] () mutable {
     if (*ownerIsDestroyed) {
       return;
     }
-    owner->receiveMessageFromOwnedWebWorker(workerId, msgString);
+    owner->receiveMessageFromOwnedWebWorker(workerId, msgString, std::move(transfer));
   });
 }
 
-void JSCExecutor::receiveMessageFromOwnedWebWorker(int workerId, const std::string& json) {
+void JSCExecutor::receiveMessageFromOwnedWebWorker(int workerId, const std::string& json, TransferList&& transfer) {
   Object* workerObj;
   try {
     workerObj = &m_ownedWorkers.at(workerId).jsObj;
@@ -451,16 +1193,16 @@ void JSCExecutor::receiveMessageFromOwnedWebWorker(int workerId, const std::stri
     return;
   }
 
-  JSValueRef args[] = { createMessageObject(json) };
+  JSValueRef args[] = { createMessageObject(json, std::move(transfer)) };
   onmessageValue.asObject().callAsFunction(1, args);
 
   flush();
 }
 
-void JSCExecutor::receiveMessageFromOwner(const std::string& msgString) {
+void JSCExecutor::receiveMessageFromOwner(const std::string& msgString, TransferList&& transfer) {
   CHECK(m_owner) << "Received message in a Executor that doesn't have an owner!";
 
-  JSValueRef args[] = { createMessageObject(msgString) };
+  JSValueRef args[] = { createMessageObject(msgString, std::move(transfer)) };
   Value onmessageValue = Object::getGlobalObject(m_context).getProperty("onmessage");
   onmessageValue.asObject().callAsFunction(1, args);
 }
@@ -469,18 +1211,68 @@ void JSCExecutor::terminateOwnedWebWorker(int workerId) {
   auto& workerRegistration = m_ownedWorkers.at(workerId);
   std::shared_ptr<MessageQueueThread> workerMQT = workerRegistration.executor->m_messageQueueThread;
   ExecutorToken workerExecutorToken = workerRegistration.executorToken;
+  JSCExecutor *workerPtr = workerRegistration.executor;
   m_ownedWorkers.erase(workerId);
 
   std::unique_ptr<JSExecutor> worker = m_bridge->unregisterExecutor(workerExecutorToken);
+
+  // Park the thread and its reset VM for the next spawn instead of tearing
+  // both down, if the pool has room.
+  bool poolHasRoom;
+  {
+    std::lock_guard<std::mutex> lock(s_workerPoolMutex);
+    poolHasRoom = s_workerPool.size() < kMaxPooledWorkers;
+  }
+  if (poolHasRoom) {
+    JSGlobalContextRef pooledContext = nullptr;
+    workerMQT->runOnQueueSync([workerPtr, &pooledContext] () {
+      pooledContext = workerPtr->resetForReuse();
+    });
+    worker.reset();
+
+    {
+      std::lock_guard<std::mutex> lock(s_workerPoolMutex);
+      if (s_workerPool.size() < kMaxPooledWorkers) {
+        s_workerPool.push_back(PooledWorker{std::move(workerMQT), pooledContext});
+        return;
+      }
+    }
+    // Lost the race for the last slot; tear down after all.
+    JSGlobalContextRelease(pooledContext);
+    workerMQT->quitSynchronous();
+    return;
+  }
+
   worker->destroy();
   worker.reset();
   workerMQT->quitSynchronous();
 }
 
-Object JSCExecutor::createMessageObject(const std::string& msgJson) {
+Object JSCExecutor::createMessageObject(const std::string& msgJson, TransferList&& transfer) {
   Value rebornJSMsg = Value::fromJSON(m_context, String(msgJson.c_str()));
   Object messageObject = Object::create(m_context);
   messageObject.setProperty("data", rebornJSMsg);
+#ifdef JSC_HAS_TYPED_ARRAY_API
+  // Transferred buffers surface as event.buffers, a Uint8Array per entry
+  // wrapping the native bytes directly — no copy into the receiving VM.
+  if (!transfer.empty()) {
+    std::vector<JSValueRef> views;
+    views.reserve(transfer.size());
+    for (auto& buffer : transfer) {
+      size_t size = buffer.size;
+      views.push_back(JSObjectMakeTypedArrayWithBytesNoCopy(
+          m_context,
+          kJSTypedArrayTypeUint8Array,
+          buffer.bytes.release(),
+          size,
+          releaseTransferredBytes,
+          nullptr,
+          nullptr));
+    }
+    JSObjectRef viewArray = JSObjectMakeArray(m_context, views.size(), views.data(), nullptr);
+    messageObject.setProperty("buffers", Value(m_context, viewArray));
+  }
+#endif
   return messageObject;
 }
 
@@ -492,14 +1284,32 @@ JSValueRef JSCExecutor::nativePostMessage(
     size_t argumentCount,
     const JSValueRef arguments[],
     JSValueRef *exception) {
-  if (argumentCount != 1) {
+  if (argumentCount != 1 && argumentCount != 2) {
     *exception = makeJSCException(ctx, "postMessage got wrong number of arguments");
     return JSValueMakeUndefined(ctx);
   }
   JSValueRef msg = arguments[0];
-  JSCExecutor *webWorker = s_globalContextRefToJSCExecutor.at(JSContextGetGlobalContext(ctx));
 
-  webWorker->postMessageToOwner(msg);
+  TransferList transfer;
+  if (argumentCount == 2 && !JSValueIsUndefined(ctx, arguments[1]) &&
+      !JSValueIsNull(ctx, arguments[1])) {
+#ifdef JSC_HAS_TYPED_ARRAY_API
+    if (!collectTransferables(ctx, arguments[1], transfer, exception)) {
+      return JSValueMakeUndefined(ctx);
+    }
+#else
+    *exception = makeJSCException(ctx, "Transferables aren't supported by this JSC build");
+    return JSValueMakeUndefined(ctx);
+#endif
+  }
+
+  JSCExecutor *webWorker = executorForContext(ctx);
+  if (!webWorker) {
+    *exception = makeJSCException(ctx, "Global JS context didn't map to a valid executor");
+    return JSValueMakeUndefined(ctx);
+  }
+
+  webWorker->postMessageToOwner(msg, std::move(transfer));
 
   return JSValueMakeUndefined(ctx);
 }
@@ -526,10 +1336,8 @@ JSValueRef JSCExecutor::nativeRequire(
     return JSValueMakeUndefined(ctx);
   }
 
-  JSCExecutor *executor;
-  try {
-    executor = s_globalContextRefToJSCExecutor.at(JSContextGetGlobalContext(ctx));
-  } catch (std::out_of_range& e) {
+  JSCExecutor *executor = executorForContext(ctx);
+  if (!executor) {
     *exception = makeJSCException(ctx, "Global JS context didn't map to a valid executor");
     return JSValueMakeUndefined(ctx);
   }
@@ -558,24 +1366,209 @@ JSValueRef JSCExecutor::nativeFlushQueueImmediate(
     size_t argumentCount,
     const JSValueRef arguments[],
     JSValueRef *exception) {
-  if (argumentCount != 1) {
+  if (argumentCount != 1 && argumentCount != 2) {
     *exception = createErrorString(ctx, "Got wrong number of args");
     return JSValueMakeUndefined(ctx);
   }
 
-  JSCExecutor *executor;
-  try {
-    executor = s_globalContextRefToJSCExecutor.at(JSContextGetGlobalContext(ctx));
-  } catch (std::out_of_range& e) {
+  JSCExecutor *executor = executorForContext(ctx);
+  if (!executor) {
     *exception = createErrorString(ctx, "Global JS context didn't map to a valid executor");
     return JSValueMakeUndefined(ctx);
   }
 
-  std::string resStr = Value(ctx, arguments[0]).toJSONString();
+  // The optional second argument is the surface id a shared-VM surface queue
+  // tags its batches with; absent or zero means the host queue.
+  uint32_t surfaceId = 0;
+  if (argumentCount == 2) {
+    surfaceId = (uint32_t) Value(ctx, arguments[1]).asNumber();
+  }
+
+  // A binary-protocol-aware MessageQueue hands us the already-encoded batch
+  // as a string; pass its bytes through untouched. Anything else is the JSON
+  // fallback and gets stringified as before.
+  Value batchValue(ctx, arguments[0]);
+  std::string resStr;
+  if (batchValue.isString()) {
+    resStr = batchValue.toString().str();
+    if (!isBinaryBatch(resStr)) {
+      resStr = batchValue.toJSONString();
+    }
+  } else {
+    resStr = batchValue.toJSONString();
+  }
+
+  executor->flushQueueImmediate(std::move(resStr), surfaceId);
+
+  return JSValueMakeUndefined(ctx);
+}
+
+JSValueRef JSCExecutor::nativeFlushQueueBinary(
+    JSContextRef ctx,
+    JSObjectRef function,
+    JSObjectRef thisObject,
+    size_t argumentCount,
+    const JSValueRef arguments[],
+    JSValueRef *exception) {
+  if (argumentCount != 1 || !JSValueIsString(ctx, arguments[0])) {
+    *exception = createErrorString(ctx, "nativeFlushQueueBinary expects one string argument");
+    return JSValueMakeUndefined(ctx);
+  }
+
+  JSCExecutor *executor = executorForContext(ctx);
+  if (!executor) {
+    *exception = createErrorString(ctx, "Global JS context didn't map to a valid executor");
+    return JSValueMakeUndefined(ctx);
+  }
+
+  String batch = Value(ctx, arguments[0]).toString();
+  executor->flushQueueBinary(batch);
+
+  return JSValueMakeUndefined(ctx);
+}
+
+JSValueRef JSCExecutor::nativeBatchTimeOrigin(
+    JSContextRef ctx,
+    JSObjectRef function,
+    JSObjectRef thisObject,
+    size_t argumentCount,
+    const JSValueRef arguments[],
+    JSValueRef *exception) {
+  // Batched timing mode: returns the nativePerformanceNow stamp taken when
+  // the current native->JS dispatch started, without touching the clock.
+  // Telemetry that timestamps many events per batch can read this once (or
+  // cheaply per event) and derive offsets instead of paying a clock read per
+  // event. Comparable with nativePerformanceNow values.
+  JSCExecutor* executor = executorForContext(ctx);
+  if (!executor) {
+    return JSValueMakeNumber(ctx, 0);
+  }
+  return JSValueMakeNumber(ctx, executor->m_batchTimeOrigin);
+}
+
+JSValueRef JSCExecutor::nativeCallQueueHasPending(
+    JSContextRef ctx,
+    JSObjectRef function,
+    JSObjectRef thisObject,
+    size_t argumentCount,
+    const JSValueRef arguments[],
+    JSValueRef *exception) {
+  // Called by MessageQueue when its queue goes empty -> non-empty. A context
+  // still in the prewarm pool has no executor yet; nothing can be pending for
+  // it, so just ignore the signal.
+  JSCExecutor* executor = executorForContext(ctx);
+  if (executor) {
+    executor->m_hasPendingJSCalls = true;
+    executor->m_pendingFlagInUse = true;
+  }
+  return JSValueMakeUndefined(ctx);
+}
+
+#ifdef JSC_HAS_TYPED_ARRAY_API
+// Deallocator for no-copy blob views: the context is a heap-allocated
+// shared_ptr keeping the registry bytes alive for as long as JS holds the
+// typed array.
+static void releaseBlobViewBytes(void* bytes, void* deallocatorContext) {
+  delete static_cast<std::shared_ptr<const std::string>*>(deallocatorContext);
+}
+#endif
+
+JSValueRef JSCExecutor::nativeCreateBlob(
+    JSContextRef ctx,
+    JSObjectRef function,
+    JSObjectRef thisObject,
+    size_t argumentCount,
+    const JSValueRef arguments[],
+    JSValueRef *exception) {
+  if (argumentCount != 1) {
+    *exception = createErrorString(ctx, "Got wrong number of args");
+    return JSValueMakeUndefined(ctx);
+  }
+
+#ifdef JSC_HAS_TYPED_ARRAY_API
+  Value arrayValue(ctx, arguments[0]);
+  if (!arrayValue.isObject()) {
+    *exception = createErrorString(ctx, "nativeCreateBlob expects a typed array");
+    return JSValueMakeUndefined(ctx);
+  }
+  Object array = arrayValue.asObject();
+  if (!array.isTypedArray()) {
+    *exception = createErrorString(ctx, "nativeCreateBlob expects a typed array");
+    return JSValueMakeUndefined(ctx);
+  }
+
+  // One copy out of the VM's buffer (which may be collected or detached any
+  // time after we return) into registry storage; from here the payload
+  // travels by id only.
+  size_t size;
+  void* data = array.typedArrayBytes(&size);
+  uint64_t blobId = BlobRegistry::store(
+      std::string(static_cast<const char*>(data), size));
+  return JSValueMakeNumber(ctx, (double) blobId);
+#else
+  *exception = createErrorString(ctx, "Typed arrays aren't supported by this JSC build");
+  return JSValueMakeUndefined(ctx);
+#endif
+}
+
+JSValueRef JSCExecutor::nativeBlobTypedArray(
+    JSContextRef ctx,
+    JSObjectRef function,
+    JSObjectRef thisObject,
+    size_t argumentCount,
+    const JSValueRef arguments[],
+    JSValueRef *exception) {
+  if (argumentCount < 1 || argumentCount > 3) {
+    *exception = createErrorString(ctx, "Got wrong number of args");
+    return JSValueMakeUndefined(ctx);
+  }
+
+#ifdef JSC_HAS_TYPED_ARRAY_API
+  uint64_t blobId = (uint64_t) Value(ctx, arguments[0]).asNumber();
+  auto bytes = BlobRegistry::get(blobId);
+  if (!bytes) {
+    *exception = createErrorString(ctx, "Unknown or released blob id");
+    return JSValueMakeUndefined(ctx);
+  }
 
-  executor->flushQueueImmediate(resStr);
+  size_t offset = argumentCount >= 2
+      ? (size_t) Value(ctx, arguments[1]).asNumber() : 0;
+  size_t size = argumentCount >= 3
+      ? (size_t) Value(ctx, arguments[2]).asNumber() : bytes->size() - offset;
+  if (offset > bytes->size() || size > bytes->size() - offset) {
+    *exception = createErrorString(ctx, "Blob view is out of bounds");
+    return JSValueMakeUndefined(ctx);
+  }
 
+  // Zero-copy view over the registry bytes; the shared_ptr parked in the
+  // deallocator context keeps them alive past release() until JS lets go of
+  // the array.
+  auto* keepAlive = new std::shared_ptr<const std::string>(bytes);
+  return Object::makeTypedArrayNoCopy(
+      ctx,
+      const_cast<char*>(bytes->data()) + offset,
+      size,
+      &releaseBlobViewBytes,
+      keepAlive);
+#else
+  *exception = createErrorString(ctx, "Typed arrays aren't supported by this JSC build");
   return JSValueMakeUndefined(ctx);
+#endif
+}
+
+JSValueRef JSCExecutor::nativeReleaseBlob(
+    JSContextRef ctx,
+    JSObjectRef function,
+    JSObjectRef thisObject,
+    size_t argumentCount,
+    const JSValueRef arguments[],
+    JSValueRef *exception) {
+  if (argumentCount != 1) {
+    *exception = createErrorString(ctx, "Got wrong number of args");
+    return JSValueMakeUndefined(ctx);
+  }
+  uint64_t blobId = (uint64_t) Value(ctx, arguments[0]).asNumber();
+  return JSValueMakeBoolean(ctx, BlobRegistry::release(blobId));
 }
 
 JSValueRef JSCExecutor::nativeStartWorker(
@@ -595,10 +1588,8 @@ JSValueRef JSCExecutor::nativeStartWorker(
   JSValueRef worker = arguments[1];
   JSValueRef globalObj = arguments[2];
 
-  JSCExecutor *executor;
-  try {
-    executor = s_globalContextRefToJSCExecutor.at(JSContextGetGlobalContext(ctx));
-  } catch (std::out_of_range& e) {
+  JSCExecutor *executor = executorForContext(ctx);
+  if (!executor) {
     *exception = createErrorString(ctx, "Global JS context didn't map to a valid executor");
     return JSValueMakeUndefined(ctx);
   }
@@ -615,7 +1606,7 @@ JSValueRef JSCExecutor::nativePostMessageToWorker(
     size_t argumentCount,
     const JSValueRef arguments[],
     JSValueRef *exception) {
-  if (argumentCount != 2) {
+  if (argumentCount != 2 && argumentCount != 3) {
     *exception = createErrorString(ctx, "Got wrong number of args");
     return JSValueMakeUndefined(ctx);
   }
@@ -626,15 +1617,26 @@ JSValueRef JSCExecutor::nativePostMessageToWorker(
     return JSValueMakeUndefined(ctx);
   }
 
-  JSCExecutor *executor;
-  try {
-    executor = s_globalContextRefToJSCExecutor.at(JSContextGetGlobalContext(ctx));
-  } catch (std::out_of_range& e) {
+  TransferList transfer;
+  if (argumentCount == 3 && !JSValueIsUndefined(ctx, arguments[2]) &&
+      !JSValueIsNull(ctx, arguments[2])) {
+#ifdef JSC_HAS_TYPED_ARRAY_API
+    if (!collectTransferables(ctx, arguments[2], transfer, exception)) {
+      return JSValueMakeUndefined(ctx);
+    }
+#else
+    *exception = createErrorString(ctx, "Transferables aren't supported by this JSC build");
+    return JSValueMakeUndefined(ctx);
+#endif
+  }
+
+  JSCExecutor *executor = executorForContext(ctx);
+  if (!executor) {
     *exception = createErrorString(ctx, "Global JS context didn't map to a valid executor");
     return JSValueMakeUndefined(ctx);
   }
 
-  executor->postMessageToOwnedWebWorker((int) workerDouble, arguments[1], exception);
+  executor->postMessageToOwnedWebWorker((int) workerDouble, arguments[1], std::move(transfer), exception);
 
   return JSValueMakeUndefined(ctx);
 }
@@ -657,10 +1659,8 @@ JSValueRef JSCExecutor::nativeTerminateWorker(
     return JSValueMakeUndefined(ctx);
   }
 
-  JSCExecutor *executor;
-  try {
-    executor = s_globalContextRefToJSCExecutor.at(JSContextGetGlobalContext(ctx));
-  } catch (std::out_of_range& e) {
+  JSCExecutor *executor = executorForContext(ctx);
+  if (!executor) {
     *exception = createErrorString(ctx, "Global JS context didn't map to a valid executor");
     return JSValueMakeUndefined(ctx);
   }
@@ -676,14 +1676,10 @@ static JSValueRef nativePerformanceNow(
     JSObjectRef thisObject,
     size_t argumentCount,
     const JSValueRef arguments[], JSValueRef *exception) {
-  // This is equivalent to android.os.SystemClock.elapsedRealtime() in native
-  struct timespec now;
-  clock_gettime(CLOCK_MONOTONIC_RAW, &now);
-  int64_t nano = now.tv_sec * NANOSECONDS_IN_SECOND + now.tv_nsec;
-  return JSValueMakeNumber(ctx, (nano / (double)NANOSECONDS_IN_MILLISECOND));
+  return JSValueMakeNumber(ctx, performanceNowMillis());
 }
 
-static JSValueRef nativeInjectHMRUpdate(
+JSValueRef JSCExecutor::nativeInjectHMRUpdate(
     JSContextRef ctx,
     JSObjectRef function,
     JSObjectRef thisObject,
@@ -691,8 +1687,142 @@ static JSValueRef nativeInjectHMRUpdate(
     const JSValueRef arguments[], JSValueRef *exception) {
   String execJSString = Value(ctx, arguments[0]).toString();
   String jsURL = Value(ctx, arguments[1]).toString();
+
+  // When the context maps to an executor, filter the update down to modules
+  // whose content actually changed; repeated edits to one file then cost one
+  // module evaluation instead of the whole update. Contexts still in the
+  // prewarm pool take the unfiltered path.
+  JSCExecutor* executor = executorForContext(ctx);
+  if (executor) {
+    std::string changed =
+        executor->m_hmrCache.filterChangedModules(execJSString.str());
+    if (changed.empty()) {
+      return JSValueMakeUndefined(ctx);
+    }
+    String changedScript(changed.c_str());
+    evaluateScript(ctx, changedScript, jsURL);
+    return JSValueMakeUndefined(ctx);
+  }
+
   evaluateScript(ctx, execJSString, jsURL);
   return JSValueMakeUndefined(ctx);
 }
 
+JSValueRef JSCExecutor::nativeGetLazyGlobal(
+    JSContextRef ctx,
+    JSObjectRef function,
+    JSObjectRef thisObject,
+    size_t argumentCount,
+    const JSValueRef arguments[],
+    JSValueRef *exception) {
+  if (argumentCount != 1 || !JSValueIsString(ctx, arguments[0])) {
+    *exception = createErrorString(ctx, "nativeGetLazyGlobal expects (name)");
+    return JSValueMakeUndefined(ctx);
+  }
+
+  JSCExecutor* executor = executorForContext(ctx);
+  if (!executor) {
+    *exception = createErrorString(ctx, "Global JS context didn't map to a valid executor");
+    return JSValueMakeUndefined(ctx);
+  }
+
+  std::string name = Value(ctx, arguments[0]).toString().str();
+  auto payload = executor->m_lazyGlobals.find(name);
+  if (payload == executor->m_lazyGlobals.end()) {
+    return JSValueMakeUndefined(ctx);
+  }
+
+  String json(payload->second->c_str());
+  JSValueRef value = JSValueMakeFromJSONString(ctx, json);
+  executor->m_lazyGlobals.erase(payload);
+  if (!value) {
+    *exception = createErrorString(ctx, "Lazy global payload wasn't valid JSON");
+    return JSValueMakeUndefined(ctx);
+  }
+  return value;
+}
+
+JSValueRef JSCExecutor::nativeCallSyncHook(
+    JSContextRef ctx,
+    JSObjectRef function,
+    JSObjectRef thisObject,
+    size_t argumentCount,
+    const JSValueRef arguments[],
+    JSValueRef *exception) {
+  if (argumentCount < 1 || !JSValueIsString(ctx, arguments[0])) {
+    *exception = createErrorString(ctx, "nativeCallSyncHook expects (name, args?)");
+    return JSValueMakeUndefined(ctx);
+  }
+
+  std::string name = Value(ctx, arguments[0]).toString().str();
+  folly::dynamic args = folly::dynamic::array;
+  if (argumentCount >= 2 && !JSValueIsUndefined(ctx, arguments[1]) &&
+      !JSValueIsNull(ctx, arguments[1])) {
+    args = folly::parseJson(Value(ctx, arguments[1]).toJSONString());
+  }
+
+  JSCExecutor* executor = executorForContext(ctx);
+  if (!executor) {
+    *exception = createErrorString(ctx, "Global JS context didn't map to a valid executor");
+    return JSValueMakeUndefined(ctx);
+  }
+
+  // Runs the handler inline on this JS thread: the answer comes back in the
+  // same stack frame, with no queue hop or callback bookkeeping in either
+  // direction.
+  folly::dynamic result = nullptr;
+  if (!executor->m_bridge->callSyncNativeHook(name, args, &result)) {
+    *exception = createErrorString(ctx, "No sync native hook registered under that name");
+    return JSValueMakeUndefined(ctx);
+  }
+
+  if (result.isNull()) {
+    return JSValueMakeNull(ctx);
+  }
+  return Value::fromJSON(ctx, String(folly::toJson(result).c_str()));
+}
+
+JSValueRef JSCExecutor::nativeStartSamplingProfiler(
+    JSContextRef ctx,
+    JSObjectRef function,
+    JSObjectRef thisObject,
+    size_t argumentCount,
+    const JSValueRef arguments[],
+    JSValueRef *exception) {
+  if (argumentCount != 2 || !JSValueIsString(ctx, arguments[1])) {
+    *exception = createErrorString(
+        ctx, "nativeStartSamplingProfiler expects (intervalMs, outputPath)");
+    return JSValueMakeUndefined(ctx);
+  }
+
+  double intervalMs = JSValueToNumber(ctx, arguments[0], exception);
+  std::string outputPath = Value(ctx, arguments[1]).toString().str();
+
+  JSCExecutor* executor = executorForContext(ctx);
+  if (!executor) {
+    *exception = createErrorString(ctx, "Global JS context didn't map to a valid executor");
+    return JSValueMakeUndefined(ctx);
+  }
+
+  executor->startSamplingProfiler((int) intervalMs, outputPath);
+  return JSValueMakeUndefined(ctx);
+}
+
+JSValueRef JSCExecutor::nativeStopSamplingProfiler(
+    JSContextRef ctx,
+    JSObjectRef function,
+    JSObjectRef thisObject,
+    size_t argumentCount,
+    const JSValueRef arguments[],
+    JSValueRef *exception) {
+  JSCExecutor* executor = executorForContext(ctx);
+  if (!executor) {
+    *exception = createErrorString(ctx, "Global JS context didn't map to a valid executor");
+    return JSValueMakeUndefined(ctx);
+  }
+
+  executor->stopSamplingProfiler();
+  return JSValueMakeUndefined(ctx);
+}
+
 } }
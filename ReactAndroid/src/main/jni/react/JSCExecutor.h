@@ -2,15 +2,23 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <memory>
 #include <unordered_map>
+#include <vector>
 #include <folly/json.h>
 #include <JavaScriptCore/JSContextRef.h>
 
+#include "CallArgsBuilder.h"
 #include "ExecutorToken.h"
 #include "Executor.h"
+#include "JSBigString.h"
 #include "JSCHelpers.h"
+#include "HMRUpdateCache.h"
+#include "JSCPerfSampler.h"
+#include "JSCSamplingProfiler.h"
+#include "UnbundlePrefetcher.h"
 #include "Value.h"
 
 namespace facebook {
@@ -18,17 +26,39 @@ namespace react {
 
 class MessageQueueThread;
 
+/**
+ * Fills the warm context pool from a background thread; see
+ * JSCExecutor::prewarmContextPool.
+ */
+void prewarmJSCContextPool(size_t poolSize);
+
 class JSCExecutorFactory : public JSExecutorFactory {
 public:
   JSCExecutorFactory(const std::string& cacheDir, const folly::dynamic& jscConfig) :
   cacheDir_(cacheDir),
-  m_jscConfig(jscConfig) {}
+  m_jscConfig(jscConfig) {
+    if (m_jscConfig.getDefault("PrewarmContextPool", true).getBool()) {
+      prewarmJSCContextPool(1);
+    }
+  }
   virtual std::unique_ptr<JSExecutor> createJSExecutor(Bridge *bridge) override;
 private:
   std::string cacheDir_;
   folly::dynamic m_jscConfig;
 };
 
+/**
+ * A byte payload detached from its source VM, en route to another executor.
+ * On JSC builds with the typed array API the receiving side exposes these
+ * zero-copy as Uint8Arrays, so only the small message envelope goes through
+ * JSON; see the postMessage transferable plumbing in JSCExecutor.cpp.
+ */
+struct TransferableBuffer {
+  std::unique_ptr<uint8_t[]> bytes;
+  size_t size;
+};
+using TransferList = std::vector<TransferableBuffer>;
+
 class JSCExecutor;
 class WorkerRegistration : public noncopyable {
 public:
@@ -53,6 +83,14 @@ public:
   virtual void loadApplicationScript(
     const std::string& script,
     const std::string& sourceURL) override;
+
+  /**
+   * Evaluates the bundle straight out of an immutable (possibly mmap-backed)
+   * buffer, without copying it into a std::string first.
+   */
+  virtual void loadApplicationScript(
+    std::unique_ptr<const JSBigString> script,
+    const std::string& sourceURL) override;
   virtual void loadApplicationUnbundle(
     std::unique_ptr<JSModulesUnbundle> unbundle,
     const std::string& startupCode,
@@ -61,24 +99,84 @@ public:
     const std::string& moduleId,
     const std::string& methodId,
     const folly::dynamic& arguments) override;
+  virtual void callFunction(
+    uint32_t callHandle,
+    const std::string& moduleId,
+    const std::string& methodId,
+    const folly::dynamic& arguments) override;
+  virtual void callFunctionBatch(std::vector<JSFunctionCall>&& calls) override;
   virtual void invokeCallback(
     const double callbackId,
     const folly::dynamic& arguments) override;
+  virtual void callFunctionOnSurface(
+    uint32_t surfaceId,
+    const std::string& moduleId,
+    const std::string& methodId,
+    const folly::dynamic& arguments) override;
+  virtual void invokeCallbackOnSurface(
+    uint32_t surfaceId,
+    const double callbackId,
+    const folly::dynamic& arguments) override;
   virtual void setGlobalVariable(
     const std::string& propName,
     const std::string& jsonValue) override;
+
+  /**
+   * Adopting variant: parks the payload and installs a self-replacing getter
+   * on the global object, so the JSON is parsed on first JS read of the
+   * global (or never, for globals the bundle doesn't touch) instead of at
+   * injection time.
+   */
+  virtual void setGlobalVariable(
+    const std::string& propName,
+    std::unique_ptr<const std::string> jsonValue) override;
   virtual void* getJavaScriptContext() override;
   virtual bool supportsProfiling() override;
+  virtual folly::dynamic getStartupTimings() override;
   virtual void startProfiler(const std::string &titleString) override;
   virtual void stopProfiler(const std::string &titleString, const std::string &filename) override;
   virtual void handleMemoryPressureModerate() override;
   virtual void handleMemoryPressureCritical() override;
+  virtual void scheduleIdleGC(int slices) override;
   virtual void destroy() override;
 
   void installNativeHook(const char *name, JSObjectCallAsFunctionCallback callback);
 
+  /**
+   * Starts snapshotting heap/GC stats into a ring buffer every intervalMs
+   * (samples are taken on the VM thread; see JSCPerfSampler). Restarting
+   * with a new interval replaces the running sampler. Safe to call from any
+   * thread.
+   */
+  void startPerfStatsSampling(int intervalMs);
+  void stopPerfStatsSampling();
+
+  /**
+   * Starts the low-overhead sampling profiler: SIGPROF-driven native stacks
+   * of the JS thread interleaved with periodic JS backtraces, streamed to
+   * outputPath in a compact binary format (see JSCSamplingProfiler.h).
+   * Cheap enough for production sessions, unlike the legacy profiler.
+   */
+  void startSamplingProfiler(int intervalMs, const std::string& outputPath);
+  void stopSamplingProfiler();
+
+  /**
+   * Drains and returns the samples gathered so far. Safe to call from any
+   * thread, but from only one at a time.
+   */
+  folly::dynamic getPerfStatsSamples();
+
+  /**
+   * Pre-creates poolSize contexts with all executor-independent globals
+   * installed, on a background thread, so a later executor construction can
+   * adopt one instantly instead of paying for context setup. Contexts are
+   * created before any per-process tuning config is applied, so tuned builds
+   * should prewarm after configuration.
+   */
+  static void prewarmContextPool(size_t poolSize);
+
 private:
-  JSGlobalContextRef m_context;
+  JSGlobalContextRef m_context = nullptr;
   Bridge *m_bridge;
   int m_workerId = 0; // if this is a worker executor, this is non-zero
   JSCExecutor *m_owner = nullptr; // if this is a worker executor, this is non-null
@@ -87,35 +185,116 @@ private:
   std::string m_deviceCacheDir;
   std::shared_ptr<MessageQueueThread> m_messageQueueThread;
   std::unique_ptr<JSModulesUnbundle> m_unbundle;
+  // Warms likely-next unbundle modules off-thread after startup; see
+  // UnbundlePrefetcher.h.
+  UnbundlePrefetcher m_unbundlePrefetcher;
   folly::dynamic m_jscConfig;
   std::unique_ptr<Object> m_batchedBridge;
   std::unique_ptr<Object> m_flushedQueueObj;
+  std::unique_ptr<Object> m_callFunctionObj;
+  std::unique_ptr<Object> m_invokeCallbackObj;
+  // Surface-addressed bridge entry points for shared-VM mode; null when the
+  // loaded runtime doesn't export them (single-surface bundles).
+  std::unique_ptr<Object> m_callFunctionSurfaceObj;
+  std::unique_ptr<Object> m_invokeCallbackSurfaceObj;
+  // Reusable channel buffer for nativeFlushQueueBinary; retains its capacity
+  // across batches so steady-state flushes don't allocate.
+  std::string m_flushChannelBuffer;
+  // Set by nativeCallQueueHasPending when JS first enqueues into an empty
+  // queue, cleared whenever the queue is drained. Once JS has called the hook
+  // (m_pendingFlagInUse), flush() skips the flushedQueue evaluation and its
+  // toJSONString of a null result whenever the flag is clear; bundles that
+  // never call the hook keep the always-evaluate behavior. JS-thread only.
+  bool m_hasPendingJSCalls = false;
+  bool m_pendingFlagInUse = false;
+  // nativePerformanceNow timestamp taken once at the start of each native->JS
+  // dispatch; nativeBatchTimeOrigin hands it to JS without a clock read, so
+  // per-event timestamps within a batch can be derived from one stamp.
+  // JS-thread only.
+  double m_batchTimeOrigin = 0;
+  // Per-call argument list for the cached-bridge-method paths; cleared and
+  // refilled on the JS thread so steady-state calls reuse one allocation.
+  CallArgsBuilder m_callArgs;
+  // Bundle-startup phase markers (BridgeMetrics::nowMicros timestamps),
+  // written on the JS thread during loadApplicationScript. Atomic so
+  // getStartupTimings can snapshot them from any thread; zero means the
+  // phase hasn't happened.
+  struct {
+    std::atomic<uint64_t> loadStart = ATOMIC_VAR_INIT(0);
+    std::atomic<uint64_t> sourceReady = ATOMIC_VAR_INIT(0);
+    std::atomic<uint64_t> evaluateStart = ATOMIC_VAR_INIT(0);
+    std::atomic<uint64_t> evaluateEnd = ATOMIC_VAR_INIT(0);
+    std::atomic<uint64_t> firstFlushEnd = ATOMIC_VAR_INIT(0);
+  } m_startupTimings;
+  // JSC string refs for interned call names, built once per handle so the
+  // handle-based callFunction allocates no strings per call.
+  std::unordered_map<uint32_t, std::pair<String, String>> m_internedCallNames;
+  // JSON payloads injected through the adopting setGlobalVariable overload,
+  // awaiting their first JS read; nativeGetLazyGlobal parses and drops them.
+  std::unordered_map<std::string, std::unique_ptr<const std::string>> m_lazyGlobals;
+  // Dev-only: filters unchanged modules out of injected HMR updates.
+  HMRUpdateCache m_hmrCache;
+  std::shared_ptr<JSCPerfSampler> m_perfSampler;
+  std::unique_ptr<JSCSamplingProfiler> m_samplingProfiler;
+  // Shared with the sampling timer thread so stop/destroy can end it.
+  std::shared_ptr<std::atomic<bool>> m_perfSamplingActive;
 
   /**
-   * WebWorker constructor. Must be invoked from thread this Executor will run on.
+   * WebWorker constructor. Must be invoked from thread this Executor will run
+   * on. reusedContext is a context handed back by a pooled worker's
+   * resetForReuse (or null for a fresh VM).
    */
   explicit JSCExecutor(
       Bridge *bridge,
       int workerId,
       JSCExecutor *owner,
+      JSGlobalContextRef reusedContext,
       const std::string& script,
       const std::unordered_map<std::string, std::string>& globalObjAsJSON,
       const folly::dynamic& jscConfig);
 
+  static JSGlobalContextRef createPreparedContext();
+  static JSGlobalContextRef takeWarmContext();
+
   void initOnJSVMThread();
   void terminateOnJSVMThread();
+
+  /**
+   * Worker-thread counterpart of terminateOnJSVMThread for pooled reuse:
+   * tears down everything executor-specific but keeps the VM alive, stripping
+   * the globals the worker script added so the next worker adopts what looks
+   * like a freshly prepared context. Leaves this executor destroyed and
+   * returns the surviving context, which the caller now owns.
+   */
+  JSGlobalContextRef resetForReuse();
+  void prepareSourceCache(const char* script, size_t size);
+  // Reuses a hash precomputed off-thread (see JSBigString::precomputedHash)
+  // instead of rehashing the bundle on the JS thread.
+  void prepareSourceCache(const JSBigString& script);
+  void prepareSourceCacheForHash(uint64_t bundleHash);
   void flush();
-  void flushQueueImmediate(std::string queueJSON);
+  // surfaceId 0 means the host queue; non-zero batches route to that
+  // surface's bridge (see Bridge::callNativeModulesFromSurface).
+  void flushQueueImmediate(std::string queueJSON, uint32_t surfaceId = 0);
+  void flushQueueBinary(JSStringRef batch);
   void loadModule(uint32_t moduleId);
+  void evaluateStartupSegments(
+      std::shared_ptr<std::vector<std::string>> segments,
+      size_t index,
+      std::shared_ptr<std::string> sourceURL);
   bool ensureBatchedBridgeObject();
+  std::string callCachedBridgeMethod(
+      Object* method,
+      const std::string& methodName,
+      const CallArgsBuilder& arguments);
 
   int addWebWorker(const std::string& script, JSValueRef workerRef, JSValueRef globalObjRef);
-  void postMessageToOwnedWebWorker(int worker, JSValueRef message, JSValueRef *exn);
-  void postMessageToOwner(JSValueRef result);
-  void receiveMessageFromOwnedWebWorker(int workerId, const std::string& message);
-  void receiveMessageFromOwner(const std::string &msgString);
+  void postMessageToOwnedWebWorker(int worker, JSValueRef message, TransferList&& transfer, JSValueRef *exn);
+  void postMessageToOwner(JSValueRef result, TransferList&& transfer);
+  void receiveMessageFromOwnedWebWorker(int workerId, const std::string& message, TransferList&& transfer);
+  void receiveMessageFromOwner(const std::string &msgString, TransferList&& transfer);
   void terminateOwnedWebWorker(int worker);
-  Object createMessageObject(const std::string& msgData);
+  Object createMessageObject(const std::string& msgData, TransferList&& transfer);
   bool usePreparsingAndStringRef();
 
   static JSValueRef nativeStartWorker(
@@ -160,6 +339,83 @@ private:
       size_t argumentCount,
       const JSValueRef arguments[],
       JSValueRef *exception);
+  static JSValueRef nativeFlushQueueBinary(
+      JSContextRef ctx,
+      JSObjectRef function,
+      JSObjectRef thisObject,
+      size_t argumentCount,
+      const JSValueRef arguments[],
+      JSValueRef *exception);
+  static JSValueRef nativeCallQueueHasPending(
+      JSContextRef ctx,
+      JSObjectRef function,
+      JSObjectRef thisObject,
+      size_t argumentCount,
+      const JSValueRef arguments[],
+      JSValueRef *exception);
+  static JSValueRef nativeBatchTimeOrigin(
+      JSContextRef ctx,
+      JSObjectRef function,
+      JSObjectRef thisObject,
+      size_t argumentCount,
+      const JSValueRef arguments[],
+      JSValueRef *exception);
+  static JSValueRef nativeCreateBlob(
+      JSContextRef ctx,
+      JSObjectRef function,
+      JSObjectRef thisObject,
+      size_t argumentCount,
+      const JSValueRef arguments[],
+      JSValueRef *exception);
+  static JSValueRef nativeBlobTypedArray(
+      JSContextRef ctx,
+      JSObjectRef function,
+      JSObjectRef thisObject,
+      size_t argumentCount,
+      const JSValueRef arguments[],
+      JSValueRef *exception);
+  static JSValueRef nativeReleaseBlob(
+      JSContextRef ctx,
+      JSObjectRef function,
+      JSObjectRef thisObject,
+      size_t argumentCount,
+      const JSValueRef arguments[],
+      JSValueRef *exception);
+  static JSValueRef nativeGetLazyGlobal(
+      JSContextRef ctx,
+      JSObjectRef function,
+      JSObjectRef thisObject,
+      size_t argumentCount,
+      const JSValueRef arguments[],
+      JSValueRef *exception);
+  static JSValueRef nativeInjectHMRUpdate(
+      JSContextRef ctx,
+      JSObjectRef function,
+      JSObjectRef thisObject,
+      size_t argumentCount,
+      const JSValueRef arguments[],
+      JSValueRef *exception);
+  static JSValueRef nativeCallSyncHook(
+      JSContextRef ctx,
+      JSObjectRef function,
+      JSObjectRef thisObject,
+      size_t argumentCount,
+      const JSValueRef arguments[],
+      JSValueRef *exception);
+  static JSValueRef nativeStartSamplingProfiler(
+      JSContextRef ctx,
+      JSObjectRef function,
+      JSObjectRef thisObject,
+      size_t argumentCount,
+      const JSValueRef arguments[],
+      JSValueRef *exception);
+  static JSValueRef nativeStopSamplingProfiler(
+      JSContextRef ctx,
+      JSObjectRef function,
+      JSObjectRef thisObject,
+      size_t argumentCount,
+      const JSValueRef arguments[],
+      JSValueRef *exception);
 };
 
 } }
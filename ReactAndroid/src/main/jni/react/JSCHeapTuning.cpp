@@ -0,0 +1,52 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "JSCHeapTuning.h"
+
+namespace facebook {
+namespace react {
+
+namespace {
+
+// Starting points for apps whose steady-state heap the stock JSC defaults
+// handle badly: a big initial heap so startup doesn't grow-and-collect its
+// way up, a nursery sized for allocation-heavy render passes, and a lazier
+// full-GC trigger.
+folly::dynamic largeAppPreset() {
+  return folly::dynamic::object
+      ("InitialHeapSizeMB", 64)
+      ("NurserySizeMB", 16)
+      ("GCTriggerRatio", 2.0);
+}
+
+} // namespace
+
+folly::dynamic expandHeapTuningConfig(const folly::dynamic& jscConfig) {
+  if (!jscConfig.isObject()) {
+    return jscConfig;
+  }
+
+  const auto* presetName = jscConfig.get_ptr("HeapTuningPreset");
+  const auto* explicitTuning = jscConfig.get_ptr("HeapTuning");
+  if (!presetName && !explicitTuning) {
+    return jscConfig;
+  }
+
+  folly::dynamic tuning = folly::dynamic::object;
+  if (presetName && presetName->isString() &&
+      presetName->asString() == "large-app") {
+    tuning = largeAppPreset();
+  }
+
+  // Explicit dials override whatever the preset chose.
+  if (explicitTuning && explicitTuning->isObject()) {
+    for (const auto& entry : explicitTuning->items()) {
+      tuning[entry.first] = entry.second;
+    }
+  }
+
+  folly::dynamic expanded = jscConfig;
+  expanded["HeapTuning"] = std::move(tuning);
+  return expanded;
+}
+
+} }
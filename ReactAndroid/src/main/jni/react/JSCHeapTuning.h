@@ -0,0 +1,28 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include <folly/json.h>
+
+namespace facebook {
+namespace react {
+
+/**
+ * Expands the heap tuning shorthand in a jscConfig into the explicit dials
+ * the JSC tuning layer consumes. Apps select a profile through jscConfig:
+ *
+ *   "HeapTuningPreset": "large-app"   - preset bundle of dials
+ *   "HeapTuning": {                   - explicit dials, win over the preset
+ *     "InitialHeapSizeMB": 64,
+ *     "NurserySizeMB": 16,
+ *     "GCTriggerRatio": 2.0
+ *   }
+ *
+ * The returned config carries a fully populated "HeapTuning" object merged
+ * from the preset and any explicit overrides; configs that mention neither
+ * key come back unchanged. Unknown preset names are ignored so stale
+ * server-driven configs can't break startup.
+ */
+folly::dynamic expandHeapTuningConfig(const folly::dynamic& jscConfig);
+
+} }
@@ -35,23 +35,77 @@ JSValueRef makeJSCException(
   return JSValueToObject(ctx, exceptionString, NULL);
 }
 
+JSException::JSException(
+    JSContextRef ctx,
+    JSValueRef exceptionValue,
+    JSStringRef sourceURL) :
+    JsException(""),
+    m_context(JSContextGetGlobalContext(ctx)),
+    m_value(exceptionValue),
+    m_sourceURL(sourceURL) {
+  JSGlobalContextRetain(m_context);
+  JSValueProtect(m_context, m_value);
+  if (m_sourceURL != nullptr) {
+    JSStringRetain(m_sourceURL);
+  }
+}
+
+JSException::JSException(const JSException& other) :
+    JsException(""),
+    m_context(other.m_context),
+    m_value(other.m_value),
+    m_sourceURL(other.m_sourceURL),
+    m_message(other.m_message) {
+  JSGlobalContextRetain(m_context);
+  JSValueProtect(m_context, m_value);
+  if (m_sourceURL != nullptr) {
+    JSStringRetain(m_sourceURL);
+  }
+}
+
+JSException::~JSException() {
+  JSValueUnprotect(m_context, m_value);
+  if (m_sourceURL != nullptr) {
+    JSStringRelease(m_sourceURL);
+  }
+  JSGlobalContextRelease(m_context);
+}
+
+const char* JSException::what() const noexcept {
+  if (m_message.empty()) {
+    try {
+      buildMessage();
+    } catch (...) {
+      m_message = "Exception thrown while stringifying a JS exception";
+    }
+  }
+  return m_message.c_str();
+}
+
+void JSException::buildMessage() const {
+  Value exception = Value(m_context, m_value);
+  std::string exceptionText = exception.toString().str();
+  LOG(ERROR) << "Got JS Exception: " << exceptionText;
+  auto line = exception.asObject().getProperty("line");
+
+  std::ostringstream locationInfo;
+  std::string file = m_sourceURL != nullptr ? String::ref(m_sourceURL).str() : "";
+  locationInfo << exceptionText;
+  locationInfo << " (" << (file.length() ? file : "<unknown file>");
+  if (line != nullptr && line.isNumber()) {
+    locationInfo << ":" << line.asInteger();
+  }
+  locationInfo << ")";
+  m_message = locationInfo.str();
+}
+
 JSValueRef evaluateScript(JSContextRef context, JSStringRef script, JSStringRef source) {
   JSValueRef exn, result;
   result = JSEvaluateScript(context, script, NULL, source, 0, &exn);
   if (result == nullptr) {
-    Value exception = Value(context, exn);
-    std::string exceptionText = exception.toString().str();
-    LOG(ERROR) << "Got JS Exception: " << exceptionText;
-    auto line = exception.asObject().getProperty("line");
-
-    std::ostringstream locationInfo;
-    std::string file = source != nullptr ? String::ref(source).str() : "";
-    locationInfo << "(" << (file.length() ? file : "<unknown file>");
-    if (line != nullptr && line.isNumber()) {
-      locationInfo << ":" << line.asInteger();
-    }
-    locationInfo << ")";
-    throwJSExecutionException("%s %s", exceptionText.c_str(), locationInfo.str().c_str());
+    // Capture the JS value and defer stringification: the message (and the
+    // error log) is only built if somebody asks the exception for what().
+    throw JSException(context, exn, source);
   }
   return result;
 }
@@ -6,9 +6,10 @@
 #include <JavaScriptCore/JSObjectRef.h>
 #include <JavaScriptCore/JSValueRef.h>
 
-#include <alloca.h>
+#include <cstdio>
 #include <stdexcept>
-#include <algorithm>
+#include <string>
+#include <vector>
 
 namespace facebook {
 namespace react {
@@ -17,17 +18,45 @@ struct JsException : std::runtime_error {
   using std::runtime_error::runtime_error;
 };
 
+/**
+ * Thrown when a script evaluated through evaluateScript raises a JS
+ * exception. The exception value is captured (and protected from GC) as-is;
+ * the human-readable description is only built when what() is first called,
+ * so catch sites that swallow the exception never pay for stringifying it.
+ */
+class JSException : public JsException {
+ public:
+  JSException(JSContextRef ctx, JSValueRef exceptionValue, JSStringRef sourceURL);
+  JSException(const JSException& other);
+  JSException& operator=(const JSException&) = delete;
+  ~JSException() override;
+
+  const char* what() const noexcept override;
+
+ private:
+  void buildMessage() const;
+
+  JSGlobalContextRef m_context;
+  JSValueRef m_value;
+  JSStringRef m_sourceURL;
+  mutable std::string m_message;
+};
+
 inline void throwJSExecutionException(const char* msg) {
   throw JsException(msg);
 }
 
 template <typename... Args>
 inline void throwJSExecutionException(const char* fmt, Args... args) {
-  int msgSize = snprintf(nullptr, 0, fmt, args...);
-  msgSize = std::min(512, msgSize + 1);
-  char *msg = (char*) alloca(msgSize);
-  snprintf(msg, msgSize, fmt, args...);
-  throw JsException(msg);
+  // One formatting buffer per thread, grown to the largest message seen and
+  // then reused. The old alloca() path silently truncated at 512 bytes.
+  static thread_local std::vector<char> buffer(512);
+  int msgSize = snprintf(buffer.data(), buffer.size(), fmt, args...);
+  if (msgSize >= static_cast<int>(buffer.size())) {
+    buffer.resize(msgSize + 1);
+    snprintf(buffer.data(), buffer.size(), fmt, args...);
+  }
+  throw JsException(buffer.data());
 }
 
 void installGlobalFunction(
@@ -0,0 +1,68 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "JSCPerfSampler.h"
+
+#include <chrono>
+
+#ifdef JSC_HAS_PERF_STATS_API
+#include <JavaScriptCore/JSPerfStats.h>
+#endif
+
+namespace facebook {
+namespace react {
+
+void JSCPerfSampler::sample(JSGlobalContextRef ctx) {
+  uint64_t head = m_head.load(std::memory_order_relaxed);
+  uint64_t tail = m_tail.load(std::memory_order_acquire);
+  if (head - tail >= kCapacity) {
+    // Consumer has fallen behind; dropping the newest sample is cheaper than
+    // stalling the VM thread and the gap is visible in the timestamps.
+    return;
+  }
+
+  Sample& slot = m_samples[head & (kCapacity - 1)];
+  slot = Sample();
+  slot.timeMicros = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+
+#ifdef JSC_HAS_PERF_STATS_API
+  JSHeapStats heapStats = {0};
+  JSGetHeapStats(ctx, &heapStats);
+  slot.heapSize = heapStats.size;
+  slot.heapExtraSize = heapStats.extraSize;
+  slot.heapCapacity = heapStats.capacity;
+  slot.objectCount = heapStats.objectCount;
+
+  JSGCStats gcStats = {0};
+  JSGetGCStats(ctx, &gcStats);
+  slot.lastFullGCLength = gcStats.lastFullGCLength;
+  slot.lastEdenGCLength = gcStats.lastEdenGCLength;
+#else
+  (void)ctx;
+#endif
+
+  m_head.store(head + 1, std::memory_order_release);
+}
+
+folly::dynamic JSCPerfSampler::drain() {
+  folly::dynamic result = folly::dynamic::array();
+
+  uint64_t tail = m_tail.load(std::memory_order_relaxed);
+  uint64_t head = m_head.load(std::memory_order_acquire);
+  for (; tail != head; tail++) {
+    const Sample& s = m_samples[tail & (kCapacity - 1)];
+    result.push_back(folly::dynamic::object
+        ("timeMicros", s.timeMicros)
+        ("heapSize", s.heapSize)
+        ("heapExtraSize", s.heapExtraSize)
+        ("heapCapacity", s.heapCapacity)
+        ("objectCount", s.objectCount)
+        ("lastFullGCLength", s.lastFullGCLength)
+        ("lastEdenGCLength", s.lastEdenGCLength));
+  }
+  m_tail.store(tail, std::memory_order_release);
+
+  return result;
+}
+
+} }
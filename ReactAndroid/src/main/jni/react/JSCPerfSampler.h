@@ -0,0 +1,65 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include <folly/dynamic.h>
+#include <JavaScriptCore/JSContextRef.h>
+
+#include "noncopyable.h"
+
+namespace facebook {
+namespace react {
+
+/**
+ * Continuous sampler for JSC heap and GC statistics.
+ *
+ * The one-shot hooks in JSCPerfStats/JSCMemory only answer questions the JS
+ * side thinks to ask; correlating GC pauses with dropped frames needs a
+ * stream. sample() runs on the VM thread (JSC's stats APIs are not
+ * thread-safe) and appends a snapshot to a fixed-size lock-free ring buffer;
+ * drain() pops accumulated samples from any thread. Single producer, single
+ * consumer; when the consumer falls behind, new samples are dropped rather
+ * than blocking the VM thread.
+ *
+ * Heap and GC fields are populated when built with JSC_HAS_PERF_STATS_API;
+ * otherwise samples carry timestamps only.
+ */
+class JSCPerfSampler : public noncopyable {
+public:
+  /**
+   * Snapshots heap size, capacity, object count and last GC pause lengths
+   * for the given context. Must be called on the context's VM thread.
+   */
+  void sample(JSGlobalContextRef ctx);
+
+  /**
+   * Removes and returns all buffered samples as an array of
+   * { timeMicros, heapSize, heapExtraSize, heapCapacity, objectCount,
+   *   lastFullGCLength, lastEdenGCLength } objects. Must not be called
+   * concurrently with itself.
+   */
+  folly::dynamic drain();
+
+private:
+  struct Sample {
+    uint64_t timeMicros;
+    double heapSize;
+    double heapExtraSize;
+    double heapCapacity;
+    double objectCount;
+    double lastFullGCLength;
+    double lastEdenGCLength;
+  };
+
+  // Power of two so index wrapping is a mask.
+  static const size_t kCapacity = 512;
+
+  Sample m_samples[kCapacity];
+  std::atomic<uint64_t> m_head = ATOMIC_VAR_INIT(0); // next write (producer)
+  std::atomic<uint64_t> m_tail = ATOMIC_VAR_INIT(0); // next read (consumer)
+};
+
+} }
@@ -0,0 +1,231 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "JSCSamplingProfiler.h"
+
+#include <string.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#include <unwind.h>
+
+#include <chrono>
+#include <cstdio>
+
+#include <glog/logging.h>
+
+#include "Value.h"
+
+// Private JSC API; declared here rather than included because the header's
+// location varies across the JSC drops we build against. Must be called on
+// the context's VM thread.
+extern "C" JSStringRef JSContextCreateBacktrace(JSContextRef ctx, unsigned maxStackSize);
+
+namespace facebook {
+namespace react {
+
+namespace {
+
+// The process-global SIGPROF handler routes to the single active profiler.
+std::atomic<JSCSamplingProfiler*> s_activeProfiler(nullptr);
+struct sigaction s_previousSigprofAction;
+
+uint64_t nowMonotonicMicros() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<uint64_t>(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+}
+
+struct UnwindState {
+  uintptr_t* pcs;
+  size_t max;
+  size_t count;
+};
+
+_Unwind_Reason_Code unwindCallback(struct _Unwind_Context* context, void* arg) {
+  UnwindState* state = static_cast<UnwindState*>(arg);
+  uintptr_t pc = _Unwind_GetIP(context);
+  if (pc != 0) {
+    if (state->count >= state->max) {
+      return _URC_END_OF_STACK;
+    }
+    state->pcs[state->count++] = pc;
+  }
+  return _URC_NO_REASON;
+}
+
+template <typename T>
+void appendRaw(std::vector<uint8_t>& out, const T& value) {
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+  out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+} // namespace
+
+void samplingProfilerSignalHandler(int signum, siginfo_t* info, void* ucontext) {
+  JSCSamplingProfiler* profiler = s_activeProfiler.load(std::memory_order_acquire);
+  if (profiler) {
+    profiler->captureNativeStack();
+  }
+}
+
+JSCSamplingProfiler::~JSCSamplingProfiler() {
+  stop();
+}
+
+void JSCSamplingProfiler::start(
+    JSGlobalContextRef context,
+    std::shared_ptr<MessageQueueThread> jsQueue,
+    std::shared_ptr<bool> executorDestroyed,
+    const std::string& outputPath,
+    int intervalMs) {
+  if (m_active.load()) {
+    return;
+  }
+  JSCSamplingProfiler* expected = nullptr;
+  if (!s_activeProfiler.compare_exchange_strong(expected, this)) {
+    LOG(WARNING) << "Another sampling profiler is already running";
+    return;
+  }
+
+  m_context = context;
+  m_jsQueue = std::move(jsQueue);
+  m_executorDestroyed = std::move(executorDestroyed);
+  m_outputPath = outputPath;
+  m_intervalMs = intervalMs > 0 ? intervalMs : 10;
+
+  // Learn the JS thread's tid from the JS thread itself, synchronously, so
+  // sampling can't start before we know where to aim the signal.
+  if (m_jsQueue->isOnThread()) {
+    m_jsThreadTid = static_cast<int>(syscall(__NR_gettid));
+  } else {
+    m_jsQueue->runOnQueueSync([this] {
+      m_jsThreadTid = static_cast<int>(syscall(__NR_gettid));
+    });
+  }
+
+  struct sigaction action;
+  memset(&action, 0, sizeof(action));
+  action.sa_sigaction = samplingProfilerSignalHandler;
+  action.sa_flags = SA_SIGINFO | SA_RESTART;
+  sigemptyset(&action.sa_mask);
+  sigaction(SIGPROF, &action, &s_previousSigprofAction);
+
+  m_active.store(true);
+  m_samplerThread = std::thread([this] { samplerLoop(); });
+}
+
+void JSCSamplingProfiler::stop() {
+  if (!m_active.exchange(false)) {
+    return;
+  }
+  if (m_samplerThread.joinable()) {
+    m_samplerThread.join();
+  }
+  s_activeProfiler.store(nullptr, std::memory_order_release);
+  sigaction(SIGPROF, &s_previousSigprofAction, nullptr);
+  m_jsQueue.reset();
+  m_executorDestroyed.reset();
+  m_context = nullptr;
+}
+
+// Runs inside the SIGPROF handler on the JS thread. _Unwind_Backtrace isn't
+// strictly async-signal-safe but is the standard practice for SIGPROF
+// samplers; everything else here is lock- and allocation-free, writing into
+// the preallocated pending slot the sampler thread is waiting on.
+void JSCSamplingProfiler::captureNativeStack() {
+  UnwindState state = {m_pendingSample.pcs, kMaxNativeFrames, 0};
+  _Unwind_Backtrace(unwindCallback, &state);
+  m_pendingSample.timestampMicros = nowMonotonicMicros();
+  m_pendingSample.frameCount = static_cast<uint16_t>(state.count);
+  m_pendingSample.ready.store(true, std::memory_order_release);
+}
+
+void JSCSamplingProfiler::recordJSStack(uint64_t timestampMicros, std::string&& backtrace) {
+  std::lock_guard<std::mutex> lock(m_jsStacksMutex);
+  m_jsStacks.emplace_back(timestampMicros, std::move(backtrace));
+}
+
+void JSCSamplingProfiler::appendNativeSample(std::vector<uint8_t>& out) {
+  out.push_back(0x01);
+  appendRaw(out, m_pendingSample.timestampMicros);
+  appendRaw(out, m_pendingSample.frameCount);
+  for (uint16_t i = 0; i < m_pendingSample.frameCount; i++) {
+    appendRaw(out, static_cast<uint64_t>(m_pendingSample.pcs[i]));
+  }
+}
+
+void JSCSamplingProfiler::drainJSStacks(std::vector<uint8_t>& out) {
+  std::vector<std::pair<uint64_t, std::string>> stacks;
+  {
+    std::lock_guard<std::mutex> lock(m_jsStacksMutex);
+    stacks.swap(m_jsStacks);
+  }
+  for (auto& stack : stacks) {
+    out.push_back(0x02);
+    appendRaw(out, stack.first);
+    appendRaw(out, static_cast<uint32_t>(stack.second.size()));
+    out.insert(out.end(), stack.second.begin(), stack.second.end());
+  }
+}
+
+void JSCSamplingProfiler::samplerLoop() {
+  FILE* file = fopen(m_outputPath.c_str(), "wb");
+  if (!file) {
+    LOG(ERROR) << "Couldn't open sampling profile at " << m_outputPath;
+    m_active.store(false);
+    return;
+  }
+  static const char kMagic[4] = {'R', 'N', 'S', 'P'};
+  fwrite(kMagic, sizeof(kMagic), 1, file);
+  uint16_t version = 1;
+  fwrite(&version, sizeof(version), 1, file);
+
+  std::vector<uint8_t> buffer;
+  buffer.reserve(64 * 1024);
+  pid_t pid = getpid();
+  int tick = 0;
+
+  while (m_active.load(std::memory_order_relaxed)) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(m_intervalMs));
+
+    m_pendingSample.ready.store(false, std::memory_order_relaxed);
+    if (syscall(__NR_tgkill, pid, m_jsThreadTid, SIGPROF) == 0) {
+      // The handler fills the slot on the JS thread; give it a brief spin.
+      for (int spin = 0; spin < 10000 && !m_pendingSample.ready.load(std::memory_order_acquire); spin++) {
+        std::this_thread::yield();
+      }
+      if (m_pendingSample.ready.load(std::memory_order_acquire)) {
+        appendNativeSample(buffer);
+      }
+    }
+
+    if (++tick % kJsSampleDivisor == 0 && !m_jsSamplePending.exchange(true)) {
+      auto destroyed = m_executorDestroyed;
+      JSGlobalContextRef context = m_context;
+      m_jsQueue->runOnQueue([this, destroyed, context] {
+        // The destroyed flag outlives the executor that owns this profiler;
+        // once it's set, `this` may be gone too, so bail before touching it.
+        if (*destroyed) {
+          return;
+        }
+        String backtrace = String::adopt(JSContextCreateBacktrace(context, 64));
+        recordJSStack(nowMonotonicMicros(), backtrace.str());
+        m_jsSamplePending.store(false);
+      });
+    }
+
+    drainJSStacks(buffer);
+    if (buffer.size() >= 60 * 1024) {
+      fwrite(buffer.data(), 1, buffer.size(), file);
+      buffer.clear();
+    }
+  }
+
+  drainJSStacks(buffer);
+  if (!buffer.empty()) {
+    fwrite(buffer.data(), 1, buffer.size(), file);
+  }
+  fclose(file);
+}
+
+} }
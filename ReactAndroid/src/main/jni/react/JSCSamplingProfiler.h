@@ -0,0 +1,98 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include <signal.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <JavaScriptCore/JSContextRef.h>
+
+#include "MessageQueueThread.h"
+#include "noncopyable.h"
+
+namespace facebook {
+namespace react {
+
+/**
+ * Low-overhead sampling profiler for production sessions, where the legacy
+ * start/stop profiler in JSCLegacyProfiler is far too heavy. Two interleaved
+ * sample streams go to a compact binary file:
+ *
+ *  - Native stacks: a SIGPROF sent to the JS thread every interval; the
+ *    handler unwinds up to 32 PCs into a preallocated slot. When long-running
+ *    JS keeps the thread busy these land in JSC interpreter/JIT frames.
+ *  - JS backtraces: every few ticks a task posted to the JS queue captures
+ *    the JS stack through JSC's private backtrace API (which is only safe on
+ *    the VM thread, never from the signal handler).
+ *
+ * Offline tooling merges the streams by timestamp: the nearest preceding JS
+ * backtrace names the JS entry point active during a run of native samples.
+ *
+ * File format: "RNSP" + uint16 version, then records of
+ *   0x01 uint64 monotonic micros, uint16 frameCount, frameCount x uint64 PC
+ *   0x02 uint64 monotonic micros, uint32 byteLength, UTF-8 JS backtrace
+ * All integers are little-endian (we only run on LE targets).
+ *
+ * Only one instance can be sampling at a time (the SIGPROF handler is
+ * process-global). start/stop are safe from any thread.
+ */
+class JSCSamplingProfiler : public noncopyable {
+public:
+  JSCSamplingProfiler() {}
+  ~JSCSamplingProfiler();
+
+  void start(
+      JSGlobalContextRef context,
+      std::shared_ptr<MessageQueueThread> jsQueue,
+      std::shared_ptr<bool> executorDestroyed,
+      const std::string& outputPath,
+      int intervalMs);
+  void stop();
+
+private:
+  static const size_t kMaxNativeFrames = 32;
+  // One JS backtrace per this many native ticks; JS capture runs real JS
+  // machinery, so it stays much rarer than the signal samples.
+  static const int kJsSampleDivisor = 4;
+
+  struct PendingNativeSample {
+    uint64_t timestampMicros;
+    uint16_t frameCount;
+    uintptr_t pcs[kMaxNativeFrames];
+    std::atomic<bool> ready{false};
+  };
+
+  void samplerLoop();
+  void captureNativeStack();
+  void recordJSStack(uint64_t timestampMicros, std::string&& backtrace);
+  void appendNativeSample(std::vector<uint8_t>& out);
+  void drainJSStacks(std::vector<uint8_t>& out);
+
+  // The SIGPROF handler resolves the active instance through this; see
+  // JSCSamplingProfiler.cpp.
+  friend void samplingProfilerSignalHandler(int, siginfo_t*, void*);
+
+  JSGlobalContextRef m_context = nullptr;
+  std::shared_ptr<MessageQueueThread> m_jsQueue;
+  std::shared_ptr<bool> m_executorDestroyed;
+  std::string m_outputPath;
+  int m_intervalMs = 0;
+  int m_jsThreadTid = 0;
+
+  std::atomic<bool> m_active{false};
+  std::atomic<bool> m_jsSamplePending{false};
+  std::thread m_samplerThread;
+  PendingNativeSample m_pendingSample;
+
+  std::mutex m_jsStacksMutex;
+  std::vector<std::pair<uint64_t, std::string>> m_jsStacks;
+};
+
+} }
@@ -0,0 +1,92 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "JSCSourceCache.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <folly/Conv.h>
+#include <folly/String.h>
+#include <glog/logging.h>
+
+namespace facebook {
+namespace react {
+namespace JSCSourceCache {
+
+static const char* BUNDLE_DIR_PREFIX = "rn-bundle-";
+
+uint64_t hashBundle(const char* data, size_t size) {
+  // FNV-1a. Fast enough to run over a multi-MB bundle at startup and stable
+  // across processes, which is all we need for a cache key.
+  uint64_t hash = 0xcbf29ce484222325ull;
+  for (size_t i = 0; i < size; i++) {
+    hash ^= (uint8_t)data[i];
+    hash *= 0x100000001b3ull;
+  }
+  return hash;
+}
+
+static void removeRecursively(const std::string& path) {
+  DIR* dir = opendir(path.c_str());
+  if (dir) {
+    while (struct dirent* entry = readdir(dir)) {
+      std::string name = entry->d_name;
+      if (name == "." || name == "..") {
+        continue;
+      }
+      std::string childPath = path + "/" + name;
+      struct stat childInfo;
+      if (lstat(childPath.c_str(), &childInfo) == 0 && S_ISDIR(childInfo.st_mode)) {
+        removeRecursively(childPath);
+      } else {
+        unlink(childPath.c_str());
+      }
+    }
+    closedir(dir);
+  }
+  rmdir(path.c_str());
+}
+
+static void pruneStaleBundleDirs(const std::string& cacheDir, const std::string& keepName) {
+  DIR* dir = opendir(cacheDir.c_str());
+  if (!dir) {
+    return;
+  }
+  while (struct dirent* entry = readdir(dir)) {
+    std::string name = entry->d_name;
+    if (name != keepName &&
+        name.compare(0, strlen(BUNDLE_DIR_PREFIX), BUNDLE_DIR_PREFIX) == 0) {
+      removeRecursively(cacheDir + "/" + name);
+    }
+  }
+  closedir(dir);
+}
+
+std::string prepareBundleCacheDir(const std::string& cacheDir, uint64_t bundleHash) {
+  if (cacheDir.empty()) {
+    return "";
+  }
+
+  auto dirName = folly::to<std::string>(BUNDLE_DIR_PREFIX, folly::hexlify(
+      folly::ByteRange((const uint8_t*)&bundleHash, sizeof(bundleHash))));
+  auto bundleCacheDir = cacheDir + "/" + dirName;
+
+  if (mkdir(bundleCacheDir.c_str(), 0700) != 0 && errno != EEXIST) {
+    LOG(WARNING) << "Couldn't create bundle cache dir " << bundleCacheDir
+                 << ", skipping startup cache";
+    return "";
+  }
+
+  // A new bundle hash means the old blobs can never be hit again; drop them
+  // rather than letting each OTA update grow the cache directory.
+  pruneStaleBundleDirs(cacheDir, dirName);
+
+  return bundleCacheDir;
+}
+
+} // namespace JSCSourceCache
+} }
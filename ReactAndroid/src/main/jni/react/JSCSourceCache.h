@@ -0,0 +1,40 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+
+namespace facebook {
+namespace react {
+
+/**
+ * Startup source cache for JSC.
+ *
+ * The executor's cache directory holds one subdirectory per bundle, keyed by
+ * a hash of the bundle bytes. JSC builds with the pre-parsing cache (see
+ * configureJSContextForAndroid) write their parsed-source/bytecode blobs into
+ * that subdirectory, so a warm start with an unchanged bundle skips the full
+ * parse while a bundle update naturally misses and repopulates. Entries for
+ * other bundle hashes are pruned to keep the directory from growing across
+ * OTA updates.
+ */
+namespace JSCSourceCache {
+
+/**
+ * Stable 64-bit FNV-1a hash of the bundle bytes.
+ */
+uint64_t hashBundle(const char* data, size_t size);
+
+/**
+ * Ensures the per-bundle cache subdirectory for the given hash exists under
+ * cacheDir and evicts subdirectories belonging to other bundle hashes.
+ * Returns the subdirectory path, or an empty string if cacheDir is empty or
+ * the directory can't be created (callers should then skip caching).
+ */
+std::string prepareBundleCacheDir(const std::string& cacheDir, uint64_t bundleHash);
+
+} // namespace JSCSourceCache
+
+} }
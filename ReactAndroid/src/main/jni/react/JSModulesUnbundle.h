@@ -5,6 +5,7 @@
 #include <cstdint>
 #include <string>
 #include <stdexcept>
+#include <vector>
 
 #include "noncopyable.h"
 
@@ -27,8 +28,50 @@ public:
     std::string name;
     std::string code;
   };
+
+  /**
+   * Non-owning view of a module's source. code points at a null-terminated
+   * buffer owned by the unbundle and stays valid for the unbundle's lifetime.
+   */
+  struct ModuleRef {
+    std::string name;
+    const char* code;
+  };
+
   virtual ~JSModulesUnbundle() {}
   virtual Module getModule(uint32_t moduleId) const = 0;
+
+  /**
+   * Fills ref with a zero-copy view of the module source if this unbundle
+   * backend supports it. Backends that read modules into fresh strings return
+   * false and callers fall back to getModule().
+   */
+  virtual bool getModuleRef(uint32_t moduleId, ModuleRef* ref) const {
+    return false;
+  }
+
+  /**
+   * Gives the backend a chance to warm a module ahead of need (fault pages
+   * in, decompress, ...). Returns false when the backend has nothing better
+   * than a plain read, in which case the caller should read the module
+   * itself. Unlike the read APIs this may be called off the JS thread.
+   */
+  virtual bool prefetchModule(uint32_t moduleId) {
+    return false;
+  }
+
+  /**
+   * Gives the backend a chance to rewrite its on-disk layout so module
+   * records appear in the given observed require order, making the next cold
+   * start's early requires fault sequential pages. Any rewrite must be
+   * atomic (write-then-rename) and must not disturb the running instance;
+   * the new layout takes effect at the next open. Called off the JS thread.
+   * Returns true if a rewrite happened. Backends without persistent layout
+   * (or already laid out this way) return false.
+   */
+  virtual bool relayoutForRequireOrder(const std::vector<uint32_t>& requireOrder) {
+    return false;
+  }
 };
 
 }
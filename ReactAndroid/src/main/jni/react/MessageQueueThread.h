@@ -2,37 +2,87 @@
 
 #pragma once
 
-#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <functional>
-#include <mutex>
+
+#include "FutexEvent.h"
+#include "InlineTask.h"
 
 namespace facebook {
 namespace react {
 
+/**
+ * Relative scheduling tiers for runOnQueue. Tasks within a tier run FIFO;
+ * Immediate tasks overtake already-queued Normal work, and Idle tasks run
+ * strictly in gaps, when no higher-priority work is pending.
+ */
+enum class TaskPriority {
+  Immediate,
+  Normal,
+  Idle,
+};
+
 class MessageQueueThread {
  public:
   virtual ~MessageQueueThread() {}
-  virtual void runOnQueue(std::function<void()>&&) = 0;
+  // Equivalent to runOnQueue(TaskPriority::Normal, ...).
+  virtual void runOnQueue(MessageQueueTask&&) = 0;
+  // Queues without priority support fall back to plain FIFO ordering.
+  virtual void runOnQueue(TaskPriority priority, MessageQueueTask&& task) {
+    runOnQueue(std::move(task));
+  }
+  /**
+   * Runs the given task the next time this queue goes idle, i.e. once no
+   * immediate- or normal-priority work is pending; shorthand for the
+   * TaskPriority::Idle tier. Meant for deferrable background work like
+   * prefetching and cache maintenance that shouldn't delay bridge calls.
+   */
+  virtual void onIdle(MessageQueueTask&& task) {
+    runOnQueue(TaskPriority::Idle, std::move(task));
+  }
   virtual bool isOnThread() = 0;
   // quitSynchronous() should synchronously ensure that no further tasks will run on the queue.
   virtual void quitSynchronous() = 0;
 
   void runOnQueueSync(std::function<void()>&& runnable) {
-    std::mutex signalMutex;
-    std::condition_variable signalCv;
-    bool runnableComplete = false;
-
-    runOnQueue([&] () mutable {
-      std::lock_guard<std::mutex> lock(signalMutex);
-
+    // Already on the target thread: run inline. Queuing here would deadlock
+    // the thread on itself, and this also makes re-entrant sync calls safe.
+    if (isOnThread()) {
       runnable();
-      runnableComplete = true;
+      return;
+    }
 
-      signalCv.notify_one();
+    FutexEvent done;
+    runOnQueue([&runnable, &done] {
+      runnable();
+      done.signal();
     });
 
-    std::unique_lock<std::mutex> lock(signalMutex);
-    signalCv.wait(lock, [&runnableComplete] { return runnableComplete; });
+    auto waitStart = std::chrono::steady_clock::now();
+    done.wait();
+    uint64_t waitMicros = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - waitStart).count();
+    SyncWaitStats& stats = syncWaitStats();
+    stats.count.fetch_add(1, std::memory_order_relaxed);
+    stats.totalWaitMicros.fetch_add(waitMicros, std::memory_order_relaxed);
+  }
+
+  /**
+   * Process-wide instrumentation for runOnQueueSync: how often callers
+   * blocked on another thread and for how long in total. Inline fast-path
+   * executions don't count as waits. Reads are unsynchronized snapshots;
+   * fine for telemetry.
+   */
+  struct SyncWaitStats {
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> totalWaitMicros{0};
+  };
+
+  static SyncWaitStats& syncWaitStats() {
+    static SyncWaitStats stats;
+    return stats;
   }
 };
 
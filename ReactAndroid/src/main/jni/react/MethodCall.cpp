@@ -2,16 +2,36 @@
 
 #include "MethodCall.h"
 
+// The shared batched-bridge core lives outside the Android tree so the
+// Ubuntu runtime can use it too; a relative include keeps both the ndk-build
+// and BUCK targets working without new include roots.
+#include "../../../../../ReactCommon/BatchedBridge/MethodCallBatch.h"
+
+#include <cstring>
 #include <folly/json.h>
 #include <stdexcept>
 
 namespace facebook {
 namespace react {
 
-#define REQUEST_MODULE_IDS 0
-#define REQUEST_METHOD_IDS 1
+static const char BINARY_BATCH_MAGIC[4] = { 'R', 'N', 'B', '\x01' };
+
 #define REQUEST_PARAMSS 2
-#define REQUEST_CALLID 3
+
+namespace {
+
+// Binds by reference: the batch fields are the largest subtrees of the parse
+// and copying folly::dynamic is deep.
+struct DynamicTraits {
+  typedef const folly::dynamic& ValueRef;
+  static bool isArray(const folly::dynamic& value) { return value.isArray(); }
+  static size_t size(const folly::dynamic& value) { return value.size(); }
+  static ValueRef at(const folly::dynamic& value, size_t i) { return value[i]; }
+  static bool isInt(const folly::dynamic& value) { return value.isInt(); }
+  static int toInt(const folly::dynamic& value) { return value.getInt(); }
+};
+
+} // namespace
 
 std::vector<MethodCall> parseMethodCalls(const std::string& json) {
   folly::dynamic jsonData = folly::parseJson(json);
@@ -20,53 +40,141 @@ std::vector<MethodCall> parseMethodCalls(const std::string& json) {
     return {};
   }
 
-  if (!jsonData.isArray()) {
-    throw std::invalid_argument(
-        folly::to<std::string>("Did not get valid calls back from JS: ", jsonData.typeName()));
+  std::vector<MethodCall> methodCalls;
+  if (jsonData.isArray() && jsonData.size() > 0 && jsonData[0].isArray()) {
+    methodCalls.reserve(jsonData[0].size());
   }
+  forEachMethodCall<DynamicTraits>(
+    jsonData,
+    [&](int moduleId, int methodId, size_t callIndex, int callId) {
+      // Moving the arguments out keeps the parse's allocation volume flat;
+      // the batch is dead after this walk.
+      methodCalls.emplace_back(
+        moduleId,
+        methodId,
+        std::move(jsonData[REQUEST_PARAMSS][callIndex]),
+        callId);
+    },
+    [&](const char* message) {
+      throw std::invalid_argument(
+          folly::to<std::string>("Did not get valid calls back from JS: ", message));
+    });
 
-  if (jsonData.size() < REQUEST_PARAMSS + 1) {
-    throw std::invalid_argument(
-          folly::to<std::string>("Did not get valid calls back from JS: size == ", jsonData.size()));
+  return methodCalls;
+}
+
+bool isBinaryBatch(const std::string& batch) {
+  return batch.size() >= sizeof(BINARY_BATCH_MAGIC) &&
+      memcmp(batch.data(), BINARY_BATCH_MAGIC, sizeof(BINARY_BATCH_MAGIC)) == 0;
+}
+
+BinaryBatchReader::BinaryBatchReader(const char* data, size_t size)
+    : m_data(data)
+    , m_size(size)
+    , m_offset(0) {
+  if (size < sizeof(BINARY_BATCH_MAGIC) ||
+      memcmp(data, BINARY_BATCH_MAGIC, sizeof(BINARY_BATCH_MAGIC)) != 0) {
+    throw std::invalid_argument("Binary batch is missing its magic header");
   }
+  m_offset = sizeof(BINARY_BATCH_MAGIC);
+}
 
-  auto moduleIds = jsonData[REQUEST_MODULE_IDS];
-  auto methodIds = jsonData[REQUEST_METHOD_IDS];
-  auto params = jsonData[REQUEST_PARAMSS];
-  int  callId = -1;
+bool BinaryBatchReader::hasNext() const {
+  return m_offset < m_size;
+}
+
+namespace {
 
-  if (!moduleIds.isArray() || !methodIds.isArray() || !params.isArray()) {
-    throw std::invalid_argument(
-          folly::to<std::string>("Did not get valid calls back from JS: ", json.c_str()));
+template <typename T>
+T readRaw(const char* data, size_t size, size_t& offset) {
+  if (offset + sizeof(T) > size) {
+    throw std::invalid_argument("Truncated binary batch record");
   }
+  T value;
+  memcpy(&value, data + offset, sizeof(T));
+  offset += sizeof(T);
+  return value;
+}
 
-  if (jsonData.size() > REQUEST_CALLID) {
-    if (!jsonData[REQUEST_CALLID].isInt()) {
-      throw std::invalid_argument(
-          folly::to<std::string>("Did not get valid calls back from JS: %s", json.c_str()));
-    } else {
-      callId = jsonData[REQUEST_CALLID].getInt();
-    }
+folly::StringPiece readBytes(const char* data, size_t size, size_t& offset) {
+  uint32_t length = readRaw<uint32_t>(data, size, offset);
+  if (offset + length > size) {
+    throw std::invalid_argument("Truncated binary batch string");
   }
+  folly::StringPiece piece(data + offset, length);
+  offset += length;
+  return piece;
+}
 
-  std::vector<MethodCall> methodCalls;
-  for (size_t i = 0; i < moduleIds.size(); i++) {
-    auto paramsValue = params[i];
-    if (!paramsValue.isArray()) {
-      throw std::invalid_argument(
-          folly::to<std::string>("Call argument isn't an array"));
+folly::dynamic readArgument(const char* data, size_t size, size_t& offset) {
+  uint8_t tag = readRaw<uint8_t>(data, size, offset);
+  switch (tag) {
+    case BinaryArgument::Null:
+      return nullptr;
+    case BinaryArgument::False:
+      return false;
+    case BinaryArgument::True:
+      return true;
+    case BinaryArgument::Double:
+      return readRaw<double>(data, size, offset);
+    case BinaryArgument::Int32:
+      return readRaw<int32_t>(data, size, offset);
+    case BinaryArgument::String:
+      return readBytes(data, size, offset).str();
+    case BinaryArgument::Json:
+      // Structured arguments (maps/nested arrays) still ride as JSON blobs,
+      // but only that argument pays the parse instead of the whole batch.
+      return folly::parseJson(readBytes(data, size, offset));
+    case BinaryArgument::Blob: {
+      // Only the handle crosses; the bytes stay in the BlobRegistry until
+      // the receiving module resolves the id.
+      int64_t blobId = (int64_t) readRaw<uint64_t>(data, size, offset);
+      int64_t blobOffset = readRaw<uint32_t>(data, size, offset);
+      int64_t blobSize = readRaw<uint32_t>(data, size, offset);
+      return folly::dynamic::object
+          ("type", "blob")
+          ("blobId", blobId)
+          ("offset", blobOffset)
+          ("size", blobSize);
     }
+    default:
+      throw std::invalid_argument(
+          folly::to<std::string>("Unknown binary argument tag: ", (int)tag));
+  }
+}
+
+} // namespace
 
-    methodCalls.emplace_back(
-      moduleIds[i].getInt(),
-      methodIds[i].getInt(),
-      std::move(params[i]),
-      callId);
+MethodCall BinaryBatchReader::next() {
+  uint32_t recordLength = readRaw<uint32_t>(m_data, m_size, m_offset);
+  size_t recordEnd = m_offset + recordLength;
+  if (recordEnd > m_size) {
+    throw std::invalid_argument("Truncated binary batch record");
+  }
+
+  int32_t moduleId = readRaw<int32_t>(m_data, m_size, m_offset);
+  int32_t methodId = readRaw<int32_t>(m_data, m_size, m_offset);
+  int32_t callId = readRaw<int32_t>(m_data, m_size, m_offset);
+  uint32_t argCount = readRaw<uint32_t>(m_data, m_size, m_offset);
+
+  folly::dynamic arguments = folly::dynamic::array();
+  for (uint32_t i = 0; i < argCount; i++) {
+    arguments.push_back(readArgument(m_data, m_size, m_offset));
+  }
 
-    // only incremement callid if contains valid callid as callid is optional
-    callId += (callId != -1) ? 1 : 0;
+  if (m_offset != recordEnd) {
+    throw std::invalid_argument("Binary batch record length mismatch");
   }
 
+  return MethodCall(moduleId, methodId, std::move(arguments), callId);
+}
+
+std::vector<MethodCall> parseBinaryMethodCalls(const std::string& batch) {
+  BinaryBatchReader reader(batch.data(), batch.size());
+  std::vector<MethodCall> methodCalls;
+  while (reader.hasNext()) {
+    methodCalls.push_back(reader.next());
+  }
   return methodCalls;
 }
 
@@ -24,6 +24,92 @@ struct MethodCall {
     , callId(cid) {}
 };
 
+/**
+ * A call headed in the other direction: native into a JS module method.
+ * Used by the batched dispatch path so a burst of calls can cross to the
+ * executor thread in a single queue hop.
+ */
+struct JSFunctionCall {
+  std::string moduleId;
+  std::string methodId;
+  folly::dynamic arguments;
+};
+
 std::vector<MethodCall> parseMethodCalls(const std::string& json);
 
+/**
+ * Binary batch protocol.
+ *
+ * A batch that crosses the bridge may be encoded as a length-prefixed binary
+ * stream instead of JSON to avoid the folly::toJson/parseJson round trip on
+ * every flush. The layout is:
+ *
+ *   [4 bytes]  magic "RNB\x01"
+ *   repeated records:
+ *     [uint32]  record byte length (excluding this field)
+ *     [int32]   moduleId
+ *     [int32]   methodId
+ *     [int32]   callId (-1 if absent)
+ *     [uint32]  argument count
+ *     repeated typed arguments:
+ *       [uint8] tag (see BinaryArgument)
+ *       tag-specific payload (doubles and int32s inline, strings and
+ *       pre-encoded JSON blobs as [uint32 length][bytes], blob handles as
+ *       [uint64 blobId][uint32 offset][uint32 size])
+ *
+ * All integers are little-endian. The executor that produced the batch
+ * advertises support by installing the __fbBridgeBinaryVersion global; the
+ * JSON path remains the fallback for executors and JS runtimes that don't.
+ */
+struct BinaryArgument {
+  enum Tag : uint8_t {
+    Null = 0,
+    False = 1,
+    True = 2,
+    Double = 3,
+    Int32 = 4,
+    String = 5,
+    Json = 6,
+    // Reference to bytes parked in the BlobRegistry, so binary payloads
+    // cross by id instead of as base64 text. Decodes to
+    // {"type": "blob", "blobId": id, "offset": o, "size": n}; the receiving
+    // module resolves and releases the id.
+    Blob = 7,
+  };
+};
+
+/**
+ * Returns whether the given batch payload carries the binary batch magic.
+ */
+bool isBinaryBatch(const std::string& batch);
+
+/**
+ * Zero-copy reader over an encoded binary batch. The reader does not own the
+ * buffer and only materializes folly::dynamic values for the arguments of the
+ * call currently being read; the buffer must outlive the reader.
+ */
+class BinaryBatchReader {
+public:
+  BinaryBatchReader(const char* data, size_t size);
+
+  bool hasNext() const;
+
+  /**
+   * Decodes the next method call. Throws std::invalid_argument on a
+   * truncated or malformed record.
+   */
+  MethodCall next();
+
+private:
+  const char* m_data;
+  size_t m_size;
+  size_t m_offset;
+};
+
+/**
+ * Convenience wrapper decoding a whole binary batch at once, mirroring
+ * parseMethodCalls for the JSON path.
+ */
+std::vector<MethodCall> parseBinaryMethodCalls(const std::string& batch);
+
 } }
@@ -0,0 +1,183 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "MetricsRing.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+#include "BridgeMetrics.h"
+
+namespace facebook {
+namespace react {
+namespace MetricsRing {
+
+namespace {
+
+const uint32_t kMagic = 0x52474e4d; // 'MNGR' little-endian: "MNGR"ing
+const uint32_t kVersion = 1;
+// 4096 records of 64 bytes plus the header page: a 260KB file holding a few
+// seconds of worst-case bridge traffic, which is the window that matters
+// leading into a crash.
+const uint32_t kRecordCount = 4096;
+const size_t kNameSize = 28;
+
+struct Header {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t recordCount;
+  uint32_t reserved;
+  // Claiming a slot is one relaxed fetch_add on this cursor, straight in
+  // the mapped page; it only ever grows, across sessions too, so sequence
+  // numbers stay globally ordered.
+  std::atomic<uint64_t> writeCursor;
+  uint8_t pad[4096 - 24];
+};
+
+struct Record {
+  uint64_t seq;
+  uint64_t epoch;
+  uint64_t timeMicros;
+  int64_t value;
+  char name[kNameSize];
+  uint32_t checksum;
+};
+
+static_assert(sizeof(Header) == 4096, "Header must fill one page");
+static_assert(sizeof(Record) == 64, "Record slots must stay cache-line sized");
+
+// Cheap fold of every field but the checksum itself; torn slots from a
+// crash mid-store fail this and get skipped by readers.
+uint32_t checksumRecord(const Record& r) {
+  uint64_t h = r.seq * 0x9e3779b97f4a7c15ull;
+  h ^= r.epoch + 0x85ebca6bull + (h << 6) + (h >> 2);
+  h ^= r.timeMicros + (h << 6) + (h >> 2);
+  h ^= static_cast<uint64_t>(r.value) + (h << 6) + (h >> 2);
+  for (size_t i = 0; i < kNameSize; i++) {
+    h = h * 31 + static_cast<uint8_t>(r.name[i]);
+  }
+  return static_cast<uint32_t>(h ^ (h >> 32));
+}
+
+std::mutex s_initMutex;
+Header* s_header = nullptr;
+Record* s_records = nullptr;
+uint64_t s_epoch = 0;
+bool s_drained = false;
+
+} // namespace
+
+bool initialize(const std::string& cacheDir) {
+  std::lock_guard<std::mutex> lock(s_initMutex);
+  if (s_header != nullptr) {
+    return true;
+  }
+
+  std::string path = cacheDir + "/metrics.ring";
+  int fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0600);
+  if (fd == -1) {
+    return false;
+  }
+
+  const size_t fileSize = sizeof(Header) + sizeof(Record) * kRecordCount;
+  struct stat st;
+  bool fresh = ::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) != fileSize;
+  if (fresh && ::ftruncate(fd, fileSize) != 0) {
+    ::close(fd);
+    return false;
+  }
+
+  void* map = ::mmap(nullptr, fileSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (map == MAP_FAILED) {
+    return false;
+  }
+
+  Header* header = static_cast<Header*>(map);
+  if (fresh || header->magic != kMagic || header->version != kVersion ||
+      header->recordCount != kRecordCount) {
+    // Fresh file or a layout change: start the ring over. Previous-version
+    // records aren't worth a migration path.
+    std::memset(map, 0, fileSize);
+    header->magic = kMagic;
+    header->version = kVersion;
+    header->recordCount = kRecordCount;
+    header->writeCursor.store(0, std::memory_order_relaxed);
+  }
+
+  // Wall-clock stamp makes the epoch unique per session without another
+  // persisted counter; collisions would need two launches in the same
+  // microsecond.
+  s_epoch = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count();
+  s_records = reinterpret_cast<Record*>(header + 1);
+  // Publishes the mapping to record() callers on other threads.
+  __atomic_store_n(&s_header, header, __ATOMIC_RELEASE);
+  return true;
+}
+
+void record(const char* name, int64_t value) {
+  Header* header = __atomic_load_n(&s_header, __ATOMIC_ACQUIRE);
+  if (header == nullptr) {
+    return;
+  }
+
+  uint64_t seq = header->writeCursor.fetch_add(1, std::memory_order_relaxed);
+  Record& slot = s_records[seq % kRecordCount];
+
+  // Plain stores into the mapped page; a crash between any of them leaves a
+  // checksum mismatch, never a syscall or a lock held.
+  slot.seq = seq;
+  slot.epoch = s_epoch;
+  slot.timeMicros = BridgeMetrics::nowMicros();
+  slot.value = value;
+  std::strncpy(slot.name, name, kNameSize - 1);
+  slot.name[kNameSize - 1] = '\0';
+  slot.checksum = checksumRecord(slot);
+}
+
+folly::dynamic drainPrevious() {
+  folly::dynamic result = folly::dynamic::array();
+
+  std::lock_guard<std::mutex> lock(s_initMutex);
+  if (s_header == nullptr || s_drained) {
+    return result;
+  }
+  s_drained = true;
+
+  std::vector<const Record*> survivors;
+  survivors.reserve(kRecordCount);
+  for (uint32_t i = 0; i < kRecordCount; i++) {
+    const Record& r = s_records[i];
+    if (r.epoch == 0 || r.epoch == s_epoch) {
+      continue;
+    }
+    if (r.checksum != checksumRecord(r)) {
+      continue;
+    }
+    survivors.push_back(&r);
+  }
+  std::sort(survivors.begin(), survivors.end(),
+            [] (const Record* a, const Record* b) { return a->seq < b->seq; });
+
+  for (const Record* r : survivors) {
+    result.push_back(folly::dynamic::object
+        ("name", std::string(r->name))
+        ("value", r->value)
+        ("timeMicros", r->timeMicros)
+        ("session", r->epoch));
+  }
+  return result;
+}
+
+} // namespace MetricsRing
+} }
@@ -0,0 +1,57 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include <folly/dynamic.h>
+
+namespace facebook {
+namespace react {
+
+/**
+ * Crash-safe persistent metrics ring.
+ *
+ * A fixed-size mmap-backed file of fixed-size records, kept beside the
+ * executor cache dir. record() claims a slot with one atomic increment and
+ * fills it with plain stores into the mapped page — no syscalls, no locks —
+ * so it is safe on the bridge dispatch hot path. Because the mapping is
+ * MAP_SHARED, the kernel writes dirty pages back even when the process
+ * dies abruptly; whatever the previous session recorded on its way into a
+ * crash is readable at the next launch.
+ *
+ * Every record carries the session epoch, a sequence number and a checksum,
+ * so readers can skip slots torn by a crash mid-store and order what
+ * survived. The ring wraps: under sustained traffic it always holds the
+ * most recent records, which is the tail that matters after a crash.
+ */
+namespace MetricsRing {
+
+/**
+ * Maps (creating on first use) the ring file under the given cache dir and
+ * stamps this session's epoch. Idempotent and cheap after the first call.
+ * Returns false when the file cannot be created or mapped, in which case
+ * record() quietly no-ops.
+ */
+bool initialize(const std::string& cacheDir);
+
+/**
+ * Appends one record under the current session's epoch. The name is
+ * truncated to the fixed slot width. Safe from any thread; calls before
+ * initialize() (or after a failed one) are dropped.
+ */
+void record(const char* name, int64_t value);
+
+/**
+ * The records previous sessions left behind (epoch differs from this
+ * session's), oldest first, as [{name, value, timeMicros, session}].
+ * One-shot: the first call returns them for upload, later calls return an
+ * empty array. Timestamps are on the BridgeMetrics monotonic clock of the
+ * session that wrote them, so they order records but don't date them.
+ */
+folly::dynamic drainPrevious();
+
+} // namespace MetricsRing
+
+} }
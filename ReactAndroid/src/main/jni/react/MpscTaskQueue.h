@@ -0,0 +1,130 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include <atomic>
+
+#include "InlineTask.h"
+#include "noncopyable.h"
+
+namespace facebook {
+namespace react {
+
+/**
+ * A lock-free multi-producer single-consumer task queue.
+ *
+ * Producers push from any thread with a single CAS loop and no allocation
+ * beyond the task node itself. The consumer drains everything that has been
+ * pushed in one go; tasks run in push order. Intended for queue-front
+ * batching: a dispatcher only needs to schedule a consumer wakeup when push()
+ * reports the empty -> non-empty transition, collapsing a burst of tasks
+ * into one wakeup.
+ *
+ * drain() must only be called from one thread at a time (for the message
+ * queue use case, the queue's own thread).
+ *
+ * Task nodes are recycled through a spinlock-guarded free list instead of
+ * going back to malloc, and the tasks themselves are inline-storage
+ * MessageQueueTasks, so a steady-state push performs no allocation at all.
+ * The free list grows to the queue's high-water mark and stays there.
+ */
+class MpscTaskQueue : public noncopyable {
+public:
+  ~MpscTaskQueue() {
+    // Drop any tasks that never ran; matches the dispatcher behavior of
+    // discarding work for a dead queue.
+    freeList(m_head.exchange(nullptr, std::memory_order_acquire));
+    freeList(m_free.exchange(nullptr, std::memory_order_acquire));
+  }
+
+  /**
+   * Pushes a task; returns true if the queue was empty, i.e. the caller is
+   * responsible for scheduling a consumer wakeup.
+   */
+  bool push(MessageQueueTask&& fn) {
+    Task* task = allocTask();
+    task->fn = std::move(fn);
+    Task* oldHead = m_head.load(std::memory_order_relaxed);
+    do {
+      task->next = oldHead;
+    } while (!m_head.compare_exchange_weak(
+        oldHead, task, std::memory_order_release, std::memory_order_relaxed));
+    return oldHead == nullptr;
+  }
+
+  /**
+   * True if nothing is currently queued. Inherently racy with concurrent
+   * producers; intended for best-effort gap detection by the consumer.
+   */
+  bool isEmpty() const {
+    return m_head.load(std::memory_order_acquire) == nullptr;
+  }
+
+  /**
+   * Runs every task pushed so far, in push order.
+   */
+  void drain() {
+    Task* task = m_head.exchange(nullptr, std::memory_order_acquire);
+
+    // The list comes out newest-first; reverse it to run in push order.
+    Task* reversed = nullptr;
+    while (task) {
+      Task* next = task->next;
+      task->next = reversed;
+      reversed = task;
+      task = next;
+    }
+
+    while (reversed) {
+      Task* next = reversed->next;
+      reversed->fn();
+      // Drop the captures now rather than when the node is reused; tasks
+      // often hold the last reference to arguments or executor state.
+      reversed->fn.reset();
+      recycleTask(reversed);
+      reversed = next;
+    }
+  }
+
+private:
+  struct Task {
+    MessageQueueTask fn;
+    Task* next{nullptr};
+  };
+
+  Task* allocTask() {
+    // A plain Treiber stack would suffer ABA with concurrent producers
+    // popping, so the (tiny) free-list accesses take a spinlock instead;
+    // it's held for two pointer moves.
+    while (m_freeLock.test_and_set(std::memory_order_acquire)) {
+    }
+    Task* task = m_free.load(std::memory_order_relaxed);
+    if (task) {
+      m_free.store(task->next, std::memory_order_relaxed);
+    }
+    m_freeLock.clear(std::memory_order_release);
+    return task ? task : new Task();
+  }
+
+  void recycleTask(Task* task) {
+    while (m_freeLock.test_and_set(std::memory_order_acquire)) {
+    }
+    task->next = m_free.load(std::memory_order_relaxed);
+    m_free.store(task, std::memory_order_relaxed);
+    m_freeLock.clear(std::memory_order_release);
+  }
+
+  static void freeList(Task* task) {
+    while (task) {
+      Task* next = task->next;
+      delete task;
+      task = next;
+    }
+  }
+
+  std::atomic<Task*> m_head{nullptr};
+  std::atomic<Task*> m_free{nullptr};
+  std::atomic_flag m_freeLock = ATOMIC_FLAG_INIT;
+};
+
+} }
@@ -0,0 +1,55 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "NativeMessageQueueThread.h"
+
+namespace facebook {
+namespace react {
+
+NativeMessageQueueThread::NativeMessageQueueThread() :
+  m_thread([this] { loop(); }) {
+}
+
+NativeMessageQueueThread::~NativeMessageQueueThread() {
+  if (m_thread.joinable()) {
+    quitSynchronous();
+  }
+}
+
+void NativeMessageQueueThread::runOnQueue(MessageQueueTask&& task) {
+  if (m_queue.push(std::move(task))) {
+    std::lock_guard<std::mutex> lock(m_wakeMutex);
+    m_wakePending = true;
+    m_wakeCv.notify_one();
+  }
+}
+
+bool NativeMessageQueueThread::isOnThread() {
+  return std::this_thread::get_id() == m_thread.get_id();
+}
+
+void NativeMessageQueueThread::quitSynchronous() {
+  {
+    std::lock_guard<std::mutex> lock(m_wakeMutex);
+    m_quitting = true;
+    m_wakeCv.notify_one();
+  }
+  m_thread.join();
+}
+
+void NativeMessageQueueThread::loop() {
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(m_wakeMutex);
+      m_wakeCv.wait(lock, [this] { return m_wakePending || m_quitting; });
+      if (m_quitting) {
+        // Tasks still queued are dropped, matching quitSynchronous's
+        // contract that nothing runs after it returns.
+        return;
+      }
+      m_wakePending = false;
+    }
+    m_queue.drain();
+  }
+}
+
+} }
@@ -0,0 +1,45 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "MessageQueueThread.h"
+#include "MpscTaskQueue.h"
+
+namespace facebook {
+namespace react {
+
+/**
+ * A MessageQueueThread backed by a plain std::thread instead of a Java
+ * looper, for queues that never touch JNI (e.g. the parallel JSON encoder's
+ * workers). Tasks go through the same lock-free MpscTaskQueue as
+ * JMessageQueueThread; the condition variable only comes into play on the
+ * empty -> non-empty wakeup.
+ */
+class NativeMessageQueueThread : public MessageQueueThread {
+public:
+  NativeMessageQueueThread();
+  ~NativeMessageQueueThread() override;
+
+  // Pull in the priority-tier overload; this queue is priority-unaware and
+  // runs everything FIFO.
+  using MessageQueueThread::runOnQueue;
+  void runOnQueue(MessageQueueTask&& task) override;
+  bool isOnThread() override;
+  void quitSynchronous() override;
+
+private:
+  void loop();
+
+  MpscTaskQueue m_queue;
+  std::mutex m_wakeMutex;
+  std::condition_variable m_wakeCv;
+  bool m_wakePending{false};
+  bool m_quitting{false};
+  std::thread m_thread;
+};
+
+} }
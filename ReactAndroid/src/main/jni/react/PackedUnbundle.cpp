@@ -0,0 +1,408 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "PackedUnbundle.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <folly/Conv.h>
+
+namespace facebook {
+namespace react {
+
+static const uint32_t PACKED_UNBUNDLE_MAGIC = 0xFB0BD1E5;
+static const uint32_t PACKED_UNBUNDLE_MAGIC_LZ4 = 0xFB0BD1E6;
+static const size_t HEADER_SIZE = 2 * sizeof(uint32_t);
+
+// The prefetcher replays whole require profiles; don't let modules it decoded
+// but JS hasn't consumed yet pile up past this.
+static const size_t MAX_STASHED_MODULES = 64;
+
+/**
+ * Minimal safe decoder for the LZ4 block format: a stream of sequences, each
+ * a token byte (literal length high nibble, match length low nibble, 15
+ * meaning "continued in following bytes"), the literals, a little-endian
+ * 16-bit backwards match offset, and the match length. Every length and
+ * offset is bounds-checked against both buffers, so a corrupt entry fails
+ * decode instead of writing out of bounds. Only decode lives in the runtime;
+ * compression happens in the packer at build time.
+ */
+static bool lz4DecodeBlock(
+    const uint8_t* src,
+    size_t srcSize,
+    uint8_t* dst,
+    size_t dstSize) {
+  const uint8_t* srcEnd = src + srcSize;
+  uint8_t* out = dst;
+  uint8_t* dstEnd = dst + dstSize;
+
+  while (src < srcEnd) {
+    uint8_t token = *src++;
+
+    size_t literalLength = token >> 4;
+    if (literalLength == 15) {
+      uint8_t extra;
+      do {
+        if (src >= srcEnd) {
+          return false;
+        }
+        extra = *src++;
+        literalLength += extra;
+      } while (extra == 255);
+    }
+    if (literalLength > (size_t)(srcEnd - src) ||
+        literalLength > (size_t)(dstEnd - out)) {
+      return false;
+    }
+    memcpy(out, src, literalLength);
+    src += literalLength;
+    out += literalLength;
+
+    if (src == srcEnd) {
+      // The final sequence is literals only.
+      break;
+    }
+
+    if (srcEnd - src < 2) {
+      return false;
+    }
+    size_t matchOffset = src[0] | (src[1] << 8);
+    src += 2;
+    if (matchOffset == 0 || matchOffset > (size_t)(out - dst)) {
+      return false;
+    }
+
+    size_t matchLength = token & 0x0f;
+    if (matchLength == 15) {
+      uint8_t extra;
+      do {
+        if (src >= srcEnd) {
+          return false;
+        }
+        extra = *src++;
+        matchLength += extra;
+      } while (extra == 255);
+    }
+    matchLength += 4;
+    if (matchLength > (size_t)(dstEnd - out)) {
+      return false;
+    }
+
+    // Byte-wise on purpose: matches may overlap their own output.
+    const uint8_t* match = out - matchOffset;
+    for (size_t i = 0; i < matchLength; i++) {
+      out[i] = match[i];
+    }
+    out += matchLength;
+  }
+
+  return out == dstEnd;
+}
+
+PackedUnbundle::PackedUnbundle(void* map, size_t mapSize, const std::string& sourcePath) :
+    m_map(map),
+    m_mapSize(mapSize),
+    m_sourcePath(sourcePath) {
+  if (mapSize < HEADER_SIZE) {
+    throw std::runtime_error("Packed unbundle is too small for its header");
+  }
+  const uint32_t* header = static_cast<const uint32_t*>(map);
+  bool compressed = header[0] == PACKED_UNBUNDLE_MAGIC_LZ4;
+  if (!compressed && header[0] != PACKED_UNBUNDLE_MAGIC) {
+    throw std::runtime_error("Packed unbundle has wrong magic number");
+  }
+  uint32_t entryCount = header[1];
+  size_t entrySize = compressed ? 3 * sizeof(uint32_t) : 2 * sizeof(uint32_t);
+  if (HEADER_SIZE + (size_t)entryCount * entrySize > mapSize) {
+    throw std::runtime_error("Packed unbundle offset table is truncated");
+  }
+
+  // Normalize both table formats into one in-memory layout; 12 bytes per
+  // entry is nothing next to the payloads.
+  m_entries.reserve(entryCount);
+  const uint32_t* table = reinterpret_cast<const uint32_t*>(
+      static_cast<const char*>(map) + HEADER_SIZE);
+  for (uint32_t i = 0; i < entryCount; i++) {
+    Entry entry;
+    if (compressed) {
+      entry = {table[3 * i], table[3 * i + 1], table[3 * i + 2]};
+    } else {
+      entry = {table[2 * i], table[2 * i + 1], 0};
+    }
+    m_entries.push_back(entry);
+  }
+}
+
+PackedUnbundle::~PackedUnbundle() {
+  munmap(m_map, m_mapSize);
+}
+
+bool PackedUnbundle::isPackedUnbundle(const std::string& sourcePath) {
+  int fd = ::open(sourcePath.c_str(), O_RDONLY);
+  if (fd == -1) {
+    return false;
+  }
+  uint32_t magic = 0;
+  bool isPacked = ::read(fd, &magic, sizeof(magic)) == sizeof(magic) &&
+      (magic == PACKED_UNBUNDLE_MAGIC || magic == PACKED_UNBUNDLE_MAGIC_LZ4);
+  ::close(fd);
+  return isPacked;
+}
+
+std::unique_ptr<PackedUnbundle> PackedUnbundle::fromFile(const std::string& sourcePath) {
+  int fd = ::open(sourcePath.c_str(), O_RDONLY);
+  if (fd == -1) {
+    throw std::runtime_error("Couldn't open packed unbundle: " + sourcePath);
+  }
+
+  struct stat fileInfo;
+  if (::fstat(fd, &fileInfo) == -1) {
+    ::close(fd);
+    throw std::runtime_error("Couldn't stat packed unbundle: " + sourcePath);
+  }
+
+  void* map = mmap(nullptr, fileInfo.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (map == MAP_FAILED) {
+    throw std::runtime_error("Couldn't mmap packed unbundle: " + sourcePath);
+  }
+
+  return std::unique_ptr<PackedUnbundle>(
+      new PackedUnbundle(map, fileInfo.st_size, sourcePath));
+}
+
+const PackedUnbundle::Entry* PackedUnbundle::entryForId(uint32_t entryId) const {
+  if (entryId >= m_entries.size()) {
+    return nullptr;
+  }
+  const Entry* entry = &m_entries[entryId];
+  if (entry->length == 0 ||
+      (size_t)entry->offset + entry->length > m_mapSize) {
+    return nullptr;
+  }
+  return entry;
+}
+
+const char* PackedUnbundle::rawPayload(const Entry* entry) const {
+  const char* data = static_cast<const char*>(m_map) + entry->offset;
+  // The packer must NUL-terminate every raw payload; refuse the entry
+  // otherwise rather than handing JSC an unterminated buffer.
+  if (data[entry->length - 1] != '\0') {
+    return nullptr;
+  }
+  return data;
+}
+
+bool PackedUnbundle::decodeEntry(const Entry* entry, std::string* out) const {
+  out->resize(entry->rawLength);
+  const uint8_t* src = reinterpret_cast<const uint8_t*>(
+      static_cast<const char*>(m_map) + entry->offset);
+  if (!lz4DecodeBlock(src, entry->length,
+                      reinterpret_cast<uint8_t*>(&(*out)[0]),
+                      entry->rawLength) ||
+      entry->rawLength == 0 || (*out)[entry->rawLength - 1] != '\0') {
+    return false;
+  }
+  // Drop the trailing NUL from the logical size; c_str() still provides it.
+  out->resize(entry->rawLength - 1);
+  return true;
+}
+
+bool PackedUnbundle::getModuleRef(uint32_t moduleId, ModuleRef* ref) const {
+  const Entry* entry = entryForId(moduleId);
+  if (!entry || moduleId == 0) {
+    return false;
+  }
+
+  const char* code;
+  if (entry->rawLength == 0) {
+    code = rawPayload(entry);
+  } else {
+    // Prefer a payload the prefetcher already decoded; decode here otherwise.
+    // Either way the bytes go into the next pooled slot, which keeps them
+    // alive while JSC evaluates — a ref is only valid until a few more
+    // modules are decoded, which require-then-evaluate respects.
+    std::string decoded;
+    {
+      std::lock_guard<std::mutex> lock(m_stashMutex);
+      auto it = m_stash.find(moduleId);
+      if (it != m_stash.end()) {
+        decoded = std::move(it->second);
+        m_stash.erase(it);
+      }
+    }
+    if (decoded.empty() && !decodeEntry(entry, &decoded)) {
+      return false;
+    }
+    std::string& slot = m_decodeSlots[m_nextDecodeSlot];
+    m_nextDecodeSlot = (m_nextDecodeSlot + 1) % (sizeof(m_decodeSlots) / sizeof(m_decodeSlots[0]));
+    slot = std::move(decoded);
+    code = slot.c_str();
+  }
+
+  if (!code) {
+    return false;
+  }
+  ref->name = folly::to<std::string>(moduleId, ".js");
+  ref->code = code;
+  return true;
+}
+
+bool PackedUnbundle::prefetchModule(uint32_t moduleId) {
+  const Entry* entry = entryForId(moduleId);
+  if (!entry || moduleId == 0) {
+    // Matches getModuleRef: a bad id surfaces as ModuleNotFound at require
+    // time, not here.
+    return true;
+  }
+
+  if (entry->rawLength == 0) {
+    // Raw entry: the mapping is the storage, so walking the source is all the
+    // warming there is — it faults the pages in.
+    const char* code = rawPayload(entry);
+    if (code) {
+      (void) strlen(code);
+    }
+    return true;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_stashMutex);
+    if (m_stash.size() >= MAX_STASHED_MODULES ||
+        m_stash.count(moduleId) != 0) {
+      return true;
+    }
+  }
+  std::string decoded;
+  if (decodeEntry(entry, &decoded)) {
+    std::lock_guard<std::mutex> lock(m_stashMutex);
+    if (m_stash.size() < MAX_STASHED_MODULES) {
+      m_stash.emplace(moduleId, std::move(decoded));
+    }
+  }
+  return true;
+}
+
+bool PackedUnbundle::relayoutForRequireOrder(const std::vector<uint32_t>& requireOrder) {
+  if (m_sourcePath.empty() || m_entries.size() < 2) {
+    return false;
+  }
+
+  // Desired payload order: startup code stays first, profiled modules follow
+  // in require order, everything else keeps its relative position after them.
+  std::vector<uint32_t> order;
+  order.reserve(m_entries.size());
+  std::vector<bool> placed(m_entries.size(), false);
+  order.push_back(0);
+  placed[0] = true;
+  for (uint32_t id : requireOrder) {
+    if (id < m_entries.size() && !placed[id]) {
+      order.push_back(id);
+      placed[id] = true;
+    }
+  }
+  for (uint32_t id = 1; id < m_entries.size(); id++) {
+    if (!placed[id]) {
+      order.push_back(id);
+    }
+  }
+
+  // If offsets already run monotonically along the desired order, cold
+  // requires fault sequential pages as-is; skip the rewrite so a stable
+  // profile costs one pass over the table per run, not a file copy.
+  uint32_t previousOffset = 0;
+  bool monotone = true;
+  for (uint32_t id : order) {
+    if (m_entries[id].length == 0) {
+      continue;
+    }
+    if (m_entries[id].offset < previousOffset) {
+      monotone = false;
+      break;
+    }
+    previousOffset = m_entries[id].offset;
+  }
+  if (monotone) {
+    return false;
+  }
+
+  const uint32_t* header = static_cast<const uint32_t*>(m_map);
+  bool compressed = header[0] == PACKED_UNBUNDLE_MAGIC_LZ4;
+  size_t entrySize = compressed ? 3 * sizeof(uint32_t) : 2 * sizeof(uint32_t);
+  uint32_t tableEnd = HEADER_SIZE + m_entries.size() * entrySize;
+
+  // Recompute offsets for the new placement; ids (table positions), lengths
+  // and rawLengths are untouched, so readers see the same contract.
+  std::vector<Entry> newEntries = m_entries;
+  uint32_t cursor = tableEnd;
+  for (uint32_t id : order) {
+    newEntries[id].offset = m_entries[id].length == 0 ? tableEnd : cursor;
+    cursor += m_entries[id].length;
+  }
+
+  // Write-then-rename with an fsync in between, like the prefetcher's
+  // profile: a kill mid-rewrite leaves the old layout intact. The live
+  // mapping keeps reading the old inode either way.
+  std::string tmpPath = m_sourcePath + ".relayout";
+  FILE* out = fopen(tmpPath.c_str(), "wb");
+  if (out == nullptr) {
+    return false;
+  }
+  bool ok = fwrite(header, sizeof(uint32_t), 2, out) == 2;
+  for (size_t i = 0; ok && i < newEntries.size(); i++) {
+    uint32_t fields[3] = {newEntries[i].offset, newEntries[i].length, newEntries[i].rawLength};
+    ok = fwrite(fields, sizeof(uint32_t), entrySize / sizeof(uint32_t), out) ==
+        entrySize / sizeof(uint32_t);
+  }
+  for (uint32_t id : order) {
+    if (!ok) {
+      break;
+    }
+    const Entry& entry = m_entries[id];
+    if (entry.length == 0) {
+      continue;
+    }
+    ok = fwrite(static_cast<const char*>(m_map) + entry.offset, 1, entry.length, out) ==
+        entry.length;
+  }
+  ok = fflush(out) == 0 && ::fsync(fileno(out)) == 0 && ok;
+  fclose(out);
+
+  if (!ok || rename(tmpPath.c_str(), m_sourcePath.c_str()) != 0) {
+    unlink(tmpPath.c_str());
+    return false;
+  }
+  return true;
+}
+
+JSModulesUnbundle::Module PackedUnbundle::getModule(uint32_t moduleId) const {
+  ModuleRef ref;
+  if (!getModuleRef(moduleId, &ref)) {
+    throw ModuleNotFound(folly::to<std::string>("Module not found: ", moduleId, ".js"));
+  }
+  return {ref.name, std::string(ref.code)};
+}
+
+const char* PackedUnbundle::startupCode() const {
+  const Entry* entry = entryForId(0);
+  if (entry && entry->rawLength != 0) {
+    // Decoded once and kept for the unbundle's lifetime, like the mapped
+    // bytes it replaces.
+    if (m_startupDecoded.empty() && !decodeEntry(entry, &m_startupDecoded)) {
+      throw std::runtime_error("Packed unbundle startup code failed to decode");
+    }
+    return m_startupDecoded.c_str();
+  }
+  const char* code = entry ? rawPayload(entry) : nullptr;
+  if (!code) {
+    throw std::runtime_error("Packed unbundle has no startup code entry");
+  }
+  return code;
+}
+
+} }
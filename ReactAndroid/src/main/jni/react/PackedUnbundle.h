@@ -0,0 +1,118 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "JSModulesUnbundle.h"
+
+namespace facebook {
+namespace react {
+
+/**
+ * An unbundle packed into a single indexed file, mapped once with mmap.
+ *
+ * Layout (all integers little-endian):
+ *
+ *   [uint32]  magic 0xFB0BD1E5 (raw) or 0xFB0BD1E6 (LZ4-capable)
+ *   [uint32]  entry count (entry 0 is the startup code, entry i is module i)
+ *   raw:  entry count x { [uint32] offset, [uint32] length }
+ *   lz4:  entry count x { [uint32] offset, [uint32] length, [uint32] rawLength }
+ *   entry payloads
+ *
+ * Offsets are relative to the start of the file. A raw payload is stored with
+ * a trailing NUL (included in its length) so module source can be handed to
+ * JSC straight out of the mapping. In the LZ4-capable format, rawLength 0
+ * marks a payload stored raw (the packer skips compression for modules too
+ * small to win); otherwise the payload is one LZ4 block that decodes to
+ * exactly rawLength bytes, trailing NUL included. Module source dominates
+ * the pack, so compression typically shrinks the file ~3x, which is what
+ * cold requires on slow flash end up paying for.
+ *
+ * Compression happens in the packer at build time; this class only carries
+ * the decoder. Decoded modules land in a small pool of reusable buffers (a
+ * ref stays valid until a few more modules are decoded), and the prefetcher
+ * can decompress ahead of need via prefetchModule.
+ */
+class PackedUnbundle : public JSModulesUnbundle {
+public:
+  ~PackedUnbundle() override;
+
+  /**
+   * Cheaply checks whether the file at the given path starts with a packed
+   * unbundle magic.
+   */
+  static bool isPackedUnbundle(const std::string& sourcePath);
+
+  /**
+   * Maps the packed unbundle. Throws std::runtime_error if the file can't be
+   * opened or fails header validation.
+   */
+  static std::unique_ptr<PackedUnbundle> fromFile(const std::string& sourcePath);
+
+  Module getModule(uint32_t moduleId) const override;
+  bool getModuleRef(uint32_t moduleId, ModuleRef* ref) const override;
+
+  /**
+   * Decompresses the module into the prefetch stash (or faults a raw
+   * module's pages in), so the require that follows finds the bytes ready.
+   */
+  bool prefetchModule(uint32_t moduleId) override;
+
+  /**
+   * Rewrites the packed file with payloads laid out in the given require
+   * order (startup code first, unprofiled modules keeping their relative
+   * position after the profiled ones). The entry table stays id-indexed, so
+   * readers are unaffected; only placement changes, and with it which pages
+   * a cold start's require sequence faults. Write-then-rename beside the
+   * source path; the live mapping keeps reading the old inode. Skipped (and
+   * false) when offsets already run monotonically along the desired order.
+   */
+  bool relayoutForRequireOrder(const std::vector<uint32_t>& requireOrder) override;
+
+  /**
+   * The startup code (entry 0), null-terminated. Borrowed from the mapping
+   * when stored raw; decoded once and kept when compressed. Valid for the
+   * unbundle's lifetime either way.
+   */
+  const char* startupCode() const;
+
+private:
+  struct Entry {
+    uint32_t offset;
+    uint32_t length;
+    // Decoded size including the trailing NUL; 0 means stored raw.
+    uint32_t rawLength;
+  };
+
+  PackedUnbundle(void* map, size_t mapSize, const std::string& sourcePath);
+
+  const Entry* entryForId(uint32_t entryId) const;
+  const char* rawPayload(const Entry* entry) const;
+  bool decodeEntry(const Entry* entry, std::string* out) const;
+
+  void* m_map;
+  size_t m_mapSize;
+  // Retained for relayoutForRequireOrder's write-then-rename.
+  std::string m_sourcePath;
+  // Normalized from whichever on-disk table format the file carries.
+  std::vector<Entry> m_entries;
+
+  // Decoded-module plumbing. The stash holds modules the prefetcher decoded
+  // ahead of need, keyed by id and consumed (moved out) by the first require;
+  // the slots keep a consumed or freshly decoded payload alive while JSC
+  // evaluates it. The mutex covers the stash, which is the only state shared
+  // with the prefetch thread; the slots are JS-thread only.
+  mutable std::mutex m_stashMutex;
+  mutable std::unordered_map<uint32_t, std::string> m_stash;
+  mutable std::string m_decodeSlots[4];
+  mutable size_t m_nextDecodeSlot = 0;
+  mutable std::string m_startupDecoded;
+};
+
+} }
@@ -0,0 +1,108 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "ParallelJson.h"
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <folly/json.h>
+
+#include "NativeMessageQueueThread.h"
+
+namespace facebook {
+namespace react {
+namespace ParallelJson {
+
+namespace {
+
+// Below this many top-level elements the fan-out overhead (wakeups plus the
+// latch) costs more than it saves; measured crossover is a few dozen
+// medium-sized rows, so err high.
+const size_t kMinElementsForParallel = 64;
+
+// Two workers plus the calling thread saturates the encode on the big.LITTLE
+// devices we target without stealing every core from layout and rendering.
+const size_t kNumWorkers = 2;
+
+NativeMessageQueueThread* workerPool() {
+  // Created on first large payload, process-lifetime thereafter; idle
+  // workers just sit in a condition-variable wait.
+  static NativeMessageQueueThread pool[kNumWorkers];
+  return pool;
+}
+
+void encodeSegment(
+    const folly::dynamic& array,
+    size_t begin,
+    size_t end,
+    std::string* out) {
+  std::string result;
+  for (size_t i = begin; i < end; i++) {
+    if (i != begin) {
+      result += ',';
+    }
+    result += folly::toJson(array[i]).toStdString();
+  }
+  *out = std::move(result);
+}
+
+} // namespace
+
+std::string toJson(const folly::dynamic& value) {
+  if (!value.isArray() || value.size() < kMinElementsForParallel) {
+    return folly::toJson(value).toStdString();
+  }
+
+  size_t size = value.size();
+  const size_t numSegments = kNumWorkers + 1;
+  std::vector<std::string> segments(numSegments);
+
+  std::mutex doneMutex;
+  std::condition_variable doneCv;
+  size_t pendingSegments = kNumWorkers;
+
+  NativeMessageQueueThread* pool = workerPool();
+  for (size_t seg = 0; seg < kNumWorkers; seg++) {
+    size_t begin = size * seg / numSegments;
+    size_t end = size * (seg + 1) / numSegments;
+    std::string* out = &segments[seg];
+    pool[seg].runOnQueue(
+        [&value, begin, end, out, &doneMutex, &doneCv, &pendingSegments] {
+      encodeSegment(value, begin, end, out);
+      std::lock_guard<std::mutex> lock(doneMutex);
+      if (--pendingSegments == 0) {
+        doneCv.notify_one();
+      }
+    });
+  }
+
+  // The calling thread takes the last segment instead of idling on the
+  // latch.
+  encodeSegment(value, size * kNumWorkers / numSegments, size, &segments.back());
+
+  {
+    std::unique_lock<std::mutex> lock(doneMutex);
+    doneCv.wait(lock, [&pendingSegments] { return pendingSegments == 0; });
+  }
+
+  size_t totalSize = 2 + numSegments - 1;
+  for (const std::string& segment : segments) {
+    totalSize += segment.size();
+  }
+  std::string result;
+  result.reserve(totalSize);
+  result += '[';
+  for (size_t seg = 0; seg < numSegments; seg++) {
+    if (seg != 0) {
+      result += ',';
+    }
+    result += segments[seg];
+  }
+  result += ']';
+  return result;
+}
+
+} // namespace ParallelJson
+} }
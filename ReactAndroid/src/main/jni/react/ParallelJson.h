@@ -0,0 +1,29 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include <string>
+
+#include <folly/dynamic.h>
+
+namespace facebook {
+namespace react {
+
+/**
+ * JSON encoding for large outbound payloads.
+ *
+ * folly::toJson of a multi-hundred-KB batch (feed deliveries and the like)
+ * runs single-threaded on the JS queue with double-conversion dominating the
+ * profile. toJson below splits big top-level arrays into segments, encodes
+ * them concurrently on a small process-wide pool of
+ * NativeMessageQueueThreads, and concatenates the results -- element
+ * encodings are independent, so the concatenation is byte-identical to the
+ * serial output. Small values take the serial path untouched.
+ */
+namespace ParallelJson {
+
+std::string toJson(const folly::dynamic& value);
+
+} // namespace ParallelJson
+
+} }
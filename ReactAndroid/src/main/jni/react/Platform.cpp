@@ -17,10 +17,13 @@ namespace WebWorkerUtil {
 WebWorkerQueueFactory createWebWorkerThread;
 LoadScriptFromAssets loadScriptFromAssets;
 LoadScriptFromNetworkSync loadScriptFromNetworkSync;
+DownloadScriptToFileSync downloadScriptToFileSync;
 };
 
 namespace PerfLogging {
 InstallNativeHooks installNativeHooks;
+SetCurrentBatchId setCurrentBatchId;
+FlushMarkers flushMarkers;
 };
 
 namespace JSLogging {
@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <string>
@@ -32,11 +33,25 @@ extern LoadScriptFromAssets loadScriptFromAssets;
 
 using LoadScriptFromNetworkSync = std::function<std::string(const std::string& url, const std::string& tempfileName)>;
 extern LoadScriptFromNetworkSync loadScriptFromNetworkSync;
+
+// Like loadScriptFromNetworkSync, but leaves the downloaded file in place so
+// it can serve as a persistent cache entry (see WorkerScriptCache).
+using DownloadScriptToFileSync = std::function<void(const std::string& url, const std::string& filename)>;
+extern DownloadScriptToFileSync downloadScriptToFileSync;
 };
 
 namespace PerfLogging {
 using InstallNativeHooks = std::function<void(JSGlobalContextRef)>;
 extern InstallNativeHooks installNativeHooks;
+
+// Batch attribution for perf markers: the bridge tags the calling JS thread
+// with the id of the batch in flight and flushes the markers buffered under
+// it at each end-of-batch. Both are optional; check before calling.
+using SetCurrentBatchId = std::function<void(int64_t batchId)>;
+extern SetCurrentBatchId setCurrentBatchId;
+
+using FlushMarkers = std::function<void()>;
+extern FlushMarkers flushMarkers;
 };
 
 namespace JSLogging {
@@ -0,0 +1,105 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "ThreadScheduling.h"
+
+#include <errno.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "JSCHelpers.h"
+#include "Value.h"
+
+namespace facebook {
+namespace react {
+
+namespace {
+
+std::string g_applyResult = "not-configured";
+
+pid_t currentTid() {
+  return (pid_t)syscall(SYS_gettid);
+}
+
+static JSValueRef nativeThreadPlacement(
+    JSContextRef ctx,
+    JSObjectRef function,
+    JSObjectRef thisObject,
+    size_t argumentCount,
+    const JSValueRef arguments[],
+    JSValueRef* exception) {
+  return Value::fromJSON(ctx, String(folly::toJson(currentThreadPlacement()).c_str()));
+}
+
+} // namespace
+
+void applyJSThreadScheduling(const folly::dynamic& jscConfig) {
+  if (!jscConfig.isObject()) {
+    return;
+  }
+  const auto* scheduling = jscConfig.get_ptr("ThreadScheduling");
+  if (!scheduling || !scheduling->isObject()) {
+    return;
+  }
+
+  const pid_t tid = currentTid();
+  std::string result;
+
+  const auto* priority = scheduling->get_ptr("JSPriority");
+  if (priority && priority->isNumber()) {
+    // Nice is per-thread on Linux; raising priority (negative values) only
+    // works with CAP_SYS_NICE, so a denial here is expected on some builds.
+    result += setpriority(PRIO_PROCESS, tid, (int)priority->asInt()) == 0
+      ? "priority-applied;" : "priority-denied;";
+  }
+
+  const auto* affinity = scheduling->get_ptr("JSAffinity");
+  if (affinity && affinity->isArray()) {
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    for (const auto& cpu : *affinity) {
+      if (cpu.isNumber() && cpu.asInt() >= 0 && cpu.asInt() < CPU_SETSIZE) {
+        CPU_SET((int)cpu.asInt(), &cpus);
+      }
+    }
+    result += CPU_COUNT(&cpus) > 0 && sched_setaffinity(tid, sizeof(cpus), &cpus) == 0
+      ? "affinity-applied;" : "affinity-denied;";
+  }
+
+  if (!result.empty()) {
+    g_applyResult = result;
+  }
+}
+
+folly::dynamic currentThreadPlacement() {
+  const pid_t tid = currentTid();
+  folly::dynamic placement = folly::dynamic::object
+      ("tid", (int64_t)tid)
+      ("applied", g_applyResult);
+
+  errno = 0;
+  const int niceValue = getpriority(PRIO_PROCESS, tid);
+  if (errno == 0) {
+    placement["nice"] = niceValue;
+  }
+
+  cpu_set_t cpus;
+  if (sched_getaffinity(tid, sizeof(cpus), &cpus) == 0) {
+    folly::dynamic allowed = folly::dynamic::array;
+    for (int i = 0; i < CPU_SETSIZE; ++i) {
+      if (CPU_ISSET(i, &cpus)) {
+        allowed.push_back(i);
+      }
+    }
+    placement["cpus"] = std::move(allowed);
+  }
+
+  return placement;
+}
+
+void addThreadPlacementHooks(JSGlobalContextRef ctx) {
+  installGlobalFunction(ctx, "nativeThreadPlacement", nativeThreadPlacement);
+}
+
+} }
@@ -0,0 +1,39 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include <JavaScriptCore/JSContextRef.h>
+#include <folly/json.h>
+
+namespace facebook {
+namespace react {
+
+/**
+ * Applies the "ThreadScheduling" section of a jscConfig to the calling
+ * thread; runs first thing on the JS message queue thread so touch-driven
+ * JS work stops losing the CPU to background threads:
+ *
+ *   "ThreadScheduling": {
+ *     "JSPriority": -4,          // nice value; negative needs CAP_SYS_NICE
+ *     "JSAffinity": [4, 5, 6, 7] // CPU indices (big cores on big.LITTLE)
+ *   }
+ *
+ * Both knobs are best effort: a denied setpriority or sched_setaffinity is
+ * recorded in the placement, never fatal, so server-driven configs cannot
+ * break startup.
+ */
+void applyJSThreadScheduling(const folly::dynamic& jscConfig);
+
+/**
+ * The calling thread's actual placement for diagnostics: tid, nice value,
+ * allowed CPUs, and what applyJSThreadScheduling last reported.
+ */
+folly::dynamic currentThreadPlacement();
+
+/**
+ * Installs nativeThreadPlacement(), which returns the JS thread's placement
+ * as a JSON string.
+ */
+void addThreadPlacementHooks(JSGlobalContextRef ctx);
+
+} }
@@ -0,0 +1,134 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "TraceRecorder.h"
+
+#include <chrono>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <unistd.h>
+#include <sys/syscall.h>
+
+#include <folly/dynamic.h>
+#include <folly/json.h>
+
+namespace facebook {
+namespace react {
+namespace TraceRecorder {
+
+std::atomic<bool> enabled = ATOMIC_VAR_INIT(false);
+
+namespace {
+
+enum Phase : uint8_t {
+  PHASE_BEGIN = 0,
+  PHASE_END = 1,
+};
+
+struct Event {
+  uint64_t timeMicros;
+  uint16_t id;
+  uint8_t phase;
+};
+
+// Power of two; at ~32 bytes/record this is ~128KB per recorded thread,
+// holding several seconds of bridge activity.
+const size_t kEventCapacity = 4096;
+
+struct ThreadBuffer {
+  explicit ThreadBuffer(pid_t tid) : tid(tid) {}
+  pid_t tid;
+  Event events[kEventCapacity];
+  // Total events ever written; the ring holds the last kEventCapacity.
+  std::atomic<uint64_t> head = ATOMIC_VAR_INIT(0);
+};
+
+// Guards the name table and the buffer registry; never taken on the
+// recording fast path.
+std::mutex s_registryMutex;
+std::vector<std::string> s_eventNames;
+std::unordered_map<std::string, uint16_t> s_eventIds;
+std::vector<ThreadBuffer*> s_threadBuffers;
+
+// Buffers are registered once and deliberately never freed: a thread's last
+// events stay extractable even after it exits, and the recorder survives
+// thread teardown order issues. Bounded by thread count.
+ThreadBuffer* bufferForThisThread() {
+  static thread_local ThreadBuffer* buffer = nullptr;
+  if (!buffer) {
+    buffer = new ThreadBuffer((pid_t)syscall(SYS_gettid));
+    std::lock_guard<std::mutex> lock(s_registryMutex);
+    s_threadBuffers.push_back(buffer);
+  }
+  return buffer;
+}
+
+uint64_t nowMicros() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void record(uint16_t id, uint8_t phase) {
+  ThreadBuffer* buffer = bufferForThisThread();
+  uint64_t head = buffer->head.load(std::memory_order_relaxed);
+  Event& slot = buffer->events[head & (kEventCapacity - 1)];
+  slot.timeMicros = nowMicros();
+  slot.id = id;
+  slot.phase = phase;
+  buffer->head.store(head + 1, std::memory_order_release);
+}
+
+} // namespace
+
+void setEnabled(bool value) {
+  enabled.store(value, std::memory_order_relaxed);
+}
+
+uint16_t eventId(const char* name) {
+  std::lock_guard<std::mutex> lock(s_registryMutex);
+  auto it = s_eventIds.find(name);
+  if (it != s_eventIds.end()) {
+    return it->second;
+  }
+  uint16_t id = (uint16_t)s_eventNames.size();
+  s_eventNames.push_back(name);
+  s_eventIds.emplace(name, id);
+  return id;
+}
+
+void beginSection(uint16_t id) {
+  record(id, PHASE_BEGIN);
+}
+
+void endSection(uint16_t id) {
+  record(id, PHASE_END);
+}
+
+std::string dumpChromeTrace() {
+  folly::dynamic traceEvents = folly::dynamic::array();
+
+  std::lock_guard<std::mutex> lock(s_registryMutex);
+  for (ThreadBuffer* buffer : s_threadBuffers) {
+    uint64_t head = buffer->head.load(std::memory_order_acquire);
+    uint64_t start = head > kEventCapacity ? head - kEventCapacity : 0;
+    for (uint64_t i = start; i < head; i++) {
+      const Event& event = buffer->events[i & (kEventCapacity - 1)];
+      if (event.id >= s_eventNames.size()) {
+        continue; // torn slot from a concurrent writer
+      }
+      traceEvents.push_back(folly::dynamic::object
+          ("name", s_eventNames[event.id])
+          ("ph", event.phase == PHASE_BEGIN ? "B" : "E")
+          ("ts", event.timeMicros)
+          ("pid", (uint64_t)getpid())
+          ("tid", (uint64_t)buffer->tid)
+          ("cat", "bridge"));
+    }
+  }
+
+  return folly::toJson(folly::dynamic::object("traceEvents", std::move(traceEvents))).toStdString();
+}
+
+} // namespace TraceRecorder
+} }
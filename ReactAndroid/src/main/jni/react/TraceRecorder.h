@@ -0,0 +1,77 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace facebook {
+namespace react {
+
+/**
+ * In-process flight recorder for bridge trace sections.
+ *
+ * fbsystrace needs atrace enabled device-wide and formats strings per
+ * section; this recorder instead writes fixed-size (timestamp, event-id,
+ * phase) records into per-thread ring buffers, so the last seconds of bridge
+ * activity are always available for extraction after a jank. Event names are
+ * interned once; recording a section is an enabled-flag load, a clock read
+ * and a few stores — cheap enough to leave on in production.
+ *
+ * dumpChromeTrace() serializes whatever the rings currently hold into
+ * Chrome trace-event JSON (chrome://tracing, ts in microseconds).
+ */
+namespace TraceRecorder {
+
+extern std::atomic<bool> enabled;
+
+inline bool isEnabled() {
+  return enabled.load(std::memory_order_relaxed);
+}
+
+void setEnabled(bool value);
+
+/**
+ * Interns a section name, returning a stable id. Thread-safe; takes a lock,
+ * so cache the id where the name is known statically.
+ */
+uint16_t eventId(const char* name);
+
+void beginSection(uint16_t id);
+void endSection(uint16_t id);
+
+std::string dumpChromeTrace();
+
+/**
+ * RAII section marker. The string overload interns on every use and is meant
+ * for per-call names like tracing names off the bridge; prefer the id
+ * overload with a function-local static for fixed names.
+ */
+class Section {
+public:
+  explicit Section(uint16_t id) : m_id(id), m_active(isEnabled()) {
+    if (m_active) {
+      beginSection(m_id);
+    }
+  }
+  explicit Section(const char* name) : m_active(isEnabled()) {
+    if (m_active) {
+      m_id = eventId(name);
+      beginSection(m_id);
+    }
+  }
+  ~Section() {
+    if (m_active) {
+      endSection(m_id);
+    }
+  }
+
+private:
+  uint16_t m_id = 0;
+  bool m_active;
+};
+
+} // namespace TraceRecorder
+
+} }
@@ -0,0 +1,144 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "UnbundlePrefetcher.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <thread>
+#include <unistd.h>
+
+#include <glog/logging.h>
+
+namespace facebook {
+namespace react {
+
+namespace {
+
+// A profile longer than this stops predicting navigation requires and starts
+// re-reading the whole bundle; cap both what we replay and what we record.
+const size_t kMaxProfileModules = 512;
+
+std::vector<uint32_t> readProfile(const std::string& profilePath) {
+  std::vector<uint32_t> moduleIds;
+  std::ifstream profile(profilePath);
+  if (!profile) {
+    return moduleIds;
+  }
+  uint32_t moduleId;
+  while (moduleIds.size() < kMaxProfileModules && profile >> moduleId) {
+    moduleIds.push_back(moduleId);
+  }
+  return moduleIds;
+}
+
+void writeProfile(const std::string& profilePath, const std::vector<uint32_t>& moduleIds) {
+  // Write-then-rename so a kill mid-write leaves last run's profile intact
+  // rather than a truncated one.
+  std::string tmpPath = profilePath + ".tmp";
+  {
+    std::ofstream profile(tmpPath);
+    if (!profile) {
+      return;
+    }
+    for (uint32_t moduleId : moduleIds) {
+      profile << moduleId << "\n";
+    }
+  }
+  if (rename(tmpPath.c_str(), profilePath.c_str()) != 0) {
+    unlink(tmpPath.c_str());
+  }
+}
+
+} // namespace
+
+UnbundlePrefetcher::~UnbundlePrefetcher() {
+  shutdown();
+}
+
+void UnbundlePrefetcher::start(JSModulesUnbundle* unbundle, const std::string& profilePath) {
+  if (profilePath.empty() || m_state) {
+    return;
+  }
+  m_profilePath = profilePath;
+  m_state = std::make_shared<State>();
+  m_state->unbundle = unbundle;
+
+  std::vector<uint32_t> moduleIds = readProfile(profilePath);
+  if (moduleIds.empty()) {
+    // First run (or profile wiped): nothing to warm, but keep recording so
+    // the next run has a profile.
+    return;
+  }
+
+  auto state = m_state;
+  std::thread([state, moduleIds] {
+    for (uint32_t moduleId : moduleIds) {
+      std::lock_guard<std::mutex> lock(state->mutex);
+      if (!state->unbundle) {
+        return;
+      }
+      try {
+        if (state->unbundle->prefetchModule(moduleId)) {
+          // Backend with its own warming (e.g. a compressed packed unbundle
+          // decoding ahead of need) has already done the work.
+          continue;
+        }
+        JSModulesUnbundle::ModuleRef moduleRef;
+        if (state->unbundle->getModuleRef(moduleId, &moduleRef)) {
+          // Mapped backend: the ref is just pointer math, so walk the source
+          // to fault its pages in.
+          (void) strlen(moduleRef.code);
+        } else {
+          // File backend: getModule does the read, which is all the warming
+          // there is to do; the bytes land in the OS file cache.
+          state->unbundle->getModule(moduleId);
+        }
+      } catch (JSModulesUnbundle::ModuleNotFound&) {
+        // A stale profile from an older bundle; skip the id and keep going.
+      }
+    }
+
+    // With the whole profile warmed, let the backend rewrite its on-disk
+    // layout to match it, so the next cold boot's early requires fault
+    // sequential pages that readahead already pulled in. Runs under the
+    // state lock so shutdown can't free the unbundle mid-rewrite.
+    std::lock_guard<std::mutex> lock(state->mutex);
+    if (state->unbundle) {
+      state->unbundle->relayoutForRequireOrder(moduleIds);
+    }
+  }).detach();
+}
+
+void UnbundlePrefetcher::recordRequire(uint32_t moduleId) {
+  if (!m_state || m_recorded.size() >= kMaxProfileModules) {
+    return;
+  }
+  m_recorded.push_back(moduleId);
+}
+
+void UnbundlePrefetcher::shutdown() {
+  if (!m_state) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    m_state->unbundle = nullptr;
+  }
+  m_state.reset();
+  if (!m_recorded.empty()) {
+    writeProfile(m_profilePath, m_recorded);
+    m_recorded.clear();
+  }
+}
+
+/* static */
+std::string UnbundlePrefetcher::profilePathFor(const std::string& cacheDir) {
+  if (cacheDir.empty()) {
+    return "";
+  }
+  return cacheDir + "/rn-require-profile";
+}
+
+} }
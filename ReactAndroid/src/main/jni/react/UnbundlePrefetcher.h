@@ -0,0 +1,75 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "JSModulesUnbundle.h"
+#include "noncopyable.h"
+
+namespace facebook {
+namespace react {
+
+/**
+ * Warms unbundle modules on a background thread so first-time requires hit
+ * RAM instead of stalling the JS thread on I/O.
+ *
+ * The prefetcher records the order in which modules are required during a
+ * run and persists it beside the device cache dir. On the next run it replays
+ * that profile off-thread right after the startup bundle finishes loading,
+ * warming each module so that by the time JS requires it the bytes are in
+ * the page cache (mapped unbundles), already decompressed (compressed packed
+ * unbundles), or at least in warm file cache (per-module file unbundles).
+ * Navigation pushes are the usual beneficiary:
+ * they require a burst of scene modules that the previous run's profile
+ * predicts almost exactly.
+ */
+class UnbundlePrefetcher : public noncopyable {
+public:
+  ~UnbundlePrefetcher();
+
+  /**
+   * Loads the profile at profilePath (if any) and starts warming the listed
+   * modules on a detached background thread. The unbundle must stay valid
+   * until shutdown() is called. An empty profilePath disables both
+   * prefetching and profile persistence.
+   */
+  void start(JSModulesUnbundle* unbundle, const std::string& profilePath);
+
+  /**
+   * Records a first-time require. Called from the JS thread on every
+   * nativeRequire; the recorded order becomes next run's profile.
+   */
+  void recordRequire(uint32_t moduleId);
+
+  /**
+   * Detaches the background thread from the unbundle and persists the
+   * require order recorded this run. Must be called (on the JS thread)
+   * before the unbundle is destroyed.
+   */
+  void shutdown();
+
+  /**
+   * Returns the profile path for a device cache dir, or an empty string if
+   * cacheDir is empty.
+   */
+  static std::string profilePathFor(const std::string& cacheDir);
+
+private:
+  // Shared with the background thread; the mutex makes shutdown() safe to
+  // race with an in-flight module read.
+  struct State {
+    std::mutex mutex;
+    JSModulesUnbundle* unbundle{nullptr};
+  };
+
+  std::shared_ptr<State> m_state;
+  std::string m_profilePath;
+  std::vector<uint32_t> m_recorded;
+};
+
+} }
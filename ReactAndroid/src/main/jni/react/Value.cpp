@@ -2,11 +2,87 @@
 
 #include "Value.h"
 
+#include <cstring>
+
+#include <folly/dynamic.h>
+
 #include "JSCHelpers.h"
 
 namespace facebook {
 namespace react {
 
+namespace {
+
+// The dispatch path reads the same few property names over and over
+// (__fbBatchedBridge, flushedQueue, ...), and each access used to pay a
+// JSStringCreateWithUTF8CString allocation. JSStringRefs are
+// context-independent, so the names are interned instead: well-known bridge
+// names are pinned for the life of the process and anything else shares a
+// small least-recently-used table. Caches are per-thread for the same reason
+// as the toStringPiece buffer.
+const char* const kPinnedPropertyNames[] = {
+  "__fbBatchedBridge",
+  "callFunctionReturnFlushedQueue",
+  "invokeCallbackAndReturnFlushedQueue",
+  "processBatchReturnFlushedQueue",
+  "flushedQueue",
+  "Array",
+  "length",
+  "data",
+  "buffers",
+  "onmessage",
+};
+const size_t kPinnedPropertyNameCount =
+    sizeof(kPinnedPropertyNames) / sizeof(kPinnedPropertyNames[0]);
+const size_t kRecentPropertyNameCount = 16;
+
+// Returns a JSStringRef owned by the cache (wrap with String::ref to use);
+// valid at least until the next intern on the same thread can evict it.
+JSStringRef internPropertyName(const char* utf8) {
+  static thread_local JSStringRef pinned[kPinnedPropertyNameCount] = {};
+  for (size_t i = 0; i < kPinnedPropertyNameCount; i++) {
+    if (strcmp(kPinnedPropertyNames[i], utf8) == 0) {
+      if (!pinned[i]) {
+        pinned[i] = JSStringCreateWithUTF8CString(utf8);
+      }
+      return pinned[i];
+    }
+  }
+
+  struct RecentEntry {
+    std::string name;
+    JSStringRef ref;
+    uint64_t lastUse;
+  };
+  static thread_local std::vector<RecentEntry> recent;
+  static thread_local uint64_t useClock = 0;
+
+  ++useClock;
+  size_t victim = 0;
+  for (size_t i = 0; i < recent.size(); i++) {
+    if (recent[i].name == utf8) {
+      recent[i].lastUse = useClock;
+      return recent[i].ref;
+    }
+    if (recent[i].lastUse < recent[victim].lastUse) {
+      victim = i;
+    }
+  }
+
+  JSStringRef ref = JSStringCreateWithUTF8CString(utf8);
+  if (recent.size() < kRecentPropertyNameCount) {
+    recent.push_back(RecentEntry{utf8, ref, useClock});
+  } else {
+    JSStringRelease(recent[victim].ref);
+    recent[victim].name = utf8;
+    recent[victim].ref = ref;
+    recent[victim].lastUse = useClock;
+  }
+  return ref;
+}
+
+} // namespace
+
 Value::Value(JSContextRef context, JSValueRef value) :
   m_context(context),
   m_value(value)
@@ -24,6 +100,19 @@ JSContextRef Value::context() const {
   return m_context;
 }
 
+folly::StringPiece String::toStringPiece() const {
+  // One buffer per thread so JS, worker, and native-module threads don't
+  // stomp each other's in-flight conversions. Grows to the largest string
+  // seen on the thread and stays there.
+  static thread_local std::vector<char> buffer;
+  size_t reserved = utf8Size();
+  if (buffer.size() < reserved) {
+    buffer.resize(reserved);
+  }
+  size_t length = JSStringGetUTF8CString(m_string.get(), buffer.data(), reserved) - 1;
+  return folly::StringPiece(buffer.data(), length);
+}
+
 std::string Value::toJSONString(unsigned indent) const {
   JSValueRef exn;
   auto stringToAdopt = JSValueCreateJSONString(m_context, m_value, indent, &exn);
@@ -43,6 +132,93 @@ Value Value::fromJSON(JSContextRef ctx, const String& json) {
   return Value(ctx, result);
 }
 
+static JSValueRef valueRefFromDynamic(JSContextRef ctx, const folly::dynamic& value) {
+  switch (value.type()) {
+    case folly::dynamic::NULLT:
+      return JSValueMakeNull(ctx);
+    case folly::dynamic::BOOL:
+      return JSValueMakeBoolean(ctx, value.getBool());
+    case folly::dynamic::INT64:
+      return JSValueMakeNumber(ctx, value.getInt());
+    case folly::dynamic::DOUBLE:
+      return JSValueMakeNumber(ctx, value.getDouble());
+    case folly::dynamic::STRING:
+      return JSValueMakeString(ctx, String(value.getString().c_str()));
+    case folly::dynamic::ARRAY: {
+      std::vector<JSValueRef> elements;
+      elements.reserve(value.size());
+      for (auto& element : value) {
+        elements.push_back(valueRefFromDynamic(ctx, element));
+      }
+      JSValueRef exn;
+      JSObjectRef arr = JSObjectMakeArray(ctx, elements.size(), elements.data(), &exn);
+      if (!arr) {
+        std::string exceptionText = Value(ctx, exn).toString().str();
+        throwJSExecutionException("Failed to make JS array: %s", exceptionText.c_str());
+      }
+      return arr;
+    }
+    case folly::dynamic::OBJECT: {
+      Object obj = Object::create(ctx);
+      for (auto& entry : value.items()) {
+        obj.setProperty(
+            String(entry.first.asString().c_str()),
+            Value(ctx, valueRefFromDynamic(ctx, entry.second)));
+      }
+      return obj;
+    }
+  }
+  throwJSExecutionException("Unsupported dynamic type: %s", value.typeName());
+  return JSValueMakeUndefined(ctx);
+}
+
+/* static */
+Value Value::fromDynamic(JSContextRef ctx, const folly::dynamic& value) {
+  return Value(ctx, valueRefFromDynamic(ctx, value));
+}
+
+folly::dynamic Value::toDynamic() const {
+  switch (JSValueGetType(m_context, m_value)) {
+    case kJSTypeUndefined:
+    case kJSTypeNull:
+      return nullptr;
+    case kJSTypeBoolean:
+      return asBoolean();
+    case kJSTypeNumber:
+      return asNumber();
+    case kJSTypeString:
+      return String::adopt(JSValueToStringCopy(m_context, m_value, nullptr)).str();
+    case kJSTypeObject:
+      break;
+  }
+
+  JSObjectRef obj = JSValueToObject(m_context, m_value, nullptr);
+  // Not all JSC revisions we build against have JSValueIsArray, so use an
+  // instanceof check against the global Array constructor instead.
+  JSObjectRef arrayConstructor = JSValueToObject(
+      m_context, Object::getGlobalObject(m_context).getProperty("Array"), nullptr);
+  if (arrayConstructor &&
+      JSValueIsInstanceOfConstructor(m_context, m_value, arrayConstructor, nullptr)) {
+    folly::dynamic result = folly::dynamic::array();
+    unsigned length =
+        Value(m_context, Object(m_context, obj).getProperty("length")).asUnsignedInteger();
+    for (unsigned i = 0; i < length; i++) {
+      result.push_back(Object(m_context, obj).getPropertyAtIndex(i).toDynamic());
+    }
+    return result;
+  }
+
+  folly::dynamic result = folly::dynamic::object();
+  auto namesRef = JSObjectCopyPropertyNames(m_context, obj);
+  size_t count = JSPropertyNameArrayGetCount(namesRef);
+  for (size_t i = 0; i < count; i++) {
+    auto key = String::ref(JSPropertyNameArrayGetNameAtIndex(namesRef, i));
+    result[key.str()] = Object(m_context, obj).getProperty(key).toDynamic();
+  }
+  JSPropertyNameArrayRelease(namesRef);
+  return result;
+}
+
 Object Value::asObject() {
   JSValueRef exn;
   JSObjectRef jsObj = JSValueToObject(context(), m_value, &exn);
@@ -95,7 +271,7 @@ Value Object::getPropertyAtIndex(unsigned index) const {
 }
 
 Value Object::getProperty(const char *propName) const {
-  return getProperty(String(propName));
+  return getProperty(String::ref(internPropertyName(propName)));
 }
 
 void Object::setProperty(const String& propName, const Value& value) const {
@@ -108,7 +284,7 @@ void Object::setProperty(const String& propName, const Value& value) const {
 }
 
 void Object::setProperty(const char *propName, const Value& value) const {
-  setProperty(String(propName), value);
+  setProperty(String::ref(internPropertyName(propName)), value);
 }
 
 std::vector<std::string> Object::getPropertyNames() const {
@@ -7,17 +7,29 @@
 #include <unordered_map>
 #include <vector>
 
+#include <folly/Range.h>
+
 #include <JavaScriptCore/JSObjectRef.h>
 #include <JavaScriptCore/JSRetainPtr.h>
 #include <JavaScriptCore/JSStringRef.h>
 #include <JavaScriptCore/JSValueRef.h>
 
+#ifdef JSC_HAS_TYPED_ARRAY_API
+#include <JavaScriptCore/JSTypedArray.h>
+#endif
+
 #include "noncopyable.h"
 
 #if WITH_FBJSCEXTENSIONS
 #include <jsc_stringref.h>
 #endif
 
+namespace folly {
+
+struct dynamic;
+
+}
+
 namespace facebook {
 namespace react {
 
@@ -52,12 +64,25 @@ public:
     return JSStringGetMaximumUTF8CStringSize(m_string.get());
   }
 
+  /**
+   * UTF-8 view of the string, converted into a reusable per-thread buffer so
+   * no heap allocation happens after warmup. The backing buffer is
+   * NUL-terminated just past the view. Only valid until the next
+   * toStringPiece() call on the same thread; copy (or use str()) to keep it.
+   */
+  folly::StringPiece toStringPiece() const;
+
+  /**
+   * Direct pointer into JSC's internal UTF-16 buffer: zero-copy, length()
+   * characters, not NUL-terminated, valid while this String is alive. Lets
+   * UTF-16 consumers (e.g. JNI's NewString) skip the UTF-8 round trip.
+   */
+  const JSChar* utf16() const {
+    return JSStringGetCharactersPtr(m_string.get());
+  }
+
   std::string str() const {
-    size_t reserved = utf8Size();
-    char* bytes = new char[reserved];
-    size_t length = JSStringGetUTF8CString(m_string.get(), bytes, reserved) - 1;
-    std::unique_ptr<char[]> retainedBytes(bytes);
-    return std::string(bytes, length);
+    return toStringPiece().str();
   }
 
   // Assumes that utf8 is null terminated
@@ -142,6 +167,56 @@ public:
     }
   }
 
+  /**
+   * Private-data slot access. Only objects created from a JSClass (e.g. a
+   * custom global object class) carry the slot; setPrivate on anything else
+   * is a no-op returning false.
+   */
+  void* getPrivate() const {
+    return JSObjectGetPrivate(m_obj);
+  }
+
+  bool setPrivate(void* data) const {
+    return JSObjectSetPrivate(m_obj, data);
+  }
+
+#ifdef JSC_HAS_TYPED_ARRAY_API
+  /**
+   * Typed-array access, for binary payloads that cross the bridge without a
+   * base64/JSON round trip.
+   */
+  bool isTypedArray() const {
+    return JSValueGetTypedArrayType(m_context, m_obj, nullptr) !=
+        kJSTypedArrayTypeNone;
+  }
+
+  /**
+   * Direct pointer into the array's backing store, with its byte length in
+   * *size. Valid only while the array is alive and until control returns to
+   * JS (the VM may move or detach the buffer); copy to keep.
+   */
+  void* typedArrayBytes(size_t* size) const {
+    *size = JSObjectGetTypedArrayByteLength(m_context, m_obj, nullptr);
+    return JSObjectGetTypedArrayBytesPtr(m_context, m_obj, nullptr);
+  }
+
+  /**
+   * Wraps externally owned bytes as a Uint8Array without copying. The VM
+   * calls bytesDeallocator(bytes, deallocatorContext) when the array is
+   * collected; the bytes must stay valid until then.
+   */
+  static Object makeTypedArrayNoCopy(
+      JSContextRef ctx,
+      void* bytes,
+      size_t size,
+      JSTypedArrayBytesDeallocator bytesDeallocator,
+      void* deallocatorContext) {
+    return Object(ctx, JSObjectMakeTypedArrayWithBytesNoCopy(
+        ctx, kJSTypedArrayTypeUint8Array, bytes, size,
+        bytesDeallocator, deallocatorContext, nullptr));
+  }
+#endif
+
   static Object getGlobalObject(JSContextRef ctx) {
     auto globalObj = JSContextGetGlobalObject(ctx);
     return Object(ctx, globalObj);
@@ -219,6 +294,18 @@ public:
 
   std::string toJSONString(unsigned indent = 0) const;
   static Value fromJSON(JSContextRef ctx, const String& json);
+
+  /**
+   * Builds a JSValueRef tree directly from a folly::dynamic, without
+   * serializing through an intermediate JSON string.
+   */
+  static Value fromDynamic(JSContextRef ctx, const folly::dynamic& value);
+
+  /**
+   * Reads this value back into a folly::dynamic, without going through
+   * JSValueCreateJSONString/parseJson.
+   */
+  folly::dynamic toDynamic() const;
 protected:
   JSContextRef context() const;
   JSContextRef m_context;
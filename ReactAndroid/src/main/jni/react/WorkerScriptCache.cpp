@@ -0,0 +1,136 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "WorkerScriptCache.h"
+
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <unistd.h>
+#include <unordered_set>
+
+#include <folly/Conv.h>
+#include <folly/String.h>
+#include <glog/logging.h>
+
+#include "JSCSourceCache.h"
+#include "Platform.h"
+
+namespace facebook {
+namespace react {
+namespace WorkerScriptCache {
+
+namespace {
+
+// URLs with a fetch currently in flight, either from prefetchScript or from a
+// concurrent loadScript for the same worker script.
+std::mutex s_fetchMutex;
+std::condition_variable s_fetchCv;
+std::unordered_set<std::string> s_fetchesInFlight;
+
+bool isNetworkUrl(const std::string& script) {
+  return script.find("http://") == 0 || script.find("https://") == 0;
+}
+
+std::string cachePathForUrl(const std::string& scriptUrl, const std::string& cacheDir) {
+  // Content-addressed by URL hash rather than worker id, so the same script
+  // started twice (or across app launches) maps to the same cache entry.
+  uint64_t urlHash = JSCSourceCache::hashBundle(scriptUrl.c_str(), scriptUrl.size());
+  return folly::to<std::string>(cacheDir, "/rn-worker-", folly::hexlify(
+      folly::ByteRange((const uint8_t*)&urlHash, sizeof(urlHash))), ".js");
+}
+
+bool readCachedScript(const std::string& cachePath, std::string* scriptSrc) {
+  std::ifstream cacheFile(cachePath);
+  if (!cacheFile) {
+    return false;
+  }
+  std::stringstream buffer;
+  buffer << cacheFile.rdbuf();
+  *scriptSrc = buffer.str();
+  return true;
+}
+
+/**
+ * Downloads scriptUrl into its cache entry unless another thread is already
+ * doing so, in which case waits for that fetch to finish instead.
+ */
+void fetchIntoCache(const std::string& scriptUrl, const std::string& cachePath) {
+  {
+    std::unique_lock<std::mutex> lock(s_fetchMutex);
+    if (s_fetchesInFlight.count(scriptUrl)) {
+      s_fetchCv.wait(lock, [&] {
+        return s_fetchesInFlight.count(scriptUrl) == 0;
+      });
+      return;
+    }
+    s_fetchesInFlight.insert(scriptUrl);
+  }
+
+  // Downloading straight to cachePath makes the fetch double as cache
+  // population; a crashed download is cleaned up so a torn file is never
+  // served on the next launch.
+  try {
+    WebWorkerUtil::downloadScriptToFileSync(scriptUrl, cachePath);
+  } catch (...) {
+    unlink(cachePath.c_str());
+    std::lock_guard<std::mutex> lock(s_fetchMutex);
+    s_fetchesInFlight.erase(scriptUrl);
+    s_fetchCv.notify_all();
+    throw;
+  }
+
+  std::lock_guard<std::mutex> lock(s_fetchMutex);
+  s_fetchesInFlight.erase(scriptUrl);
+  s_fetchCv.notify_all();
+}
+
+} // namespace
+
+std::string loadScript(const std::string& scriptUrlOrAssetName, const std::string& cacheDir) {
+  if (!isNetworkUrl(scriptUrlOrAssetName)) {
+    // TODO(9604438): Protect against script does not exist
+    return WebWorkerUtil::loadScriptFromAssets(scriptUrlOrAssetName);
+  }
+
+  auto cachePath = cachePathForUrl(scriptUrlOrAssetName, cacheDir);
+
+  std::string scriptSrc;
+  if (readCachedScript(cachePath, &scriptSrc)) {
+    return scriptSrc;
+  }
+
+  fetchIntoCache(scriptUrlOrAssetName, cachePath);
+
+  if (!readCachedScript(cachePath, &scriptSrc)) {
+    // The shared fetch we waited on failed; fall back to a plain download so
+    // this worker still comes up.
+    scriptSrc = WebWorkerUtil::loadScriptFromNetworkSync(scriptUrlOrAssetName, cachePath);
+  }
+  return scriptSrc;
+}
+
+void prefetchScript(const std::string& scriptUrl, const std::string& cacheDir) {
+  if (!isNetworkUrl(scriptUrl) || cacheDir.empty()) {
+    return;
+  }
+
+  auto cachePath = cachePathForUrl(scriptUrl, cacheDir);
+  std::thread([scriptUrl, cachePath] {
+    std::string ignored;
+    if (readCachedScript(cachePath, &ignored)) {
+      return;
+    }
+    try {
+      fetchIntoCache(scriptUrl, cachePath);
+    } catch (const std::exception& e) {
+      // Prefetch is best-effort; the worker launch path will retry.
+      LOG(WARNING) << "Worker script prefetch for " << scriptUrl
+                   << " failed: " << e.what();
+    }
+  }).detach();
+}
+
+} // namespace WorkerScriptCache
+} }
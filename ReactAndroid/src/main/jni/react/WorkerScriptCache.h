@@ -0,0 +1,39 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include <string>
+
+namespace facebook {
+namespace react {
+
+/**
+ * Persistent, content-addressed cache for web worker scripts.
+ *
+ * Worker scripts fetched from the network used to be downloaded synchronously
+ * on the worker's message queue thread into a throwaway temp file on every
+ * launch. The cache keys downloaded scripts by a hash of their URL under the
+ * device cache dir, so repeat launches start from warm bytes, and exposes a
+ * background prefetch so a script can be warming while the app does other
+ * startup work. Concurrent requests for the same URL share one download
+ * instead of serializing behind each other.
+ */
+namespace WorkerScriptCache {
+
+/**
+ * Returns the worker script source, fetching and caching it if needed.
+ * Network URLs go through the cache; plain asset names fall through to
+ * WebWorkerUtil::loadScriptFromAssets. Blocks if a prefetch for the same URL
+ * is already in flight rather than downloading twice.
+ */
+std::string loadScript(const std::string& scriptUrlOrAssetName, const std::string& cacheDir);
+
+/**
+ * Starts fetching the given script URL into the cache on a background
+ * thread. No-op if the script is already cached or a fetch is in flight.
+ */
+void prefetchScript(const std::string& scriptUrl, const std::string& cacheDir);
+
+} // namespace WorkerScriptCache
+
+} }
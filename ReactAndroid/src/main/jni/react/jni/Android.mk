@@ -10,6 +10,7 @@ LOCAL_SRC_FILES := \
   JSCPerfLogging.cpp \
   JSLoader.cpp \
   JSLogging.cpp \
+  JStringCache.cpp \
   JniJSModulesUnbundle.cpp \
   NativeArray.cpp \
   OnLoad.cpp \
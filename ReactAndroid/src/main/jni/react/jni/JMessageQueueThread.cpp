@@ -12,13 +12,70 @@ namespace facebook {
 namespace react {
 
 JMessageQueueThread::JMessageQueueThread(alias_ref<JavaMessageQueueThread::javaobject> jobj) :
-    m_jobj(make_global(jobj)) {
+    m_jobj(make_global(jobj)),
+    m_queues(std::make_shared<TierQueues>()) {
 }
 
-void JMessageQueueThread::runOnQueue(std::function<void()>&& runnable) {
+void JMessageQueueThread::runOnQueue(MessageQueueTask&& runnable) {
+  runOnQueue(TaskPriority::Normal, std::move(runnable));
+}
+
+void JMessageQueueThread::runOnQueue(TaskPriority priority, MessageQueueTask&& runnable) {
+  if (priority == TaskPriority::Idle) {
+    bool wasEmpty;
+    {
+      std::lock_guard<std::mutex> lock(m_queues->idleLock);
+      wasEmpty = m_queues->idleTasks.empty();
+      m_queues->idleTasks.push_back(std::move(runnable));
+    }
+    // If idle work was already pending, a drain is on its way and will get
+    // to this task (or bail and hand off to the drain scheduled by whatever
+    // higher-priority push preempted it).
+    if (wasEmpty) {
+      scheduleDrain();
+    }
+    return;
+  }
+
+  // Tasks go through a lock-free MPSC queue per tier; only the push that
+  // finds its queue empty pays for a JNativeRunnable allocation and the JNI
+  // hop. Tasks posted while a drain is pending ride along with it.
+  MpscTaskQueue& queue = priority == TaskPriority::Immediate
+      ? m_queues->immediate : m_queues->normal;
+  if (queue.push(std::move(runnable))) {
+    scheduleDrain();
+  }
+}
+
+void JMessageQueueThread::scheduleDrain() {
   static auto method = JavaMessageQueueThread::javaClassStatic()->
     getMethod<void(Runnable::javaobject)>("runOnQueue");
-  method(m_jobj, JNativeRunnable::newObjectCxxArgs(runnable).get());
+  // The drain runnable holds the queues alive via shared_ptr in case this
+  // JMessageQueueThread is destroyed while the runnable is still queued.
+  std::shared_ptr<TierQueues> queues = m_queues;
+  std::function<void()> drain = [queues] {
+    queues->immediate.drain();
+    queues->normal.drain();
+    // Idle tasks run strictly in gaps: one at a time, and only while no
+    // higher-priority work has shown up. The emptiness checks are racy, but
+    // a push that slips past one has scheduled its own drain, so bailing
+    // here never strands work.
+    while (queues->immediate.isEmpty() && queues->normal.isEmpty()) {
+      MessageQueueTask task;
+      {
+        std::lock_guard<std::mutex> lock(queues->idleLock);
+        if (queues->idleTasks.empty()) {
+          return;
+        }
+        task = std::move(queues->idleTasks.front());
+        queues->idleTasks.pop_front();
+      }
+      task();
+    }
+    // Preempted by higher-priority work; its drain picks up the remaining
+    // idle tasks once the queues go quiet again.
+  };
+  method(m_jobj, JNativeRunnable::newObjectCxxArgs(std::move(drain)).get());
 }
 
 bool JMessageQueueThread::isOnThread() {
@@ -2,9 +2,13 @@
 
 #pragma once
 
+#include <deque>
 #include <functional>
+#include <memory>
+#include <mutex>
 
 #include <react/MessageQueueThread.h>
+#include <react/MpscTaskQueue.h>
 
 #include <jni/fbjni.h>
 
@@ -23,9 +27,17 @@ public:
   JMessageQueueThread(alias_ref<JavaMessageQueueThread::javaobject> jobj);
 
   /**
-   * Enqueues the given function to run on this MessageQueueThread.
+   * Enqueues the given function to run on this MessageQueueThread at normal
+   * priority.
    */
-  void runOnQueue(std::function<void()>&& runnable) override;
+  void runOnQueue(MessageQueueTask&& runnable) override;
+
+  /**
+   * Enqueues the given function on the given priority tier. Immediate tasks
+   * overtake normal work already queued; idle tasks only run in gaps, when
+   * neither higher tier has work pending.
+   */
+  void runOnQueue(TaskPriority priority, MessageQueueTask&& runnable) override;
 
   /**
    * Returns whether the currently executing thread is this MessageQueueThread.
@@ -47,7 +59,23 @@ public:
    */
   static std::unique_ptr<JMessageQueueThread> currentMessageQueueThread();
 private:
+  /**
+   * The per-tier task storage, shared with in-flight drain runnables so
+   * queued tasks stay alive if this JMessageQueueThread is destroyed first.
+   * The idle tier is a plain locked deque: it is cold by definition, and the
+   * drain needs to pop one task at a time so it can yield between tasks.
+   */
+  struct TierQueues {
+    MpscTaskQueue immediate;
+    MpscTaskQueue normal;
+    std::mutex idleLock;
+    std::deque<MessageQueueTask> idleTasks;
+  };
+
+  void scheduleDrain();
+
   global_ref<JavaMessageQueueThread::javaobject> m_jobj;
+  std::shared_ptr<TierQueues> m_queues;
 };
 
 class MessageQueueThreadRegistry : public jni::JavaClass<MessageQueueThreadRegistry> {
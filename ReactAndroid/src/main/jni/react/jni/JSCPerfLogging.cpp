@@ -2,6 +2,8 @@
 
 #include "JSCPerfLogging.h"
 
+#include <vector>
+
 #include <fb/log.h>
 #include <jni/fbjni.h>
 #include <react/JSCHelpers.h>
@@ -49,6 +51,12 @@ class JObjectWrapper<jqpl> : public JObjectWrapper<jobject> {
     markerCancelMethod(this_, markerId, instanceKey);
   }
 
+  void markerBatch(jlongArray markers) {
+    static auto markerBatchMethod =
+      qplClass()->getMethod<void(jlongArray)>("markerBatch");
+    markerBatchMethod(this_, markers);
+  }
+
   int64_t currentMonotonicTimestamp() {
     static auto currentTimestampMethod =
       qplClass()->getMethod<int64_t()>("currentMonotonicTimestamp");
@@ -117,6 +125,70 @@ static bool isReady() {
   return ready;
 }
 
+// Six jlong slots per buffered marker: kind, markerId, instanceKey,
+// actionId, timestamp, bridge batch id. Keep in sync with
+// QuickPerformanceLogger#markerBatch.
+static const size_t kMarkerLongs = 6;
+static const int64_t kNoBatch = -1;
+
+enum MarkerKind : jlong {
+  kMarkerStart = 0,
+  kMarkerEnd = 1,
+  kMarkerNote = 2,
+  kMarkerCancel = 3,
+};
+
+// Thread-confined: each JS thread (main executor, web workers) buffers its
+// own markers and flushes them at its own batch boundaries, so none of this
+// needs locking.
+static thread_local std::vector<jlong> tl_pendingMarkers;
+static thread_local int64_t tl_currentBatchId = kNoBatch;
+
+static bool bufferingMarkers() {
+  return tl_currentBatchId != kNoBatch;
+}
+
+static void bufferMarker(
+    MarkerKind kind,
+    int32_t markerId,
+    int32_t instanceKey,
+    int16_t actionId,
+    int64_t timestamp) {
+  tl_pendingMarkers.push_back(kind);
+  tl_pendingMarkers.push_back(markerId);
+  tl_pendingMarkers.push_back(instanceKey);
+  tl_pendingMarkers.push_back(actionId);
+  tl_pendingMarkers.push_back(timestamp);
+  tl_pendingMarkers.push_back(tl_currentBatchId);
+}
+
+// Replays buffered markers one JNI call at a time, for QPL implementations
+// that predate markerBatch; batch attribution is lost but no marker is
+// dropped.
+static void replayPendingMarkers() {
+  auto qpl = JQuickPerformanceLoggerProvider::get();
+  for (size_t i = 0; i + kMarkerLongs <= tl_pendingMarkers.size(); i += kMarkerLongs) {
+    int32_t markerId = (int32_t) tl_pendingMarkers[i + 1];
+    int32_t instanceKey = (int32_t) tl_pendingMarkers[i + 2];
+    int16_t actionId = (int16_t) tl_pendingMarkers[i + 3];
+    int64_t timestamp = tl_pendingMarkers[i + 4];
+    switch ((MarkerKind) tl_pendingMarkers[i]) {
+      case kMarkerStart:
+        qpl->markerStart(markerId, instanceKey, timestamp);
+        break;
+      case kMarkerEnd:
+        qpl->markerEnd(markerId, instanceKey, actionId, timestamp);
+        break;
+      case kMarkerNote:
+        qpl->markerNote(markerId, instanceKey, actionId, timestamp);
+        break;
+      case kMarkerCancel:
+        qpl->markerCancel(markerId, instanceKey);
+        break;
+    }
+  }
+}
+
 // After having read the implementation of PNaN that is returned from JSValueToNumber, and some
 // more material on how NaNs are constructed, I think this is the most consistent way to verify
 // NaN with how we generate it.
@@ -158,7 +230,11 @@ static JSValueRef nativeQPLMarkerStart(
     int32_t markerId = (int32_t) targets[0];
     int32_t instanceKey = (int32_t) targets[1];
     int64_t timestamp = (int64_t) targets[2];
-    JQuickPerformanceLoggerProvider::get()->markerStart(markerId, instanceKey, timestamp);
+    if (bufferingMarkers()) {
+      bufferMarker(kMarkerStart, markerId, instanceKey, 0, timestamp);
+    } else {
+      JQuickPerformanceLoggerProvider::get()->markerStart(markerId, instanceKey, timestamp);
+    }
   }
   return JSValueMakeUndefined(ctx);
 }
@@ -176,7 +252,11 @@ static JSValueRef nativeQPLMarkerEnd(
     int32_t instanceKey = (int32_t) targets[1];
     int16_t actionId = (int16_t) targets[2];
     int64_t timestamp = (int64_t) targets[3];
-    JQuickPerformanceLoggerProvider::get()->markerEnd(markerId, instanceKey, actionId, timestamp);
+    if (bufferingMarkers()) {
+      bufferMarker(kMarkerEnd, markerId, instanceKey, actionId, timestamp);
+    } else {
+      JQuickPerformanceLoggerProvider::get()->markerEnd(markerId, instanceKey, actionId, timestamp);
+    }
   }
   return JSValueMakeUndefined(ctx);
 }
@@ -194,7 +274,11 @@ static JSValueRef nativeQPLMarkerNote(
     int32_t instanceKey = (int32_t) targets[1];
     int16_t actionId = (int16_t) targets[2];
     int64_t timestamp = (int64_t) targets[3];
-    JQuickPerformanceLoggerProvider::get()->markerNote(markerId, instanceKey, actionId, timestamp);
+    if (bufferingMarkers()) {
+      bufferMarker(kMarkerNote, markerId, instanceKey, actionId, timestamp);
+    } else {
+      JQuickPerformanceLoggerProvider::get()->markerNote(markerId, instanceKey, actionId, timestamp);
+    }
   }
   return JSValueMakeUndefined(ctx);
 }
@@ -210,7 +294,11 @@ static JSValueRef nativeQPLMarkerCancel(
   if (isReady() && grabDoubles(2, targets, ctx, argumentCount, arguments, exception)) {
     int32_t markerId = (int32_t) targets[0];
     int32_t instanceKey = (int32_t) targets[1];
-    JQuickPerformanceLoggerProvider::get()->markerCancel(markerId, instanceKey);
+    if (bufferingMarkers()) {
+      bufferMarker(kMarkerCancel, markerId, instanceKey, 0, 0);
+    } else {
+      JQuickPerformanceLoggerProvider::get()->markerCancel(markerId, instanceKey);
+    }
   }
   return JSValueMakeUndefined(ctx);
 }
@@ -241,4 +329,38 @@ void addNativePerfLoggingHooks(JSGlobalContextRef ctx) {
   installGlobalFunction(ctx, "nativeQPLTimestamp", nativeQPLTimestamp);
 }
 
+void setPerfMarkerBatchId(int64_t batchId) {
+  tl_currentBatchId = batchId;
+}
+
+void flushPerfMarkers() {
+  if (tl_pendingMarkers.empty()) {
+    return;
+  }
+  if (!isReady()) {
+    // Same policy as the unbatched path: markers recorded before QPL is up
+    // are dropped.
+    tl_pendingMarkers.clear();
+    return;
+  }
+  static bool batchSupported = true;
+  if (batchSupported) {
+    try {
+      auto markers = make_long_array(tl_pendingMarkers.size());
+      markers->setRegion(0, tl_pendingMarkers.size(), tl_pendingMarkers.data());
+      JQuickPerformanceLoggerProvider::get()->markerBatch(markers.get());
+    } catch (...) {
+      // The installed QPL predates markerBatch; replay one call per marker
+      // from here on.
+      FBLOGE("QuickPerformanceLogger has no markerBatch; replaying markers individually.");
+      batchSupported = false;
+    }
+  }
+  if (!batchSupported) {
+    replayPendingMarkers();
+  }
+  // clear() keeps the capacity for the next batch.
+  tl_pendingMarkers.clear();
+}
+
 } }
@@ -2,10 +2,28 @@
 
 #pragma once
 
+#include <cstdint>
+
 #include <JavaScriptCore/JSContextRef.h>
 namespace facebook {
 namespace react {
 
 void addNativePerfLoggingHooks(JSGlobalContextRef ctx);
 
+/**
+ * Tags markers recorded on the calling thread from here on with the given
+ * bridge batch id and switches them from immediate JNI forwarding to a
+ * native buffer. Threads that never get a batch id (web workers before
+ * their first flush, the initial bundle load) keep forwarding markers one
+ * at a time as before.
+ */
+void setPerfMarkerBatchId(int64_t batchId);
+
+/**
+ * Flushes the calling thread's buffered markers to Java in a single JNI
+ * call; see QuickPerformanceLogger#markerBatch for the packing. Called by
+ * the bridge at each end-of-batch.
+ */
+void flushPerfMarkers();
+
 } }
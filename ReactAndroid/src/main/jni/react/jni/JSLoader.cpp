@@ -4,11 +4,17 @@
 
 #include <android/asset_manager_jni.h>
 #include <jni/Environment.h>
+#include <condition_variable>
 #include <fstream>
+#include <mutex>
 #include <sstream>
 #include <streambuf>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <fb/log.h>
+#include <react/JSCSourceCache.h>
+#include <react/PackedUnbundle.h>
 #ifdef WITH_FBSYSTRACE
 #include <fbsystrace.h>
 using fbsystrace::FbSystraceSection;
@@ -59,6 +65,52 @@ std::string loadScriptFromAssets(
   return "";
 }
 
+std::unique_ptr<const JSBigString> loadScriptFromAssetsMapped(
+    AAssetManager *manager,
+    const std::string& assetName) {
+  #ifdef WITH_FBSYSTRACE
+  FbSystraceSection s(TRACE_TAG_REACT_CXX_BRIDGE, "reactbridge_jni_loadScriptFromAssetsMapped",
+    "assetName", assetName);
+  #endif
+  if (manager) {
+    auto asset = AAssetManager_open(
+      manager,
+      assetName.c_str(),
+      AASSET_MODE_RANDOM); // Fine for mmap; the fallback reads sequentially anyway
+    if (asset) {
+      // Uncompressed assets are stored as plain file regions in the APK and
+      // can be mapped directly; openFileDescriptor fails for compressed ones.
+      off_t offset, length;
+      int fd = AAsset_openFileDescriptor(asset, &offset, &length);
+      if (fd >= 0) {
+        auto mapped = JSBigFileString::fromDescriptor(fd, offset, length);
+        close(fd);
+        if (mapped) {
+          AAsset_close(asset);
+          return mapped;
+        }
+      }
+      AAsset_close(asset);
+    }
+  }
+  // Compressed asset (or mapping failed): fall back to the copying loader.
+  return std::unique_ptr<const JSBigString>(
+      new JSBigStdString(loadScriptFromAssets(manager, assetName)));
+}
+
+std::unique_ptr<const JSBigString> loadScriptFromFileMapped(const std::string& fileName) {
+  #ifdef WITH_FBSYSTRACE
+  FbSystraceSection s(TRACE_TAG_REACT_CXX_BRIDGE, "reactbridge_jni_loadScriptFromFileMapped",
+    "fileName", fileName);
+  #endif
+  auto mapped = JSBigFileString::fromPath(fileName);
+  if (mapped) {
+    return mapped;
+  }
+  return std::unique_ptr<const JSBigString>(
+      new JSBigStdString(loadScriptFromFile(fileName)));
+}
+
 std::string loadScriptFromFile(const std::string& fileName) {
   #ifdef WITH_FBSYSTRACE
   FbSystraceSection s(TRACE_TAG_REACT_CXX_BRIDGE, "reactbridge_jni_loadScriptFromFile",
@@ -80,6 +132,65 @@ std::string loadScriptFromFile(const std::string& fileName) {
   return "";
 }
 
+namespace {
+
+struct PreloadedBundle {
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool done = false;
+  std::unique_ptr<const JSBigString> script;
+};
+
+// In-flight pre-loads keyed by file path; entries are claimed (and removed)
+// by takePreloadedScript.
+std::mutex gPreloadsMutex;
+std::unordered_map<std::string, std::shared_ptr<PreloadedBundle>> gPreloads;
+
+}
+
+void preloadScriptFromFile(const std::string& fileName) {
+  if (PackedUnbundle::isPackedUnbundle(fileName)) {
+    // Packed unbundles go through their own load path (and the unbundle
+    // prefetcher already warms them); nothing would claim the result.
+    return;
+  }
+  auto pending = std::make_shared<PreloadedBundle>();
+  {
+    std::lock_guard<std::mutex> lock(gPreloadsMutex);
+    if (!gPreloads.emplace(fileName, pending).second) {
+      // Already in flight (or finished and unclaimed) for this file.
+      return;
+    }
+  }
+  std::thread([pending, fileName] {
+    auto script = loadScriptFromFileMapped(fileName);
+    // Hashing doubles as verification and page warming: every byte is
+    // touched here, so a mapped bundle is resident (and known readable) by
+    // the time JSC parses it on the JS thread.
+    uint64_t hash = JSCSourceCache::hashBundle(script->c_str(), script->size());
+    std::lock_guard<std::mutex> lock(pending->mutex);
+    pending->script.reset(new JSBigPreHashedString(std::move(script), hash));
+    pending->done = true;
+    pending->cv.notify_all();
+  }).detach();
+}
+
+std::unique_ptr<const JSBigString> takePreloadedScript(const std::string& fileName) {
+  std::shared_ptr<PreloadedBundle> pending;
+  {
+    std::lock_guard<std::mutex> lock(gPreloadsMutex);
+    auto it = gPreloads.find(fileName);
+    if (it == gPreloads.end()) {
+      return nullptr;
+    }
+    pending = std::move(it->second);
+    gPreloads.erase(it);
+  }
+  std::unique_lock<std::mutex> lock(pending->mutex);
+  pending->cv.wait(lock, [&pending] { return pending->done; });
+  return std::move(pending->script);
+}
+
 void registerJSLoaderNatives() {
   JNIEnv *env = jni::Environment::current();
   jclass applicationHolderClass = env->FindClass("com/facebook/react/common/ApplicationHolder");
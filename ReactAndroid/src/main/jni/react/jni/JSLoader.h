@@ -3,9 +3,12 @@
 #pragma once
 
 #include <android/asset_manager.h>
+#include <memory>
 #include <string>
 #include <jni.h>
 
+#include <react/JSBigString.h>
+
 namespace facebook {
 namespace react {
 
@@ -25,6 +28,38 @@ std::string loadScriptFromAssets(AAssetManager *assetManager, const std::string&
  */
 std::string loadScriptFromFile(const std::string& fileName);
 
+/**
+ * Loads a JS script from an android asset as an mmap-backed buffer when the
+ * asset is stored uncompressed, falling back to a copying read otherwise.
+ * Unlike the std::string loaders above, no intermediate copies are made.
+ */
+std::unique_ptr<const JSBigString> loadScriptFromAssetsMapped(
+    AAssetManager *assetManager,
+    const std::string& assetName);
+
+/**
+ * Loads a JS script from a file as an mmap-backed buffer, falling back to a
+ * copying read if the file cannot be mapped.
+ */
+std::unique_ptr<const JSBigString> loadScriptFromFileMapped(const std::string& fileName);
+
+/**
+ * Starts loading the given bundle file on a background thread, overlapping
+ * the read (or map), page warming, and the bytecode-cache hash with
+ * Java-side bridge construction. A no-op if a pre-load for the same file is
+ * already in flight. OTA-style flows should call this as soon as the bundle
+ * path is known; loadScriptFromFile picks the result up automatically.
+ */
+void preloadScriptFromFile(const std::string& fileName);
+
+/**
+ * Claims the result of preloadScriptFromFile for the given file, waiting for
+ * the background stage if it hasn't finished. The returned script carries
+ * the precomputed bundle hash (see JSBigString::precomputedHash). Returns
+ * nullptr if no pre-load was started for the file.
+ */
+std::unique_ptr<const JSBigString> takePreloadedScript(const std::string& fileName);
+
 void registerJSLoaderNatives();
 
 } }
@@ -28,7 +28,9 @@ JSValueRef nativeLoggingHook(
   if (argumentCount > 0) {
     JSStringRef jsString = JSValueToStringCopy(ctx, arguments[0], NULL);
     String message = String::adopt(jsString);
-    FBLOG_PRI(logLevel, "ReactNativeJS", "%s", message.str().c_str());
+    // toStringPiece's backing buffer is NUL-terminated, so the piece data
+    // doubles as a C string without the std::string copy str() would make.
+    FBLOG_PRI(logLevel, "ReactNativeJS", "%s", message.toStringPiece().data());
   }
   return JSValueMakeUndefined(ctx);
 }
@@ -0,0 +1,60 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "JStringCache.h"
+
+#include <mutex>
+#include <unordered_map>
+
+#include <jni/LocalString.h>
+
+namespace facebook {
+namespace react {
+namespace JStringCache {
+
+namespace {
+
+// Map keys across a feed of similar rows repeat endlessly but the overall
+// vocabulary stays small; past this size we assume we are being fed payload
+// data and stop interning so the cache can't pin arbitrary Java heap.
+const size_t kMaxCachedStrings = 512;
+
+std::mutex s_cacheMutex;
+std::unordered_map<std::string, jstring> s_cache;
+
+jstring createLocal(JNIEnv* env, const std::string& value) {
+  jni::LocalString str(value.c_str());
+  return static_cast<jstring>(env->NewLocalRef(str.string()));
+}
+
+} // namespace
+
+jstring get(JNIEnv* env, const std::string& value) {
+  {
+    std::lock_guard<std::mutex> lock(s_cacheMutex);
+    auto it = s_cache.find(value);
+    if (it != s_cache.end()) {
+      return it->second;
+    }
+  }
+
+  // Conversion happens outside the lock; worst case a race converts the same
+  // value twice and the loser's insert finds the winner's entry.
+  jstring local = createLocal(env, value);
+
+  std::lock_guard<std::mutex> lock(s_cacheMutex);
+  auto it = s_cache.find(value);
+  if (it != s_cache.end()) {
+    env->DeleteLocalRef(local);
+    return it->second;
+  }
+  if (s_cache.size() >= kMaxCachedStrings) {
+    return local;
+  }
+  auto global = static_cast<jstring>(env->NewGlobalRef(local));
+  env->DeleteLocalRef(local);
+  s_cache.emplace(value, global);
+  return global;
+}
+
+} // namespace JStringCache
+} }
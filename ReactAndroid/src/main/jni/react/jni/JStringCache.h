@@ -0,0 +1,29 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include <jni.h>
+#include <string>
+
+namespace facebook {
+namespace react {
+
+/**
+ * Memoizing cache for the small, stable vocabulary of strings we hand to
+ * Java over and over — perf marker names and map keys. Each distinct value
+ * is converted to a Java string once and pinned as a global reference, so
+ * steady-state bridge traffic stops minting (and garbage-collecting)
+ * thousands of identical short-lived java.lang.Strings.
+ */
+namespace JStringCache {
+
+/**
+ * Returns a Java string for the given value. The reference is owned by the
+ * cache (or, once the cache is full, by the current local frame) — callers
+ * must not delete it, but may pass it to Java calls or return it to Java.
+ */
+jstring get(JNIEnv* env, const std::string& value);
+
+} // namespace JStringCache
+
+} }
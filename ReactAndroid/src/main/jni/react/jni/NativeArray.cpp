@@ -2,12 +2,175 @@
 
 #include "NativeArray.h"
 
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
 #include <jni/fbjni.h>
+#include <jni/fbjni/ByteBuffer.h>
 #include <folly/json.h>
 
 namespace facebook {
 namespace react {
 
+/*
+ * Typed payload encoding, little-endian:
+ *
+ *   value  := tag:uint8 payload
+ *   tag    := 0 null | 1 false | 2 true | 3 double (8 bytes)
+ *           | 4 int32 (4 bytes) | 5 string (uint32 length + utf8 bytes)
+ *           | 6 array (uint32 count + count values)
+ *           | 7 map (uint32 count + count (string-payload, value) pairs)
+ *           | 8 keyed map (uint32 count + count (keyId:uint32, value) pairs)
+ *
+ * The top-level payload is the array encoded as a single tag-6 value. The
+ * keyed export prefixes the value with uint32 newKeyCount + that many
+ * string-payloads, the dictionary entries assigned since the count the
+ * caller reported. Keep in sync with the decoders in
+ * ReadableNativeArray.java and ReadableNativeMap.java.
+ */
+namespace {
+
+enum PayloadTag : uint8_t {
+  TAG_NULL = 0,
+  TAG_FALSE = 1,
+  TAG_TRUE = 2,
+  TAG_DOUBLE = 3,
+  TAG_INT32 = 4,
+  TAG_STRING = 5,
+  TAG_ARRAY = 6,
+  TAG_MAP = 7,
+  TAG_KEYED_MAP = 8,
+};
+
+template<typename T>
+void appendRaw(std::string& out, const T& value) {
+  out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void appendStringPayload(std::string& out, const std::string& str) {
+  appendRaw(out, (uint32_t)str.size());
+  out.append(str);
+}
+
+void appendValue(std::string& out, const folly::dynamic& value) {
+  switch (value.type()) {
+    case folly::dynamic::NULLT:
+      out.push_back((char)TAG_NULL);
+      break;
+    case folly::dynamic::BOOL:
+      out.push_back((char)(value.getBool() ? TAG_TRUE : TAG_FALSE));
+      break;
+    case folly::dynamic::INT64: {
+      int64_t asInt = value.getInt();
+      if (asInt == (int32_t)asInt) {
+        out.push_back((char)TAG_INT32);
+        appendRaw(out, (int32_t)asInt);
+      } else {
+        // Java reads everything numeric as double anyway; keep the wider
+        // range rather than truncating.
+        out.push_back((char)TAG_DOUBLE);
+        appendRaw(out, (double)asInt);
+      }
+      break;
+    }
+    case folly::dynamic::DOUBLE:
+      out.push_back((char)TAG_DOUBLE);
+      appendRaw(out, value.getDouble());
+      break;
+    case folly::dynamic::STRING:
+      out.push_back((char)TAG_STRING);
+      appendStringPayload(out, value.getString());
+      break;
+    case folly::dynamic::ARRAY:
+      out.push_back((char)TAG_ARRAY);
+      appendRaw(out, (uint32_t)value.size());
+      for (auto& elem : value) {
+        appendValue(out, elem);
+      }
+      break;
+    case folly::dynamic::OBJECT:
+      out.push_back((char)TAG_MAP);
+      appendRaw(out, (uint32_t)value.size());
+      for (auto& pair : value.items()) {
+        // Non-string keys can't come off the bridge, but folly allows them;
+        // stringify so the payload stays well-formed.
+        appendStringPayload(
+            out, pair.first.isString() ? pair.first.getString() : pair.first.asString());
+        appendValue(out, pair.second);
+      }
+      break;
+  }
+}
+
+// Interned-key dictionary for the keyed map export. Ids are assigned in
+// first-appearance order and never reused, so a decoder only ever needs the
+// entries past the count it already mirrors. Guarded by the caller of
+// appendValueKeyed holding gKeyDictionaryMutex; exports can come from any
+// thread.
+std::mutex gKeyDictionaryMutex;
+std::vector<std::string> gKeyDictionary;
+std::unordered_map<std::string, uint32_t> gKeyIds;
+
+uint32_t internKey(const std::string& key) {
+  auto it = gKeyIds.find(key);
+  if (it != gKeyIds.end()) {
+    return it->second;
+  }
+  uint32_t id = (uint32_t)gKeyDictionary.size();
+  gKeyDictionary.push_back(key);
+  gKeyIds.emplace(key, id);
+  return id;
+}
+
+void appendValueKeyed(std::string& out, const folly::dynamic& value) {
+  switch (value.type()) {
+    case folly::dynamic::ARRAY:
+      out.push_back((char)TAG_ARRAY);
+      appendRaw(out, (uint32_t)value.size());
+      for (auto& elem : value) {
+        appendValueKeyed(out, elem);
+      }
+      break;
+    case folly::dynamic::OBJECT:
+      out.push_back((char)TAG_KEYED_MAP);
+      appendRaw(out, (uint32_t)value.size());
+      for (auto& pair : value.items()) {
+        appendRaw(out, internKey(
+            pair.first.isString() ? pair.first.getString() : pair.first.asString()));
+        appendValueKeyed(out, pair.second);
+      }
+      break;
+    default:
+      // Scalars encode identically in both variants.
+      appendValue(out, value);
+      break;
+  }
+}
+
+} // namespace
+
+std::string encodeKeyedPayload(const folly::dynamic& value, uint32_t knownKeys) {
+  std::lock_guard<std::mutex> lock(gKeyDictionaryMutex);
+  if (knownKeys > gKeyDictionary.size()) {
+    knownKeys = (uint32_t)gKeyDictionary.size();
+  }
+
+  // Encode first; interning during the walk assigns ids to any new keys,
+  // which the prefix then carries.
+  std::string body;
+  appendValueKeyed(body, value);
+
+  std::string payload;
+  appendRaw(payload, (uint32_t)(gKeyDictionary.size() - knownKeys));
+  for (size_t i = knownKeys; i < gKeyDictionary.size(); i++) {
+    appendStringPayload(payload, gKeyDictionary[i]);
+  }
+  payload.append(body);
+  return payload;
+}
+
 NativeArray::NativeArray(folly::dynamic a)
     : array(std::move(a)) {
   if (!array.isArray()) {
@@ -24,9 +187,36 @@ jstring NativeArray::toString() {
   return jni::make_jstring(folly::toJson(array).c_str()).release();
 }
 
+std::string NativeArray::encodeTypedPayload() {
+  if (isConsumed) {
+    jni::throwNewJavaException("com/facebook/react/bridge/ObjectAlreadyConsumedException",
+                               "Array already consumed");
+  }
+  std::string payload;
+  appendValue(payload, array);
+  return payload;
+}
+
+jint NativeArray::writeTypedPayload(jni::alias_ref<jni::JByteBuffer> byteBuffer) {
+  if (!byteBuffer->isDirect()) {
+    jni::throwNewJavaException("java/lang/IllegalArgumentException",
+                               "expected a direct ByteBuffer");
+  }
+
+  std::string payload = encodeTypedPayload();
+
+  if (byteBuffer->getDirectSize() < payload.size()) {
+    return -(jint)payload.size();
+  }
+
+  std::memcpy(byteBuffer->getDirectBytes(), payload.data(), payload.size());
+  return (jint)payload.size();
+}
+
 void NativeArray::registerNatives() {
   registerHybrid({
     makeNativeMethod("toString", NativeArray::toString),
+    makeNativeMethod("writeTypedPayload", NativeArray::writeTypedPayload),
   });
 }
 
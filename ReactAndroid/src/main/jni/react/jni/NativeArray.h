@@ -3,6 +3,7 @@
 #pragma once
 
 #include <jni/fbjni.h>
+#include <jni/fbjni/ByteBuffer.h>
 #include <folly/dynamic.h>
 
 namespace facebook {
@@ -19,6 +20,22 @@ class NativeArray : public jni::HybridClass<NativeArray> {
 
   jstring toString();
 
+  /**
+   * Writes the array as a compact typed binary encoding into a direct
+   * ByteBuffer, so large payloads can cross the JNI boundary once instead of
+   * being serialized to JSON text and re-parsed in Java. Returns the number
+   * of bytes written, or the negated required size if the buffer is too small
+   * (the caller should reallocate and retry).
+   */
+  jint writeTypedPayload(jni::alias_ref<jni::JByteBuffer> byteBuffer);
+
+  /**
+   * Encodes the array in the typed binary format used by writeTypedPayload;
+   * shared with the pinned-array bulk export on ReadableNativeArray. Throws
+   * if the array has already been consumed.
+   */
+  std::string encodeTypedPayload();
+
   static void registerNatives();
 
  protected:
@@ -26,4 +43,15 @@ class NativeArray : public jni::HybridClass<NativeArray> {
   explicit NativeArray(folly::dynamic array);
 };
 
+/**
+ * Keyed variant of the typed payload encoding, used by the map bulk export:
+ * object keys are written as uint32 ids into a process-wide interned-key
+ * dictionary, so the style and config property names that repeat across
+ * every map cross the boundary as 4 bytes after their first appearance.
+ * The payload is prefixed with the dictionary entries assigned past
+ * knownKeys, letting the decoder's mirror of the dictionary catch up before
+ * it reads the value.
+ */
+std::string encodeKeyedPayload(const folly::dynamic& value, uint32_t knownKeys);
+
 }}
@@ -1,5 +1,10 @@
 // Copyright 2004-present Facebook. All Rights Reserved.
 
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+
 #include <android/asset_manager_jni.h>
 #include <android/input.h>
 #include <fb/log.h>
@@ -15,7 +20,10 @@
 #include <react/Bridge.h>
 #include <react/Executor.h>
 #include <react/JSCExecutor.h>
+#include <react/BundleDelta.h>
+#include <react/JSBigString.h>
 #include <react/JSModulesUnbundle.h>
+#include <react/PackedUnbundle.h>
 #include <react/MethodCall.h>
 #include <react/Platform.h>
 #include "JExecutorToken.h"
@@ -28,6 +36,7 @@
 #include "JMessageQueueThread.h"
 #include "JniJSModulesUnbundle.h"
 #include "JSLogging.h"
+#include "JStringCache.h"
 #include "JSCPerfLogging.h"
 #include "WebWorkers.h"
 #include <algorithm>
@@ -214,6 +223,23 @@ jobject ReadableNativeArray::getType(jint index) {
   return type::getType(array.at(index).type());
 }
 
+jint ReadableNativeArray::exportTypedPayload(jbyteArray buffer) {
+  // Encode before pinning: no allocation, JNI call or exception may happen
+  // inside the critical window.
+  std::string payload = encodeTypedPayload();
+
+  JNIEnv* env = Environment::current();
+  jsize capacity = env->GetArrayLength(buffer);
+  if (static_cast<size_t>(capacity) < payload.size()) {
+    return -(jint)payload.size();
+  }
+
+  void* pinned = env->GetPrimitiveArrayCritical(buffer, nullptr);
+  memcpy(pinned, payload.data(), payload.size());
+  env->ReleasePrimitiveArrayCritical(buffer, pinned, 0);
+  return (jint)payload.size();
+}
+
 void ReadableNativeArray::registerNatives() {
   jni::registerNatives("com/facebook/react/bridge/ReadableNativeArray", {
     makeNativeMethod("size", ReadableNativeArray::getSize),
@@ -227,6 +253,8 @@ void ReadableNativeArray::registerNatives() {
                      ReadableNativeArray::getMap),
     makeNativeMethod("getType", "(I)Lcom/facebook/react/bridge/ReadableType;",
                      ReadableNativeArray::getType),
+    makeNativeMethod("exportTypedPayload", "([B)I",
+                     ReadableNativeArray::exportTypedPayload),
   });
 }
 
@@ -497,6 +525,25 @@ static jobject getValueType(JNIEnv* env, jobject obj, jstring keyName) {
   return type::getType(getMapValue(env, obj, keyName).type());
 }
 
+static jint exportKeyedPayload(JNIEnv* env, jobject obj, jbyteArray buffer, jint knownKeys) {
+  auto nativeMap = extractRefPtr<NativeMap>(env, obj);
+  exceptions::throwIfObjectAlreadyConsumed(nativeMap, "Map already consumed");
+
+  // Nothing may allocate, call into JNI or throw while the array is pinned,
+  // so the payload is fully built first.
+  std::string payload = encodeKeyedPayload(nativeMap->map, (uint32_t)std::max(knownKeys, 0));
+
+  jsize capacity = env->GetArrayLength(buffer);
+  if (static_cast<size_t>(capacity) < payload.size()) {
+    return -(jint)payload.size();
+  }
+
+  void* pinned = env->GetPrimitiveArrayCritical(buffer, nullptr);
+  memcpy(pinned, payload.data(), payload.size());
+  env->ReleasePrimitiveArrayCritical(buffer, pinned, 0);
+  return (jint)payload.size();
+}
+
 } // namespace readable
 
 namespace iterator {
@@ -520,9 +567,11 @@ static jstring getNextKey(JNIEnv* env, jobject obj) {
     throwNewJavaException("com/facebook/react/bridge/InvalidIteratorException",
                           "No such element exists");
   }
-  LocalString value(nativeIterator->iterator->first.c_str());
+  // Keys repeat across every row of a typical payload; hand back the cached
+  // Java string instead of minting a fresh one per iteration.
+  jstring key = JStringCache::get(env, nativeIterator->iterator->first);
   ++nativeIterator->iterator;
-  return static_cast<jstring>(env->NewLocalRef(value.string()));
+  return key;
 }
 
 } // namespace iterator
@@ -570,23 +619,55 @@ static void enqueueNativeRunnableOnQueue(JNIEnv* env, jobject callbackQueueThrea
 namespace bridge {
 
 static jmethodID gCallbackMethod;
+static jmethodID gCallBatchMethod;
 static jmethodID gOnBatchCompleteMethod;
 static jmethodID gOnExecutorUnregisteredMethod;
 static jmethodID gLogMarkerMethod;
 
 struct CountableBridge : Bridge, Countable {
   using Bridge::Bridge;
+
+  // Maps Java's numeric (moduleId, methodId) pairs to interned call handles
+  // so steady-state calls skip the per-call string building below.
+  std::mutex callHandleMutex;
+  std::unordered_map<uint64_t, uint32_t> callHandles;
 };
 
 static void logMarker(const std::string& marker) {
   JNIEnv* env = Environment::current();
   jclass markerClass = env->FindClass("com/facebook/react/bridge/ReactMarker");
-  jstring jmarker = env->NewStringUTF(marker.c_str());
-  env->CallStaticVoidMethod(markerClass, gLogMarkerMethod, jmarker);
+  // Marker names are a fixed vocabulary; the cache owns the jstring.
+  env->CallStaticVoidMethod(markerClass, gLogMarkerMethod, JStringCache::get(env, marker));
   env->DeleteLocalRef(markerClass);
-  env->DeleteLocalRef(jmarker);
 }
 
+/**
+ * Scoped JNI local frame. Locals created inside the frame (argument arrays,
+ * boxed values) are released by a single PopLocalFrame instead of piecemeal,
+ * and can never outgrow the enclosing frame for large batches. Safe to
+ * destroy with a pending Java exception.
+ */
+class LocalFrame {
+public:
+  LocalFrame(JNIEnv* env, jint capacity) :
+      env_(env),
+      pushed_(env->PushLocalFrame(capacity) == 0) {
+    if (!pushed_) {
+      // Couldn't reserve the frame (OOM); clear the error and fall back to
+      // the caller's frame rather than dropping the batch.
+      env_->ExceptionClear();
+    }
+  }
+  ~LocalFrame() {
+    if (pushed_) {
+      env_->PopLocalFrame(nullptr);
+    }
+  }
+private:
+  JNIEnv* env_;
+  bool pushed_;
+};
+
 static void makeJavaCall(JNIEnv* env, ExecutorToken executorToken, jobject callback, const MethodCall& call) {
   if (call.arguments.isNull()) {
     return;
@@ -612,6 +693,53 @@ static void signalBatchComplete(JNIEnv* env, jobject callback) {
   env->CallVoidMethod(callback, gOnBatchCompleteMethod);
 }
 
+/**
+ * Hands a binary-encoded batch to Java in one JNI crossing. Java walks the
+ * records locally (BinaryBatchReader.java) instead of calling back down per
+ * method invocation and per argument read, so JNI transitions per batch drop
+ * from O(calls x args) to O(1). The direct buffer wraps the batch string and
+ * is only valid for the duration of the call.
+ */
+static void deliverBinaryBatch(JNIEnv* env, ExecutorToken executorToken, jobject callback,
+                               const std::string& batch, bool isEndOfBatch) {
+  #ifdef WITH_FBSYSTRACE
+  // End the async flows without materializing any arguments: records are
+  // length prefixed, so this walk only touches each header.
+  size_t offset = 4;
+  while (offset + 4 <= batch.size()) {
+    uint32_t recordLength;
+    memcpy(&recordLength, batch.data() + offset, sizeof(recordLength));
+    if (recordLength < 12 || offset + 4 + recordLength > batch.size()) {
+      break;
+    }
+    int32_t callId;
+    memcpy(&callId, batch.data() + offset + 12, sizeof(callId));
+    if (callId != -1) {
+      fbsystrace_end_async_flow(TRACE_TAG_REACT_APPS, "native", callId);
+    }
+    offset += 4 + recordLength;
+  }
+  #endif
+
+  LocalFrame frame(env, 8);
+  jobject buffer = env->NewDirectByteBuffer(
+      const_cast<char*>(batch.data()), static_cast<jlong>(batch.size()));
+  if (buffer == nullptr) {
+    return;
+  }
+  env->CallVoidMethod(
+      callback,
+      gCallBatchMethod,
+      static_cast<JExecutorTokenHolder*>(executorToken.getPlatformExecutorToken().get())->getJobj(),
+      buffer);
+  if (env->ExceptionCheck()) {
+    return;
+  }
+  if (isEndOfBatch) {
+    signalBatchComplete(env, callback);
+  }
+}
+
 class PlatformBridgeCallback : public BridgeCallback {
 public:
   PlatformBridgeCallback(
@@ -655,7 +783,14 @@ public:
       bool isEndOfBatch) override {
     executeCallbackOnCallbackQueueThread([executorToken, callJSON, isEndOfBatch] (ResolvedWeakReference& callback) {
       JNIEnv* env = Environment::current();
-      for (auto& call : react::parseMethodCalls(callJSON)) {
+      if (react::isBinaryBatch(callJSON)) {
+        deliverBinaryBatch(env, executorToken, callback, callJSON, isEndOfBatch);
+        return;
+      }
+      auto calls = react::parseMethodCalls(callJSON);
+      // One frame for the whole batch: per-call locals are dropped in bulk.
+      LocalFrame frame(env, static_cast<jint>(calls.size()) + 8);
+      for (auto& call : calls) {
         makeJavaCall(env, executorToken, callback, call);
         if (env->ExceptionCheck()) {
           return;
@@ -712,6 +847,17 @@ static void loadApplicationScript(
   }
 }
 
+static void loadApplicationScript(
+    const RefPtr<CountableBridge>& bridge,
+    std::unique_ptr<const JSBigString> script,
+    const std::string& sourceUri) {
+  try {
+    bridge->loadApplicationScript(std::move(script), sourceUri);
+  } catch (...) {
+    translatePendingCppExceptionToJavaException();
+  }
+}
+
 static void loadApplicationUnbundle(
     const RefPtr<CountableBridge>& bridge,
     AAssetManager *assetManager,
@@ -735,24 +881,28 @@ static void loadScriptFromAssets(JNIEnv* env, jobject obj, jobject assetManager,
   auto bridge = extractRefPtr<CountableBridge>(env, obj);
   auto assetNameStr = fromJString(env, assetName);
 
-  env->CallStaticVoidMethod(markerClass, gLogMarkerMethod, env->NewStringUTF("loadScriptFromAssets_start"));
-  auto script = react::loadScriptFromAssets(manager, assetNameStr);
+  env->CallStaticVoidMethod(markerClass, gLogMarkerMethod, JStringCache::get(env, "loadScriptFromAssets_start"));
   #ifdef WITH_FBSYSTRACE
   FbSystraceSection s(TRACE_TAG_REACT_CXX_BRIDGE, "reactbridge_jni_"
     "loadApplicationScript",
     "assetName", assetNameStr);
   #endif
 
-  env->CallStaticVoidMethod(markerClass, gLogMarkerMethod, env->NewStringUTF("loadScriptFromAssets_read"));
   if (JniJSModulesUnbundle::isUnbundle(manager, assetNameStr)) {
+    auto script = react::loadScriptFromAssets(manager, assetNameStr);
+    env->CallStaticVoidMethod(markerClass, gLogMarkerMethod, JStringCache::get(env, "loadScriptFromAssets_read"));
     loadApplicationUnbundle(bridge, manager, script, assetNameStr);
   } else {
-    loadApplicationScript(bridge, script, "file://" + assetNameStr);
+    // Plain bundles go through the mapped loader so the bytes are never
+    // copied between here and JSC.
+    auto script = react::loadScriptFromAssetsMapped(manager, assetNameStr);
+    env->CallStaticVoidMethod(markerClass, gLogMarkerMethod, JStringCache::get(env, "loadScriptFromAssets_read"));
+    loadApplicationScript(bridge, std::move(script), "file://" + assetNameStr);
   }
   if (env->ExceptionCheck()) {
     return;
   }
-  env->CallStaticVoidMethod(markerClass, gLogMarkerMethod, env->NewStringUTF("loadScriptFromAssets_done"));
+  env->CallStaticVoidMethod(markerClass, gLogMarkerMethod, JStringCache::get(env, "loadScriptFromAssets_done"));
 }
 
 static void loadScriptFromFile(JNIEnv* env, jobject obj, jstring fileName, jstring sourceURL) {
@@ -760,20 +910,65 @@ static void loadScriptFromFile(JNIEnv* env, jobject obj, jstring fileName, jstri
 
   auto bridge = jni::extractRefPtr<CountableBridge>(env, obj);
   auto fileNameStr = fileName == NULL ? "" : fromJString(env, fileName);
-  env->CallStaticVoidMethod(markerClass, gLogMarkerMethod, env->NewStringUTF("loadScriptFromFile_start"));
-  auto script = fileName == NULL ? "" : react::loadScriptFromFile(fileNameStr);
+  env->CallStaticVoidMethod(markerClass, gLogMarkerMethod, JStringCache::get(env, "loadScriptFromFile_start"));
+  if (fileName != NULL && PackedUnbundle::isPackedUnbundle(fileNameStr)) {
+    try {
+      auto unbundle = PackedUnbundle::fromFile(fileNameStr);
+      std::string startupCode = unbundle->startupCode();
+      bridge->loadApplicationUnbundle(std::move(unbundle), startupCode, fileNameStr);
+    } catch (...) {
+      translatePendingCppExceptionToJavaException();
+    }
+    if (!env->ExceptionCheck()) {
+      env->CallStaticVoidMethod(markerClass, gLogMarkerMethod, JStringCache::get(env, "loadScriptFromFile_exec"));
+    }
+    return;
+  }
+  std::unique_ptr<const JSBigString> script;
+  if (fileName == NULL) {
+    script.reset(new JSBigStdString(""));
+  } else {
+    // A pre-load started via preloadScriptFromFile already has the bytes
+    // resident and the cache hash computed; fall back to a synchronous load
+    // otherwise.
+    script = react::takePreloadedScript(fileNameStr);
+    if (!script) {
+      script = react::loadScriptFromFileMapped(fileNameStr);
+    }
+  }
   #ifdef WITH_FBSYSTRACE
   auto sourceURLStr = sourceURL == NULL ? fileNameStr : fromJString(env, sourceURL);
   FbSystraceSection s(TRACE_TAG_REACT_CXX_BRIDGE, "reactbridge_jni_"
     "loadApplicationScript",
     "sourceURL", sourceURLStr);
   #endif
-  env->CallStaticVoidMethod(markerClass, gLogMarkerMethod, env->NewStringUTF("loadScriptFromFile_read"));
-  loadApplicationScript(bridge, script, jni::fromJString(env, sourceURL));
+  env->CallStaticVoidMethod(markerClass, gLogMarkerMethod, JStringCache::get(env, "loadScriptFromFile_read"));
+  loadApplicationScript(bridge, std::move(script), jni::fromJString(env, sourceURL));
   if (env->ExceptionCheck()) {
     return;
   }
-  env->CallStaticVoidMethod(markerClass, gLogMarkerMethod, env->NewStringUTF("loadScriptFromFile_exec"));
+  env->CallStaticVoidMethod(markerClass, gLogMarkerMethod, JStringCache::get(env, "loadScriptFromFile_exec"));
+}
+
+static void preloadScriptFromFile(JNIEnv* env, jclass, jstring fileName) {
+  if (fileName != NULL) {
+    react::preloadScriptFromFile(fromJString(env, fileName));
+  }
+}
+
+static jboolean applyScriptDelta(JNIEnv* env, jclass, jstring baseFileName,
+                                 jstring deltaFileName, jstring outputFileName) {
+  if (baseFileName == NULL || deltaFileName == NULL || outputFileName == NULL) {
+    return JNI_FALSE;
+  }
+  // On success the patched file at outputFileName is a full bundle; the
+  // caller hands it to loadScriptFromFile (or preloadScriptFromFile first)
+  // like any other download. On failure the caller falls back to fetching
+  // the full bundle.
+  return BundleDelta::apply(
+      fromJString(env, baseFileName),
+      fromJString(env, deltaFileName),
+      fromJString(env, outputFileName)) ? JNI_TRUE : JNI_FALSE;
 }
 
 static void callFunction(JNIEnv* env, jobject obj, JExecutorToken::jhybridobject jExecutorToken, jint moduleId, jint methodId,
@@ -781,12 +976,29 @@ static void callFunction(JNIEnv* env, jobject obj, JExecutorToken::jhybridobject
   auto bridge = extractRefPtr<CountableBridge>(env, obj);
   auto arguments = cthis(wrap_alias(args));
   try {
+    uint64_t key = ((uint64_t)(uint32_t)moduleId << 32) | (uint32_t)methodId;
+    uint32_t callHandle;
+    bool haveHandle;
+    {
+      std::lock_guard<std::mutex> lock(bridge->callHandleMutex);
+      auto it = bridge->callHandles.find(key);
+      haveHandle = it != bridge->callHandles.end();
+      callHandle = haveHandle ? it->second : 0;
+    }
+    if (!haveHandle) {
+      // First call to this module/method: build the strings once, intern
+      // them, and remember the handle for all later calls.
+      callHandle = bridge->internCallName(
+        folly::to<std::string>(moduleId),
+        folly::to<std::string>(methodId),
+        fromJString(env, tracingName));
+      std::lock_guard<std::mutex> lock(bridge->callHandleMutex);
+      bridge->callHandles.emplace(key, callHandle);
+    }
     bridge->callFunction(
       cthis(wrap_alias(jExecutorToken))->getExecutorToken(wrap_alias(jExecutorToken)),
-      folly::to<std::string>(moduleId),
-      folly::to<std::string>(methodId),
-      std::move(arguments->array),
-      fromJString(env, tracingName)
+      callHandle,
+      std::move(arguments->array)
     );
   } catch (...) {
     translatePendingCppExceptionToJavaException();
@@ -810,7 +1022,11 @@ static void invokeCallback(JNIEnv* env, jobject obj, JExecutorToken::jhybridobje
 
 static void setGlobalVariable(JNIEnv* env, jobject obj, jstring propName, jstring jsonValue) {
   auto bridge = extractRefPtr<CountableBridge>(env, obj);
-  bridge->setGlobalVariable(fromJString(env, propName), fromJString(env, jsonValue));
+  // Adopting overload: the payload string crosses the queue by move; see
+  // Bridge::setGlobalVariable.
+  bridge->setGlobalVariable(
+      fromJString(env, propName),
+      folly::make_unique<const std::string>(fromJString(env, jsonValue)));
 }
 
 static jlong getJavaScriptContext(JNIEnv *env, jobject obj) {
@@ -929,12 +1145,15 @@ extern "C" JNIEXPORT jint JNI_OnLoad(JavaVM* vm, void* reserved) {
         return loadScriptFromAssets(assetName);
       };
     WebWorkerUtil::loadScriptFromNetworkSync = WebWorkers::loadScriptFromNetworkSync;
+    WebWorkerUtil::downloadScriptToFileSync = WebWorkers::downloadScriptToFileSync;
     MessageQueues::getCurrentMessageQueueThread =
       [] {
         return std::unique_ptr<MessageQueueThread>(
             JMessageQueueThread::currentMessageQueueThread().release());
       };
     PerfLogging::installNativeHooks = addNativePerfLoggingHooks;
+    PerfLogging::setCurrentBatchId = setPerfMarkerBatchId;
+    PerfLogging::flushMarkers = flushPerfMarkers;
     JSLogging::nativeHook = nativeLoggingHook;
 
     // get the current env
@@ -972,6 +1191,8 @@ extern "C" JNIEXPORT jint JNI_OnLoad(JavaVM* vm, void* reserved) {
         makeNativeMethod(
           "getType", "(Ljava/lang/String;)Lcom/facebook/react/bridge/ReadableType;",
           map::readable::getValueType),
+        makeNativeMethod("exportKeyedPayload", "([BI)I",
+          map::readable::exportKeyedPayload),
     });
 
     registerNatives("com/facebook/react/bridge/WritableNativeMap", {
@@ -1009,6 +1230,7 @@ extern "C" JNIEXPORT jint JNI_OnLoad(JavaVM* vm, void* reserved) {
 
     jclass callbackClass = env->FindClass("com/facebook/react/bridge/ReactCallback");
     bridge::gCallbackMethod = env->GetMethodID(callbackClass, "call", "(Lcom/facebook/react/bridge/ExecutorToken;IILcom/facebook/react/bridge/ReadableNativeArray;)V");
+    bridge::gCallBatchMethod = env->GetMethodID(callbackClass, "callBatch", "(Lcom/facebook/react/bridge/ExecutorToken;Ljava/nio/ByteBuffer;)V");
     bridge::gOnBatchCompleteMethod = env->GetMethodID(callbackClass, "onBatchComplete", "()V");
     bridge::gOnExecutorUnregisteredMethod = env->GetMethodID(callbackClass, "onExecutorUnregistered", "(Lcom/facebook/react/bridge/ExecutorToken;)V");
 
@@ -1022,6 +1244,11 @@ extern "C" JNIEXPORT jint JNI_OnLoad(JavaVM* vm, void* reserved) {
           "loadScriptFromAssets", "(Landroid/content/res/AssetManager;Ljava/lang/String;)V",
           bridge::loadScriptFromAssets),
         makeNativeMethod("loadScriptFromFile", bridge::loadScriptFromFile),
+        makeNativeMethod("preloadScriptFromFile", "(Ljava/lang/String;)V",
+          bridge::preloadScriptFromFile),
+        makeNativeMethod("applyScriptDelta",
+          "(Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;)Z",
+          bridge::applyScriptDelta),
         makeNativeMethod("callFunction", bridge::callFunction),
         makeNativeMethod("invokeCallback", bridge::invokeCallback),
         makeNativeMethod("setGlobalVariable", bridge::setGlobalVariable),
@@ -68,6 +68,26 @@ void ProxyExecutor::callFunction(const std::string& moduleId, const std::string&
   m_bridge->callNativeModules(*this, result, true);
 }
 
+void ProxyExecutor::callFunctionBatch(std::vector<JSFunctionCall>&& calls) {
+  if (calls.size() == 1) {
+    callFunction(calls[0].moduleId, calls[0].methodId, calls[0].arguments);
+    return;
+  }
+
+  // Each executeJSCall is a JNI hop plus a round trip to the debugger host,
+  // which dominates frame times when this executor is active. Land the whole
+  // batch with one crossing; MessageQueue.processBatchReturnFlushedQueue
+  // replays it on the JS side.
+  folly::dynamic batch = folly::dynamic::array();
+  for (auto& call : calls) {
+    batch.push_back(folly::dynamic::array(
+        call.moduleId, call.methodId, std::move(call.arguments)));
+  }
+  std::vector<folly::dynamic> args{std::move(batch)};
+  std::string result = executeJSCallWithProxy(m_executor.get(), "processBatchReturnFlushedQueue", args);
+  m_bridge->callNativeModules(*this, result, true);
+}
+
 void ProxyExecutor::invokeCallback(const double callbackId, const folly::dynamic& arguments) {
   std::vector<folly::dynamic> call{
     (double) callbackId,
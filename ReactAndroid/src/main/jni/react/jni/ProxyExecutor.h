@@ -42,6 +42,7 @@ public:
     const std::string& moduleId,
     const std::string& methodId,
     const folly::dynamic& arguments) override;
+  virtual void callFunctionBatch(std::vector<JSFunctionCall>&& calls) override;
   virtual void invokeCallback(
     const double callbackId,
     const folly::dynamic& arguments) override;
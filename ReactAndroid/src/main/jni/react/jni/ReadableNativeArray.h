@@ -29,6 +29,15 @@ class ReadableNativeArray : public jni::HybridClass<ReadableNativeArray, NativeA
   jobject getMap(jint index);
   jobject getType(jint index);
 
+  /**
+   * Bulk export: encodes the whole array — types, sizes and primitive data —
+   * into the given byte[], pinned with GetPrimitiveArrayCritical, so Java
+   * decodes a payload of thousands of elements locally after a single JNI
+   * crossing instead of one accessor call per element. Returns the number of
+   * bytes written, or the negated required size if the buffer is too small.
+   */
+  jint exportTypedPayload(jbyteArray buffer);
+
   static void registerNatives();
 };
 
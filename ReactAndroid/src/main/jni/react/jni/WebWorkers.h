@@ -28,13 +28,17 @@ public:
     return folly::make_unique<JMessageQueueThread>(res);
   }
 
-  static std::string loadScriptFromNetworkSync(const std::string& url, const std::string& tempfileName) {
+  static void downloadScriptToFileSync(const std::string& url, const std::string& filename) {
     static auto method = WebWorkers::javaClassStatic()->
         getStaticMethod<void(jstring, jstring)>("downloadScriptToFileSync");
     method(
         WebWorkers::javaClassStatic(),
         jni::make_jstring(url).get(),
-        jni::make_jstring(tempfileName).get());
+        jni::make_jstring(filename).get());
+  }
+
+  static std::string loadScriptFromNetworkSync(const std::string& url, const std::string& tempfileName) {
+    downloadScriptToFileSync(url, tempfileName);
 
     std::ifstream tempFile(tempfileName);
     if (!tempFile.good()) {
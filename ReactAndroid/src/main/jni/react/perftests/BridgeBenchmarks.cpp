@@ -0,0 +1,209 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "BridgeBenchmarks.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+#include <folly/Conv.h>
+#include <folly/json.h>
+
+#include <react/JSCHelpers.h>
+#include <react/MethodCall.h>
+#include <react/MpscTaskQueue.h>
+#include <react/Value.h>
+
+#include <JavaScriptCore/JavaScript.h>
+
+namespace facebook {
+namespace react {
+
+namespace {
+
+uint64_t nowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * Times fn once per iteration and reports mean/stddev/p50/p99 so a CI run
+ * can flag regressions without eyeballing raw numbers. A few warmup
+ * iterations run first to get allocators and JSC caches into steady state.
+ */
+folly::dynamic runBenchmark(int iterations, const std::function<void()>& fn) {
+  const int warmupIterations = std::max(1, iterations / 10);
+  for (int i = 0; i < warmupIterations; i++) {
+    fn();
+  }
+
+  std::vector<uint64_t> samples;
+  samples.reserve(iterations);
+  for (int i = 0; i < iterations; i++) {
+    uint64_t start = nowNs();
+    fn();
+    samples.push_back(nowNs() - start);
+  }
+
+  double mean = 0;
+  for (uint64_t sample : samples) {
+    mean += sample;
+  }
+  mean /= samples.size();
+
+  double variance = 0;
+  for (uint64_t sample : samples) {
+    variance += (sample - mean) * (sample - mean);
+  }
+  variance /= samples.size();
+
+  std::sort(samples.begin(), samples.end());
+  uint64_t p50 = samples[samples.size() / 2];
+  uint64_t p99 = samples[std::min(samples.size() - 1, samples.size() * 99 / 100)];
+
+  return folly::dynamic::object
+      ("iterations", iterations)
+      ("meanNs", mean)
+      ("stddevNs", std::sqrt(variance))
+      ("p50Ns", p50)
+      ("p99Ns", p99);
+}
+
+std::string makeJsonBatch(int calls) {
+  folly::dynamic moduleIds = folly::dynamic::array();
+  folly::dynamic methodIds = folly::dynamic::array();
+  folly::dynamic params = folly::dynamic::array();
+  for (int i = 0; i < calls; i++) {
+    moduleIds.push_back(i % 16);
+    methodIds.push_back(i % 8);
+    params.push_back(folly::dynamic::array(i, "some parameter text", true, nullptr));
+  }
+  return folly::toJson(
+      folly::dynamic::array(moduleIds, methodIds, params, calls)).toStdString();
+}
+
+template<typename T>
+void appendRaw(std::string& out, const T& value) {
+  out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+std::string makeBinaryBatch(int calls) {
+  std::string batch("RNB\x01", 4);
+  const char* text = "some parameter text";
+  for (int i = 0; i < calls; i++) {
+    std::string record;
+    appendRaw(record, (int32_t)(i % 16));  // moduleId
+    appendRaw(record, (int32_t)(i % 8));   // methodId
+    appendRaw(record, (int32_t)i);         // callId
+    appendRaw(record, (uint32_t)3);        // argument count
+    record.push_back((char)BinaryArgument::Int32);
+    appendRaw(record, (int32_t)i);
+    record.push_back((char)BinaryArgument::String);
+    appendRaw(record, (uint32_t)strlen(text));
+    record.append(text);
+    record.push_back((char)BinaryArgument::True);
+    appendRaw(batch, (uint32_t)record.size());
+    batch.append(record);
+  }
+  return batch;
+}
+
+// Representative of a medium native->JS payload: a list of smallish records.
+folly::dynamic makePayload(int records) {
+  folly::dynamic rows = folly::dynamic::array();
+  for (int i = 0; i < records; i++) {
+    rows.push_back(folly::dynamic::object
+        ("id", i)
+        ("title", "Row title with some text in it")
+        ("selected", i % 2 == 0)
+        ("score", i * 0.75)
+        ("tags", folly::dynamic::array("one", "two", "three")));
+  }
+  return folly::dynamic::object("rows", std::move(rows))("offset", 0);
+}
+
+void benchParseMethodCalls(folly::dynamic& results) {
+  for (int batchSize : {1, 10, 100, 1000}) {
+    std::string json = makeJsonBatch(batchSize);
+    results[folly::to<std::string>("parseMethodCalls_", batchSize)] =
+        runBenchmark(batchSize >= 1000 ? 50 : 500, [&json] {
+          parseMethodCalls(json);
+        });
+
+    std::string binary = makeBinaryBatch(batchSize);
+    results[folly::to<std::string>("parseBinaryMethodCalls_", batchSize)] =
+        runBenchmark(batchSize >= 1000 ? 50 : 500, [&binary] {
+          parseBinaryMethodCalls(binary);
+        });
+  }
+}
+
+void benchValueJson(folly::dynamic& results) {
+  JSGlobalContextRef ctx = JSGlobalContextCreateInGroup(nullptr, nullptr);
+  std::string payloadJson = folly::toJson(makePayload(200)).toStdString();
+
+  results["valueFromJSON"] = runBenchmark(200, [&] {
+    String json(payloadJson.c_str());
+    Value::fromJSON(ctx, json);
+  });
+
+  String json(payloadJson.c_str());
+  Value parsed = Value::fromJSON(ctx, json);
+  results["valueToJSONString"] = runBenchmark(200, [&] {
+    parsed.toJSONString();
+  });
+
+  JSGlobalContextRelease(ctx);
+}
+
+void benchJscCallRoundTrip(folly::dynamic& results) {
+  JSGlobalContextRef ctx = JSGlobalContextCreateInGroup(nullptr, nullptr);
+
+  // Same shape as executeJSCallWithJSC in JSCExecutor.cpp: apply a bridge
+  // method through an evaluated call expression and JSON-serialize the
+  // returned queue.
+  String bridgeSetup(
+      "__fbBatchedBridge = { callFunctionReturnFlushedQueue: "
+      "function(module, method, args) { return [[], [], [], 0]; } };");
+  evaluateScript(ctx, bridgeSetup, nullptr);
+
+  std::string callJs =
+      "__fbBatchedBridge.callFunctionReturnFlushedQueue.apply(null, "
+      "[\"UIManager\", \"updateView\", [1, \"RCTView\", {\"opacity\": 0.5}]])";
+  results["jscCallRoundTrip"] = runBenchmark(500, [&] {
+    String script(callJs.c_str());
+    Value result(ctx, evaluateScript(ctx, script, nullptr));
+    result.toJSONString();
+  });
+
+  JSGlobalContextRelease(ctx);
+}
+
+void benchTaskQueueThroughput(folly::dynamic& results) {
+  // Stands in for runOnExecutorQueue throughput: the native queue hop runs
+  // through MpscTaskQueue, and the Java looper half can't run in this
+  // process. Each iteration pushes and drains a burst of tasks.
+  MpscTaskQueue queue;
+  results["taskQueuePushDrain_100"] = runBenchmark(500, [&queue] {
+    for (int i = 0; i < 100; i++) {
+      queue.push([] {});
+    }
+    queue.drain();
+  });
+}
+
+} // namespace
+
+folly::dynamic runBridgeBenchmarks() {
+  folly::dynamic results = folly::dynamic::object();
+  benchParseMethodCalls(results);
+  benchValueJson(results);
+  benchJscCallRoundTrip(results);
+  benchTaskQueueThroughput(results);
+  return results;
+}
+
+} }
@@ -0,0 +1,17 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include <folly/dynamic.h>
+
+namespace facebook {
+namespace react {
+
+/**
+ * Runs the bridge microbenchmark suite and returns per-benchmark statistics
+ * as { name: { iterations, meanNs, stddevNs, p50Ns, p99Ns } }. See
+ * BridgeBenchmarks.cpp for the benchmark list.
+ */
+folly::dynamic runBridgeBenchmarks();
+
+} }
@@ -1,10 +1,14 @@
 // Copyright 2004-present Facebook. All Rights Reserved.
 
 #include <fb/log.h>
+#include <folly/json.h>
 #include <jni/Environment.h>
 #include <jni/LocalString.h>
 #include <jni/Registration.h>
 
+#include "BridgeBenchmarks.h"
+#include "StartupBenchmarks.h"
+
 namespace facebook {
 namespace react {
 
@@ -46,6 +50,40 @@ static void startWatchingForLogMessage(JNIEnv* env, jclass loggerClass, jstring
 
 } // namespace logwatcher
 
+namespace benchmarks {
+
+/**
+ * Runs the whole suite and hands the per-benchmark statistics back to the
+ * instrumentation test as a JSON string, so the Java side can log or assert
+ * on them without a native type for every stat.
+ */
+static jstring runBridgeBenchmarksJni(JNIEnv* env, jclass benchmarksClass) {
+  std::string json = folly::toJson(runBridgeBenchmarks()).toStdString();
+  jni::LocalString result(json.c_str());
+  return static_cast<jstring>(env->NewLocalRef(result.string()));
+}
+
+/**
+ * Boots the bridge headlessly against the given recorded bundle across the
+ * available delivery modes; see StartupBenchmarks.h for the shape of the
+ * returned JSON.
+ */
+static jstring runStartupBenchmarksJni(
+    JNIEnv* env,
+    jclass benchmarksClass,
+    jstring jbundlePath,
+    jstring jcacheDir,
+    jint iterations) {
+  std::string bundlePath = jni::fromJString(env, jbundlePath);
+  std::string cacheDir = jni::fromJString(env, jcacheDir);
+  std::string json = folly::toJson(
+      runStartupBenchmarks(bundlePath, cacheDir, iterations)).toStdString();
+  jni::LocalString result(json.c_str());
+  return static_cast<jstring>(env->NewLocalRef(result.string()));
+}
+
+} // namespace benchmarks
+
 extern "C" jint JNI_OnLoad(JavaVM* vm, void* reserved) {
   // get the current env
   JNIEnv* env;
@@ -59,6 +97,11 @@ extern "C" jint JNI_OnLoad(JavaVM* vm, void* reserved) {
     { "hasSeenExpectedLogMessage", "()Z", (void*) logwatcher::hasSeenExpectedLogMessage },
   });
 
+  jni::registerNatives(env, "com/facebook/catalyst/testing/BridgeBenchmarks", {
+    { "runBridgeBenchmarks", "()Ljava/lang/String;", (void*) benchmarks::runBridgeBenchmarksJni },
+    { "runStartupBenchmarks", "(Ljava/lang/String;Ljava/lang/String;I)Ljava/lang/String;", (void*) benchmarks::runStartupBenchmarksJni },
+  });
+
   return JNI_VERSION_1_4;
 }
 
@@ -0,0 +1,172 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "StartupBenchmarks.h"
+
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <folly/Memory.h>
+
+#include <react/Bridge.h>
+#include <react/BridgeMetrics.h>
+#include <react/ExecutorToken.h>
+#include <react/ExecutorTokenFactory.h>
+#include <react/JSBigString.h>
+#include <react/JSCExecutor.h>
+#include <react/MessageQueueThread.h>
+#include <react/PackedUnbundle.h>
+#include <react/Platform.h>
+
+namespace facebook {
+namespace react {
+
+namespace {
+
+/**
+ * Runs every task inline on the calling thread. A real boot hops through the
+ * Java looper; that hop is benchmarked separately (benchTaskQueueThroughput
+ * in BridgeBenchmarks.cpp), and keeping the whole boot on one thread makes
+ * the phase timings deterministic run to run.
+ */
+class InlineMessageQueueThread : public MessageQueueThread {
+ public:
+  void runOnQueue(MessageQueueTask&& task) override {
+    task();
+  }
+  bool isOnThread() override {
+    return true;
+  }
+  void quitSynchronous() override {}
+};
+
+class InlineExecutorTokenFactory : public ExecutorTokenFactory {
+ public:
+  ExecutorToken createExecutorToken() const override {
+    return ExecutorToken(std::make_shared<PlatformExecutorToken>());
+  }
+};
+
+/**
+ * Counts flushed batches; a headless boot has no native modules to deliver
+ * them to, but the count shows whether the bundle's first flush happened.
+ */
+class CountingBridgeCallback : public BridgeCallback {
+ public:
+  void onCallNativeModules(
+      ExecutorToken executorToken,
+      const std::string& callJSON,
+      bool isEndOfBatch) override {
+    batches++;
+  }
+  void onExecutorUnregistered(ExecutorToken executorToken) override {}
+
+  int batches = 0;
+};
+
+std::string readFile(const std::string& path) {
+  std::ifstream file(path, std::ios::binary);
+  std::ostringstream contents;
+  contents << file.rdbuf();
+  return contents.str();
+}
+
+// Headless boots have no real native modules; the runtime just needs the
+// config global to exist before the bundle evaluates.
+const char* kBridgeConfigJson = "{\"remoteModuleConfig\":[]}";
+
+folly::dynamic bootOnce(
+    const std::string& mode,
+    const std::string& bundlePath,
+    const std::string& cacheDir) {
+  // Prewarming would hide the context-creation cost from exactly the phase
+  // this harness exists to measure.
+  folly::dynamic jscConfig = folly::dynamic::object("PrewarmContextPool", false);
+  JSCExecutorFactory factory(cacheDir, jscConfig);
+
+  auto callback = folly::make_unique<CountingBridgeCallback>();
+  CountingBridgeCallback* callbackPtr = callback.get();
+
+  uint64_t bootStart = BridgeMetrics::nowMicros();
+  Bridge bridge(
+      &factory,
+      folly::make_unique<InlineExecutorTokenFactory>(),
+      std::move(callback));
+  uint64_t bridgeReady = BridgeMetrics::nowMicros();
+
+  bridge.setGlobalVariable("__fbBatchedBridgeConfig", kBridgeConfigJson);
+
+  if (mode == "unbundle") {
+    auto unbundle = PackedUnbundle::fromFile(bundlePath);
+    std::string startupCode = unbundle->startupCode();
+    bridge.loadApplicationUnbundle(
+        std::move(unbundle), startupCode, bundlePath);
+  } else if (mode == "mmap" || mode == "bytecodeCache") {
+    auto script = JSBigFileString::fromPath(bundlePath);
+    if (!script) {
+      throw std::runtime_error("could not mmap bundle: " + bundlePath);
+    }
+    bridge.loadApplicationScript(std::move(script), bundlePath);
+  } else {
+    bridge.loadApplicationScript(readFile(bundlePath), bundlePath);
+  }
+  uint64_t loadEnd = BridgeMetrics::nowMicros();
+
+  folly::dynamic timings = bridge.getStartupTimings();
+  int batches = callbackPtr->batches;
+  bridge.destroy();
+
+  timings["bootStartMicros"] = bootStart;
+  timings["bridgeReadyMicros"] = bridgeReady;
+  timings["loadEndMicros"] = loadEnd;
+  timings["flushedBatches"] = batches;
+  return timings;
+}
+
+} // namespace
+
+folly::dynamic runStartupBenchmarks(
+    const std::string& bundlePath,
+    const std::string& cacheDir,
+    int iterations) {
+  // This process doesn't run the app's JNI initialization, so install the
+  // platform hooks a boot touches, restoring whatever was there afterwards.
+  auto previousQueueFactory = MessageQueues::getCurrentMessageQueueThread;
+  auto previousLogMarker = ReactMarker::logMarker;
+  MessageQueues::getCurrentMessageQueueThread =
+      []() -> std::unique_ptr<MessageQueueThread> {
+    return folly::make_unique<InlineMessageQueueThread>();
+  };
+  ReactMarker::logMarker = [](const std::string& marker) {};
+
+  folly::dynamic results = folly::dynamic::object();
+  std::vector<std::string> modes;
+  if (PackedUnbundle::isPackedUnbundle(bundlePath)) {
+    modes = {"unbundle"};
+  } else {
+    modes = {"plain", "mmap", "bytecodeCache"};
+    results["unbundle"] = "skipped: bundle is not a packed unbundle";
+  }
+
+  for (const auto& mode : modes) {
+    folly::dynamic runs = folly::dynamic::array();
+    for (int i = 0; i < iterations; i++) {
+      try {
+        runs.push_back(bootOnce(
+            mode, bundlePath, mode == "bytecodeCache" ? cacheDir : ""));
+      } catch (const std::exception& e) {
+        runs.push_back(folly::dynamic::object("error", e.what()));
+      }
+    }
+    results[mode] = std::move(runs);
+  }
+
+  MessageQueues::getCurrentMessageQueueThread = previousQueueFactory;
+  ReactMarker::logMarker = previousLogMarker;
+  return results;
+}
+
+} }
@@ -0,0 +1,28 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include <string>
+
+#include <folly/dynamic.h>
+
+namespace facebook {
+namespace react {
+
+/**
+ * Boots Bridge + JSCExecutor headlessly through a full startup — config
+ * injection, bundle load, first flush — against the bundle at bundlePath,
+ * once per delivery mode, iterations times each. A plain bundle runs in
+ * plain-string, mmap, and bytecode-cache modes (cacheDir holds the source
+ * cache; the first bytecode-cache run is the cold, cache-populating one);
+ * a packed unbundle file runs in unbundle mode. Returns, per mode, an array
+ * of per-run objects carrying the executor's startup phase timings (see
+ * JSExecutor::getStartupTimings) plus harness timestamps, all on the
+ * BridgeMetrics::nowMicros clock.
+ */
+folly::dynamic runStartupBenchmarks(
+    const std::string& bundlePath,
+    const std::string& cacheDir,
+    int iterations);
+
+} }
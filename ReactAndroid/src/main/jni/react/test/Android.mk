@@ -3,10 +3,21 @@ LOCAL_PATH:= $(call my-dir)
 include $(CLEAR_VARS)
 
 LOCAL_SRC_FILES:= \
+	bridgemetrics.cpp \
+	callargsbuilder.cpp \
+	flatidmap.cpp \
+	hmrupdatecache.cpp \
+	inlinetask.cpp \
 	jscexecutor.cpp \
+	jscheaptuning.cpp \
+	mpsctaskqueue.cpp \
+	nativemessagequeuethread.cpp \
+	paralleljson.cpp \
 	jsclogging.cpp \
 	value.cpp \
 	methodcall.cpp \
+	tracerecorder.cpp \
+	unbundleprefetcher.cpp \
 
 LOCAL_SHARED_LIBRARIES := \
 	libfb \
@@ -0,0 +1,34 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include <gtest/gtest.h>
+#include <react/BridgeMetrics.h>
+
+using namespace facebook;
+using namespace facebook::react;
+
+TEST(BridgeMetrics, CountsAndTotals) {
+  BridgeMetrics metrics;
+  metrics.record("UIManager.updateView", 100);
+  metrics.record("UIManager.updateView", 300);
+  metrics.record("<callback>", 50);
+
+  auto snapshot = metrics.toDynamic();
+  EXPECT_EQ(2, snapshot["UIManager.updateView"]["count"].getInt());
+  EXPECT_EQ(400, snapshot["UIManager.updateView"]["totalMicros"].getInt());
+  EXPECT_EQ(1, snapshot["<callback>"]["count"].getInt());
+}
+
+TEST(BridgeMetrics, HistogramBuckets) {
+  BridgeMetrics metrics;
+  // Bucket i holds [2^(i-1), 2^i): 100us lands in bucket 7, 300us in 9.
+  metrics.record("call", 100);
+  metrics.record("call", 300);
+  // Latencies beyond the histogram range collapse into the last bucket.
+  metrics.record("call", 1ull << 40);
+
+  auto buckets = metrics.toDynamic()["call"]["buckets"];
+  ASSERT_EQ(BridgeMetrics::kNumBuckets, buckets.size());
+  EXPECT_EQ(1, buckets[7].getInt());
+  EXPECT_EQ(1, buckets[9].getInt());
+  EXPECT_EQ(1, buckets[BridgeMetrics::kNumBuckets - 1].getInt());
+}
@@ -0,0 +1,30 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include <gtest/gtest.h>
+#include <react/CallArgsBuilder.h>
+
+using namespace facebook;
+using namespace facebook::react;
+
+TEST(CallArgsBuilder, AppendsIntoAnArrayInOrder) {
+  CallArgsBuilder builder;
+  builder.append("UIManager");
+  builder.append("measure");
+  builder.append(folly::dynamic::array(1, 2));
+
+  ASSERT_EQ(3, builder.size());
+  EXPECT_EQ("UIManager", builder.args()[0].getString());
+  EXPECT_EQ("measure", builder.args()[1].getString());
+  EXPECT_EQ(folly::dynamic(folly::dynamic::array(1, 2)), builder.args()[2]);
+}
+
+TEST(CallArgsBuilder, ClearEmptiesTheListForTheNextCall) {
+  CallArgsBuilder builder;
+  builder.append("first");
+  builder.clear();
+  EXPECT_EQ(0, builder.size());
+
+  builder.append(42.0);
+  ASSERT_EQ(1, builder.size());
+  EXPECT_EQ(42.0, builder.args()[0].getDouble());
+}
@@ -0,0 +1,76 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include <memory>
+
+#include <gtest/gtest.h>
+#include <react/FlatIdMap.h>
+
+using namespace facebook;
+using namespace facebook::react;
+
+TEST(FlatIdMap, InsertFindErase) {
+  FlatIdMap<int> map;
+  map.emplace(3, 30);
+  map.emplace(7, 70);
+  ASSERT_NE(nullptr, map.find(3));
+  EXPECT_EQ(30, *map.find(3));
+  EXPECT_EQ(70, *map.find(7));
+  EXPECT_EQ(nullptr, map.find(4));
+  EXPECT_TRUE(map.erase(3));
+  EXPECT_FALSE(map.erase(3));
+  EXPECT_EQ(nullptr, map.find(3));
+  EXPECT_EQ(1u, map.size());
+}
+
+TEST(FlatIdMap, OverwritingAKeyKeepsOneEntry) {
+  FlatIdMap<int> map;
+  map.emplace(5, 1);
+  map.emplace(5, 2);
+  EXPECT_EQ(1u, map.size());
+  EXPECT_EQ(2, *map.find(5));
+}
+
+TEST(FlatIdMap, EraseClosesProbeChains) {
+  // 1, 9 and 17 all hash to the same initial slot in the 8-wide table;
+  // erasing the middle of the chain must not orphan the tail.
+  FlatIdMap<int> map;
+  map.emplace(1, 100);
+  map.emplace(9, 900);
+  map.emplace(17, 1700);
+  EXPECT_TRUE(map.erase(9));
+  ASSERT_NE(nullptr, map.find(17));
+  EXPECT_EQ(1700, *map.find(17));
+  EXPECT_EQ(100, *map.find(1));
+  EXPECT_EQ(nullptr, map.find(9));
+}
+
+TEST(FlatIdMap, GrowsPastInitialCapacity) {
+  FlatIdMap<int> map;
+  for (uint32_t i = 0; i < 100; i++) {
+    map.emplace(i, (int) (i * 10));
+  }
+  EXPECT_EQ(100u, map.size());
+  for (uint32_t i = 0; i < 100; i++) {
+    ASSERT_NE(nullptr, map.find(i));
+    EXPECT_EQ((int) (i * 10), *map.find(i));
+  }
+}
+
+TEST(FlatIdMap, SupportsMoveOnlyValues) {
+  FlatIdMap<std::unique_ptr<int>> map;
+  map.emplace(2, std::unique_ptr<int>(new int(42)));
+  ASSERT_NE(nullptr, map.find(2));
+  EXPECT_EQ(42, **map.find(2));
+  EXPECT_TRUE(map.erase(2));
+}
+
+TEST(FlatIdMap, ForEachVisitsEveryLiveEntry) {
+  FlatIdMap<int> map;
+  map.emplace(1, 1);
+  map.emplace(2, 2);
+  map.emplace(3, 3);
+  map.erase(2);
+  int sum = 0;
+  map.forEach([&sum] (uint32_t key, int& value) { sum += value; });
+  EXPECT_EQ(4, sum);
+}
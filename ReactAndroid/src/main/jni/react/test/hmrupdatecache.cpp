@@ -0,0 +1,47 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include <gtest/gtest.h>
+#include <react/HMRUpdateCache.h>
+
+using namespace facebook;
+using namespace facebook::react;
+
+TEST(HMRUpdateCache, FirstUpdateEvaluatesEverything) {
+  HMRUpdateCache cache;
+  std::string update = "__d(1, function() {});\n__d(2, function() {});\n";
+  EXPECT_EQ(update, cache.filterChangedModules(update));
+}
+
+TEST(HMRUpdateCache, UnchangedUpdateIsSkippedEntirely) {
+  HMRUpdateCache cache;
+  std::string update = "__d(1, function() {});\n__d(2, function() {});\n";
+  cache.filterChangedModules(update);
+  EXPECT_EQ("", cache.filterChangedModules(update));
+}
+
+TEST(HMRUpdateCache, OnlyChangedModulesSurvive) {
+  HMRUpdateCache cache;
+  cache.filterChangedModules(
+      "__d(1, function() { old(); });\n__d(2, function() {});\n");
+  std::string second =
+      "__d(1, function() { edited(); });\n__d(2, function() {});\n";
+  EXPECT_EQ("__d(1, function() { edited(); });\n",
+            cache.filterChangedModules(second));
+}
+
+TEST(HMRUpdateCache, GlueBeforeModulesIsItsOwnChunk) {
+  HMRUpdateCache cache;
+  std::string update = "var glue = 1;\n__d(1, function() {});\n";
+  EXPECT_EQ(update, cache.filterChangedModules(update));
+  // Same glue, edited module: only the module comes back.
+  std::string second = "var glue = 1;\n__d(1, function() { x(); });\n";
+  EXPECT_EQ("__d(1, function() { x(); });\n", cache.filterChangedModules(second));
+}
+
+TEST(HMRUpdateCache, NonBundleScriptsDeduplicateWhole) {
+  HMRUpdateCache cache;
+  std::string script = "console.log('not a module bundle');";
+  EXPECT_EQ(script, cache.filterChangedModules(script));
+  EXPECT_EQ("", cache.filterChangedModules(script));
+  EXPECT_EQ("other();", cache.filterChangedModules("other();"));
+}
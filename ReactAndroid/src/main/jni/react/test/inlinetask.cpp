@@ -0,0 +1,44 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include <memory>
+
+#include <gtest/gtest.h>
+#include <react/InlineTask.h>
+
+using namespace facebook;
+using namespace facebook::react;
+
+TEST(InlineTask, CallsTheClosure) {
+  int calls = 0;
+  InlineTask<int(int), 64> task = [&calls] (int x) {
+    calls++;
+    return x + 1;
+  };
+  EXPECT_EQ(5, task(4));
+  EXPECT_EQ(1, calls);
+}
+
+TEST(InlineTask, SupportsMoveOnlyCaptures) {
+  auto value = std::unique_ptr<int>(new int(42));
+  InlineTask<int(), 64> task = [value=std::move(value)] {
+    return *value;
+  };
+  EXPECT_EQ(42, task());
+}
+
+TEST(InlineTask, MoveTransfersTheClosure) {
+  InlineTask<int(), 64> task = [] { return 7; };
+  InlineTask<int(), 64> moved = std::move(task);
+  EXPECT_FALSE((bool)task);
+  ASSERT_TRUE((bool)moved);
+  EXPECT_EQ(7, moved());
+}
+
+TEST(InlineTask, ResetReleasesCaptures) {
+  auto tracked = std::make_shared<int>(1);
+  InlineTask<void(), 64> task = [tracked] {};
+  EXPECT_EQ(2, tracked.use_count());
+  task.reset();
+  EXPECT_EQ(1, tracked.use_count());
+  EXPECT_FALSE((bool)task);
+}
@@ -0,0 +1,37 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include <gtest/gtest.h>
+#include <react/JSCHeapTuning.h>
+
+using namespace facebook;
+using namespace facebook::react;
+
+TEST(JSCHeapTuning, ConfigWithoutTuningKeysComesBackUnchanged) {
+  folly::dynamic config = folly::dynamic::object("PrewarmContextPool", true);
+  EXPECT_EQ(config, expandHeapTuningConfig(config));
+}
+
+TEST(JSCHeapTuning, LargeAppPresetExpandsToExplicitDials) {
+  folly::dynamic config = folly::dynamic::object("HeapTuningPreset", "large-app");
+  auto expanded = expandHeapTuningConfig(config);
+  auto& tuning = expanded["HeapTuning"];
+  EXPECT_EQ(64, tuning["InitialHeapSizeMB"].getInt());
+  EXPECT_EQ(16, tuning["NurserySizeMB"].getInt());
+  EXPECT_EQ(2.0, tuning["GCTriggerRatio"].getDouble());
+}
+
+TEST(JSCHeapTuning, ExplicitDialsOverrideThePreset) {
+  folly::dynamic config = folly::dynamic::object
+      ("HeapTuningPreset", "large-app")
+      ("HeapTuning", folly::dynamic::object("NurserySizeMB", 4));
+  auto expanded = expandHeapTuningConfig(config);
+  auto& tuning = expanded["HeapTuning"];
+  EXPECT_EQ(4, tuning["NurserySizeMB"].getInt());
+  EXPECT_EQ(64, tuning["InitialHeapSizeMB"].getInt());
+}
+
+TEST(JSCHeapTuning, UnknownPresetYieldsNoDials) {
+  folly::dynamic config = folly::dynamic::object("HeapTuningPreset", "speedy");
+  auto expanded = expandHeapTuningConfig(config);
+  EXPECT_TRUE(expanded["HeapTuning"].empty());
+}
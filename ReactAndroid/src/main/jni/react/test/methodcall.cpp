@@ -113,3 +113,68 @@ TEST(parseMethodCalls, ParseTwoCalls) {
   auto returnedCalls = parseMethodCalls(jsText);
   ASSERT_EQ(2, returnedCalls.size());
 }
+
+namespace {
+
+void appendRaw(std::string& out, const void* data, size_t size) {
+  out.append(reinterpret_cast<const char*>(data), size);
+}
+
+template <typename T>
+void appendValue(std::string& out, T value) {
+  appendRaw(out, &value, sizeof(value));
+}
+
+std::string encodeSingleCallBatch(
+    int32_t moduleId,
+    int32_t methodId,
+    int32_t callId,
+    const std::string& args) {
+  std::string batch("RNB\x01", 4);
+  appendValue<uint32_t>(batch, 3 * sizeof(int32_t) + sizeof(uint32_t) + args.size());
+  appendValue<int32_t>(batch, moduleId);
+  appendValue<int32_t>(batch, methodId);
+  appendValue<int32_t>(batch, callId);
+  appendValue<uint32_t>(batch, args.empty() ? 0 : 1);
+  batch += args;
+  return batch;
+}
+
+} // namespace
+
+TEST(parseBinaryMethodCalls, SingleCallNoArgs) {
+  auto batch = encodeSingleCallBatch(7, 3, -1, "");
+  ASSERT_TRUE(isBinaryBatch(batch));
+  auto returnedCalls = parseBinaryMethodCalls(batch);
+  ASSERT_EQ(1, returnedCalls.size());
+  ASSERT_EQ(7, returnedCalls[0].moduleId);
+  ASSERT_EQ(3, returnedCalls[0].methodId);
+  ASSERT_EQ(0, returnedCalls[0].arguments.size());
+}
+
+TEST(parseBinaryMethodCalls, TypedArguments) {
+  std::string doubleArg;
+  appendValue<uint8_t>(doubleArg, 3); // BinaryArgument::Double
+  appendValue<double>(doubleArg, 42.16);
+  auto returnedCalls = parseBinaryMethodCalls(encodeSingleCallBatch(0, 0, -1, doubleArg));
+  ASSERT_EQ(1, returnedCalls.size());
+  ASSERT_EQ(1, returnedCalls[0].arguments.size());
+  ASSERT_EQ(42.16, returnedCalls[0].arguments[0].getDouble());
+
+  std::string stringArg;
+  appendValue<uint8_t>(stringArg, 5); // BinaryArgument::String
+  appendValue<uint32_t>(stringArg, 6);
+  stringArg += "foobar";
+  returnedCalls = parseBinaryMethodCalls(encodeSingleCallBatch(0, 0, -1, stringArg));
+  ASSERT_EQ("foobar", returnedCalls[0].arguments[0].getString());
+}
+
+TEST(parseBinaryMethodCalls, TruncatedBatchThrows) {
+  auto batch = encodeSingleCallBatch(7, 3, -1, "");
+  batch.resize(batch.size() - 2);
+  ASSERT_THROW(parseBinaryMethodCalls(batch), std::invalid_argument);
+}
+
+TEST(parseBinaryMethodCalls, JsonPayloadIsNotBinary) {
+  ASSERT_FALSE(isBinaryBatch("[[7],[3],[[]]]"));
+}
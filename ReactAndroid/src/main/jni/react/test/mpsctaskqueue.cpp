@@ -0,0 +1,56 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <react/MpscTaskQueue.h>
+
+using namespace facebook;
+using namespace facebook::react;
+
+TEST(MpscTaskQueue, RunsTasksInPushOrder) {
+  MpscTaskQueue queue;
+  std::vector<int> order;
+  EXPECT_TRUE(queue.push([&order] { order.push_back(1); }));
+  EXPECT_FALSE(queue.push([&order] { order.push_back(2); }));
+  queue.drain();
+  ASSERT_EQ(2, order.size());
+  EXPECT_EQ(1, order[0]);
+  EXPECT_EQ(2, order[1]);
+}
+
+TEST(MpscTaskQueue, RecycledNodesStillRunInOrder) {
+  MpscTaskQueue queue;
+  std::vector<int> order;
+  // Several push/drain rounds so later rounds run on free-listed nodes.
+  for (int round = 0; round < 3; round++) {
+    for (int i = 0; i < 4; i++) {
+      queue.push([&order, round, i] { order.push_back(round * 4 + i); });
+    }
+    queue.drain();
+  }
+  ASSERT_EQ(12, order.size());
+  for (int i = 0; i < 12; i++) {
+    EXPECT_EQ(i, order[i]);
+  }
+}
+
+TEST(MpscTaskQueue, ReportsEmptiness) {
+  MpscTaskQueue queue;
+  EXPECT_TRUE(queue.isEmpty());
+  queue.push([] {});
+  EXPECT_FALSE(queue.isEmpty());
+  queue.drain();
+  EXPECT_TRUE(queue.isEmpty());
+}
+
+TEST(MpscTaskQueue, DropsCapturesAfterRunning) {
+  MpscTaskQueue queue;
+  auto tracked = std::make_shared<int>(1);
+  queue.push([tracked] {});
+  EXPECT_EQ(2, tracked.use_count());
+  queue.drain();
+  // The node is recycled, not freed, but the closure must be gone.
+  EXPECT_EQ(1, tracked.use_count());
+}
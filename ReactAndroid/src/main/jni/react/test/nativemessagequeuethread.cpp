@@ -0,0 +1,46 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include <atomic>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <react/NativeMessageQueueThread.h>
+
+using namespace facebook;
+using namespace facebook::react;
+
+TEST(NativeMessageQueueThread, RunsTasksOnItsOwnThread) {
+  NativeMessageQueueThread thread;
+  EXPECT_FALSE(thread.isOnThread());
+
+  std::atomic<bool> ranOnThread(false);
+  thread.runOnQueueSync([&] {
+    ranOnThread = thread.isOnThread();
+  });
+  EXPECT_TRUE(ranOnThread);
+}
+
+TEST(NativeMessageQueueThread, SyncCallsRunInlineOnTheirOwnThread) {
+  NativeMessageQueueThread thread;
+  bool ran = false;
+  thread.runOnQueueSync([&] {
+    // Re-entrant sync call from the queue's own thread: must run inline
+    // instead of deadlocking on itself.
+    thread.runOnQueueSync([&] { ran = true; });
+  });
+  EXPECT_TRUE(ran);
+}
+
+TEST(NativeMessageQueueThread, RunsTasksInOrder) {
+  NativeMessageQueueThread thread;
+  std::vector<int> order;
+  for (int i = 0; i < 5; i++) {
+    thread.runOnQueue([&order, i] { order.push_back(i); });
+  }
+  // Synchronous task acts as a barrier behind the queued ones.
+  thread.runOnQueueSync([] {});
+  ASSERT_EQ(5, order.size());
+  for (int i = 0; i < 5; i++) {
+    EXPECT_EQ(i, order[i]);
+  }
+}
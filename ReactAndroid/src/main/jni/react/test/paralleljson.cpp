@@ -0,0 +1,45 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include <gtest/gtest.h>
+#include <folly/json.h>
+#include <react/ParallelJson.h>
+
+using namespace facebook;
+using namespace facebook::react;
+
+namespace {
+
+folly::dynamic makeRows(int count) {
+  folly::dynamic rows = folly::dynamic::array();
+  for (int i = 0; i < count; i++) {
+    rows.push_back(folly::dynamic::object
+        ("id", i)
+        ("score", i * 0.125)
+        ("title", "row with \"quotes\" and unicode \xc3\xa9")
+        ("tags", folly::dynamic::array("a", nullptr, true, 1.5)));
+  }
+  return rows;
+}
+
+} // namespace
+
+TEST(ParallelJson, SmallValuesMatchSerialEncoding) {
+  folly::dynamic value = folly::dynamic::object("a", 1)("b", folly::dynamic::array(1, 2));
+  EXPECT_EQ(folly::toJson(value).toStdString(), ParallelJson::toJson(value));
+
+  folly::dynamic small = makeRows(3);
+  EXPECT_EQ(folly::toJson(small).toStdString(), ParallelJson::toJson(small));
+}
+
+TEST(ParallelJson, LargeArraysMatchSerialEncoding) {
+  folly::dynamic large = makeRows(500);
+  EXPECT_EQ(folly::toJson(large).toStdString(), ParallelJson::toJson(large));
+}
+
+TEST(ParallelJson, RepeatedEncodesAreStable) {
+  folly::dynamic large = makeRows(200);
+  std::string first = ParallelJson::toJson(large);
+  for (int i = 0; i < 10; i++) {
+    EXPECT_EQ(first, ParallelJson::toJson(large));
+  }
+}
@@ -0,0 +1,45 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include <gtest/gtest.h>
+#include <folly/json.h>
+#include <react/TraceRecorder.h>
+
+using namespace facebook;
+using namespace facebook::react;
+
+TEST(TraceRecorder, DisabledRecordsNothing) {
+  TraceRecorder::setEnabled(false);
+  {
+    TraceRecorder::Section s("disabled-section");
+  }
+  auto trace = folly::parseJson(TraceRecorder::dumpChromeTrace());
+  for (auto& event : trace["traceEvents"]) {
+    EXPECT_NE("disabled-section", event["name"].getString());
+  }
+}
+
+TEST(TraceRecorder, SectionsComeOutAsBeginEndPairs) {
+  TraceRecorder::setEnabled(true);
+  {
+    TraceRecorder::Section s("test-section");
+  }
+  TraceRecorder::setEnabled(false);
+
+  auto trace = folly::parseJson(TraceRecorder::dumpChromeTrace());
+  uint64_t beginTs = 0;
+  int begins = 0, ends = 0;
+  for (auto& event : trace["traceEvents"]) {
+    if (event["name"].getString() != "test-section") {
+      continue;
+    }
+    if (event["ph"].getString() == "B") {
+      begins++;
+      beginTs = event["ts"].getInt();
+    } else {
+      ends++;
+      EXPECT_GE((uint64_t)event["ts"].getInt(), beginTs);
+    }
+  }
+  EXPECT_EQ(1, begins);
+  EXPECT_EQ(1, ends);
+}
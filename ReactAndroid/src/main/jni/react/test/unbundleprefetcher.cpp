@@ -0,0 +1,88 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <thread>
+
+#include <gtest/gtest.h>
+#include <react/UnbundlePrefetcher.h>
+
+using namespace facebook;
+using namespace facebook::react;
+
+namespace {
+
+class CountingUnbundle : public JSModulesUnbundle {
+public:
+  Module getModule(uint32_t moduleId) const override {
+    fetched.push_back(moduleId);
+    return {"module", "code"};
+  }
+
+  mutable std::vector<uint32_t> fetched;
+};
+
+std::string tempProfilePath() {
+  return "/tmp/rn-require-profile-test";
+}
+
+} // namespace
+
+TEST(UnbundlePrefetcher, RecordsAndPersistsRequireOrder) {
+  std::string path = tempProfilePath();
+  remove(path.c_str());
+
+  CountingUnbundle unbundle;
+  {
+    UnbundlePrefetcher prefetcher;
+    prefetcher.start(&unbundle, path);
+    prefetcher.recordRequire(12);
+    prefetcher.recordRequire(7);
+    prefetcher.recordRequire(42);
+    prefetcher.shutdown();
+  }
+
+  std::ifstream profile(path);
+  ASSERT_TRUE((bool)profile);
+  uint32_t a, b, c;
+  profile >> a >> b >> c;
+  EXPECT_EQ(12, a);
+  EXPECT_EQ(7, b);
+  EXPECT_EQ(42, c);
+  remove(path.c_str());
+}
+
+TEST(UnbundlePrefetcher, WarmsProfiledModulesInOrder) {
+  std::string path = tempProfilePath();
+  {
+    std::ofstream profile(path);
+    profile << 3 << "\n" << 1 << "\n" << 2 << "\n";
+  }
+
+  CountingUnbundle unbundle;
+  UnbundlePrefetcher prefetcher;
+  prefetcher.start(&unbundle, path);
+
+  // The prefetch thread is detached; wait for it to get through the profile.
+  for (int i = 0; i < 100 && unbundle.fetched.size() < 3; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  prefetcher.shutdown();
+
+  ASSERT_EQ(3, unbundle.fetched.size());
+  EXPECT_EQ(3, unbundle.fetched[0]);
+  EXPECT_EQ(1, unbundle.fetched[1]);
+  EXPECT_EQ(2, unbundle.fetched[2]);
+  remove(path.c_str());
+}
+
+TEST(UnbundlePrefetcher, EmptyPathDisablesRecording) {
+  CountingUnbundle unbundle;
+  UnbundlePrefetcher prefetcher;
+  prefetcher.start(&unbundle, "");
+  prefetcher.recordRequire(1);
+  prefetcher.shutdown();
+  EXPECT_EQ(0, unbundle.fetched.size());
+}
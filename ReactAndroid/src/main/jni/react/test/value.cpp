@@ -36,3 +36,41 @@ TEST(Value, ToJSONString) {
 
 }
 
+
+TEST(Value, FromDynamic) {
+  JSContextRef ctx = JSGlobalContextCreateInGroup(nullptr, nullptr);
+  folly::dynamic dyn = folly::dynamic::object
+      ("string", "foo")
+      ("number", 4.5)
+      ("bool", true)
+      ("null", nullptr)
+      ("array", folly::dynamic::array(1, "two", false));
+  Value v(Value::fromDynamic(ctx, dyn));
+  EXPECT_TRUE(JSValueIsObject(ctx, v));
+  EXPECT_EQ(folly::toJson(dyn), folly::toJson(folly::parseJson(v.toJSONString())));
+}
+
+TEST(Value, ToStringPiece) {
+  String s("hello \xc3\xa9 world");
+  auto piece = s.toStringPiece();
+  EXPECT_EQ("hello \xc3\xa9 world", piece.str());
+  // The backing buffer is NUL-terminated just past the piece.
+  EXPECT_EQ('\0', piece.data()[piece.size()]);
+  EXPECT_EQ(piece.str(), s.str());
+}
+
+TEST(Value, Utf16View) {
+  String s("abc");
+  const JSChar* chars = s.utf16();
+  ASSERT_EQ(3, s.length());
+  EXPECT_EQ('a', chars[0]);
+  EXPECT_EQ('c', chars[2]);
+}
+
+TEST(Value, ToDynamicRoundTrip) {
+  JSContextRef ctx = JSGlobalContextCreateInGroup(nullptr, nullptr);
+  folly::dynamic dyn = folly::dynamic::array(
+      7, "str", folly::dynamic::object("nested", folly::dynamic::array(1.5, nullptr)));
+  Value v(Value::fromDynamic(ctx, dyn));
+  EXPECT_EQ(dyn, v.toDynamic());
+}
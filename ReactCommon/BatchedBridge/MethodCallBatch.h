@@ -0,0 +1,94 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include <cstddef>
+
+namespace facebook {
+namespace react {
+
+// Platform-neutral core of the batched bridge: the shape of the
+// [moduleIds, methodIds, paramArrays, callId?] batch every runtime receives
+// from a JS flush, and the validation and call-order walk over it. The
+// Android and Ubuntu bridges each implemented this separately, so batch
+// format changes had to be made twice; both now delegate here.
+//
+// The core is templated over the host value model via a traits struct so
+// neither runtime drags in the other's dependencies (folly::dynamic on
+// Android, QVariant on Ubuntu). Traits must provide:
+//
+//   typename ValueRef;                         // how at() hands values back:
+//                                              // a const reference where
+//                                              // copies are deep, a value
+//                                              // where they are shared
+//   static bool isArray(const Value&);
+//   static size_t size(const Value&);
+//   static ValueRef at(const Value&, size_t);
+//   static bool isInt(const Value&);
+//   static int toInt(const Value&);
+
+enum BatchField {
+  BatchFieldModuleIds = 0,
+  BatchFieldMethodIds = 1,
+  BatchFieldParams = 2,
+  BatchFieldCallId = 3,
+};
+
+// Walks a batch in call order, invoking
+//   onCall(int moduleId, int methodId, size_t callIndex, int callId)
+// per call. Argument extraction stays with the caller - callIndex addresses
+// the params array - so each runtime can move or convert arguments in its
+// own value model without the core forcing a copy. On a malformed batch
+// onError(const char*) is invoked and the walk stops; the Android adapter
+// throws from it, the Qt adapter logs.
+template <typename Traits, typename Value, typename OnCall, typename OnError>
+void forEachMethodCall(const Value& batch, OnCall&& onCall, OnError&& onError) {
+  if (!Traits::isArray(batch)) {
+    onError("batch is not an array");
+    return;
+  }
+  if (Traits::size(batch) < BatchFieldParams + 1) {
+    onError("batch has too few fields");
+    return;
+  }
+
+  typename Traits::ValueRef moduleIds = Traits::at(batch, BatchFieldModuleIds);
+  typename Traits::ValueRef methodIds = Traits::at(batch, BatchFieldMethodIds);
+  typename Traits::ValueRef params = Traits::at(batch, BatchFieldParams);
+  if (!Traits::isArray(moduleIds) || !Traits::isArray(methodIds) || !Traits::isArray(params)) {
+    onError("batch fields are not arrays");
+    return;
+  }
+
+  const size_t count = Traits::size(moduleIds);
+  if (Traits::size(methodIds) != count || Traits::size(params) != count) {
+    onError("batch field lengths do not match");
+    return;
+  }
+
+  int callId = -1;
+  if (Traits::size(batch) > BatchFieldCallId) {
+    typename Traits::ValueRef id = Traits::at(batch, BatchFieldCallId);
+    if (!Traits::isInt(id)) {
+      onError("batch callId is not an int");
+      return;
+    }
+    callId = Traits::toInt(id);
+  }
+
+  for (size_t i = 0; i < count; i++) {
+    if (!Traits::isArray(Traits::at(params, i))) {
+      onError("call arguments are not an array");
+      return;
+    }
+    onCall(Traits::toInt(Traits::at(moduleIds, i)),
+           Traits::toInt(Traits::at(methodIds, i)),
+           i,
+           callId);
+    // callId is optional; when present each call in the batch gets its own.
+    callId += (callId != -1) ? 1 : 0;
+  }
+}
+
+} // namespace react
+} // namespace facebook
@@ -0,0 +1,192 @@
+/**
+ * Copyright (C) 2016, Canonical Ltd.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <algorithm>
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMouseEvent>
+#include <QMutexLocker>
+#include <QQuickView>
+#include <QTimer>
+
+#include <QDebug>
+
+#include "benchmark.h"
+#include "reacttrace.h"
+
+
+namespace {
+
+double percentileMs(const QVector<double>& sorted, double p)
+{
+  if (sorted.isEmpty())
+    return 0;
+  return sorted.at(int((sorted.size() - 1) * p));
+}
+
+// VmHWM from /proc/self/status; the high-water mark survives any frees the
+// run ends with, which is the number capacity planning wants.
+qint64 peakRssKb()
+{
+  QFile status("/proc/self/status");
+  if (!status.open(QIODevice::ReadOnly))
+    return -1;
+  while (!status.atEnd()) {
+    const QByteArray line = status.readLine();
+    if (line.startsWith("VmHWM:"))
+      return line.mid(6).trimmed().split(' ').first().toLongLong();
+  }
+  return -1;
+}
+
+} // namespace
+
+ReactBenchmark::ReactBenchmark(QQuickView* view, const QString& scenarioPath, QObject* parent)
+  : QObject(parent)
+  , m_view(view)
+  , m_scenarioPath(scenarioPath)
+{
+  QFile file(scenarioPath);
+  if (!file.open(QIODevice::ReadOnly)) {
+    qWarning() << "Could not open benchmark scenario" << scenarioPath;
+    return;
+  }
+  QJsonParseError error;
+  const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &error);
+  if (!document.isObject()) {
+    qWarning() << "Could not parse benchmark scenario" << scenarioPath << error.errorString();
+    return;
+  }
+  m_scenario = document.object().toVariantMap();
+  m_valid = true;
+
+  const QString replay = m_scenario.value("replay").toString();
+  if (!replay.isEmpty())
+    qputenv("REACT_REPLAY_FILE", QFileInfo(replay).absoluteFilePath().toLocal8Bit());
+
+  // The trace buffer doubles as the bridge latency source for the report;
+  // the Chrome trace it dumps on exit is a useful side artifact.
+  if (!qEnvironmentVariableIsSet("REACT_TRACE_FILE"))
+    qputenv("REACT_TRACE_FILE", (scenarioPath + ".trace.json").toLocal8Bit());
+}
+
+bool ReactBenchmark::valid() const
+{
+  return m_valid;
+}
+
+QString ReactBenchmark::bundle() const
+{
+  return m_scenario.value("bundle").toString();
+}
+
+QString ReactBenchmark::executor() const
+{
+  const QString executor = m_scenario.value("executor").toString();
+  if (!executor.isEmpty())
+    return executor;
+  return m_scenario.value("replay").toString().isEmpty() ? QString() : "ReactReplayExecutor";
+}
+
+void ReactBenchmark::start()
+{
+  m_clock.start();
+
+  // Direct connection: frameSwapped fires on the render thread, and stamping
+  // there keeps scheduler jitter out of the deltas.
+  connect(m_view, &QQuickWindow::frameSwapped,
+          this, &ReactBenchmark::frameSwapped, Qt::DirectConnection);
+
+  for (const QVariant& entry : m_scenario.value("touches").toList()) {
+    const QVariantMap touch = entry.toMap();
+    QTimer::singleShot(touch.value("atMs").toInt(), this, [=] {
+      deliverTouch(touch);
+    });
+  }
+
+  QTimer::singleShot(m_scenario.value("durationMs", 10000).toInt(), this, [=] {
+    finish();
+  });
+}
+
+void ReactBenchmark::frameSwapped()
+{
+  const qint64 now = m_clock.nsecsElapsed();
+  QMutexLocker locker(&m_framesLock);
+  if (m_lastFrameNs >= 0)
+    m_frameDeltasMs.append((now - m_lastFrameNs) / 1e6);
+  m_lastFrameNs = now;
+}
+
+void ReactBenchmark::deliverTouch(const QVariantMap& touch)
+{
+  const QString type = touch.value("type").toString();
+  QEvent::Type eventType;
+  Qt::MouseButton button = Qt::LeftButton;
+  Qt::MouseButtons buttons = Qt::LeftButton;
+  if (type == "press") {
+    eventType = QEvent::MouseButtonPress;
+  } else if (type == "move") {
+    eventType = QEvent::MouseMove;
+    button = Qt::NoButton;
+  } else if (type == "release") {
+    eventType = QEvent::MouseButtonRelease;
+    buttons = Qt::NoButton;
+  } else {
+    qWarning() << "Unknown benchmark touch type" << type;
+    return;
+  }
+
+  QPointF position(touch.value("x").toDouble(), touch.value("y").toDouble());
+  QMouseEvent event(eventType, position, button, buttons, Qt::NoModifier);
+  QCoreApplication::sendEvent(m_view, &event);
+}
+
+void ReactBenchmark::finish()
+{
+  QVector<double> deltas;
+  {
+    QMutexLocker locker(&m_framesLock);
+    deltas = m_frameDeltasMs;
+  }
+  std::sort(deltas.begin(), deltas.end());
+
+  QJsonObject frames;
+  frames["count"] = deltas.size();
+  frames["p50Ms"] = percentileMs(deltas, 0.50);
+  frames["p90Ms"] = percentileMs(deltas, 0.90);
+  frames["p99Ms"] = percentileMs(deltas, 0.99);
+  frames["maxMs"] = deltas.isEmpty() ? 0 : deltas.last();
+
+  QJsonObject report;
+  report["scenario"] = m_scenarioPath;
+  report["durationMs"] = double(m_clock.elapsed());
+  report["frames"] = frames;
+  report["bridge"] = QJsonObject::fromVariantMap(reactTraceRequestSummary());
+  report["peakRssKb"] = double(peakRssKb());
+
+  const QByteArray json = QJsonDocument(report).toJson();
+  const QString output = m_scenario.value("output").toString();
+  if (output.isEmpty()) {
+    fwrite(json.constData(), 1, json.size(), stdout);
+    fflush(stdout);
+  } else {
+    QFile file(output);
+    if (file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+      file.write(json);
+    else
+      qWarning() << "Could not write benchmark report to" << output;
+  }
+
+  QCoreApplication::exit(0);
+}
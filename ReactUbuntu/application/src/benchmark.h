@@ -0,0 +1,79 @@
+/**
+ * Copyright (C) 2016, Canonical Ltd.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QObject>
+#include <QString>
+#include <QVariant>
+#include <QVector>
+
+class QQuickView;
+
+// Scripted scenario driver behind the --benchmark flag. Runs the normal
+// application boot against a recorded bundle, replays recorded bridge
+// traffic through ReactReplayExecutor, synthesizes a scripted input stream,
+// and exits with a machine-readable report: frame-time percentiles off
+// frameSwapped, the bridge request latency summary off the trace buffer,
+// and peak RSS. Pairs with the offscreen QML platform so CI can run it
+// without a display.
+//
+// The scenario is a JSON file:
+//
+//   {
+//     "bundle": "session.bundle.js",
+//     "replay": "session.replay",
+//     "durationMs": 10000,
+//     "touches": [{"atMs": 1200, "type": "press", "x": 120, "y": 400}, ...],
+//     "output": "report.json"
+//   }
+//
+// touches use types press/move/release; output defaults to stdout. A
+// Chrome trace of the run lands next to the scenario unless
+// REACT_TRACE_FILE already points somewhere.
+class ReactBenchmark : public QObject
+{
+  Q_OBJECT
+
+public:
+  ReactBenchmark(QQuickView* view, const QString& scenarioPath, QObject* parent = 0);
+
+  bool valid() const;
+
+  // Overrides for the application's launch properties; empty when the
+  // scenario leaves one to the command line.
+  QString bundle() const;
+  QString executor() const;
+
+  // Call once the view is up; arms the input and duration timers and starts
+  // frame sampling.
+  void start();
+
+private Q_SLOTS:
+  void frameSwapped();
+
+private:
+  void deliverTouch(const QVariantMap& touch);
+  void finish();
+
+  QQuickView* m_view;
+  QString m_scenarioPath;
+  QVariantMap m_scenario;
+  bool m_valid = false;
+
+  QElapsedTimer m_clock;
+  QMutex m_framesLock;
+  QVector<double> m_frameDeltasMs;
+  qint64 m_lastFrameNs = -1;
+};
+
+#endif // BENCHMARK_H
@@ -19,12 +19,15 @@
 #include "reactrawtextproperties.h"
 #include "reactitem.h"
 #include "reactview.h"
+#include "reactenginepool.h"
+#include "benchmark.h"
 
 
 // TODO: some way to change while running
 class ReactNativeProperties : public QObject {
   Q_OBJECT
   Q_PROPERTY(bool liveReload READ liveReload WRITE setLiveReload NOTIFY liveReloadChanged)
+  Q_PROPERTY(bool hotReload READ hotReload WRITE setHotReload NOTIFY hotReloadChanged)
   Q_PROPERTY(QUrl codeLocation READ codeLocation WRITE setCodeLocation NOTIFY codeLocationChanged)
   Q_PROPERTY(QString pluginsPath READ pluginsPath WRITE setPluginsPath NOTIFY pluginsPathChanged)
   Q_PROPERTY(QString executor READ executor WRITE setExecutor NOTIFY executorChanged)
@@ -41,6 +44,15 @@ public:
     m_liveReload = liveReload;
     Q_EMIT liveReloadChanged();
   }
+  bool hotReload() const {
+    return m_hotReload;
+  }
+  void setHotReload(bool hotReload) {
+    if (m_hotReload == hotReload)
+      return;
+    m_hotReload = hotReload;
+    Q_EMIT hotReloadChanged();
+  }
   QUrl codeLocation() const {
     return m_codeLocation;
   }
@@ -101,15 +113,18 @@ public:
       }
       setCodeLocation(QUrl::fromLocalFile(fi.absoluteFilePath()));
       setLiveReload(false);
+      setHotReload(false);
     }
   }
 Q_SIGNALS:
   void liveReloadChanged();
+  void hotReloadChanged();
   void codeLocationChanged();
   void pluginsPathChanged();
   void executorChanged();
 private:
   bool m_liveReload = false;
+  bool m_hotReload = false;
   QString m_packagerHost = "localhost";
   QString m_packagerPort = "8081";
   QString m_localSource;
@@ -131,6 +146,14 @@ void registerTypes()
 
 int main(int argc, char** argv)
 {
+  // The platform has to be chosen before QGuiApplication exists, so the
+  // benchmark flag is spotted ahead of the real parse; an explicit
+  // QT_QPA_PLATFORM still wins for benchmarking against a live display.
+  for (int i = 1; i < argc; ++i) {
+    if (qstrcmp(argv[i], "--benchmark") == 0 && !qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+      qputenv("QT_QPA_PLATFORM", "offscreen");
+  }
+
   QGuiApplication app(argc, argv);
   QQuickView view;
   ReactNativeProperties* rnp = new ReactNativeProperties(&view);
@@ -142,14 +165,17 @@ int main(int argc, char** argv)
   p.addHelpOption();
   p.addOptions({
     {{"R", "live-reload"}, "Enable live reload."},
+    {"hot-reload", "Enable module-level hot reload."},
     {{"H", "host"}, "Set packager host address.", rnp->packagerHost()},
     {{"P", "port"}, "Set packager port number.", rnp->packagerPort()},
     {{"L", "local"}, "Set path to the local packaged source", "not set"},
     {{"M", "plugins-path"}, "Set path to node modules", "./plugins"},
     {{"E", "executor"}, "Set Javascript executor", rnp->executor()},
+    {"benchmark", "Run a headless benchmark scenario and exit.", "scenario"},
   });
   p.process(app);
   rnp->setLiveReload(p.isSet("live-reload"));
+  rnp->setHotReload(p.isSet("hot-reload"));
   if (p.isSet("host"))
     rnp->setPackagerHost(p.value("host"));
   if (p.isSet("port"))
@@ -161,11 +187,29 @@ int main(int argc, char** argv)
   if (p.isSet("executor"))
     rnp->setExecutor(p.value("executor"));
 
+  ReactBenchmark* benchmark = nullptr;
+  if (p.isSet("benchmark")) {
+    benchmark = new ReactBenchmark(&view, p.value("benchmark"), &view);
+    if (!benchmark->valid())
+      return 1;
+    if (!benchmark->bundle().isEmpty())
+      rnp->setLocalSource(benchmark->bundle());
+    if (!benchmark->executor().isEmpty())
+      rnp->setExecutor(benchmark->executor());
+  }
+
   view.rootContext()->setContextProperty("ReactNativeProperties", rnp);
+  // Resolve the React imports in the view's engine before the root QML
+  // loads; the first ReactView then finds plugins loaded and imports
+  // resolved.
+  ReactEnginePool::prewarm(view.engine());
   view.setSource(QUrl("qrc:///main.qml"));
   view.setResizeMode(QQuickView::SizeRootObjectToView);
   view.show();
 
+  if (benchmark != nullptr)
+    benchmark->start();
+
   return app.exec();
 }
 
@@ -14,13 +14,24 @@
 #include <iterator>
 #include <algorithm>
 
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
 #include <QGuiApplication>
-#include <QStandardPaths>
+#include <QSaveFile>
 #include <QSettings>
+#include <QStandardPaths>
+#include <QThread>
+#include <QTimer>
 
 #include <QDebug>
 
+#ifdef Q_OS_UNIX
+#include <unistd.h>
+#endif
+
 #include "reactasynclocalstorage.h"
+#include "reactbridge.h"
 
 
 namespace {
@@ -30,6 +41,12 @@ QVariantMap makeError(const QString& message, const QVariantMap& extraData = QVa
   rc.insert("message", message);
   return rc;
 }
+
+enum JournalOp { Op_Set = 1, Op_Remove, Op_Clear };
+
+// Compact once the journal carries this many records and most of them no
+// longer contribute to the live table.
+const int kCompactThreshold = 1024;
 }
 
 
@@ -37,7 +54,7 @@ void ReactAsyncLocalStorage::multiGet(
   const QList<QString>& keys,
   const ReactModuleInterface::ListArgumentBlock& callback
 ) {
-  if (m_settings == nullptr) {
+  if (m_journal == nullptr) {
     callback(m_bridge, QVariantList{
       QVariantList{makeError("Could not open storage file")}, QVariant()});
     return;
@@ -45,7 +62,8 @@ void ReactAsyncLocalStorage::multiGet(
 
   QVariantList rc;
   for (const QString& key : keys) {
-    rc.push_back(QVariantList{key, m_settings->value(key)});
+    auto it = m_table.constFind(key);
+    rc.push_back(QVariantList{key, it != m_table.constEnd() ? QVariant(it.value()) : QVariant()});
   }
   callback(m_bridge, QVariantList{QVariant(), rc});
 }
@@ -54,30 +72,92 @@ void ReactAsyncLocalStorage::multiSet(
       const QList<QList<QString>>& kvPairs,
       const ReactModuleInterface::ListArgumentBlock& callback
 ) {
-  if (m_settings == nullptr) {
+  if (m_journal == nullptr) {
     callback(m_bridge, QVariantList{
       QVariantList{makeError("Could not open storage file")}, QVariant()});
     return;
   }
 
   for (const QList<QString>& pair : kvPairs) {
-    m_settings->setValue(pair.first(), pair.last());
+    m_table.insert(pair.first(), pair.last());
+    appendRecord(Op_Set, pair.first(), pair.last());
   }
   callback(m_bridge, QVariantList{QVariant()});
 }
 
+bool ReactAsyncLocalStorage::invokeBridgeValueMethod(
+  ReactBridge* bridge,
+  const QString& methodName,
+  const ReactBridgeValueRef& args
+) {
+  const bool isGet = methodName == "multiGet";
+  if (!isGet && methodName != "multiSet")
+    return false;
+
+  // Shape check on the calling thread; anything unexpected falls back to
+  // the generic path and its diagnostics.
+  const ReactBridgeValue& argv = args.value();
+  if (argv.type != ReactBridgeValue::Array || argv.count() != 2 ||
+      argv.at(0).type != ReactBridgeValue::Array ||
+      argv.at(1).type != ReactBridgeValue::Int)
+    return false;
+
+  // Hop to the storage thread; the captured ref keeps the batch arena alive
+  // until the call has run.
+  if (QThread::currentThread() != thread()) {
+    QTimer::singleShot(0, this, [=] { invokeBridgeValueMethod(bridge, methodName, args); });
+    return true;
+  }
+
+  const ReactBridgeValue& payload = argv.at(0);
+  const int callbackId = int(argv.at(1).toInt());
+  auto respond = [=](const QVariantList& response) {
+    bridge->invokeAndProcess("invokeCallbackAndReturnFlushedQueue",
+                             QVariantList{callbackId, response});
+  };
+
+  if (m_journal == nullptr) {
+    respond(QVariantList{QVariantList{makeError("Could not open storage file")}, QVariant()});
+    return true;
+  }
+
+  if (isGet) {
+    QVariantList rc;
+    rc.reserve(payload.count());
+    for (int i = 0; i < payload.count(); ++i) {
+      const QString key = payload.at(i).toString();
+      auto it = m_table.constFind(key);
+      rc.push_back(QVariantList{key, it != m_table.constEnd() ? QVariant(it.value()) : QVariant()});
+    }
+    respond(QVariantList{QVariant(), rc});
+  } else {
+    for (int i = 0; i < payload.count(); ++i) {
+      const ReactBridgeValue& pair = payload.at(i);
+      if (pair.type != ReactBridgeValue::Array || pair.count() < 2)
+        continue;
+      const QString key = pair.at(0).toString();
+      const QString value = pair.at(1).toString();
+      m_table.insert(key, value);
+      appendRecord(Op_Set, key, value);
+    }
+    respond(QVariantList{QVariant()});
+  }
+  return true;
+}
+
 void ReactAsyncLocalStorage::multiRemove(
       const QList<QString>& keys,
       const ReactModuleInterface::ListArgumentBlock& callback
 ) {
-  if (m_settings == nullptr) {
+  if (m_journal == nullptr) {
     callback(m_bridge, QVariantList{
       QVariantList{makeError("Could not open storage file")}, QVariant()});
     return;
   }
 
   for (const QString& key : keys) {
-    m_settings->remove(key);
+    m_table.remove(key);
+    appendRecord(Op_Remove, key);
   }
   callback(m_bridge, QVariantList{QVariant()});
 }
@@ -85,26 +165,27 @@ void ReactAsyncLocalStorage::multiRemove(
 void ReactAsyncLocalStorage::clear(
       const ReactModuleInterface::ListArgumentBlock& callback
 ) {
-  if (m_settings == nullptr) {
+  if (m_journal == nullptr) {
     callback(m_bridge, QVariantList{
       QVariantList{makeError("Could not open storage file")}, QVariant()});
     return;
   }
 
-  m_settings->clear();
+  m_table.clear();
+  appendRecord(Op_Clear, QString());
   callback(m_bridge, QVariantList{QVariant()});
 }
 
 void ReactAsyncLocalStorage::getAllKeys(
       const ReactModuleInterface::ListArgumentBlock& callback
 ) {
-  if (m_settings == nullptr) {
+  if (m_journal == nullptr) {
     callback(m_bridge, QVariantList{
       QVariantList{makeError("Could not open storage file")}, QVariant()});
     return;
   }
 
-  QStringList sk = m_settings->allKeys();
+  QStringList sk = m_table.keys();
   QVariantList rc;
   std::transform(sk.begin(), sk.end(), std::back_inserter(rc), [](const QString& v) {
     return QVariant::fromValue(v);
@@ -116,12 +197,16 @@ void ReactAsyncLocalStorage::getAllKeys(
 ReactAsyncLocalStorage::ReactAsyncLocalStorage(QObject* parent)
   : QObject(parent)
   , m_bridge(nullptr)
-  , m_settings(nullptr)
+  , m_journal(nullptr)
+  , m_pendingRecords(0)
+  , m_journalRecords(0)
+  , m_flushScheduled(false)
 {
 }
 
 ReactAsyncLocalStorage::~ReactAsyncLocalStorage()
 {
+  flushJournal();
 }
 
 
@@ -143,10 +228,138 @@ void ReactAsyncLocalStorage::setBridge(ReactBridge* bridge)
       qCritical() << __PRETTY_FUNCTION__ << "No XDG_RUNTIME_DIR path set, cannot create local storage file.";
       return;
   }
-  m_settings = new QSettings(QString("%1/%2/react-state-store").arg(runtimeDir).arg(applicationName),
-                            QSettings::NativeFormat,
-                            this);
-  m_settings->setFallbacksEnabled(false);
+
+  const QString basePath = QString("%1/%2").arg(runtimeDir).arg(applicationName);
+  QDir().mkpath(basePath);
+  m_journalPath = basePath + "/react-state-store.journal";
+
+  bool migrated = false;
+  const QString legacyPath = basePath + "/react-state-store";
+  if (!QFile::exists(m_journalPath) && QFile::exists(legacyPath)) {
+    // One-time import of the old per-key QSettings store.
+    QSettings legacy(legacyPath, QSettings::NativeFormat);
+    legacy.setFallbacksEnabled(false);
+    for (const QString& key : legacy.allKeys()) {
+      m_table.insert(key, legacy.value(key).toString());
+    }
+    migrated = true;
+  } else {
+    loadJournal();
+  }
+
+  m_journal = new QFile(m_journalPath, this);
+  if (!m_journal->open(QIODevice::WriteOnly | QIODevice::Append)) {
+    qCritical() << __PRETTY_FUNCTION__ << "Could not open storage journal" << m_journalPath;
+    delete m_journal;
+    m_journal = nullptr;
+    return;
+  }
+
+  if (migrated)
+    compactJournal();
+}
+
+void ReactAsyncLocalStorage::loadJournal()
+{
+  QFile in(m_journalPath);
+  if (!in.open(QIODevice::ReadOnly))
+    return;
+
+  QDataStream stream(&in);
+  stream.setVersion(QDataStream::Qt_5_0);
+  while (!stream.atEnd()) {
+    quint8 op = 0;
+    QString key;
+    QString value;
+    stream >> op;
+    if (op == Op_Set)
+      stream >> key >> value;
+    else if (op == Op_Remove)
+      stream >> key;
+    if (stream.status() != QDataStream::Ok)
+      break; // torn tail from an interrupted append; drop it
+    switch (op) {
+    case Op_Set: m_table.insert(key, value); break;
+    case Op_Remove: m_table.remove(key); break;
+    case Op_Clear: m_table.clear(); break;
+    default: return; // unknown record, cannot trust the rest of the log
+    }
+    ++m_journalRecords;
+  }
+}
+
+void ReactAsyncLocalStorage::appendRecord(quint8 op, const QString& key, const QString& value)
+{
+  QDataStream stream(&m_pending, QIODevice::WriteOnly | QIODevice::Append);
+  stream.setVersion(QDataStream::Qt_5_0);
+  stream << op;
+  if (op == Op_Set)
+    stream << key << value;
+  else if (op == Op_Remove)
+    stream << key;
+  ++m_pendingRecords;
+
+  // Write-behind; everything stored this event loop turn goes to disk as a
+  // single sequential append with one fsync.
+  if (!m_flushScheduled) {
+    m_flushScheduled = true;
+    QTimer::singleShot(0, this, SLOT(flushJournal()));
+  }
+}
+
+void ReactAsyncLocalStorage::flushJournal()
+{
+  m_flushScheduled = false;
+  if (m_pending.isEmpty() || m_journal == nullptr)
+    return;
+
+  m_journal->write(m_pending);
+  m_journal->flush();
+#ifdef Q_OS_UNIX
+  fsync(m_journal->handle());
+#endif
+  m_journalRecords += m_pendingRecords;
+  m_pending.clear();
+  m_pendingRecords = 0;
+
+  if (m_journalRecords > kCompactThreshold && m_journalRecords > 4 * m_table.size())
+    compactJournal();
+}
+
+void ReactAsyncLocalStorage::compactJournal()
+{
+  QSaveFile out(m_journalPath);
+  if (!out.open(QIODevice::WriteOnly))
+    return;
+
+  QDataStream stream(&out);
+  stream.setVersion(QDataStream::Qt_5_0);
+  for (auto it = m_table.constBegin(); it != m_table.constEnd(); ++it) {
+    stream << quint8(Op_Set) << it.key() << it.value();
+  }
+  if (!out.commit())
+    return;
+
+  m_journalRecords = m_table.size();
+  reopenJournal();
+}
+
+void ReactAsyncLocalStorage::reopenJournal()
+{
+  if (m_journal == nullptr)
+    return;
+  // The compacted file replaced ours on disk; reopen so appends land there.
+  m_journal->close();
+  if (!m_journal->open(QIODevice::WriteOnly | QIODevice::Append)) {
+    qCritical() << __PRETTY_FUNCTION__ << "Could not reopen storage journal" << m_journalPath;
+    delete m_journal;
+    m_journal = nullptr;
+  }
+}
+
+ReactModuleInterface::ThreadAffinity ReactAsyncLocalStorage::threadAffinity() const
+{
+  return DedicatedThread;
 }
 
 ReactViewManager* ReactAsyncLocalStorage::viewManager()
@@ -168,4 +381,3 @@ QVariantMap ReactAsyncLocalStorage::constantsToExport()
 {
   return QVariantMap{};
 }
-
@@ -15,12 +15,13 @@
 #define REACTASYNCLOCALSTORAGE_H
 
 #include <QByteArray>
+#include <QHash>
 #include <QUrl>
 
 #include "reactmoduleinterface.h"
 
 
-class QSettings;
+class QFile;
 
 
 class ReactAsyncLocalStorage
@@ -51,6 +52,10 @@ public:
 
   void setBridge(ReactBridge* bridge) override;
 
+  // Journal writes and fsyncs must never stall the GUI thread; a dedicated
+  // thread also keeps get/set ordering without any locking.
+  ThreadAffinity threadAffinity() const override;
+
   // TODO: this doesnt seem right
   ReactViewManager* viewManager() override;
 
@@ -58,9 +63,34 @@ public:
   QList<ReactModuleMethod*> methodsToExport() override;
   QVariantMap constantsToExport() override;
 
+  // multiGet/multiSet bursts (session restore reads ~200 keys at launch)
+  // decode their key and pair arrays straight from the wire value instead of
+  // boxing every element through the QVariant coercion machinery.
+  bool invokeBridgeValueMethod(ReactBridge* bridge,
+                               const QString& methodName,
+                               const ReactBridgeValueRef& args) override;
+
+private Q_SLOTS:
+  void flushJournal();
+
 private:
+  void loadJournal();
+  void appendRecord(quint8 op, const QString& key, const QString& value = QString());
+  void compactJournal();
+  void reopenJournal();
+
   ReactBridge* m_bridge;
-  QSettings* m_settings;
+
+  // Reads are served entirely from the in-memory table; mutations append to
+  // a write-behind journal which is group-committed (one write and one fsync
+  // per batch) and compacted once it is mostly dead records.
+  QFile* m_journal;
+  QString m_journalPath;
+  QHash<QString, QString> m_table;
+  QByteArray m_pending;
+  int m_pendingRecords;
+  int m_journalRecords;
+  bool m_flushScheduled;
 };
 
 #endif // REACTASYNCLOCALSTORAGE_H
@@ -0,0 +1,45 @@
+
+/**
+ * Copyright (C) 2016, Canonical Ltd.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ *
+ * Author: Justin McPherson <justin.mcpherson@canonical.com>
+ *
+ */
+
+#include <QHash>
+#include <QVector>
+
+#include "reactatoms.h"
+
+
+namespace {
+QHash<QString, int> atomTable;
+QVector<QString> atomNames;
+}
+
+int reactAtom(const QString& name)
+{
+  auto it = atomTable.constFind(name);
+  if (it != atomTable.constEnd())
+    return it.value();
+
+  const int atom = atomNames.size();
+  atomNames.push_back(name);
+  atomTable.insert(name, atom);
+  return atom;
+}
+
+const QString& reactAtomName(int atom)
+{
+  return atomNames.at(atom);
+}
+
+int reactAtomCount()
+{
+  return atomNames.size();
+}
@@ -0,0 +1,37 @@
+
+/**
+ * Copyright (C) 2016, Canonical Ltd.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ *
+ * Author: Justin McPherson <justin.mcpherson@canonical.com>
+ *
+ */
+
+#ifndef REACTATOMS_H
+#define REACTATOMS_H
+
+#include <QString>
+
+
+// Process-wide interned name table. Prop, event and method names form a
+// small fixed vocabulary per application, so they are minted into dense
+// integer atoms on first sight; tables on the update path can then index an
+// array by atom instead of hashing and comparing QStrings per write. Atoms
+// are never recycled. Like the rest of the view update machinery this runs
+// on the GUI thread only.
+
+// Returns the atom for name, minting the next one on first sight.
+int reactAtom(const QString& name);
+
+// The name an atom was minted for; valid for the life of the process.
+const QString& reactAtomName(int atom);
+
+// One past the highest atom handed out; the size to which atom-indexed
+// tables need to grow.
+int reactAtomCount();
+
+#endif // REACTATOMS_H
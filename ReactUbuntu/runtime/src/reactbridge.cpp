@@ -12,16 +12,29 @@
  */
 
 #include <QStandardPaths>
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
 #include <QMap>
 #include <QDir>
 #include <QPluginLoader>
-#include <QJsonDocument>
+#include <QQmlComponent>
 #include <QQuickItem>
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThread>
+#include <QThreadPool>
 #include <QTimer>
 #include <QNetworkAccessManager>
 #include <QNetworkDiskCache>
+#include <QNetworkRequest>
+
+#include <BatchedBridge/MethodCallBatch.h>
 
 #include "reactbridge.h"
+#include "reactjsonvalue.h"
 #include "reactsourcecode.h"
 #include "reactnetexecutor.h"
 #include "reactmoduleloader.h"
@@ -30,11 +43,22 @@
 #include "reactmodulemethod.h"
 
 #include "reacteventdispatcher.h"
+#include "reactscheduler.h"
+#include "reactrequestscheduler.h"
+#include "reactwarmup.h"
+#include "reactenginepool.h"
+#include "reactcachestats.h"
+#include "reactthreadscheduling.h"
+#include "reacttrace.h"
+#include "reactmemorybudget.h"
+#include "reactframemonitor.h"
 #include "reactnetworking.h"
 #include "reactnetinfo.h"
+#include "reactwebsocket.h"
 #include "reacttiming.h"
 #include "reactappstate.h"
 #include "reactasynclocalstorage.h"
+#include "reactnativeanimation.h"
 #include "reactviewmanager.h"
 #include "reactrawtextmanager.h"
 #include "reacttextmanager.h"
@@ -62,33 +86,52 @@ public:
   QQuickItem* visualParent = nullptr;
   ReactRedboxItem* redbox = nullptr;
   QNetworkAccessManager* nam = nullptr;
+  ReactRequestScheduler* requestScheduler = nullptr;
   ReactUIManager* uiManager = nullptr;
   ReactImageLoader* imageLoader = nullptr;
   ReactSourceCode* sourceCode = nullptr;
   ReactEventDispatcher* eventDispatcher = nullptr;
+  ReactScheduler* scheduler = nullptr;
   QUrl bundleUrl;
   QString pluginsPath = "./plugins";
+  QUrl warmupManifest;
+  QVariantMap threadScheduling;
   QMap<int, ReactModuleData*> modules;
-
+  QThread* moduleWorker = nullptr;
+  QList<QThread*> moduleThreads;
+  QHash<QByteArray, QQmlComponent*> blueprints;
+  bool blueprintsWarmed = false;
+  bool warmupRun = false;
+
+  // Batch transaction state. While a batch applies, calls back into JS and
+  // nested executor results are parked here and replayed once the batch has
+  // committed, so modules never observe a half-applied batch and JS never
+  // interleaves with one.
+  bool inBatch = false;
+  struct DeferredCall {
+    QString module;
+    QString method;
+    QVariantList args;
+  };
+  QList<DeferredCall> deferredCalls;
+  QList<ReactBridgeValueRef> pendingResults;
+
+  // View managers only; the rest of the internal modules are registered
+  // lazily from their static meta-objects in initModules.
   QObjectList internalModules() {
     return QObjectList {
-      new ReactTiming,
-      new ReactAppState,
-      new ReactAsyncLocalStorage,
-      new ReactNetworking,
-      new ReactNetInfo,
       new ReactViewManager,
       new ReactRawTextManager,
       new ReactTextManager,
       new ReactImageManager,
-      new ReactExceptionsManager,
     };
   }
 
-  QObjectList pluginModules() {
+  QObjectList pluginModules(QList<ReactModuleRegistration>* registrations) {
     QObjectList modules;
     UbuntuComponentsLoader loader;
     modules << loader.availableModules();
+    *registrations << loader.moduleRegistrations();
     // for (QObject* o : QPluginLoader::staticInstances()) {
     //   ReactModuleLoader* ml = qobject_cast<ReactModuleLoader*>(o);
     //   if (o == nullptr)
@@ -117,6 +160,7 @@ public:
         continue;
       }
       modules << ml->availableModules();
+      *registrations << ml->moduleRegistrations();
     }
 
     return modules;
@@ -124,6 +168,83 @@ public:
 };
 
 
+namespace
+{
+// Adapts the shared batched-bridge core to the arena-backed value model the
+// executors hand back. Values are plain structs inside one allocation, so
+// handing references back costs nothing and walking the batch allocates
+// nothing; only the argument list of each invoked call is converted to
+// QVariant, at the QMetaMethod::invoke boundary.
+struct BridgeValueTraits
+{
+  typedef const ReactBridgeValue& ValueRef;
+  static bool isArray(const ReactBridgeValue& value) { return value.type == ReactBridgeValue::Array; }
+  static size_t size(const ReactBridgeValue& value) { return value.count(); }
+  static ValueRef at(const ReactBridgeValue& value, size_t i) { return value.at(i); }
+  static bool isInt(const ReactBridgeValue& value) { return value.type == ReactBridgeValue::Int; }
+  static int toInt(const ReactBridgeValue& value) { return value.toInt(); }
+};
+
+// The module config is pure reflection over the binary and its plugins -
+// names, method tables, view prop types - so its serialized form is cached
+// across launches, keyed on the identity of what it reflects.
+QString moduleConfigCachePath(const QString& pluginsPath)
+{
+  QCryptographicHash hash(QCryptographicHash::Sha1);
+  const QFileInfo binary(QCoreApplication::applicationFilePath());
+  hash.addData(binary.absoluteFilePath().toUtf8());
+  hash.addData(QByteArray::number(binary.size()));
+  hash.addData(QByteArray::number(binary.lastModified().toMSecsSinceEpoch()));
+  QDir pluginsDir(pluginsPath);
+  for (const QFileInfo& plugin :
+       pluginsDir.entryInfoList(QStringList{"*.so"}, QDir::Files, QDir::Name)) {
+    hash.addData(plugin.absoluteFilePath().toUtf8());
+    hash.addData(QByteArray::number(plugin.size()));
+    hash.addData(QByteArray::number(plugin.lastModified().toMSecsSinceEpoch()));
+  }
+  return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) +
+    "/react-module-config-" + hash.result().toHex() + ".json";
+}
+
+// Registers a module without constructing it: the instance, and setBridge
+// side effects like NetInfo's connectivity monitoring, is only created when
+// JS first calls into the module.
+// Runs one module's meta-object scan on the global pool; see
+// ReactModuleData::introspect for what is and is not safe off-thread.
+class IntrospectTask : public QRunnable
+{
+public:
+  IntrospectTask(QObject* module, ReactModuleData::Introspection** slot, QSemaphore* done)
+    : m_module(module)
+    , m_slot(slot)
+    , m_done(done)
+  {
+  }
+
+  void run() override {
+    *m_slot = ReactModuleData::introspect(m_module);
+    m_done->release();
+  }
+
+private:
+  QObject* m_module;
+  ReactModuleData::Introspection** m_slot;
+  QSemaphore* m_done;
+};
+
+template<typename Module>
+ReactModuleData* lazyModuleData(ReactBridge* bridge, const char* name)
+{
+  return new ReactModuleData(Module::staticMetaObject, name, [bridge] {
+    Module* module = new Module;
+    module->setBridge(bridge);
+    bridge->setupModuleThread(module);
+    return static_cast<QObject*>(module);
+  });
+}
+}
+
+
 ReactBridge::ReactBridge(QObject* parent)
   : QObject(parent)
   , d_ptr(new ReactBridgePrivate)
@@ -132,10 +253,60 @@ ReactBridge::ReactBridge(QObject* parent)
 
 
   d->eventDispatcher = new ReactEventDispatcher(this);
+  d->scheduler = new ReactScheduler(this);
 }
 
 ReactBridge::~ReactBridge()
 {
+  Q_D(ReactBridge);
+  for (QThread* thread : d->moduleThreads) {
+    thread->quit();
+    thread->wait();
+  }
+}
+
+void ReactBridge::setupModuleThread(QObject* moduleImpl)
+{
+  Q_D(ReactBridge);
+
+  ReactModuleInterface* module = qobject_cast<ReactModuleInterface*>(moduleImpl);
+  switch (module->threadAffinity()) {
+  case ReactModuleInterface::GuiThread:
+    break;
+  case ReactModuleInterface::WorkerThread:
+    if (d->moduleWorker == nullptr) {
+      d->moduleWorker = new QThread(this);
+      d->moduleWorker->setObjectName("ReactModuleWorker");
+      d->moduleWorker->start();
+      reactApplyThreadScheduling("modules", d->moduleWorker);
+      d->moduleThreads.append(d->moduleWorker);
+    }
+    moduleImpl->moveToThread(d->moduleWorker);
+    break;
+  case ReactModuleInterface::DedicatedThread: {
+    QThread* thread = new QThread(this);
+    thread->setObjectName(module->moduleName() + "Thread");
+    thread->start();
+    reactApplyThreadScheduling("modules", thread);
+    d->moduleThreads.append(thread);
+    moduleImpl->moveToThread(thread);
+    break;
+  }
+  }
+}
+
+QQmlComponent* ReactBridge::componentForSource(const QByteArray& source)
+{
+  Q_D(ReactBridge);
+
+  auto it = d->blueprints.constFind(source);
+  if (it != d->blueprints.constEnd())
+    return it.value();
+
+  QQmlComponent* component = new QQmlComponent(d->qmlEngine, this);
+  component->setData(source, QUrl());
+  d->blueprints.insert(source, component);
+  return component;
 }
 
 void ReactBridge::setupExecutor()
@@ -166,6 +337,28 @@ void ReactBridge::init()
   initModules();
   injectModules();
   loadSource();
+
+  // Paint last session's first frame while the executor is still off
+  // fetching and evaluating the bundle; the real mount dismisses it.
+  if (d->uiManager != nullptr && d->visualParent != nullptr) {
+    d->uiManager->replayFirstFrameSnapshot();
+  }
+
+  if (!d->blueprintsWarmed) {
+    d->blueprintsWarmed = true;
+    // Compile every view manager's blueprint while the executor is off
+    // fetching and parsing the bundle - idle frames the GUI thread would
+    // otherwise spend waiting; first use of any view type then finds its
+    // component ready-made. One task per manager, so the compiles spread
+    // over frame time instead of landing in one long frame.
+    for (ReactModuleData* moduleData : d->modules) {
+      d->scheduler->schedule(ReactScheduler::CacheMaintenance, [=] {
+        ReactViewManager* manager = moduleData->viewManager();
+        if (manager != nullptr)
+          componentForSource(manager->componentSource());
+      });
+    }
+  }
 }
 
 void ReactBridge::reload()
@@ -190,21 +383,48 @@ void ReactBridge::reload()
 
 void ReactBridge::enqueueJSCall(const QString& module, const QString& method, const QVariantList& args)
 {
-  d_func()->executor->executeJSCall("callFunctionReturnFlushedQueue",
+  // Calls can originate on a module's declared worker thread; the executor
+  // and its transport live here, so hop over before touching them.
+  if (QThread::currentThread() != thread()) {
+    QTimer::singleShot(0, this, [=] { enqueueJSCall(module, method, args); });
+    return;
+  }
+
+  Q_D(ReactBridge);
+  if (d->inBatch) {
+    // A module reacting to a batch by calling straight back into JS (with
+    // the in-process executor, synchronously) would interleave a new batch
+    // with the half-applied one; it goes out when this batch has committed.
+    d->deferredCalls.append(ReactBridgePrivate::DeferredCall{module, method, args});
+    return;
+  }
+
+  d->executor->executeJSCall("callFunctionReturnFlushedQueue",
                                     QVariantList{module, method, args},
-                                    [=](const QJsonDocument& doc) {
-                                      processResult(doc);
+                                    [=](const ReactBridgeValueRef& result) {
+                                      processResult(result);
                                     });
 }
 
 void ReactBridge::invokeAndProcess(const QString& method, const QVariantList &args)
 {
-  d_func()->executor->executeJSCall(method, args, [=](const QJsonDocument& doc) { processResult(doc); });
+  if (QThread::currentThread() != thread()) {
+    QTimer::singleShot(0, this, [=] { invokeAndProcess(method, args); });
+    return;
+  }
+
+  d_func()->executor->executeJSCall(method, args, [=](const ReactBridgeValueRef& result) { processResult(result); });
 }
 
 void ReactBridge::executeSourceCode(const QByteArray& sourceCode)
 {
-  Q_UNUSED(sourceCode);
+  Q_D(ReactBridge);
+  // Evaluates straight into the running host - hot reload updates ride
+  // through here - and the completion flushes the JS queue like any script,
+  // so whatever the evaluation scheduled applies as a normal batch.
+  if (d->executor == nullptr)
+    return;
+  d->executor->executeApplicationScript(sourceCode, d->bundleUrl);
 }
 
 bool ReactBridge::ready() const
@@ -220,6 +440,16 @@ void ReactBridge::setReady(bool ready)
 
   d->ready = ready;
   emit readyChanged();
+
+  if (ready && !d->warmupRun) {
+    d->warmupRun = true;
+    // The application's declared warmup (deeper than the blueprint compiles
+    // scheduled at init: component instantiation, lazy module construction,
+    // image predecode) waits for ready since it reaches into modules and
+    // the image loader.
+    if (!d->warmupManifest.isEmpty())
+      (new ReactWarmup(this))->run(d->warmupManifest);
+  }
 }
 
 QQuickItem* ReactBridge::visualParent() const
@@ -246,6 +476,10 @@ void ReactBridge::setQmlEngine(QQmlEngine* qmlEngine)
   if (d->qmlEngine == qmlEngine)
     return;
   d->qmlEngine = qmlEngine;
+
+  // A real engine is serving React content now; any scratch engine the host
+  // prewarmed at launch has served its purpose.
+  ReactEnginePool::release();
 }
 
 QNetworkAccessManager* ReactBridge::networkAccessManager() const
@@ -265,7 +499,41 @@ void ReactBridge::setNetworkAccessManager(QNetworkAccessManager* nam)
     auto cache = new QNetworkDiskCache(d->nam);
     cache->setCacheDirectory(QStandardPaths::writableLocation(QStandardPaths::CacheLocation));
     d->nam->setCache(cache);
+
+    // Disk-backed rather than resident, but counted under the same budget
+    // so kiosk sessions cannot creep on either axis. Lowering the maximum
+    // triggers an expire pass; restoring it lets the cache refill.
+    const qint64 maximum = cache->maximumCacheSize();
+    ReactMemoryBudget::instance()->registerClient(
+      "network.diskcache", ReactMemoryBudget::Retainable, cache,
+      [cache] { return cache->cacheSize(); },
+      [cache, maximum](qint64 target) {
+        cache->setMaximumCacheSize(qMax(qint64(1), target));
+        cache->setMaximumCacheSize(maximum);
+      });
+
+    // QNetworkDiskCache answers lookups internally, so only its size is
+    // observable; hit rates for it come from the imageloader.url counters
+    // that front it.
+    reactCacheByteProbe("network.diskcache", [cache] { return cache->cacheSize(); });
   }
+
+  delete d->requestScheduler;
+  d->requestScheduler = new ReactRequestScheduler(d->nam, this);
+}
+
+ReactRequestScheduler* ReactBridge::requestScheduler() const
+{
+  return d_func()->requestScheduler;
+}
+
+void ReactBridge::prepareRequest(QNetworkRequest& request) const
+{
+  // Connection reuse is the manager's default behaviour; pipelining is a per
+  // request attribute in Qt and stays opt-in, some servers mishandle it.
+  static const bool pipelining = qgetenv("REACT_NET_PIPELINING").toInt() > 0;
+  if (pipelining)
+    request.setAttribute(QNetworkRequest::HttpPipeliningAllowedAttribute, true);
 }
 
 QUrl ReactBridge::bundleUrl() const
@@ -294,6 +562,33 @@ void ReactBridge::setPluginsPath(const QString& pluginsPath)
   d->pluginsPath = pluginsPath;
 }
 
+QUrl ReactBridge::warmupManifest() const
+{
+  return d_func()->warmupManifest;
+}
+
+void ReactBridge::setWarmupManifest(const QUrl& warmupManifest)
+{
+  Q_D(ReactBridge);
+  if (d->warmupManifest == warmupManifest)
+    return;
+  d->warmupManifest = warmupManifest;
+}
+
+QVariantMap ReactBridge::threadScheduling() const
+{
+  return d_func()->threadScheduling;
+}
+
+void ReactBridge::setThreadScheduling(const QVariantMap& threadScheduling)
+{
+  Q_D(ReactBridge);
+  if (d->threadScheduling == threadScheduling)
+    return;
+  d->threadScheduling = threadScheduling;
+  reactSetThreadSchedulingConfig(threadScheduling);
+}
+
 QString ReactBridge::executorName() const
 {
   return d_func()->executorName;
@@ -312,6 +607,11 @@ ReactEventDispatcher* ReactBridge::eventDispatcher() const
   return d_func()->eventDispatcher;
 }
 
+ReactScheduler* ReactBridge::scheduler() const
+{
+  return d_func()->scheduler;
+}
+
 QList<ReactModuleData*> ReactBridge::modules() const
 {
   return d_func()->modules.values();
@@ -366,9 +666,43 @@ void ReactBridge::initModules()
 {
   Q_D(ReactBridge);
 
+  // Modules with no constants or custom exports are constructed on first
+  // use; cold start no longer pays for timers, network monitoring or
+  // storage setup the session may never touch.
+  for (ReactModuleData* moduleData : QList<ReactModuleData*>{
+         lazyModuleData<ReactTiming>(this, "RCTTiming"),
+         lazyModuleData<ReactAppState>(this, "RCTAppState"),
+         lazyModuleData<ReactAsyncLocalStorage>(this, "RCTAsyncLocalStorage"),
+         lazyModuleData<ReactNetworking>(this, "RCTNetworking"),
+         lazyModuleData<ReactNetInfo>(this, "RCTNetInfo"),
+         lazyModuleData<ReactWebSocket>(this, "RCTWebSocketModule"),
+         lazyModuleData<ReactExceptionsManager>(this, "RCTExceptionsManager"),
+         lazyModuleData<ReactNativeAnimation>(this, "RCTNativeAnimation"),
+         lazyModuleData<ReactCacheStats>(this, "RCTCacheStats") }) {
+    d->modules.insert(moduleData->id(), moduleData);
+  }
+
   QObjectList modules;
+  QList<ReactModuleRegistration> registrations;
   modules << d->internalModules();
-  modules << d->pluginModules();
+  modules << d->pluginModules(&registrations);
+
+  // Descriptor-registered plugin modules skip startup introspection
+  // entirely: the meta-object compiled into the plugin is the method config,
+  // and the instance (with its bridge and thread setup) is deferred to the
+  // first call from JS, like the built-in lazy modules above.
+  for (const ReactModuleRegistration& registration : registrations) {
+    ReactBridge* bridge = this;
+    const std::function<QObject*()> factory = registration.factory;
+    ReactModuleData* moduleData =
+      new ReactModuleData(*registration.metaObject, registration.name, [bridge, factory] {
+        QObject* module = factory();
+        qobject_cast<ReactModuleInterface*>(module)->setBridge(bridge);
+        bridge->setupModuleThread(module);
+        return module;
+      });
+    d->modules.insert(moduleData->id(), moduleData);
+  }
 
   // Special cases // TODO:
   d->sourceCode = new ReactSourceCode;
@@ -384,22 +718,56 @@ void ReactBridge::initModules()
   connect(d->sourceCode, SIGNAL(loadFailed()), SLOT(sourcesLoadFailed()));
 
   // XXX:
+  QObjectList validModules;
   for (QObject* o : modules) {
     ReactModuleInterface* module = qobject_cast<ReactModuleInterface*>(o);
     if (module != nullptr) {
       module->setBridge(this);
-      ReactModuleData* moduleData = new ReactModuleData(o);
-      d->modules.insert(moduleData->id(), moduleData);
+      setupModuleThread(o);
+      validModules << o;
     } else {
       qWarning() << "A module loader exported an invalid module";
     }
   }
+
+  // The executor handshake is in flight while we sit here, so fan the
+  // meta-object scans out across the global pool; the merge below runs on
+  // this thread and keeps id assignment and coercion registration (and so
+  // the registry order) exactly as sequential registration produced.
+  QVector<ReactModuleData::Introspection*> scans(validModules.size());
+  QSemaphore scansDone;
+  for (int i = 0; i < validModules.size(); ++i) {
+    QThreadPool::globalInstance()->start(
+      new IntrospectTask(validModules.at(i), &scans[i], &scansDone));
+  }
+  scansDone.acquire(validModules.size());
+
+  for (int i = 0; i < validModules.size(); ++i) {
+    ReactModuleData* moduleData = new ReactModuleData(validModules.at(i), scans.at(i));
+    d->modules.insert(moduleData->id(), moduleData);
+  }
 }
 
 void ReactBridge::injectModules()
 {
   Q_D(ReactBridge);
 
+  // Module ids are assigned sequentially per process, so the blob is only
+  // valid for the id range it was built against; a bridge reload renumbers
+  // and falls through to a rebuild (without clobbering the cache).
+  const QByteArray expectedHeader =
+    "ids " + QByteArray::number(d->modules.firstKey()) + " " +
+    QByteArray::number(d->modules.size()) + "\n";
+
+  const QString cachePath = moduleConfigCachePath(d->pluginsPath);
+  QFile cacheFile(cachePath);
+  if (cacheFile.open(QIODevice::ReadOnly)) {
+    if (cacheFile.readLine() == expectedHeader) {
+      d->executor->injectSerializedJson("__fbBatchedBridgeConfig", cacheFile.readAll());
+      return;
+    }
+  }
+
   QVariantMap moduleConfig;
 
   for (auto& md : d->modules) {
@@ -407,57 +775,112 @@ void ReactBridge::injectModules()
     moduleConfig.insert(md->name(), md->info());
   }
 
-  d->executor->injectJson("__fbBatchedBridgeConfig", QVariantMap{
+  const QByteArray blob = reactStringifyJson(QVariantMap{
     { "remoteModuleConfig", moduleConfig }
   });
+  d->executor->injectSerializedJson("__fbBatchedBridgeConfig", blob);
+
+  if (d->modules.firstKey() == 1) {
+    QDir().mkpath(QFileInfo(cachePath).absolutePath());
+    QFile out(cachePath);
+    if (out.open(QIODevice::WriteOnly)) {
+      out.write(expectedHeader);
+      out.write(blob);
+    }
+  }
 }
 
-void ReactBridge::processResult(const QJsonDocument& doc)
+void ReactBridge::processResult(const ReactBridgeValueRef& result)
 {
   Q_D(ReactBridge);
 
-  if (doc.isNull())
+  if (!result.isValid())
     return;
 
-  if (!doc.isArray()) {
-    qCritical() << "Returned document from executor in unexpected form";
+  if (d->inBatch) {
+    // A nested result (in-process executor answering a deferred call's
+    // flush) becomes its own transaction after this one commits.
+    d->pendingResults.append(result);
     return;
   }
+  d->inBatch = true;
+  reactTraceSpanBegin("batchApply");
 
-  QVariantList requests = doc.toVariant().toList();
-
-  QVariantList moduleIDs = requests[FieldRequestModuleIDs].toList();
-  QVariantList methodIDs = requests[FieldMethodIDs].toList();
-  QVariantList paramArrays = requests[FieldParams].toList();
-
-  // qDebug() << "moduleIDs" << moduleIDs;
-  // qDebug() << "methodIDs" << methodIDs;
-  // qDebug() << "paramArrays" << paramArrays;
+  const ReactBridgeValue& batch = result.value();
+  const ReactBridgeValue* paramArrays =
+    (batch.type == ReactBridgeValue::Array &&
+     batch.count() > facebook::react::BatchFieldParams)
+      ? &batch.at(facebook::react::BatchFieldParams) : nullptr;
 
+  // Batch validation and call ordering live in the shared bridge core; only
+  // module dispatch is ours.
   // XXX: this should all really be wrapped up in a Module class
   // including invocations etc
-  for (int i = 0; i < moduleIDs.size(); ++i) {
-    ReactModuleData* moduleData = d->modules[moduleIDs[i].toInt()];
-    if (moduleData == nullptr) {
-      qCritical() << "Could not find referenced module";
-      continue;
-    }
+  facebook::react::forEachMethodCall<BridgeValueTraits>(
+    batch,
+    [&](int moduleId, int methodId, size_t callIndex, int callId) {
+      Q_UNUSED(callId);
+      ReactModuleData* moduleData = d->modules[moduleId];
+      if (moduleData == nullptr) {
+        qCritical() << "Could not find referenced module";
+        return;
+      }
 
-    ReactModuleMethod* method = moduleData->method(methodIDs[i].toInt());
-    if (method == nullptr) {
-      qCritical() << "Request for unsupported method";
-      continue;
-    }
+      ReactModuleMethod* method = moduleData->method(methodId);
+      if (method == nullptr) {
+        qCritical() << "Request for unsupported method";
+        return;
+      }
 
-    method->invokeWithBridge(this, paramArrays[i].toList());
+      const bool monitored = reactFrameMonitorEnabled();
+      const qint64 dispatchBeginUs = monitored ? reactFrameMonitorNowUs() : 0;
+
+      // Batch-native methods decode straight from the wire values and skip
+      // the conversion below entirely.
+      bool invoked = paramArrays != nullptr &&
+        moduleData->invokeWithBridgeValue(this, methodId,
+                                          result.subRef(paramArrays->at(callIndex)));
+      if (!invoked) {
+        // The only QVariant conversion in the whole batch walk; the invoke
+        // machinery downstream (reactvaluecoercion, QML property writes)
+        // still speaks QVariant.
+        method->invokeWithBridge(this, paramArrays->at(callIndex).toVariant().toList());
+      }
+
+      if (monitored)
+        reactFrameMonitorDispatch(moduleData->name() + "." + method->name(),
+                                  dispatchBeginUs, reactFrameMonitorNowUs());
+    },
+    [](const char* message) {
+      qCritical() << "Returned result from executor in unexpected form:" << message;
+    });
+
+  d->inBatch = false;
+
+  // Commit phase: listeners (UIManager, modules batching work) schedule
+  // their flushes off this, already paced by the frame scheduler.
+  emit endOfBatch();
+  // Nested results replay below as transactions of their own, each under
+  // its own span.
+  reactTraceSpanEnd("batchApply");
+
+  // Work parked during the batch now runs, each result as a transaction of
+  // its own. Replayed calls may park further work; the loops drain it all
+  // in arrival order.
+  while (!d->pendingResults.isEmpty()) {
+    processResult(d->pendingResults.takeFirst());
+  }
+  while (!d->deferredCalls.isEmpty()) {
+    const ReactBridgePrivate::DeferredCall call = d->deferredCalls.takeFirst();
+    enqueueJSCall(call.module, call.method, call.args);
   }
 }
 
 void ReactBridge::applicationScriptDone()
 {
   QTimer::singleShot(0, [this]() {
-      d_func()->executor->executeJSCall("flushedQueue", QVariantList{}, [=](const QJsonDocument& doc) {
-          processResult(doc);
+      d_func()->executor->executeJSCall("flushedQueue", QVariantList{}, [=](const ReactBridgeValueRef& result) {
+          processResult(result);
           setReady(true);
         });
     });
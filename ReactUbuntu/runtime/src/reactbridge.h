@@ -17,15 +17,22 @@
 #include <QUrl>
 #include <QObject>
 #include <QScopedPointer>
+#include <QVariantMap>
+
+#include "reactbridgevalue.h"
 
 
 class QQuickItem;
+class QQmlComponent;
 class QQmlEngine;
 class QNetworkAccessManager;
+class QNetworkRequest;
 class ReactModuleData;
 class ReactUIManager;
 class ReactImageLoader;
 class ReactEventDispatcher;
+class ReactScheduler;
+class ReactRequestScheduler;
 class ReactRedboxItem;
 
 class ReactBridgePrivate;
@@ -38,6 +45,8 @@ class ReactBridge : public QObject
   Q_PROPERTY(QNetworkAccessManager* networkAccessManager READ networkAccessManager WRITE setNetworkAccessManager)
   Q_PROPERTY(QUrl bundleUrl READ bundleUrl WRITE setBundleUrl)
   Q_PROPERTY(QString pluginsPath READ pluginsPath WRITE setPluginsPath)
+  Q_PROPERTY(QUrl warmupManifest READ warmupManifest WRITE setWarmupManifest)
+  Q_PROPERTY(QVariantMap threadScheduling READ threadScheduling WRITE setThreadScheduling)
   Q_PROPERTY(QString executorName READ executorName WRITE setExecutorName)
   Q_PROPERTY(QList<ReactModuleData*> modules READ modules)
   Q_PROPERTY(ReactUIManager* uiManager READ uiManager)
@@ -58,6 +67,15 @@ public:
   void invokeAndProcess(const QString& method, const QVariantList &args);
   void executeSourceCode(const QByteArray& sourceCode);
 
+  // Moves a freshly constructed module onto the thread its declared
+  // affinity asks for; no-op for the default GUI affinity.
+  void setupModuleThread(QObject* moduleImpl);
+
+  // Returns the compiled component for the given QML source, compiling it on
+  // first request. Blueprints are pinned for the lifetime of the bridge and
+  // shared by every view manager whose views come from the same source.
+  QQmlComponent* componentForSource(const QByteArray& source);
+
   // XXX: maybe rename
   bool ready() const;
   void setReady(bool ready);
@@ -71,16 +89,36 @@ public:
   QNetworkAccessManager* networkAccessManager() const;
   void setNetworkAccessManager(QNetworkAccessManager* nam);
 
+  // Applies the shared connection tuning (keep-alive reuse is the manager
+  // default, pipelining is opt-in through REACT_NET_PIPELINING) to a request
+  // going through the bridge's network access manager.
+  void prepareRequest(QNetworkRequest& request) const;
+
   QUrl bundleUrl() const;
   void setBundleUrl(const QUrl& bundleUrl);
 
   QString pluginsPath() const;
   void setPluginsPath(const QString& pluginsPath);
 
+  // Optional manifest of components, modules and images to warm in idle
+  // slices after the bridge is ready (see ReactWarmup).
+  QUrl warmupManifest() const;
+  void setWarmupManifest(const QUrl& warmupManifest);
+
+  // Optional priority/affinity placement for the runtime's helper threads,
+  // keyed by thread class (see reactthreadscheduling.h for the shape); set
+  // before init so threads pick it up as they start.
+  QVariantMap threadScheduling() const;
+  void setThreadScheduling(const QVariantMap& threadScheduling);
+
   QString executorName() const;
   void setExecutorName(const QString& executorName);
 
   ReactEventDispatcher* eventDispatcher() const;
+  ReactScheduler* scheduler() const;
+  // Priority/dedup layer all runtime GETs on the shared access manager go
+  // through; lives as long as the manager is set.
+  ReactRequestScheduler* requestScheduler() const;
   QList<ReactModuleData*> modules() const;
   ReactUIManager* uiManager() const;
   ReactImageLoader* imageLoader() const;
@@ -89,6 +127,10 @@ public:
 Q_SIGNALS:
   void readyChanged();
 
+  // Emitted after every native-call batch from the executor has been
+  // dispatched; modules use it to apply accumulated work in one pass.
+  void endOfBatch();
+
 private Q_SLOTS:
   void sourcesFinished();
   void sourcesLoadFailed();
@@ -98,7 +140,7 @@ private:
   void loadSource();
   void initModules();
   void injectModules();
-  void processResult(const QJsonDocument& document);
+  void processResult(const ReactBridgeValueRef& result);
   void setupExecutor();
 
   QScopedPointer<ReactBridgePrivate> d_ptr;
@@ -0,0 +1,452 @@
+
+/**
+ * Copyright (C) 2016, Canonical Ltd.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ *
+ * Author: Justin McPherson <justin.mcpherson@canonical.com>
+ *
+ */
+
+#include <cstring>
+
+#include <QVarLengthArray>
+#include <QVector>
+
+#include "reactbridgevalue.h"
+
+
+// Bump allocator backing one parse. Values, long string characters and
+// child runs are carved out of a few large chunks and freed in one sweep
+// when the last ReactBridgeValueRef drops, instead of one malloc/free pair
+// per JSON node the way QVariant trees behave.
+class ReactBridgeValueArena {
+public:
+  ReactBridgeValueArena() = default;
+  ~ReactBridgeValueArena() {
+    for (char* chunk : m_chunks)
+      delete[] chunk;
+  }
+  ReactBridgeValueArena(const ReactBridgeValueArena&) = delete;
+  ReactBridgeValueArena& operator=(const ReactBridgeValueArena&) = delete;
+
+  void* allocate(size_t size) {
+    size = (size + 7) & ~size_t(7);
+    if (size > m_remaining) {
+      const size_t chunkSize = qMax(size, size_t(ChunkSize));
+      char* chunk = new char[chunkSize];
+      m_chunks.append(chunk);
+      m_cursor = chunk;
+      m_remaining = chunkSize;
+    }
+    void* out = m_cursor;
+    m_cursor += size;
+    m_remaining -= size;
+    return out;
+  }
+
+private:
+  enum { ChunkSize = 16384 };
+  QVector<char*> m_chunks;
+  char* m_cursor = nullptr;
+  size_t m_remaining = 0;
+};
+
+
+namespace {
+
+// Same single-pass grammar as JsonReader in reactjsonvalue.cpp, but building
+// ReactBridgeValue nodes in an arena instead of QVariant containers.
+// Children are buffered on the stack while a container parses and then
+// copied into one contiguous arena run; the POD copy is safe because nested
+// pointers target arena memory, which never moves.
+class BridgeJsonReader {
+public:
+  BridgeJsonReader(const QByteArray& data, ReactBridgeValueArena* arena)
+    : p(data.constData())
+    , end(p + data.size())
+    , arena(arena) {
+  }
+
+  const ReactBridgeValue* parse() {
+    ReactBridgeValue value = parseValue();
+    if (failed)
+      return nullptr;
+    skipWhitespace();
+    if (p != end)
+      return nullptr; // trailing garbage
+    ReactBridgeValue* root =
+        static_cast<ReactBridgeValue*>(arena->allocate(sizeof(ReactBridgeValue)));
+    *root = value;
+    return root;
+  }
+
+private:
+  ReactBridgeValue fail() {
+    failed = true;
+    return makeNull();
+  }
+  static ReactBridgeValue makeNull() {
+    ReactBridgeValue value;
+    memset(&value, 0, sizeof(value));
+    value.type = ReactBridgeValue::Null;
+    return value;
+  }
+  void skipWhitespace() {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r'))
+      ++p;
+  }
+  ReactBridgeValue parseValue() {
+    skipWhitespace();
+    if (p >= end)
+      return fail();
+    switch (*p) {
+    case '{':
+      return parseObject();
+    case '[':
+      return parseArray();
+    case '"':
+      return takeString();
+    case 't':
+      if (end - p >= 4 && memcmp(p, "true", 4) == 0) {
+        p += 4;
+        ReactBridgeValue value = makeNull();
+        value.type = ReactBridgeValue::Bool;
+        value.boolean = true;
+        return value;
+      }
+      return fail();
+    case 'f':
+      if (end - p >= 5 && memcmp(p, "false", 5) == 0) {
+        p += 5;
+        ReactBridgeValue value = makeNull();
+        value.type = ReactBridgeValue::Bool;
+        value.boolean = false;
+        return value;
+      }
+      return fail();
+    case 'n':
+      if (end - p >= 4 && memcmp(p, "null", 4) == 0) {
+        p += 4;
+        return makeNull();
+      }
+      return fail();
+    default:
+      return parseNumber();
+    }
+  }
+  ReactBridgeValue parseObject() {
+    ++p; // '{'
+    QVarLengthArray<ReactBridgeValue, 32> children; // key, value, key, value...
+    skipWhitespace();
+    if (p < end && *p == '}') {
+      ++p;
+      return finishContainer(ReactBridgeValue::Map, children, 0);
+    }
+    for (;;) {
+      skipWhitespace();
+      if (p >= end || *p != '"')
+        return fail();
+      children.append(takeString());
+      if (failed)
+        return makeNull();
+      skipWhitespace();
+      if (p >= end || *p != ':')
+        return fail();
+      ++p;
+      children.append(parseValue());
+      if (failed)
+        return makeNull();
+      skipWhitespace();
+      if (p < end && *p == ',') {
+        ++p;
+        continue;
+      }
+      if (p < end && *p == '}') {
+        ++p;
+        return finishContainer(ReactBridgeValue::Map, children, children.size() / 2);
+      }
+      return fail();
+    }
+  }
+  ReactBridgeValue parseArray() {
+    ++p; // '['
+    QVarLengthArray<ReactBridgeValue, 32> children;
+    skipWhitespace();
+    if (p < end && *p == ']') {
+      ++p;
+      return finishContainer(ReactBridgeValue::Array, children, 0);
+    }
+    for (;;) {
+      children.append(parseValue());
+      if (failed)
+        return makeNull();
+      skipWhitespace();
+      if (p < end && *p == ',') {
+        ++p;
+        continue;
+      }
+      if (p < end && *p == ']') {
+        ++p;
+        return finishContainer(ReactBridgeValue::Array, children, children.size());
+      }
+      return fail();
+    }
+  }
+  ReactBridgeValue finishContainer(
+      quint8 type,
+      const QVarLengthArray<ReactBridgeValue, 32>& children,
+      int count) {
+    ReactBridgeValue value = makeNull();
+    value.type = type;
+    value.array.count = count;
+    value.array.items = nullptr;
+    if (!children.isEmpty()) {
+      ReactBridgeValue* items = static_cast<ReactBridgeValue*>(
+          arena->allocate(children.size() * sizeof(ReactBridgeValue)));
+      memcpy(items, children.constData(), children.size() * sizeof(ReactBridgeValue));
+      value.array.items = items;
+    }
+    return value;
+  }
+  ReactBridgeValue makeString(const QVarLengthArray<ushort, 64>& units) {
+    ReactBridgeValue value = makeNull();
+    value.type = ReactBridgeValue::String;
+    if (units.size() <= ReactBridgeValue::ShortStringMax) {
+      value.shortLength = quint8(units.size());
+      memcpy(value.shortChars, units.constData(), units.size() * sizeof(ushort));
+    } else {
+      value.shortLength = 255;
+      ushort* chars =
+          static_cast<ushort*>(arena->allocate(units.size() * sizeof(ushort)));
+      memcpy(chars, units.constData(), units.size() * sizeof(ushort));
+      value.string.unicode = chars;
+      value.string.length = units.size();
+    }
+    return value;
+  }
+  void appendSpan(QVarLengthArray<ushort, 64>& out, const char* start, const char* stop) {
+    bool ascii = true;
+    for (const char* c = start; c < stop; ++c) {
+      if (uchar(*c) >= 0x80) {
+        ascii = false;
+        break;
+      }
+    }
+    if (ascii) {
+      for (const char* c = start; c < stop; ++c)
+        out.append(ushort(uchar(*c)));
+      return;
+    }
+    const QString span = QString::fromUtf8(start, stop - start);
+    for (const QChar c : span)
+      out.append(c.unicode());
+  }
+  ReactBridgeValue takeString() {
+    ++p; // opening quote
+    QVarLengthArray<ushort, 64> out;
+    const char* spanStart = p;
+    while (p < end) {
+      const char c = *p;
+      if (c == '"') {
+        appendSpan(out, spanStart, p);
+        ++p;
+        return makeString(out);
+      }
+      if (c != '\\') {
+        ++p;
+        continue;
+      }
+      appendSpan(out, spanStart, p);
+      ++p;
+      if (p >= end)
+        break;
+      switch (*p) {
+      case '"': out.append('"'); break;
+      case '\\': out.append('\\'); break;
+      case '/': out.append('/'); break;
+      case 'b': out.append('\b'); break;
+      case 'f': out.append('\f'); break;
+      case 'n': out.append('\n'); break;
+      case 'r': out.append('\r'); break;
+      case 't': out.append('\t'); break;
+      case 'u': {
+        if (end - p < 5)
+          return fail();
+        bool ok = false;
+        const ushort unit = QByteArray(p + 1, 4).toUShort(&ok, 16);
+        if (!ok)
+          return fail();
+        // Surrogate pairs arrive as two consecutive escapes and recombine
+        // naturally in the UTF-16 buffer.
+        out.append(unit);
+        p += 4;
+        break;
+      }
+      default:
+        return fail();
+      }
+      ++p;
+      spanStart = p;
+    }
+    return fail();
+  }
+  ReactBridgeValue parseNumber() {
+    const char* start = p;
+    if (p < end && *p == '-')
+      ++p;
+    bool integral = true;
+    while (p < end) {
+      const char c = *p;
+      if (c >= '0' && c <= '9') {
+        ++p;
+      } else if (c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-') {
+        integral = false;
+        ++p;
+      } else {
+        break;
+      }
+    }
+    if (p == start)
+      return fail();
+    const QByteArray token(start, p - start);
+    if (integral) {
+      bool ok = false;
+      const qlonglong n = token.toLongLong(&ok);
+      if (ok) {
+        ReactBridgeValue value = makeNull();
+        value.type = ReactBridgeValue::Int;
+        value.integer = n;
+        return value;
+      }
+    }
+    bool ok = false;
+    const double d = token.toDouble(&ok);
+    if (!ok)
+      return fail();
+    ReactBridgeValue value = makeNull();
+    value.type = ReactBridgeValue::Double;
+    value.number = d;
+    return value;
+  }
+
+  const char* p;
+  const char* end;
+  ReactBridgeValueArena* arena;
+  bool failed = false;
+};
+
+} // namespace
+
+
+int ReactBridgeValue::count() const
+{
+  if (type == Array)
+    return array.count;
+  if (type == Map)
+    return map.count;
+  return 0;
+}
+
+const ReactBridgeValue& ReactBridgeValue::at(int i) const
+{
+  if (type == Map)
+    return map.items[i * 2 + 1];
+  return array.items[i];
+}
+
+const ReactBridgeValue& ReactBridgeValue::keyAt(int i) const
+{
+  return map.items[i * 2];
+}
+
+bool ReactBridgeValue::toBool() const
+{
+  switch (type) {
+  case Bool: return boolean;
+  case Int: return integer != 0;
+  case Double: return number != 0;
+  default: return false;
+  }
+}
+
+qint64 ReactBridgeValue::toInt() const
+{
+  switch (type) {
+  case Bool: return boolean ? 1 : 0;
+  case Int: return integer;
+  case Double: return qint64(number);
+  default: return 0;
+  }
+}
+
+double ReactBridgeValue::toDouble() const
+{
+  switch (type) {
+  case Bool: return boolean ? 1 : 0;
+  case Int: return integer;
+  case Double: return number;
+  default: return 0;
+  }
+}
+
+QString ReactBridgeValue::toString() const
+{
+  switch (type) {
+  case String:
+    if (shortLength != 255)
+      return QString::fromUtf16(shortChars, shortLength);
+    return QString::fromUtf16(string.unicode, string.length);
+  case Int:
+    return QString::number(integer);
+  case Double:
+    return QString::number(number);
+  case Bool:
+    return boolean ? QStringLiteral("true") : QStringLiteral("false");
+  default:
+    return QString();
+  }
+}
+
+QVariant ReactBridgeValue::toVariant() const
+{
+  switch (type) {
+  case Null:
+    return QVariant();
+  case Bool:
+    return QVariant(boolean);
+  case Int:
+    return QVariant(qlonglong(integer));
+  case Double:
+    return QVariant(number);
+  case String:
+    return QVariant(toString());
+  case Array: {
+    QVariantList list;
+    list.reserve(array.count);
+    for (int i = 0; i < array.count; ++i)
+      list.push_back(at(i).toVariant());
+    return list;
+  }
+  case Map: {
+    QVariantMap object;
+    for (int i = 0; i < map.count; ++i)
+      object.insert(keyAt(i).toString(), at(i).toVariant());
+    return object;
+  }
+  }
+  return QVariant();
+}
+
+
+ReactBridgeValueRef reactParseBridgeJson(const QByteArray& json)
+{
+  QSharedPointer<ReactBridgeValueArena> arena(new ReactBridgeValueArena);
+  const ReactBridgeValue* root = BridgeJsonReader(json, arena.data()).parse();
+  if (root == nullptr)
+    return ReactBridgeValueRef();
+  return ReactBridgeValueRef(root, arena);
+}
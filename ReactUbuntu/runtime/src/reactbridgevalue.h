@@ -0,0 +1,107 @@
+/**
+ * Copyright (C) 2016, Canonical Ltd.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ *
+ * Author: Justin McPherson <justin.mcpherson@canonical.com>
+ *
+ */
+
+#ifndef REACTBRIDGEVALUE_H
+#define REACTBRIDGEVALUE_H
+
+#include <QByteArray>
+#include <QSharedPointer>
+#include <QString>
+#include <QVariant>
+
+// Value model for bridge traffic. A QVariant tree heap-boxes every nested
+// map and list in a refcounted, detachable container, so a deep batch
+// payload (navigation state, list data) costs an allocation per node and
+// detach-copies whenever a non-const accessor slips in. ReactBridgeValue is
+// a plain 32-byte tagged union instead: numbers, booleans and short strings
+// are stored inline, long strings and children live in the arena that
+// parsed them, and nothing is refcounted. Conversion to QVariant happens
+// once per call's argument list, at the QMetaMethod::invoke boundary.
+
+class ReactBridgeValueArena;
+
+struct ReactBridgeValue {
+  enum Type {
+    Null = 0,
+    Bool,
+    Int,
+    Double,
+    String,
+    Array,
+    Map
+  };
+
+  enum { ShortStringMax = 11 };
+
+  quint8 type;
+  // String only: number of inline UTF-16 units, or 255 when the characters
+  // live in the arena.
+  quint8 shortLength;
+  union {
+    bool boolean;
+    qint64 integer;
+    double number;
+    struct { const ushort* unicode; int length; } string;
+    struct { const ReactBridgeValue* items; int count; } array;
+    // Maps interleave their children: items[2i] is the key (always a
+    // String), items[2i + 1] the value.
+    struct { const ReactBridgeValue* items; int count; } map;
+    ushort shortChars[ShortStringMax];
+  };
+
+  int count() const;
+  // Array element / map value by index; map keys via keyAt.
+  const ReactBridgeValue& at(int i) const;
+  const ReactBridgeValue& keyAt(int i) const;
+
+  bool toBool() const;
+  qint64 toInt() const;
+  double toDouble() const;
+  QString toString() const;
+
+  // The deep conversion; call it only where a QVariant is genuinely
+  // required (module invocation, QML).
+  QVariant toVariant() const;
+};
+
+// Handle carried through executor callbacks: the root value plus shared
+// ownership of the arena every value of the parse lives in. Values are
+// invalidated when the last ref to their arena drops.
+class ReactBridgeValueRef {
+public:
+  ReactBridgeValueRef() : m_value(nullptr) {}
+  ReactBridgeValueRef(const ReactBridgeValue* value,
+                      const QSharedPointer<ReactBridgeValueArena>& arena)
+    : m_value(value), m_arena(arena) {}
+
+  // An invalid ref means the call produced no (or unparseable) output.
+  bool isValid() const { return m_value != nullptr; }
+  const ReactBridgeValue& value() const { return *m_value; }
+
+  // A ref to a value nested somewhere in this parse, sharing the arena; used
+  // to hand one call's argument list to a module while keeping the whole
+  // batch alive.
+  ReactBridgeValueRef subRef(const ReactBridgeValue& value) const {
+    return ReactBridgeValueRef(&value, m_arena);
+  }
+
+private:
+  const ReactBridgeValue* m_value;
+  QSharedPointer<ReactBridgeValueArena> m_arena;
+};
+
+// Single pass JSON -> ReactBridgeValue parser; the arena-backed counterpart
+// of reactParseJson. Returns an invalid ref when the input is not well
+// formed JSON.
+ReactBridgeValueRef reactParseBridgeJson(const QByteArray& json);
+
+#endif // REACTBRIDGEVALUE_H
@@ -0,0 +1,108 @@
+
+/**
+ * Copyright (C) 2016, Canonical Ltd.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ *
+ * Author: Justin McPherson <justin.mcpherson@canonical.com>
+ *
+ */
+
+#include <QMap>
+#include <QMutex>
+
+#include "reactcachestats.h"
+
+
+namespace {
+
+QMutex registryLock;
+QMap<QByteArray, ReactCacheCounters*> counters;
+QMap<QByteArray, std::function<qint64()>> byteProbes;
+
+} // namespace
+
+
+ReactCacheCounters* reactCacheCounters(const char* name)
+{
+  QMutexLocker locker(&registryLock);
+  ReactCacheCounters*& block = counters[name];
+  if (block == nullptr)
+    block = new ReactCacheCounters;
+  return block;
+}
+
+void reactCacheByteProbe(const char* name, const std::function<qint64()>& probe)
+{
+  reactCacheCounters(name);
+  QMutexLocker locker(&registryLock);
+  byteProbes.insert(name, probe);
+}
+
+QVariantMap reactCacheStatsSnapshot()
+{
+  QMutexLocker locker(&registryLock);
+  QVariantMap snapshot;
+  for (auto it = counters.constBegin(); it != counters.constEnd(); ++it) {
+    const ReactCacheCounters* block = it.value();
+    const qint64 hits = block->hits.load(std::memory_order_relaxed);
+    const qint64 misses = block->misses.load(std::memory_order_relaxed);
+
+    QVariantMap entry{
+      {"hits", hits},
+      {"misses", misses},
+      {"evictions", block->evictions.load(std::memory_order_relaxed)},
+    };
+    const auto probe = byteProbes.constFind(it.key());
+    entry["bytes"] = probe != byteProbes.constEnd()
+      ? probe.value()() : block->bytes.load(std::memory_order_relaxed);
+    if (hits + misses > 0)
+      entry["hitRate"] = double(hits) / double(hits + misses);
+
+    snapshot.insert(QString::fromLatin1(it.key()), entry);
+  }
+  return snapshot;
+}
+
+
+void ReactCacheStats::getStats(const ReactModuleInterface::ListArgumentBlock& resolve)
+{
+  resolve(m_bridge, QVariantList{reactCacheStatsSnapshot()});
+}
+
+ReactCacheStats::ReactCacheStats(QObject* parent)
+  : QObject(parent)
+{
+}
+
+ReactCacheStats::~ReactCacheStats()
+{
+}
+
+void ReactCacheStats::setBridge(ReactBridge* bridge)
+{
+  m_bridge = bridge;
+}
+
+ReactViewManager* ReactCacheStats::viewManager()
+{
+  return nullptr;
+}
+
+QString ReactCacheStats::moduleName()
+{
+  return "RCTCacheStats";
+}
+
+QList<ReactModuleMethod*> ReactCacheStats::methodsToExport()
+{
+  return QList<ReactModuleMethod*>{};
+}
+
+QVariantMap ReactCacheStats::constantsToExport()
+{
+  return QVariantMap{};
+}
@@ -0,0 +1,78 @@
+
+/**
+ * Copyright (C) 2016, Canonical Ltd.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ *
+ * Author: Justin McPherson <justin.mcpherson@canonical.com>
+ *
+ */
+
+#ifndef REACTCACHESTATS_H
+#define REACTCACHESTATS_H
+
+#include <atomic>
+#include <functional>
+
+#include <QVariantMap>
+
+#include "reactmoduleinterface.h"
+
+
+// Effectiveness counters for the runtime's caches. Hot paths bump relaxed
+// atomics - the decoded-image and text-measurement caches are probed off
+// the GUI thread - so instrumentation costs one increment per lookup and
+// the numbers are only reconciled when somebody asks for a snapshot.
+struct ReactCacheCounters {
+  std::atomic<qint64> hits{0};
+  std::atomic<qint64> misses{0};
+  std::atomic<qint64> evictions{0};
+  std::atomic<qint64> bytes{0};
+};
+
+// Registers (or returns the already registered) counter block for a cache
+// name; the block lives for the process, so callers keep the pointer.
+ReactCacheCounters* reactCacheCounters(const char* name);
+
+// Caches that already track their own size (the network disk cache) hand
+// over a probe called at snapshot time instead of maintaining the bytes
+// counter.
+void reactCacheByteProbe(const char* name, const std::function<qint64()>& probe);
+
+// One map per cache: hits, misses, evictions, bytes and the derived
+// hitRate. Feeds the RCTCacheStats module and the trace summary; bytes is
+// zero for caches that do not measure in bytes.
+QVariantMap reactCacheStatsSnapshot();
+
+
+// Thin module handing the snapshot to JS, so perf tooling can sample hit
+// rates from inside the app instead of sizing the caches by guesswork.
+class ReactCacheStats
+  : public QObject
+  , public ReactModuleInterface
+{
+  Q_OBJECT
+  Q_INTERFACES(ReactModuleInterface)
+
+  Q_INVOKABLE void getStats(const ReactModuleInterface::ListArgumentBlock& resolve);
+
+public:
+  ReactCacheStats(QObject* parent = 0);
+  ~ReactCacheStats();
+
+  void setBridge(ReactBridge* bridge) override;
+
+  ReactViewManager* viewManager() override;
+
+  QString moduleName() override;
+  QList<ReactModuleMethod*> methodsToExport() override;
+  QVariantMap constantsToExport() override;
+
+private:
+  ReactBridge* m_bridge = nullptr;
+};
+
+#endif // REACTCACHESTATS_H
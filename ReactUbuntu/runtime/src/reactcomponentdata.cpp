@@ -22,9 +22,17 @@
 #include "reactmoduledata.h"
 #include "reactviewmanager.h"
 #include "reactattachedproperties.h"
+#include "reactflexlayout.h"
 #include "reactpropertyhandler.h"
 
 
+namespace {
+// QML object creation dominates list scrolling; keep a modest number of
+// detached views per type around for reuse.
+const int kMaxRecycledViews = 32;
+}
+
+
 ReactComponentData::ReactComponentData(ReactModuleData* moduleData)
   : m_moduleData(moduleData)
 {
@@ -33,6 +41,7 @@ ReactComponentData::ReactComponentData(ReactModuleData* moduleData)
 
 ReactComponentData::~ReactComponentData()
 {
+  qDeleteAll(m_recycledViews);
 }
 
 QString ReactComponentData::name() const
@@ -128,7 +137,15 @@ QQuickItem* ReactComponentData::createView(int tag, const QVariantMap& propertie
 {
   ReactViewManager* viewManager = m_moduleInterface->viewManager();
 
-  QQuickItem* view = viewManager->view(properties);
+  QQuickItem* view = nullptr;
+  if (!m_recycledViews.isEmpty()) {
+    view = m_recycledViews.takeLast();
+    view->setVisible(true);
+  } else {
+    view = viewManager->view(properties);
+    if (view == nullptr)
+      return nullptr;
+  }
 
   ReactAttachedProperties* rap = ReactAttachedProperties::get(view);
   rap->setTag(tag);
@@ -139,6 +156,56 @@ QQuickItem* ReactComponentData::createView(int tag, const QVariantMap& propertie
   return view;
 }
 
+bool ReactComponentData::prewarmView()
+{
+  if (m_recycledViews.size() >= kMaxRecycledViews)
+    return false;
+
+  QQuickItem* view = m_moduleInterface->viewManager()->view();
+  if (view == nullptr)
+    return false;
+
+  // Same resting state recycleView leaves a view in; createView revives it
+  // the usual way, tag and property handler included.
+  view->setVisible(false);
+  m_recycledViews.push_back(view);
+  return true;
+}
+
+bool ReactComponentData::recycleView(QQuickItem* view)
+{
+  if (m_recycledViews.size() >= kMaxRecycledViews)
+    return false;
+
+  // A container still carrying React children cannot be reset in isolation.
+  for (QQuickItem* child : view->childItems()) {
+    if (ReactAttachedProperties::get(child, false) != nullptr)
+      return false;
+  }
+
+  m_moduleInterface->viewManager()->prepareForRecycle(view);
+
+  ReactAttachedProperties* rap = ReactAttachedProperties::get(view);
+  rap->setTag(-1);
+  ReactPropertyHandler* ph = rap->propertyHandler();
+  if (ph != nullptr) {
+    // Prop state belongs to the old incarnation; createView sets up a fresh
+    // handler on reuse.
+    ph->deleteLater();
+    rap->setPropertyHandler(nullptr);
+  }
+
+  ReactFlexLayout* fl = ReactFlexLayout::get(view, false);
+  if (fl != nullptr) {
+    fl->resetStyle();
+  }
+
+  view->setParentItem(nullptr);
+  view->setVisible(false);
+  m_recycledViews.push_back(view);
+  return true;
+}
+
 ReactModuleMethod* ReactComponentData::method(int id) const
 {
   return m_moduleData->method(id);
@@ -14,6 +14,7 @@
 #ifndef REACTCOMPONENTDATA_H
 #define REACTCOMPONENTDATA_H
 
+#include <QList>
 #include <QString>
 #include <QVariant>
 
@@ -37,11 +38,22 @@ public:
 
   QQuickItem* createView(int tag, const QVariantMap& properties);
 
+  // Takes a view detached by manageChildren back into the pool for reuse by
+  // a later createView. Returns false when the view cannot be recycled and
+  // should be deleted instead.
+  bool recycleView(QQuickItem* view);
+
+  // Instantiates one fresh view straight into the pool, so a later
+  // createView is a pool take instead of a component instantiation. Called
+  // from idle-time render-ahead; returns false when the pool is full.
+  bool prewarmView();
+
   ReactModuleMethod* method(int id) const;
 
 private:
   ReactModuleData* m_moduleData;
   ReactModuleInterface* m_moduleInterface;
+  QList<QQuickItem*> m_recycledViews;
 };
 
 
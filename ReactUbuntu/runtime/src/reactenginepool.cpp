@@ -0,0 +1,65 @@
+
+/**
+ * Copyright (C) 2016, Canonical Ltd.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ *
+ * Author: Justin McPherson <justin.mcpherson@canonical.com>
+ *
+ */
+
+#include <QQmlComponent>
+#include <QQmlEngine>
+
+#include <QDebug>
+
+#include "reactenginepool.h"
+
+
+namespace {
+// Touches every import a React root view pulls in; compiling it walks the
+// import paths and loads the component sets' plugin libraries, both of
+// which QML only does once.
+static const char* probe_qml = R"PROBE(
+import QtQuick 2.4
+import Ubuntu.Components 1.2
+import React 0.1
+
+Item {
+}
+)PROBE";
+
+QQmlEngine* scratchEngine = nullptr;
+QQmlComponent* probeComponent = nullptr;
+}
+
+void ReactEnginePool::prewarm(QQmlEngine* engine)
+{
+  if (probeComponent != nullptr)
+    return;
+
+  if (engine == nullptr) {
+    scratchEngine = new QQmlEngine;
+    engine = scratchEngine;
+  }
+
+  probeComponent = new QQmlComponent(engine);
+  probeComponent->setData(QByteArray(probe_qml), QUrl());
+  if (probeComponent->isError()) {
+    // Best effort; whatever imports did resolve still had their plugins
+    // loaded.
+    for (const QQmlError& error : probeComponent->errors())
+      qWarning() << __PRETTY_FUNCTION__ << error.toString();
+  }
+}
+
+void ReactEnginePool::release()
+{
+  delete probeComponent;
+  probeComponent = nullptr;
+  delete scratchEngine;
+  scratchEngine = nullptr;
+}
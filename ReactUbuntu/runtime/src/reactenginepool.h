@@ -0,0 +1,42 @@
+/**
+ * Copyright (C) 2016, Canonical Ltd.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ *
+ * Author: Justin McPherson <justin.mcpherson@canonical.com>
+ *
+ */
+
+#ifndef REACTENGINEPOOL_H
+#define REACTENGINEPOOL_H
+
+class QQmlEngine;
+
+// Front-loads the one-time QML costs a React root view would otherwise pay
+// on its first frame: the import path walk, loading the plugin libraries of
+// the imported component sets, and registering their types. Plugin loading
+// and type registration are process-wide, so paying them at launch in any
+// engine makes the first real import of the same modules cheap.
+//
+// Host applications call prewarm() right after registering the React types
+// and before loading their root QML - passing their own engine when they
+// have one, so that engine-local import state lands where the first
+// ReactView will live. The bridge releases the pool when a real engine is
+// adopted.
+class ReactEnginePool
+{
+public:
+  // Resolves the React root view's import set in engine, or in a private
+  // scratch engine when none is supplied. Safe to call more than once; only
+  // the first call does work.
+  static void prewarm(QQmlEngine* engine = nullptr);
+
+  // Drops the scratch engine and the probe component once a real engine is
+  // serving React content.
+  static void release();
+};
+
+#endif // REACTENGINEPOOL_H
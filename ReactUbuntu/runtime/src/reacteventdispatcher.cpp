@@ -1,4 +1,3 @@
-
 /**
  * Copyright (C) 2016, Canonical Ltd.
  * All rights reserved.
@@ -11,15 +10,38 @@
  *
  */
 
+#include <QList>
 #include <QVariant>
 
 #include "reacteventdispatcher.h"
 #include "reactbridge.h"
+#include "reactscheduler.h"
+
+
+namespace
+{
+// Only streams where the latest value fully supersedes the previous one may
+// be merged; discrete events keep their order and count.
+bool isCoalesceable(const QString& eventName)
+{
+  return eventName == QLatin1String("topScroll") ||
+         eventName == QLatin1String("topTouchMove") ||
+         eventName == QLatin1String("topViewportChange");
+}
+}
 
 
 class ReactEventDispatcherPrivate {
 public:
+  struct QueuedEvent {
+    QString method;
+    QVariantList args;
+    QString coalesceKey;
+  };
+
   ReactBridge* bridge;
+  QList<QueuedEvent> events;
+  bool flushScheduled = false;
 };
 
 
@@ -41,3 +63,76 @@ void ReactEventDispatcher::sendDeviceEvent(const QString& name, const QVariantLi
                                   "emit",
                                   QVariantList{name, args});
 }
+
+void ReactEventDispatcher::sendViewEvent(
+  int reactTag,
+  const QString& eventName,
+  const QVariantList& eventData
+)
+{
+  QVariantList args{reactTag, eventName};
+  args += eventData;
+  queueEvent("receiveEvent",
+             args,
+             isCoalesceable(eventName)
+               ? eventName + "/" + QString::number(reactTag) : QString());
+}
+
+void ReactEventDispatcher::sendTouchEvent(
+  const QString& eventName,
+  const QVariantList& touches,
+  const QVariantList& changedIndices
+)
+{
+  queueEvent("receiveTouches",
+             QVariantList{eventName, touches, changedIndices},
+             isCoalesceable(eventName) ? eventName : QString());
+}
+
+void ReactEventDispatcher::queueEvent(
+  const QString& method,
+  const QVariantList& args,
+  const QString& coalesceKey
+)
+{
+  Q_D(ReactEventDispatcher);
+
+  // Only merge with the tail of the queue; replacing an entry that has other
+  // events queued after it would reorder the stream as JS sees it.
+  if (!coalesceKey.isEmpty() && !d->events.isEmpty() &&
+      d->events.last().coalesceKey == coalesceKey) {
+    d->events.last().args = args;
+  } else {
+    d->events.append(ReactEventDispatcherPrivate::QueuedEvent{method, args, coalesceKey});
+  }
+
+  scheduleFlush();
+}
+
+void ReactEventDispatcher::scheduleFlush()
+{
+  Q_D(ReactEventDispatcher);
+
+  if (d->flushScheduled)
+    return;
+  d->flushScheduled = true;
+  // Frame pacing moved to the bridge scheduler; the drain runs after layout
+  // applies, ahead of decode handoffs and cache work.
+  d->bridge->scheduler()->schedule(ReactScheduler::EventDispatch,
+                                   [this] { flushEvents(); });
+}
+
+void ReactEventDispatcher::flushEvents()
+{
+  Q_D(ReactEventDispatcher);
+
+  d->flushScheduled = false;
+  if (d->events.isEmpty())
+    return;
+
+  QList<ReactEventDispatcherPrivate::QueuedEvent> events;
+  events.swap(d->events);
+  for (const ReactEventDispatcherPrivate::QueuedEvent& e : events) {
+    d->bridge->enqueueJSCall("RCTEventEmitter", e.method, e.args);
+  }
+}
@@ -15,6 +15,7 @@
 #define REACTEVENTDISPATCHER_H
 
 #include <QObject>
+#include <QVariant>
 
 
 class ReactBridge;
@@ -32,7 +33,25 @@ public:
 
   void sendDeviceEvent(const QString& name, const QVariantList& args);
 
+  // View and touch events are queued and flushed once per rendered frame;
+  // consecutive events in a coalesceable stream (scrolls, touch moves)
+  // collapse to the latest value instead of one executor round trip each.
+  void sendViewEvent(int reactTag,
+                     const QString& eventName,
+                     const QVariantList& eventData = QVariantList{});
+  void sendTouchEvent(const QString& eventName,
+                      const QVariantList& touches,
+                      const QVariantList& changedIndices);
+
+private Q_SLOTS:
+  void flushEvents();
+
 private:
+  void queueEvent(const QString& method,
+                  const QVariantList& args,
+                  const QString& coalesceKey);
+  void scheduleFlush();
+
   QScopedPointer<ReactEventDispatcherPrivate> d_ptr;
 };
 
@@ -11,20 +11,69 @@
  *
  */
 
+#include <QHash>
+#include <QVector>
+
 #include "reactevents.h"
 
+
+namespace
+{
+// Recycled payload maps. An entry can be handed out again once the events
+// that referenced it have been flushed and dropped, leaving the pool as the
+// sole owner; until then it stays parked here.
+QVector<QVariantMap> payloadPool;
+const int kPayloadPoolSize = 8;
+}
+
 QString normalizeInputEventName(const QString& eventName)
 {
+  // The same handful of names passes through here thousands of times a
+  // minute during a drag; the normalized forms are interned so each lookup
+  // shares one allocation per distinct name.
+  static QHash<QString, QString> interned;
+  auto it = interned.constFind(eventName);
+  if (it != interned.constEnd())
+    return it.value();
+
   QString tmp = eventName;
-  if (eventName.startsWith("top"))
-    return tmp;
-
-  if (eventName.startsWith("on")) {
-    tmp.replace(0, 2, "top");
-  } else {
-    tmp[0] = tmp[0].toUpper();
-    tmp = "top" + tmp;
+  if (!eventName.startsWith("top")) {
+    if (eventName.startsWith("on")) {
+      tmp.replace(0, 2, "top");
+    } else {
+      tmp[0] = tmp[0].toUpper();
+      tmp = "top" + tmp;
+    }
   }
 
+  interned.insert(eventName, tmp);
   return tmp;
 }
+
+const QString& reactInternedString(const char* literal)
+{
+  static QHash<const void*, QString> strings;
+  QString& interned = strings[literal];
+  if (interned.isNull())
+    interned = QString::fromLatin1(literal);
+  return interned;
+}
+
+QVariantMap reactAcquireEventPayload()
+{
+  for (int i = 0; i < payloadPool.size(); ++i) {
+    if (payloadPool.at(i).isDetached()) {
+      QVariantMap payload;
+      payload.swap(payloadPool[i]);
+      payloadPool.remove(i);
+      return payload;
+    }
+  }
+  return QVariantMap{};
+}
+
+void reactReleaseEventPayload(const QVariantMap& payload)
+{
+  if (payloadPool.size() < kPayloadPoolSize)
+    payloadPool.append(payload);
+}
@@ -15,8 +15,22 @@
 #define REACTEVENTS_H
 
 #include <QString>
+#include <QVariant>
 
 
 QString normalizeInputEventName(const QString& eventName);
 
+// Returns a shared QString for a string literal; per-event payload keys then
+// reuse one allocation instead of converting from 8-bit on every insert.
+// Entries are keyed on the pointer, so only pass genuine literals.
+const QString& reactInternedString(const char* literal);
+
+// High frequency event payloads come from a small recycling pool. A released
+// map becomes reusable once the dispatcher has flushed every queued event
+// still referencing it; refilling the same key set then updates values in
+// place without allocating. Acquire can hand out a previously filled map, so
+// callers must write every key they expect readers to see.
+QVariantMap reactAcquireEventPayload();
+void reactReleaseEventPayload(const QVariantMap& payload);
+
 #endif
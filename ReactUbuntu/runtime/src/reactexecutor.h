@@ -19,12 +19,17 @@
 #include <QVariant>
 #include <QObject>
 
+#include "reactbridgevalue.h"
+
 class ReactExecutor : public QObject
 {
   Q_OBJECT
 
 public:
-  typedef std::function<void(const QJsonDocument&)> ExecuteCallback;
+  // Results arrive as the arena-backed value tree produced by
+  // reactParseBridgeJson; an invalid ref means the call produced no (or
+  // unparseable) output.
+  typedef std::function<void(const ReactBridgeValueRef&)> ExecuteCallback;
 
   ReactExecutor(QObject* parent);
   ~ReactExecutor();
@@ -32,6 +37,9 @@ public:
   virtual void init() = 0;
 
   virtual void injectJson(const QString& name, const QVariant& data) = 0;
+  // Injects bytes that are already JSON, skipping the QVariant walk and the
+  // encode; used for blobs cached across launches (module config).
+  virtual void injectSerializedJson(const QString& name, const QByteArray& json) = 0;
   virtual void executeApplicationScript(const QByteArray& script, const QUrl& sourceUrl) = 0;
   virtual void executeJSCall(const QString& method,
                              const QVariantList& args = QVariantList(),
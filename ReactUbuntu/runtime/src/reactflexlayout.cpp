@@ -10,6 +10,16 @@
  *
  */
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <QCoreApplication>
+#include <QHash>
+#include <QPointer>
 #include <QQuickItem>
 
 extern "C" {
@@ -18,35 +28,68 @@ extern "C" {
 
 #include "reactflexlayout.h"
 #include "reactattachedproperties.h"
+#include "reactthreadscheduling.h"
+#include "reacttrace.h"
 #include "reactvaluecoercion.h"
 
 
 namespace {
-static QMap<QString, ReactFlexLayout::Direction> directions{
-  { "row", ReactFlexLayout::DirectionRow },
-  { "column", ReactFlexLayout::DirectionColumn }
-};
-static QMap<QString, ReactFlexLayout::Alignment> alignments{
-  { "flex-start", ReactFlexLayout::AlignmentFlexStart },
-  { "flex-end", ReactFlexLayout::AlignmentFlexEnd },
-  { "center", ReactFlexLayout::AlignmentCenter },
-  { "stretch", ReactFlexLayout::AlignmentStretch }
-};
-static QMap<QString, ReactFlexLayout::Justify> justifys{
-  { "flex-start", ReactFlexLayout::JustifyFlexStart },
-  { "flex-end", ReactFlexLayout::JustifyFlexEnd },
-  { "center", ReactFlexLayout::JustifyCenter },
-  { "space-between", ReactFlexLayout::JustifySpaceBetween },
-  { "space-around", ReactFlexLayout::JustifySpaceAround }
-};
-static QMap<QString, ReactFlexLayout::Position> positions{
-  { "absolute", ReactFlexLayout::PositionAbsolute },
-  { "relative", ReactFlexLayout::PositionRelative }
-};
-static QMap<QString, ReactFlexLayout::Wrap> wraps{
-  { "wrap", ReactFlexLayout::WrapYes },
-  { "nowrap", ReactFlexLayout::WrapNo }
+enum StyleKeyword {
+  KeywordUnknown = -1,
+  KeywordRow,
+  KeywordColumn,
+  KeywordFlexStart,
+  KeywordFlexEnd,
+  KeywordCenter,
+  KeywordStretch,
+  KeywordSpaceBetween,
+  KeywordSpaceAround,
+  KeywordAbsolute,
+  KeywordRelative,
+  KeywordWrap,
+  KeywordNoWrap,
 };
+
+// Style keywords are resolved on (length, leading chars) instead of QMap
+// string lookups; createView bursts run this for every styled property, so
+// it has to be a couple of integer compares, not a red-black tree walk.
+StyleKeyword parseStyleKeyword(const QString& value) {
+  switch (value.length()) {
+  case 3:
+    return value == QLatin1String("row") ? KeywordRow : KeywordUnknown;
+  case 4:
+    return value == QLatin1String("wrap") ? KeywordWrap : KeywordUnknown;
+  case 6:
+    switch (value.at(0).unicode()) {
+    case 'c':
+      if (value == QLatin1String("column"))
+        return KeywordColumn;
+      return value == QLatin1String("center") ? KeywordCenter : KeywordUnknown;
+    case 'n':
+      return value == QLatin1String("nowrap") ? KeywordNoWrap : KeywordUnknown;
+    }
+    return KeywordUnknown;
+  case 7:
+    return value == QLatin1String("stretch") ? KeywordStretch : KeywordUnknown;
+  case 8:
+    switch (value.at(0).unicode()) {
+    case 'f':
+      return value == QLatin1String("flex-end") ? KeywordFlexEnd : KeywordUnknown;
+    case 'a':
+      return value == QLatin1String("absolute") ? KeywordAbsolute : KeywordUnknown;
+    case 'r':
+      return value == QLatin1String("relative") ? KeywordRelative : KeywordUnknown;
+    }
+    return KeywordUnknown;
+  case 10:
+    return value == QLatin1String("flex-start") ? KeywordFlexStart : KeywordUnknown;
+  case 12:
+    return value == QLatin1String("space-around") ? KeywordSpaceAround : KeywordUnknown;
+  case 13:
+    return value == QLatin1String("space-between") ? KeywordSpaceBetween : KeywordUnknown;
+  }
+  return KeywordUnknown;
+}
 }
 
 class FlexPropertyHandler {
@@ -61,63 +104,239 @@ public:
     }
   }
 
-  void applyProperties(ReactFlexLayout* fl, const QVariantMap& properties) {
+  void applyProperties(ReactFlexLayout* fl, const QVariantMap& properties,
+                       QHash<QString, quint64>* applied) {
     for (auto it = properties.constBegin(); it != properties.constEnd(); ++it) {
-      QMap<QString, QMetaProperty>::iterator pi = m_properties.find(it.key());
-      if (pi != m_properties.end()) {
-        pi.value().write(fl, reactCoerceValue(it.value(), pi.value().userType(), &m_coercions));
-      }
+      QHash<QString, QMetaProperty>::iterator pi = m_properties.find(it.key());
+      if (pi == m_properties.end())
+        continue;
+      const quint64 hash = reactPropertyHash(it.value());
+      QHash<QString, quint64>::const_iterator ai = applied->constFind(it.key());
+      if (ai != applied->constEnd() && ai.value() == hash)
+        continue;
+      pi.value().write(fl, reactCoerceValue(it.value(), pi.value().userType(), &m_coercions));
+      applied->insert(it.key(), hash);
     }
   }
 
+  // Unknown keywords fall back to the zero enumerator, which is what the
+  // old QMap lookups returned for a missing key.
   QMap<int, coerce_function> m_coercions{
     {
       qMetaTypeId<ReactFlexLayout::Direction>(),
       [](const QVariant& value) {
         Q_ASSERT(value.canConvert<QString>());
-        return directions[value.toString()];
+        switch (parseStyleKeyword(value.toString())) {
+        case KeywordRow: return ReactFlexLayout::DirectionRow;
+        case KeywordColumn: return ReactFlexLayout::DirectionColumn;
+        default: return ReactFlexLayout::DirectionColumn;
+        }
       }
     },
     {
       qMetaTypeId<ReactFlexLayout::Alignment>(),
       [](const QVariant& value) {
         Q_ASSERT(value.canConvert<QString>());
-        return alignments[value.toString()];
+        switch (parseStyleKeyword(value.toString())) {
+        case KeywordFlexStart: return ReactFlexLayout::AlignmentFlexStart;
+        case KeywordFlexEnd: return ReactFlexLayout::AlignmentFlexEnd;
+        case KeywordCenter: return ReactFlexLayout::AlignmentCenter;
+        case KeywordStretch: return ReactFlexLayout::AlignmentStretch;
+        default: return ReactFlexLayout::AlignementAuto;
+        }
       }
     },
     {
       qMetaTypeId<ReactFlexLayout::Justify>(),
       [](const QVariant& value) {
         Q_ASSERT(value.canConvert<QString>());
-        return justifys[value.toString()];
+        switch (parseStyleKeyword(value.toString())) {
+        case KeywordFlexStart: return ReactFlexLayout::JustifyFlexStart;
+        case KeywordFlexEnd: return ReactFlexLayout::JustifyFlexEnd;
+        case KeywordCenter: return ReactFlexLayout::JustifyCenter;
+        case KeywordSpaceBetween: return ReactFlexLayout::JustifySpaceBetween;
+        case KeywordSpaceAround: return ReactFlexLayout::JustifySpaceAround;
+        default: return ReactFlexLayout::JustifyFlexStart;
+        }
       }
     },
     {
       qMetaTypeId<ReactFlexLayout::Position>(),
       [](const QVariant& value) {
         Q_ASSERT(value.canConvert<QString>());
-        return positions[value.toString()];
+        switch (parseStyleKeyword(value.toString())) {
+        case KeywordAbsolute: return ReactFlexLayout::PositionAbsolute;
+        default: return ReactFlexLayout::PositionRelative;
+        }
       }
     },
     {
       qMetaTypeId<ReactFlexLayout::Wrap>(),
       [](const QVariant& value) {
         Q_ASSERT(value.canConvert<QString>());
-        return wraps[value.toString()];
+        switch (parseStyleKeyword(value.toString())) {
+        case KeywordWrap: return ReactFlexLayout::WrapYes;
+        default: return ReactFlexLayout::WrapNo;
+        }
       }
     },
   };
 
-  QMap<QString, QMetaProperty> m_properties;
+  QHash<QString, QMetaProperty> m_properties;
 };
 Q_GLOBAL_STATIC(FlexPropertyHandler, flexPropertyHandler);
 
 
+// Flyweight storage for layout style maps. Apps use a few hundred distinct
+// styles across tens of thousands of created nodes, so each distinct map is
+// interned once - hash-consed on its structural hash, keeping the canonical
+// map to rule out collisions - and items carry just the id. Comparing two
+// styles is then an integer compare, and the maps themselves are stored once
+// (Qt's implicit sharing makes the canonical copy the only deep one).
+class StyleInternTable {
+public:
+  int intern(const QVariantMap& style) {
+    const quint64 hash = reactPropertyHash(style);
+    for (auto it = m_ids.constFind(hash); it != m_ids.constEnd() && it.key() == hash; ++it) {
+      if (m_styles.at(it.value()) == style)
+        return it.value();
+    }
+    m_styles.push_back(style);
+    const int id = m_styles.size() - 1;
+    m_ids.insertMulti(hash, id);
+    return id;
+  }
+
+private:
+  QHash<quint64, int> m_ids;
+  std::vector<QVariantMap> m_styles;
+};
+Q_GLOBAL_STATIC(StyleInternTable, styleInternTable);
+
+
 QDebug operator<<(QDebug debug, const ReactFlexLayoutPrivate* p);
 
 namespace
 {
 enum { CSS_HORIZONTAL = CSS_BOTTOM + 1, CSS_VERTICAL, CSS_PROP_COUNT };
+
+bool asyncLayoutEnabled()
+{
+  static bool enabled = qgetenv("REACT_ASYNC_LAYOUT").toInt() > 0;
+  return enabled;
+}
+
+bool parallelLayoutEnabled()
+{
+  static bool enabled = qgetenv("REACT_PARALLEL_LAYOUT").toInt() > 0;
+  return enabled;
+}
+
+// Grid units per pixel for deterministic layout rounding; the test farm sets
+// 64 so geometry snapshots compare exactly across machines. 0 disables.
+float layoutScaleFactor()
+{
+  static float scale = qgetenv("REACT_LAYOUT_SCALE").toFloat();
+  return scale;
+}
+
+// Services one layout pass's measure misses in a single trip instead of a
+// synchronous call per text node mid-layout. Thread-safe measures (text
+// shaping against the shared measurement cache) fan out across a few
+// workers; anything else runs inline on the calling thread.
+void batchMeasureRequests(void*, css_measure_request_t* requests, int count)
+{
+  std::vector<int> concurrent;
+  for (int i = 0; i < count; ++i) {
+    css_measure_request_t& request = requests[i];
+    if (request.node->measure_thread_safe) {
+      concurrent.push_back(i);
+    } else {
+      request.result = request.node->measure(request.node->context,
+                                             request.width, request.width_mode,
+                                             request.height, request.height_mode);
+    }
+  }
+  if (concurrent.empty())
+    return;
+
+  std::atomic<int> next(0);
+  auto drain = [&] {
+    for (;;) {
+      int i = next.fetch_add(1);
+      if (i >= int(concurrent.size()))
+        break;
+      css_measure_request_t& request = requests[concurrent[i]];
+      request.result = request.node->measure(request.node->context,
+                                             request.width, request.width_mode,
+                                             request.height, request.height_mode);
+    }
+  };
+  int workers = std::min<int>(concurrent.size(), 4) - 1;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < workers; ++i)
+    threads.emplace_back(drain);
+  drain();
+  for (std::thread& t : threads)
+    t.join();
+}
+
+// Worker-thread copy of one flex node: just the css node (style and cached
+// layout) plus the dirty flag, so layoutNode can run against the shadow tree
+// without touching anything owned by the GUI thread. The css nodes all come
+// out of one arena, so the snapshot is a handful of slab allocations rather
+// than one malloc per node and the tree sits contiguously for the layout
+// pass; the arena outlives the ShadowNodes and is freed in bulk.
+struct ShadowNode {
+  css_node_t* node;
+  bool dirty = false;
+  QPointer<ReactFlexLayout> target;
+  std::vector<ShadowNode*> children;
+  measure_function measureFn;
+
+  ShadowNode(css_arena_t* arena)
+    : node(css_arena_new_node(arena)) {
+    node->context = this;
+    node->get_child = ShadowNode::getChild;
+    node->is_dirty = ShadowNode::isDirty;
+  }
+  ~ShadowNode() {
+    for (ShadowNode* child : children) {
+      delete child;
+    }
+  }
+  static css_node_t* getChild(void* context, int i) {
+    return static_cast<ShadowNode*>(context)->children[i]->node;
+  }
+  static bool isDirty(void* context) {
+    return static_cast<ShadowNode*>(context)->dirty;
+  }
+  static css_dim_t measure(void* context, float width, css_measure_mode_t widthMode, float height, css_measure_mode_t heightMode) {
+    ShadowNode* s = static_cast<ShadowNode*>(context);
+    flex_dimensions df = s->measureFn(width, FlexMeasureMode(widthMode), height, FlexMeasureMode(heightMode));
+    return { float(df.first), float(df.second) };
+  }
+};
+
+struct LayoutDiff {
+  QPointer<ReactFlexLayout> target;
+  float x;
+  float y;
+  float width;
+  float height;
+};
+
+// Carries one async layout run's results back to the GUI thread. Created on
+// the GUI thread so the posted event is delivered there; deletes itself once
+// applied, and drops the results if the root went away meanwhile.
+class AsyncLayoutJob : public QObject {
+public:
+  QPointer<ReactFlexLayout> root;
+  std::vector<LayoutDiff> diffs;
+  quint32 generation = 0;
+
+  bool event(QEvent* event) override; // defined below ReactFlexLayoutPrivate
+};
 }
 
 class ReactFlexLayoutPrivate
@@ -182,6 +401,11 @@ public:
   }
   void prepareLayout(ReactFlexLayoutPrivate* p) {
     p->cssNode->children_count = p->children.size();
+    if (p->prepareFunction) {
+      // GUI thread; lets items with measure functions snapshot whatever
+      // state the measure needs before it runs off the GUI thread.
+      p->prepareFunction();
+    }
     updateMargin(p);
     updatePadding(p);
 
@@ -203,12 +427,65 @@ public:
   void setDirty(bool dirty) {
     // qDebug() << __PRETTY_FUNCTION__ << this << "old" << dirty << "new" << dirty;
     this->dirty = dirty;
-    if (!dirty)
+    if (!dirty) {
+      selfDirty = false;
       return; // dont reset parent
-    if (parentItem != nullptr) {
-      ReactFlexLayout* pl = ReactFlexLayout::get(parentItem, false);
-      if (pl != nullptr)
-        pl->setDirty(dirty);
+    }
+    // This node's own style or content changed; ancestors are only marked as
+    // being on a dirty path, which is what lets relayout start at the
+    // nearest boundary instead of the root.
+    selfDirty = true;
+    ++layoutGeneration; // invalidates any in-flight async layout
+    if (measureFunction) {
+      // The measure cache is keyed on constraints only; a dirty measured
+      // item may mean its content (the text) changed under the same ones.
+      css_node_clear_measure_cache(cssNode);
+    }
+    markAncestorsDirty();
+  }
+  void markAncestorsDirty() {
+    ReactFlexLayoutPrivate* p = this;
+    while (p->parentItem != nullptr) {
+      ReactFlexLayout* pl = ReactFlexLayout::get(p->parentItem, false);
+      if (pl == nullptr)
+        break;
+      p = get(pl);
+      p->dirty = true;
+      ++p->layoutGeneration;
+    }
+  }
+  // A node whose style fixes both dimensions is a layout boundary: content
+  // changes below it cannot alter its own geometry, so relayout can start
+  // there instead of at the root.
+  bool isLayoutBoundary() const {
+    return !isUndefined(cssNode->style.dimensions[CSS_WIDTH]) &&
+           !isUndefined(cssNode->style.dimensions[CSS_HEIGHT]);
+  }
+  // For every node whose own state changed, records the nearest enclosing
+  // boundary (strict ancestor - a node's own margin or flex can still move
+  // its siblings). Falls back to the root when there is none.
+  static void collectRelayoutRoots(ReactFlexLayoutPrivate* node,
+                                   ReactFlexLayoutPrivate* boundary,
+                                   std::vector<ReactFlexLayoutPrivate*>& roots) {
+    if (!node->dirty)
+      return;
+    if (node->selfDirty) {
+      if (std::find(roots.begin(), roots.end(), boundary) == roots.end())
+        roots.push_back(boundary);
+      return; // the boundary pass covers everything below
+    }
+    ReactFlexLayoutPrivate* childBoundary = node->isLayoutBoundary() ? node : boundary;
+    for (auto& c : node->children) {
+      collectRelayoutRoots(get(ReactFlexLayout::get(c)), childBoundary, roots);
+    }
+  }
+  static void clearDirtySubtree(ReactFlexLayoutPrivate* p) {
+    if (!p->dirty && !p->selfDirty)
+      return;
+    p->dirty = false;
+    p->selfDirty = false;
+    for (auto& c : p->children) {
+      clearDirtySubtree(get(ReactFlexLayout::get(c)));
     }
   }
   void local_print_node(int tab) {
@@ -240,22 +517,141 @@ public:
     if (!dirty)
       return;
 
-    prepareLayout(this);
-    // qDebug() << __PRETTY_FUNCTION__ << "After prepareLayout";
-    // local_print_node(0);
-
-    layoutNode(cssNode, CSS_UNDEFINED, CSS_UNDEFINED, CSS_DIRECTION_INHERIT);
-    // qDebug() << __PRETTY_FUNCTION__ << "After layoutNode";
-    // local_print_node(0);
+    ReactTraceSpan span("layout");
+    css_layout_set_parallel(parallelLayoutEnabled());
+    css_layout_set_batch_measure(&batchMeasureRequests, nullptr);
+    css_layout_set_scale_factor(layoutScaleFactor());
+
+    std::vector<ReactFlexLayoutPrivate*> relayoutRoots;
+    collectRelayoutRoots(this, this, relayoutRoots);
+
+    for (ReactFlexLayoutPrivate* r : relayoutRoots) {
+      if (!r->dirty)
+        continue; // already covered by an enclosing pass
+
+      prepareLayout(r);
+      if (r == this) {
+        // Trees with GUI-only measure functions stay synchronous: their
+        // measurement calls back into Qt Quick, which is only safe on the
+        // GUI thread. Thread safe measures (text shaping) go async.
+        if (asyncLayoutEnabled() && !hasGuiOnlyMeasure(this)) {
+          layoutAsync();
+          return; // the full pass covers any boundary subtrees as well
+        }
+        // The flattened tree puts the nodes in contiguous parallel arrays;
+        // child access during the pass is index arithmetic instead of a
+        // QList walk through the attached-properties hash per visit.
+        css_flat_tree_t* flat = new_css_flat_tree(cssNode);
+        layout_css_flat_tree(flat, CSS_UNDEFINED, CSS_UNDEFINED, CSS_DIRECTION_INHERIT);
+        applyChangedLayout(flat, nullptr);
+        free_css_flat_tree(flat);
+      } else {
+        // The boundary's size is fixed by style; lay out just its subtree at
+        // that size and leave the boundary item where the parent put it.
+        css_flat_tree_t* flat = new_css_flat_tree(r->cssNode);
+        layout_css_flat_tree(flat,
+                             r->cssNode->style.dimensions[CSS_WIDTH],
+                             r->cssNode->style.dimensions[CSS_HEIGHT],
+                             CSS_DIRECTION_INHERIT);
+        applyChangedLayout(flat, r->cssNode);
+        free_css_flat_tree(flat);
+      }
+      clearDirtySubtree(r);
+    }
 
-    applyLayout();
-    // qDebug() << __PRETTY_FUNCTION__ << "After applyLayout";
-    // local_print_node(0);
+    // Anything still marked is a propagation flag on an ancestor of a
+    // boundary; clear those too so the next polish starts clean.
+    clearDirtySubtree(this);
   }
   void setMeasureFunction(const measure_function& measureFunction) {
     this->measureFunction = measureFunction;
     cssNode->measure = measureFunction ? measure : nullptr;
   }
+  static bool hasGuiOnlyMeasure(ReactFlexLayoutPrivate* p) {
+    if (p->measureFunction && !p->measureThreadSafe)
+      return true;
+    for (auto& c : p->children) {
+      if (hasGuiOnlyMeasure(get(ReactFlexLayout::get(c))))
+        return true;
+    }
+    return false;
+  }
+  ShadowNode* snapshotTree(ReactFlexLayoutPrivate* p, css_arena_t* arena) {
+    ShadowNode* s = new ShadowNode(arena);
+    s->node->style = p->cssNode->style;
+    s->node->layout = p->cssNode->layout;
+    s->node->children_count = p->children.size();
+    s->node->memoizable = p->cssNode->memoizable;
+    s->dirty = p->dirty;
+    s->target = p->q_ptr;
+    if (p->measureFunction && p->measureThreadSafe) {
+      s->measureFn = p->measureFunction;
+      s->node->measure = ShadowNode::measure;
+      s->node->measure_thread_safe = true;
+      memcpy(s->node->measure_cache, p->cssNode->measure_cache, sizeof(s->node->measure_cache));
+      s->node->measure_cache_count = p->cssNode->measure_cache_count;
+    }
+    for (auto& c : p->children) {
+      s->children.push_back(snapshotTree(get(ReactFlexLayout::get(c)), arena));
+    }
+    return s;
+  }
+  static void collectDiffs(ShadowNode* s, std::vector<LayoutDiff>& diffs) {
+    if (!s->node->layout.should_update) {
+      return;
+    }
+    diffs.push_back(LayoutDiff{ s->target,
+                                s->node->layout.position[CSS_LEFT],
+                                s->node->layout.position[CSS_TOP],
+                                s->node->layout.dimensions[CSS_WIDTH],
+                                s->node->layout.dimensions[CSS_HEIGHT] });
+    for (ShadowNode* child : s->children) {
+      collectDiffs(child, diffs);
+    }
+  }
+  void layoutAsync() {
+    if (asyncLayoutInFlight)
+      return; // applying the in-flight results reschedules if still dirty
+    asyncLayoutInFlight = true;
+
+    AsyncLayoutJob* job = new AsyncLayoutJob; // lives on the GUI thread
+    job->root = q_ptr;
+    job->generation = layoutGeneration;
+    std::shared_ptr<css_arena_t> arena(new_css_arena(256), free_css_arena);
+    std::shared_ptr<ShadowNode> shadow(snapshotTree(this, arena.get()));
+
+    // The layout pass only touches the shadow tree, so the GUI thread keeps
+    // rendering; the posted event delivers the diffs back to the job's
+    // thread even though the worker has no event loop of its own. The arena
+    // travels with the snapshot; ~ShadowNode never frees individual nodes.
+    std::thread([job, shadow, arena] {
+        reactApplyThreadScheduling("layout");
+        ReactTraceSpan span("layoutAsync");
+        layoutNodeBatched(shadow->node, CSS_UNDEFINED, CSS_UNDEFINED, CSS_DIRECTION_INHERIT);
+        css_round_layout_results(shadow->node);
+        collectDiffs(shadow.get(), job->diffs);
+        QCoreApplication::postEvent(job, new QEvent(QEvent::User));
+      }).detach();
+  }
+  void applyAsyncResults(const std::vector<LayoutDiff>& diffs, quint32 generation) {
+    asyncLayoutInFlight = false;
+    for (const LayoutDiff& diff : diffs) {
+      if (diff.target.isNull())
+        continue;
+      ReactFlexLayoutPrivate* p = get(diff.target.data());
+      if (!p->qmlAnchors) {
+        p->applyGeometry(diff.x, diff.y, diff.width, diff.height);
+      }
+      p->dirty = false;
+    }
+    if (layoutGeneration != generation) {
+      // The tree changed while the worker ran; schedule another pass.
+      dirty = true;
+      item->polish();
+    } else {
+      clearDirtySubtree(this);
+    }
+  }
   static ReactFlexLayoutPrivate* get(ReactFlexLayout* rfl) {
     return rfl->d_func();
   }
@@ -281,41 +677,80 @@ public:
   bool qmlImplicitWidth;
   bool qmlImplicitHeight;
   bool dirty;
+  bool selfDirty = false; // this node changed, not just a descendant
+  bool asyncLayoutInFlight = false;
+  quint32 layoutGeneration = 0;
   float padding[CSS_PROP_COUNT];
   float margin[CSS_PROP_COUNT];
   QQuickItem* item;
   QQuickItem* parentItem;
   QList<QQuickItem*> children;
+  // reactPropertyHash of the last style value applied per key; resends of an
+  // unchanged value are dropped before they can dirty the layout.
+  QHash<QString, quint64> appliedStyle;
+  // Interned id of the last style map applied; -1 until one has been.
+  int styleId = -1;
   css_node_t* cssNode;
   measure_function measureFunction;
+  std::function<void()> prepareFunction;
+  bool measureThreadSafe = false;
   ReactFlexLayout* q_ptr;
 
 private:
-  void applyLayout() {
-    // qDebug() << __PRETTY_FUNCTION__ << this << cssNode->layout.should_update;
-    if (!cssNode->layout.should_update) {
-      return;
-    }
-    cssNode->layout.should_update = false;
-    dirty = false;
-
-    if (!qmlAnchors) {
-      item->setX(cssNode->layout.position[CSS_LEFT]);
-      item->setY(cssNode->layout.position[CSS_TOP]);
-      item->setWidth(cssNode->layout.dimensions[CSS_WIDTH]);
-      item->setHeight(cssNode->layout.dimensions[CSS_HEIGHT]);
+  // Applies one pass's results off the flat tree's change list: only nodes
+  // whose geometry actually moved are visited, so the apply cost scales with
+  // the change, not the tree. A boundary relayout passes its root as
+  // skipNode - the boundary computed itself at a local origin, but the item
+  // stays where the enclosing pass put it.
+  static void applyChangedLayout(css_flat_tree_t* flat, css_node_t* skipNode) {
+    css_layout_change_t* changes;
+    int count = css_flat_tree_changes(flat, &changes);
+    for (int i = 0; i < count; ++i) {
+      const css_layout_change_t& change = changes[i];
+      if (change.node == skipNode)
+        continue;
+      ReactFlexLayoutPrivate* p = static_cast<ReactFlexLayoutPrivate*>(change.node->context);
+      if (!p->qmlAnchors) {
+        p->applyGeometry(change.position[CSS_LEFT],
+                         change.position[CSS_TOP],
+                         change.dimensions[CSS_WIDTH],
+                         change.dimensions[CSS_HEIGHT]);
+      }
+      css_node_set_applied(change.node,
+                           change.position[CSS_LEFT],
+                           change.position[CSS_TOP],
+                           change.dimensions[CSS_WIDTH],
+                           change.dimensions[CSS_HEIGHT]);
     }
+  }
+  // Unchanged geometry must not poke the item; a no-op write would still
+  // pay for the property machinery on every relayout.
+  void applyGeometry(double x, double y, double width, double height) {
+    if (item->x() != x)
+      item->setX(x);
+    if (item->y() != y)
+      item->setY(y);
+    if (item->width() != width)
+      item->setWidth(width);
+    if (item->height() != height)
+      item->setHeight(height);
+  }
+};
 
-    for (auto& c : children) {
-      ReactFlexLayoutPrivate::get(ReactFlexLayout::get(c))->applyLayout();
+namespace
+{
+bool AsyncLayoutJob::event(QEvent* event)
+{
+  if (event->type() == QEvent::User) {
+    if (!root.isNull()) {
+      ReactFlexLayoutPrivate::get(root.data())->applyAsyncResults(diffs, generation);
     }
-
-    cssNode->layout.position[CSS_LEFT] = 0;
-    cssNode->layout.position[CSS_TOP] = 0;
-    cssNode->layout.dimensions[CSS_WIDTH] = CSS_UNDEFINED;
-    cssNode->layout.dimensions[CSS_HEIGHT] = CSS_UNDEFINED;
+    deleteLater();
+    return true;
   }
-};
+  return QObject::event(event);
+}
+}
 
 QDebug operator<<(QDebug debug, const ReactFlexLayoutPrivate* p)
 {
@@ -393,6 +828,17 @@ void ReactFlexLayout::setQmlImplicitHeight(bool qmlImplicitHeight)
   d->qmlImplicitHeight = qmlImplicitHeight;
 }
 
+bool ReactFlexLayout::memoizable() const
+{
+  return d_func()->cssNode->memoizable;
+}
+
+void ReactFlexLayout::setMemoizable(bool memoizable)
+{
+  Q_D(ReactFlexLayout);
+  d->cssNode->memoizable = memoizable;
+}
+
 bool ReactFlexLayout::isDirty()
 {
   return d_func()->dirty;
@@ -401,7 +847,9 @@ bool ReactFlexLayout::isDirty()
 void ReactFlexLayout::setDirty(bool dirty)
 {
   Q_D(ReactFlexLayout);
-  if (d->dirty == dirty)
+  // Re-marking an already dirty node still has to go through: it may only be
+  // on a dirty path so far, and now needs recording as changed itself.
+  if (!dirty && !d->dirty)
     return;
   d->setDirty(dirty);
 }
@@ -797,6 +1245,18 @@ void ReactFlexLayout::setMeasureFunction(const measure_function& measureFunction
   d_func()->setMeasureFunction(measureFunction);
 }
 
+void ReactFlexLayout::setPrepareFunction(const std::function<void()>& prepareFunction)
+{
+  d_func()->prepareFunction = prepareFunction;
+}
+
+void ReactFlexLayout::setMeasureThreadSafe(bool threadSafe)
+{
+  Q_D(ReactFlexLayout);
+  d->measureThreadSafe = threadSafe;
+  d->cssNode->measure_thread_safe = threadSafe;
+}
+
 QQuickItem* ReactFlexLayout::parentItem() const
 {
   return d_func()->parentItem;
@@ -837,7 +1297,43 @@ QList<QQuickItem*> ReactFlexLayout::removeChildren(const QList<int>& children)
 
 void ReactFlexLayout::applyLayoutProperties(const QVariantMap& properties)
 {
-  flexPropertyHandler()->applyProperties(this, properties);
+  Q_D(ReactFlexLayout);
+  // Recycled list rows mostly re-wear a style the item already has; one
+  // integer compare against the interned id skips the whole per-property
+  // walk in that case.
+  const int styleId = styleInternTable()->intern(properties);
+  if (styleId == d->styleId)
+    return;
+  flexPropertyHandler()->applyProperties(this, properties, &d->appliedStyle);
+  d->styleId = styleId;
+}
+
+void ReactFlexLayout::resetStyle()
+{
+  Q_D(ReactFlexLayout);
+
+  // new_css_node supplies the default style; swap in a fresh node rather
+  // than replicating the defaults here. The measure hook survives the reset
+  // as it belongs to the item, not its place in the tree.
+  css_node_t* fresh = new_css_node();
+  fresh->context = d->cssNode->context;
+  fresh->get_child = d->cssNode->get_child;
+  fresh->is_dirty = d->cssNode->is_dirty;
+  fresh->measure = d->cssNode->measure;
+  fresh->measure_thread_safe = d->cssNode->measure_thread_safe;
+  free_css_node(d->cssNode);
+  d->cssNode = fresh;
+
+  for (int i = 0; i < CSS_PROP_COUNT; ++i) {
+    d->margin[i] = CSS_UNDEFINED;
+    d->padding[i] = CSS_UNDEFINED;
+  }
+  d->dirty = false;
+  d->selfDirty = false;
+  d->parentItem = nullptr;
+  d->children.clear();
+  d->appliedStyle.clear();
+  d->styleId = -1;
 }
 
 void ReactFlexLayout::polish(QQuickItem* item)
@@ -42,6 +42,7 @@ class ReactFlexLayout : public QObject
   Q_PROPERTY(bool qmlImplicitWidth READ qmlImplicitWidth WRITE setQmlImplicitWidth)
   Q_PROPERTY(bool qmlImplicitHeight READ qmlImplicitHeight WRITE setQmlImplicitHeight)
   Q_PROPERTY(bool dirty READ isDirty WRITE setDirty)
+  Q_PROPERTY(bool memoizable READ memoizable WRITE setMemoizable)
   Q_PROPERTY(double flex READ flex WRITE setFlex NOTIFY flexChanged)
   Q_PROPERTY(Direction flexDirection READ flexDirection WRITE setFlexDirection NOTIFY flexDirectionChanged)
   Q_PROPERTY(Justify justifyContent READ justifyContent WRITE setJustifyContent NOTIFY justifyContentChanged)
@@ -98,6 +99,11 @@ public:
   bool isDirty();
   void setDirty(bool dirty);
 
+  // Opts this item's subtree into the layout engine's memoization cache;
+  // meant for list rows whose siblings share style and shape.
+  bool memoizable() const;
+  void setMemoizable(bool memoizable);
+
   double flex() const;
   void setFlex(double flex);
 
@@ -187,6 +193,15 @@ public:
   measure_function measureFunction() const;
   void setMeasureFunction(const measure_function& measureFunction);
 
+  // Invoked on the GUI thread before each layout pass; gives items with a
+  // measure function a chance to snapshot the state the measure needs when
+  // it runs away from the GUI thread.
+  void setPrepareFunction(const std::function<void()>& prepareFunction);
+
+  // Marks the measure function as safe to call from the async layout
+  // worker; trees made up of such measures keep the asynchronous path.
+  void setMeasureThreadSafe(bool threadSafe);
+
   QQuickItem* parentItem() const;
   void setParentItem(QQuickItem* parentItem);
 
@@ -195,6 +210,10 @@ public:
 
   void applyLayoutProperties(const QVariantMap& properties);
 
+  // Returns the style to its initial state; used when the item is recycled
+  // so style from the previous incarnation does not leak into the next one.
+  void resetStyle();
+
   static void polish(QQuickItem* item);
   static ReactFlexLayout* get(QQuickItem* item, bool create = true);
   static ReactFlexLayout* qmlAttachedProperties(QObject* object);
@@ -0,0 +1,158 @@
+
+/**
+ * Copyright (C) 2016, Canonical Ltd.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ *
+ * Author: Justin McPherson <justin.mcpherson@canonical.com>
+ *
+ */
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QQuickWindow>
+#include <QSet>
+#include <QVector>
+
+#include <QDebug>
+
+#include "reactframemonitor.h"
+
+
+namespace {
+
+struct Dispatch {
+  qint64 beginUs;
+  qint64 endUs;
+  QString name;
+};
+
+// A frame or two of dispatches on a busy bridge; older entries cannot have
+// contributed to a stall still being detected.
+const int kDispatchRingSize = 1024;
+
+// Recording stops when full; a session that janky has given us plenty.
+const int kMaxIncidents = 256;
+
+// Swap gaps past this are a window with nothing to repaint, not a stall.
+const qint64 kIdleCeilingUs = 1000 * 1000;
+
+QString incidentsPath;
+QElapsedTimer monitorClock;
+qint64 budgetUs = 32 * 1000;
+
+QMutex monitorLock;
+QVector<Dispatch> dispatchRing(kDispatchRingSize);
+int dispatchHead = 0;
+QJsonArray incidents;
+QSet<QQuickWindow*> hookedWindows;
+qint64 lastSwapUs = -1;
+
+void dumpIncidents()
+{
+  if (incidents.isEmpty())
+    return;
+
+  QFile out(incidentsPath);
+  if (!out.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+    qWarning() << "Could not write frame incidents to" << incidentsPath;
+    return;
+  }
+  out.write(QJsonDocument(incidents).toJson());
+}
+
+// Render thread; the lock is only contended when the bridge is mid-batch,
+// which is exactly the overlap worth recording.
+void frameSwapped()
+{
+  const qint64 now = reactFrameMonitorNowUs();
+
+  QMutexLocker locker(&monitorLock);
+  const qint64 last = lastSwapUs;
+  lastSwapUs = now;
+  if (last < 0)
+    return;
+
+  const qint64 delta = now - last;
+  if (delta <= budgetUs || delta > kIdleCeilingUs || incidents.size() >= kMaxIncidents)
+    return;
+
+  QJsonArray overlapping;
+  for (int i = 0; i < kDispatchRingSize; ++i) {
+    const Dispatch& dispatch = dispatchRing.at((dispatchHead + i) % kDispatchRingSize);
+    if (dispatch.name.isEmpty() || dispatch.endUs < last || dispatch.beginUs > now)
+      continue;
+    overlapping.append(QJsonObject{
+      { "name", dispatch.name },
+      { "beginUs", dispatch.beginUs },
+      { "durationUs", dispatch.endUs - dispatch.beginUs },
+    });
+  }
+
+  incidents.append(QJsonObject{
+    { "tsUs", now },
+    { "frameMs", delta / 1000.0 },
+    { "dispatches", overlapping },
+  });
+}
+
+} // namespace
+
+bool reactFrameMonitorEnabled()
+{
+  static const bool enabled = [] {
+    incidentsPath = QString::fromLocal8Bit(qgetenv("REACT_FRAME_INCIDENTS_FILE"));
+    if (incidentsPath.isEmpty())
+      return false;
+    bool ok = false;
+    const qint64 budget = qgetenv("REACT_FRAME_BUDGET_MS").toLongLong(&ok);
+    if (ok && budget > 0)
+      budgetUs = budget * 1000;
+    monitorClock.start();
+    qAddPostRoutine(dumpIncidents);
+    return true;
+  }();
+  return enabled;
+}
+
+qint64 reactFrameMonitorNowUs()
+{
+  return monitorClock.nsecsElapsed() / 1000;
+}
+
+void reactFrameMonitorAttach(QQuickWindow* window)
+{
+  if (!reactFrameMonitorEnabled() || window == nullptr)
+    return;
+
+  QMutexLocker locker(&monitorLock);
+  if (hookedWindows.contains(window))
+    return;
+  hookedWindows.insert(window);
+
+  QObject::connect(window, &QQuickWindow::frameSwapped, window,
+                   [] { frameSwapped(); }, Qt::DirectConnection);
+  QObject::connect(window, &QObject::destroyed, [window] {
+    QMutexLocker locker(&monitorLock);
+    hookedWindows.remove(window);
+  });
+}
+
+void reactFrameMonitorDispatch(const QString& name, qint64 beginUs, qint64 endUs)
+{
+  if (!reactFrameMonitorEnabled())
+    return;
+
+  QMutexLocker locker(&monitorLock);
+  dispatchRing[dispatchHead] = Dispatch{beginUs, endUs, name};
+  dispatchHead = (dispatchHead + 1) % kDispatchRingSize;
+}
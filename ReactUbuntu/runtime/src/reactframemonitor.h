@@ -0,0 +1,45 @@
+/**
+ * Copyright (C) 2016, Canonical Ltd.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ *
+ * Author: Justin McPherson <justin.mcpherson@canonical.com>
+ *
+ */
+
+#ifndef REACTFRAMEMONITOR_H
+#define REACTFRAMEMONITOR_H
+
+#include <QString>
+#include <QtGlobal>
+
+class QQuickWindow;
+
+// Dropped-frame detector. Point REACT_FRAME_INCIDENTS_FILE at a path and
+// the root window's frameSwapped deltas are watched for over-budget frames
+// (REACT_FRAME_BUDGET_MS, default 32); each one is captured as an incident
+// record carrying the module dispatches that overlapped the stalled frame,
+// taken from a small always-recording ring the bridge's batch walk feeds.
+// Incidents dump as JSON when the application exits, turning "it stutters
+// sometimes" into per-module attribution.
+//
+// Windows only repaint on damage, so long swap gaps are usually idle, not
+// jank; deltas past an idle ceiling are ignored.
+
+// Checked once at startup from the environment; constant afterwards.
+bool reactFrameMonitorEnabled();
+
+// Microseconds on the monitor clock.
+qint64 reactFrameMonitorNowUs();
+
+// Watches frameSwapped on the root view's window. Safe to call per root
+// view; a window is only hooked once.
+void reactFrameMonitorAttach(QQuickWindow* window);
+
+// Records one native module dispatch into the attribution ring.
+void reactFrameMonitorDispatch(const QString& name, qint64 beginUs, qint64 endUs);
+
+#endif // REACTFRAMEMONITOR_H
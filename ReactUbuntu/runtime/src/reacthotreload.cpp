@@ -0,0 +1,126 @@
+
+/**
+ * Copyright (C) 2016, Canonical Ltd.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ *
+ * Author: Justin McPherson <justin.mcpherson@canonical.com>
+ *
+ */
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTimer>
+#include <QUrlQuery>
+#include <QWebSocket>
+
+#include <QDebug>
+
+#include "reacthotreload.h"
+#include "reactbridge.h"
+#include "reactredboxitem.h"
+
+
+namespace {
+const int redialDelayMs = 2000;
+}
+
+class ReactHotReloadPrivate : public QObject {
+  Q_OBJECT
+public:
+  ReactBridge* bridge = nullptr;
+  QWebSocket socket;
+  QUrl socketUrl;
+  bool redialPending = false;
+
+  void dial() {
+    socket.open(socketUrl);
+  }
+
+public Q_SLOTS:
+  void messageReceived(const QString& message) {
+    const QJsonObject update = QJsonDocument::fromJson(message.toUtf8()).object();
+    const QString type = update.value("type").toString();
+
+    if (type == "update") {
+      // Each entry redefines one module's factory in the running host; the
+      // HMR runtime in the bundle then re-requires it and propagates along
+      // the accept chain. The evaluation flushes the JS queue like any
+      // script, so resulting view updates apply through the normal batch
+      // path, in place.
+      QByteArray script;
+      for (const QJsonValue& module :
+           update.value("body").toObject().value("modules").toArray()) {
+        script += module.toObject().value("code").toString().toUtf8();
+        script += '\n';
+      }
+      if (!script.isEmpty())
+        bridge->executeSourceCode(script);
+    } else if (type == "error") {
+      bridge->redbox()->showErrorMessage(
+        update.value("body").toObject().value("description").toString());
+    }
+    // update-start and update-done only delimit a burst; nothing to do.
+  }
+
+  void redial() {
+    // Error and disconnected both fire for most failures; one timer covers
+    // the pair.
+    if (redialPending)
+      return;
+    redialPending = true;
+    qWarning() << "Hot reload connection lost; redialing" << socketUrl;
+    QTimer::singleShot(redialDelayMs, this, [=] {
+        redialPending = false;
+        dial();
+      });
+  }
+};
+
+
+ReactHotReload::ReactHotReload(ReactBridge* bridge)
+  : QObject(bridge)
+  , d_ptr(new ReactHotReloadPrivate)
+{
+  Q_D(ReactHotReload);
+  d->bridge = bridge;
+  connect(&d->socket, SIGNAL(textMessageReceived(QString)), d, SLOT(messageReceived(QString)));
+  connect(&d->socket, SIGNAL(error(QAbstractSocket::SocketError)), d, SLOT(redial()));
+  connect(&d->socket, SIGNAL(disconnected()), d, SLOT(redial()));
+}
+
+ReactHotReload::~ReactHotReload()
+{
+}
+
+void ReactHotReload::start(const QUrl& bundleUrl)
+{
+  Q_D(ReactHotReload);
+
+  QUrl url;
+  url.setScheme("ws");
+  url.setHost(bundleUrl.host());
+  url.setPort(bundleUrl.port(8081));
+  url.setPath("/hot");
+
+  // The packager keys its update streams on the entry file the bundle was
+  // built from; the bundle path maps back to it by swapping the extension.
+  QString entry = bundleUrl.path();
+  if (entry.startsWith('/'))
+    entry.remove(0, 1);
+  entry.replace(".bundle", ".js");
+
+  QUrlQuery query;
+  query.addQueryItem("platform", "ubuntu");
+  query.addQueryItem("bundleEntry", entry);
+  url.setQuery(query);
+
+  d->socketUrl = url;
+  d->dial();
+}
+
+#include "reacthotreload.moc"
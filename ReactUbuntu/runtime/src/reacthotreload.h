@@ -0,0 +1,49 @@
+
+/**
+ * Copyright (C) 2016, Canonical Ltd.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ *
+ * Author: Justin McPherson <justin.mcpherson@canonical.com>
+ *
+ */
+
+#ifndef REACTHOTRELOAD_H
+#define REACTHOTRELOAD_H
+
+#include <QObject>
+#include <QScopedPointer>
+#include <QUrl>
+
+class ReactBridge;
+
+// Module-level hot reload against a packager. Subscribes to the packager's
+// /hot socket and evaluates each update's changed module factories in the
+// running JS host, so an edit re-executes only the modules it touched. The
+// bridge, module registry and native view tree all stay up; React's own
+// reconciliation then rebuilds just the views whose components changed,
+// where a live reload tears the whole pipeline down and refetches the
+// bundle. The bundle has to be requested with hot=true so the packager
+// includes its HMR runtime; ReactView appends that when hot reload is on.
+class ReactHotReloadPrivate;
+class ReactHotReload : public QObject
+{
+  Q_OBJECT
+  Q_DECLARE_PRIVATE(ReactHotReload)
+
+public:
+  ReactHotReload(ReactBridge* bridge);
+  ~ReactHotReload();
+
+  // Connects to the packager serving the bundle and applies updates until
+  // destroyed; a dropped socket is redialed after a short delay.
+  void start(const QUrl& bundleUrl);
+
+private:
+  QScopedPointer<ReactHotReloadPrivate> d_ptr;
+};
+
+#endif // REACTHOTRELOAD_H
@@ -10,56 +10,400 @@
  *
  */
 
+#include <atomic>
 #include <memory>
 
+#include <QBuffer>
+#include <QCache>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QFile>
+#include <QHash>
 #include <QMap>
+#include <QPair>
+#include <QMutex>
+#include <QMutexLocker>
 #include <QCryptographicHash>
+#include <QImageReader>
 #include <QNetworkRequest>
 #include <QNetworkReply>
 #include <QNetworkDiskCache>
 #include <QQuickImageProvider>
+#include <QQuickWindow>
+#include <QRunnable>
+#include <QSGTexture>
+#include <QThreadPool>
 
 #include "reactimageloader.h"
 #include "reactbridge.h"
+#include "reactscheduler.h"
+#include "reactrequestscheduler.h"
+#include "reactcachestats.h"
+#include "reactmemorybudget.h"
+#include "reactthreadscheduling.h"
+
+
+namespace
+{
+// Upper bound on decoded bitmaps kept around; QCache evicts least recently
+// used entries once the summed byteCount passes this.
+const int kDecodedCacheBytes = 64 * 1024 * 1024;
+
+// No progressive pass is attempted before this much of the transfer has
+// arrived; below it even a progressive JPEG rarely has a complete first scan.
+const qint64 kProgressiveMinBytes = 32 * 1024;
+
+// Partial passes decode bounded to this edge; they only bridge the gap until
+// the full image arrives, so full resolution would be wasted work.
+const int kProgressivePassEdge = 256;
+}
 
 
 class ReactImageLoaderPrivate {
 public:
+  // Delegates to one GL texture shared by every image view showing the same
+  // content. The scene graph owns and deletes the texture each Image node
+  // holds, so sharing the upload needs this thin ref-holding proxy: each
+  // node gets its own deletable QSGTexture, all bound to the same pixels.
+  class SharedTexture : public QSGTexture {
+  public:
+    SharedTexture(const QSharedPointer<QSGTexture>& inner) : inner(inner) {}
+    int textureId() const override { return inner->textureId(); }
+    QSize textureSize() const override { return inner->textureSize(); }
+    bool hasAlphaChannel() const override { return inner->hasAlphaChannel(); }
+    bool hasMipmaps() const override { return inner->hasMipmaps(); }
+    bool isAtlasTexture() const override { return inner->isAtlasTexture(); }
+    QSGTexture* removedFromAtlas() const override { return inner->removedFromAtlas(); }
+    QRectF normalizedTextureSubRect() const override { return inner->normalizedTextureSubRect(); }
+    void bind() override {
+      // The node configures sampling on its own texture object; forward the
+      // state so the shared texture binds the way this node expects.
+      inner->setFiltering(filtering());
+      inner->setMipmapFiltering(mipmapFiltering());
+      inner->setHorizontalWrapMode(horizontalWrapMode());
+      inner->setVerticalWrapMode(verticalWrapMode());
+      inner->bind();
+    }
+  private:
+    QSharedPointer<QSGTexture> inner;
+  };
+
+  class SharedTextureFactory : public QQuickTextureFactory {
+  public:
+    SharedTextureFactory(ReactImageLoaderPrivate* priv, const QString& key, const QImage& image)
+      : p(priv), key(key), m_image(image) {}
+    QSGTexture* createTexture(QQuickWindow* window) const override {
+      return new SharedTexture(p->sharedTexture(key, m_image, window));
+    }
+    QSize textureSize() const override { return m_image.size(); }
+    int textureByteCount() const override { return m_image.byteCount(); }
+    QImage image() const override { return m_image; }
+  private:
+    ReactImageLoaderPrivate* p;
+    QString key;
+    QImage m_image;
+  };
+
   class ImageProvider : public QQuickImageProvider {
   public:
-    ImageProvider(ReactImageLoaderPrivate* priv):QQuickImageProvider(QQuickImageProvider::Image), p(priv) {}
-    QImage requestImage(const QString& id,  QSize* size, const QSize& requestedSize) override {
-      auto cache = qobject_cast<QNetworkDiskCache*>(p->bridge->networkAccessManager()->cache());
-      auto idev = cache->data(p->cacheIds.key(id.toLocal8Bit()));
-      if (idev == nullptr) {
-        qWarning() << __PRETTY_FUNCTION__ << "Could not obtain cache entry for" << id;
-        return QImage();
+    ImageProvider(ReactImageLoaderPrivate* priv):QQuickImageProvider(QQuickImageProvider::Texture), p(priv) {}
+    QQuickTextureFactory* requestTexture(const QString& id, QSize* size, const QSize& requestedSize) override {
+      const QString key = decodeKey(id, requestedSize);
+      QImage image = p->lookupDecoded(key);
+      if (image.isNull() && id.contains(QLatin1String("!p"))) {
+        // An evicted progressive pass cannot be rebuilt from the disk cache;
+        // the full image is on its way regardless.
+        return nullptr;
       }
-      idev->deleteLater();
-      QImage image = QImage::fromData(idev->readAll());
+      if (image.isNull()) {
+        auto cache = qobject_cast<QNetworkDiskCache*>(p->bridge->networkAccessManager()->cache());
+        auto idev = cache->data(p->cacheIds.key(id.toLocal8Bit()));
+        if (idev == nullptr) {
+          qWarning() << __PRETTY_FUNCTION__ << "Could not obtain cache entry for" << id;
+          return nullptr;
+        }
+        image = decodeImage(readCacheData(idev), requestedSize);
+        delete idev; // releases the mapping, so only after the decode
+        p->cacheDecoded(key, image);
+      }
+      if (image.isNull())
+        return nullptr;
       if (size != nullptr)
         *size = image.size();
-      return image;
+      return new SharedTextureFactory(p, key, image);
     }
     ReactImageLoaderPrivate* p = nullptr;
   };
 
+  // Per-fetch progressive decode bookkeeping; touched on the GUI thread only.
+  struct ProgressiveState {
+    qint64 nextAttemptBytes = kProgressiveMinBytes;
+    int pass = 0;
+    bool decodeInFlight = false;
+    bool checkedFormat = false;
+    bool formatSupported = false;
+  };
+
+  // Receives one decoded pass back on the GUI thread - publishing touches
+  // the active fetch table and runs subscriber callbacks. Created on the GUI
+  // thread so the posted event is delivered there; deletes itself once the
+  // pass has been applied.
+  class ProgressivePassReceiver : public QObject {
+  public:
+    ProgressivePassReceiver(ReactImageLoaderPrivate* priv, const QUrl& source,
+                            const std::shared_ptr<ProgressiveState>& state, int pass)
+      : p(priv), source(source), state(state), pass(pass) {}
+    bool event(QEvent* ev) override {
+      if (ev->type() != QEvent::User)
+        return QObject::event(ev);
+      state->decodeInFlight = false;
+      p->publishProgressivePass(source, image, pass);
+      deleteLater();
+      return true;
+    }
+    ReactImageLoaderPrivate* p;
+    QUrl source;
+    std::shared_ptr<ProgressiveState> state;
+    int pass;
+    QImage image;
+  };
+
+  // Decodes a partial transfer into a bounded low-resolution pass on the
+  // global thread pool and posts the result to the GUI-thread receiver.
+  class ProgressiveDecodeJob : public QRunnable {
+  public:
+    ProgressiveDecodeJob(ProgressivePassReceiver* receiver, const QByteArray& partial)
+      : receiver(receiver), partial(partial) {}
+    void run() override {
+      reactApplyThreadScheduling("decode");
+      receiver->image = decodeImage(partial,
+                                    QSize(kProgressivePassEdge, kProgressivePassEdge));
+      QCoreApplication::postEvent(receiver, new QEvent(QEvent::User));
+    }
+    ProgressivePassReceiver* receiver;
+    QByteArray partial;
+  };
+
+  // Decodes one image on the global thread pool and parks the bitmap in the
+  // decoded cache for the provider to pick up.
+  class DecodeJob : public QRunnable {
+  public:
+    DecodeJob(ReactImageLoaderPrivate* priv, const QUrl& source, const QSize& targetSize,
+              const std::shared_ptr<std::atomic<int>>& state)
+      : p(priv), source(source), targetSize(targetSize), state(state) {}
+    void run() override {
+      // Claim the queued slot; an interest revocation that got there first
+      // has already counted the drop, and the decode simply never happens.
+      int expected = DecodeQueued;
+      if (!state->compare_exchange_strong(expected, DecodeStarted))
+        return;
+      reactApplyThreadScheduling("decode");
+      auto cache = qobject_cast<QNetworkDiskCache*>(p->bridge->networkAccessManager()->cache());
+      auto idev = cache->data(source);
+      if (idev == nullptr)
+        return;
+      const QString id = QString::fromLatin1(p->cacheIds.value(source));
+      p->cacheDecoded(decodeKey(id, targetSize), decodeImage(readCacheData(idev), targetSize));
+      delete idev;
+    }
+    ReactImageLoaderPrivate* p;
+    QUrl source;
+    QSize targetSize;
+    std::shared_ptr<std::atomic<int>> state;
+  };
+
+  // Lifecycle of a queued decode's shared state; see pendingDecodes.
+  enum { DecodeQueued = 0, DecodeStarted = 1, DecodeCancelled = 2 };
+
   ReactImageLoaderPrivate() {
     provider = new ImageProvider(this);
+    decodedImages.setMaxCost(kDecodedCacheBytes);
+  }
+  // QNetworkDiskCache hands back a QFile on the cache entry; map it so the
+  // decoder reads straight from the page cache instead of copying the file.
+  // The returned array wraps the mapping, which lives until the device is
+  // deleted.
+  static QByteArray readCacheData(QIODevice* idev) {
+    QFile* file = qobject_cast<QFile*>(idev);
+    if (file != nullptr) {
+      uchar* mapped = file->map(0, file->size());
+      if (mapped != nullptr)
+        return QByteArray::fromRawData(reinterpret_cast<const char*>(mapped), file->size());
+    }
+    return idev->readAll();
+  }
+  static QString decodeKey(const QString& id, const QSize& size) {
+    if (size.isEmpty())
+      return id;
+    return id + "/" + QString::number(size.width()) + "x" + QString::number(size.height());
+  }
+  // Scaling during decode avoids ever materialising the full-resolution
+  // bitmap; KeepAspectRatioByExpanding never drops below the target in
+  // either dimension, so "cover" and "contain" fills both stay sharp.
+  static QImage decodeImage(const QByteArray& data, const QSize& targetSize) {
+    QBuffer buffer;
+    buffer.setData(data);
+    buffer.open(QIODevice::ReadOnly);
+    QImageReader reader(&buffer);
+    if (!targetSize.isEmpty()) {
+      const QSize sourceSize = reader.size();
+      if (sourceSize.isValid() &&
+          (sourceSize.width() > targetSize.width() && sourceSize.height() > targetSize.height())) {
+        reader.setScaledSize(sourceSize.scaled(targetSize, Qt::KeepAspectRatioByExpanding));
+      }
+    }
+    return reader.read();
+  }
+  // Runs on the render thread, from SharedTextureFactory::createTexture.
+  // One upload per content key per window; TextureCanUseAtlas lets the
+  // scene graph pack small images (avatars, icons) into its atlas, so they
+  // batch together too. The table holds weak refs: the GL storage lives
+  // exactly as long as some view still shows the content, and deletion is
+  // posted back to the texture's own (render) thread.
+  QSharedPointer<QSGTexture> sharedTexture(const QString& key, const QImage& image, QQuickWindow* window) {
+    QMutexLocker locker(&textureMutex);
+    const QPair<QQuickWindow*, QString> fullKey = qMakePair(window, key);
+    QSharedPointer<QSGTexture> strong = sharedTextures.value(fullKey).toStrongRef();
+    if (strong)
+      return strong;
+
+    for (auto it = sharedTextures.begin(); it != sharedTextures.end();) {
+      it = it->isNull() ? sharedTextures.erase(it) : it + 1;
+    }
+
+    strong = QSharedPointer<QSGTexture>(
+      window->createTextureFromImage(image, QQuickWindow::TextureCanUseAtlas),
+      [](QSGTexture* texture) { texture->deleteLater(); });
+    sharedTextures.insert(fullKey, strong.toWeakRef());
+    return strong;
+  }
+  QImage lookupDecoded(const QString& key) {
+    QMutexLocker locker(&decodeMutex);
+    QImage* image = decodedImages.object(key);
+    ReactCacheCounters* stats = reactCacheCounters("imageloader.decoded");
+    (image != nullptr ? stats->hits : stats->misses)
+      .fetch_add(1, std::memory_order_relaxed);
+    return image != nullptr ? *image : QImage();
+  }
+  void cacheDecoded(const QString& key, const QImage& image) {
+    if (image.isNull())
+      return;
+    QMutexLocker locker(&decodeMutex);
+    // QCache evicts internally; the count delta across the insert is the
+    // only window onto how many entries it pushed out.
+    const int before = decodedImages.count();
+    decodedImages.insert(key, new QImage(image), image.byteCount());
+    reactCacheCounters("imageloader.decoded")->evictions
+      .fetch_add(qMax(0, before + 1 - decodedImages.count()), std::memory_order_relaxed);
   }
   void markCached(const QUrl& source) {
     cacheIds.insert(source, QCryptographicHash::hash(source.toEncoded(), QCryptographicHash::Sha1).toBase64());
   }
   bool isCached(const QUrl& source) {
-    return cacheIds.contains(source);
+    ReactCacheCounters* stats = reactCacheCounters("imageloader.url");
+    if (cacheIds.contains(source)) {
+      stats->hits.fetch_add(1, std::memory_order_relaxed);
+      return true;
+    }
+    // The network disk cache survives relaunch; adopt entries that are still
+    // fresh so cached feed images come up without touching the network.
+    // Expired entries fall through to fetchImage, whose PreferCache request
+    // revalidates against the server with the stored HTTP validators.
+    auto cache = qobject_cast<QNetworkDiskCache*>(bridge->networkAccessManager()->cache());
+    if (cache == nullptr) {
+      stats->misses.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    const QNetworkCacheMetaData metaData = cache->metaData(source);
+    if (!metaData.isValid() ||
+        (metaData.expirationDate().isValid() &&
+         metaData.expirationDate() <= QDateTime::currentDateTime())) {
+      stats->misses.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    markCached(source);
+    stats->hits.fetch_add(1, std::memory_order_relaxed);
+    return true;
   }
   QUrl cachedUrl(const QUrl& source) {
     return QUrl("image://react/" + cacheIds.value(source));
   }
-  void fetchImage(const QUrl& source, const ReactImageLoader::LoadEventCallback& ec) {
+  // Only formats that encode a full-frame approximation early yield useful
+  // partial passes: progressive JPEG and Adam7-interlaced PNG. A truncated
+  // baseline scan decodes top-down and ends in a grey band, which looks
+  // worse than the placeholder it would replace.
+  static bool supportsProgressivePasses(const QByteArray& data) {
+    if (data.size() >= 4 && quint8(data[0]) == 0xff && quint8(data[1]) == 0xd8) {
+      // Walk the JPEG segments looking for a progressive start-of-frame.
+      int pos = 2;
+      while (pos + 4 <= data.size() && quint8(data[pos]) == 0xff) {
+        const quint8 marker = quint8(data[pos + 1]);
+        if (marker == 0xc2)
+          return true;
+        if (marker == 0xc0 || marker == 0xc1 || marker == 0xda)
+          return false; // baseline frame, or entropy-coded data begins
+        pos += 2 + ((quint8(data[pos + 2]) << 8) | quint8(data[pos + 3]));
+      }
+      return false;
+    }
+    if (data.size() >= 29 && data.startsWith("\x89PNG\r\n\x1a\n")) {
+      // Byte 28 is the IHDR interlace method; 1 is Adam7.
+      return data.at(28) == 1;
+    }
+    return false;
+  }
+  static QString progressivePassKey(const QUrl& source, int pass) {
+    // '!' is outside the base64 alphabet the regular cache ids use, so pass
+    // keys can never collide with a disk cache entry.
+    return QString::fromLatin1(
+        QCryptographicHash::hash(source.toEncoded(), QCryptographicHash::Sha1).toBase64())
+      + "!p" + QString::number(pass);
+  }
+  void maybeDecodeProgressive(const QUrl& source, QNetworkReply* reply,
+                              const std::shared_ptr<ProgressiveState>& state,
+                              qint64 bytesReceived, qint64 bytesTotal) {
+    if (state->decodeInFlight || bytesReceived < state->nextAttemptBytes)
+      return;
+    if (bytesTotal > 0 && bytesReceived >= bytesTotal)
+      return; // the finished handler delivers the full image
+    // Nothing reads the reply until it finishes, so a peek sees everything
+    // received so far without consuming it.
+    const QByteArray partial = reply->peek(reply->bytesAvailable());
+    if (!state->checkedFormat && partial.size() >= kProgressiveMinBytes) {
+      state->checkedFormat = true;
+      state->formatSupported = supportsProgressivePasses(partial);
+    }
+    if (!state->formatSupported)
+      return;
+    // Each pass waits for twice the bytes of the previous one, so even a
+    // very slow transfer costs at most a handful of partial decodes.
+    state->nextAttemptBytes = bytesReceived * 2;
+    state->pass += 1;
+    state->decodeInFlight = true;
+    QThreadPool::globalInstance()->start(new ProgressiveDecodeJob(
+      new ProgressivePassReceiver(this, source, state, state->pass), partial));
+  }
+  void publishProgressivePass(const QUrl& source, const QImage& image, int pass) {
+    // The fetch may have finished while the pass decoded; the full image
+    // supersedes anything decoded from a prefix of it.
+    if (image.isNull() || !activeFetches.contains(source))
+      return;
+    const QString key = progressivePassKey(source, pass);
+    cacheDecoded(key, image);
+    // Every pass gets its own provider uri so the view reloads on upgrade.
+    dispatchFetchEvent(source, ReactImageLoader::Event_ProgressiveLoad,
+                       QVariantMap{{"uri", QUrl("image://react/" + key)},
+                                   {"pass", pass}});
+  }
+  void dispatchFetchEvent(const QUrl& source, ReactImageLoader::Event event, const QVariantMap& data) {
+    for (const ReactImageLoader::LoadEventCallback& ec : activeFetches.value(source))
+      ec(event, data);
+  }
+  void fetchImage(const QUrl& source,
+                  const ReactImageLoader::LoadEventCallback& ec,
+                  ReactRequestScheduler::Priority priority) {
     auto data = std::make_shared<QVariantMap>(QVariantMap{});
 
-    // XXX: images downloading already
     if (isCached(source)) {
       // TODO: need to cycle through events?
       ec(ReactImageLoader::Event_LoadStart, *data);
@@ -68,32 +412,107 @@ public:
       return;
     }
 
+    ec(ReactImageLoader::Event_LoadStart, *data);
+
+    // Prefetch promises carry no interest token, so a fetch they ride must
+    // survive every view losing interest in it.
+    if (priority == ReactRequestScheduler::Prefetch)
+      untrackedSubscribers[source] += 1;
+
+    // A second request for a URL already in flight rides the existing fetch
+    // instead of issuing its own GET; every subscriber sees the remaining
+    // events of the one transfer.
+    auto active = activeFetches.find(source);
+    if (active != activeFetches.end()) {
+      active->append(ec);
+      return;
+    }
+    activeFetches.insert(source, QList<ReactImageLoader::LoadEventCallback>{ec});
+
     QNetworkRequest request(source);
+    bridge->prepareRequest(request);
     request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::PreferCache);
-    auto reply = bridge->networkAccessManager()->get(request);
 
-    ec(ReactImageLoader::Event_LoadStart, *data);
+    auto progressive = std::make_shared<ProgressiveState>();
 
-    QObject::connect(reply, &QNetworkReply::downloadProgress, [=](qint64 bytesReceived, qint64 bytesTotal) {
-        data->insert("loaded", bytesReceived);
-        data->insert("total", bytesTotal);
-        ec(ReactImageLoader::Event_Progress, *data);
-      });
-    QObject::connect(reply, static_cast<void(QNetworkReply::*)(QNetworkReply::NetworkError)>(&QNetworkReply::error), [=](QNetworkReply::NetworkError code) {
-        data->insert("error", reply->errorString());
-        ec(ReactImageLoader::Event_Error, *data);
-      });
-    QObject::connect(reply, &QNetworkReply::finished, [=]() {
-        reply->deleteLater();
-        if (reply->error() == QNetworkReply::NoError) {
-          if (!source.isLocalFile())
-            markCached(source);
-          ec(ReactImageLoader::Event_Load, *data);
-        }
-        ec(ReactImageLoader::Event_LoadEnd, *data);
-      });
+    bridge->requestScheduler()->get(request, priority, [=](QNetworkReply* reply) {
+      activeReplies.insert(source, reply);
+      QObject::connect(reply, &QNetworkReply::downloadProgress, [=](qint64 bytesReceived, qint64 bytesTotal) {
+          data->insert("loaded", bytesReceived);
+          data->insert("total", bytesTotal);
+          dispatchFetchEvent(source, ReactImageLoader::Event_Progress, *data);
+          maybeDecodeProgressive(source, reply, progressive, bytesReceived, bytesTotal);
+        });
+      QObject::connect(reply, static_cast<void(QNetworkReply::*)(QNetworkReply::NetworkError)>(&QNetworkReply::error), [=](QNetworkReply::NetworkError code) {
+          data->insert("error", reply->errorString());
+          dispatchFetchEvent(source, ReactImageLoader::Event_Error, *data);
+        });
+      QObject::connect(reply, &QNetworkReply::finished, [=]() {
+          reply->deleteLater();
+          activeReplies.remove(source);
+          untrackedSubscribers.remove(source);
+          const QList<ReactImageLoader::LoadEventCallback> subscribers = activeFetches.take(source);
+          if (reply->error() == QNetworkReply::NoError) {
+            if (!source.isLocalFile())
+              markCached(source);
+            for (const ReactImageLoader::LoadEventCallback& subscriber : subscribers)
+              subscriber(ReactImageLoader::Event_Load, *data);
+          }
+          for (const ReactImageLoader::LoadEventCallback& subscriber : subscribers)
+            subscriber(ReactImageLoader::Event_LoadEnd, *data);
+        });
+    });
+  }
+  // Interest plumbing; GUI thread only, like the fetch tables. A token maps
+  // back to its source, liveInterest counts tokens per source, and
+  // untrackedSubscribers counts fetch riders (prefetch promises) that no
+  // token speaks for.
+  int takeLoadInterest(const QUrl& source) {
+    const int token = nextInterestToken++;
+    interestTokens.insert(token, source);
+    liveInterest[source] += 1;
+    return token;
+  }
+  void releaseLoadInterest(int token) {
+    const QUrl source = interestTokens.take(token);
+    if (source.isEmpty())
+      return;
+    auto it = liveInterest.find(source);
+    if (it == liveInterest.end() || --it.value() > 0)
+      return;
+    liveInterest.erase(it);
+    cancelPendingWork(source);
+  }
+  void cancelPendingWork(const QUrl& source) {
+    ReactCacheCounters* stats = reactCacheCounters("imageloader.cancelled");
+    // Queued decodes dequeue by losing the race for their slot; one that
+    // already started runs to completion. In the counter block, hits are
+    // aborted fetches and misses are dropped decodes.
+    for (const auto& state : pendingDecodes.take(source)) {
+      int expected = DecodeQueued;
+      if (state->compare_exchange_strong(expected, DecodeCancelled))
+        stats->misses.fetch_add(1, std::memory_order_relaxed);
+    }
+    QNetworkReply* reply = activeReplies.value(source);
+    if (reply == nullptr || untrackedSubscribers.value(source) > 0)
+      return;
+    stats->hits.fetch_add(1, std::memory_order_relaxed);
+    // abort() fires the error and finished handlers, so subscribers see the
+    // usual terminal events and the fetch tables clean themselves up.
+    reply->abort();
   }
   QMap<QUrl, QByteArray> cacheIds;
+  QHash<QUrl, QList<ReactImageLoader::LoadEventCallback>> activeFetches;
+  QHash<QUrl, QNetworkReply*> activeReplies;
+  QHash<QUrl, int> untrackedSubscribers;
+  int nextInterestToken = 1;
+  QHash<int, QUrl> interestTokens;
+  QHash<QUrl, int> liveInterest;
+  QHash<QUrl, QList<std::shared_ptr<std::atomic<int>>>> pendingDecodes;
+  QCache<QString, QImage> decodedImages;
+  QHash<QPair<QQuickWindow*, QString>, QWeakPointer<QSGTexture>> sharedTextures;
+  QMutex decodeMutex;
+  QMutex textureMutex;
   ReactBridge* bridge = nullptr;
   ImageProvider* provider = nullptr;
 };
@@ -112,7 +531,7 @@ void ReactImageLoader::prefetchImage(
       else
         resolve(d->bridge, QVariantList{true});
     }
-  });
+  }, ReactRequestScheduler::Prefetch);
 }
 
 
@@ -120,6 +539,24 @@ ReactImageLoader::ReactImageLoader(QObject* parent)
   : QObject(parent)
   , d_ptr(new ReactImageLoaderPrivate)
 {
+  ReactImageLoaderPrivate* p = d_ptr.data();
+  ReactMemoryBudget::instance()->registerClient(
+    "imageloader.decoded", ReactMemoryBudget::Disposable, this,
+    [p] {
+      QMutexLocker locker(&p->decodeMutex);
+      return qint64(p->decodedImages.totalCost());
+    },
+    [p](qint64 target) {
+      QMutexLocker locker(&p->decodeMutex);
+      // Lowering the cap evicts down to the target; restoring it lets the
+      // cache grow back until the next sweep.
+      p->decodedImages.setMaxCost(int(qBound(qint64(1), target, qint64(kDecodedCacheBytes))));
+      p->decodedImages.setMaxCost(kDecodedCacheBytes);
+    });
+  reactCacheByteProbe("imageloader.decoded", [p] {
+      QMutexLocker locker(&p->decodeMutex);
+      return qint64(p->decodedImages.totalCost());
+    });
 }
 
 ReactImageLoader::~ReactImageLoader()
@@ -161,5 +598,36 @@ void ReactImageLoader::loadImage(
   const QUrl& source,
   const LoadEventCallback& loadEventCallback
 ) {
-  d_func()->fetchImage(source, loadEventCallback);
+  d_func()->fetchImage(source, loadEventCallback, ReactRequestScheduler::Normal);
+}
+
+void ReactImageLoader::predecodeImage(const QUrl& source, const QSize& targetSize)
+{
+  Q_D(ReactImageLoader);
+  // The handoff itself costs GUI-thread time - isCached may hit the disk
+  // cache index - so it rides the scheduler's decode class and yields to
+  // layout and input when the frame is already full.
+  d->bridge->scheduler()->schedule(ReactScheduler::DecodeHandoff, [=] {
+    if (!d->isCached(source))
+      return;
+    auto state = std::make_shared<std::atomic<int>>(ReactImageLoaderPrivate::DecodeQueued);
+    auto& queue = d->pendingDecodes[source];
+    // Started (or already cancelled) entries are dead weight; prune them
+    // while we're touching the list on the GUI thread anyway.
+    for (auto it = queue.begin(); it != queue.end();)
+      it = (*it)->load() != ReactImageLoaderPrivate::DecodeQueued ? queue.erase(it) : it + 1;
+    queue.append(state);
+    QThreadPool::globalInstance()->start(
+      new ReactImageLoaderPrivate::DecodeJob(d, source, targetSize, state));
+  });
+}
+
+int ReactImageLoader::takeLoadInterest(const QUrl& source)
+{
+  return d_func()->takeLoadInterest(source);
+}
+
+void ReactImageLoader::releaseLoadInterest(int token)
+{
+  d_func()->releaseLoadInterest(token);
 }
@@ -14,6 +14,7 @@
 #ifndef REACTIMAGELOADER_H
 #define REACTIMAGELOADER_H
 
+#include <QSize>
 #include <QUrl>
 
 #include "reactmoduleinterface.h"
@@ -36,7 +37,11 @@ class ReactImageLoader
   Q_DECLARE_PRIVATE(ReactImageLoader)
 
 public:
-  enum Event { Event_LoadStart, Event_Progress, Event_Error, Event_Load, Event_LoadEnd };
+  // Event_ProgressiveLoad is native-only: it carries a provider uri for a
+  // low-resolution pass decoded from the partial transfer, and the image
+  // manager swaps it in until Event_Load delivers the full image.
+  enum Event { Event_LoadStart, Event_Progress, Event_Error, Event_Load, Event_LoadEnd,
+               Event_ProgressiveLoad };
   typedef std::function<void(Event, const QVariantMap&)> LoadEventCallback;
 
   ReactImageLoader(QObject* parent = 0);
@@ -51,6 +56,21 @@ public:
   QUrl provideUriFromSourceUrl(const QUrl& source);
   void loadImage(const QUrl& source, const LoadEventCallback& ec = LoadEventCallback());
 
+  // Interest tokens tie in-flight work to the views that want it: an image
+  // view takes a token when it points at a source and releases it on unmount
+  // (or when repointed). When the last token for a source is released, and
+  // no tokenless subscriber like prefetchImage is riding the fetch, the
+  // transfer aborts and queued decodes for the source are dropped; fast
+  // scrolling stops downloading and decoding images nobody will see. The
+  // "imageloader.cancelled" stats block counts the cancelled work.
+  int takeLoadInterest(const QUrl& source);
+  void releaseLoadInterest(int token);
+
+  // Decodes a fetched image on the worker pool, scaled down to targetSize,
+  // so the image provider can serve it from the decoded cache instead of
+  // decoding full-resolution data on Qt's single image thread.
+  void predecodeImage(const QUrl& source, const QSize& targetSize);
+
 private:
   QScopedPointer<ReactImageLoaderPrivate> d_ptr;
 };
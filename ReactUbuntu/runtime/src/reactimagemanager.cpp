@@ -24,10 +24,9 @@
 #include "reactattachedproperties.h"
 #include "reactbridge.h"
 #include "reactevents.h"
+#include "reacteventdispatcher.h"
 #include "reactimageloader.h"
 
-int ReactImageManager::m_id = 0;
-
 
 namespace {
 static QMap<ReactImageLoader::Event, QString> eventNames{
@@ -64,6 +63,13 @@ public:
     : ReactPropertyHandler(object)
     , m_bridge(bridge) {
     }
+  ~ImagePropertyHandler() {
+    // Unmount (or recycling, which replaces the handler) revokes this
+    // view's interest: the last view leaving a source aborts its fetch and
+    // drops its queued decodes.
+    if (m_loadToken != 0)
+      m_bridge->imageLoader()->releaseLoadInterest(m_loadToken);
+  }
   QString resizeMode() const;
   void setResizeMode(const QString& resizeMode);
   QString backfaceVisibility() const;
@@ -97,6 +103,7 @@ public:
 private:
   ReactBridge* m_bridge;
   QMap<ReactImageLoader::Event, bool> m_events;
+  int m_loadToken = 0;
 };
 
 QColor ImagePropertyHandler::backgroundColor() const
@@ -148,14 +155,37 @@ QUrl ImagePropertyHandler::source() const
 
 void ImagePropertyHandler::setSource(const QUrl& source)
 {
+  // A re-pointed view no longer wants whatever its previous source still
+  // has in flight.
+  if (m_loadToken != 0)
+    m_bridge->imageLoader()->releaseLoadInterest(m_loadToken);
+  m_loadToken = m_bridge->imageLoader()->takeLoadInterest(source);
   m_bridge->imageLoader()->loadImage(source, [=](ReactImageLoader::Event event, const QVariantMap& data) {
+      if (event == ReactImageLoader::Event_ProgressiveLoad) {
+        // Low-resolution pass decoded from the partial transfer; show it
+        // while the rest of the bytes arrive. Event_Load swaps in the full
+        // image through the regular path below. Not a JS-visible event.
+        m_object->setProperty("source", data.value("uri"));
+        return;
+      }
       if (event == ReactImageLoader::Event_Load) {
+        // By the time the fetch completes flex layout has usually sized the
+        // item; decode ahead at that size so the paint-time request is a
+        // cache hit instead of a full-resolution decode.
+        QQuickItem* item = qobject_cast<QQuickItem*>(m_object);
+        QSize targetSize;
+        if (item != nullptr && item->width() > 0 && item->height() > 0) {
+          targetSize = QSize(item->width(), item->height());
+          m_object->setProperty("sourceSize", targetSize);
+        }
+        m_bridge->imageLoader()->predecodeImage(source, targetSize);
         m_object->setProperty("source", m_bridge->imageLoader()->provideUriFromSourceUrl(source));
       }
       if (m_events[event]) {
         int reactTag = ReactAttachedProperties::get(qobject_cast<QQuickItem*>(m_object))->tag();
-        m_bridge->enqueueJSCall("RCTEventEmitter", "receiveEvent",
-                                QVariantList{reactTag, normalizeInputEventName(eventNames[event]), data});
+        m_bridge->eventDispatcher()->sendViewEvent(reactTag,
+                                                   normalizeInputEventName(eventNames[event]),
+                                                   QVariantList{data});
       }
     });
 }
@@ -310,6 +340,14 @@ QVariantMap ReactImageManager::constantsToExport()
   return QVariantMap{};
 }
 
+void ReactImageManager::prepareForRecycle(QQuickItem* view) const
+{
+  ReactViewManager::prepareForRecycle(view);
+  // The old bitmap must not flash up when the view is reused for a new cell.
+  view->setProperty("source", QUrl());
+  view->setProperty("sourceSize", QSize());
+}
+
 QStringList ReactImageManager::customDirectEventTypes()
 {
   return QStringList{normalizeInputEventName("onLoadStart"),
@@ -326,48 +364,50 @@ import QtGraphicalEffects 1.0
 import React 0.1 as React
 
 React.Item {
-  id: imageRect%1
+  id: imageRect
   backgroundColor: 'transparent'
-  property alias source: image%1.source
-  property alias resizeMode: image%1.fillMode
-  property alias tintColor: colorOverlay%1.color
+  property alias source: image.source
+  property alias resizeMode: image.fillMode
+  property alias tintColor: colorOverlay.color
   onTintColorChanged: {
-    image%1.visible = false
-    colorOverlay%1.visible = true
+    image.visible = false
+    colorOverlay.visible = true
   }
   Image {
-    id: image%1
+    id: image
     visible: true
     anchors.fill: parent
-    layer.enabled: imageRect%1.borderRadius > 0
+    layer.enabled: imageRect.borderRadius > 0
     layer.effect: OpacityMask {
       maskSource: Rectangle {
-        width: image%1.width
-        height: image%1.height
-        radius: imageRect%1.borderRadius
+        width: image.width
+        height: image.height
+        radius: imageRect.borderRadius
       }
     }
   }
   ColorOverlay {
     visible: false
-    anchors.fill: image%1
-    id: colorOverlay%1
-    source: image%1
+    anchors.fill: image
+    id: colorOverlay
+    source: image
   }
 }
 )COMPONENT";
 }
 
-QQuickItem* ReactImageManager::view(const QVariantMap& properties) const
+QByteArray ReactImageManager::componentSource() const
 {
-  QString componentString = QString(component_qml).arg(m_id++);
+  return QByteArray(component_qml);
+}
 
-  QQmlComponent component(m_bridge->qmlEngine());
-  component.setData(componentString.toLocal8Bit(), QUrl());
-  if (!component.isReady())
-    qCritical() << "Component for RCTImageViewManager not ready" << component.errors();
+QQuickItem* ReactImageManager::view(const QVariantMap& properties) const
+{
+  QQmlComponent* component = m_bridge->componentForSource(componentSource());
+  if (!component->isReady())
+    qCritical() << "Component for RCTImageViewManager not ready" << component->errors();
 
-  QQuickItem* item = qobject_cast<QQuickItem*>(component.create());
+  QQuickItem* item = qobject_cast<QQuickItem*>(component->create());
   if (item == nullptr) {
     qCritical() << "Unable to create component for RCTImageViewManager";
     return nullptr;
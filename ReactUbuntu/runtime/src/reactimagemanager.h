@@ -39,12 +39,14 @@ public:
 
   QStringList customDirectEventTypes() override;
 
+  void prepareForRecycle(QQuickItem* view) const override;
+
   QQuickItem* view(const QVariantMap& properties) const override;
 
+  QByteArray componentSource() const override;
+
 private:
   void configureView(QQuickItem* view) const;
-
-  static int m_id;
 };
 
 #endif // REACTIMAGEMANAGER_H
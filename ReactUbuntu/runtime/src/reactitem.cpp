@@ -12,7 +12,11 @@
  */
 
 
-#include <QPainter>
+#include <cmath>
+
+#include <QSGGeometryNode>
+#include <QSGVertexColorMaterial>
+#include <QVector>
 
 #include "reactitem.h"
 #include "reactflexlayout.h"
@@ -37,6 +41,43 @@ QString penStyleToBorderStyle(Qt::PenStyle penStyle)
   case Qt::DashLine: return "dashed";
   }
 }
+
+// Background, border and radii all render through one vertex-colored
+// QSGGeometryNode per item; the renderer can batch styled views into a
+// single draw instead of breaking on a painted texture per item.
+
+// Segments used to approximate a quarter arc of the given radius.
+int arcSegments(double radius)
+{
+  if (radius <= 0)
+    return 1;
+  return qBound(2, int(radius / 3) + 2, 12);
+}
+
+// One sample along the shape outline: the matching points on the outer
+// (item) and inner (inside the border) contours, and which side's border
+// color the following segment takes.
+struct PerimeterPoint
+{
+  QPointF outer;
+  QPointF inner;
+  int side;   // 0 top, 1 right, 2 bottom, 3 left
+};
+
+void setColoredVertex(QSGGeometry::ColoredPoint2D*& vertex,
+                      const QPointF& point,
+                      const QColor& color,
+                      double alphaScale = 1.0)
+{
+  // The vertex color material blends premultiplied.
+  const double alpha = color.alphaF() * alphaScale;
+  vertex->set(point.x(), point.y(),
+              uchar(qRound(color.redF() * alpha * 255)),
+              uchar(qRound(color.greenF() * alpha * 255)),
+              uchar(qRound(color.blueF() * alpha * 255)),
+              uchar(qRound(alpha * 255)));
+  ++vertex;
+}
 }
 
 
@@ -55,39 +96,88 @@ public:
   double borderWidth = 0;
   double borderWidths[4] = { 0, };
   Qt::PenStyle borderStyle = Qt::SolidLine;
-  QRectF outerRects[4];
-  QRectF innerRects[4];
 
   ReactItemPrivate(ReactItem* q)
     : q_ptr(q)
   {
   }
 
-  void calculateCornerRects(const QRectF& otr, const QRectF& inr) {
-    outerRects[0] = QRectF(otr.topLeft(), QSizeF(borderRadiuses[0] * 2, borderRadiuses[0] * 2));
-    outerRects[1] = QRectF(otr.topRight().x() - borderRadiuses[1] * 2, otr.topRight().y(),
-                           borderRadiuses[1] * 2, borderRadiuses[1] * 2);
-    outerRects[2] = QRectF(otr.bottomRight().x() - borderRadiuses[2] * 2,
-                           otr.bottomRight().y() - borderRadiuses[2] * 2,
-                           borderRadiuses[2] * 2, borderRadiuses[2] * 2);
-    outerRects[3] = QRectF(otr.bottomLeft().x(), otr.bottomLeft().y() - borderRadiuses[3] * 2,
-                           borderRadiuses[3] * 2, borderRadiuses[3] * 2);
-
-    innerRects[0] = QRectF(inr.topLeft(),
-                            QSizeF((borderRadiuses[0] - borderWidths[3]) * 2,
-                                    (borderRadiuses[0] - borderWidths[0]) * 2));
-    innerRects[1] = QRectF(inr.topRight().x() - (borderRadiuses[1] - borderWidths[1]) * 2,
-                           inr.topRight().y(),
-                            (borderRadiuses[1] - borderWidths[1]) * 2,
-                            (borderRadiuses[1] - borderWidths[0]) * 2);
-    innerRects[2] = QRectF(inr.bottomRight().x() - (borderRadiuses[2] - borderWidths[1]) * 2,
-                           inr.bottomRight().y() - (borderRadiuses[2] - borderWidths[2]) * 2,
-                           (borderRadiuses[2] - borderWidths[1]) * 2,
-                           (borderRadiuses[2] - borderWidths[2]) * 2);
-    innerRects[3] = QRectF(inr.bottomLeft().x(),
-                           inr.bottomLeft().y() - (borderRadiuses[3] - borderWidths[2]) * 2,
-                           (borderRadiuses[3] - borderWidths[3]) * 2,
-                           (borderRadiuses[3] - borderWidths[2]) * 2);
+  void addCorner(QVector<PerimeterPoint>& points,
+                 const QRectF& area,
+                 const QRectF& inner,
+                 int corner,
+                 double startAngle,
+                 int sideBefore,
+                 int sideAfter) const {
+    const double radius = borderRadiuses[corner];
+
+    QPointF center;
+    double innerX = 0;
+    double innerY = 0;
+    switch (corner) {
+    case 0:
+      center = QPointF(area.left() + radius, area.top() + radius);
+      innerX = borderWidths[3]; innerY = borderWidths[0];
+      break;
+    case 1:
+      center = QPointF(area.right() - radius, area.top() + radius);
+      innerX = borderWidths[1]; innerY = borderWidths[0];
+      break;
+    case 2:
+      center = QPointF(area.right() - radius, area.bottom() - radius);
+      innerX = borderWidths[1]; innerY = borderWidths[2];
+      break;
+    case 3:
+      center = QPointF(area.left() + radius, area.bottom() - radius);
+      innerX = borderWidths[3]; innerY = borderWidths[2];
+      break;
+    }
+
+    if (radius <= 0) {
+      // Sharp corner; duplicated so the border color switches sides cleanly.
+      const QPointF outerCorner(corner == 0 || corner == 3 ? area.left() : area.right(),
+                                corner < 2 ? area.top() : area.bottom());
+      const QPointF innerCorner(corner == 0 || corner == 3 ? inner.left() : inner.right(),
+                                corner < 2 ? inner.top() : inner.bottom());
+      points.push_back(PerimeterPoint{outerCorner, innerCorner, sideBefore});
+      points.push_back(PerimeterPoint{outerCorner, innerCorner, sideAfter});
+      return;
+    }
+
+    const double innerRadiusX = qMax(radius - innerX, 0.0);
+    const double innerRadiusY = qMax(radius - innerY, 0.0);
+    const int half = qMax(1, arcSegments(radius) / 2);
+    for (int pass = 0; pass < 2; ++pass) {
+      const int side = pass == 0 ? sideBefore : sideAfter;
+      const double base = startAngle + pass * M_PI_4;
+      for (int i = 0; i <= half; ++i) {
+        const double angle = base + (M_PI_4 * i) / half;
+        const QPointF direction(std::cos(angle), std::sin(angle));
+        QPointF innerPoint = center + QPointF(innerRadiusX * direction.x(),
+                                              innerRadiusY * direction.y());
+        // A radius smaller than the border width collapses the inner arc
+        // onto the inner rect corner.
+        innerPoint.setX(qBound(inner.left(), innerPoint.x(), inner.right()));
+        innerPoint.setY(qBound(inner.top(), innerPoint.y(), inner.bottom()));
+        points.push_back(PerimeterPoint{center + radius * direction, innerPoint, side});
+      }
+    }
+  }
+
+  // Walks the outline clockwise from the top-left corner; the straight
+  // edges fall out of connecting consecutive corner samples.
+  QVector<PerimeterPoint> buildPerimeter(const QRectF& area) const {
+    QRectF inner = area.adjusted(borderWidths[3], borderWidths[0],
+                                 -borderWidths[1], -borderWidths[2]);
+    if (inner.width() < 0 || inner.height() < 0)
+      inner = QRectF(area.center(), QSizeF(0, 0));
+
+    QVector<PerimeterPoint> points;
+    addCorner(points, area, inner, 0, M_PI, 3, 0);
+    addCorner(points, area, inner, 1, M_PI * 1.5, 0, 1);
+    addCorner(points, area, inner, 2, 0, 1, 2);
+    addCorner(points, area, inner, 3, M_PI_2, 2, 3);
+    return points;
   }
 
   ReactItem* q_ptr;
@@ -437,178 +527,181 @@ void ReactItem::setShadowRadius(double shadowRadius)
 
 
 ReactItem::ReactItem(QQuickItem *parent)
-  : QQuickPaintedItem(parent)
+  : QQuickItem(parent)
   , d_ptr(new ReactItemPrivate(this))
 {
+  setFlag(ItemHasContents, true);
 }
 
 ReactItem::~ReactItem()
 {
 }
 
-void ReactItem::paint(QPainter* painter)
+QSGNode* ReactItem::updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData* data)
 {
   Q_D(ReactItem);
+  Q_UNUSED(data);
 
-  painter->setRenderHint(QPainter::Antialiasing);
-
-  QRectF area(QPointF(0, 0), QSizeF(width(), height()));
-
-  // TODO; support variant widths with variant radii
-  QRectF border = area.adjusted(d->borderWidths[3], d->borderWidths[0],
-                                -d->borderWidths[1], -d->borderWidths[2]);
-
-  if (border != area) {
-    if (d->customBorderWidths || d->customBorderColors || d->customBorderRadius) {
-      if (!d->customBorderColors && !(d->borderRadius > 0 || d->customBorderRadius)) {
-        QPainterPath path;
-        path.addRect(area);
-        path.addRect(border);
-        painter->fillPath(path, d->borderColor);
-        if (d->backgroundColor.isValid() && d->backgroundColor.alpha() != 0) {
-          QPainterPath ap;
-          ap.addRect(area);
-          painter->fillPath(ap.subtracted(path), d->backgroundColor);
-        }
-      } else {
-        d->calculateCornerRects(area, border);
-        QPainterPath path;
-        // TODO: background
-
-        // top
-        if (d->borderRadiuses[0] > 0) {
-          if (!d->innerRects[0].isEmpty()) {
-            path.arcMoveTo(d->innerRects[0], 90);
-            path.arcTo(d->innerRects[0], 90, 45);
-          } else {
-            path.moveTo(border.topLeft());
-          }
-          path.arcTo(d->outerRects[0], -225, -45);
-        } else {
-          path.moveTo(border.topLeft());
-          path.lineTo(area.topLeft());
-        }
-        if (d->borderRadiuses[1] > 0) {
-          path.arcTo(d->outerRects[1], -270, -45);
-          if (!d->innerRects[1].isEmpty()) {
-            path.arcTo(d->innerRects[1], 45, 45);
-          } else {
-            path.lineTo(border.topRight());
-          }
-        } else {
-          path.lineTo(area.topRight());
-          path.lineTo(border.topRight());
-        }
-        path.closeSubpath();
-        painter->fillPath(path, d->borderColors[0]);
-
-        // right
-        path = QPainterPath();
-        if (d->borderRadiuses[1] > 0) {
-          if (!d->innerRects[1].isEmpty()) {
-            path.arcMoveTo(d->innerRects[1], 0);
-            path.arcTo(d->innerRects[1], 0, 45);
-          } else {
-            path.moveTo(border.topRight());
-          }
-          path.arcTo(d->outerRects[1], 45, -45);
-        } else {
-          path.moveTo(border.topRight());
-          path.lineTo(area.topRight());
-        }
-        if (d->borderRadiuses[2] > 0) {
-          path.arcTo(d->outerRects[2], 0, -45);
-          if (!d->innerRects[2].isEmpty()) {
-            path.arcTo(d->innerRects[2], -45, 45);
-          } else {
-            path.lineTo(border.bottomRight());
-          }
-        } else {
-          path.lineTo(area.bottomRight());
-          path.lineTo(border.bottomRight());
-        }
-        path.closeSubpath();
-        painter->fillPath(path, d->borderColors[1]);
-
-        // bottom
-        path = QPainterPath();
-        if (d->borderRadiuses[2] > 0) {
-          if (!d->innerRects[2].isEmpty()) {
-            path.arcMoveTo(d->innerRects[2], -90);
-            path.arcTo(d->innerRects[2], -90, 45);
-          } else {
-            path.moveTo(border.bottomRight());
-          }
-          path.arcTo(d->outerRects[2], -45, -45);
-        } else {
-          path.moveTo(border.bottomRight());
-          path.lineTo(area.bottomRight());
-        }
-        if (d->borderRadiuses[3] > 0) {
-          path.arcTo(d->outerRects[3], -90, -45);
-          if (!d->innerRects[3].isEmpty()) {
-            path.arcTo(d->innerRects[3], -135, -45);
-          } else {
-            path.lineTo(border.bottomLeft());
-          }
-        } else {
-          path.lineTo(area.bottomLeft());
-          path.lineTo(border.bottomLeft());
-        }
-        path.closeSubpath();
-        painter->fillPath(path, d->borderColors[2]);
-
-        // left
-        path = QPainterPath();
-        if (d->borderRadiuses[3] > 0) {
-          if (!d->innerRects[3].isEmpty()) {
-            path.arcMoveTo(d->innerRects[3], -180);
-            path.arcTo(d->innerRects[3], -180, 45);
-          } else {
-            path.moveTo(border.bottomLeft());
-          }
-          path.arcTo(d->outerRects[3], -135, -45);
-        } else {
-          path.moveTo(border.bottomLeft());
-          path.lineTo(area.bottomLeft());
-        }
-        if (d->borderRadiuses[0] > 0) {
-          path.arcTo(d->outerRects[0], -180, -45);
-          if (!d->innerRects[0].isEmpty()) {
-            path.arcTo(d->innerRects[0], -225, 45);
+  const QRectF area(QPointF(0, 0), QSizeF(width(), height()));
+  const bool hasBackground = d->backgroundColor.isValid() && d->backgroundColor.alpha() != 0;
+  bool hasBorder = false;
+  for (int i = 0; i < 4; ++i) {
+    if (d->borderWidths[i] > 0)
+      hasBorder = true;
+  }
+
+  if (area.isEmpty() || (!hasBackground && !hasBorder)) {
+    delete oldNode;
+    return nullptr;
+  }
+
+  auto sideColor = [d](int side) {
+    if (d->borderWidths[side] <= 0)
+      return QColor(0, 0, 0, 0);
+    return d->borderColors[side].isValid() ? d->borderColors[side] : d->borderColor;
+  };
+
+  const QVector<PerimeterPoint> perimeter = d->buildPerimeter(area);
+  const int pointCount = perimeter.size();
+
+  // The border flattens to a list of quads between the contours up front:
+  // solid styles take one quad per perimeter segment, dashed and dotted
+  // styles chop the segments along the dash pattern, and the allocation
+  // below sizes off whatever came out.
+  struct BorderQuad {
+    QPointF i0;
+    QPointF o0;
+    QPointF o1;
+    QPointF i1;
+    QColor color;
+  };
+  QVector<BorderQuad> borderQuads;
+  if (hasBorder) {
+    if (d->borderStyle == Qt::SolidLine) {
+      borderQuads.reserve(pointCount);
+      for (int i = 0; i < pointCount; ++i) {
+        const PerimeterPoint& p0 = perimeter.at(i);
+        const PerimeterPoint& p1 = perimeter.at((i + 1) % pointCount);
+        borderQuads.push_back(BorderQuad{p0.inner, p0.outer, p1.outer, p1.inner,
+                                         sideColor(p0.side)});
+      }
+    } else {
+      // Dash metrics follow the pen styles these map from: dashes run three
+      // times the side's width with one width of gap, dots one and one. The
+      // phase carries around the outline so the pattern continues through
+      // corners instead of restarting on every arc sample.
+      auto lerp = [](const QPointF& a, const QPointF& b, double t) {
+        return a + (b - a) * t;
+      };
+      double phase = 0;
+      for (int i = 0; i < pointCount; ++i) {
+        const PerimeterPoint& p0 = perimeter.at(i);
+        const PerimeterPoint& p1 = perimeter.at((i + 1) % pointCount);
+        const QColor color = sideColor(p0.side);
+        const double sideWidth = qMax(d->borderWidths[p0.side], 1.0);
+        const double on = (d->borderStyle == Qt::DotLine ? 1.0 : 3.0) * sideWidth;
+        const double period = on + sideWidth;
+        const QPointF delta = p1.outer - p0.outer;
+        const double length = std::sqrt(delta.x() * delta.x() + delta.y() * delta.y());
+        if (length <= 0)
+          continue;
+        double s = 0;
+        while (s < length) {
+          const double pos = std::fmod(phase + s, period);
+          if (pos < on) {
+            const double end = qMin(length, s + (on - pos));
+            borderQuads.push_back(BorderQuad{lerp(p0.inner, p1.inner, s / length),
+                                             lerp(p0.outer, p1.outer, s / length),
+                                             lerp(p0.outer, p1.outer, end / length),
+                                             lerp(p0.inner, p1.inner, end / length),
+                                             color});
+            s = end;
           } else {
-            path.lineTo(border.topLeft());
+            s = qMin(length, s + (period - pos));
           }
-        } else {
-          path.lineTo(area.topLeft());
-          path.lineTo(border.topLeft());
         }
-        path.closeSubpath();
-        painter->fillPath(path, d->borderColors[3]);
-      }
-    }
-    else {
-      QPainterPath path;
-      path.addRoundedRect(border, d->borderRadius, d->borderRadius);
-      if (d->backgroundColor.isValid() && d->backgroundColor.alpha() != 0) {
-        painter->fillPath(path, d->backgroundColor);
-      }
-      if (d->borderColor.alpha() != 0) {
-        QPen pen(d->borderStyle);
-        pen.setColor(d->borderColor);
-        pen.setWidthF(d->borderWidth);
-        pen.setJoinStyle(Qt::MiterJoin);
-        painter->setPen(pen);
-        painter->drawPath(path);
+        phase = std::fmod(phase + length, period);
       }
     }
+  }
+
+  // Background fans around the centroid of the inner contour, the border is
+  // a quad per dash-visible segment between the contours, and a one pixel
+  // fringe fades the outer edge to transparent in place of paint time
+  // antialiasing.
+  int vertexCount = pointCount * 6;                   // fringe
+  if (hasBackground)
+    vertexCount += pointCount * 3;
+  vertexCount += borderQuads.size() * 6;
+
+  QSGGeometryNode* node = static_cast<QSGGeometryNode*>(oldNode);
+  QSGGeometry* geometry = nullptr;
+  if (node == nullptr) {
+    node = new QSGGeometryNode;
+    geometry = new QSGGeometry(QSGGeometry::defaultAttributes_ColoredPoint2D(), vertexCount);
+    geometry->setDrawingMode(GL_TRIANGLES);
+    node->setGeometry(geometry);
+    node->setFlag(QSGNode::OwnsGeometry);
+    node->setMaterial(new QSGVertexColorMaterial);
+    node->setFlag(QSGNode::OwnsMaterial);
   } else {
-    if (d->backgroundColor.isValid() && d->backgroundColor.alpha() != 0) {
-      QPainterPath path;
-      path.addRoundedRect(area, d->borderRadius, d->borderRadius);
-      painter->fillPath(path, d->backgroundColor);
+    geometry = node->geometry();
+    geometry->allocate(vertexCount);
+  }
+
+  QPointF centroid;
+  for (const PerimeterPoint& point : perimeter)
+    centroid += point.inner;
+  centroid /= pointCount;
+
+  QSGGeometry::ColoredPoint2D* vertex = geometry->vertexDataAsColoredPoint2D();
+
+  if (hasBackground) {
+    for (int i = 0; i < pointCount; ++i) {
+      const PerimeterPoint& p0 = perimeter.at(i);
+      const PerimeterPoint& p1 = perimeter.at((i + 1) % pointCount);
+      setColoredVertex(vertex, centroid, d->backgroundColor);
+      setColoredVertex(vertex, p0.inner, d->backgroundColor);
+      setColoredVertex(vertex, p1.inner, d->backgroundColor);
     }
   }
+
+  for (const BorderQuad& quad : borderQuads) {
+    setColoredVertex(vertex, quad.i0, quad.color);
+    setColoredVertex(vertex, quad.o0, quad.color);
+    setColoredVertex(vertex, quad.o1, quad.color);
+    setColoredVertex(vertex, quad.i0, quad.color);
+    setColoredVertex(vertex, quad.o1, quad.color);
+    setColoredVertex(vertex, quad.i1, quad.color);
+  }
+
+  auto featherPoint = [centroid](const QPointF& outer) {
+    const QPointF direction = outer - centroid;
+    const double length = std::sqrt(direction.x() * direction.x() +
+                                    direction.y() * direction.y());
+    if (length <= 0)
+      return outer;
+    return outer + direction / length;
+  };
+  for (int i = 0; i < pointCount; ++i) {
+    const PerimeterPoint& p0 = perimeter.at(i);
+    const PerimeterPoint& p1 = perimeter.at((i + 1) % pointCount);
+    // Along a dashed or dotted outline the border color only holds inside
+    // the dashes, so the fringe falls back to the background there too.
+    QColor edgeColor = d->borderStyle == Qt::SolidLine ? sideColor(p0.side)
+                                                       : QColor(0, 0, 0, 0);
+    if (edgeColor.alpha() == 0 && hasBackground)
+      edgeColor = d->backgroundColor;
+    setColoredVertex(vertex, p0.outer, edgeColor);
+    setColoredVertex(vertex, featherPoint(p0.outer), edgeColor, 0);
+    setColoredVertex(vertex, featherPoint(p1.outer), edgeColor, 0);
+    setColoredVertex(vertex, p0.outer, edgeColor);
+    setColoredVertex(vertex, featherPoint(p1.outer), edgeColor, 0);
+    setColoredVertex(vertex, p1.outer, edgeColor);
+  }
+
+  node->markDirty(QSGNode::DirtyGeometry);
+  return node;
 }
 
 void ReactItem::updatePolish()
@@ -14,12 +14,12 @@
 #ifndef REACTITEM_H
 #define REACTITEM_H
 
-#include <QQuickPaintedItem>
+#include <QQuickItem>
 #include <QScopedPointer>
 
 
 class ReactItemPrivate;
-class ReactItem : public QQuickPaintedItem
+class ReactItem : public QQuickItem
 {
   Q_OBJECT
   Q_PROPERTY(QString backfaceVisibility READ backfaceVisibility WRITE setBackfaceVisibility NOTIFY backfaceVisibilityChanged)
@@ -152,7 +152,7 @@ Q_SIGNALS:
   void shadowRadiusChanged();
 
 protected:
-  void paint(QPainter* painter);
+  QSGNode* updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData* data);
   void updatePolish();
 
 private:
@@ -0,0 +1,162 @@
+/**
+ * Copyright (C) 2016, Canonical Ltd.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include <JavaScriptCore/JavaScript.h>
+
+#include <QString>
+#include <QUrl>
+
+#include <QDebug>
+
+#include "reactjscexecutor.h"
+#include "reactjsonvalue.h"
+
+
+namespace {
+struct RegisterClass {
+  RegisterClass() { qRegisterMetaType<ReactJscExecutor*>(); }
+} registerClass;
+
+QString fromJSString(JSStringRef string) {
+  size_t bufferSize = JSStringGetMaximumUTF8CStringSize(string);
+  QByteArray buffer(int(bufferSize), Qt::Uninitialized);
+  size_t written = JSStringGetUTF8CString(string, buffer.data(), bufferSize);
+  return QString::fromUtf8(buffer.constData(), int(written) - 1); // drop the NUL
+}
+}
+
+class ReactJscExecutorPrivate {
+public:
+  JSGlobalContextRef context = nullptr;
+
+  JSValueRef evaluate(const QByteArray& script, const QUrl& sourceUrl, JSValueRef* exception) {
+    JSStringRef source = JSStringCreateWithUTF8CString(script.constData());
+    JSStringRef url = nullptr;
+    if (!sourceUrl.isEmpty())
+      url = JSStringCreateWithUTF8CString(sourceUrl.toString().toUtf8().constData());
+    JSValueRef result = JSEvaluateScript(context, source, nullptr, url, 0, exception);
+    if (url != nullptr)
+      JSStringRelease(url);
+    JSStringRelease(source);
+    return result;
+  }
+
+  QString describeException(JSValueRef exception) {
+    JSStringRef string = JSValueToStringCopy(context, exception, nullptr);
+    if (string == nullptr)
+      return QString("unknown exception");
+    QString description = fromJSString(string);
+    JSStringRelease(string);
+    return description;
+  }
+};
+
+
+ReactJscExecutor::ReactJscExecutor(QObject* parent)
+  : ReactExecutor(parent)
+  , d_ptr(new ReactJscExecutorPrivate)
+{
+}
+
+ReactJscExecutor::~ReactJscExecutor()
+{
+  Q_D(ReactJscExecutor);
+  if (d->context != nullptr)
+    JSGlobalContextRelease(d->context);
+}
+
+void ReactJscExecutor::init()
+{
+  Q_D(ReactJscExecutor);
+  d->context = JSGlobalContextCreate(nullptr);
+}
+
+void ReactJscExecutor::injectJson(const QString& name, const QVariant& data)
+{
+  injectSerializedJson(name, reactStringifyJson(data));
+}
+
+void ReactJscExecutor::injectSerializedJson(const QString& name, const QByteArray& serialized)
+{
+  Q_D(ReactJscExecutor);
+
+  JSStringRef json = JSStringCreateWithUTF8CString(serialized.constData());
+  JSValueRef value = JSValueMakeFromJSONString(d->context, json);
+  JSStringRelease(json);
+
+  JSStringRef propertyName = JSStringCreateWithUTF8CString(name.toUtf8().constData());
+  JSObjectSetProperty(d->context,
+                      JSContextGetGlobalObject(d->context),
+                      propertyName,
+                      value,
+                      kJSPropertyAttributeNone,
+                      nullptr);
+  JSStringRelease(propertyName);
+}
+
+void ReactJscExecutor::executeApplicationScript(const QByteArray& script, const QUrl& sourceUrl)
+{
+  Q_D(ReactJscExecutor);
+
+  JSValueRef exception = nullptr;
+  d->evaluate(script, sourceUrl, &exception);
+  if (exception != nullptr) {
+    qCritical() << __PRETTY_FUNCTION__ << "Exception evaluating application script:"
+                << d->describeException(exception);
+    return;
+  }
+
+  Q_EMIT applicationScriptDone();
+}
+
+void ReactJscExecutor::executeJSCall(
+  const QString& method,
+  const QVariantList& args,
+  const ReactExecutor::ExecuteCallback& callback
+) {
+  Q_D(ReactJscExecutor);
+
+  // Build the same call expression the out-of-process executors send over
+  // the wire, so behaviour is identical minus the round trip.
+  QByteArrayList stringifiedArgs;
+  for (const QVariant& arg : args) {
+    if (arg.type() == QVariant::List || arg.type() == QVariant::Map) {
+      stringifiedArgs += reactStringifyJson(arg);
+    } else {
+      stringifiedArgs += '"' + arg.toString().toLocal8Bit() + '"';
+    }
+  }
+
+  QByteArray script =
+    QByteArray("__fbBatchedBridge.") + method.toLocal8Bit() + "(" + stringifiedArgs.join(',') + ");";
+
+  JSValueRef exception = nullptr;
+  JSValueRef result = d->evaluate(script, QUrl(), &exception);
+  if (exception != nullptr) {
+    qCritical() << __PRETTY_FUNCTION__ << "Exception executing" << method << ":"
+                << d->describeException(exception);
+    if (callback)
+      callback(ReactBridgeValueRef());
+    return;
+  }
+
+  if (!callback)
+    return;
+
+  ReactBridgeValueRef parsed;
+  if (result != nullptr && !JSValueIsUndefined(d->context, result)) {
+    JSStringRef json = JSValueCreateJSONString(d->context, result, 0, nullptr);
+    if (json != nullptr) {
+      parsed = reactParseBridgeJson(fromJSString(json).toUtf8());
+      JSStringRelease(json);
+    }
+  }
+  callback(parsed);
+}
@@ -0,0 +1,41 @@
+/**
+ * Copyright (C) 2016, Canonical Ltd.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#ifndef REACTJSCEXECUTOR_H
+#define REACTJSCEXECUTOR_H
+
+#include "reactexecutor.h"
+
+
+class ReactJscExecutorPrivate;
+class ReactJscExecutor : public ReactExecutor
+{
+  Q_OBJECT
+
+  Q_DECLARE_PRIVATE(ReactJscExecutor)
+
+public:
+  Q_INVOKABLE ReactJscExecutor(QObject* parent = 0);
+  ~ReactJscExecutor();
+
+  void init() override;
+
+  void injectJson(const QString& name, const QVariant& data) override;
+  void injectSerializedJson(const QString& name, const QByteArray& json) override;
+  void executeApplicationScript(const QByteArray& script, const QUrl& sourceUrl) override;
+  void executeJSCall(const QString& method,
+                     const QVariantList& args = QVariantList(),
+                     const ExecuteCallback& callback = ExecuteCallback()) override;
+
+private:
+  QScopedPointer<ReactJscExecutorPrivate> d_ptr;
+};
+
+#endif // REACTJSCEXECUTOR_H
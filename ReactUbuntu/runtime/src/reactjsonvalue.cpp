@@ -0,0 +1,346 @@
+
+/**
+ * Copyright (C) 2016, Canonical Ltd.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ *
+ * Author: Justin McPherson <justin.mcpherson@canonical.com>
+ *
+ */
+
+#include <cmath>
+#include <cstring>
+
+#include "reactjsonvalue.h"
+
+
+namespace {
+
+class JsonReader {
+public:
+  JsonReader(const QByteArray& data)
+    : p(data.constData())
+    , end(p + data.size()) {
+  }
+
+  QVariant parse() {
+    QVariant value = parseValue();
+    if (failed)
+      return QVariant();
+    skipWhitespace();
+    if (p != end)
+      return QVariant(); // trailing garbage
+    return value;
+  }
+
+private:
+  QVariant fail() {
+    failed = true;
+    return QVariant();
+  }
+  void skipWhitespace() {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r'))
+      ++p;
+  }
+  QVariant parseValue() {
+    skipWhitespace();
+    if (p >= end)
+      return fail();
+    switch (*p) {
+    case '{':
+      return parseObject();
+    case '[':
+      return parseArray();
+    case '"':
+      return QVariant(takeString());
+    case 't':
+      if (end - p >= 4 && memcmp(p, "true", 4) == 0) {
+        p += 4;
+        return QVariant(true);
+      }
+      return fail();
+    case 'f':
+      if (end - p >= 5 && memcmp(p, "false", 5) == 0) {
+        p += 5;
+        return QVariant(false);
+      }
+      return fail();
+    case 'n':
+      if (end - p >= 4 && memcmp(p, "null", 4) == 0) {
+        p += 4;
+        return QVariant();
+      }
+      return fail();
+    default:
+      return parseNumber();
+    }
+  }
+  QVariant parseObject() {
+    ++p; // '{'
+    QVariantMap object;
+    skipWhitespace();
+    if (p < end && *p == '}') {
+      ++p;
+      return object;
+    }
+    for (;;) {
+      skipWhitespace();
+      if (p >= end || *p != '"')
+        return fail();
+      QString key = takeString();
+      if (failed)
+        return QVariant();
+      skipWhitespace();
+      if (p >= end || *p != ':')
+        return fail();
+      ++p;
+      QVariant value = parseValue();
+      if (failed)
+        return QVariant();
+      object.insert(key, value);
+      skipWhitespace();
+      if (p < end && *p == ',') {
+        ++p;
+        continue;
+      }
+      if (p < end && *p == '}') {
+        ++p;
+        return object;
+      }
+      return fail();
+    }
+  }
+  QVariant parseArray() {
+    ++p; // '['
+    QVariantList array;
+    skipWhitespace();
+    if (p < end && *p == ']') {
+      ++p;
+      return array;
+    }
+    for (;;) {
+      QVariant value = parseValue();
+      if (failed)
+        return QVariant();
+      array.push_back(value);
+      skipWhitespace();
+      if (p < end && *p == ',') {
+        ++p;
+        continue;
+      }
+      if (p < end && *p == ']') {
+        ++p;
+        return array;
+      }
+      return fail();
+    }
+  }
+  QString takeString() {
+    ++p; // opening quote
+    QString out;
+    const char* spanStart = p;
+    while (p < end) {
+      const char c = *p;
+      if (c == '"') {
+        out += QString::fromUtf8(spanStart, p - spanStart);
+        ++p;
+        return out;
+      }
+      if (c != '\\') {
+        ++p;
+        continue;
+      }
+      out += QString::fromUtf8(spanStart, p - spanStart);
+      ++p;
+      if (p >= end)
+        break;
+      switch (*p) {
+      case '"': out += QLatin1Char('"'); break;
+      case '\\': out += QLatin1Char('\\'); break;
+      case '/': out += QLatin1Char('/'); break;
+      case 'b': out += QLatin1Char('\b'); break;
+      case 'f': out += QLatin1Char('\f'); break;
+      case 'n': out += QLatin1Char('\n'); break;
+      case 'r': out += QLatin1Char('\r'); break;
+      case 't': out += QLatin1Char('\t'); break;
+      case 'u': {
+        if (end - p < 5) {
+          failed = true;
+          return QString();
+        }
+        bool ok = false;
+        const ushort unit = QByteArray(p + 1, 4).toUShort(&ok, 16);
+        if (!ok) {
+          failed = true;
+          return QString();
+        }
+        // Surrogate pairs arrive as two consecutive escapes and recombine
+        // naturally in the UTF-16 string.
+        out += QChar(unit);
+        p += 4;
+        break;
+      }
+      default:
+        failed = true;
+        return QString();
+      }
+      ++p;
+      spanStart = p;
+    }
+    failed = true;
+    return QString();
+  }
+  QVariant parseNumber() {
+    const char* start = p;
+    if (p < end && *p == '-')
+      ++p;
+    bool integral = true;
+    while (p < end) {
+      const char c = *p;
+      if (c >= '0' && c <= '9') {
+        ++p;
+      } else if (c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-') {
+        integral = false;
+        ++p;
+      } else {
+        break;
+      }
+    }
+    if (p == start)
+      return fail();
+    const QByteArray token(start, p - start);
+    if (integral) {
+      bool ok = false;
+      const qlonglong n = token.toLongLong(&ok);
+      if (ok)
+        return QVariant(n);
+    }
+    bool ok = false;
+    const double d = token.toDouble(&ok);
+    if (!ok)
+      return fail();
+    return QVariant(d);
+  }
+
+  const char* p;
+  const char* end;
+  bool failed = false;
+};
+
+void writeValue(const QVariant& value, QByteArray& out);
+
+void writeString(const QString& string, QByteArray& out) {
+  static const char hex[] = "0123456789abcdef";
+  out += '"';
+  const QByteArray utf8 = string.toUtf8();
+  for (const char c : utf8) {
+    switch (c) {
+    case '"': out += "\\\""; break;
+    case '\\': out += "\\\\"; break;
+    case '\b': out += "\\b"; break;
+    case '\f': out += "\\f"; break;
+    case '\n': out += "\\n"; break;
+    case '\r': out += "\\r"; break;
+    case '\t': out += "\\t"; break;
+    default:
+      if (uchar(c) < 0x20) {
+        out += "\\u00";
+        out += hex[(uchar(c) >> 4) & 0xf];
+        out += hex[uchar(c) & 0xf];
+      } else {
+        out += c;
+      }
+    }
+  }
+  out += '"';
+}
+
+void writeList(const QVariantList& list, QByteArray& out) {
+  out += '[';
+  bool first = true;
+  for (const QVariant& value : list) {
+    if (!first)
+      out += ',';
+    first = false;
+    writeValue(value, out);
+  }
+  out += ']';
+}
+
+void writeMap(const QVariantMap& map, QByteArray& out) {
+  out += '{';
+  bool first = true;
+  for (QVariantMap::const_iterator it = map.constBegin(); it != map.constEnd(); ++it) {
+    if (!first)
+      out += ',';
+    first = false;
+    writeString(it.key(), out);
+    out += ':';
+    writeValue(it.value(), out);
+  }
+  out += '}';
+}
+
+void writeValue(const QVariant& value, QByteArray& out) {
+  switch (value.type()) {
+  case QVariant::Invalid:
+    out += "null";
+    break;
+  case QVariant::Bool:
+    out += value.toBool() ? "true" : "false";
+    break;
+  case QVariant::Int:
+  case QVariant::UInt:
+  case QVariant::LongLong:
+    out += QByteArray::number(value.toLongLong());
+    break;
+  case QVariant::ULongLong:
+    out += QByteArray::number(value.toULongLong());
+    break;
+  case QVariant::Double: {
+    const double d = value.toDouble();
+    if (std::isnan(d) || std::isinf(d)) {
+      out += "null"; // JSON has no representation for these
+    } else if (std::abs(d) < 1e15 && d == qint64(d)) {
+      out += QByteArray::number(qint64(d));
+    } else {
+      out += QByteArray::number(d, 'g', 17);
+    }
+    break;
+  }
+  case QVariant::Map:
+  case QVariant::Hash:
+    writeMap(value.toMap(), out);
+    break;
+  case QVariant::List:
+  case QVariant::StringList:
+    writeList(value.toList(), out);
+    break;
+  default:
+    // QUrl, QDateTime and friends serialize through their string form, the
+    // same treatment QJsonValue::fromVariant applied.
+    if (value.canConvert(QMetaType::QString))
+      writeString(value.toString(), out);
+    else
+      out += "null";
+    break;
+  }
+}
+
+}
+
+
+QVariant reactParseJson(const QByteArray& json)
+{
+  return JsonReader(json).parse();
+}
+
+QByteArray reactStringifyJson(const QVariant& value)
+{
+  QByteArray out;
+  writeValue(value, out);
+  return out;
+}
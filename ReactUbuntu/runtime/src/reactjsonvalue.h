@@ -0,0 +1,31 @@
+
+/**
+ * Copyright (C) 2016, Canonical Ltd.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ *
+ * Author: Justin McPherson <justin.mcpherson@canonical.com>
+ *
+ */
+
+#ifndef REACTJSONVALUE_H
+#define REACTJSONVALUE_H
+
+#include <QByteArray>
+#include <QVariant>
+
+// Single pass JSON <-> QVariant codec for bridge traffic. The executor
+// framing decodes wire payloads straight into the QVariant trees that
+// module invocation and value coercion consume, instead of building a
+// QJsonDocument first and converting it a second time; the writer is the
+// inverse for outbound calls.
+
+// Returns an invalid QVariant when the input is not well formed JSON.
+QVariant reactParseJson(const QByteArray& json);
+
+QByteArray reactStringifyJson(const QVariant& value);
+
+#endif // REACTJSONVALUE_H
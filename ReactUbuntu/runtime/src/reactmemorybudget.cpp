@@ -0,0 +1,120 @@
+
+/**
+ * Copyright (C) 2016, Canonical Ltd.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ *
+ * Author: Justin McPherson <justin.mcpherson@canonical.com>
+ *
+ */
+
+#include <QTimer>
+
+#include <QDebug>
+
+#include "reactmemorybudget.h"
+
+
+namespace {
+const qint64 kDefaultBudgetBytes = 128 * 1024 * 1024;
+
+// Slow enough to be free, fast enough that a kiosk session's creep is
+// caught within a minute of starting.
+const int kSweepIntervalMs = 30 * 1000;
+}
+
+ReactMemoryBudget* ReactMemoryBudget::instance()
+{
+  static ReactMemoryBudget* budget = new ReactMemoryBudget;
+  return budget;
+}
+
+ReactMemoryBudget::ReactMemoryBudget()
+  : m_budget(kDefaultBudgetBytes)
+{
+  bool ok = false;
+  const qint64 configured = qgetenv("REACT_MEMORY_BUDGET_MB").toLongLong(&ok);
+  if (ok && configured > 0)
+    m_budget = configured * 1024 * 1024;
+
+  QTimer* sweep = new QTimer(this);
+  connect(sweep, &QTimer::timeout, this, &ReactMemoryBudget::enforce);
+  sweep->start(kSweepIntervalMs);
+}
+
+void ReactMemoryBudget::registerClient(const char* name,
+                                       Priority priority,
+                                       QObject* context,
+                                       const std::function<qint64()>& cost,
+                                       const std::function<void(qint64)>& shrink)
+{
+  m_clients.append(Client{name, priority, context, cost, shrink});
+  connect(context, &QObject::destroyed, this, [=](QObject* object) {
+    for (int i = 0; i < m_clients.size(); ++i) {
+      if (m_clients.at(i).context == object) {
+        m_clients.remove(i);
+        break;
+      }
+    }
+  });
+}
+
+qint64 ReactMemoryBudget::budget() const
+{
+  return m_budget;
+}
+
+qint64 ReactMemoryBudget::totalCost() const
+{
+  qint64 total = 0;
+  for (const Client& client : m_clients)
+    total += client.cost();
+  return total;
+}
+
+void ReactMemoryBudget::enforce()
+{
+  for (Priority level : {Disposable, Retainable}) {
+    const qint64 overage = totalCost() - m_budget;
+    if (overage <= 0)
+      return;
+    shrinkLevel(level, overage);
+  }
+}
+
+void ReactMemoryBudget::shrinkLevel(Priority level, qint64 cut)
+{
+  qint64 levelTotal = 0;
+  for (const Client& client : m_clients) {
+    if (client.priority == level)
+      levelTotal += client.cost();
+  }
+  if (levelTotal <= 0)
+    return;
+
+  cut = qMin(cut, levelTotal);
+  for (const Client& client : m_clients) {
+    if (client.priority != level)
+      continue;
+    // Proportional to the client's share of the level, so the trim lands
+    // on whoever grew instead of always emptying the same cache.
+    const qint64 cost = client.cost();
+    client.shrink(cost - cut * cost / levelTotal);
+  }
+}
+
+void ReactMemoryBudget::handlePressure(PressureLevel level)
+{
+  for (const Client& client : m_clients) {
+    if (client.priority == Critical && level != PressureCritical)
+      continue;
+    const qint64 cost = client.cost();
+    if (level == PressureCritical)
+      client.shrink(client.priority == Critical ? cost / 2 : 0);
+    else
+      client.shrink(cost / 2);
+  }
+}
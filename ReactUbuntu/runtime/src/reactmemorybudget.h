@@ -0,0 +1,80 @@
+/**
+ * Copyright (C) 2016, Canonical Ltd.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ *
+ * Author: Justin McPherson <justin.mcpherson@canonical.com>
+ *
+ */
+
+#ifndef REACTMEMORYBUDGET_H
+#define REACTMEMORYBUDGET_H
+
+#include <functional>
+
+#include <QObject>
+#include <QVector>
+
+// Coordinates the runtime's native caches under one budget. Each cache
+// registers with a cost callback and a shrink callback; a periodic sweep
+// brings the summed cost back under the budget, trimming clients within a
+// priority level proportionally to their share of it, so one hungry cache
+// cannot starve the rest or creep a long-running session toward OOM.
+// The budget defaults to 128MB and is overridable with
+// REACT_MEMORY_BUDGET_MB.
+class ReactMemoryBudget : public QObject
+{
+  Q_OBJECT
+
+public:
+  // Shrink order: Disposable clients give memory back first, Retainable
+  // next; Critical clients are only asked to shrink under critical
+  // pressure.
+  enum Priority { Disposable, Retainable, Critical };
+  enum PressureLevel { PressureModerate, PressureCritical };
+
+  static ReactMemoryBudget* instance();
+
+  // cost reports the client's current byte count; shrink is asked to bring
+  // it down to targetBytes, a hint LRU caches round to entry boundaries.
+  // The registration is dropped when context is destroyed, so per-bridge
+  // caches survive a reload cleanly.
+  void registerClient(const char* name,
+                      Priority priority,
+                      QObject* context,
+                      const std::function<qint64()>& cost,
+                      const std::function<void(qint64 targetBytes)>& shrink);
+
+  qint64 budget() const;
+  qint64 totalCost() const;
+
+  // Brings the summed cost back under the budget; also runs on the sweep
+  // timer.
+  void enforce();
+
+  // Coordinated shrink beyond the budget: moderate halves every
+  // non-critical client, critical empties them and halves Critical clients
+  // as well.
+  void handlePressure(PressureLevel level);
+
+private:
+  ReactMemoryBudget();
+
+  struct Client {
+    const char* name;
+    Priority priority;
+    QObject* context;
+    std::function<qint64()> cost;
+    std::function<void(qint64)> shrink;
+  };
+
+  void shrinkLevel(Priority level, qint64 cut);
+
+  QVector<Client> m_clients;
+  qint64 m_budget;
+};
+
+#endif // REACTMEMORYBUDGET_H
@@ -26,29 +26,43 @@ namespace
 static int nextModuleId = 1;
 // TODO: sort out all the issues around methodsToExport
 
-QList<ReactModuleMethod*> buildMethodList(QObject* moduleImpl)
+void appendMetaMethods(const QMetaObject* metaObject,
+                       const ReactModuleMethod::ObjectFunction& objectFunction,
+                       QList<ReactModuleMethod*>& methods)
 {
-  const QMetaObject* metaObject = moduleImpl->metaObject();
   const int methodCount = metaObject->methodCount();
+  for (int i = metaObject->methodOffset(); i < methodCount; ++i) {
+    QMetaMethod m = metaObject->method(i);
+    if (m.methodType() == QMetaMethod::Method)
+      methods << new ReactModuleMethod(m, objectFunction);
+  }
+}
 
+QList<ReactModuleMethod*> buildMethodList(QObject* moduleImpl)
+{
   QList<ReactModuleMethod*> methods;
 
   // from methodsToExport
   ReactModuleInterface* rmi = qobject_cast<ReactModuleInterface*>(moduleImpl);
   methods = rmi->methodsToExport();
 
-  for (int i = metaObject->methodOffset(); i < methodCount; ++i) {
-    QMetaMethod m = metaObject->method(i);
-    if (m.methodType() == QMetaMethod::Method)
-      methods << new ReactModuleMethod(metaObject->method(i),
-                                       [moduleImpl](QVariantList&) {
-                                         return moduleImpl;
-                                       });
-  }
+  appendMetaMethods(moduleImpl->metaObject(),
+                    [moduleImpl](QVariantList&) {
+                      return moduleImpl;
+                    },
+                    methods);
 
   return methods;
 }
 
+void registerModuleCoercions(QObject* moduleImpl)
+{
+  coerce_map coercions = qobject_cast<ReactModuleInterface*>(moduleImpl)->coercionsToExport();
+  for (auto it = coercions.constBegin(); it != coercions.constEnd(); ++it) {
+    reactRegisterCoercion(it.key(), it.value());
+  }
+}
+
 QVariantMap buildConstantMap(QObject* moduleImpl)
 {
   const QMetaObject* metaObject = moduleImpl->metaObject();
@@ -74,26 +88,84 @@ QVariantMap buildConstantMap(QObject* moduleImpl)
 class ReactModuleDataPrivate
 {
 public:
+  QObject* instance() {
+    if (moduleImpl == nullptr) {
+      moduleImpl = factory();
+      registerModuleCoercions(moduleImpl);
+    }
+    return moduleImpl;
+  }
+
   int id;
-  QObject* moduleImpl;
+  QString name;
+  QObject* moduleImpl = nullptr;
+  ReactModuleData::ModuleFactory factory;
+  QVariantMap constants;
+  QList<ReactModuleMethod*> methods;
+};
+
+struct ReactModuleData::Introspection
+{
   QVariantMap constants;
   QList<ReactModuleMethod*> methods;
+  coerce_map coercions;
 };
 
-ReactModuleData::ReactModuleData(QObject* moduleImpl)
+ReactModuleData::Introspection* ReactModuleData::introspect(QObject* moduleImpl)
+{
+  Introspection* introspection = new Introspection;
+  introspection->constants = buildConstantMap(moduleImpl);
+  introspection->methods = buildMethodList(moduleImpl);
+  introspection->coercions = qobject_cast<ReactModuleInterface*>(moduleImpl)->coercionsToExport();
+  return introspection;
+}
+
+ReactModuleData::ReactModuleData(QObject* moduleImpl, Introspection* introspection)
   : d_ptr(new ReactModuleDataPrivate)
 {
   Q_D(ReactModuleData);
   d->id = nextModuleId++;
   d->moduleImpl = moduleImpl;
-  d->constants = buildConstantMap(moduleImpl);
-  d->methods = buildMethodList(moduleImpl);
+  if (introspection != nullptr) {
+    d->constants = introspection->constants;
+    d->methods = introspection->methods;
+    for (auto it = introspection->coercions.constBegin();
+         it != introspection->coercions.constEnd(); ++it) {
+      reactRegisterCoercion(it.key(), it.value());
+    }
+    delete introspection;
+  } else {
+    d->constants = buildConstantMap(moduleImpl);
+    d->methods = buildMethodList(moduleImpl);
+    registerModuleCoercions(moduleImpl);
+  }
+}
+
+ReactModuleData::ReactModuleData(const QMetaObject& metaObject,
+                                 const QString& name,
+                                 const ModuleFactory& factory)
+  : d_ptr(new ReactModuleDataPrivate)
+{
+  Q_D(ReactModuleData);
+  d->id = nextModuleId++;
+  d->name = name;
+  d->factory = factory;
+
+  // The method table is reflection only; the instance (and its setBridge
+  // side effects) is deferred until one of these methods is first invoked.
+  ReactModuleDataPrivate* p = d;
+  appendMetaMethods(&metaObject,
+                    [p](QVariantList&) {
+                      return p->instance();
+                    },
+                    d->methods);
 }
 
 ReactModuleData::~ReactModuleData()
 {
   Q_D(ReactModuleData);
-  d->moduleImpl->deleteLater();
+  if (d->moduleImpl != nullptr)
+    d->moduleImpl->deleteLater();
 }
 
 int ReactModuleData::id() const
@@ -103,7 +175,10 @@ int ReactModuleData::id() const
 
 QString ReactModuleData::name() const
 {
-  return qobject_cast<ReactModuleInterface*>(d_func()->moduleImpl)->moduleName();
+  Q_D(const ReactModuleData);
+  if (!d->name.isEmpty())
+    return d->name;
+  return qobject_cast<ReactModuleInterface*>(d->moduleImpl)->moduleName();
 }
 
 QVariant ReactModuleData::info() const
@@ -133,7 +208,33 @@ ReactModuleMethod* ReactModuleData::method(int id) const
   return d_func()->methods.value(id);
 }
 
+bool ReactModuleData::invokeWithBridgeValue(ReactBridge* bridge, int methodId, const ReactBridgeValueRef& args)
+{
+  Q_D(ReactModuleData);
+  ReactModuleMethod* method = d->methods.value(methodId);
+  if (method == nullptr)
+    return false;
+  // The call is happening either way, so instantiating a lazy module here is
+  // no earlier than the generic path would.
+  ReactModuleInterface* rmi = qobject_cast<ReactModuleInterface*>(d->instance());
+  if (rmi == nullptr)
+    return false;
+  return rmi->invokeBridgeValueMethod(bridge, method->name(), args);
+}
+
+void ReactModuleData::warmUp()
+{
+  Q_D(ReactModuleData);
+  if (d->moduleImpl == nullptr && d->factory)
+    d->instance();
+}
+
 ReactViewManager* ReactModuleData::viewManager() const
 {
-  return qobject_cast<ReactModuleInterface*>(d_func()->moduleImpl)->viewManager();
+  Q_D(const ReactModuleData);
+  // Lazily registered modules are never view managers; asking through the
+  // factory would defeat the deferral when the UI manager scans all modules.
+  if (d->moduleImpl == nullptr)
+    return nullptr;
+  return qobject_cast<ReactModuleInterface*>(d->moduleImpl)->viewManager();
 }
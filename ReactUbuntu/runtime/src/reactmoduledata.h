@@ -14,9 +14,15 @@
 #ifndef REACTMODULEDATA_H
 #define REACTMODULEDATA_H
 
+#include <functional>
+
 #include <QScopedPointer>
+#include <QString>
 
 class QObject;
+struct QMetaObject;
+class ReactBridge;
+class ReactBridgeValueRef;
 class ReactModuleMethod;
 class ReactViewManager;
 
@@ -27,7 +33,24 @@ class ReactModuleData
   Q_DECLARE_PRIVATE(ReactModuleData)
 
 public:
-  ReactModuleData(QObject* moduleImpl);
+  typedef std::function<QObject*()> ModuleFactory;
+
+  // The thread-safe half of registration: the method table, constants and
+  // coercions scraped from the module's meta-object and export hooks. It can
+  // run on any thread; the constructor consumes it on the bridge thread,
+  // which keeps id assignment and coercion registration sequential.
+  struct Introspection;
+  static Introspection* introspect(QObject* moduleImpl);
+
+  ReactModuleData(QObject* moduleImpl, Introspection* introspection = nullptr);
+  // Registers a module without constructing it: the config exported to JS is
+  // built from the static meta-object and the given name, and the instance
+  // comes from the factory on the first call into the module. Only for
+  // modules with no constants, no custom exported methods and no view
+  // manager.
+  ReactModuleData(const QMetaObject& metaObject,
+                  const QString& name,
+                  const ModuleFactory& factory);
   ~ReactModuleData();
 
   int id() const;
@@ -37,8 +60,18 @@ public:
 
   ReactModuleMethod* method(int id) const;
 
+  // Offers the call to the module's batch-native dispatch (see
+  // ReactModuleInterface::invokeBridgeValueMethod) before the generic
+  // QVariant path; returns whether the module took it.
+  bool invokeWithBridgeValue(ReactBridge* bridge, int methodId, const ReactBridgeValueRef& args);
+
   ReactViewManager* viewManager() const;
 
+  // Constructs the instance of a lazily registered module ahead of its first
+  // method call; no-op when the instance already exists. Used by the idle
+  // warmup pass so the construction cost is not paid mid-interaction.
+  void warmUp();
+
 private:
   QScopedPointer<ReactModuleDataPrivate> d_ptr;
 };
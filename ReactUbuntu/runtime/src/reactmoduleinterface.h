@@ -18,8 +18,11 @@
 
 #include <QtPlugin>
 
+#include "reactvaluecoercion.h"
+
 
 class ReactBridge;
+class ReactBridgeValueRef;
 class ReactViewManager;
 class ReactPropertyHandler;
 class ReactModuleMethod;
@@ -41,10 +44,19 @@ public:
   typedef MapArgumentBlock BubblingEventBlock;
   typedef MapArgumentBlock DirectEventBlock;
 
+  // Where the bridge runs this module's exported methods. Modules default to
+  // the GUI thread; pure I/O modules can opt out so their work never contends
+  // with rendering. WorkerThread shares one background thread between all
+  // modules declaring it; DedicatedThread gets a thread of its own, which
+  // also serializes the module's operations.
+  enum ThreadAffinity { GuiThread, WorkerThread, DedicatedThread };
+
   virtual ~ReactModuleInterface() {}
 
   virtual void setBridge(ReactBridge* bridge) { Q_UNUSED(bridge); }
 
+  virtual ThreadAffinity threadAffinity() const { return GuiThread; }
+
   // TODO: this doesnt seem right
   virtual ReactViewManager* viewManager() { return nullptr; }
   virtual ReactPropertyHandler* propertyHandler(QObject* object) { return nullptr; }
@@ -52,6 +64,23 @@ public:
   virtual QString moduleName() = 0;
   virtual QList<ReactModuleMethod*> methodsToExport() = 0;
   virtual QVariantMap constantsToExport() = 0;
+
+  // Coercions for module-specific argument types; registered into the global
+  // table when the module is added to the bridge.
+  virtual coerce_map coercionsToExport() { return coerce_map{}; }
+
+  // Batch-native dispatch: a module that recognises methodName decodes the
+  // argument list straight from the wire value type, skipping the QVariant
+  // boxing and per-argument coercion of the generic path. Return true when
+  // the call was handled; false falls back to invokeWithBridge. args is the
+  // call's argument array and keeps the batch parse alive for as long as it
+  // is held, so it may be captured across a thread hop.
+  virtual bool invokeBridgeValueMethod(ReactBridge* bridge,
+                                       const QString& methodName,
+                                       const ReactBridgeValueRef& args) {
+    Q_UNUSED(bridge); Q_UNUSED(methodName); Q_UNUSED(args);
+    return false;
+  }
 };
 
 #define ReactModuleInterface_IID "com.canonical.ReactNative.ModuleInterface"
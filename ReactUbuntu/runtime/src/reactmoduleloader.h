@@ -14,14 +14,36 @@
 #ifndef REACTMODULELOADER_H
 #define REACTMODULELOADER_H
 
+#include <functional>
+
 #include <QObject>
 
+// Registers a plugin module from what the plugin compiled in - the moc
+// meta-object is the method descriptor - so the bridge neither constructs
+// nor introspects the module at startup; the factory runs on first call
+// from JS. Only for modules with no constants, no custom exported methods
+// and no view manager (those need an instance; export them through
+// availableModules).
+struct ReactModuleRegistration
+{
+  const QMetaObject* metaObject;
+  QString name;
+  std::function<QObject*()> factory;
+};
+
 class ReactModuleLoader
 {
 public:
   virtual ~ReactModuleLoader() {}
 
   virtual QObjectList availableModules() = 0;
+
+  // Descriptor-based registrations; preferred over availableModules for
+  // modules that qualify.
+  virtual QList<ReactModuleRegistration> moduleRegistrations()
+  {
+    return QList<ReactModuleRegistration>{};
+  }
 };
 
 #define ReactModuleLoader_IID "com.canonical.ReactNative.ModuleLoader"
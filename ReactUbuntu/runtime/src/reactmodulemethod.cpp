@@ -11,11 +11,14 @@
  *
  */
 
+#include <QThread>
+#include <QTimer>
 #include <QVector>
 
 #include <QDebug>
 
 #include "reactmodulemethod.h"
+#include "reacttrace.h"
 #include "reactvaluecoercion.h"
 
 
@@ -23,6 +26,19 @@ ReactModuleMethod::ReactModuleMethod(const QMetaMethod& metaMethod, const Object
   : m_metaMethod(metaMethod)
   , m_objectFunction(objectFunction)
 {
+  compileInvoker();
+}
+
+void ReactModuleMethod::compileInvoker()
+{
+  const int parameterCount = m_metaMethod.parameterCount();
+  m_parameterTypes.reserve(parameterCount);
+  for (int i = 0; i < parameterCount; ++i) {
+    m_parameterTypes.append(m_metaMethod.parameterType(i));
+  }
+  // Slot 0 is the return value; exported methods are all void.
+  m_argv.resize(parameterCount + 1);
+  m_argv[0] = nullptr;
 }
 
 ReactModuleMethod::~ReactModuleMethod()
@@ -40,12 +56,14 @@ QString ReactModuleMethod::type() const
               ? "remoteAsync" : "remote";
 }
 
-// meh
-#define _R_ARG(argn) QGenericArgument(argn.typeName(), argn.data())
-
-// TODO: don't use direct connection
 void ReactModuleMethod::invokeWithBridge(ReactBridge* bridge, const QVariantList& args)
 {
+  // Covers coercion and the direct metacall; an off-thread invocation only
+  // charges the posting here, the metacall runs on the target's thread.
+  if (m_traceName == nullptr)
+    m_traceName = reactTraceInternName(name());
+  ReactTraceSpan span(m_traceName);
+
   QVariantList argsm = args;
   QObject* target = m_objectFunction(argsm);
   if (target == nullptr) {
@@ -55,7 +73,7 @@ void ReactModuleMethod::invokeWithBridge(ReactBridge* bridge, const QVariantList
 
   //qDebug() << __PRETTY_FUNCTION__ << "module" << target << "name" << m_metaMethod.methodSignature();
 
-  const int parameterCount = m_metaMethod.parameterCount();
+  const int parameterCount = m_parameterTypes.size();
 
   if (argsm.size() != parameterCount) {
     qCritical() << "Attempt to invoke" << m_metaMethod.methodSignature() <<
@@ -64,8 +82,9 @@ void ReactModuleMethod::invokeWithBridge(ReactBridge* bridge, const QVariantList
   }
 
   QVariantList pa;
+  pa.reserve(parameterCount);
   for (int i = 0; i < parameterCount; ++i) {
-    pa << reactCoerceValue(argsm.at(i), m_metaMethod.parameterType(i));
+    pa << reactCoerceValue(argsm.at(i), m_parameterTypes.at(i));
     if (!pa.last().isValid()) {
       qCritical() << "Could not convert argument" << i << "for" <<
         m_metaMethod.methodSignature() << "from" << argsm.at(i).typeName();
@@ -73,42 +92,33 @@ void ReactModuleMethod::invokeWithBridge(ReactBridge* bridge, const QVariantList
     }
   }
 
-  switch (argsm.size()) {
-  case 0:
-    m_metaMethod.invoke(target, Qt::DirectConnection);
-    break;
-  case 1:
-    m_metaMethod.invoke(target, Qt::DirectConnection, _R_ARG(pa.at(0)));
-    break;
-  case 2:
-    m_metaMethod.invoke(target, Qt::DirectConnection,
-                        _R_ARG(pa.at(0)), _R_ARG(pa.at(1)));
-    break;
-  case 3:
-    m_metaMethod.invoke(target, Qt::DirectConnection,
-                        _R_ARG(pa.at(0)), _R_ARG(pa.at(1)), _R_ARG(pa.at(2)));
-    break;
-  case 4:
-    m_metaMethod.invoke(target, Qt::DirectConnection,
-                        _R_ARG(pa.at(0)), _R_ARG(pa.at(1)), _R_ARG(pa.at(2)), _R_ARG(pa.at(3)));
-    break;
-  case 5:
-    m_metaMethod.invoke(target, Qt::DirectConnection,
-                        _R_ARG(pa.at(0)), _R_ARG(pa.at(1)), _R_ARG(pa.at(2)), _R_ARG(pa.at(3)), _R_ARG(pa.at(4)));
-    break;
-  case 6:
-    m_metaMethod.invoke(target, Qt::DirectConnection,
-                        _R_ARG(pa.at(0)), _R_ARG(pa.at(1)), _R_ARG(pa.at(2)), _R_ARG(pa.at(3)), _R_ARG(pa.at(4)),
-                        _R_ARG(pa.at(5)));
-    break;
-  case 7:
-    m_metaMethod.invoke(target, Qt::DirectConnection,
-                        _R_ARG(pa.at(0)), _R_ARG(pa.at(1)), _R_ARG(pa.at(2)), _R_ARG(pa.at(3)), _R_ARG(pa.at(4)),
-                        _R_ARG(pa.at(5)), _R_ARG(pa.at(6)));
-  case 8:
-    m_metaMethod.invoke(target, Qt::DirectConnection,
-                        _R_ARG(pa.at(0)), _R_ARG(pa.at(1)), _R_ARG(pa.at(2)), _R_ARG(pa.at(3)), _R_ARG(pa.at(4)),
-                        _R_ARG(pa.at(5)), _R_ARG(pa.at(6)), _R_ARG(pa.at(7)));
-    break;
+  // Modules can declare off-GUI thread affinity; respect it by running the
+  // metacall over on the target's thread, with the coerced arguments going
+  // along by value.
+  if (target->thread() != QThread::currentThread()) {
+    const QMetaMethod metaMethod = m_metaMethod;
+    const QVector<int> parameterTypes = m_parameterTypes;
+    QTimer::singleShot(0, target, [target, metaMethod, parameterTypes, pa]() {
+      QVariantList arguments = pa;
+      QVector<void*> argv(parameterTypes.size() + 1);
+      argv[0] = nullptr;
+      for (int i = 0; i < parameterTypes.size(); ++i) {
+        argv[i + 1] = parameterTypes.at(i) == QMetaType::QVariant
+                          ? (void*)&arguments[i] : arguments[i].data();
+      }
+      QMetaObject::metacall(target, QMetaObject::InvokeMetaMethod,
+                            metaMethod.methodIndex(), argv.data());
+    });
+    return;
+  }
+
+  // The coerced variants hold exactly the resolved parameter types, so the
+  // metacall vector can point straight at their payloads; this skips the
+  // signature re-matching QMetaMethod::invoke does on every call.
+  for (int i = 0; i < parameterCount; ++i) {
+    m_argv[i + 1] = m_parameterTypes.at(i) == QMetaType::QVariant
+                        ? (void*)&pa[i] : pa[i].data();
   }
+  QMetaObject::metacall(target, QMetaObject::InvokeMetaMethod,
+                        m_metaMethod.methodIndex(), m_argv.data());
 }
@@ -18,6 +18,7 @@
 
 #include <QPointer>
 #include <QMetaMethod>
+#include <QVector>
 
 
 class ReactBridge;
@@ -37,8 +38,18 @@ public:
   void invokeWithBridge(ReactBridge* bridge, const QVariantList& args);
 
 private:
+  void compileInvoker();
+
   ObjectFunction m_objectFunction;
   QMetaMethod m_metaMethod;
+
+  // Resolved once at registration so invocation is a typed copy loop plus a
+  // direct metacall instead of per-call type lookups.
+  QVector<int> m_parameterTypes;
+  QVector<void*> m_argv;
+
+  // Interned span name for tracing, resolved on first invocation.
+  const char* m_traceName = nullptr;
 };
 
 
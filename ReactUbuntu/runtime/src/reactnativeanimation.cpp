@@ -0,0 +1,255 @@
+
+/**
+ * Copyright (C) 2016, Canonical Ltd.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ *
+ * Author: Justin McPherson <justin.mcpherson@canonical.com>
+ *
+ */
+
+#include <cmath>
+
+#include <QDebug>
+#include <QQuickItem>
+
+#include "reactnativeanimation.h"
+#include "reactbridge.h"
+#include "reactscheduler.h"
+#include "reactuimanager.h"
+
+
+namespace
+{
+QEasingCurve easingFromName(const QString& name)
+{
+  if (name == QLatin1String("linear"))
+    return QEasingCurve(QEasingCurve::Linear);
+  if (name == QLatin1String("ease-in"))
+    return QEasingCurve(QEasingCurve::InCubic);
+  if (name == QLatin1String("ease-out"))
+    return QEasingCurve(QEasingCurve::OutCubic);
+  return QEasingCurve(QEasingCurve::InOutCubic);
+}
+
+// Springs settle rather than end; below these thresholds the remaining
+// motion is under a visible pixel and the value snaps to its target.
+const double springRestDisplacement = 0.005;
+const double springRestVelocity = 0.005;
+}
+
+
+ReactNativeAnimation::ReactNativeAnimation(QObject* parent)
+  : QObject(parent)
+{
+  m_clock.start();
+}
+
+ReactNativeAnimation::~ReactNativeAnimation()
+{
+}
+
+void ReactNativeAnimation::setBridge(ReactBridge* bridge)
+{
+  m_bridge = bridge;
+}
+
+ReactViewManager* ReactNativeAnimation::viewManager()
+{
+  return nullptr;
+}
+
+QString ReactNativeAnimation::moduleName()
+{
+  return "RCTNativeAnimation";
+}
+
+QList<ReactModuleMethod*> ReactNativeAnimation::methodsToExport()
+{
+  return QList<ReactModuleMethod*>{};
+}
+
+QVariantMap ReactNativeAnimation::constantsToExport()
+{
+  return QVariantMap{};
+}
+
+void ReactNativeAnimation::startAnimation
+(
+  int animationId,
+  int reactTag,
+  const QVariantMap& config,
+  const ReactModuleInterface::ListArgumentBlock& onComplete
+)
+{
+  QQuickItem* item = m_bridge->uiManager()->viewForTag(reactTag);
+  if (item == nullptr) {
+    qWarning() << __PRETTY_FUNCTION__ << "Attempting to animate unknown view" << reactTag;
+    onComplete(m_bridge, QVariantList{QVariantMap{{"finished", false}}});
+    return;
+  }
+
+  // Restarting an id supersedes the old run, like a JS-driven restart would.
+  finishAnimation(animationId, false);
+
+  Animation animation;
+  animation.target = item;
+  animation.onComplete = onComplete;
+
+  const QString property = config.value("property").toString();
+  double currentValue = 0;
+  if (property == QLatin1String("translateX")) {
+    animation.property = TranslateX;
+    animation.baseX = item->x();
+  } else if (property == QLatin1String("translateY")) {
+    animation.property = TranslateY;
+    animation.baseY = item->y();
+  } else if (property == QLatin1String("scale")) {
+    animation.property = Scale;
+    currentValue = item->scale();
+  } else if (property == QLatin1String("rotation")) {
+    animation.property = Rotation;
+    currentValue = item->rotation();
+  } else if (property == QLatin1String("opacity")) {
+    animation.property = Opacity;
+    currentValue = item->opacity();
+  } else {
+    qWarning() << __PRETTY_FUNCTION__ << "Cannot animate property" << property;
+    onComplete(m_bridge, QVariantList{QVariantMap{{"finished", false}}});
+    return;
+  }
+
+  animation.fromValue = config.value("fromValue", currentValue).toDouble();
+  animation.toValue = config.value("toValue").toDouble();
+
+  if (config.value("type").toString() == QLatin1String("spring")) {
+    animation.spring = true;
+    animation.stiffness = config.value("stiffness", 100).toDouble();
+    animation.damping = config.value("damping", 10).toDouble();
+    animation.mass = config.value("mass", 1).toDouble();
+    animation.position = animation.fromValue;
+    animation.velocity = config.value("initialVelocity", 0).toDouble();
+  } else {
+    animation.durationMs = config.value("duration", 250).toDouble();
+    animation.easing = easingFromName(config.value("easing").toString());
+  }
+
+  animation.startMs = m_clock.elapsed();
+  m_animations.insert(animationId, animation);
+  if (!m_tickScheduled) {
+    // Coming out of idle; the gap since the last animated frame is not an
+    // integration step.
+    m_lastTickMs = animation.startMs;
+  }
+  scheduleTick();
+}
+
+void ReactNativeAnimation::stopAnimation(int animationId)
+{
+  finishAnimation(animationId, false);
+}
+
+void ReactNativeAnimation::applyValue(const Animation& animation, double value)
+{
+  QQuickItem* item = animation.target.data();
+  switch (animation.property) {
+  case Opacity:
+    item->setOpacity(value);
+    break;
+  // Translations write the position directly, offset from where layout put
+  // the item; a layout pass during the animation rebases on the next start,
+  // which matches how JS-driven position animations behaved.
+  case TranslateX:
+    item->setX(animation.baseX + value);
+    break;
+  case TranslateY:
+    item->setY(animation.baseY + value);
+    break;
+  case Scale:
+    item->setScale(value);
+    break;
+  case Rotation:
+    item->setRotation(value);
+    break;
+  }
+}
+
+void ReactNativeAnimation::finishAnimation(int animationId, bool finished)
+{
+  QMap<int, Animation>::iterator it = m_animations.find(animationId);
+  if (it == m_animations.end())
+    return;
+
+  const ReactModuleInterface::ListArgumentBlock onComplete = it->onComplete;
+  m_animations.erase(it);
+  onComplete(m_bridge, QVariantList{QVariantMap{{"finished", finished}}});
+}
+
+void ReactNativeAnimation::scheduleTick()
+{
+  if (m_tickScheduled || m_animations.isEmpty())
+    return;
+  m_tickScheduled = true;
+  // Layout-apply class: property writes must land every frame regardless of
+  // remaining budget, or the animation visibly stutters.
+  m_bridge->scheduler()->schedule(ReactScheduler::LayoutApply, [this] { tick(); });
+}
+
+void ReactNativeAnimation::tick()
+{
+  m_tickScheduled = false;
+
+  const qint64 now = m_clock.elapsed();
+  // Integration step for springs; capped so a stalled frame advances the
+  // simulation without overshooting into instability.
+  const double dt = qMin(now - m_lastTickMs, qint64(64)) / 1000.0;
+  m_lastTickMs = now;
+
+  QList<int> completed;
+  for (QMap<int, Animation>::iterator it = m_animations.begin();
+       it != m_animations.end(); ++it) {
+    Animation& animation = it.value();
+    if (animation.target.isNull()) {
+      completed.append(it.key());
+      continue;
+    }
+
+    double value = 0;
+    bool done = false;
+    if (animation.spring) {
+      const double acceleration =
+        (-animation.stiffness * (animation.position - animation.toValue) -
+         animation.damping * animation.velocity) / animation.mass;
+      animation.velocity += acceleration * dt;
+      animation.position += animation.velocity * dt;
+      value = animation.position;
+      done = std::fabs(animation.velocity) < springRestVelocity &&
+             std::fabs(animation.position - animation.toValue) < springRestDisplacement;
+      if (done)
+        value = animation.toValue;
+    } else {
+      double progress = animation.durationMs > 0
+        ? (now - animation.startMs) / animation.durationMs : 1.0;
+      if (progress >= 1.0) {
+        progress = 1.0;
+        done = true;
+      }
+      value = animation.fromValue +
+        (animation.toValue - animation.fromValue) * animation.easing.valueForProgress(progress);
+    }
+
+    applyValue(animation, value);
+    if (done)
+      completed.append(it.key());
+  }
+
+  for (int animationId : completed) {
+    // A dropped target never reached its end value.
+    finishAnimation(animationId, !m_animations[animationId].target.isNull());
+  }
+
+  scheduleTick();
+}
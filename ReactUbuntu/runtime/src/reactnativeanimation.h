@@ -0,0 +1,103 @@
+
+/**
+ * Copyright (C) 2016, Canonical Ltd.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ *
+ * Author: Justin McPherson <justin.mcpherson@canonical.com>
+ *
+ */
+
+#ifndef REACTNATIVEANIMATION_H
+#define REACTNATIVEANIMATION_H
+
+#include <QEasingCurve>
+#include <QElapsedTimer>
+#include <QMap>
+#include <QPointer>
+#include <QVariant>
+#include <QObject>
+
+#include "reactmoduleinterface.h"
+
+class QQuickItem;
+class ReactBridge;
+
+// Drives declared animations natively: JS sends the curve once, the module
+// interpolates on the frame scheduler and writes QQuickItem properties
+// directly, and JS hears back once on completion. The per-frame path costs
+// no executor round trip and no property coercion, unlike animating through
+// updateView.
+class ReactNativeAnimation
+  : public QObject
+  , public ReactModuleInterface
+{
+  Q_OBJECT
+  Q_INTERFACES(ReactModuleInterface)
+
+  // config: { "type": "timing"|"spring",
+  //           "property": "opacity"|"translateX"|"translateY"|"scale"|"rotation",
+  //           "toValue", optional "fromValue" (defaults to the current value),
+  //           timing: "duration" ms, "easing" name,
+  //           spring: "stiffness", "damping", "mass", "initialVelocity" }
+  // onComplete fires exactly once with {finished: bool}; false when the
+  // animation was stopped, replaced, or its view went away.
+  Q_INVOKABLE void startAnimation(int animationId,
+                                  int reactTag,
+                                  const QVariantMap& config,
+                                  const ReactModuleInterface::ListArgumentBlock& onComplete);
+  Q_INVOKABLE void stopAnimation(int animationId);
+
+public:
+  ReactNativeAnimation(QObject* parent = 0);
+  ~ReactNativeAnimation();
+
+  void setBridge(ReactBridge* bridge) override;
+
+  ReactViewManager* viewManager() override;
+
+  QString moduleName() override;
+  QList<ReactModuleMethod*> methodsToExport() override;
+  QVariantMap constantsToExport() override;
+
+private:
+  enum AnimatedProperty { Opacity, TranslateX, TranslateY, Scale, Rotation };
+
+  struct Animation {
+    QPointer<QQuickItem> target;
+    AnimatedProperty property = Opacity;
+    bool spring = false;
+    double fromValue = 0;
+    double toValue = 0;
+    // timing
+    double durationMs = 0;
+    QEasingCurve easing;
+    // spring state, integrated per frame
+    double stiffness = 0;
+    double damping = 0;
+    double mass = 1;
+    double position = 0;
+    double velocity = 0;
+    // translations offset the item's layout position
+    double baseX = 0;
+    double baseY = 0;
+    qint64 startMs = 0;
+    ReactModuleInterface::ListArgumentBlock onComplete;
+  };
+
+  void applyValue(const Animation& animation, double value);
+  void finishAnimation(int animationId, bool finished);
+  void scheduleTick();
+  void tick();
+
+  QPointer<ReactBridge> m_bridge;
+  QMap<int, Animation> m_animations;
+  QElapsedTimer m_clock;
+  qint64 m_lastTickMs = 0;
+  bool m_tickScheduled = false;
+};
+
+#endif // REACTNATIVEANIMATION_H
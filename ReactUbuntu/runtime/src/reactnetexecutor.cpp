@@ -13,21 +13,220 @@
 
 #include <QString>
 #include <QUrl>
+#include <QHash>
+#include <QMap>
 #include <QQueue>
 #include <QObject>
 #include <QTcpSocket>
-#include <QJsonDocument>
 #include <QStateMachine>
+#include <QTimer>
+#include <QUuid>
 
 #include <QDebug>
 
 #include "reactnetexecutor.h"
+#include "reactjsonvalue.h"
+#include "reactreplayexecutor.h"
+#include "reacttrace.h"
 
 
 namespace {
 struct RegisterClass {
   RegisterClass() { qRegisterMetaType<ReactNetExecutor*>(); }
 } registerClass;
+
+// Protocol 3 frames the application bundle as a run of segments; a set high
+// bit in the request id marks "more segments follow" and the final segment
+// carries the plain id the server replies to once evaluation finishes.
+const quint32 segmentContinues = 0x80000000;
+const int segmentBytes = 64 * 1024;
+// Stop queueing segments into the socket once this much is still unsent;
+// bytesWritten resumes the stream. This is what lets the server parse early
+// segments while later ones are in flight without us buffering the whole
+// bundle in the kernel.
+const qint64 sendWindowBytes = 256 * 1024;
+
+// Protocol 4 adds session resume. Request id 0 is reserved for the
+// handshake: the client opens every connection with "SESSION <token>" and
+// the server answers RESUMED when it still holds that session's VM, or NEW.
+// The client journals every request until its reply arrives; on RESUMED it
+// re-sends only the journal, and the server is expected to skip evaluation
+// of ids it already executed and resend their cached replies. A transient
+// blip therefore costs one round trip instead of a bundle re-transfer and
+// config re-injection. On NEW after the bundle was sent the session is
+// unrecoverable and the executor goes dead as before.
+const quint32 helloRequestId = 0;
+const int reconnectBaseDelayMs = 500;
+const int reconnectMaxDelayMs = 5 * 1000;
+const int reconnectMaxAttempts = 20;
+
+// Protocol 5 negotiates transparent frame compression in both directions: a
+// body at or above the threshold travels deflated (qCompress framing, i.e.
+// an uncompressed-size prefix followed by a zlib stream) with the high bit
+// of the length word set. Batch JSON is dominated by repeated module,
+// method and property names, so large frames shrink severalfold; below the
+// threshold the deflate overhead outweighs the wire time saved.
+const quint32 frameCompressed = 0x80000000;
+const int compressMinBytes = 4 * 1024;
+
+// Reply frames at least this large parse incrementally as their bytes
+// arrive (StreamingBatchParser below); smaller ones are not worth the
+// bookkeeping and compressed ones cannot be scanned until inflated.
+const int streamParseMinBytes = 64 * 1024;
+
+// Streaming parse for large reply frames, protocol independent. A
+// multi-megabyte batch (the initial UI hierarchy delivery) used to sit in
+// the input buffer untouched until its last byte and only then parse as one
+// tree, holding raw bytes and the whole parsed tree at once and serializing
+// network time before parse and dispatch time. The batch layout
+// ([moduleIds, methodIds, paramArrays, callId?]) puts the small id columns
+// first, so once those are in, every paramArrays entry that completes can
+// be respliced into a single-call batch and handed to the bridge while the
+// rest of the frame is still on the wire. Each mini batch parses into its
+// own arena and drops after dispatch, so the full tree never materializes;
+// the raw frame stays buffered as before (replay capture and resume
+// journaling want the whole body). The trailing callId arrives after the
+// params and is not respliced; the Qt dispatch path ignores it.
+//
+// Anything that is not batch shaped emits nothing and the frame falls back
+// to the buffered parse at completion. A batch that goes malformed after
+// entries have gone out stops early, matching forEachMethodCall's
+// stop-on-error semantics.
+class StreamingBatchParser {
+public:
+  std::function<void(const ReactBridgeValueRef&)> onEntry;
+
+  void reset() {
+    m_pos = 0;
+    m_depth = 0;
+    m_topElement = -1;
+    m_topStart = 0;
+    m_entryStart = 0;
+    m_entryIndex = 0;
+    m_emitted = 0;
+    m_inString = false;
+    m_escaped = false;
+    m_started = false;
+    m_failed = false;
+    m_moduleIds.clear();
+    m_methodIds.clear();
+  }
+
+  int emitted() const { return m_emitted; }
+
+  // Continues the scan over the same, longer buffer; positions are offsets,
+  // so appends that reallocate the buffer are fine.
+  void consume(const QByteArray& buffer) {
+    if (m_failed)
+      return;
+    const char* data = buffer.constData();
+    const int size = buffer.size();
+    while (m_pos < size) {
+      const char c = data[m_pos];
+      if (!m_started) {
+        if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+          ++m_pos;
+          continue;
+        }
+        if (c != '[') {
+          m_failed = true;  // not a batch; the buffered path sorts it out
+          return;
+        }
+        m_started = true;
+        m_depth = 1;
+        ++m_pos;
+        continue;
+      }
+      if (m_inString) {
+        if (m_escaped)
+          m_escaped = false;
+        else if (c == '\\')
+          m_escaped = true;
+        else if (c == '"')
+          m_inString = false;
+      } else if (c == '"') {
+        m_inString = true;
+      } else if (c == '[' || c == '{') {
+        if (m_depth == 1) {
+          ++m_topElement;
+          m_topStart = m_pos;
+        } else if (m_depth == 2 && m_topElement == 2) {
+          m_entryStart = m_pos;
+        }
+        ++m_depth;
+      } else if (c == ']' || c == '}') {
+        --m_depth;
+        if (m_depth == 1) {
+          completedTopElement(data);
+        } else if (m_depth == 2 && m_topElement == 2) {
+          completedEntry(data);
+        } else if (m_depth == 0) {
+          return;  // end of the batch; trailing bytes are the frame's business
+        }
+        if (m_failed)
+          return;
+      }
+      ++m_pos;
+    }
+  }
+
+private:
+  void completedTopElement(const char* data) {
+    if (m_topElement > 1)
+      return;  // params emit per entry; a scalar callId never gets here
+    const QByteArray slice =
+      QByteArray::fromRawData(data + m_topStart, m_pos - m_topStart + 1);
+    const QVariantList ids = reactParseJson(slice).toList();
+    if (ids.isEmpty()) {
+      m_failed = true;
+      return;
+    }
+    (m_topElement == 0 ? m_moduleIds : m_methodIds) = ids;
+  }
+
+  void completedEntry(const char* data) {
+    if (m_entryIndex >= m_moduleIds.size() || m_entryIndex >= m_methodIds.size()) {
+      qCritical() << "Streamed batch carries more params than ids; stopping early";
+      m_failed = true;
+      return;
+    }
+    const int length = m_pos - m_entryStart + 1;
+    QByteArray mini;
+    mini.reserve(length + 24);
+    mini += "[[";
+    mini += QByteArray::number(m_moduleIds.at(m_entryIndex).toInt());
+    mini += "],[";
+    mini += QByteArray::number(m_methodIds.at(m_entryIndex).toInt());
+    mini += "],[";
+    mini.append(data + m_entryStart, length);
+    mini += "]]";
+    ++m_entryIndex;
+
+    const ReactBridgeValueRef entry = reactParseBridgeJson(mini);
+    if (!entry.isValid()) {
+      qCritical() << "Streamed batch entry failed to parse; stopping early";
+      m_failed = true;
+      return;
+    }
+    ++m_emitted;
+    if (onEntry)
+      onEntry(entry);
+  }
+
+  int m_pos = 0;
+  int m_depth = 0;
+  int m_topElement = -1;
+  int m_topStart = 0;
+  int m_entryStart = 0;
+  int m_entryIndex = 0;
+  int m_emitted = 0;
+  bool m_inString = false;
+  bool m_escaped = false;
+  bool m_started = false;
+  bool m_failed = false;
+  QVariantList m_moduleIds;
+  QVariantList m_methodIds;
+};
 }
 
 class ReactNetExecutorPrivate : public QObject {
@@ -37,44 +236,363 @@ public:
   QTcpSocket* socket = nullptr;
   QStateMachine* machina = nullptr;
   QByteArray inputBuffer;
-  QQueue<QByteArray> requestQueue;
+  // Requests queue as chunk lists and the chunks go to the socket one by
+  // one behind a summed length header; implicit sharing keeps the large
+  // chunks (bundle, batch payloads, module config) aliased to the buffers
+  // the bridge built instead of joined into fresh allocations.
+  QQueue<QByteArrayList> requestQueue;
   QQueue<ReactExecutor::ExecuteCallback> responseQueue;
 
+  static quint32 chunksLength(const QByteArrayList& chunks) {
+    quint32 length = 0;
+    for (const QByteArray& chunk : chunks)
+      length += chunk.size();
+    return length;
+  }
+
+  // Puts one frame on the wire: the length word (plus the request id when
+  // the framing carries one), then the body chunks. Under protocol 5 a
+  // large body is flattened and deflated first and the compressed bit set
+  // on the length word; an incompressible one goes out as-is.
+  void writeFrame(const QByteArrayList& chunks, int headerWords, quint32 requestId) {
+    const quint32 length = chunksLength(chunks);
+
+    QByteArray deflated;
+    if (compress && length >= quint32(compressMinBytes)) {
+      QByteArray flat;
+      flat.reserve(length);
+      for (const QByteArray& chunk : chunks)
+        flat += chunk;
+      deflated = qCompress(flat);
+      if (quint32(deflated.size()) >= length)
+        deflated = QByteArray();
+    }
+
+    const quint32 wireLength = deflated.isNull() ? length : quint32(deflated.size());
+    reactTraceWireFrame(true, length, wireLength);
+
+    quint32 header[2] = { deflated.isNull() ? wireLength : wireLength | frameCompressed,
+                          requestId };
+    socket->write((const char*)header, headerWords * sizeof(quint32));
+    if (deflated.isNull()) {
+      for (const QByteArray& chunk : chunks)
+        socket->write(chunk);
+    } else {
+      socket->write(deflated);
+    }
+  }
+
+  // Protocol 2: every frame carries a request id after the length prefix and
+  // replies may complete out of order, so queued requests are flushed back to
+  // back instead of one per round trip.
+  bool pipeline = false;
+  quint32 nextRequestId = 1;
+  quint32 replyId = 0;
+  QQueue<quint32> requestIdQueue;
+  QHash<quint32, ReactExecutor::ExecuteCallback> pendingCallbacks;
+
+  // Protocol 3: the application script streams as segment frames so the
+  // server can feed its parser while the rest of the bundle is still on the
+  // wire.
+  bool chunked = false;
+  QByteArray scriptBuffer;
+  int scriptOffset = 0;
+  quint32 scriptRequestId = 0;
+
+  // Protocol 5: frames above the threshold deflate before the socket and
+  // inflate after it, marked by the compressed bit on the length word.
+  bool compress = false;
+  bool inputCompressed = false;
+
+  // Large frames parse as they arrive: completed batch entries go to the
+  // reply's callback one by one, and the completion callback then fires
+  // with an invalid ref, which the bridge treats as "nothing further".
+  StreamingBatchParser streamParser;
+  bool streamingFrame = false;
+
+  ReactExecutor::ExecuteCallback replyCallback() const {
+    if (pipeline)
+      return pendingCallbacks.value(replyId);
+    return responseQueue.isEmpty() ? ReactExecutor::ExecuteCallback()
+                                   : responseQueue.head();
+  }
+
+  void beginStreamingIfLarge(quint32 length) {
+    streamingFrame = !inputCompressed && length >= quint32(streamParseMinBytes);
+    if (!streamingFrame)
+      return;
+    streamParser.reset();
+    streamParser.onEntry = [this](const ReactBridgeValueRef& entry) {
+      ReactExecutor::ExecuteCallback callback = replyCallback();
+      if (callback)
+        callback(entry);
+    };
+  }
+
+  // Inbound body for the frame just completed, inflated when marked.
+  QByteArray takeInputBody() {
+    const QByteArray body = inputCompressed ? qUncompress(inputBuffer) : inputBuffer;
+    reactTraceWireFrame(false, body.size(), inputBuffer.size());
+    inputCompressed = false;
+    return body;
+  }
+
+  // Protocol 1 has no ids on the wire, but replies are strictly FIFO, so
+  // when tracing these queues carry a synthetic id alongside a request
+  // through send and reply.
+  QQueue<quint32> traceSendIds;
+  QQueue<quint32> traceReplyIds;
+
+  // Protocol 4: requests stay journaled until their reply lands, so a
+  // reconnect can replay exactly the unacknowledged tail. The script keeps
+  // its own copy since it streams as segments.
+  bool resumable = false;
+  bool awaitingHello = false;
+  bool sentScript = false;
+  bool scriptAcked = false;
+  QByteArray sessionToken;
+  QMap<quint32, QByteArrayList> journal;
+  QByteArray journalScript;
+  int reconnectAttempts = 0;
+
+  void sendHello() {
+    awaitingHello = true;
+    writeFrame(QByteArrayList{"SESSION " + sessionToken}, 2, helloRequestId);
+  }
+
+  void handleHello(const QByteArray& payload) {
+    awaitingHello = false;
+    reconnectAttempts = 0;
+
+    if (payload != "RESUMED") {
+      if (sentScript) {
+        // The server dropped the VM; nothing short of a full re-bootstrap
+        // can recover, which is the bridge's call, not ours.
+        qWarning() << "JS host lost the session; executor going down";
+        machina->stop();
+        return;
+      }
+      // Fresh session on the first connection; proceed normally.
+    } else if (sentScript && !scriptAcked) {
+      // The bundle was mid-stream or mid-evaluation; start it over. The
+      // server skips re-evaluation if it already finished.
+      scriptBuffer = journalScript;
+      scriptOffset = 0;
+    }
+
+    // Unacknowledged requests replay in id order; the server dedupes by id
+    // and resends cached replies for any it already executed.
+    for (auto it = journal.constBegin(); it != journal.constEnd(); ++it)
+      writeFrame(it.value(), 2, it.key());
+
+    writeScriptSegments();
+    processRequests();
+  }
+
+  void scheduleReconnect() {
+    if (++reconnectAttempts > reconnectMaxAttempts) {
+      qWarning() << "JS host unreachable after" << reconnectMaxAttempts << "attempts; executor going down";
+      machina->stop();
+      return;
+    }
+    const int delay = qMin(reconnectBaseDelayMs * (1 << qMin(reconnectAttempts - 1, 4)),
+                           reconnectMaxDelayMs);
+    QTimer::singleShot(delay, this, [=] {
+      socket->abort();
+      // A partial frame from the dropped connection means nothing on the
+      // new one.
+      inputBuffer.clear();
+      streamingFrame = false;
+      socket->connectToHost(serverHost, 5000);
+    });
+  }
+
+  void streamScript(const QByteArray& script, const ReactExecutor::ExecuteCallback& callback) {
+    scriptBuffer = script;
+    scriptOffset = 0;
+    scriptRequestId = nextRequestId++;
+    pendingCallbacks.insert(scriptRequestId, callback);
+    if (resumable) {
+      sentScript = true;
+      journalScript = script;
+    }
+    writeScriptSegments();
+  }
+
+  void writeScriptSegments() {
+    if (scriptBuffer.isEmpty() || awaitingHello ||
+        socket->state() != QAbstractSocket::ConnectedState)
+      return;
+
+    // Keep the send window full and no more; backpressure comes from only
+    // topping it back up as bytesWritten drains it.
+    while (scriptOffset < scriptBuffer.size() && socket->bytesToWrite() < sendWindowBytes) {
+      int length = qMin(segmentBytes, scriptBuffer.size() - scriptOffset);
+      bool last = scriptOffset + length == scriptBuffer.size();
+      writeFrame(QByteArrayList{QByteArray::fromRawData(scriptBuffer.constData() + scriptOffset, length)},
+                 2, last ? scriptRequestId : scriptRequestId | segmentContinues);
+      scriptOffset += length;
+    }
+
+    if (scriptOffset == scriptBuffer.size())
+      scriptBuffer.clear();
+  }
+
+  void enqueueRequest(const QByteArrayList& request, const ReactExecutor::ExecuteCallback& callback) {
+    requestQueue.enqueue(request);
+    if (pipeline) {
+      quint32 requestId = nextRequestId++;
+      requestIdQueue.enqueue(requestId);
+      pendingCallbacks.insert(requestId, callback);
+      if (resumable)
+        journal.insert(requestId, request);
+      reactTraceRequestBegin(requestId);
+    } else {
+      responseQueue.enqueue(callback);
+      if (reactTraceEnabled()) {
+        const quint32 traceId = nextRequestId++;
+        traceSendIds.enqueue(traceId);
+        reactTraceRequestBegin(traceId);
+      }
+    }
+    processRequests();
+  }
+
   void processRequests() {
     if (socket->state() != QAbstractSocket::ConnectedState ||
-        requestQueue.isEmpty()) {
+        awaitingHello || requestQueue.isEmpty()) {
       return;
     }
 
-    QByteArray request = requestQueue.dequeue();
-    quint32 length = request.size();
-    socket->write((const char*)&length, sizeof(length));
-    socket->write(request.constData(), request.size());
+    if (!pipeline) {
+      QByteArrayList request = requestQueue.dequeue();
+      writeFrame(request, 1, 0);
+      if (!traceSendIds.isEmpty()) {
+        const quint32 traceId = traceSendIds.dequeue();
+        reactTraceRequestStamp(traceId, "send");
+        traceReplyIds.enqueue(traceId);
+      }
+      return;
+    }
+
+    while (!requestQueue.isEmpty()) {
+      QByteArrayList request = requestQueue.dequeue();
+      const quint32 requestId = requestIdQueue.dequeue();
+      writeFrame(request, 2, requestId);
+      reactTraceRequestStamp(requestId, "send");
+    }
+  }
+
+  void deliverReply(const QByteArray& payload) {
+    if (resumable && replyId == helloRequestId) {
+      handleHello(payload);
+      return;
+    }
+    if (resumable) {
+      journal.remove(replyId);
+      if (replyId == scriptRequestId) {
+        scriptAcked = true;
+        journalScript.clear();
+      }
+    }
+    reactTraceRequestStamp(replyId, "reply");
+    reactReplayRecord(payload);
+    ReactExecutor::ExecuteCallback callback = pendingCallbacks.take(replyId);
+    if (callback) {
+      ReactBridgeValueRef result;
+      if (streamingFrame && streamParser.emitted() > 0) {
+        // Entries already went out as they completed; the invalid ref just
+        // closes out the request.
+      } else if (payload != "undefined") {
+        result = reactParseBridgeJson(payload);
+      }
+      callback(result);
+    }
+    streamingFrame = false;
+    reactTraceRequestEnd(replyId);
+  }
+
+  void readFrames() {
+    // Replies can interleave, so drain every complete frame that is
+    // buffered; a partial frame picks up on the next readyRead.
+    for (;;) {
+      if (inputBuffer.capacity() == 0) {
+        quint32 header[2];
+        if (socket->bytesAvailable() < qint64(sizeof(header)))
+          return;
+        socket->read((char*)header, sizeof(header));
+        replyId = header[1];
+        inputCompressed = (header[0] & frameCompressed) != 0;
+        const quint32 length = header[0] & ~frameCompressed;
+        if (length == 0) {
+          deliverReply(QByteArray());
+          continue;
+        }
+        inputBuffer.reserve(length);
+        beginStreamingIfLarge(length);
+      }
+
+      inputBuffer += socket->read(inputBuffer.capacity() - inputBuffer.size());
+      if (streamingFrame)
+        streamParser.consume(inputBuffer);
+      if (inputBuffer.size() < inputBuffer.capacity())
+        return;
+
+      deliverReply(takeInputBody());
+      inputBuffer.clear();
+    }
   }
 
 public Q_SLOTS:
+  void resumeScript() {
+    writeScriptSegments();
+  }
+
   void readReply() {
+    if (pipeline) {
+      readFrames();
+      return;
+    }
+
     if (inputBuffer.capacity() == 0) {
       quint32 length = 0;
       if (socket->bytesAvailable() < sizeof(length))
         return;
       socket->read((char*)&length, sizeof(length));
-      inputBuffer.reserve(length);
+      inputCompressed = (length & frameCompressed) != 0;
+      inputBuffer.reserve(length & ~frameCompressed);
+      beginStreamingIfLarge(length & ~frameCompressed);
     }
 
     inputBuffer += socket->read(inputBuffer.capacity() - inputBuffer.size());
+    if (streamingFrame)
+      streamParser.consume(inputBuffer);
 
     if (inputBuffer.size() < inputBuffer.capacity())
       return;
 
+    const QByteArray body = takeInputBody();
+
+    quint32 traceId = 0;
+    if (!traceReplyIds.isEmpty()) {
+      traceId = traceReplyIds.dequeue();
+      reactTraceRequestStamp(traceId, "reply");
+    }
+    reactReplayRecord(body);
+
     ReactExecutor::ExecuteCallback callback = responseQueue.dequeue();
     if (callback) {
-      QJsonDocument doc;
-      if (inputBuffer != "undefined") {
-        doc = QJsonDocument::fromJson(inputBuffer);
+      ReactBridgeValueRef result;
+      if (streamingFrame && streamParser.emitted() > 0) {
+        // Entries already went out as they completed.
+      } else if (body != "undefined") {
+        result = reactParseBridgeJson(body);
       }
-      callback(doc);
+      callback(result);
     }
+    streamingFrame = false;
+    if (traceId != 0)
+      reactTraceRequestEnd(traceId);
 
     inputBuffer.clear();
   }
@@ -90,8 +608,20 @@ ReactNetExecutor::ReactNetExecutor(QObject* parent)
   if (!serverHost.isEmpty())
     d->serverHost = serverHost;
 
+  // Opt in to the id-tagged pipelined framing; the server has to speak it
+  // too, so the default stays with the one-frame-at-a-time protocol.
+  int protocol = qgetenv("REACT_SERVER_PROTOCOL").toInt();
+  d->pipeline = protocol >= 2;
+  d->chunked = protocol >= 3;
+  d->resumable = protocol >= 4;
+  d->compress = protocol >= 5;
+  if (d->resumable)
+    d->sessionToken = QUuid::createUuid().toByteArray();
+
   d->socket = new QTcpSocket(this);
   connect(d->socket, SIGNAL(readyRead()), d, SLOT(readReply()));
+  if (d->chunked)
+    connect(d->socket, SIGNAL(bytesWritten(qint64)), d, SLOT(resumeScript()));
 
   d->machina = new QStateMachine(this);
 
@@ -100,13 +630,34 @@ ReactNetExecutor::ReactNetExecutor(QObject* parent)
   QState* readyState = new QState();
 
   initialState->addTransition(d->socket, SIGNAL(connected()), readyState);
-  readyState->addTransition(d->socket, SIGNAL(error(QAbstractSocket::SocketError)), errorState);
-  readyState->addTransition(d->socket, SIGNAL(disconnected()), errorState);
+  if (d->resumable) {
+    // A dropped socket goes through reconnect instead of straight to dead;
+    // a failed attempt re-enters the state, which schedules the next one.
+    QState* reconnectState = new QState();
+    readyState->addTransition(d->socket, SIGNAL(error(QAbstractSocket::SocketError)), reconnectState);
+    readyState->addTransition(d->socket, SIGNAL(disconnected()), reconnectState);
+    reconnectState->addTransition(d->socket, SIGNAL(error(QAbstractSocket::SocketError)), reconnectState);
+    reconnectState->addTransition(d->socket, SIGNAL(connected()), readyState);
+    connect(reconnectState, &QAbstractState::entered, [=] {
+        d->scheduleReconnect();
+      });
+    d->machina->addState(reconnectState);
+  } else {
+    readyState->addTransition(d->socket, SIGNAL(error(QAbstractSocket::SocketError)), errorState);
+    readyState->addTransition(d->socket, SIGNAL(disconnected()), errorState);
+  }
 
   connect(initialState, &QAbstractState::entered, [=] {
       d->socket->connectToHost(d->serverHost, 5000);
     });
   connect(readyState, &QAbstractState::entered, [=] {
+      if (d->resumable) {
+        // Nothing flushes until the server says whether the session
+        // survived; handleHello releases the queues.
+        d->sendHello();
+        return;
+      }
+      d->writeScriptSegments();
       d->processRequests();
     });
   connect(errorState, &QAbstractState::entered, [=] {
@@ -143,13 +694,30 @@ void ReactNetExecutor::init()
 
 void ReactNetExecutor::injectJson(const QString& name, const QVariant& data)
 {
-  QJsonDocument doc = QJsonDocument::fromVariant(data);
-  processRequest(name.toLocal8Bit() + "=" + doc.toJson(QJsonDocument::Compact));
+  injectSerializedJson(name, reactStringifyJson(data));
+}
+
+void ReactNetExecutor::injectSerializedJson(const QString& name, const QByteArray& json)
+{
+  // The config payload runs to hundreds of KB; keep it as its own shared
+  // chunk instead of concatenating.
+  processRequest(QByteArrayList{name.toLocal8Bit() + "=", json});
 }
 
 void ReactNetExecutor::executeApplicationScript(const QByteArray& script, const QUrl& /*sourceUrl*/)
 {
-  processRequest(script, [=](const QJsonDocument&) {
+  Q_D(ReactNetExecutor);
+
+  if (d->chunked) {
+    // Stream the bundle so transfer and parse overlap instead of running
+    // back to back; the single reply still marks evaluation complete.
+    d->streamScript(script, [=](const ReactBridgeValueRef&) {
+        Q_EMIT applicationScriptDone();
+      });
+    return;
+  }
+
+  processRequest(QByteArrayList{script}, [=](const ReactBridgeValueRef&) {
       Q_EMIT applicationScriptDone();
     });
 }
@@ -159,30 +727,32 @@ void ReactNetExecutor::executeJSCall(
   const QVariantList& args,
   const ReactExecutor::ExecuteCallback& callback
 ) {
-  QByteArrayList stringifiedArgs;
+  // Built as chunks rather than joined: a multi-MB batch payload stays
+  // shared with the buffer the stringifier produced.
+  QByteArrayList chunks{QByteArray("__fbBatchedBridge.") + method.toLocal8Bit() + "("};
+  bool first = true;
   for (const QVariant& arg : args) {
+    if (!first)
+      chunks += QByteArray(",");
+    first = false;
     if (arg.type() == QVariant::List || arg.type() == QVariant::Map) {
-      QJsonDocument doc = QJsonDocument::fromVariant(arg);
-      stringifiedArgs += doc.toJson(QJsonDocument::Compact);
+      chunks += reactStringifyJson(arg);
     } else {
-      stringifiedArgs += '"' + arg.toString().toLocal8Bit() + '"';
+      chunks += '"' + arg.toString().toLocal8Bit() + '"';
     }
   }
+  chunks += QByteArray(");");
 
-  processRequest(
-     QByteArray("__fbBatchedBridge.") + method.toLocal8Bit() + "(" + stringifiedArgs.join(',') + ");",
-     callback);
+  processRequest(chunks, callback);
 }
 
 void ReactNetExecutor::processRequest(
-  const QByteArray& request,
+  const QByteArrayList& request,
   const ReactExecutor::ExecuteCallback& callback
 ) {
   Q_D(ReactNetExecutor);
 
-  d->requestQueue.enqueue(request);
-  d->responseQueue.enqueue(callback);
-  d->processRequests();
+  d->enqueueRequest(request, callback);
 }
 
 #include "reactnetexecutor.moc"
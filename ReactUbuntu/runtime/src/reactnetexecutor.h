@@ -14,6 +14,8 @@
 #ifndef REACTNETEXECUTOR_H
 #define REACTNETEXECUTOR_H
 
+#include <QByteArrayList>
+
 #include "reactexecutor.h"
 
 
@@ -35,13 +37,16 @@ public:
   void init() override;
 
   void injectJson(const QString& name, const QVariant& data) override;
+  void injectSerializedJson(const QString& name, const QByteArray& json) override;
   void executeApplicationScript(const QByteArray& script, const QUrl& sourceUrl) override;
   void executeJSCall(const QString& method,
                      const QVariantList& args = QVariantList(),
                      const ExecuteCallback& callback = ExecuteCallback()) override;
 
 private:
-  void processRequest(const QByteArray& request, const ExecuteCallback& callback = ExecuteCallback());
+  // Requests travel as chunk lists so large payloads stay implicitly shared
+  // end to end; the wire frame is the chunks behind one summed length.
+  void processRequest(const QByteArrayList& request, const ExecuteCallback& callback = ExecuteCallback());
 
   QScopedPointer<ReactNetExecutorPrivate> d_ptr;
 };
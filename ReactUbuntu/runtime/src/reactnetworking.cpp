@@ -11,17 +11,23 @@
  *
  */
 
+#include <memory>
+
+#include <QBuffer>
+#include <QFile>
 #include <QMetaObject>
 #include <QMetaMethod>
 #include <QNetworkAccessManager>
 #include <QNetworkRequest>
 #include <QNetworkReply>
+#include <QTimer>
 
 #include <QDebug>
 
 #include "reactnetworking.h"
 #include "reactbridge.h"
 #include "reacteventdispatcher.h"
+#include "reactrequestscheduler.h"
 
 
 namespace {
@@ -32,6 +38,19 @@ QVariantMap headerListToMap(const QList<QNetworkReply::RawHeaderPair>& rawHeader
   }
   return rh;
 }
+
+// Body bytes are handed to JS once this much has accumulated, so a fast
+// transfer does not flood the bridge with one event per socket read while a
+// slow one still streams progressively. REACT_NET_CHUNK_SIZE overrides.
+int incrementalChunkSize() {
+  static int size = 0;
+  if (size == 0) {
+    size = qgetenv("REACT_NET_CHUNK_SIZE").toInt();
+    if (size <= 0)
+      size = 64 * 1024;
+  }
+  return size;
+}
 }
 
 
@@ -41,8 +60,87 @@ public:
   QNetworkAccessManager* nam;
   QMap<int, QNetworkReply*> activeConnections;
 
-  void handleGetRequest(int requestId, const QNetworkRequest& request) {
-    QNetworkReply* reply = nam->get(request);
+  void handleGetRequest(int requestId,
+                        const QNetworkRequest& request,
+                        ReactRequestScheduler::Priority priority) {
+    bridge->requestScheduler()->get(request, priority, [=](QNetworkReply* reply) {
+      wireGetReply(requestId, reply);
+    });
+  }
+
+  // Builds the body device for an upload, or null when the method carries
+  // none. File bodies stream from disk as the socket drains; only string
+  // and base64 bodies - which already crossed the bridge - sit in memory.
+  QIODevice* bodyDevice(int requestId, const QVariantMap& data, bool* failed) {
+    *failed = false;
+    if (data.contains("file")) {
+      QFile* file = new QFile(data.value("file").toString());
+      if (!file->open(QIODevice::ReadOnly)) {
+        delete file;
+        bridge->eventDispatcher()->sendDeviceEvent("didCompleteNetworkResponse", QVariantList{
+          requestId,
+          "Could not open file for upload: " + data.value("file").toString()
+        });
+        *failed = true;
+        return nullptr;
+      }
+      return file;
+    }
+    QByteArray bytes;
+    if (data.contains("base64")) {
+      bytes = QByteArray::fromBase64(data.value("base64").toString().toLatin1());
+    } else if (data.contains("string")) {
+      bytes = data.value("string").toString().toUtf8();
+    } else {
+      if (data.contains("formData"))
+        qWarning() << __PRETTY_FUNCTION__ << "form data uploads not yet supported";
+      return nullptr;
+    }
+    QBuffer* buffer = new QBuffer;
+    buffer->setData(bytes);
+    buffer->open(QIODevice::ReadOnly);
+    return buffer;
+  }
+
+  void handleUploadRequest(int requestId,
+                           const QNetworkRequest& request,
+                           const QString& method,
+                           const QVariantMap& data,
+                           ReactRequestScheduler::Priority priority) {
+    bool failed = false;
+    QIODevice* body = bodyDevice(requestId, data, &failed);
+    if (failed)
+      return;
+    bridge->requestScheduler()->send(request, method.toUpper().toLocal8Bit(), body,
+                                     priority, [=](QNetworkReply* reply) {
+      wireUploadProgress(requestId, reply);
+      // Response handling is the same as for a GET.
+      wireGetReply(requestId, reply);
+    });
+  }
+
+  void wireUploadProgress(int requestId, QNetworkReply* reply) {
+    // uploadProgress fires per socket write; coalesce to one device event
+    // per event-loop turn so a large body read off a fast disk does not
+    // flood the bridge.
+    auto pending = std::make_shared<QPair<qint64, qint64>>(-1, -1);
+    QObject::connect(reply, &QNetworkReply::uploadProgress, [=](qint64 sent, qint64 total) {
+      const bool scheduled = pending->first >= 0;
+      *pending = qMakePair(sent, total);
+      if (scheduled)
+        return;
+      QTimer::singleShot(0, bridge, [=] {
+        bridge->eventDispatcher()->sendDeviceEvent("didSendNetworkData", QVariantList{
+          requestId,
+          pending->first,
+          pending->second
+        });
+        pending->first = -1;
+      });
+    });
+  }
+
+  void wireGetReply(int requestId, QNetworkReply* reply) {
     QObject::connect(reply, &QNetworkReply::metaDataChanged, [=]() {
       bridge->eventDispatcher()->sendDeviceEvent("didReceiveNetworkResponse", QVariantList{
         requestId,
@@ -51,17 +149,30 @@ public:
         reply->url().toString()
       });
     });
-    QObject::connect(reply, &QNetworkReply::downloadProgress, [=](qint64 bytesReceived, qint64 bytesTotal) {
-      if (bytesReceived == 0) {
+    // The body is drained as it arrives and never accumulates beyond the
+    // chunk threshold; JS sees the same incremental event stream for a
+    // gigabyte download as for a small one.
+    auto pending = std::make_shared<QByteArray>();
+    QObject::connect(reply, &QNetworkReply::readyRead, [=]() {
+      pending->append(reply->readAll());
+      if (pending->size() < incrementalChunkSize())
         return;
-      }
       bridge->eventDispatcher()->sendDeviceEvent("didReceiveNetworkData", QVariantList{
         requestId,
-        reply->read(bytesReceived)
+        *pending
       });
+      pending->clear();
     });
     QObject::connect(reply, &QNetworkReply::finished, [=]() {
       reply->deleteLater();
+      pending->append(reply->readAll());
+      if (!pending->isEmpty()) {
+        bridge->eventDispatcher()->sendDeviceEvent("didReceiveNetworkData", QVariantList{
+          requestId,
+          *pending
+        });
+        pending->clear();
+      }
       bridge->eventDispatcher()->sendDeviceEvent("didCompleteNetworkResponse", QVariantList{
         requestId,
         reply->error() != QNetworkReply::NoError ? QVariant(reply->errorString()) : QVariant()
@@ -78,21 +189,35 @@ void ReactNetworking::sendRequest(
   const QString& method,
   const QUrl& url,
   const QVariantMap& headers,
-  const QByteArray& data
+  const QVariantMap& data
 ) {
   // qDebug() << __PRETTY_FUNCTION__ << method << url;
   Q_D(ReactNetworking);
 
   QNetworkRequest request(url);
+  d->bridge->prepareRequest(request);
 
+  // Application API calls default to the head of the request queue; a JS
+  // caller that knows better (pagination ahead of the viewport, say) can
+  // demote itself with an X-React-Priority pseudo header, which never goes
+  // on the wire.
+  ReactRequestScheduler::Priority priority = ReactRequestScheduler::Interactive;
   for (const QString& key : headers.keys()) {
+    if (key.compare("x-react-priority", Qt::CaseInsensitive) == 0) {
+      const QString value = headers[key].toString();
+      if (value.compare("prefetch", Qt::CaseInsensitive) == 0)
+        priority = ReactRequestScheduler::Prefetch;
+      else if (value.compare("normal", Qt::CaseInsensitive) == 0)
+        priority = ReactRequestScheduler::Normal;
+      continue;
+    }
     request.setRawHeader(key.toLocal8Bit(), headers[key].toString().toLocal8Bit());
   }
 
-  // TODO: data (post etc)
-
   if (method.compare("get", Qt::CaseInsensitive) == 0) {
-    d->handleGetRequest(requestId, request);
+    d->handleGetRequest(requestId, request, priority);
+  } else {
+    d->handleUploadRequest(requestId, request, method, data, priority);
   }
 }
 
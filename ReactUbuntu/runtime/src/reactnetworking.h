@@ -31,11 +31,14 @@ class ReactNetworking
   // Q_PLUGIN_METADATA(IID ReactModuleInterface_IID)
   Q_INTERFACES(ReactModuleInterface)
 
+  // data matches what XMLHttpRequest sends: {string:}, {base64:} or
+  // {file:} with a native path, whose body streams from disk without ever
+  // crossing the bridge or buffering whole in memory.
   Q_INVOKABLE void sendRequest(int requestId,
                                const QString& method,
                                const QUrl& url,
                                const QVariantMap& headers,
-                               const QByteArray& data);
+                               const QVariantMap& data);
   Q_INVOKABLE void abortRequest(int requestId);
 
   Q_DECLARE_PRIVATE(ReactNetworking);
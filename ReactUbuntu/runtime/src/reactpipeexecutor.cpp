@@ -18,12 +18,25 @@
 #include <QCoreApplication>
 #include <QObject>
 #include <QProcess>
-#include <QJsonDocument>
+#include <QSocketNotifier>
 #include <QStateMachine>
 
 #include <QDebug>
 
+#ifdef Q_OS_LINUX
+#include <atomic>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 #include "reactpipeexecutor.h"
+#include "reactjsonvalue.h"
+#include "reactreplayexecutor.h"
+#include "reactthreadscheduling.h"
+#include "reacttrace.h"
 
 
 namespace {
@@ -46,6 +59,120 @@ QString itemWithPath(const QString& item, const QStringList& searchPaths) {
 struct RegisterClass {
   RegisterClass() { qRegisterMetaType<ReactPipeExecutor*>(); }
 } registerClass;
+
+#ifdef Q_OS_LINUX
+// One direction of the shared segment: a single-producer single-consumer
+// byte ring. head and tail are free-running counters taken modulo the ring
+// size, so used space is always head - tail.
+struct ShmRingHeader {
+  std::atomic<quint32> head;
+  char pad0[60];
+  std::atomic<quint32> tail;
+  char pad1[60];
+};
+
+// Shared-memory transport to the co-process: a request ring (host to js) and
+// a reply ring (js to host) in one segment, with an eventfd doorbell per
+// direction. The doorbells are created without CLOEXEC so the child inherits
+// them across start(); the segment itself is opened by name on the far side.
+struct ShmChannel {
+  QByteArray name;
+  char* base = nullptr;
+  quint32 ringBytes = 0;
+  int toJsDoorbell = -1;   // rung here after producing requests or freeing reply space
+  int toHostDoorbell = -1; // rung by the co-process after replies or freed request space
+
+  ShmRingHeader* requestRing() const { return (ShmRingHeader*)base; }
+  char* requestData() const { return base + sizeof(ShmRingHeader); }
+  ShmRingHeader* replyRing() const { return (ShmRingHeader*)(base + sizeof(ShmRingHeader) + ringBytes); }
+  char* replyData() const { return base + 2 * sizeof(ShmRingHeader) + ringBytes; }
+
+  bool create(quint32 bytes) {
+    name = "/reactpipe-" + QByteArray::number(getpid());
+    int fd = shm_open(name.constData(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0)
+      return false;
+    size_t total = 2 * (sizeof(ShmRingHeader) + size_t(bytes));
+    if (ftruncate(fd, total) != 0) {
+      close(fd);
+      shm_unlink(name.constData());
+      return false;
+    }
+    base = (char*)mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+      base = nullptr;
+      shm_unlink(name.constData());
+      return false;
+    }
+    ringBytes = bytes;
+    toJsDoorbell = eventfd(0, EFD_NONBLOCK);
+    toHostDoorbell = eventfd(0, EFD_NONBLOCK);
+    if (toJsDoorbell < 0 || toHostDoorbell < 0) {
+      destroy();
+      return false;
+    }
+    return true;
+  }
+
+  void destroy() {
+    if (base != nullptr) {
+      munmap(base, 2 * (sizeof(ShmRingHeader) + size_t(ringBytes)));
+      shm_unlink(name.constData());
+      base = nullptr;
+    }
+    if (toJsDoorbell >= 0) {
+      close(toJsDoorbell);
+      toJsDoorbell = -1;
+    }
+    if (toHostDoorbell >= 0) {
+      close(toHostDoorbell);
+      toHostDoorbell = -1;
+    }
+  }
+
+  // Writes as much of [data, data+n) into the request ring as fits and
+  // returns how much went in; the caller retries the rest when the
+  // co-process signals freed space.
+  quint32 writeSome(const char* data, quint32 n) {
+    ShmRingHeader* ring = requestRing();
+    quint32 head = ring->head.load(std::memory_order_relaxed);
+    quint32 tail = ring->tail.load(std::memory_order_acquire);
+    quint32 written = qMin(n, ringBytes - (head - tail));
+    if (written == 0)
+      return 0;
+    quint32 pos = head % ringBytes;
+    quint32 first = qMin(written, ringBytes - pos);
+    memcpy(requestData() + pos, data, first);
+    memcpy(requestData(), data + first, written - first);
+    ring->head.store(head + written, std::memory_order_release);
+    return written;
+  }
+
+  // Drains up to max bytes from the reply ring.
+  quint32 readSome(char* out, quint32 max) {
+    ShmRingHeader* ring = replyRing();
+    quint32 head = ring->head.load(std::memory_order_acquire);
+    quint32 tail = ring->tail.load(std::memory_order_relaxed);
+    quint32 readable = qMin(max, head - tail);
+    if (readable == 0)
+      return 0;
+    quint32 pos = tail % ringBytes;
+    quint32 first = qMin(readable, ringBytes - pos);
+    memcpy(out, replyData() + pos, first);
+    memcpy(out + first, replyData(), readable - first);
+    ring->tail.store(tail + readable, std::memory_order_release);
+    return readable;
+  }
+
+  void ringDoorbell() {
+    quint64 one = 1;
+    if (write(toJsDoorbell, &one, sizeof(one)) < 0) {
+      // Non-blocking eventfd; an EAGAIN here means the bell is already rung.
+    }
+  }
+};
+#endif // Q_OS_LINUX
 }
 
 class ReactPipeExecutorPrivate : public QObject {
@@ -55,21 +182,158 @@ public:
   QProcess* nodeProcess = nullptr;
   QStateMachine* machina = nullptr;
   QByteArray inputBuffer;
-  QQueue<QByteArray> requestQueue;
+  // Requests queue as chunk lists, written out one by one behind a summed
+  // length header; implicit sharing keeps the large chunks (bundle, batch
+  // payloads, module config) aliased to the buffers the bridge built
+  // instead of joined into fresh allocations.
+  QQueue<QByteArrayList> requestQueue;
   QQueue<ReactExecutor::ExecuteCallback> responseQueue;
 
+  static quint32 chunksLength(const QByteArrayList& chunks) {
+    quint32 length = 0;
+    for (const QByteArray& chunk : chunks)
+      length += chunk.size();
+    return length;
+  }
+
+  // The pipe protocol has no ids on the wire, but replies are strictly
+  // FIFO, so when tracing these queues carry a synthetic id alongside a
+  // request through send and reply.
+  quint32 nextTraceId = 1;
+  QQueue<quint32> traceSendIds;
+  QQueue<quint32> traceReplyIds;
+
+  void traceSend() {
+    if (traceSendIds.isEmpty())
+      return;
+    const quint32 traceId = traceSendIds.dequeue();
+    reactTraceRequestStamp(traceId, "send");
+    traceReplyIds.enqueue(traceId);
+  }
+
+#ifdef Q_OS_LINUX
+  ShmChannel shm;
+  bool shmActive = false;
+  // Framed requests waiting for ring space, kept as chunks with an offset
+  // into the head chunk; the ring copy reads straight from each shared
+  // chunk, with no staging buffer to fill or shuffle down.
+  QQueue<QByteArray> shmOutChunks;
+  quint32 shmOutOffset = 0;
+  QByteArray shmInBuffer;  // partially received reply frame
+  QSocketNotifier* shmNotifier = nullptr;
+#endif
+
   void processRequests() {
     if (nodeProcess->state() != QProcess::Running ||
         requestQueue.isEmpty()) {
       return;
     }
 
-    QByteArray request = requestQueue.dequeue();
-    quint32 length = request.size();
+#ifdef Q_OS_LINUX
+    if (shmActive) {
+      // Batch traffic and the bundle go through the ring; the pipe stays up
+      // for control only.
+      while (!requestQueue.isEmpty()) {
+        QByteArrayList request = requestQueue.dequeue();
+        quint32 length = chunksLength(request);
+        shmOutChunks.enqueue(QByteArray((const char*)&length, sizeof(length)));
+        for (const QByteArray& chunk : request)
+          shmOutChunks.enqueue(chunk);
+        traceSend();
+      }
+      flushShm();
+      return;
+    }
+#endif
+
+    QByteArrayList request = requestQueue.dequeue();
+    quint32 length = chunksLength(request);
     nodeProcess->write((const char*)&length, sizeof(length));
-    nodeProcess->write(request.constData(), request.size());
+    for (const QByteArray& chunk : request)
+      nodeProcess->write(chunk);
+    traceSend();
+  }
+
+  void deliverReply(const QByteArray& payload) {
+    reactReplayRecord(payload);
+    quint32 traceId = 0;
+    if (!traceReplyIds.isEmpty()) {
+      traceId = traceReplyIds.dequeue();
+      reactTraceRequestStamp(traceId, "reply");
+    }
+    ReactExecutor::ExecuteCallback callback = responseQueue.dequeue();
+    if (callback) {
+      ReactBridgeValueRef result;
+      if (payload != "undefined") {
+        result = reactParseBridgeJson(payload);
+      }
+      callback(result);
+    }
+    if (traceId != 0)
+      reactTraceRequestEnd(traceId);
   }
 
+#ifdef Q_OS_LINUX
+  // Creates the segment and doorbells. Has to run before the co-process is
+  // spawned: the raw descriptor numbers in the offer only mean anything in
+  // the child through fork inheritance, and descriptors created after
+  // start() are never inherited.
+  void createShmChannel() {
+    if (qgetenv("REACT_PIPE_SHM").toInt() <= 0)
+      return;
+    quint32 ringBytes = qEnvironmentVariableIntValue("REACT_PIPE_SHM_SIZE");
+    if (ringBytes == 0)
+      ringBytes = 4 * 1024 * 1024;
+    if (!shm.create(ringBytes))
+      qWarning() << __PRETTY_FUNCTION__ << "Could not create shared-memory transport";
+  }
+
+  // Offers the shared-memory transport to the co-process over the pipe. The
+  // offer rides the normal request queue, so ordering with anything queued
+  // behind it is preserved; the co-process maps the segment, takes over the
+  // inherited doorbell descriptors and replies true to switch over.
+  void negotiateShm() {
+    if (shm.base == nullptr)
+      return;
+    QByteArray offer = "__shmAttach(\"" + shm.name + "\"," +
+      QByteArray::number(shm.ringBytes) + "," +
+      QByteArray::number(shm.toJsDoorbell) + "," +
+      QByteArray::number(shm.toHostDoorbell) + ");";
+    requestQueue.prepend(QByteArrayList{offer});
+    if (reactTraceEnabled()) {
+      const quint32 traceId = nextTraceId++;
+      traceSendIds.prepend(traceId);
+      reactTraceRequestBegin(traceId);
+    }
+    responseQueue.prepend([this](const ReactBridgeValueRef& result) {
+        if (result.isValid() && result.value().toBool()) {
+          shmActive = true;
+          shmNotifier = new QSocketNotifier(shm.toHostDoorbell, QSocketNotifier::Read, this);
+          connect(shmNotifier, &QSocketNotifier::activated, [this] { shmReadable(); });
+        } else {
+          shm.destroy();
+        }
+      });
+  }
+
+  void flushShm() {
+    bool wrote = false;
+    while (!shmOutChunks.isEmpty()) {
+      const QByteArray& front = shmOutChunks.head();
+      quint32 written = shm.writeSome(front.constData() + shmOutOffset,
+                                      front.size() - shmOutOffset);
+      wrote = wrote || written > 0;
+      shmOutOffset += written;
+      if (shmOutOffset < quint32(front.size()))
+        break;
+      shmOutChunks.dequeue();
+      shmOutOffset = 0;
+    }
+    if (wrote)
+      shm.ringDoorbell();
+  }
+#endif
+
 public Q_SLOTS:
   void readReply() {
     if (inputBuffer.capacity() == 0) {
@@ -85,17 +349,43 @@ public Q_SLOTS:
     if (inputBuffer.size() < inputBuffer.capacity())
       return;
 
-    ReactExecutor::ExecuteCallback callback = responseQueue.dequeue();
-    if (callback) {
-      QJsonDocument doc;
-      if (inputBuffer != "undefined") {
-        doc = QJsonDocument::fromJson(inputBuffer);
-      }
-      callback(doc);
-    }
+    deliverReply(inputBuffer);
 
     inputBuffer.clear();
   }
+
+public:
+#ifdef Q_OS_LINUX
+  void shmReadable() {
+    quint64 count = 0;
+    if (read(shm.toHostDoorbell, &count, sizeof(count)) < 0) {
+      // Spurious wakeup; nothing to drain.
+    }
+
+    char chunk[64 * 1024];
+    quint32 got;
+    while ((got = shm.readSome(chunk, sizeof(chunk))) > 0) {
+      shmInBuffer.append(chunk, got);
+    }
+
+    for (;;) {
+      if (shmInBuffer.size() < int(sizeof(quint32)))
+        break;
+      quint32 length = 0;
+      memcpy(&length, shmInBuffer.constData(), sizeof(length));
+      if (shmInBuffer.size() < int(sizeof(length) + length))
+        break;
+      deliverReply(shmInBuffer.mid(sizeof(length), length));
+      shmInBuffer.remove(0, sizeof(length) + length);
+    }
+
+    // Tell the co-process reply space was freed, and retry anything of ours
+    // still waiting on request-ring space — its doorbell means both "replies
+    // ready" and "request space freed".
+    shm.ringDoorbell();
+    flushShm();
+  }
+#endif
 };
 
 
@@ -133,9 +423,20 @@ ReactPipeExecutor::ReactPipeExecutor(QObject* parent)
   readyState->addTransition(d->nodeProcess, SIGNAL(error(QProcess::ProcessError)), errorState);
 
   connect(initialState, &QAbstractState::entered, [=] {
+#ifdef Q_OS_LINUX
+      // The doorbell descriptors reach the child only by inheritance, so
+      // the channel has to exist before the fork.
+      d->createShmChannel();
+#endif
       d->nodeProcess->start();
     });
   connect(readyState, &QAbstractState::entered, [=] {
+      // The node child is this platform's JS host; the "js" scheduling class
+      // applies to the whole child process.
+      reactApplyProcessScheduling("js", qint64(d->nodeProcess->processId()));
+#ifdef Q_OS_LINUX
+      d->negotiateShm();
+#endif
       d->processRequests();
     });
   connect(errorState, &QAbstractState::entered, [=] {
@@ -150,6 +451,9 @@ ReactPipeExecutor::ReactPipeExecutor(QObject* parent)
 
 ReactPipeExecutor::~ReactPipeExecutor()
 {
+#ifdef Q_OS_LINUX
+  d_func()->shm.destroy();
+#endif
 }
 
 QString ReactPipeExecutor::nodePath() const
@@ -189,11 +493,16 @@ void ReactPipeExecutor::init()
 
 void ReactPipeExecutor::injectJson(const QString& name, const QVariant& data)
 {
-  Q_D(ReactPipeExecutor);
+  injectSerializedJson(name, reactStringifyJson(data));
+}
 
-  QJsonDocument doc = QJsonDocument::fromVariant(data);
+void ReactPipeExecutor::injectSerializedJson(const QString& name, const QByteArray& json)
+{
+  Q_D(ReactPipeExecutor);
 
-  processRequest(name.toLocal8Bit() + "=" + doc.toJson(QJsonDocument::Compact) + ";");
+  // The config payload runs to hundreds of KB; keep it as its own shared
+  // chunk instead of concatenating.
+  processRequest(QByteArrayList{name.toLocal8Bit() + "=", json, QByteArray(";")});
 }
 
 
@@ -201,7 +510,7 @@ void ReactPipeExecutor::executeApplicationScript(const QByteArray& script, const
 {
   Q_D(ReactPipeExecutor);
 
-  processRequest(script, [=](const QJsonDocument&) {
+  processRequest(QByteArrayList{script}, [=](const ReactBridgeValueRef&) {
       Q_EMIT applicationScriptDone();
     });
 }
@@ -213,29 +522,38 @@ void ReactPipeExecutor::executeJSCall(
 ) {
   Q_D(ReactPipeExecutor);
 
-  QByteArrayList stringifiedArgs;
+  // Built as chunks rather than joined: a multi-MB batch payload stays
+  // shared with the buffer the stringifier produced.
+  QByteArrayList chunks{QByteArray("__fbBatchedBridge.") + method.toLocal8Bit() + "("};
+  bool first = true;
   for (const QVariant& arg : args) {
+    if (!first)
+      chunks += QByteArray(",");
+    first = false;
     if (arg.type() == QVariant::List || arg.type() == QVariant::Map) {
-      QJsonDocument doc = QJsonDocument::fromVariant(arg);
-      stringifiedArgs += doc.toJson(QJsonDocument::Compact);
+      chunks += reactStringifyJson(arg);
     } else {
-      stringifiedArgs += '"' + arg.toString().toLocal8Bit() + '"';
+      chunks += '"' + arg.toString().toLocal8Bit() + '"';
     }
   }
+  chunks += QByteArray(");");
 
-  processRequest(
-     QByteArray("__fbBatchedBridge.") + method.toLocal8Bit() + "(" + stringifiedArgs.join(',') + ");",
-     callback);
+  processRequest(chunks, callback);
 }
 
 void ReactPipeExecutor::processRequest(
-  const QByteArray& request,
+  const QByteArrayList& request,
   const ReactExecutor::ExecuteCallback& callback
 ) {
   Q_D(ReactPipeExecutor);
 
   d->requestQueue.enqueue(request);
   d->responseQueue.enqueue(callback);
+  if (reactTraceEnabled()) {
+    const quint32 traceId = d->nextTraceId++;
+    d->traceSendIds.enqueue(traceId);
+    reactTraceRequestBegin(traceId);
+  }
   d->processRequests();
 }
 
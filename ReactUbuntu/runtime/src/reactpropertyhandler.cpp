@@ -12,11 +12,54 @@
  */
 
 #include <QDebug>
+#include <QHash>
 
+#include "reactatoms.h"
 #include "reactpropertyhandler.h"
 #include "reactvaluecoercion.h"
 
 
+namespace {
+typedef QMap<QString, QMetaProperty> PropertyMap;
+
+void setAtomProperty(QVector<QMetaProperty>& byAtom, int atom, const QMetaProperty& property)
+{
+  if (atom >= byAtom.size())
+    byAtom.resize(atom + 1);
+  byAtom[atom] = property;
+}
+
+struct HandlerTable {
+  PropertyMap properties;
+  QVector<QMetaProperty> byAtom;
+};
+
+// Process-wide prop name -> property table, one entry per handler class.
+// Handler meta-objects come out of moc and live for the whole process, so
+// the table is built once and shared by every instance of the class. The
+// same is not true of the core objects - the QML engine compiles a
+// meta-object per created component - so those stay on the handler.
+const HandlerTable& handlerProperties(const QMetaObject* metaObject)
+{
+  static QHash<const QMetaObject*, HandlerTable> tables;
+  QHash<const QMetaObject*, HandlerTable>::iterator it = tables.find(metaObject);
+  if (it == tables.end()) {
+    HandlerTable table;
+    const int propertyCount = metaObject->propertyCount();
+    for (int i = 1; i < propertyCount; ++i) {
+      QMetaProperty p = metaObject->property(i);
+      if (p.isScriptable()) {
+        table.properties.insert(p.name(), p);
+        setAtomProperty(table.byAtom, reactAtom(p.name()), p);
+      }
+    }
+    it = tables.insert(metaObject, table);
+  }
+  return it.value();
+}
+}
+
+
 ReactPropertyHandler::ReactPropertyHandler(QObject* object, bool exposeQmlProperties)
   : QObject(object)
   , m_exposeQmlProperties(exposeQmlProperties)
@@ -31,7 +74,7 @@ ReactPropertyHandler::~ReactPropertyHandler()
 QList<QMetaProperty> ReactPropertyHandler::availableProperties()
 {
   buildPropertyMap();
-  return m_coreProperties.values() + m_extraProperties.values();
+  return m_coreProperties.values() + m_extraProperties->values();
 }
 
 void ReactPropertyHandler::applyProperties(const QVariantMap& properties)
@@ -50,16 +93,25 @@ void ReactPropertyHandler::applyProperties(const QVariantMap& properties)
   }
   */
 
-  for (const QString& key : properties.keys()) {
-    QMap<QString, QMetaProperty>::iterator it = m_extraProperties.find(key);
+  for (auto pit = properties.constBegin(); pit != properties.constEnd(); ++pit) {
+    const int atom = reactAtom(pit.key());
+    // updateView bursts resend props wholesale; skip the ones whose value
+    // has not changed since the last apply.
+    const quint64 hash = reactPropertyHash(pit.value());
+    QHash<int, quint64>::const_iterator ait = m_appliedHashes.constFind(atom);
+    if (ait != m_appliedHashes.constEnd() && ait.value() == hash)
+      continue;
+
     // Extras get first shot
-    if (it != m_extraProperties.end()) {
-      it.value().write(this, reactCoerceValue(properties.value(key), it.value().userType()));
-    } else if (m_exposeQmlProperties) {
-      it = m_coreProperties.find(key);
-      if (it != m_coreProperties.end()) {
-        it.value().write(m_object, reactCoerceValue(properties.value(key), it.value().userType()));
-      }
+    if (atom < m_extraPropertiesByAtom->size() && m_extraPropertiesByAtom->at(atom).isValid()) {
+      const QMetaProperty& p = m_extraPropertiesByAtom->at(atom);
+      p.write(this, reactCoerceValue(pit.value(), p.userType()));
+      m_appliedHashes.insert(atom, hash);
+    } else if (m_exposeQmlProperties &&
+               atom < m_corePropertiesByAtom.size() && m_corePropertiesByAtom.at(atom).isValid()) {
+      const QMetaProperty& p = m_corePropertiesByAtom.at(atom);
+      p.write(m_object, reactCoerceValue(pit.value(), p.userType()));
+      m_appliedHashes.insert(atom, hash);
     }
   }
 }
@@ -77,21 +129,16 @@ void ReactPropertyHandler::buildPropertyMap()
 
     for (int i = metaObject->propertyOffset(); i < propertyCount; ++i) {
       QMetaProperty p = metaObject->property(i);
-      if (p.isScriptable())
+      if (p.isScriptable()) {
         m_coreProperties.insert(p.name(), p);
+        setAtomProperty(m_corePropertiesByAtom, reactAtom(p.name()), p);
+      }
     }
   }
 
   // All properties on the handlers (extras)
-  {
-  const QMetaObject* metaObject = this->metaObject();
-  const int propertyCount = metaObject->propertyCount();
-
-  for (int i = 1; i < propertyCount; ++i) {
-    QMetaProperty p = metaObject->property(i);
-    if (p.isScriptable())
-      m_extraProperties.insert(p.name(), p);
-  }
-  }
+  const HandlerTable& table = handlerProperties(this->metaObject());
+  m_extraProperties = &table.properties;
+  m_extraPropertiesByAtom = &table.byAtom;
   m_cached = true;
 }
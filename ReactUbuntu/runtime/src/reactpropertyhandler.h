@@ -14,9 +14,11 @@
 #ifndef REACTPROPERTYHANDLER_H
 #define REACTPROPERTYHANDLER_H
 
+#include <QHash>
 #include <QMap>
 #include <QObject>
 #include <QMetaProperty>
+#include <QVector>
 
 
 class QQuickItem;
@@ -38,7 +40,18 @@ protected:
   bool m_cached = false;
   QObject* m_object;
   QMap<QString, QMetaProperty> m_coreProperties;
-  QMap<QString, QMetaProperty> m_extraProperties;
+  // Shared per-class table; all instances of a handler class point at the
+  // same map.
+  const QMap<QString, QMetaProperty>* m_extraProperties = nullptr;
+  // Atom-indexed mirrors of the two maps above; the per-write lookups in
+  // applyProperties are array indexing on the prop name atom. An atom past
+  // the end of a vector was minted after the table was built and so cannot
+  // name one of its properties.
+  QVector<QMetaProperty> m_corePropertiesByAtom;
+  const QVector<QMetaProperty>* m_extraPropertiesByAtom = nullptr;
+  // reactPropertyHash of the last value written per prop atom; a resend
+  // hashing the same is dropped before the QMetaProperty::write.
+  QHash<int, quint64> m_appliedHashes;
 
 private:
   void buildPropertyMap();
@@ -81,16 +81,18 @@ Text {
 )COMPONENT";
 }
 
-QQuickItem* ReactRawTextManager::view(const QVariantMap& properties) const
+QByteArray ReactRawTextManager::componentSource() const
 {
-  QString componentString = QString(component_qml);
+  return QByteArray(component_qml);
+}
 
-  QQmlComponent component(m_bridge->qmlEngine());
-  component.setData(componentString.toLocal8Bit(), QUrl());
-  if (!component.isReady())
+QQuickItem* ReactRawTextManager::view(const QVariantMap& properties) const
+{
+  QQmlComponent* component = m_bridge->componentForSource(componentSource());
+  if (!component->isReady())
     qCritical() << "Component for RCTRawTextManager not ready";
 
-  QQuickItem* item = qobject_cast<QQuickItem*>(component.create());
+  QQuickItem* item = qobject_cast<QQuickItem*>(component->create());
   if (item == nullptr) {
     qCritical() << "Unable to create component for RCTRawTextManager";
     return nullptr;
@@ -46,6 +46,8 @@ public:
 
   QQuickItem* view(const QVariantMap& properties = QVariantMap()) const override;
 
+  QByteArray componentSource() const override;
+
 protected:
   ReactBridge* m_bridge;
 };
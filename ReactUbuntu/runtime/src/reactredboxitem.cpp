@@ -15,6 +15,7 @@
 
 #include "reactredboxitem.h"
 #include "reactbridge.h"
+#include "reactsourcemap.h"
 
 
 namespace {
@@ -150,14 +151,54 @@ class ReactRedboxItemPrivate : public QAbstractListModel {
   Q_DECLARE_PUBLIC(ReactRedboxItem)
 public:
   QList<QVariantMap> stack;
+  QList<QVariantMap> rawStack;
   QQuickItem* redbox;
   ReactRedboxItem* q_ptr;
   ReactBridge* bridge;
+  ReactSourceMap* sourceMap = nullptr;
 
   ReactRedboxItemPrivate(ReactRedboxItem* q)
     : q_ptr(q)
   {}
 
+  // Shows the raw frames immediately and swaps in source-mapped positions
+  // once (or as soon as) the symbolication index is available.
+  void showStack(const QList<QVariantMap>& stack) {
+    rawStack = stack;
+
+    if (sourceMap == nullptr && !stack.isEmpty()) {
+      sourceMap = new ReactSourceMap(this);
+      connect(sourceMap, SIGNAL(loaded()), SLOT(sourceMapLoaded()));
+      sourceMap->loadForBundle(bridge->bundleUrl(), bridge->networkAccessManager());
+    }
+
+    setStack(symbolicatedStack(stack));
+  }
+
+  QList<QVariantMap> symbolicatedStack(const QList<QVariantMap>& stack) const {
+    if (sourceMap == nullptr || !sourceMap->ready())
+      return stack;
+
+    QList<QVariantMap> resolved;
+    resolved.reserve(stack.size());
+    for (const QVariantMap& frame : stack) {
+      QVariantMap position = sourceMap->resolveFrame(frame.value("lineNumber").toInt(),
+                                                     frame.value("column").toInt());
+      if (position.isEmpty()) {
+        resolved.push_back(frame);
+        continue;
+      }
+      QVariantMap mapped = frame;
+      mapped.insert("file", position.value("file"));
+      mapped.insert("lineNumber", position.value("lineNumber"));
+      mapped.insert("column", position.value("column"));
+      if (mapped.value("methodName").toString().isEmpty() && position.contains("methodName"))
+        mapped.insert("methodName", position.value("methodName"));
+      resolved.push_back(mapped);
+    }
+    return resolved;
+  }
+
   void setStack(const QList<QVariantMap>& stack) {
     const bool oe = this->stack.isEmpty();
     beginResetModel();
@@ -195,6 +236,9 @@ public Q_SLOTS:
   void dismissPressed() {
     q_ptr->setParentItem(0);
   }
+  void sourceMapLoaded() {
+    setStack(symbolicatedStack(rawStack));
+  }
 
 Q_SIGNALS:
   void emptyChanged();
@@ -229,7 +273,7 @@ void ReactRedboxItem::showErrorMessage(const QString& message, const QList<QVari
 {
   Q_D(ReactRedboxItem);
   d->redbox->setProperty("message", message);
-  d->setStack(stack);
+  d->showStack(stack);
   setParentItem(d->bridge->visualParent());
   setX(0); setY(0);
   setWidth(d->bridge->visualParent()->width()); setHeight(d->bridge->visualParent()->height());
@@ -239,7 +283,7 @@ void ReactRedboxItem::updateErrorMessage(const QString& message, const QList<QVa
 {
   Q_D(ReactRedboxItem);
   d->redbox->setProperty("message", message);
-  d->setStack(stack);
+  d->showStack(stack);
 }
 
 #include "reactredboxitem.moc"
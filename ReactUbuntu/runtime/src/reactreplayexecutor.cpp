@@ -0,0 +1,184 @@
+
+/**
+ * Copyright (C) 2016, Canonical Ltd.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ *
+ * Author: Justin McPherson <justin.mcpherson@canonical.com>
+ *
+ */
+
+#include <QDataStream>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QList>
+#include <QTimer>
+
+#include <QDebug>
+
+#include "reactreplayexecutor.h"
+
+
+namespace {
+struct RegisterClass {
+  RegisterClass() { qRegisterMetaType<ReactReplayExecutor*>(); }
+} registerClass;
+
+const char kLogMagic[] = "reactreplay 1\n";
+}
+
+
+void reactReplayRecord(const QByteArray& replyPayload)
+{
+  static QElapsedTimer sessionClock;
+  static QFile* log = [] () -> QFile* {
+    const QString path = QString::fromLocal8Bit(qgetenv("REACT_REPLAY_RECORD"));
+    if (path.isEmpty())
+      return nullptr;
+    QFile* file = new QFile(path);
+    if (!file->open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+      qWarning() << __PRETTY_FUNCTION__ << "Could not open replay log" << path;
+      delete file;
+      return nullptr;
+    }
+    file->write(kLogMagic, sizeof(kLogMagic) - 1);
+    sessionClock.start();
+    return file;
+  }();
+
+  if (log == nullptr)
+    return;
+
+  QDataStream stream(log);
+  stream.setVersion(QDataStream::Qt_5_0);
+  stream << qint64(sessionClock.elapsed()) << replyPayload;
+}
+
+
+class ReactReplayExecutorPrivate
+{
+public:
+  struct Batch {
+    qint64 atMs;
+    QByteArray payload;
+  };
+
+  QList<Batch> batches;
+  int cursor = 0;
+  bool maxSpeed = false;
+  QElapsedTimer clock;
+
+  int delivered = 0;
+  qint64 totalDispatchUs = 0;
+  qint64 maxDispatchUs = 0;
+};
+
+
+ReactReplayExecutor::ReactReplayExecutor(QObject* parent)
+  : ReactExecutor(parent)
+  , d_ptr(new ReactReplayExecutorPrivate)
+{
+}
+
+ReactReplayExecutor::~ReactReplayExecutor()
+{
+  Q_D(ReactReplayExecutor);
+  if (d->delivered > 0) {
+    qDebug() << "Replay:" << d->delivered << "batches,"
+             << d->totalDispatchUs / d->delivered << "us avg parse+dispatch,"
+             << d->maxDispatchUs << "us max,"
+             << d->batches.size() - d->cursor << "unconsumed";
+  }
+}
+
+void ReactReplayExecutor::init()
+{
+  Q_D(ReactReplayExecutor);
+
+  d->maxSpeed = qgetenv("REACT_REPLAY_SPEED") == "max";
+
+  const QString path = QString::fromLocal8Bit(qgetenv("REACT_REPLAY_FILE"));
+  QFile log(path);
+  if (path.isEmpty() || !log.open(QIODevice::ReadOnly) ||
+      log.read(sizeof(kLogMagic) - 1) != kLogMagic) {
+    qWarning() << __PRETTY_FUNCTION__ << "Could not read replay log" << path;
+    return;
+  }
+
+  QDataStream stream(&log);
+  stream.setVersion(QDataStream::Qt_5_0);
+  while (!stream.atEnd()) {
+    ReactReplayExecutorPrivate::Batch batch;
+    stream >> batch.atMs >> batch.payload;
+    if (stream.status() != QDataStream::Ok)
+      break; // torn tail; the session was cut short while recording
+    d->batches.append(batch);
+  }
+}
+
+void ReactReplayExecutor::injectJson(const QString& name, const QVariant& data)
+{
+  Q_UNUSED(name);
+  Q_UNUSED(data);
+}
+
+void ReactReplayExecutor::injectSerializedJson(const QString& name, const QByteArray& json)
+{
+  Q_UNUSED(name);
+  Q_UNUSED(json);
+}
+
+void ReactReplayExecutor::executeApplicationScript(const QByteArray& script, const QUrl& sourceUrl)
+{
+  Q_UNUSED(script);
+  Q_UNUSED(sourceUrl);
+  Q_D(ReactReplayExecutor);
+  // The recorded session's startup batches stand in for evaluation; the
+  // timeline starts where the live session's replies started flowing.
+  d->clock.start();
+  Q_EMIT applicationScriptDone();
+}
+
+void ReactReplayExecutor::executeJSCall(
+  const QString& method,
+  const QVariantList& args,
+  const ReactExecutor::ExecuteCallback& callback
+) {
+  Q_UNUSED(method);
+  Q_UNUSED(args);
+  Q_D(ReactReplayExecutor);
+
+  if (!callback)
+    return;
+
+  // Each call consumes the next recorded reply; the app's own call pattern
+  // paces consumption, the recorded timeline paces delivery.
+  if (d->cursor >= d->batches.size()) {
+    callback(ReactBridgeValueRef());
+    return;
+  }
+
+  const ReactReplayExecutorPrivate::Batch batch = d->batches.at(d->cursor++);
+  auto deliver = [=] {
+    QElapsedTimer dispatch;
+    dispatch.start();
+    ReactBridgeValueRef result;
+    if (batch.payload != "undefined") {
+      result = reactParseBridgeJson(batch.payload);
+    }
+    callback(result);
+    const qint64 us = dispatch.nsecsElapsed() / 1000;
+    ++d->delivered;
+    d->totalDispatchUs += us;
+    d->maxDispatchUs = qMax(d->maxDispatchUs, us);
+  };
+
+  const qint64 dueInMs = d->maxSpeed ? 0 : batch.atMs - d->clock.elapsed();
+  if (dueInMs <= 0)
+    deliver();
+  else
+    QTimer::singleShot(dueInMs, this, deliver);
+}
@@ -0,0 +1,57 @@
+
+/**
+ * Copyright (C) 2016, Canonical Ltd.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ *
+ * Author: Justin McPherson <justin.mcpherson@canonical.com>
+ *
+ */
+
+#ifndef REACTREPLAYEXECUTOR_H
+#define REACTREPLAYEXECUTOR_H
+
+#include "reactexecutor.h"
+
+
+// Replays a recorded session's bridge traffic through the normal parse and
+// module dispatch path, turning a captured session into a reproducible
+// benchmark. Record by running any live executor with
+// REACT_REPLAY_RECORD=<path>; replay by selecting this executor with
+// executorName and pointing REACT_REPLAY_FILE at the log. Batches are
+// delivered on the recorded timeline, or as fast as the host consumes them
+// with REACT_REPLAY_SPEED=max; per-batch parse and dispatch latency stats
+// are reported when the executor is torn down.
+class ReactReplayExecutorPrivate;
+class ReactReplayExecutor : public ReactExecutor
+{
+  Q_OBJECT
+
+  Q_DECLARE_PRIVATE(ReactReplayExecutor)
+
+public:
+  Q_INVOKABLE ReactReplayExecutor(QObject* parent = 0);
+  ~ReactReplayExecutor();
+
+  void init() override;
+
+  void injectJson(const QString& name, const QVariant& data) override;
+  void injectSerializedJson(const QString& name, const QByteArray& json) override;
+  void executeApplicationScript(const QByteArray& script, const QUrl& sourceUrl) override;
+  void executeJSCall(const QString& method,
+                     const QVariantList& args = QVariantList(),
+                     const ExecuteCallback& callback = ExecuteCallback()) override;
+
+private:
+  QScopedPointer<ReactReplayExecutorPrivate> d_ptr;
+};
+
+// Recording tap for the live executors: appends one reply payload, with its
+// offset on the session timeline, to the log named by REACT_REPLAY_RECORD.
+// No-op (one branch) when recording is off.
+void reactReplayRecord(const QByteArray& replyPayload);
+
+#endif // REACTREPLAYEXECUTOR_H
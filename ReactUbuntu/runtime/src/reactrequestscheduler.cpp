@@ -0,0 +1,149 @@
+
+/**
+ * Copyright (C) 2016, Canonical Ltd.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ *
+ * Author: Justin McPherson <justin.mcpherson@canonical.com>
+ *
+ */
+
+#include <QHash>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QQueue>
+
+#include <QDebug>
+
+#include "reactrequestscheduler.h"
+
+
+namespace
+{
+// Connections a single host may have in flight at once; below Qt's own
+// six-per-host limit so an Interactive request never finds the manager
+// itself saturated. REACT_NET_HOST_CONNECTIONS overrides.
+int hostConnectionLimit()
+{
+  static int limit = 0;
+  if (limit == 0) {
+    limit = qgetenv("REACT_NET_HOST_CONNECTIONS").toInt();
+    if (limit <= 0)
+      limit = 4;
+  }
+  return limit;
+}
+
+QNetworkRequest::Priority wirePriority(ReactRequestScheduler::Priority priority)
+{
+  switch (priority) {
+  case ReactRequestScheduler::Interactive: return QNetworkRequest::HighPriority;
+  case ReactRequestScheduler::Prefetch: return QNetworkRequest::LowPriority;
+  default: return QNetworkRequest::NormalPriority;
+  }
+}
+}
+
+class ReactRequestSchedulerPrivate
+{
+public:
+  struct Pending {
+    QNetworkRequest request;
+    QByteArray verb; // empty means GET
+    QIODevice* body = nullptr;
+    ReactRequestScheduler::StartedHandler handler;
+  };
+
+  bool hostFree(const QString& host) {
+    return activePerHost.value(host) < hostConnectionLimit();
+  }
+
+  void start(const Pending& pending) {
+    const QString host = pending.request.url().host();
+    activePerHost[host]++;
+    QNetworkReply* reply = pending.verb.isEmpty()
+      ? nam->get(pending.request)
+      : nam->sendCustomRequest(pending.request, pending.verb, pending.body);
+    if (pending.body != nullptr) {
+      // The manager reads the device as the socket drains; tie its lifetime
+      // to the reply so it is released exactly when the transfer is done.
+      pending.body->setParent(reply);
+    }
+    QObject::connect(reply, &QNetworkReply::finished, q, [=] {
+      if (--activePerHost[host] == 0)
+        activePerHost.remove(host);
+      dispatch();
+    });
+    if (pending.handler)
+      pending.handler(reply);
+  }
+
+  void dispatch() {
+    // Higher classes drain first; within a class a blocked host does not
+    // hold up requests to other hosts further back in the queue.
+    for (int c = 0; c < ReactRequestScheduler::PriorityCount; ++c) {
+      QQueue<Pending>& queue = queues[c];
+      for (int i = 0; i < queue.size();) {
+        if (!hostFree(queue.at(i).request.url().host())) {
+          ++i;
+          continue;
+        }
+        start(queue.takeAt(i));
+      }
+    }
+  }
+
+  QNetworkAccessManager* nam = nullptr;
+  ReactRequestScheduler* q = nullptr;
+  QQueue<Pending> queues[ReactRequestScheduler::PriorityCount];
+  QHash<QString, int> activePerHost;
+};
+
+
+ReactRequestScheduler::ReactRequestScheduler(QNetworkAccessManager* nam, QObject* parent)
+  : QObject(parent)
+  , d_ptr(new ReactRequestSchedulerPrivate)
+{
+  Q_D(ReactRequestScheduler);
+  d->nam = nam;
+  d->q = this;
+}
+
+ReactRequestScheduler::~ReactRequestScheduler()
+{
+}
+
+void ReactRequestScheduler::get(
+  const QNetworkRequest& request,
+  Priority priority,
+  const StartedHandler& handler
+) {
+  Q_D(ReactRequestScheduler);
+
+  QNetworkRequest prioritized = request;
+  prioritized.setPriority(wirePriority(priority));
+
+  d->queues[priority].enqueue(
+    ReactRequestSchedulerPrivate::Pending{prioritized, QByteArray(), nullptr, handler});
+  d->dispatch();
+}
+
+void ReactRequestScheduler::send(
+  const QNetworkRequest& request,
+  const QByteArray& verb,
+  QIODevice* body,
+  Priority priority,
+  const StartedHandler& handler
+) {
+  Q_D(ReactRequestScheduler);
+
+  QNetworkRequest prioritized = request;
+  prioritized.setPriority(wirePriority(priority));
+  d->queues[priority].enqueue(
+    ReactRequestSchedulerPrivate::Pending{prioritized, verb, body, handler});
+  d->dispatch();
+}
@@ -0,0 +1,75 @@
+
+/**
+ * Copyright (C) 2016, Canonical Ltd.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ *
+ * Author: Justin McPherson <justin.mcpherson@canonical.com>
+ *
+ */
+
+#ifndef REACTREQUESTSCHEDULER_H
+#define REACTREQUESTSCHEDULER_H
+
+#include <functional>
+
+#include <QObject>
+#include <QScopedPointer>
+
+class QIODevice;
+class QNetworkAccessManager;
+class QNetworkReply;
+class QNetworkRequest;
+
+// Priority queue in front of the shared QNetworkAccessManager. Every request
+// from the runtime goes through here; requests beyond the per-host
+// concurrency cap wait in their priority class, and a waiting Interactive
+// request always goes on the wire before queued prefetches, so a feed of
+// image fetches can no longer starve the API call behind a tap.
+class ReactRequestSchedulerPrivate;
+class ReactRequestScheduler : public QObject
+{
+  Q_OBJECT
+  Q_DECLARE_PRIVATE(ReactRequestScheduler)
+
+public:
+  enum Priority {
+    // User is waiting on the result right now (API calls, bundle reload).
+    Interactive = 0,
+    // Content coming on screen (visible images).
+    Normal,
+    // Speculative work; only runs when nothing above wants the host.
+    Prefetch,
+    PriorityCount
+  };
+
+  typedef std::function<void(QNetworkReply*)> StartedHandler;
+
+  ReactRequestScheduler(QNetworkAccessManager* nam, QObject* parent = 0);
+  ~ReactRequestScheduler();
+
+  // Issues the GET immediately when the target host has a free slot,
+  // otherwise parks it; the handler runs with the live reply once the
+  // request is on the wire, and the caller wires its signals there.
+  void get(const QNetworkRequest& request,
+           Priority priority,
+           const StartedHandler& handler);
+
+  // Issues a request with a verb and an optional body device. The device is
+  // read as the socket drains - never buffered whole - and is reparented to
+  // the reply once the request is on the wire, so it lives exactly as long
+  // as the transfer.
+  void send(const QNetworkRequest& request,
+            const QByteArray& verb,
+            QIODevice* body,
+            Priority priority,
+            const StartedHandler& handler);
+
+private:
+  QScopedPointer<ReactRequestSchedulerPrivate> d_ptr;
+};
+
+#endif // REACTREQUESTSCHEDULER_H
@@ -0,0 +1,155 @@
+
+/**
+ * Copyright (C) 2016, Canonical Ltd.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ *
+ * Author: Justin McPherson <justin.mcpherson@canonical.com>
+ *
+ */
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QQuickItem>
+#include <QQuickWindow>
+#include <QTimer>
+
+#include "reactscheduler.h"
+#include "reactbridge.h"
+
+
+namespace
+{
+// Age in milliseconds after which a task of each class runs regardless of
+// remaining budget. Layout apply always runs: geometry the batch already
+// committed must not straddle frames.
+const qint64 deadlineMs[ReactScheduler::TaskClassCount] = { 0, 16, 50, 250 };
+
+// Queued work may take at most half the measured frame interval; the rest
+// belongs to animations and scene graph synchronization. Clamped so a
+// stalled frame cannot hand the next one an enormous budget.
+const qint64 minBudgetMs = 4;
+const qint64 maxBudgetMs = 12;
+}
+
+
+class ReactSchedulerPrivate {
+public:
+  struct Task {
+    std::function<void()> fn;
+    qint64 queuedMs;
+  };
+
+  ReactBridge* bridge = nullptr;
+  QList<Task> queues[ReactScheduler::TaskClassCount];
+  QElapsedTimer clock; // started at construction; all timestamps relative
+  qint64 lastFrameMs = 0;
+  qint64 frameIntervalMs = 16;
+  bool connectedToWindow = false;
+  bool drainQueued = false;
+
+  bool empty() const {
+    for (const QList<Task>& queue : queues) {
+      if (!queue.isEmpty())
+        return false;
+    }
+    return true;
+  }
+};
+
+
+ReactScheduler::ReactScheduler(ReactBridge* bridge)
+  : QObject(bridge)
+  , d_ptr(new ReactSchedulerPrivate)
+{
+  Q_D(ReactScheduler);
+  d->bridge = bridge;
+  d->clock.start();
+}
+
+ReactScheduler::~ReactScheduler()
+{
+}
+
+void ReactScheduler::schedule(TaskClass taskClass, const std::function<void()>& task)
+{
+  Q_D(ReactScheduler);
+
+  d->queues[taskClass].append(ReactSchedulerPrivate::Task{task, d->clock.elapsed()});
+
+  QQuickItem* visualParent = d->bridge->visualParent();
+  QQuickWindow* window = visualParent != nullptr ? visualParent->window() : nullptr;
+  if (window == nullptr) {
+    // No frame to pace against until the root view is on screen; drain on
+    // the next loop pass instead.
+    if (!d->drainQueued) {
+      d->drainQueued = true;
+      QTimer::singleShot(0, this, SLOT(runTasks()));
+    }
+    return;
+  }
+
+  if (!d->connectedToWindow) {
+    // afterAnimating runs on the GUI thread once per frame, just before
+    // synchronizing with the render thread.
+    connect(window, SIGNAL(afterAnimating()), this, SLOT(runTasks()));
+    d->connectedToWindow = true;
+  }
+
+  // Make sure a frame, and with it a drain, is actually coming.
+  window->update();
+}
+
+void ReactScheduler::runTasks()
+{
+  Q_D(ReactScheduler);
+
+  d->drainQueued = false;
+
+  // Budget off the observed frame spacing, not a hardcoded 60Hz; the smoothed
+  // interval tracks 50Hz panels and halved rates under load.
+  const qint64 now = d->clock.elapsed();
+  if (d->lastFrameMs != 0) {
+    const qint64 interval = now - d->lastFrameMs;
+    if (interval > 0 && interval < 100)
+      d->frameIntervalMs = (3 * d->frameIntervalMs + interval) / 4;
+  }
+  d->lastFrameMs = now;
+  const qint64 budgetMs = qBound(minBudgetMs, d->frameIntervalMs / 2, maxBudgetMs);
+
+  QElapsedTimer spent;
+  spent.start();
+  for (int c = 0; c < TaskClassCount; ++c) {
+    QList<ReactSchedulerPrivate::Task>& queue = d->queues[c];
+    while (!queue.isEmpty()) {
+      // A task past its class's deadline runs even over budget; otherwise
+      // it carries over to the next frame.
+      if (spent.elapsed() >= budgetMs &&
+          now - queue.first().queuedMs < deadlineMs[c])
+        break;
+      // Take the task off before running it; tasks may schedule follow-ups
+      // into the same class.
+      ReactSchedulerPrivate::Task task = queue.takeFirst();
+      task.fn();
+    }
+  }
+
+  const qint64 spentMs = spent.elapsed();
+  if (d->empty() && spentMs < budgetMs)
+    Q_EMIT idle(budgetMs - spentMs);
+
+  if (!d->empty()) {
+    // Carried-over work still needs a frame to run in.
+    QQuickItem* visualParent = d->bridge->visualParent();
+    QQuickWindow* window = visualParent != nullptr ? visualParent->window() : nullptr;
+    if (window != nullptr) {
+      window->update();
+    } else if (!d->drainQueued) {
+      d->drainQueued = true;
+      QTimer::singleShot(0, this, SLOT(runTasks()));
+    }
+  }
+}
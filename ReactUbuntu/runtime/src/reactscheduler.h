@@ -0,0 +1,64 @@
+
+/**
+ * Copyright (C) 2016, Canonical Ltd.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ *
+ * Author: Justin McPherson <justin.mcpherson@canonical.com>
+ *
+ */
+
+#ifndef REACTSCHEDULER_H
+#define REACTSCHEDULER_H
+
+#include <functional>
+
+#include <QObject>
+#include <QScopedPointer>
+
+class ReactBridge;
+
+class ReactSchedulerPrivate;
+class ReactScheduler : public QObject
+{
+  Q_OBJECT
+  Q_DECLARE_PRIVATE(ReactScheduler)
+
+public:
+  // Task classes in drain order. Each class has a deadline: once a queued
+  // task is older than its class's deadline it runs even when the frame
+  // budget is spent, so low-priority work degrades to "late" rather than
+  // "starved".
+  enum TaskClass {
+    LayoutApply = 0,    // geometry must land before the frame it belongs to
+    EventDispatch,      // input feedback; a frame late is visible jank
+    DecodeHandoff,      // queuing decodes; a few frames late only delays pixels
+    CacheMaintenance,   // warm-ups and trims; pure idle-time work
+    TaskClassCount
+  };
+
+  ReactScheduler(ReactBridge* bridge);
+  ~ReactScheduler();
+
+  // Queues a task and makes sure a drain is coming, paced against the root
+  // window's render loop when one is on screen. Tasks of one class run in
+  // the order they were scheduled.
+  void schedule(TaskClass taskClass, const std::function<void()>& task);
+
+Q_SIGNALS:
+  // Emitted at the end of a frame's drain when every queue is empty and
+  // budget is left over; remainingMs is how much of this frame's budget went
+  // unused. ReactTiming forwards it to JS as the requestIdleCallback window.
+  void idle(qint64 remainingMs);
+
+private Q_SLOTS:
+  void runTasks();
+
+private:
+  QScopedPointer<ReactSchedulerPrivate> d_ptr;
+};
+
+#endif // REACTSCHEDULER_H
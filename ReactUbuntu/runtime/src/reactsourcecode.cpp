@@ -11,16 +11,39 @@
  *
  */
 
+#include <cstring>
 #include <memory>
 
+#include <QFile>
 #include <QNetworkAccessManager>
 #include <QNetworkRequest>
 #include <QNetworkReply>
+#include <QSaveFile>
+#include <QSettings>
+#include <QStandardPaths>
 #include <QTimer>
+#include <QtEndian>
 
 #include "reactsourcecode.h"
 
 
+namespace {
+
+// Stable FNV-1a 64 of the bundle bytes; must match the hash the delta packer
+// records (the same function the Android loader uses for its source cache).
+quint64 hashBundle(const char* data, int size)
+{
+  quint64 hash = 14695981039346656037ULL;
+  for (int i = 0; i < size; ++i) {
+    hash ^= static_cast<uchar>(data[i]);
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+} // namespace
+
+
 class ReactSourceCodePrivate
 {
 public:
@@ -30,6 +53,134 @@ public:
   int retryCount = 4;
   int retryAttempts = 0;
   int retryTimeout = 250;
+
+  // On-disk bundle cache. The loaded bundle is memory-mapped from here, so
+  // the executor serializes straight out of the mapping instead of a heap
+  // copy, and the stored ETag lets an unchanged bundle revalidate with one
+  // bodyless round trip.
+  QFile bundleFile;
+  uchar* mappedBundle = nullptr;
+  QByteArray cachedEtag;
+  quint64 cachedBundleHash = 0;
+
+  QString cachePath() const {
+    const QString dir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    return dir.isEmpty() ? QString() : dir + "/react-bundle.js";
+  }
+
+  QString metaPath() const {
+    const QString dir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    return dir.isEmpty() ? QString() : dir + "/react-bundle.meta";
+  }
+
+  void readMeta() {
+    cachedEtag.clear();
+    cachedBundleHash = 0;
+    if (metaPath().isEmpty())
+      return;
+    QSettings meta(metaPath(), QSettings::IniFormat);
+    if (meta.value("url").toString() == scriptUrl.toString()) {
+      cachedEtag = meta.value("etag").toByteArray();
+      cachedBundleHash = meta.value("hash").toString().toULongLong(nullptr, 16);
+    }
+  }
+
+  void writeMeta() {
+    if (metaPath().isEmpty())
+      return;
+    QSettings meta(metaPath(), QSettings::IniFormat);
+    meta.setValue("url", scriptUrl.toString());
+    meta.setValue("etag", cachedEtag);
+    meta.setValue("hash", QString::number(cachedBundleHash, 16));
+  }
+
+  bool mapCachedBundle() {
+    if (mappedBundle != nullptr) {
+      bundleFile.unmap(mappedBundle);
+      mappedBundle = nullptr;
+    }
+    if (bundleFile.isOpen())
+      bundleFile.close();
+
+    bundleFile.setFileName(cachePath());
+    if (!bundleFile.open(QIODevice::ReadOnly))
+      return false;
+
+    mappedBundle = bundleFile.map(0, bundleFile.size());
+    if (mappedBundle != nullptr) {
+      sourceCode = QByteArray::fromRawData(reinterpret_cast<const char*>(mappedBundle),
+                                           bundleFile.size());
+    } else {
+      sourceCode = bundleFile.readAll();
+    }
+    cachedBundleHash = hashBundle(sourceCode.constData(), sourceCode.size());
+    return true;
+  }
+
+  // Applies a binary bundle delta against the cached bundle and replaces the
+  // cache with the patched result. The wire format is shared with the Android
+  // loader's BundleDelta: a 0xFB0BDE17 magic, the base and result hashes and
+  // the result size (all little-endian), then copy ops ([u8 0][u64 base
+  // offset][u32 length]) and insert ops ([u8 1][u32 length][bytes]) until end
+  // of payload. Both the base and the patched output are hash-verified, and
+  // QSaveFile keeps the previous cache intact unless the whole apply
+  // succeeds, so a bad or mismatched delta leaves the cache untouched.
+  bool applyDelta(const QByteArray& delta) {
+    QFile base(cachePath());
+    if (!base.open(QIODevice::ReadOnly))
+      return false;
+    const QByteArray baseBytes = base.readAll();
+
+    const char* p = delta.constData();
+    const char* end = p + delta.size();
+    auto remaining = [&]() { return static_cast<quint64>(end - p); };
+    auto readU32 = [&]() { quint32 v; memcpy(&v, p, 4); p += 4; return quint32(qFromLittleEndian(v)); };
+    auto readU64 = [&]() { quint64 v; memcpy(&v, p, 8); p += 8; return quint64(qFromLittleEndian(v)); };
+
+    if (remaining() < 28 || readU32() != 0xFB0BDE17)
+      return false;
+    const quint64 baseHash = readU64();
+    const quint64 resultHash = readU64();
+    const quint64 resultSize = readU64();
+
+    if (hashBundle(baseBytes.constData(), baseBytes.size()) != baseHash)
+      return false;
+
+    QByteArray patched;
+    patched.reserve(resultSize);
+    while (p < end) {
+      const char op = *p++;
+      if (op == 0) {
+        if (remaining() < 12)
+          return false;
+        const quint64 offset = readU64();
+        const quint32 length = readU32();
+        if (offset > quint64(baseBytes.size()) || length > quint64(baseBytes.size()) - offset)
+          return false;
+        patched.append(baseBytes.constData() + offset, length);
+      } else if (op == 1) {
+        if (remaining() < 4)
+          return false;
+        const quint32 length = readU32();
+        if (remaining() < length)
+          return false;
+        patched.append(p, length);
+        p += length;
+      } else {
+        return false;
+      }
+    }
+
+    if (quint64(patched.size()) != resultSize ||
+        hashBundle(patched.constData(), patched.size()) != resultHash)
+      return false;
+
+    QSaveFile out(cachePath());
+    if (!out.open(QIODevice::WriteOnly))
+      return false;
+    out.write(patched);
+    return out.commit();
+  }
 };
 
 
@@ -119,8 +270,43 @@ void ReactSourceCode::loadSource(QNetworkAccessManager* nam)
 {
   Q_D(ReactSourceCode);
 
+  d->readMeta();
+
   QNetworkRequest request(d->scriptUrl);
+  // The access manager negotiates gzip/deflate itself and delivers the body
+  // already decompressed as it streams in; all that is left to add is the
+  // validator, which turns an unchanged bundle into a 304 with no body.
+  if (!d->cachedEtag.isEmpty() && QFile::exists(d->cachePath()))
+    request.setRawHeader("If-None-Match", d->cachedEtag);
+  // Advertise the cached bundle's hash so the server can answer a changed
+  // bundle with a binary delta against it instead of the full body; a server
+  // without a delta for that base just sends the full bundle as usual.
+  if (d->cachedBundleHash != 0 && QFile::exists(d->cachePath()))
+    request.setRawHeader("X-React-Bundle-Delta-Base",
+                         QByteArray::number(d->cachedBundleHash, 16));
+
   QNetworkReply* reply = nam->get(request);
+
+  auto cacheFile = std::make_shared<QSaveFile>(d->cachePath());
+  if (d->cachePath().isEmpty() || !cacheFile->open(QIODevice::WriteOnly))
+    cacheFile.reset();
+
+  auto deltaBuffer = std::make_shared<QByteArray>();
+
+  if (cacheFile != nullptr) {
+    // Spool to disk as chunks arrive instead of buffering the whole bundle
+    // in the reply; QSaveFile keeps the previous copy intact until commit.
+    // A delta reply is buffered in memory instead — it is an order of
+    // magnitude smaller than the bundle, and it must not touch the cache
+    // file it patches against.
+    QObject::connect(reply, &QNetworkReply::readyRead, [=] {
+        if (reply->rawHeader("X-React-Bundle-Delta") == "1")
+          deltaBuffer->append(reply->readAll());
+        else
+          cacheFile->write(reply->readAll());
+      });
+  }
+
   QObject::connect(reply, &QNetworkReply::finished, [=]() {
       reply->deleteLater();
       if (reply->error() != QNetworkReply::NoError) {
@@ -134,7 +320,53 @@ void ReactSourceCode::loadSource(QNetworkAccessManager* nam)
         }
         return;
       }
-      d->sourceCode = reply->readAll();
+
+      const int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+      if (status == 304 && d->mapCachedBundle()) {
+        // Not modified; run straight off the cached copy.
+        d->retryAttempts = 0;
+        d->retryTimeout = 250;
+        Q_EMIT sourceCodeChanged();
+        return;
+      }
+
+      if (reply->rawHeader("X-React-Bundle-Delta") == "1") {
+        deltaBuffer->append(reply->readAll());
+        if (d->applyDelta(*deltaBuffer) && d->mapCachedBundle()) {
+          d->cachedEtag = reply->rawHeader("ETag");
+          d->writeMeta();
+          d->retryAttempts = 0;
+          d->retryTimeout = 250;
+          Q_EMIT sourceCodeChanged();
+          return;
+        }
+        // Bad delta or a base the server mispredicted; drop the advertised
+        // hash so the retry fetches the full bundle.
+        qWarning() << __PRETTY_FUNCTION__ << ": Bundle delta failed to apply, refetching full bundle";
+        d->cachedBundleHash = 0;
+        d->writeMeta();
+        if (d->retryAttempts < d->retryCount) {
+          d->retryAttempts++;
+          QTimer::singleShot(0, [=] { loadSource(nam); });
+        } else {
+          Q_EMIT loadFailed();
+        }
+        return;
+      }
+
+      if (cacheFile != nullptr) {
+        cacheFile->write(reply->readAll());
+        if (cacheFile->commit())
+          d->cachedEtag = reply->rawHeader("ETag");
+      }
+      if (cacheFile == nullptr || !d->mapCachedBundle()) {
+        // No usable cache location; keep the bundle in memory as before.
+        d->sourceCode = reply->readAll();
+      } else {
+        // Written after mapping so the meta records the new bundle's hash
+        // for the next delta negotiation.
+        d->writeMeta();
+      }
       d->retryAttempts = 0;
       d->retryTimeout = 250;
       Q_EMIT sourceCodeChanged();
@@ -0,0 +1,318 @@
+
+/**
+ * Copyright (C) 2016, Canonical Ltd.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ *
+ * Author: Justin McPherson <justin.mcpherson@canonical.com>
+ *
+ */
+
+#include <algorithm>
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include <QDebug>
+
+#include "reactsourcemap.h"
+#include "reactjsonvalue.h"
+
+
+namespace {
+const quint32 kIndexMagic = 0x524d4150; // 'RMAP'
+const quint32 kIndexVersion = 1;
+
+int base64Value(char c)
+{
+  if (c >= 'A' && c <= 'Z')
+    return c - 'A';
+  if (c >= 'a' && c <= 'z')
+    return c - 'a' + 26;
+  if (c >= '0' && c <= '9')
+    return c - '0' + 52;
+  if (c == '+')
+    return 62;
+  if (c == '/')
+    return 63;
+  return -1;
+}
+}
+
+
+ReactSourceMap::ReactSourceMap(QObject* parent)
+  : QObject(parent)
+  , m_ready(false)
+  , m_loading(false)
+  , m_failed(false)
+  , m_mappedRecords(nullptr)
+  , m_mappedCount(0)
+{
+}
+
+ReactSourceMap::~ReactSourceMap()
+{
+}
+
+bool ReactSourceMap::ready() const
+{
+  return m_ready;
+}
+
+void ReactSourceMap::loadForBundle(const QUrl& bundleUrl, QNetworkAccessManager* nam)
+{
+  if (m_ready || m_loading || m_failed || nam == nullptr)
+    return;
+  m_loading = true;
+
+  QUrl mapUrl = bundleUrl;
+  QString path = mapUrl.path();
+  const int mi = path.lastIndexOf(".bundle");
+  if (mi != -1) {
+    path = path.left(mi) + ".map";
+  } else {
+    path += ".map";
+  }
+  mapUrl.setPath(path);
+
+  QNetworkReply* reply = nam->get(QNetworkRequest(mapUrl));
+  connect(reply, &QNetworkReply::finished, [=] {
+    reply->deleteLater();
+    m_loading = false;
+    if (reply->error() != QNetworkReply::NoError) {
+      qWarning() << __PRETTY_FUNCTION__ << "Could not fetch source map" << mapUrl;
+      m_failed = true;
+      return;
+    }
+
+    // The checksum ties the persisted index to this exact map; a changed
+    // bundle invalidates it and triggers a fresh decode.
+    const QByteArray mapJson = reply->readAll();
+    const QByteArray checksum = QCryptographicHash::hash(mapJson, QCryptographicHash::Md5);
+    if (!loadFromCache(checksum)) {
+      buildIndex(mapJson);
+      writeCache(checksum);
+    }
+    m_ready = true;
+    Q_EMIT loaded();
+  });
+}
+
+void ReactSourceMap::buildIndex(const QByteArray& mapJson)
+{
+  const QVariantMap map = reactParseJson(mapJson).toMap();
+  m_sources = map.value("sources").toStringList();
+  m_names = map.value("names").toStringList();
+
+  const QByteArray mappings = map.value("mappings").toByteArray();
+  m_records.clear();
+
+  // Segment fields are base64 VLQ deltas against the previous segment;
+  // generated column resets per line, the source side carries across lines.
+  qint32 generatedLine = 1;
+  qint32 generatedColumn = 0;
+  qint32 sourceIndex = 0;
+  qint32 sourceLine = 0;
+  qint32 sourceColumn = 0;
+  qint32 nameIndex = 0;
+
+  qint32 fields[5];
+  int fieldCount = 0;
+  quint32 value = 0;
+  int shift = 0;
+
+  auto flushSegment = [&] {
+    if (fieldCount == 0)
+      return;
+    generatedColumn += fields[0];
+    if (fieldCount >= 4) {
+      sourceIndex += fields[1];
+      sourceLine += fields[2];
+      sourceColumn += fields[3];
+
+      Record record;
+      record.generatedLine = generatedLine;
+      record.generatedColumn = generatedColumn;
+      record.sourceIndex = sourceIndex;
+      record.sourceLine = sourceLine + 1; // 0-based in the map
+      record.sourceColumn = sourceColumn;
+      if (fieldCount >= 5) {
+        nameIndex += fields[4];
+        record.nameIndex = nameIndex;
+      } else {
+        record.nameIndex = -1;
+      }
+      m_records.append(record);
+    }
+    fieldCount = 0;
+  };
+
+  for (int i = 0; i < mappings.size(); ++i) {
+    const char c = mappings.at(i);
+    if (c == ';') {
+      flushSegment();
+      ++generatedLine;
+      generatedColumn = 0;
+      continue;
+    }
+    if (c == ',') {
+      flushSegment();
+      continue;
+    }
+
+    const int digit = base64Value(c);
+    if (digit < 0)
+      continue;
+    if (shift < 32) {
+      value |= quint32(digit & 0x1f) << shift;
+    }
+    // else: 7+ continuation digits can only come from a corrupted mappings
+    // string, and shifting past the word is undefined; stop accumulating
+    // and resynchronize at the run's terminating digit.
+    if (digit & 0x20) {
+      if (shift < 32)
+        shift += 5;
+      continue;
+    }
+    const qint32 signedValue = (value & 1) ? -qint32(value >> 1) : qint32(value >> 1);
+    if (fieldCount < 5)
+      fields[fieldCount] = signedValue;
+    ++fieldCount;
+    value = 0;
+    shift = 0;
+  }
+  flushSegment();
+}
+
+QString ReactSourceMap::cachePath() const
+{
+  const QString dir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+  if (dir.isEmpty())
+    return QString();
+  return dir + "/react-sourcemap.index";
+}
+
+void ReactSourceMap::writeCache(const QByteArray& checksum)
+{
+  const QString path = cachePath();
+  if (path.isEmpty())
+    return;
+  QDir().mkpath(QFileInfo(path).path());
+
+  QSaveFile out(path);
+  if (!out.open(QIODevice::WriteOnly))
+    return;
+
+  QDataStream stream(&out);
+  stream.setVersion(QDataStream::Qt_5_0);
+  stream << kIndexMagic << kIndexVersion << checksum << m_sources << m_names
+         << quint32(m_records.size());
+  // Pad so the raw record array lands aligned for the mmap'ed reader.
+  while (out.pos() % 8)
+    stream << quint8(0);
+  out.write(reinterpret_cast<const char*>(m_records.constData()),
+            m_records.size() * sizeof(Record));
+  out.commit();
+}
+
+bool ReactSourceMap::loadFromCache(const QByteArray& checksum)
+{
+  const QString path = cachePath();
+  if (path.isEmpty())
+    return false;
+
+  m_cacheFile.reset(new QFile(path));
+  if (!m_cacheFile->open(QIODevice::ReadOnly)) {
+    m_cacheFile.reset();
+    return false;
+  }
+
+  QDataStream stream(m_cacheFile.data());
+  stream.setVersion(QDataStream::Qt_5_0);
+  quint32 magic = 0;
+  quint32 version = 0;
+  quint32 count = 0;
+  QByteArray cachedChecksum;
+  stream >> magic >> version >> cachedChecksum;
+  if (stream.status() != QDataStream::Ok ||
+      magic != kIndexMagic || version != kIndexVersion ||
+      cachedChecksum != checksum) {
+    m_cacheFile.reset();
+    return false;
+  }
+  stream >> m_sources >> m_names >> count;
+  while (m_cacheFile->pos() % 8) {
+    quint8 pad;
+    stream >> pad;
+  }
+  const qint64 offset = m_cacheFile->pos();
+  if (stream.status() != QDataStream::Ok ||
+      m_cacheFile->size() - offset < qint64(count) * qint64(sizeof(Record))) {
+    m_cacheFile.reset();
+    return false;
+  }
+
+  uchar* mapped = m_cacheFile->map(offset, qint64(count) * qint64(sizeof(Record)));
+  if (mapped == nullptr) {
+    m_cacheFile.reset();
+    return false;
+  }
+  m_mappedRecords = reinterpret_cast<const Record*>(mapped);
+  m_mappedCount = count;
+  return true;
+}
+
+const ReactSourceMap::Record* ReactSourceMap::recordsBegin() const
+{
+  return m_mappedRecords != nullptr ? m_mappedRecords : m_records.constData();
+}
+
+const ReactSourceMap::Record* ReactSourceMap::recordsEnd() const
+{
+  return m_mappedRecords != nullptr ? m_mappedRecords + m_mappedCount
+                                    : m_records.constData() + m_records.size();
+}
+
+QVariantMap ReactSourceMap::resolveFrame(int line, int column) const
+{
+  const Record* begin = recordsBegin();
+  const Record* end = recordsEnd();
+  if (begin == end)
+    return QVariantMap{};
+
+  Record probe;
+  probe.generatedLine = line;
+  probe.generatedColumn = column;
+  const Record* it = std::upper_bound(begin, end, probe,
+    [](const Record& a, const Record& b) {
+      return a.generatedLine != b.generatedLine
+                 ? a.generatedLine < b.generatedLine
+                 : a.generatedColumn < b.generatedColumn;
+    });
+  if (it == begin)
+    return QVariantMap{};
+  --it;
+  // A mapping only covers positions on its own generated line.
+  if (it->generatedLine != line)
+    return QVariantMap{};
+
+  QVariantMap rc;
+  if (it->sourceIndex >= 0 && it->sourceIndex < m_sources.size())
+    rc.insert("file", m_sources.at(it->sourceIndex));
+  rc.insert("lineNumber", it->sourceLine);
+  rc.insert("column", it->sourceColumn);
+  if (it->nameIndex >= 0 && it->nameIndex < m_names.size())
+    rc.insert("methodName", m_names.at(it->nameIndex));
+  return rc;
+}
@@ -0,0 +1,88 @@
+
+/**
+ * Copyright (C) 2016, Canonical Ltd.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ *
+ * Author: Justin McPherson <justin.mcpherson@canonical.com>
+ *
+ */
+
+#ifndef REACTSOURCEMAP_H
+#define REACTSOURCEMAP_H
+
+#include <QObject>
+#include <QScopedPointer>
+#include <QStringList>
+#include <QUrl>
+#include <QVariant>
+#include <QVector>
+
+
+class QFile;
+class QNetworkAccessManager;
+
+
+// Symbolication index for the bundle's source map. The map is fetched once,
+// its VLQ mappings decoded into a flat record table binary-searchable by
+// generated (line, column), and the table persisted beside the bundle's
+// network cache; subsequent sessions memory-map the decoded table instead of
+// parsing the map again.
+class ReactSourceMap : public QObject
+{
+  Q_OBJECT
+
+public:
+  ReactSourceMap(QObject* parent = 0);
+  ~ReactSourceMap();
+
+  bool ready() const;
+
+  // Fetches and indexes the source map the packager serves for bundleUrl
+  // (foo.bundle -> foo.map). Emits loaded() once frames can be resolved; a
+  // fetch failure (e.g. a pre-bundled app with no map) is remembered and not
+  // retried.
+  void loadForBundle(const QUrl& bundleUrl, QNetworkAccessManager* nam);
+
+  // Resolves a generated position to {file, lineNumber, column, methodName};
+  // returns an empty map when no mapping covers the position.
+  QVariantMap resolveFrame(int line, int column) const;
+
+Q_SIGNALS:
+  void loaded();
+
+private:
+  struct Record {
+    qint32 generatedLine;
+    qint32 generatedColumn;
+    qint32 sourceIndex;
+    qint32 sourceLine;
+    qint32 sourceColumn;
+    qint32 nameIndex;
+  };
+
+  void buildIndex(const QByteArray& mapJson);
+  bool loadFromCache(const QByteArray& checksum);
+  void writeCache(const QByteArray& checksum);
+  QString cachePath() const;
+  const Record* recordsBegin() const;
+  const Record* recordsEnd() const;
+
+  bool m_ready;
+  bool m_loading;
+  bool m_failed;
+  QStringList m_sources;
+  QStringList m_names;
+  QVector<Record> m_records;
+
+  // When the decoded table was loaded from the on-disk cache it is served
+  // straight from the mapping; m_records stays empty.
+  QScopedPointer<QFile> m_cacheFile;
+  const Record* m_mappedRecords;
+  quint32 m_mappedCount;
+};
+
+#endif // REACTSOURCEMAP_H
@@ -81,16 +81,18 @@ bool ReactTextManager::shouldLayout() const
   return true;
 }
 
-QQuickItem* ReactTextManager::view(const QVariantMap& properties) const
+QByteArray ReactTextManager::componentSource() const
 {
-  QString componentString = QString(component_qml);
+  return QByteArray(component_qml);
+}
 
-  QQmlComponent component(m_bridge->qmlEngine());
-  component.setData(componentString.toLocal8Bit(), QUrl());
-  if (!component.isReady())
-    qCritical() << "Component for RCTTextManager not ready" << component.errors();
+QQuickItem* ReactTextManager::view(const QVariantMap& properties) const
+{
+  QQmlComponent* component = m_bridge->componentForSource(componentSource());
+  if (!component->isReady())
+    qCritical() << "Component for RCTTextManager not ready" << component->errors();
 
-  QQuickItem* item = qobject_cast<QQuickItem*>(component.create());
+  QQuickItem* item = qobject_cast<QQuickItem*>(component->create());
   if (item == nullptr) {
     qCritical() << "Unable to create component for RCTTextManager";
     return nullptr;
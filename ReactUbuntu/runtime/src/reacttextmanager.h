@@ -40,6 +40,8 @@ public:
   bool shouldLayout() const override;
 
   QQuickItem* view(const QVariantMap& properties) const override;
+
+  QByteArray componentSource() const override;
 };
 
 #endif // REACTTEXTMANAGER_H
@@ -11,13 +11,22 @@
  *
  */
 
+#include <cmath>
+#include <limits>
 #include <map>
 
+#include <QCache>
+#include <QFont>
+#include <QMutex>
+#include <QMutexLocker>
 #include <QQuickItem>
+#include <QTextLayout>
+#include <QTextOption>
 
 #include <QDebug>
 
 #include "reacttextproperties.h"
+#include "reactcachestats.h"
 #include "reactrawtextproperties.h"
 #include "reactflexlayout.h"
 
@@ -38,6 +47,69 @@ const char* k_text_decoration_style = "textDecorationStyle";
 const char* k_text_decoration_color = "textDecorationColor";
 const char* k_writing_direction = "textDecorationColor";
 const char* k_number_of_lines = "numberOfLines";
+
+struct TextMeasurement {
+  float width;
+  float height;
+};
+
+const int kMeasureCacheEntries = 4096;
+
+// Shaping through QTextLayout measures without touching the QML scene
+// graph, which makes it safe on the async layout worker.
+TextMeasurement shapeText(const QString& text, const QFont& font, double width)
+{
+  QTextLayout textLayout(text, font);
+  QTextOption option = textLayout.textOption();
+  option.setWrapMode(QTextOption::WordWrap);
+  textLayout.setTextOption(option);
+
+  const qreal lineWidth = std::isnan(width) ? std::numeric_limits<qreal>::max() : width;
+  qreal height = 0;
+  qreal widest = 0;
+  textLayout.beginLayout();
+  forever {
+    QTextLine line = textLayout.createLine();
+    if (!line.isValid())
+      break;
+    line.setLineWidth(lineWidth);
+    line.setPosition(QPointF(0, height));
+    height += line.height();
+    widest = qMax(widest, line.naturalTextWidth());
+  }
+  textLayout.endLayout();
+
+  return TextMeasurement{ float(widest), float(height) };
+}
+
+// Measurements are shared through a bounded LRU cache so a long list full
+// of identical labels shapes each distinct one once per width constraint.
+TextMeasurement measureText(const QString& text, const QFont& font, double width)
+{
+  static QCache<QString, TextMeasurement> cache(kMeasureCacheEntries);
+  static QMutex mutex;
+
+  ReactCacheCounters* stats = reactCacheCounters("text.measure");
+  const QString key = text + QChar(0x1f) + font.key() + QChar(0x1f) + QString::number(width);
+  {
+    QMutexLocker locker(&mutex);
+    TextMeasurement* cached = cache.object(key);
+    if (cached != nullptr) {
+      stats->hits.fetch_add(1, std::memory_order_relaxed);
+      return *cached;
+    }
+  }
+  stats->misses.fetch_add(1, std::memory_order_relaxed);
+
+  TextMeasurement measurement = shapeText(text, font, width);
+
+  QMutexLocker locker(&mutex);
+  const int before = cache.count();
+  cache.insert(key, new TextMeasurement(measurement));
+  stats->evictions.fetch_add(qMax(0, before + 1 - cache.count()),
+                             std::memory_order_relaxed);
+  return measurement;
+}
 }
 
 class ReactTextPropertiesPrivate
@@ -47,28 +119,35 @@ public:
   bool dirty;
   property_map properties;
   QQuickItem* item;
+  QString measuredText;
+  QFont measuredFont;
 
   void setupLayout() {
     ReactFlexLayout* fl = ReactFlexLayout::get(item);
+    // Text assembly and font resolution touch the item, so they happen on
+    // the GUI thread before the pass; the measure itself only shapes the
+    // snapshot and can run on the layout worker.
+    fl->setPrepareFunction([=] {
+      if (!dirty)
+        return;
+      QString ts = textWithProperties(property_map());
+      item->setProperty("text", ts);
+      measuredText = ts;
+      measuredFont = item->property("font").value<QFont>();
+      dirty = false;
+    });
     fl->setMeasureFunction([=](double width, FlexMeasureMode widthMode, double height, FlexMeasureMode heightMode) {
-      if (dirty) {
-        QString ts = textWithProperties(property_map());
-        item->setProperty("text", ts);
-        dirty = false;
-      }
-      double contentWidth = item->property("contentWidth").value<double>();
+      TextMeasurement tm = measureText(measuredText, measuredFont, width);
       double sw = 0;
       if (std::isnan(width)) {
-        sw = contentWidth;
+        sw = tm.width;
       } else {
-        sw = contentWidth == 0 ? width : qMin(contentWidth, width);
+        sw = tm.width == 0 ? width : qMin(double(tm.width), width);
       }
 
-      item->setWidth(sw);
-
-      return std::make_pair(float(sw),
-                            item->property("contentHeight").value<float>());
+      return std::make_pair(float(sw), tm.height);
     });
+    fl->setMeasureThreadSafe(true);
   }
 
   template<typename VT>
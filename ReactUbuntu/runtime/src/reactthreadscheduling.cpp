@@ -0,0 +1,192 @@
+
+/**
+ * Copyright (C) 2016, Canonical Ltd.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ *
+ * Author: Justin McPherson <justin.mcpherson@canonical.com>
+ *
+ */
+
+#include <errno.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QSet>
+#include <QTimer>
+#include <QVariantList>
+
+#include <QDebug>
+
+#include "reactthreadscheduling.h"
+
+
+namespace {
+
+QMutex configLock;
+QVariantMap schedulingConfig;
+bool configLoaded = false;
+// One placement record per (class, tid); the decode pool re-applies on
+// every job, which must not multiply the report.
+QSet<QString> recordedThreads;
+QMap<QString, QVariantList> placements;
+
+qint64 currentTid()
+{
+  return qint64(syscall(SYS_gettid));
+}
+
+int niceForPriority(const QVariant& priority, bool* ok)
+{
+  *ok = true;
+  bool numeric = false;
+  const int value = priority.toInt(&numeric);
+  if (numeric)
+    return value;
+
+  const QString name = priority.toString();
+  if (name == "background") return 10;
+  if (name == "low") return 5;
+  if (name == "normal") return 0;
+  if (name == "high") return -5;
+  if (name == "interactive") return -10;
+  *ok = false;
+  return 0;
+}
+
+QVariantMap classConfig(const char* threadClass)
+{
+  QMutexLocker locker(&configLock);
+  if (!configLoaded) {
+    configLoaded = true;
+    const QByteArray env = qgetenv("REACT_THREAD_SCHEDULING");
+    if (!env.isEmpty())
+      schedulingConfig = QJsonDocument::fromJson(env).object().toVariantMap();
+  }
+  return schedulingConfig.value(threadClass).toMap();
+}
+
+void recordPlacement(const char* threadClass, qint64 tid, const QString& result)
+{
+  QVariantMap entry{{"tid", tid}, {"result", result}};
+  errno = 0;
+  const int niceValue = getpriority(PRIO_PROCESS, id_t(tid));
+  if (errno == 0)
+    entry["nice"] = niceValue;
+
+  cpu_set_t cpus;
+  if (sched_getaffinity(pid_t(tid), sizeof(cpus), &cpus) == 0) {
+    QVariantList allowed;
+    for (int i = 0; i < CPU_SETSIZE; ++i) {
+      if (CPU_ISSET(i, &cpus))
+        allowed.append(i);
+    }
+    entry["cpus"] = allowed;
+  }
+
+  QMutexLocker locker(&configLock);
+  placements[threadClass].append(entry);
+}
+
+} // namespace
+
+
+void reactSetThreadSchedulingConfig(const QVariantMap& config)
+{
+  QMutexLocker locker(&configLock);
+  schedulingConfig = config;
+  configLoaded = true;
+}
+
+void reactApplyThreadScheduling(const char* threadClass)
+{
+  const QVariantMap config = classConfig(threadClass);
+  if (config.isEmpty())
+    return;
+
+  const qint64 tid = currentTid();
+  {
+    QMutexLocker locker(&configLock);
+    const QString key = QString::fromLatin1(threadClass) + ":" + QString::number(tid);
+    if (recordedThreads.contains(key))
+      return;
+    recordedThreads.insert(key);
+  }
+
+  QString result;
+  if (config.contains("priority")) {
+    bool ok = false;
+    const int niceValue = niceForPriority(config.value("priority"), &ok);
+    if (!ok) {
+      result += "priority-unknown;";
+    } else {
+      // Raising priority (negative nice) needs CAP_SYS_NICE; a denial is
+      // expected on stock desktops and recorded rather than fatal.
+      result += setpriority(PRIO_PROCESS, id_t(tid), niceValue) == 0
+        ? "priority-applied;" : "priority-denied;";
+    }
+  }
+
+  if (config.contains("affinity")) {
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    for (const QVariant& cpu : config.value("affinity").toList()) {
+      const int index = cpu.toInt();
+      if (index >= 0 && index < CPU_SETSIZE)
+        CPU_SET(index, &cpus);
+    }
+    result += CPU_COUNT(&cpus) > 0 && sched_setaffinity(pid_t(tid), sizeof(cpus), &cpus) == 0
+      ? "affinity-applied;" : "affinity-denied;";
+  }
+
+  recordPlacement(threadClass, tid, result);
+}
+
+void reactApplyThreadScheduling(const char* threadClass, QThread* thread)
+{
+  if (classConfig(threadClass).isEmpty())
+    return;
+  // Nice and affinity are per-thread, so the call has to run on the target;
+  // the throwaway context object delivers it there.
+  QObject* hop = new QObject();
+  hop->moveToThread(thread);
+  QTimer::singleShot(0, hop, [=] {
+      reactApplyThreadScheduling(threadClass);
+      hop->deleteLater();
+    });
+}
+
+void reactApplyProcessScheduling(const char* threadClass, qint64 pid)
+{
+  const QVariantMap config = classConfig(threadClass);
+  if (!config.contains("priority") || pid <= 0)
+    return;
+
+  bool ok = false;
+  const int niceValue = niceForPriority(config.value("priority"), &ok);
+  if (!ok)
+    return;
+  recordPlacement(threadClass, pid,
+                  setpriority(PRIO_PROCESS, id_t(pid), niceValue) == 0
+                    ? "priority-applied;" : "priority-denied;");
+}
+
+QVariantMap reactThreadPlacement()
+{
+  QMutexLocker locker(&configLock);
+  QVariantMap placement;
+  for (auto it = placements.constBegin(); it != placements.constEnd(); ++it) {
+    placement.insert(it.key(), QVariantMap{
+      {"config", schedulingConfig.value(it.key()).toMap()},
+      {"threads", it.value()}});
+  }
+  return placement;
+}
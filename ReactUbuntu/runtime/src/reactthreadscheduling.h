@@ -0,0 +1,60 @@
+
+/**
+ * Copyright (C) 2016, Canonical Ltd.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ *
+ * Author: Justin McPherson <justin.mcpherson@canonical.com>
+ *
+ */
+
+#ifndef REACTTHREADSCHEDULING_H
+#define REACTTHREADSCHEDULING_H
+
+#include <QThread>
+#include <QVariantMap>
+
+
+// Scheduling placement for the runtime's helper threads. The bridge's
+// threadScheduling property (REACT_THREAD_SCHEDULING carries the same JSON
+// for the stock application) maps a thread class to a priority and an
+// optional CPU affinity:
+//
+//   {
+//     "modules": { "priority": "high", "affinity": [2, 3] },
+//     "layout":  { "priority": "interactive" },
+//     "decode":  { "priority": "background" },
+//     "js":      { "priority": "interactive" }
+//   }
+//
+// Priorities are nice classes (background 10, low 5, normal 0, high -5,
+// interactive -10; a plain integer is taken as a nice value directly).
+// Nice is per-thread on Linux, and raising priority needs CAP_SYS_NICE,
+// so application is best effort and the outcome is recorded rather than
+// fatal. "js" applies to the whole JS host process (the pipe executor's
+// node child; an in-process JS thread does not exist on this platform);
+// the other classes apply to native threads as they start.
+
+void reactSetThreadSchedulingConfig(const QVariantMap& config);
+
+// Applies the class's config to the calling thread. Cheap no-op for
+// unconfigured classes, so per-job call sites (the shared decode pool)
+// call it unconditionally; a pool thread keeps its placement for whatever
+// runs on it later.
+void reactApplyThreadScheduling(const char* threadClass);
+
+// Applies on a started QThread by hopping onto it.
+void reactApplyThreadScheduling(const char* threadClass, QThread* thread);
+
+// Applies the class's priority to a whole process (the out-of-process JS
+// host); affinity is left to the process.
+void reactApplyProcessScheduling(const char* threadClass, qint64 pid);
+
+// Diagnostics: per class, the configured request and one entry per thread
+// it was applied to with the placement that actually took effect.
+QVariantMap reactThreadPlacement();
+
+#endif // REACTTHREADSCHEDULING_H
@@ -11,19 +11,41 @@
  *
  */
 
+#include <limits>
+
+#include <QDateTime>
 #include <QMetaObject>
 #include <QMetaMethod>
-#include <QNetworkAccessManager>
-#include <QNetworkRequest>
-#include <QNetworkReply>
+#include <QQuickItem>
+#include <QQuickWindow>
 
 #include "reacttiming.h"
 #include "reactbridge.h"
 
 
+namespace
+{
+// Timers due within this much ride the window's frame callback instead of a
+// wakeup of their own, keeping them aligned with the render loop.
+const qint64 frameHorizonMs = 34;
+
+// Long timeouts may fire this much early so that wakeups batch together on
+// whichever tick comes first instead of landing one event-loop pass apart.
+qint64 coalesceSlackMs(int durationMs)
+{
+  if (durationMs < 250)
+    return 0;
+  return qMin(qint64(durationMs) / 10, qint64(50));
+}
+}
+
+
 ReactTiming::ReactTiming(QObject* parent)
   : QObject(parent)
 {
+  m_driver.setSingleShot(true);
+  connect(&m_driver, SIGNAL(timeout()), SLOT(driverFired()));
+  m_clock.start();
 }
 
 ReactTiming::~ReactTiming()
@@ -33,6 +55,7 @@ ReactTiming::~ReactTiming()
 void ReactTiming::setBridge(ReactBridge* bridge)
 {
   m_bridge = bridge;
+  connect(bridge->scheduler(), SIGNAL(idle(qint64)), SLOT(sendIdle(qint64)));
 }
 
 ReactViewManager* ReactTiming::viewManager()
@@ -96,29 +119,131 @@ void ReactTiming::createTimer
     return;
   }
 
-  QTimer *timer = new QTimer(this);
-  timer->setSingleShot(!repeats);
-  QObject::connect(timer, &QTimer::timeout, [=]() {
-      if (m_bridge)
-        m_bridge->enqueueJSCall("JSTimersExecution", "callTimers", QVariantList{QVariantList{callbackId}});
-    });
-  m_activeTimers[callbackId] = timer;
-  if (duration < 18) {
-    // XXX: mimicking RN behavior via timeouts
-    timer->start((1.0 / 60) * 1000);
-  } else {
-    timer->start(duration);
-  }
+  // Sub-frame durations behave like requestAnimationFrame: serviced on the
+  // next frame callback rather than a dedicated sub-16ms timeout.
+  const int effectiveDuration = duration < 18 ? 0 : duration;
+  m_timers.insert(callbackId,
+                  Timer{m_clock.elapsed() + effectiveDuration, effectiveDuration, repeats});
+  scheduleNext();
 }
 
 void ReactTiming::deleteTimer(int timerId)
 {
   // qDebug() << __PRETTY_FUNCTION__ << timerId;
-  QMap<int, QTimer*>::iterator it = m_activeTimers.find(timerId);
-  if (it == m_activeTimers.end())
+  m_timers.remove(timerId);
+  if (m_timers.isEmpty())
+    m_driver.stop();
+}
+
+void ReactTiming::setSendIdleEvents(bool sendIdleEvents)
+{
+  if (m_sendIdleEvents == sendIdleEvents)
+    return;
+  m_sendIdleEvents = sendIdleEvents;
+  // Idle periods are observed at the end of each frame's drain, so frames
+  // have to keep coming while JS wants them; JS clears the flag again when
+  // the last idle callback unregisters.
+  if (sendIdleEvents)
+    requestFrame();
+}
+
+void ReactTiming::sendIdle(qint64 remainingMs)
+{
+  if (!m_sendIdleEvents || m_bridge.isNull() || remainingMs < 1)
+    return;
+
+  // An absolute deadline; the JS shim hands callbacks the time remaining
+  // until it, matching requestIdleCallback's didTimeout/timeRemaining shape.
+  m_bridge->enqueueJSCall(
+    "JSTimersExecution", "callIdleCallbacks",
+    QVariantList{double(QDateTime::currentMSecsSinceEpoch() + remainingMs)});
+  requestFrame();
+}
+
+void ReactTiming::requestFrame()
+{
+  QQuickItem* visualParent = m_bridge ? m_bridge->visualParent() : nullptr;
+  QQuickWindow* window = visualParent != nullptr ? visualParent->window() : nullptr;
+  if (window != nullptr)
+    window->update();
+}
+
+void ReactTiming::frameTick()
+{
+  fireDue();
+  scheduleNext();
+}
+
+void ReactTiming::driverFired()
+{
+  fireDue();
+  scheduleNext();
+}
+
+void ReactTiming::fireDue()
+{
+  if (m_bridge.isNull() || m_timers.isEmpty())
+    return;
+
+  const qint64 now = m_clock.elapsed();
+  QVariantList due;
+  for (auto it = m_timers.begin(); it != m_timers.end();) {
+    Timer& timer = it.value();
+    if (timer.targetMs - coalesceSlackMs(timer.durationMs) > now) {
+      ++it;
+      continue;
+    }
+    due.append(it.key());
+    if (timer.repeats) {
+      timer.targetMs = now + timer.durationMs;
+      ++it;
+    } else {
+      it = m_timers.erase(it);
+    }
+  }
+
+  // Everything that came due in this wakeup crosses the bridge as one batch.
+  if (!due.isEmpty())
+    m_bridge->enqueueJSCall("JSTimersExecution", "callTimers", QVariantList{due});
+}
+
+qint64 ReactTiming::nearestTargetMs() const
+{
+  qint64 nearest = std::numeric_limits<qint64>::max();
+  for (const Timer& timer : m_timers)
+    nearest = qMin(nearest, timer.targetMs);
+  return nearest;
+}
+
+void ReactTiming::scheduleNext()
+{
+  m_driver.stop();
+  if (m_timers.isEmpty())
     return;
 
-  (*it)->stop();
-  (*it)->deleteLater();
-  m_activeTimers.erase(it);
+  const qint64 now = m_clock.elapsed();
+  const qint64 nearest = nearestTargetMs();
+
+  QQuickItem* visualParent = m_bridge ? m_bridge->visualParent() : nullptr;
+  QQuickWindow* window = visualParent != nullptr ? visualParent->window() : nullptr;
+
+  if (window != nullptr && nearest - now <= frameHorizonMs) {
+    // Due within a frame or two; ride the render loop so the callback lands
+    // aligned with the next frame instead of beating against it.
+    if (!m_connectedToWindow) {
+      // afterAnimating runs on the GUI thread once per frame, just before
+      // synchronizing with the render thread.
+      connect(window, SIGNAL(afterAnimating()), this, SLOT(frameTick()));
+      m_connectedToWindow = true;
+    }
+    window->update();
+    return;
+  }
+
+  // Far deadline: one wakeup for the earliest timer; anything else that is
+  // inside its coalescing window by then fires along with it. Coarse timers
+  // let the kernel align the wakeup with others.
+  const qint64 dt = qMax(nearest - now, qint64(0));
+  m_driver.setTimerType(dt >= 1000 ? Qt::CoarseTimer : Qt::PreciseTimer);
+  m_driver.start(dt);
 }
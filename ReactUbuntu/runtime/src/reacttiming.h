@@ -14,6 +14,7 @@
 #ifndef REACTTIMING_H
 #define REACTTIMING_H
 
+#include <QElapsedTimer>
 #include <QMap>
 #include <QVariant>
 #include <QObject>
@@ -34,6 +35,10 @@ class ReactTiming
 
   Q_INVOKABLE void createTimer(int callbackId, int duration, const QDateTime& jsSchedulingTime, bool repeats);
   Q_INVOKABLE void deleteTimer(int timerId);
+  // JS turns this on while requestIdleCallback handlers are registered; each
+  // frame the scheduler finishes under budget, the leftover is forwarded as
+  // an idle period with an absolute deadline.
+  Q_INVOKABLE void setSendIdleEvents(bool sendIdleEvents);
 
 public:
   ReactTiming(QObject* parent = 0);
@@ -48,9 +53,33 @@ public:
   QList<ReactModuleMethod*> methodsToExport() override;
   QVariantMap constantsToExport() override;
 
+private Q_SLOTS:
+  void frameTick();
+  void driverFired();
+  void sendIdle(qint64 remainingMs);
+
 private:
+  // All JS timers share one driver instead of a QTimer each: timers due
+  // within the next frame or two fire from the window's afterAnimating
+  // callback (so frame timers stay aligned with the render loop), and one
+  // single-shot QTimer covers the gap to the earliest far deadline.
+  struct Timer {
+    qint64 targetMs;
+    int durationMs;
+    bool repeats;
+  };
+
+  void fireDue();
+  void scheduleNext();
+  void requestFrame();
+  qint64 nearestTargetMs() const;
+
   QPointer<ReactBridge> m_bridge;
-  QMap<int, QTimer*> m_activeTimers;
+  QMap<int, Timer> m_timers;
+  QTimer m_driver;
+  QElapsedTimer m_clock;
+  bool m_connectedToWindow = false;
+  bool m_sendIdleEvents = false;
 };
 
 #endif // REACTTIMING_H
@@ -25,7 +25,6 @@
 
 ReactTouchableManager::ReactTouchableManager(QObject* parent)
   : ReactViewManager(parent)
-  , m_id(0)
 {
 }
 
@@ -66,26 +65,28 @@ static const char* component_qml =
 "  signal clicked()"
 "  color: \"green\"\n"
 "  MouseArea {\n"
-"    id: touchableMouseId%1\n"
+"    id: touchableMouseId\n"
 "    anchors.fill: parent\n"
 "  }\n"
 "  Connections {\n"
-"    target: touchableMouseId%1\n"
+"    target: touchableMouseId\n"
 "    onClicked: clicked()\n"
 "  }\n"
 "}\n";
 }
 
-QQuickItem* ReactTouchableManager::view(const QVariantMap& properties) const
+QByteArray ReactTouchableManager::componentSource() const
 {
-  QString componentString = QString(component_qml).arg(m_id++);
+  return QByteArray(component_qml);
+}
 
-  QQmlComponent component(m_bridge->qmlEngine());
-  component.setData(componentString.toLocal8Bit(), QUrl());
-  if (!component.isReady())
+QQuickItem* ReactTouchableManager::view(const QVariantMap& properties) const
+{
+  QQmlComponent* component = m_bridge->componentForSource(componentSource());
+  if (!component->isReady())
     qCritical() << "Component for ReactTouchableManager not ready";
 
-  QQuickItem* item = qobject_cast<QQuickItem*>(component.create());
+  QQuickItem* item = qobject_cast<QQuickItem*>(component->create());
   if (item == nullptr) {
     qCritical() << "Unable to create component for ReactTouchableManager";
     return nullptr;
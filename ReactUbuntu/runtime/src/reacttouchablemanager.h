@@ -37,6 +37,8 @@ public:
 
   QQuickItem* view(const QVariantMap& properties) const override;
 
+  QByteArray componentSource() const override;
+
   void applyProperties(QQuickItem* item, const QVariantMap& properties) const override;
 
 private Q_SLOTS:
@@ -44,8 +46,6 @@ private Q_SLOTS:
 
 private:
   void configureView(QQuickItem* view) const;
-
-  int m_id;
 };
 
 #endif // REACTTOUCHABLEMANAGER_H
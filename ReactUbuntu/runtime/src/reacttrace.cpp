@@ -0,0 +1,278 @@
+
+/**
+ * Copyright (C) 2016, Canonical Ltd.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ *
+ * Author: Justin McPherson <justin.mcpherson@canonical.com>
+ *
+ */
+
+#include <algorithm>
+#include <limits>
+
+#include <QAtomicInt>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QLoggingCategory>
+#include <QMutex>
+#include <QVector>
+
+#include <QDebug>
+
+#include "reactcachestats.h"
+#include "reactthreadscheduling.h"
+#include "reacttrace.h"
+
+
+// Default-off; Qt Creator's QML profiler shows these messages on its Debug
+// Messages row, which is the only way into its timeline from here.
+Q_LOGGING_CATEGORY(REACT_PROFILE, "react.profile", QtWarningMsg)
+
+namespace {
+
+struct TraceEvent {
+  qint64 ts;
+  quint32 id;
+  const char* name;
+  char phase;
+  int tid;
+};
+
+// Roughly a minute of a busy bridge; recording simply stops when full
+// rather than ever reallocating on the hot path.
+const int kEventCapacity = 1 << 20;
+
+QVector<TraceEvent>* events = nullptr;
+QMutex eventsMutex;
+QString tracePath;
+QElapsedTimer traceClock;
+qint64 remoteOffsetUs = std::numeric_limits<qint64>::max();
+
+struct WireStats {
+  qint64 frames = 0;
+  qint64 rawBytes = 0;
+  qint64 wireBytes = 0;
+};
+WireStats wireOut;
+WireStats wireIn;
+
+void dumpTrace()
+{
+  if (events == nullptr || events->isEmpty())
+    return;
+
+  QFile out(tracePath);
+  if (!out.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+    qWarning() << "Could not write trace to" << tracePath;
+    return;
+  }
+
+  out.write("[\n");
+  for (int i = 0; i < events->size(); ++i) {
+    const TraceEvent& event = events->at(i);
+    QByteArray line = "{\"cat\":\"bridge\",\"pid\":1,\"name\":\"";
+    line += event.name;
+    line += "\",\"ph\":\"";
+    line += event.phase;
+    line += "\",\"id\":" + QByteArray::number(event.id);
+    line += ",\"tid\":" + QByteArray::number(event.tid);
+    line += ",\"ts\":" + QByteArray::number(event.ts);
+    line += i + 1 < events->size() ? "},\n" : "}\n";
+    out.write(line);
+  }
+  out.write("]\n");
+}
+
+// The request spans all share one row; duration spans record the thread
+// they ran on so nesting comes out right per thread.
+const int kRequestTid = 1;
+
+int currentTraceTid()
+{
+  static QAtomicInt nextTid(kRequestTid + 1);
+  static thread_local int tid = nextTid.fetchAndAddRelaxed(1);
+  return tid;
+}
+
+void record(quint32 requestId, const char* name, char phase, qint64 ts,
+            int tid = kRequestTid)
+{
+  QMutexLocker lock(&eventsMutex);
+  if (events->size() >= kEventCapacity)
+    return;
+  events->append(TraceEvent{ts, requestId, name, phase, tid});
+}
+
+} // namespace
+
+bool reactTraceEnabled()
+{
+  static const bool enabled = [] {
+    tracePath = QString::fromLocal8Bit(qgetenv("REACT_TRACE_FILE"));
+    if (tracePath.isEmpty())
+      return false;
+    traceClock.start();
+    events = new QVector<TraceEvent>;
+    events->reserve(kEventCapacity);
+    qAddPostRoutine(dumpTrace);
+    return true;
+  }();
+  return enabled;
+}
+
+qint64 reactTraceNowUs()
+{
+  return traceClock.nsecsElapsed() / 1000;
+}
+
+void reactTraceRequestBegin(quint32 requestId)
+{
+  if (!reactTraceEnabled())
+    return;
+  record(requestId, "request", 'b', reactTraceNowUs());
+}
+
+void reactTraceRequestStamp(quint32 requestId, const char* phase)
+{
+  if (!reactTraceEnabled())
+    return;
+  record(requestId, phase, 'n', reactTraceNowUs());
+}
+
+void reactTraceRequestEnd(quint32 requestId)
+{
+  if (!reactTraceEnabled())
+    return;
+  record(requestId, "request", 'e', reactTraceNowUs());
+}
+
+QVariantMap reactTraceRequestSummary()
+{
+  QVariantMap summary;
+  if (events == nullptr)
+    return summary;
+
+  QHash<quint32, qint64> open;
+  QVector<qint64> latencies;
+  QMutexLocker lock(&eventsMutex);
+  for (const TraceEvent& event : *events) {
+    if (event.phase == 'b') {
+      open.insert(event.id, event.ts);
+    } else if (event.phase == 'e') {
+      auto it = open.find(event.id);
+      if (it != open.end()) {
+        latencies.append(event.ts - it.value());
+        open.erase(it);
+      }
+    }
+  }
+  std::sort(latencies.begin(), latencies.end());
+
+  summary["count"] = latencies.size();
+  const QVariantMap caches = reactCacheStatsSnapshot();
+  if (!caches.isEmpty())
+    summary["caches"] = caches;
+  const QVariantMap threads = reactThreadPlacement();
+  if (!threads.isEmpty())
+    summary["threads"] = threads;
+  if (wireOut.frames > 0 || wireIn.frames > 0) {
+    summary["wire"] = QVariantMap{
+      {"framesOut", wireOut.frames},
+      {"rawBytesOut", wireOut.rawBytes},
+      {"wireBytesOut", wireOut.wireBytes},
+      {"framesIn", wireIn.frames},
+      {"rawBytesIn", wireIn.rawBytes},
+      {"wireBytesIn", wireIn.wireBytes}};
+  }
+  if (latencies.isEmpty())
+    return summary;
+
+  auto percentile = [&](double p) {
+    return latencies.at(int((latencies.size() - 1) * p));
+  };
+  summary["p50Us"] = percentile(0.50);
+  summary["p90Us"] = percentile(0.90);
+  summary["p99Us"] = percentile(0.99);
+  summary["maxUs"] = latencies.last();
+
+  // Doubling buckets from 125us; wide enough that the top bucket only fills
+  // when something is badly wrong.
+  QVariantList histogram;
+  int index = 0;
+  for (qint64 bound = 125; index < latencies.size(); bound *= 2) {
+    int count = 0;
+    while (index < latencies.size() && latencies.at(index) <= bound) {
+      ++count;
+      ++index;
+    }
+    histogram.append(QVariantMap{{"leUs", bound}, {"count", count}});
+  }
+  summary["histogramUs"] = histogram;
+
+  return summary;
+}
+
+void reactTraceWireFrame(bool outbound, qint64 rawBytes, qint64 wireBytes)
+{
+  if (!reactTraceEnabled())
+    return;
+  WireStats& stats = outbound ? wireOut : wireIn;
+  ++stats.frames;
+  stats.rawBytes += rawBytes;
+  stats.wireBytes += wireBytes;
+}
+
+void reactTraceObserveRemoteClock(qint64 remoteUs)
+{
+  if (!reactTraceEnabled())
+    return;
+  // The stamp was made before we received it, so now - remote bounds the
+  // offset from above; the running minimum discards queueing noise.
+  const qint64 candidate = reactTraceNowUs() - remoteUs;
+  if (candidate < remoteOffsetUs)
+    remoteOffsetUs = candidate;
+}
+
+void reactTraceRemoteStamp(quint32 requestId, const char* phase, qint64 remoteUs)
+{
+  if (!reactTraceEnabled() || remoteOffsetUs == std::numeric_limits<qint64>::max())
+    return;
+  record(requestId, phase, 'n', remoteUs + remoteOffsetUs);
+}
+
+void reactTraceSpanBegin(const char* name)
+{
+  qCDebug(REACT_PROFILE, "%s begin", name);
+  if (!reactTraceEnabled())
+    return;
+  record(0, name, 'B', reactTraceNowUs(), currentTraceTid());
+}
+
+void reactTraceSpanEnd(const char* name)
+{
+  qCDebug(REACT_PROFILE, "%s end", name);
+  if (!reactTraceEnabled())
+    return;
+  record(0, name, 'E', reactTraceNowUs(), currentTraceTid());
+}
+
+const char* reactTraceInternName(const QString& name)
+{
+  static QMutex poolMutex;
+  static QHash<QString, QByteArray>* pool = nullptr;
+  QMutexLocker lock(&poolMutex);
+  if (pool == nullptr)
+    pool = new QHash<QString, QByteArray>;
+  auto it = pool->find(name);
+  if (it == pool->end())
+    it = pool->insert(name, name.toUtf8());
+  // QByteArray's data pointer is stable while the entry stays in the hash,
+  // and entries are never removed.
+  return it.value().constData();
+}
@@ -0,0 +1,94 @@
+
+/**
+ * Copyright (C) 2016, Canonical Ltd.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ *
+ * Author: Justin McPherson <justin.mcpherson@canonical.com>
+ *
+ */
+
+#ifndef REACTTRACE_H
+#define REACTTRACE_H
+
+#include <QtGlobal>
+#include <QVariantMap>
+
+
+// Bridge request tracing. Point REACT_TRACE_FILE at a path and every bridge
+// request records its lifecycle stamps (enqueue, send, reply, dispatch) on
+// the local monotonic clock; the buffer is dumped in Chrome trace format
+// (load in about:tracing) when the application exits. Stamps are appended to
+// a preallocated buffer, so tracing stays cheap enough to leave on during a
+// measurement run. Name strings must be literals; only the pointer is kept.
+
+// Checked once at startup from the environment; constant afterwards.
+bool reactTraceEnabled();
+
+// Microseconds on the trace clock.
+qint64 reactTraceNowUs();
+
+// Opens the async span for a request id (the enqueue stamp), marks a point
+// within it, and closes it (the dispatch stamp).
+void reactTraceRequestBegin(quint32 requestId);
+void reactTraceRequestStamp(quint32 requestId, const char* phase);
+void reactTraceRequestEnd(quint32 requestId);
+
+// Stamps reported by the remote JS host on its own clock, mapped onto ours
+// with an offset estimated from observed transmissions: each observation
+// bounds the offset by the receive time, and the minimum over many
+// observations converges on the true offset plus the minimum wire delay.
+// Latency summary over the request spans closed so far: count, microsecond
+// percentiles of enqueue-to-dispatch time, and a doubling-bucket histogram
+// as a list of {leUs, count} maps. Consumed by the headless benchmark
+// driver; empty when tracing is off.
+QVariantMap reactTraceRequestSummary();
+
+void reactTraceObserveRemoteClock(qint64 remoteUs);
+void reactTraceRemoteStamp(quint32 requestId, const char* phase, qint64 remoteUs);
+
+// Per-frame wire accounting from the remote executor: body size before and
+// after compression, per direction. Totals land in the request summary so a
+// deployment's compression win is visible next to its latencies.
+void reactTraceWireFrame(bool outbound, qint64 rawBytes, qint64 wireBytes);
+
+// Ranged markers for work that isn't a bridge request: batch applies, flex
+// layout passes, module invocations. Spans nest per thread (each emitting
+// thread gets its own trace row) and land in the same buffer as the request
+// spans, so a slow frame can be walked back to the batch and invocations
+// that produced it on one timeline. Qt's QML profiler protocol has no hook
+// for application-defined ranges in this Qt version, so when a Qt Creator
+// profiling session is wanted instead, enable the react.profile logging
+// category (QT_LOGGING_RULES="react.profile.debug=true"): every span
+// begin/end is then also emitted as a debug message, which the profiler
+// shows on its Debug Messages row interleaved with scene graph timing.
+// Names must be literals; runtime-built names go through
+// reactTraceInternName first.
+void reactTraceSpanBegin(const char* name);
+void reactTraceSpanEnd(const char* name);
+
+// Copies a runtime-built span name into a pool that lives for the process,
+// so TraceEvent can keep borrowing pointers. Intern once and reuse; the
+// pool never shrinks.
+const char* reactTraceInternName(const QString& name);
+
+// Scope helper for the common bracketed case.
+class ReactTraceSpan
+{
+public:
+  explicit ReactTraceSpan(const char* name) : m_name(name) {
+    reactTraceSpanBegin(m_name);
+  }
+  ~ReactTraceSpan() {
+    reactTraceSpanEnd(m_name);
+  }
+
+private:
+  Q_DISABLE_COPY(ReactTraceSpan)
+  const char* m_name;
+};
+
+#endif // REACTTRACE_H
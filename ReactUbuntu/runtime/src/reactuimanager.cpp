@@ -14,33 +14,85 @@
 #include <iterator>
 #include <algorithm>
 
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
 #include <QMetaObject>
 #include <QMetaMethod>
 #include <QJsonDocument>
 #include <QQuickItem>
 #include <QQuickItemGrabResult>
-#include <QQuickWindow>
+#include <QSet>
+#include <QStandardPaths>
+#include <QTimer>
 
 #include <QDebug>
 
 #include "reactbridge.h"
+#include "reactscheduler.h"
 #include "reactcomponentdata.h"
 #include "reactmoduledata.h"
 #include "reactmodulemethod.h"
 #include "reactflexlayout.h"
 #include "reactattachedproperties.h"
 #include "reactviewmanager.h"
+#include "reactframemonitor.h"
 #include "reactuimanager.h"
 
 
 int ReactUIManager::m_nextRootTag = 1;
 
 
+void ReactUIManager::scheduleOperation(std::function<void()>&& operation)
+{
+  m_pendingOperations.append(std::move(operation));
+}
+
+void ReactUIManager::scheduleFlush()
+{
+  if (m_flushScheduled)
+    return;
+  m_flushScheduled = true;
+  // The whole batch applies as one layout-apply task: operations within a
+  // batch are not individually consistent, so the flush never splits across
+  // frames and always runs regardless of remaining budget.
+  m_bridge->scheduler()->schedule(ReactScheduler::LayoutApply,
+                                  [this] { flushPendingOperations(); });
+}
+
+void ReactUIManager::flushPendingOperations()
+{
+  m_flushScheduled = false;
+  if (m_pendingOperations.isEmpty())
+    return;
+
+  // Operations may enqueue follow-ups while running (e.g. a view manager
+  // command invoking another queued method); the index loop picks those up
+  // in order.
+  for (int i = 0; i < m_pendingOperations.size(); ++i) {
+    m_pendingOperations[i]();
+  }
+  m_pendingOperations.clear();
+
+  // The first applied batch is the real mount; the facsimile painted from
+  // the snapshot has done its job and leaves in the same frame.
+  dismissFirstFrame();
+
+  m_bridge->visualParent()->polish();
+}
+
 void ReactUIManager::removeSubviewsFromContainerWithID(int containerReactTag)
+{
+  scheduleOperation([=] { doRemoveSubviewsFromContainerWithID(containerReactTag); });
+}
+
+void ReactUIManager::doRemoveSubviewsFromContainerWithID(int containerReactTag)
 {
   // qDebug() << __PRETTY_FUNCTION__;
 
-  QQuickItem* item = m_views.value(containerReactTag);
+  QQuickItem* item = viewEntryForTag(containerReactTag).item;
   if (item == nullptr) {
     qWarning() << __PRETTY_FUNCTION__ << "Attempting to access unknown view";
     return;
@@ -50,7 +102,7 @@ void ReactUIManager::removeSubviewsFromContainerWithID(int containerReactTag)
   childIndexes.reserve(item->childItems().size());
   std::iota(childIndexes.begin(), childIndexes.end(), 0);
 
-  manageChildren(containerReactTag, QList<int>(), QList<int>(), QList<int>(), QList<int>(), childIndexes);
+  doManageChildren(containerReactTag, QList<int>(), QList<int>(), QList<int>(), QList<int>(), childIndexes);
 }
 
 void ReactUIManager::measure
@@ -58,10 +110,21 @@ void ReactUIManager::measure
  int reactTag,
  const ReactModuleInterface::ListArgumentBlock& callback
 )
+{
+  // Queued so measurements of views created earlier in the same batch see
+  // them applied.
+  scheduleOperation([=] { doMeasure(reactTag, callback); });
+}
+
+void ReactUIManager::doMeasure
+(
+ int reactTag,
+ const ReactModuleInterface::ListArgumentBlock& callback
+)
 {
   // qDebug() << __PRETTY_FUNCTION__;
 
-  QQuickItem* item = m_views.value(reactTag);
+  QQuickItem* item = viewEntryForTag(reactTag).item;
   if (item == nullptr) {
     qWarning() << "Attempting to access unknown view";
     callback(m_bridge, QVariantList{});
@@ -81,25 +144,111 @@ void ReactUIManager::measure
     });
 }
 
+void ReactUIManager::measureBatch
+(
+  const QVariantList& requests,
+  const ReactModuleInterface::ListArgumentBlock& callback
+)
+{
+  // Queued like the single-view path so measurements see every view created
+  // earlier in the same batch.
+  scheduleOperation([=] { doMeasureBatch(requests, callback); });
+}
+
+void ReactUIManager::doMeasureBatch
+(
+  const QVariantList& requests,
+  const ReactModuleInterface::ListArgumentBlock& callback
+)
+{
+  // Rows in a list share almost their entire ancestor chain; memoizing each
+  // item's root-relative origin means a batch of N rows costs one walk of
+  // the shared chain instead of N full mapToItem traversals. Flex-positioned
+  // views only translate, so summing positions matches what mapToItem would
+  // return.
+  QHash<QQuickItem*, QPointF> origins;
+  std::function<QPointF(QQuickItem*)> originOf = [&](QQuickItem* item) -> QPointF {
+    if (item == nullptr || item == m_bridge->visualParent())
+      return QPointF(0, 0);
+    auto it = origins.constFind(item);
+    if (it != origins.constEnd())
+      return it.value();
+    const QPointF origin = originOf(item->parentItem()) + QPointF(item->x(), item->y());
+    origins.insert(item, origin);
+    return origin;
+  };
+
+  QVariantList results;
+  for (const QVariant& requestEntry : requests) {
+    const QVariantMap request = requestEntry.toMap();
+    const int reactTag = request.value("reactTag").toInt();
+    QQuickItem* item = viewEntryForTag(reactTag).item;
+    if (item == nullptr) {
+      qWarning() << __PRETTY_FUNCTION__ << "Attempting to access unknown view; reactTag=" << reactTag;
+      results.push_back(QVariantMap{});
+      continue;
+    }
+
+    const QPointF origin = originOf(item);
+    QVariantMap result{
+      { "reactTag", reactTag },
+      { "x", item->x() },
+      { "y", item->y() },
+      { "width", item->width() },
+      { "height", item->height() },
+      { "pageX", origin.x() },
+      { "pageY", origin.y() },
+    };
+    if (request.contains("ancestorReactTag")) {
+      QQuickItem* ancestor = viewEntryForTag(request.value("ancestorReactTag").toInt()).item;
+      if (ancestor != nullptr) {
+        const QPointF relative = origin - originOf(ancestor);
+        result.insert("left", relative.x());
+        result.insert("top", relative.y());
+      }
+    }
+    results.push_back(result);
+  }
+
+  callback(m_bridge, QVariantList{results});
+}
+
 void ReactUIManager::updateView
 (
   int reactTag,
   const QString& viewName,
   const QVariantMap& properties
 )
+{
+  scheduleOperation([=] { doUpdateView(reactTag, viewName, properties); });
+}
+
+void ReactUIManager::doUpdateView
+(
+  int reactTag,
+  const QString& viewName,
+  const QVariantMap& properties
+)
 {
   // qDebug() << __PRETTY_FUNCTION__ << reactTag << viewName << properties;
 
-  QQuickItem* item = m_views.value(reactTag);
-  if (item == nullptr) {
+  ViewEntry* entryPtr = mutableViewEntryForTag(reactTag);
+  if (entryPtr == nullptr) {
     qWarning() << "Attempting to update properties on unknown view; reactTag=" << reactTag << "viewName=" << viewName;
     return;
   }
+  ViewEntry& entry = *entryPtr;
+  QQuickItem* item = entry.item;
 
-  Q_ASSERT(ReactAttachedProperties::get(item) != nullptr);
-  ReactAttachedProperties::get(item)->applyProperties(properties);
+  // Fold into the resolved props the first-frame snapshot serializes.
+  for (auto it = properties.begin(); it != properties.end(); ++it) {
+    entry.props.insert(it.key(), it.value());
+  }
 
-  ReactFlexLayout* fl = ReactFlexLayout::get(item, false);
+  Q_ASSERT(entry.properties != nullptr);
+  entry.properties->applyProperties(properties);
+
+  ReactFlexLayout* fl = entry.layout;
   if (fl != nullptr) {
     fl->applyLayoutProperties(properties);
   }
@@ -116,8 +265,6 @@ void ReactUIManager::updateView
       break;
     }
   }
-
-  m_bridge->visualParent()->polish();
 }
 
 void ReactUIManager::manageChildren
@@ -129,16 +276,36 @@ void ReactUIManager::manageChildren
   const QList<int>& addAtIndices,
   const QList<int>& removeAtIndices
 )
+{
+  scheduleOperation([=] {
+      doManageChildren(containerReactTag, moveFromIndicies, moveToIndices,
+                       addChildReactTags, addAtIndices, removeAtIndices);
+    });
+}
+
+void ReactUIManager::doManageChildren
+(
+  int containerReactTag,
+  const QList<int>& moveFromIndicies,
+  const QList<int>& moveToIndices,
+  const QList<int>& addChildReactTags,
+  const QList<int>& addAtIndices,
+  const QList<int>& removeAtIndices
+)
 {
   // qDebug() << __PRETTY_FUNCTION__ << containerReactTag << moveFromIndicies << moveToIndices << addChildReactTags << addAtIndices << removeAtIndices;
 
-  QQuickItem* container = m_views[containerReactTag];
+  const ViewEntry containerEntry = viewEntryForTag(containerReactTag);
+  QQuickItem* container = containerEntry.item;
   if (container == nullptr) {
     qWarning() << "Attempting to manage children on an unknown container";
     return;
   }
 
-  ReactFlexLayout* rfl = ReactFlexLayout::get(container);
+  // Root views register without a layout; fall back to resolving (and
+  // creating) one the old way for those.
+  ReactFlexLayout* rfl = containerEntry.layout != nullptr
+    ? containerEntry.layout : ReactFlexLayout::get(container);
 
   if (!removeAtIndices.isEmpty()) {
     // removeAtIndices get unpluged and erased
@@ -148,30 +315,37 @@ void ReactUIManager::manageChildren
       child->setParent(0);
 
       // cleanup references
-      m_views.remove(ReactAttachedProperties::get(child)->tag());
-      child->deleteLater();
+      removeViewEntry(ReactAttachedProperties::get(child)->tag());
+
+      // Detached views go back to their type's pool for reuse by later
+      // createView calls; views the pool cannot take are deleted as before.
+      ReactComponentData* cd = componentDataForView(child);
+      if (cd == nullptr || !cd->recycleView(child)) {
+        child->deleteLater();
+      }
     }
 
     rfl->setDirty(true);
   }
 
-  QList<QQuickItem*> children;
+  QList<ViewEntry> children;
   // XXX: Assumption - addChildReactTags is sorted
   std::transform(addChildReactTags.begin(), addChildReactTags.end(),
                  std::back_inserter(children),
                  [this](int key) {
-                   return m_views.value(key);
+                   return viewEntryForTag(key);
                  });
   if (children.size() > 0) {
     // on iOS, order of the subviews implies z-order, implicitly its the same in
     // QML, barring some exceptions. revisit - set zorder appears to be the only
     // exception can probably self order items, but it's not an explicit guarantee
-    QList<QQuickItem*>::iterator it = children.begin();
+    ReactViewManager* vm = containerEntry.properties->viewManager();
+    QList<ViewEntry>::iterator it = children.begin();
     for (int i : addAtIndices) {
-      QQuickItem* child = *it++;
+      const ViewEntry& childEntry = *it++;
+      QQuickItem* child = childEntry.item;
 
       // Add to visual hierarchy
-      ReactViewManager* vm = ReactAttachedProperties::get(container)->viewManager();
       if (vm != nullptr) {
         vm->addChildItem(container, child, i);
       } else {
@@ -180,33 +354,39 @@ void ReactUIManager::manageChildren
       }
 
       // Add to layout
-      if (ReactAttachedProperties::get(child)->shouldLayout()) {
+      if (childEntry.properties->shouldLayout()) {
         rfl->insertChild(i, child);
-        ReactFlexLayout::get(child)->setDirty(true);
-        ReactFlexLayout::get(child)->setParentItem(container);
+        childEntry.layout->setDirty(true);
+        childEntry.layout->setParentItem(container);
       }
     }
 
     rfl->setDirty(true);
   }
-
-  m_bridge->visualParent()->polish();
 }
 
 void ReactUIManager::replaceExistingNonRootView(int reactTag, int newReactTag)
 {
-  QQuickItem* item = m_views.value(reactTag);
+  scheduleOperation([=] { doReplaceExistingNonRootView(reactTag, newReactTag); });
+}
+
+void ReactUIManager::doReplaceExistingNonRootView(int reactTag, int newReactTag)
+{
+  const ViewEntry entry = viewEntryForTag(reactTag);
+  QQuickItem* item = entry.item;
   if (item == nullptr) {
     qCritical() << __PRETTY_FUNCTION__ << "Attempting to access unknown item";
     return;
   }
 
-  QQuickItem* parent = ReactFlexLayout::get(item)->parentItem();
+  ReactFlexLayout* fl = entry.layout != nullptr
+    ? entry.layout : ReactFlexLayout::get(item);
+  QQuickItem* parent = fl->parentItem();
   Q_ASSERT(parent != nullptr);
 
   int itemIndex = item->z();
 
-  manageChildren(ReactAttachedProperties::get(parent)->tag(),
+  doManageChildren(ReactAttachedProperties::get(parent)->tag(),
                   QList<int>(),
                   QList<int>(),
                   QList<int>{newReactTag},
@@ -222,8 +402,19 @@ void ReactUIManager::measureLayout
   const ReactModuleInterface::ListArgumentBlock& callback
 )
 {
-  QQuickItem* item = m_views.value(reactTag);
-  QQuickItem* ancestor = m_views.value(reactTag);
+  scheduleOperation([=] { doMeasureLayout(reactTag, ancestorReactTag, errorCallback, callback); });
+}
+
+void ReactUIManager::doMeasureLayout
+(
+  int reactTag,
+  int ancestorReactTag,
+  const ReactModuleInterface::ListArgumentBlock& errorCallback,
+  const ReactModuleInterface::ListArgumentBlock& callback
+)
+{
+  QQuickItem* item = viewEntryForTag(reactTag).item;
+  QQuickItem* ancestor = viewEntryForTag(reactTag).item;
   Q_ASSERT(item != nullptr && ancestor != nullptr);
 
   int depth = 30; // max depth from ios
@@ -253,16 +444,28 @@ void ReactUIManager::measureLayoutRelativeToParent
   const ReactModuleInterface::ListArgumentBlock& callback
 )
 {
-  QQuickItem* item = m_views.value(reactTag);
+  scheduleOperation([=] { doMeasureLayoutRelativeToParent(reactTag, errorCallback, callback); });
+}
+
+void ReactUIManager::doMeasureLayoutRelativeToParent
+(
+  int reactTag,
+  const ReactModuleInterface::ListArgumentBlock& errorCallback,
+  const ReactModuleInterface::ListArgumentBlock& callback
+)
+{
+  const ViewEntry entry = viewEntryForTag(reactTag);
+  QQuickItem* item = entry.item;
   Q_ASSERT(item != nullptr);
 
-  ReactAttachedProperties* ap = ReactAttachedProperties::get(
-    ReactFlexLayout::get(item)->parentItem());
+  ReactFlexLayout* fl = entry.layout != nullptr
+    ? entry.layout : ReactFlexLayout::get(item);
+  ReactAttachedProperties* ap = ReactAttachedProperties::get(fl->parentItem());
   if (ap == nullptr) {
     qWarning() << __PRETTY_FUNCTION__ << "no parent item!";
     return;
   }
-  measureLayout(reactTag, ap->tag(), errorCallback, callback);
+  doMeasureLayout(reactTag, ap->tag(), errorCallback, callback);
 }
 
 // Reacts version of first responder
@@ -294,6 +497,17 @@ void ReactUIManager::createView
   int rootTag,
   const QVariantMap& props
 )
+{
+  scheduleOperation([=] { doCreateView(reactTag, viewName, rootTag, props); });
+}
+
+void ReactUIManager::doCreateView
+(
+  int reactTag,
+  const QString& viewName,
+  int rootTag,
+  const QVariantMap& props
+)
 {
   Q_UNUSED(rootTag);
 
@@ -310,7 +524,10 @@ void ReactUIManager::createView
     return;
   }
 
-  ReactAttachedProperties* ap = ReactAttachedProperties::get(item);
+  ViewEntry entry = makeViewEntry(item);
+  entry.viewName = viewName;
+  entry.props = props;
+  ReactAttachedProperties* ap = entry.properties;
 
   // TODO: move to createView?
   if (!props.isEmpty()) {
@@ -319,7 +536,10 @@ void ReactUIManager::createView
 
   // Layout properties
   if (ap->shouldLayout()) {
-    ReactFlexLayout* fl = ReactFlexLayout::get(item);
+    if (entry.layout == nullptr) {
+      entry.layout = ReactFlexLayout::get(item);
+    }
+    ReactFlexLayout* fl = entry.layout;
     fl->applyLayoutProperties(props);
 
     // At creation properties have been applied which can lead to the new item's
@@ -329,7 +549,7 @@ void ReactUIManager::createView
     fl->setDirty(false);
   }
 
-  m_views.insert(reactTag, item);
+  insertViewEntry(reactTag, entry);
 
   // qDebug() << __PRETTY_FUNCTION__ << "end";
 }
@@ -341,7 +561,17 @@ void ReactUIManager::findSubviewIn
  const ReactModuleInterface::ListArgumentBlock& callback
 )
 {
-  QQuickItem* item = m_views.value(reactTag);
+  scheduleOperation([=] { doFindSubviewIn(reactTag, point, callback); });
+}
+
+void ReactUIManager::doFindSubviewIn
+(
+ int reactTag,
+ const QPointF& point,
+ const ReactModuleInterface::ListArgumentBlock& callback
+)
+{
+  QQuickItem* item = viewEntryForTag(reactTag).item;
   if (item == nullptr) {
     qWarning() << "Attempting to access unknown view";
     callback(m_bridge, QVariantList{});
@@ -385,18 +615,88 @@ void ReactUIManager::dispatchViewManagerCommand(
   int commandID,
   const QVariantList& commandArgs
 ) {
-  // qDebug() << __PRETTY_FUNCTION__ << reactTag << commandID << commandArgs;
-  QQuickItem* item = m_views.value(reactTag);
-  if (item == nullptr) {
-    qWarning() << __PRETTY_FUNCTION__ << "Attempting to access unknown view";
+  scheduleOperation([=] { doDispatchViewManagerCommand(reactTag, commandID, commandArgs); });
+}
+
+ReactUIManager::ViewEntry ReactUIManager::makeViewEntry(QQuickItem* item)
+{
+  ViewEntry entry;
+  entry.item = item;
+  entry.properties = ReactAttachedProperties::get(item);
+  // Resolved but never created here: doCreateView creates the layout only
+  // for views that declare shouldLayout, after properties have applied.
+  entry.layout = ReactFlexLayout::get(item, false);
+  return entry;
+}
+
+ReactUIManager::ViewEntry ReactUIManager::viewEntryForTag(int tag) const
+{
+  if (tag < 0 || tag >= m_viewSlots.size())
+    return ViewEntry();
+  return m_viewSlots.at(tag).entry;
+}
+
+ReactUIManager::ViewEntry* ReactUIManager::mutableViewEntryForTag(int tag)
+{
+  if (tag < 0 || tag >= m_viewSlots.size() || m_viewSlots[tag].entry.item == nullptr)
+    return nullptr;
+  return &m_viewSlots[tag].entry;
+}
+
+void ReactUIManager::insertViewEntry(int tag, const ViewEntry& entry)
+{
+  // Facsimile tags from the first-frame replay are negative and stay out of
+  // the registry entirely; their items are tracked in m_firstFrameItems.
+  if (tag < 0)
     return;
+  if (tag >= m_viewSlots.size()) {
+    // Tags arrive almost sequentially, so growth amortizes like a push_back.
+    m_viewSlots.resize(tag + 1);
   }
-  QString moduleName = ReactAttachedProperties::get(item)->viewManager()->moduleName();
+  ViewSlot& slot = m_viewSlots[tag];
+  if (slot.entry.item == nullptr)
+    ++m_viewCount;
+  slot.entry = entry;
+  ++slot.generation;
+}
+
+void ReactUIManager::removeViewEntry(int tag)
+{
+  if (tag < 0 || tag >= m_viewSlots.size())
+    return;
+  ViewSlot& slot = m_viewSlots[tag];
+  if (slot.entry.item == nullptr)
+    return;
+  slot.entry = ViewEntry();
+  ++slot.generation;
+  --m_viewCount;
+}
+
+ReactComponentData* ReactUIManager::componentDataForView(QQuickItem* view) const
+{
+  ReactViewManager* vm = ReactAttachedProperties::get(view)->viewManager();
+  if (vm == nullptr)
+    return nullptr;
+  QString moduleName = vm->moduleName();
   // XXX:
   int mi = moduleName.indexOf("Manager");
   if (mi != -1)
     moduleName = moduleName.left(mi);
-  ReactComponentData* cd = m_componentData[moduleName];
+  return m_componentData.value(moduleName);
+}
+
+void ReactUIManager::doDispatchViewManagerCommand(
+  int reactTag,
+  int commandID,
+  const QVariantList& commandArgs
+) {
+  // qDebug() << __PRETTY_FUNCTION__ << reactTag << commandID << commandArgs;
+  QQuickItem* item = viewEntryForTag(reactTag).item;
+  if (item == nullptr) {
+    qWarning() << __PRETTY_FUNCTION__ << "Attempting to access unknown view";
+    return;
+  }
+  ReactComponentData* cd = componentDataForView(item);
   if (cd == nullptr) {
     qWarning() << __PRETTY_FUNCTION__ << "Could not find valid module information";
     return;
@@ -427,17 +727,32 @@ void ReactUIManager::takeSnapshot(
   if (options.contains("quality")) {
     quality = options.value("quality").toDouble() * 100;
   }
+  // Optional region of interest, in the coordinates of the grabbed item.
+  QRect region;
+  if (options.contains("region")) {
+    QVariantMap rm = options.value("region").toMap();
+    region = QRect(rm.value("x").toInt(), rm.value("y").toInt(),
+                   rm.value("width").toInt(), rm.value("height").toInt());
+  }
+  const bool diffMode = options.value("diff").toBool();
+
+  auto callback = [=](const QImage& grabbed) {
+    QImage image = grabbed;
+    if (!region.isNull())
+      image = image.copy(region);
+    if (imageSize.isValid() && image.size() != imageSize)
+      image = image.scaled(imageSize);
+
+    if (diffMode) {
+      resolveSnapshotDiff(target, image, resolve);
+      return;
+    }
 
-  auto callback = [=](const QImage& image) {
     QTemporaryFile* imageFile = new QTemporaryFile(m_bridge);
     imageFile->setFileTemplate(QStandardPaths::writableLocation(QStandardPaths::TempLocation) +
                                 QString("/XXXXXX.") + imageFormat);
     if (imageFile->open()) {
-      QImage saveImage = image;
-      if (imageSize.isValid())
-        saveImage = image.scaled(imageSize);
-
-      if (saveImage.save(imageFile, imageFormat.toLocal8Bit().constData(), quality)) {
+      if (image.save(imageFile, imageFormat.toLocal8Bit().constData(), quality)) {
         resolve(m_bridge, QVariantList{
             QUrl::fromLocalFile(imageFile->fileName())
           });
@@ -448,24 +763,108 @@ void ReactUIManager::takeSnapshot(
     reject(m_bridge, QVariantList{ QVariantMap{{"error", "Unable to save image to file"}}});
   };
 
+  QQuickItem* item;
   if (target == "window") {
-    callback(m_bridge->visualParent()->window()->grabWindow());
+    // Grabbing the window reads pixels back synchronously, stalling both the
+    // GUI and render threads; the root item covers the same content and
+    // renders through an FBO on the render thread, delivering the image
+    // asynchronously like any other item grab.
+    item = m_bridge->visualParent();
   } else {
-    QQuickItem* item = m_views.value(target.toInt());
-    if (item == nullptr) {
-      reject(m_bridge, QVariantList{ QVariantMap{{"error", "Could not find view"}}});
-      return;
+    item = viewEntryForTag(target.toInt()).item;
+  }
+  if (item == nullptr) {
+    reject(m_bridge, QVariantList{ QVariantMap{{"error", "Could not find view"}}});
+    return;
+  }
+
+  // Cropping needs the native resolution, so only downscale in the grab when
+  // the whole item is wanted.
+  QSharedPointer<QQuickItemGrabResult> grabResult =
+    item->grabToImage(region.isNull() ? imageSize : QSize());
+  if (grabResult.isNull()) {
+    reject(m_bridge, QVariantList{ QVariantMap{{"error", "Unable to grab view"}}});
+    return;
+  }
+  connect(grabResult.data(), &QQuickItemGrabResult::ready, [=] {
+      callback(grabResult->image());
+    });
+}
+
+namespace {
+// Tile edge for diff snapshots; coarse enough that the hash pass is cheap,
+// fine enough to localize a changed widget.
+const int kSnapshotTileSize = 64;
+
+QVector<quint32> snapshotTileHashes(const QImage& image)
+{
+  const int columns = (image.width() + kSnapshotTileSize - 1) / kSnapshotTileSize;
+  const int rows = (image.height() + kSnapshotTileSize - 1) / kSnapshotTileSize;
+
+  QVector<quint32> hashes;
+  hashes.reserve(columns * rows);
+  for (int ty = 0; ty < rows; ++ty) {
+    for (int tx = 0; tx < columns; ++tx) {
+      const int x0 = tx * kSnapshotTileSize;
+      const int y0 = ty * kSnapshotTileSize;
+      const int x1 = qMin(x0 + kSnapshotTileSize, image.width());
+      const int y1 = qMin(y0 + kSnapshotTileSize, image.height());
+
+      // FNV-1a over the tile's pixel bytes
+      quint32 hash = 2166136261u;
+      for (int y = y0; y < y1; ++y) {
+        const uchar* p = image.constScanLine(y) + x0 * 4;
+        for (const uchar* end = p + (x1 - x0) * 4; p != end; ++p) {
+          hash = (hash ^ *p) * 16777619u;
+        }
+      }
+      hashes.append(hash);
     }
-    QSharedPointer<QQuickItemGrabResult> grabResult = item->grabToImage(imageSize);
-    connect(grabResult.data(), &QQuickItemGrabResult::ready, [=] {
-        callback(grabResult->image());
-      });
   }
+  return hashes;
+}
+}
+
+void ReactUIManager::resolveSnapshotDiff(
+  const QString& target,
+  const QImage& image,
+  const ReactModuleInterface::ListArgumentBlock& resolve
+) {
+  QImage pixels = image;
+  if (pixels.format() != QImage::Format_RGB32 &&
+      pixels.format() != QImage::Format_ARGB32) {
+    pixels = pixels.convertToFormat(QImage::Format_ARGB32);
+  }
+
+  QVector<quint32> hashes = snapshotTileHashes(pixels);
+  QVector<quint32>& baseline = m_snapshotBaselines[target];
+
+  // A resized grid invalidates tile indices wholesale; every tile then
+  // reports as changed, which is also the first-snapshot behaviour.
+  QVariantList changed;
+  for (int i = 0; i < hashes.size(); ++i) {
+    if (i >= baseline.size() || baseline.at(i) != hashes.at(i)) {
+      changed.append(QVariantMap{{"tile", i}, {"hash", hashes.at(i)}});
+    }
+  }
+  baseline = hashes;
+
+  resolve(m_bridge, QVariantList{QVariantMap{
+      {"width", pixels.width()},
+      {"height", pixels.height()},
+      {"tileSize", kSnapshotTileSize},
+      {"columns", (pixels.width() + kSnapshotTileSize - 1) / kSnapshotTileSize},
+      {"changedTiles", changed}
+    }});
 }
 
 
 ReactUIManager::ReactUIManager()
   : m_bridge(nullptr)
+  , m_viewCount(0)
+  , m_flushScheduled(false)
+  , m_reapScheduled(false)
+  , m_prewarmScheduled(false)
 {
 }
 
@@ -476,13 +875,94 @@ ReactUIManager::~ReactUIManager()
 
 void ReactUIManager::reset()
 {
-  for (auto& v : m_views) {
-    v->setParentItem(nullptr);
-    v->deleteLater();
+  // Clearing the surface only needs the top-level items detached; an item
+  // whose visual parent is itself a registered view disappears with its
+  // ancestor, so the per-item scene graph invalidation is skipped for the
+  // whole interior of the tree.
+  QSet<QQuickItem*> registered;
+  for (const ViewSlot& slot : m_viewSlots) {
+    if (slot.entry.item != nullptr)
+      registered.insert(slot.entry.item);
+  }
+  for (ViewSlot& slot : m_viewSlots) {
+    QQuickItem* item = slot.entry.item;
+    if (item == nullptr)
+      continue;
+    if (!registered.contains(item->parentItem()))
+      item->setParentItem(nullptr);
+    m_reapQueue.append(item);
+    slot.entry = ViewEntry();
+    ++slot.generation;
+  }
+  m_viewCount = 0;
+  if (!m_reapQueue.isEmpty() && !m_reapScheduled) {
+    m_reapScheduled = true;
+    QTimer::singleShot(0, this, SLOT(reapViews()));
   }
   m_bridge->visualParent()->polish();
 }
 
+void ReactUIManager::reapViews()
+{
+  // QQuickItems have to die on the GUI thread, so the reaper is a bounded
+  // slice per event loop turn rather than a thread: reset() returns as soon
+  // as the old tree is detached, and its destructors amortize across turns
+  // while the fresh surface boots in between.
+  const int kReapSlice = 64;
+  for (int reaped = 0; reaped < kReapSlice && !m_reapQueue.isEmpty(); ++reaped) {
+    QPointer<QQuickItem> item = m_reapQueue.takeFirst();
+    if (!item.isNull())
+      delete item.data();
+  }
+  m_reapScheduled = !m_reapQueue.isEmpty();
+  if (m_reapScheduled)
+    QTimer::singleShot(0, this, SLOT(reapViews()));
+}
+
+void ReactUIManager::prewarmViewsFor(QQuickItem* contentItem)
+{
+  // One plan at a time: viewportChanged fires on every scroll delta and the
+  // types under a list barely shift between deltas, so a new plan is only
+  // drawn up once the previous one has drained.
+  if (!m_prewarmQueue.isEmpty())
+    return;
+
+  QHash<ReactComponentData*, int> counts;
+  for (QQuickItem* child : contentItem->childItems()) {
+    if (ReactAttachedProperties::get(child, false) == nullptr)
+      continue;
+    ReactComponentData* cd = componentDataForView(child);
+    if (cd != nullptr)
+      counts[cd] += 1;
+  }
+
+  // Roughly a screenful of headroom per type; prewarmView stops at the pool
+  // cap regardless, so an already-warm pool costs a size check per slice.
+  const int kMaxPrewarmPerType = 12;
+  for (auto it = counts.constBegin(); it != counts.constEnd(); ++it) {
+    const int target = qMin(it.value(), kMaxPrewarmPerType);
+    for (int i = 0; i < target; ++i)
+      m_prewarmQueue.append(it.key());
+  }
+  schedulePrewarm();
+}
+
+void ReactUIManager::schedulePrewarm()
+{
+  if (m_prewarmQueue.isEmpty() || m_prewarmScheduled)
+    return;
+  m_prewarmScheduled = true;
+  // One instantiation per task so the scheduler's budget pacing decides how
+  // many land per frame; CacheMaintenance only runs in idle slices anyway.
+  m_bridge->scheduler()->schedule(ReactScheduler::CacheMaintenance, [this] {
+    m_prewarmScheduled = false;
+    if (m_prewarmQueue.isEmpty())
+      return;
+    m_prewarmQueue.takeFirst()->prewarmView();
+    schedulePrewarm();
+  });
+}
+
 void ReactUIManager::setBridge(ReactBridge* bridge)
 {
   // qDebug() << __PRETTY_FUNCTION__;
@@ -501,6 +981,8 @@ void ReactUIManager::setBridge(ReactBridge* bridge)
     }
   }
 
+  connect(m_bridge, SIGNAL(endOfBatch()), SLOT(scheduleFlush()));
+
   connect(m_bridge->visualParent(), SIGNAL(widthChanged()), SLOT(rootViewWidthChanged()));
   connect(m_bridge->visualParent(), SIGNAL(heightChanged()), SLOT(rootViewHeightChanged()));
   connect(m_bridge->visualParent(), SIGNAL(scaleChanged()), SLOT(rootViewScaleChanged()));
@@ -587,13 +1069,153 @@ int ReactUIManager::allocateRootTag()
 
 void ReactUIManager::registerRootView(QQuickItem* root)
 {
-  ReactAttachedProperties* properties = ReactAttachedProperties::get(root);
-  m_views.insert(properties->tag(), root);
+  ViewEntry entry = makeViewEntry(root);
+  insertViewEntry(entry.properties->tag(), entry);
+
+  reactFrameMonitorAttach(root->window());
 }
 
 QQuickItem* ReactUIManager::viewForTag(int reactTag)
 {
-  return m_views.value(reactTag);
+  return viewEntryForTag(reactTag).item;
+}
+
+namespace {
+// Bump when the node layout below changes; a stale file is simply ignored.
+const quint32 kFirstFrameMagic = 0x52464601; // 'RFF' 1
+// Facsimile tags live outside both the root tag sequence and the positive
+// tags JS assigns, so no real operation can resolve one.
+const int kFirstFrameTagBase = -1000;
+
+QString firstFrameCachePath(const QUrl& bundleUrl)
+{
+  QCryptographicHash hash(QCryptographicHash::Sha1);
+  hash.addData(bundleUrl.toString().toUtf8());
+  return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) +
+    "/react-first-frame-" + hash.result().toHex() + ".dat";
+}
+}
+
+void ReactUIManager::saveFirstFrameSnapshot()
+{
+  QQuickItem* root = m_bridge->visualParent();
+  if (root == nullptr || m_viewCount <= 1)
+    return;
+
+  QHash<QQuickItem*, const ViewEntry*> entries;
+  for (const ViewSlot& slot : m_viewSlots) {
+    if (slot.entry.item != nullptr)
+      entries.insert(slot.entry.item, &slot.entry);
+  }
+
+  QByteArray blob;
+  QDataStream nodes(&blob, QIODevice::WriteOnly);
+  nodes.setVersion(QDataStream::Qt_5_0);
+
+  // Parent-before-child order, so replay can parent each node to an
+  // already-created item by index.
+  qint32 count = 0;
+  std::function<void(QQuickItem*, qint32)> serialize = [&](QQuickItem* item, qint32 parentIndex) {
+    for (QQuickItem* child : item->childItems()) {
+      const ViewEntry* entry = entries.value(child);
+      if (entry == nullptr || entry->viewName.isEmpty())
+        continue;
+      nodes << parentIndex << entry->viewName << entry->props
+            << child->x() << child->y() << child->width() << child->height()
+            << child->z();
+      ++count;
+      serialize(child, count - 1);
+    }
+  };
+  serialize(root, -1);
+
+  if (count == 0)
+    return;
+
+  const QString cachePath = firstFrameCachePath(m_bridge->bundleUrl());
+  QDir().mkpath(QFileInfo(cachePath).absolutePath());
+  QFile out(cachePath);
+  if (out.open(QIODevice::WriteOnly)) {
+    QDataStream header(&out);
+    header.setVersion(QDataStream::Qt_5_0);
+    header << kFirstFrameMagic << root->width() << root->height() << count;
+    out.write(blob);
+  }
+}
+
+void ReactUIManager::replayFirstFrameSnapshot()
+{
+  QQuickItem* root = m_bridge->visualParent();
+  if (root == nullptr)
+    return;
+
+  QFile in(firstFrameCachePath(m_bridge->bundleUrl()));
+  if (!in.open(QIODevice::ReadOnly))
+    return;
+
+  QDataStream stream(&in);
+  stream.setVersion(QDataStream::Qt_5_0);
+  qint32 count = 0;
+  quint32 magic = 0;
+  double rootWidth = 0, rootHeight = 0;
+  stream >> magic >> rootWidth >> rootHeight >> count;
+  if (magic != kFirstFrameMagic || count <= 0)
+    return;
+  // The geometry was resolved for that root size; a resized window would
+  // paint a visibly wrong frame, worse than a blank one.
+  if (qAbs(rootWidth - root->width()) > 0.5 || qAbs(rootHeight - root->height()) > 0.5)
+    return;
+
+  QVector<QQuickItem*> items(count, nullptr);
+  for (qint32 i = 0; i < count && !stream.atEnd(); ++i) {
+    qint32 parentIndex = -1;
+    QString viewName;
+    QVariantMap props;
+    double x, y, width, height, z;
+    stream >> parentIndex >> viewName >> props >> x >> y >> width >> height >> z;
+    if (stream.status() != QDataStream::Ok)
+      break;
+
+    // A subtree under a type this binary no longer exports just stays out
+    // of the facsimile.
+    QQuickItem* parent = parentIndex < 0 ? root : items.value(parentIndex);
+    ReactComponentData* cd = m_componentData.value(viewName);
+    if (parent == nullptr || cd == nullptr)
+      continue;
+
+    QQuickItem* item = cd->createView(kFirstFrameTagBase - i, props);
+    if (item == nullptr)
+      continue;
+    ReactAttachedProperties::get(item)->applyProperties(props);
+    item->setX(x);
+    item->setY(y);
+    item->setWidth(width);
+    item->setHeight(height);
+    item->setZ(z);
+    item->setParentItem(parent);
+    items[i] = item;
+
+    if (parentIndex < 0) {
+      // Disabled at the top so the whole facsimile is skipped by hit
+      // testing; touches before the real mount land on the root view.
+      item->setEnabled(false);
+      m_firstFrameItems.append(item);
+    }
+  }
+
+  if (!m_firstFrameItems.isEmpty())
+    root->polish();
+}
+
+void ReactUIManager::dismissFirstFrame()
+{
+  if (m_firstFrameItems.isEmpty())
+    return;
+  for (QQuickItem* item : m_firstFrameItems) {
+    item->setParentItem(nullptr);
+    item->deleteLater();
+  }
+  m_firstFrameItems.clear();
 }
 
 void ReactUIManager::rootViewWidthChanged()
@@ -14,15 +14,25 @@
 #ifndef REACTUIMANAGER_H
 #define REACTUIMANAGER_H
 
+#include <functional>
+
+#include <QHash>
+#include <QPointer>
 #include <QString>
 #include <QVariant>
+#include <QVector>
 #include <QObject>
 
 #include "reactmoduleinterface.h"
 
 
+class QImage;
+class QQuickItem;
+
 class ReactBridge;
 class ReactComponentData;
+class ReactAttachedProperties;
+class ReactFlexLayout;
 
 
 class ReactUIManager
@@ -38,6 +48,13 @@ class ReactUIManager
   // Q_INVOKABLE void setMainScrollViewTag();
   // Q_INVOKABLE void focus();
   Q_INVOKABLE void measure(int reactTag, const ReactModuleInterface::ListArgumentBlock& callback);
+  // Resolves a whole list of measure requests in one pass and answers with
+  // one combined payload; each request is a map with reactTag and an
+  // optional ancestorReactTag for relative measurement. List code measuring
+  // dozens of rows after a layout pass pays one callback dispatch instead
+  // of one per row.
+  Q_INVOKABLE void measureBatch(const QVariantList& requests,
+                                const ReactModuleInterface::ListArgumentBlock& callback);
   // Q_INVOKABLE void removeRootView();
   Q_INVOKABLE void updateView(int reactTag,
                               const QString& viewName,
@@ -97,17 +114,133 @@ public:
 
   QQuickItem* viewForTag(int reactTag);
 
+  // Render-ahead for list content: tops up the recycling pools of the view
+  // types found under contentItem, one instantiation per idle slice on the
+  // frame-budget scheduler. Rows revealed by the next flick are
+  // overwhelmingly the same types as the rows already mounted, so the
+  // reveal batch attaches pooled views instead of instantiating QML
+  // components at fling speed. Props and layout still land when JS mounts
+  // the row; the prewarm covers the instantiation, which dominates.
+  void prewarmViewsFor(QQuickItem* contentItem);
+
+  // First-frame cache: the view hierarchy (types, resolved props, layout
+  // geometry) serializes to a compact binary file at session end and replays
+  // at the next launch as a disabled facsimile, painted while the executor
+  // is still off fetching and evaluating the bundle. The first applied batch
+  // from JS carries the real mount and dismisses it.
+  void saveFirstFrameSnapshot();
+  void replayFirstFrameSnapshot();
+
 public Q_SLOTS:
   void rootViewWidthChanged();
   void rootViewHeightChanged();
   void rootViewScaleChanged();
 
+private Q_SLOTS:
+  void scheduleFlush();
+  void flushPendingOperations();
+  void reapViews();
+
 private:
+  // View operations queue up as they arrive from the bridge and are applied
+  // in one pass per frame, as a layout-apply task on the bridge scheduler,
+  // with a single polish of the scene instead of one invalidation per
+  // operation.
+  void scheduleOperation(std::function<void()>&& operation);
+
+  void doRemoveSubviewsFromContainerWithID(int containerReactTag);
+  void doMeasure(int reactTag, const ReactModuleInterface::ListArgumentBlock& callback);
+  void doMeasureBatch(const QVariantList& requests,
+                      const ReactModuleInterface::ListArgumentBlock& callback);
+  void doUpdateView(int reactTag, const QString& viewName, const QVariantMap& properties);
+  void doManageChildren(int containerReactTag,
+                        const QList<int>& moveFromIndicies,
+                        const QList<int>& moveToIndices,
+                        const QList<int>& addChildReactTags,
+                        const QList<int>& addAtIndices,
+                        const QList<int>& removeAtIndices);
+  void doReplaceExistingNonRootView(int reactTag, int newReactTag);
+  void doMeasureLayout(int reactTag,
+                       int ancestorReactTag,
+                       const ReactModuleInterface::ListArgumentBlock& errorCallback,
+                       const ReactModuleInterface::ListArgumentBlock& callback);
+  void doMeasureLayoutRelativeToParent(int reactTag,
+                                       const ReactModuleInterface::ListArgumentBlock& errorCallback,
+                                       const ReactModuleInterface::ListArgumentBlock& callback);
+  void doCreateView(int reactTag, const QString& viewName, int rootTag, const QVariantMap& props);
+  void doFindSubviewIn(int reactTag,
+                       const QPointF& point,
+                       const ReactModuleInterface::ListArgumentBlock& callback);
+  void doDispatchViewManagerCommand(int reactTag, int commandID, const QVariantList& commandArgs);
+
+  ReactComponentData* componentDataForView(QQuickItem* view) const;
+
+  void schedulePrewarm();
+
+  // Attached objects resolved once when a view enters the tag table;
+  // qmlAttachedPropertiesObject walks QML's attached-property machinery on
+  // every call, and the update path used to pay for that walk on every prop
+  // write. layout is null for views that don't take part in flex layout.
+  struct ViewEntry {
+    QQuickItem* item = nullptr;
+    ReactAttachedProperties* properties = nullptr;
+    ReactFlexLayout* layout = nullptr;
+    // Type and accumulated props, retained for the first-frame snapshot;
+    // the maps share their data with what the bridge delivered.
+    QString viewName;
+    QVariantMap props;
+  };
+
+  static ViewEntry makeViewEntry(QQuickItem* item);
+
+  // Dense generational tag registry. React tags are small integers handed
+  // out sequentially by JS, so a vector indexed by tag resolves a view with
+  // one array index instead of an associative walk on every updateView,
+  // manageChildren and measure. Each slot carries a generation that bumps on
+  // insert and removal, so a slot reused after
+  // removeSubviewsFromContainerWithID is a new incarnation and any stale
+  // reference to the old one is detectable by comparing generations.
+  struct ViewSlot {
+    ViewEntry entry;
+    quint32 generation = 0;
+  };
+
+  // Copy of the entry (empty when the tag is unknown), mirroring the old
+  // QMap::value contract.
+  ViewEntry viewEntryForTag(int tag) const;
+  // Pointer into the slot for in-place updates; null when unknown.
+  ViewEntry* mutableViewEntryForTag(int tag);
+  void insertViewEntry(int tag, const ViewEntry& entry);
+  void removeViewEntry(int tag);
+
+  // Hashes the snapshot as a tile grid and resolves with the tiles that
+  // changed since the previous diff snapshot of the same target.
+  void resolveSnapshotDiff(const QString& target,
+                           const QImage& image,
+                           const ReactModuleInterface::ListArgumentBlock& resolve);
+
+  void dismissFirstFrame();
+
   static int m_nextRootTag;
 
   ReactBridge* m_bridge;
   QMap<QString, ReactComponentData*> m_componentData;
-  QMap<int, QQuickItem*> m_views;
+  QVector<ViewSlot> m_viewSlots;
+  int m_viewCount;
+  QVector<std::function<void()>> m_pendingOperations;
+  QHash<QString, QVector<quint32>> m_snapshotBaselines;
+  // Top-level facsimile items from the replayed snapshot; their subtrees
+  // are plain child items and go with them.
+  QList<QQuickItem*> m_firstFrameItems;
+  // Detached view trees from reset(), awaiting incremental destruction.
+  // QPointer because an ancestor with QObject-parented descendants takes
+  // them along when it goes.
+  QList<QPointer<QQuickItem>> m_reapQueue;
+  // One pool top-up per entry; drained one instantiation per idle slice.
+  QList<ReactComponentData*> m_prewarmQueue;
+  bool m_flushScheduled;
+  bool m_reapScheduled;
+  bool m_prewarmScheduled;
 };
 
 #endif // REACTUIMANAGER_H
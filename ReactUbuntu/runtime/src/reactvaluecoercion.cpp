@@ -13,8 +13,13 @@
 
 #include <iterator>
 #include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <utility>
+#include <vector>
 
 #include <QDateTime>
+#include <QHash>
 #include <QPointF>
 #include <QColor>
 #include <QString>
@@ -27,8 +32,94 @@
 #include "reactnetworking.h"
 
 
-// XXX: should have some way for modules to add these
-QMap<int, coerce_function> coerceFunctions
+namespace {
+
+// Flat open-addressing table over metatype ids: power-of-two capacity with
+// linear probing, so a lookup is a hash and a short contiguous scan instead
+// of a red-black tree traversal per coerced value. Entry functors with small
+// captures stay in std::function's inline buffer, so the built-ins (all
+// capture-free) never allocate.
+class CoerceTable {
+public:
+  CoerceTable() {
+    m_entries.resize(kInitialCapacity);
+  }
+
+  void insert(int key, const coerce_function& fn) {
+    if ((m_size + 1) * 2 > m_entries.size())
+      grow();
+    Entry* entry = probe(m_entries, key);
+    if (entry->key == kEmptyKey) {
+      entry->key = key;
+      ++m_size;
+    }
+    entry->fn = fn; // last registration wins
+  }
+
+  const coerce_function* find(int key) const {
+    const Entry* entry = probe(m_entries, key);
+    return entry->key == kEmptyKey ? nullptr : &entry->fn;
+  }
+
+private:
+  struct Entry {
+    int key = kEmptyKey;
+    coerce_function fn;
+  };
+
+  // 0 is QMetaType::UnknownType, which is never a parameter type.
+  static const int kEmptyKey = 0;
+  static const size_t kInitialCapacity = 64;
+
+  template<typename Entries>
+  static auto probe(Entries& entries, int key) -> decltype(&entries.front()) {
+    size_t mask = entries.size() - 1;
+    size_t pos = (size_t(quint32(key)) * 2654435761u) & mask;
+    while (entries[pos].key != kEmptyKey && entries[pos].key != key)
+      pos = (pos + 1) & mask;
+    return &entries[pos];
+  }
+
+  void grow() {
+    std::vector<Entry> bigger(m_entries.size() * 2);
+    for (Entry& entry : m_entries) {
+      if (entry.key == kEmptyKey)
+        continue;
+      Entry* slot = probe(bigger, entry.key);
+      slot->key = entry.key;
+      slot->fn = std::move(entry.fn);
+    }
+    m_entries.swap(bigger);
+  }
+
+  std::vector<Entry> m_entries;
+  size_t m_size = 0;
+};
+
+void registerBuiltinCoercions(CoerceTable& table);
+
+// Styling payloads repeat heavily — a screenful of views shares a few colors
+// and transform shapes — so the color and transform coercions below memoize
+// their boxed results and repeated property writes reuse one shared variant
+// instead of re-converting and re-allocating each time. Both types only flow
+// through view property application on the GUI thread, so the caches are
+// unlocked. Bounded by wholesale reset; entries are tiny and a working set
+// anywhere near the limit would already mean pathological styling.
+const int kParseCacheLimit = 512;
+
+CoerceTable& coerceTable()
+{
+  static CoerceTable* table = [] {
+    CoerceTable* t = new CoerceTable;
+    registerBuiltinCoercions(*t);
+    return t;
+  }();
+  return *table;
+}
+
+void registerBuiltinCoercions(CoerceTable& table)
+{
+  const std::pair<int, coerce_function> builtins[] =
 {
   {
     qMetaTypeId<QDateTime>(),
@@ -51,10 +142,21 @@ QMap<int, coerce_function> coerceFunctions
     qMetaTypeId<QVector<float>>(),
     [](const QVariant& value) {
       Q_ASSERT(value.canConvert<QVariantList>());
+      // Transform matrices; keyed by the structural hash (same collision
+      // stance as prop diffing).
+      static QHash<quint64, QVariant> cache;
+      const quint64 key = reactPropertyHash(value);
+      auto it = cache.constFind(key);
+      if (it != cache.constEnd())
+        return it.value();
       QVariantList s = value.toList();
       QVector<float> r;
       std::transform(s.begin(), s.end(), std::back_inserter(r), [](const QVariant& v) { return v.toFloat(); });
-      return QVariant::fromValue(r);
+      if (cache.size() >= kParseCacheLimit)
+        cache.clear();
+      QVariant boxed = QVariant::fromValue(r);
+      cache.insert(key, boxed);
+      return boxed;
     }
   },
   {
@@ -138,11 +240,79 @@ QMap<int, coerce_function> coerceFunctions
     qMetaTypeId<QColor>(),
     [](const QVariant& value) {
       Q_ASSERT(value.canConvert<uint>());
-      return QVariant::fromValue(QColor::fromRgba(value.toUInt()));
+      static QHash<quint32, QVariant> cache;
+      const quint32 rgba = value.toUInt();
+      auto it = cache.constFind(rgba);
+      if (it != cache.constEnd())
+        return it.value();
+      if (cache.size() >= kParseCacheLimit)
+        cache.clear();
+      QVariant boxed = QVariant::fromValue(QColor::fromRgba(rgba));
+      cache.insert(rgba, boxed);
+      return boxed;
     }
   }
 };
 
+  for (const auto& builtin : builtins) {
+    table.insert(builtin.first, builtin.second);
+  }
+}
+
+// FNV-1a style fold; 64 bits so a collision skipping a real update is not a
+// practical concern.
+inline quint64 hashFold(quint64 seed, quint64 value)
+{
+  return (seed ^ value) * Q_UINT64_C(1099511628211);
+}
+
+} // namespace
+
+quint64 reactPropertyHash(const QVariant& value)
+{
+  switch (value.type()) {
+  case QVariant::Invalid:
+    return Q_UINT64_C(0xcbf29ce484222325);
+  case QVariant::Bool:
+    return value.toBool() ? 1 : 2;
+  case QVariant::Int:
+  case QVariant::UInt:
+  case QVariant::LongLong:
+  case QVariant::ULongLong:
+    return hashFold(3, quint64(value.toLongLong()));
+  case QVariant::Double: {
+    const double d = value.toDouble();
+    quint64 bits;
+    memcpy(&bits, &d, sizeof(bits));
+    return hashFold(4, bits);
+  }
+  case QVariant::String:
+    return hashFold(5, qHash(value.toString()));
+  case QVariant::Map: {
+    // QVariantMap iterates in key order, so equal maps fold identically.
+    quint64 seed = 6;
+    const QVariantMap map = value.toMap();
+    for (auto it = map.constBegin(); it != map.constEnd(); ++it) {
+      seed = hashFold(seed, qHash(it.key()));
+      seed = hashFold(seed, reactPropertyHash(it.value()));
+    }
+    return seed;
+  }
+  case QVariant::List: {
+    quint64 seed = 7;
+    for (const QVariant& item : value.toList())
+      seed = hashFold(seed, reactPropertyHash(item));
+    return seed;
+  }
+  default:
+    return hashFold(quint64(value.type()) << 8, qHash(value.toString()));
+  }
+}
+
+void reactRegisterCoercion(int parameterType, const coerce_function& coerceFunction)
+{
+  coerceTable().insert(parameterType, coerceFunction);
+}
 
 QVariant reactCoerceValue(const QVariant& data, int parameterType, const coerce_map* userCoercions)
 {
@@ -154,18 +324,17 @@ QVariant reactCoerceValue(const QVariant& data, int parameterType, const coerce_
     return data;
   }
 
-  coerce_function coerceFunction;
-
   // User supplied coercions first
-  if (userCoercions != nullptr)
-    coerceFunction = userCoercions->value(parameterType);
-
-  // RN coercion functions
-  if (!coerceFunction)
-    coerceFunction = coerceFunctions.value(parameterType);
+  if (userCoercions != nullptr) {
+    coerce_function coerceFunction = userCoercions->value(parameterType);
+    if (coerceFunction)
+      return coerceFunction(data);
+  }
 
-  if (coerceFunction)
-    return coerceFunction(data);
+  // RN and plugin-registered coercion functions
+  const coerce_function* coerceFunction = coerceTable().find(parameterType);
+  if (coerceFunction != nullptr)
+    return (*coerceFunction)(data);
 
   // QVariant coercions
   if (data.canConvert(parameterType)) {
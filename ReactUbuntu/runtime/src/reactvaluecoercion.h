@@ -24,6 +24,15 @@ typedef QMap<int, coerce_function> coerce_map;
 
 QVariant reactCoerceValue(const QVariant& data, int parameterType, const coerce_map* userCoercions = nullptr);
 
+// Structural hash over a property payload value: scalars hash their bits,
+// maps and lists fold their entries in. Used to detect resends of an
+// unchanged value without keeping a copy of the old one around.
+quint64 reactPropertyHash(const QVariant& value);
+
+// Adds a coercion to the global table; last registration for a type wins.
+// Plugin modules extend the table through ReactModuleInterface::coercionsToExport.
+void reactRegisterCoercion(int parameterType, const coerce_function& coerceFunction);
+
 #endif // REACTVALUECOERCION_H
 
 
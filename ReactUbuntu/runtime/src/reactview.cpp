@@ -13,9 +13,12 @@
 
 #include <QQmlEngine>
 #include <QTimer>
+#include <QUrlQuery>
 
 #include "reactevents.h"
 #include "reactbridge.h"
+#include "reacthotreload.h"
+#include "reacteventdispatcher.h"
 #include "reactuimanager.h"
 #include "reactattachedproperties.h"
 #include "reactflexlayout.h"
@@ -28,8 +31,6 @@ QVariantMap makeReactTouchEvent(QQuickItem* item, QMouseEvent* event)
 {
   const QPointF& lp = event->localPos();
 
-  QVariantMap e;
-
   // Find the deepest match
   QQuickItem* target = nullptr;
   QQuickItem* next = item;
@@ -45,19 +46,23 @@ QVariantMap makeReactTouchEvent(QQuickItem* item, QMouseEvent* event)
   ReactAttachedProperties* ap = ReactAttachedProperties::get(target, false);
   if (ap == nullptr) {
     qWarning() << __PRETTY_FUNCTION__ << "target was not a reactItem";
-    return e;
+    return QVariantMap{};
   }
 
-  e.insert("target", ap->tag());
-  e.insert("identifier", 1);
-  e.insert("touches", QVariant());
-  e.insert("changedTouches", QVariant());
+  // A pooled map with interned keys; a steady move stream overwrites the
+  // same nodes in place instead of rebuilding this map per event.
+  QVariantMap e = reactAcquireEventPayload();
+
+  e.insert(reactInternedString("target"), ap->tag());
+  e.insert(reactInternedString("identifier"), 1);
+  e.insert(reactInternedString("touches"), QVariant());
+  e.insert(reactInternedString("changedTouches"), QVariant());
 
-  e.insert("pageX", lp.x());
-  e.insert("pageY", lp.y());
-  e.insert("locationX", local.x());
-  e.insert("locationY", local.y());
-  e.insert("timestamp", QVariant::fromValue(event->timestamp()));
+  e.insert(reactInternedString("pageX"), lp.x());
+  e.insert(reactInternedString("pageY"), lp.y());
+  e.insert(reactInternedString("locationX"), local.x());
+  e.insert(reactInternedString("locationY"), local.y());
+  e.insert(reactInternedString("timestamp"), QVariant::fromValue(event->timestamp()));
 
   return e;
 }
@@ -74,10 +79,20 @@ class ReactViewPrivate : public QObject
   Q_DECLARE_PUBLIC(ReactView)
 public:
   bool liveReload = false;
+  bool hotReload = false;
+  ReactHotReload* hotReloadClient = nullptr;
+  bool nativeGestures = true;
+  double tapSlop = 10;
+  // Pre-recognition state: where the active touch went down and whether it
+  // has already left the slop (after which every move is a pan update).
+  bool touchActive = false;
+  bool panning = false;
+  QPointF touchOrigin;
   QString moduleName;
   QUrl codeLocation;
   QVariantMap properties;
   QString pluginsPath;
+  QUrl warmupManifest;
   QString executor = "ReactNetExecutor";
   ReactBridge* bridge = nullptr;
   ReactView* q_ptr;
@@ -86,6 +101,32 @@ public:
     : q_ptr(q)
     {}
 
+  // Decides whether a move event carries gesture information worth the trip
+  // through the executor. Sub-slop jitter while a tap or long press is in
+  // flight does not; JS only acts on moves once they would cancel the press.
+  bool shouldForwardMove(QMouseEvent* event) {
+    if (!nativeGestures || !touchActive)
+      return true;
+    if (panning)
+      return true;
+    const QPointF delta = event->windowPos() - touchOrigin;
+    if (qAbs(delta.x()) > tapSlop || qAbs(delta.y()) > tapSlop) {
+      panning = true;
+      return true;
+    }
+    return false;
+  }
+
+  void startHotReload() {
+    if (codeLocation.scheme() != "http") {
+      qWarning() << "Can only hot reload when fetching from packager";
+      return;
+    }
+    if (hotReloadClient == nullptr)
+      hotReloadClient = new ReactHotReload(bridge);
+    hotReloadClient->start(codeLocation);
+  }
+
   void monitorChangeUrl() {
     if (codeLocation.scheme() != "http") {
       qWarning() << "Can only live reload when fetching from packager";
@@ -136,6 +177,13 @@ ReactView::ReactView(QQuickItem* parent)
 
 ReactView::~ReactView()
 {
+  Q_D(ReactView);
+
+  // The child items are still alive here; capture the session's final view
+  // hierarchy so the next launch can paint it as its first frame.
+  if (d->bridge->ready() && d->bridge->uiManager() != nullptr) {
+    d->bridge->uiManager()->saveFirstFrameSnapshot();
+  }
 }
 
 bool ReactView::liveReload() const
@@ -143,6 +191,21 @@ bool ReactView::liveReload() const
   return d_func()->liveReload;
 }
 
+bool ReactView::hotReload() const
+{
+  return d_func()->hotReload;
+}
+
+void ReactView::setHotReload(bool hotReload)
+{
+  Q_D(ReactView);
+  if (d->hotReload == hotReload)
+    return;
+
+  d->hotReload = hotReload;
+  emit hotReloadChanged();
+}
+
 void ReactView::setLiveReload(bool liveReload)
 {
   Q_D(ReactView);
@@ -207,11 +270,53 @@ void ReactView::setPluginsPath(const QString& pluginsPath)
   Q_EMIT pluginsPathChanged();
 }
 
+QUrl ReactView::warmupManifest() const
+{
+  return d_func()->warmupManifest;
+}
+
+void ReactView::setWarmupManifest(const QUrl& warmupManifest)
+{
+  Q_D(ReactView);
+  if (d->warmupManifest == warmupManifest)
+    return;
+  d->warmupManifest = warmupManifest;
+  Q_EMIT warmupManifestChanged();
+}
+
 QString ReactView::executor() const
 {
   return d_func()->executor;
 }
 
+bool ReactView::nativeGestures() const
+{
+  return d_func()->nativeGestures;
+}
+
+void ReactView::setNativeGestures(bool nativeGestures)
+{
+  Q_D(ReactView);
+  if (d->nativeGestures == nativeGestures)
+    return;
+  d->nativeGestures = nativeGestures;
+  Q_EMIT nativeGesturesChanged();
+}
+
+double ReactView::tapSlop() const
+{
+  return d_func()->tapSlop;
+}
+
+void ReactView::setTapSlop(double tapSlop)
+{
+  Q_D(ReactView);
+  if (d->tapSlop == tapSlop)
+    return;
+  d->tapSlop = tapSlop;
+  Q_EMIT tapSlopChanged();
+}
+
 void ReactView::setExecutor(const QString& executor)
 {
   Q_D(ReactView);
@@ -243,7 +348,9 @@ void ReactView::bridgeReady()
 
   d->bridge->enqueueJSCall("AppRegistry", "runApplication", args);
 
-  if (d->liveReload) {
+  if (d->hotReload) {
+    d->startHotReload();
+  } else if (d->liveReload) {
     d->monitorChangeUrl();
   }
 }
@@ -256,10 +363,20 @@ void ReactView::componentComplete()
 
   QTimer::singleShot(0, [=]() {
       // TODO: setQmlEngine && setNetworkAccessManager to be just setQmlEngine && then internal?
+      // The packager only includes its HMR runtime (and streams updates on
+      // /hot) for bundles requested hot.
+      QUrl bundleUrl = d->codeLocation;
+      if (d->hotReload && bundleUrl.scheme() == "http") {
+        QUrlQuery query(bundleUrl);
+        if (!query.hasQueryItem("hot"))
+          query.addQueryItem("hot", "true");
+        bundleUrl.setQuery(query);
+      }
       d->bridge->setQmlEngine(qmlEngine(this));
       d->bridge->setNetworkAccessManager(qmlEngine(this)->networkAccessManager());
-      d->bridge->setBundleUrl(d->codeLocation);
+      d->bridge->setBundleUrl(bundleUrl);
       d->bridge->setPluginsPath(d->pluginsPath);
+      d->bridge->setWarmupManifest(d->warmupManifest);
       d->bridge->setExecutorName(d->executor);
       d->bridge->setVisualParent(this);
       d->bridge->init();
@@ -275,26 +392,32 @@ void ReactView::mousePressEvent(QMouseEvent* event)
   if (e.isEmpty())
     return;
 
-  d->bridge->enqueueJSCall("RCTEventEmitter", "receiveTouches",
-                          QVariantList{ normalizeInputEventName("touchStart"),
-                                        QVariantList{e},
-                                        QVariantList{0} });
+  d->touchActive = true;
+  d->panning = false;
+  d->touchOrigin = event->windowPos();
+
+  d->bridge->eventDispatcher()->sendTouchEvent(normalizeInputEventName("touchStart"),
+                                               QVariantList{e},
+                                               QVariantList{0});
+  reactReleaseEventPayload(e);
   event->setAccepted(true);
 }
 
-// TODO: optimize this
 void ReactView::mouseMoveEvent(QMouseEvent* event)
 {
   Q_D(ReactView);
 
+  if (!d->shouldForwardMove(event))
+    return;
+
   QVariantMap e = makeReactTouchEvent(this, event);
   if (e.isEmpty())
     return;
 
-  d->bridge->enqueueJSCall("RCTEventEmitter", "receiveTouches",
-                           QVariantList{normalizeInputEventName("touchMove"),
-                                        QVariantList{e},
-                                        QVariantList{0}});
+  d->bridge->eventDispatcher()->sendTouchEvent(normalizeInputEventName("touchMove"),
+                                               QVariantList{e},
+                                               QVariantList{0});
+  reactReleaseEventPayload(e);
 }
 
 void ReactView::mouseReleaseEvent(QMouseEvent* event)
@@ -306,10 +429,12 @@ void ReactView::mouseReleaseEvent(QMouseEvent* event)
   if (e.isEmpty())
     return;
 
-  d->bridge->enqueueJSCall("RCTEventEmitter", "receiveTouches",
-                          QVariantList{ normalizeInputEventName("touchEnd"),
-                                        QVariantList{e},
-                                        QVariantList{0} });
+  d->touchActive = false;
+
+  d->bridge->eventDispatcher()->sendTouchEvent(normalizeInputEventName("touchEnd"),
+                                               QVariantList{e},
+                                               QVariantList{0});
+  reactReleaseEventPayload(e);
   event->setAccepted(true);
 }
 
@@ -328,25 +453,34 @@ bool ReactView::childMouseEventFilter(QQuickItem* item, QEvent* event)
     return false;
   }
 
-  QVariantMap e = makeReactTouchEvent(item, static_cast<QMouseEvent*>(event));
+  QMouseEvent* mouseEvent = static_cast<QMouseEvent*>(event);
+
+  if (event->type() == QEvent::MouseMove && !d->shouldForwardMove(mouseEvent))
+    return false;
+
+  QVariantMap e = makeReactTouchEvent(item, mouseEvent);
   if (e.isEmpty())
     return false;
 
   QString eventName;
   if (event->type() == QEvent::MouseButtonPress) {
     eventName = "touchStart";
+    d->touchActive = true;
+    d->panning = false;
+    d->touchOrigin = mouseEvent->windowPos();
   } else if (event->type() == QEvent::MouseButtonRelease) {
     eventName = "touchEnd";
+    d->touchActive = false;
   } else if (event->type() == QEvent::MouseMove) {
     eventName = "touchMove";
   }
 
-  QTimer::singleShot(0, [=]() {
-      d->bridge->enqueueJSCall("RCTEventEmitter", "receiveTouches",
-                              QVariantList{ normalizeInputEventName(eventName),
-                                            QVariantList{e},
-                                            QVariantList{0} });
-    });
+  // The dispatcher queues and defers delivery itself, so it is safe to call
+  // straight from the event filter.
+  d->bridge->eventDispatcher()->sendTouchEvent(normalizeInputEventName(eventName),
+                                               QVariantList{e},
+                                               QVariantList{0});
+  reactReleaseEventPayload(e);
 
   event->setAccepted(true);
   return false;
@@ -29,11 +29,15 @@ class ReactView : public ReactItem
   Q_OBJECT
 
   Q_PROPERTY(bool liveReload READ liveReload WRITE setLiveReload NOTIFY liveReloadChanged)
+  Q_PROPERTY(bool hotReload READ hotReload WRITE setHotReload NOTIFY hotReloadChanged)
   Q_PROPERTY(QString moduleName READ moduleName WRITE setModuleName NOTIFY moduleNameChanged)
   Q_PROPERTY(QUrl codeLocation READ codeLocation WRITE setCodeLocation NOTIFY codeLocationChanged)
   Q_PROPERTY(QVariantMap properties READ properties WRITE setProperties NOTIFY propertiesChanged)
   Q_PROPERTY(QString pluginsPath READ pluginsPath WRITE setPluginsPath NOTIFY pluginsPathChanged)
+  Q_PROPERTY(QUrl warmupManifest READ warmupManifest WRITE setWarmupManifest NOTIFY warmupManifestChanged)
   Q_PROPERTY(QString executor READ executor WRITE setExecutor NOTIFY executorChanged)
+  Q_PROPERTY(bool nativeGestures READ nativeGestures WRITE setNativeGestures NOTIFY nativeGesturesChanged)
+  Q_PROPERTY(double tapSlop READ tapSlop WRITE setTapSlop NOTIFY tapSlopChanged)
 
   Q_DECLARE_PRIVATE(ReactView)
 
@@ -44,6 +48,13 @@ public:
   bool liveReload() const;
   void setLiveReload(bool liveReload);
 
+  // Module-level reload from the packager: changed modules re-execute in
+  // the running JS host and the view tree is patched in place, instead of
+  // the full teardown and refetch liveReload does (see ReactHotReload).
+  // Takes precedence over liveReload when both are set.
+  bool hotReload() const;
+  void setHotReload(bool hotReload);
+
   QString moduleName() const;
   void setModuleName(const QString& moduleName);
 
@@ -56,16 +67,36 @@ public:
   QString pluginsPath() const;
   void setPluginsPath(const QString& pluginsPath);
 
+  // Manifest of components, modules and images warmed in idle time once the
+  // bridge is ready (see ReactWarmup).
+  QUrl warmupManifest() const;
+  void setWarmupManifest(const QUrl& warmupManifest);
+
   QString executor() const;
   void setExecutor(const QString& executor);
 
+  // Native gesture pre-recognition: touch moves inside the tap slop are
+  // classified here and never cross the executor; only gesture-relevant
+  // events (start, the move that breaks the slop, subsequent pan moves,
+  // end) are forwarded. Custom JS responders that want the full stream can
+  // opt out by clearing nativeGestures.
+  bool nativeGestures() const;
+  void setNativeGestures(bool nativeGestures);
+
+  double tapSlop() const;
+  void setTapSlop(double tapSlop);
+
 Q_SIGNALS:
   void liveReloadChanged();
+  void hotReloadChanged();
   void moduleNameChanged();
   void codeLocationChanged();
   void propertiesChanged();
   void pluginsPathChanged();
+  void warmupManifestChanged();
   void executorChanged();
+  void nativeGesturesChanged();
+  void tapSlopChanged();
 
 private Q_SLOTS:
   void bridgeReady();
@@ -120,6 +120,18 @@ bool ReactViewManager::shouldLayout() const
   return true;
 }
 
+void ReactViewManager::prepareForRecycle(QQuickItem* view) const
+{
+  QQmlListReference transform(view, "transform");
+  if (transform.isValid())
+    transform.clear();
+  view->setOpacity(1);
+  view->setZ(0);
+  view->setClip(false);
+  view->setRotation(0);
+  view->setScale(1);
+}
+
 void ReactViewManager::addChildItem(QQuickItem* container, QQuickItem* child, int position) const
 {
   // XXX: remove this
@@ -142,12 +154,11 @@ React.Item {
 
 QQuickItem* ReactViewManager::view(const QVariantMap& properties) const
 {
-  QQmlComponent component(m_bridge->qmlEngine());
-  component.setData(component_qml, QUrl());
-  if (!component.isReady())
-    qCritical() << "React.Item is not ready!" << component.errors();
+  QQmlComponent* component = m_bridge->componentForSource(componentSource());
+  if (!component->isReady())
+    qCritical() << "React.Item is not ready!" << component->errors();
 
-  QQuickItem* item = qobject_cast<QQuickItem*>(component.create());
+  QQuickItem* item = qobject_cast<QQuickItem*>(component->create());
   if (item == nullptr) {
     qCritical() << "Unable to construct React.Item";
     return nullptr;
@@ -156,5 +167,10 @@ QQuickItem* ReactViewManager::view(const QVariantMap& properties) const
   return item;
 }
 
+QByteArray ReactViewManager::componentSource() const
+{
+  return QByteArray(component_qml);
+}
+
 
 #include "reactviewmanager.moc"
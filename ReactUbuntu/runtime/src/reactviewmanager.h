@@ -50,8 +50,19 @@ public:
   virtual bool shouldLayout() const;
   virtual void addChildItem(QQuickItem* parent, QQuickItem* child, int position) const;
 
+  // Called before a detached view enters the recycling pool; resets any
+  // state the next incarnation should not inherit. Subclasses re-implement
+  // to clear type specific state and should call the base version.
+  virtual void prepareForRecycle(QQuickItem* view) const;
+
   virtual QQuickItem* view(const QVariantMap& properties = QVariantMap()) const;
 
+  // The QML source views of this type are instantiated from. The bridge
+  // compiles each distinct source once into a pinned blueprint component
+  // (ReactBridge::componentForSource); view() instantiates from that, so the
+  // source must not vary between calls.
+  virtual QByteArray componentSource() const;
+
 protected:
   ReactBridge* m_bridge;
 };
@@ -0,0 +1,132 @@
+
+/**
+ * Copyright (C) 2016, Canonical Ltd.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ *
+ * Author: Justin McPherson <justin.mcpherson@canonical.com>
+ *
+ */
+
+#include <QFile>
+#include <QQuickItem>
+
+#include <QDebug>
+
+#include "reactwarmup.h"
+#include "reactbridge.h"
+#include "reactimageloader.h"
+#include "reactjsonvalue.h"
+#include "reactmoduledata.h"
+#include "reactscheduler.h"
+#include "reactviewmanager.h"
+
+
+namespace
+{
+QString manifestFilePath(const QUrl& manifestUrl)
+{
+  if (manifestUrl.isLocalFile())
+    return manifestUrl.toLocalFile();
+  if (manifestUrl.scheme() == "qrc")
+    return ":" + manifestUrl.path();
+  return manifestUrl.toString();
+}
+}
+
+class ReactWarmupPrivate
+{
+public:
+  ReactModuleData* moduleByName(const QString& name) {
+    for (ReactModuleData* moduleData : bridge->modules()) {
+      if (moduleData->name() == name)
+        return moduleData;
+    }
+    return nullptr;
+  }
+
+  void warmComponent(const QString& name) {
+    ReactModuleData* moduleData = moduleByName(name);
+    ReactViewManager* manager = moduleData != nullptr ? moduleData->viewManager() : nullptr;
+    if (manager == nullptr) {
+      qWarning() << __PRETTY_FUNCTION__ << "No view manager named" << name;
+      return;
+    }
+    // view() compiles the blueprint on first use; building and discarding
+    // one instance additionally runs the type's first-instantiation work
+    // (theme lookups, style singletons) off the navigation path.
+    QQuickItem* item = manager->view();
+    if (item != nullptr)
+      item->deleteLater();
+  }
+
+  void warmModule(const QString& name) {
+    ReactModuleData* moduleData = moduleByName(name);
+    if (moduleData == nullptr) {
+      qWarning() << __PRETTY_FUNCTION__ << "No module named" << name;
+      return;
+    }
+    moduleData->warmUp();
+  }
+
+  ReactBridge* bridge = nullptr;
+};
+
+
+ReactWarmup::ReactWarmup(ReactBridge* bridge)
+  : QObject(bridge)
+  , d_ptr(new ReactWarmupPrivate)
+{
+  d_ptr->bridge = bridge;
+}
+
+ReactWarmup::~ReactWarmup()
+{
+}
+
+void ReactWarmup::run(const QUrl& manifestUrl)
+{
+  Q_D(ReactWarmup);
+
+  QFile manifestFile(manifestFilePath(manifestUrl));
+  if (!manifestFile.open(QIODevice::ReadOnly)) {
+    qWarning() << __PRETTY_FUNCTION__ << "Could not open warmup manifest" << manifestUrl;
+    return;
+  }
+
+  QVariantMap manifest = reactParseJson(manifestFile.readAll()).toMap();
+  if (manifest.isEmpty()) {
+    qWarning() << __PRETTY_FUNCTION__ << "Warmup manifest" << manifestUrl << "is not a JSON object";
+    return;
+  }
+
+  ReactScheduler* scheduler = d->bridge->scheduler();
+
+  for (const QVariant& entry : manifest.value("components").toList()) {
+    QString name = entry.toString();
+    scheduler->schedule(ReactScheduler::CacheMaintenance, [=] { d->warmComponent(name); });
+  }
+
+  for (const QVariant& entry : manifest.value("modules").toList()) {
+    QString name = entry.toString();
+    scheduler->schedule(ReactScheduler::CacheMaintenance, [=] { d->warmModule(name); });
+  }
+
+  for (const QVariant& entry : manifest.value("images").toList()) {
+    QVariantMap image = entry.toMap();
+    QUrl source(image.value("uri").toString());
+    QSize targetSize(image.value("width").toInt(), image.value("height").toInt());
+    // Cold images need fetching before the decode pool can touch them;
+    // predecode runs once the bytes have landed in the cache.
+    scheduler->schedule(ReactScheduler::CacheMaintenance, [=] {
+      ReactImageLoader* imageLoader = d->bridge->imageLoader();
+      imageLoader->loadImage(source, [=](ReactImageLoader::Event event, const QVariantMap&) {
+        if (event == ReactImageLoader::Event_Load)
+          imageLoader->predecodeImage(source, targetSize);
+      });
+    });
+  }
+}
@@ -0,0 +1,57 @@
+
+/**
+ * Copyright (C) 2016, Canonical Ltd.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ *
+ * Author: Justin McPherson <justin.mcpherson@canonical.com>
+ *
+ */
+
+#ifndef REACTWARMUP_H
+#define REACTWARMUP_H
+
+#include <QObject>
+#include <QScopedPointer>
+#include <QUrl>
+
+class ReactBridge;
+
+// Idle-time warmup orchestrator. Once the bridge reports ready, the entries
+// of a declarative manifest are executed one per CacheMaintenance slice of
+// the frame scheduler, so none of the work competes with startup or input
+// but the first navigation no longer pays for it either. The manifest is a
+// JSON file:
+//
+//   {
+//     "components": ["UbuntuButtonManager", ...],
+//     "modules": ["RCTNativeAnimation", ...],
+//     "images": [{"uri": "...", "width": 48, "height": 48}, ...]
+//   }
+//
+// Components are compiled and instantiated once (and the instance thrown
+// away, which also pulls in theme and style singletons); modules are the
+// lazily registered kind and get their instance constructed; images run
+// through the loader's predecode path into the decoded cache.
+class ReactWarmupPrivate;
+class ReactWarmup : public QObject
+{
+  Q_OBJECT
+  Q_DECLARE_PRIVATE(ReactWarmup)
+
+public:
+  ReactWarmup(ReactBridge* bridge);
+  ~ReactWarmup();
+
+  // Reads the manifest and queues one scheduler task per entry, in manifest
+  // order. Unknown names are skipped with a warning.
+  void run(const QUrl& manifestUrl);
+
+private:
+  QScopedPointer<ReactWarmupPrivate> d_ptr;
+};
+
+#endif // REACTWARMUP_H
@@ -0,0 +1,189 @@
+
+/**
+ * Copyright (C) 2016, Canonical Ltd.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ *
+ * Author: Justin McPherson <justin.mcpherson@canonical.com>
+ *
+ */
+
+#include <QMap>
+#include <QTimer>
+#include <QWebSocket>
+
+#include <QDebug>
+
+#include "reactwebsocket.h"
+#include "reactbridge.h"
+
+
+class ReactWebSocketPrivate {
+public:
+  ReactBridge* bridge = nullptr;
+  QMap<int, QWebSocket*> sockets;
+
+  // Receive-side frame batching. A busy socket delivers many small frames in
+  // one burst of event loop activity; each message is queued here and a
+  // zero-timer drains the queue once the burst has been read off the socket,
+  // so JS sees one coalesced event instead of one bridge crossing per frame.
+  QVariantList pendingMessages;
+  bool flushScheduled = false;
+
+  void queueMessage(QObject* owner, const QVariantMap& event) {
+    pendingMessages.append(event);
+    if (flushScheduled)
+      return;
+    flushScheduled = true;
+    QTimer::singleShot(0, owner, [=] { flushMessages(); });
+  }
+
+  void flushMessages() {
+    flushScheduled = false;
+    if (pendingMessages.isEmpty())
+      return;
+    // Single messages keep the stock event shape; only actual bursts go
+    // through the batched event, so platforms (and tests) that never
+    // coalesce see no difference.
+    if (pendingMessages.size() == 1) {
+      bridge->enqueueJSCall("RCTDeviceEventEmitter", "emit",
+                            QVariantList{"websocketMessage", pendingMessages.first()});
+    } else {
+      bridge->enqueueJSCall("RCTDeviceEventEmitter", "emit",
+                            QVariantList{"websocketMessages", pendingMessages});
+    }
+    pendingMessages.clear();
+  }
+
+  void sendEvent(const QString& name, const QVariantMap& event) {
+    bridge->enqueueJSCall("RCTDeviceEventEmitter", "emit",
+                          QVariantList{name, event});
+  }
+};
+
+
+void ReactWebSocket::connect(
+  const QUrl& url,
+  const QVariantList& protocols,
+  const QVariantMap& options,
+  int socketId
+) {
+  Q_D(ReactWebSocket);
+  Q_UNUSED(protocols); // QWebSocket has no subprotocol support
+  Q_UNUSED(options);
+
+  QWebSocket* socket = new QWebSocket(QString(), QWebSocketProtocol::VersionLatest, this);
+  d->sockets[socketId] = socket;
+
+  QObject::connect(socket, &QWebSocket::connected, [=] {
+    d->sendEvent("websocketOpen", QVariantMap{{"id", socketId}});
+  });
+  QObject::connect(socket, &QWebSocket::disconnected, [=] {
+    d->sendEvent("websocketClosed", QVariantMap{
+      {"id", socketId},
+      {"code", static_cast<int>(socket->closeCode())},
+      {"reason", socket->closeReason()}
+    });
+    d->sockets.remove(socketId);
+    socket->deleteLater();
+  });
+  QObject::connect(socket,
+      static_cast<void (QWebSocket::*)(QAbstractSocket::SocketError)>(&QWebSocket::error),
+      [=](QAbstractSocket::SocketError) {
+    d->sendEvent("websocketFailed", QVariantMap{
+      {"id", socketId},
+      {"message", socket->errorString()}
+    });
+  });
+  QObject::connect(socket, &QWebSocket::textMessageReceived, [=](const QString& message) {
+    d->queueMessage(this, QVariantMap{
+      {"id", socketId},
+      {"type", "text"},
+      {"data", message}
+    });
+  });
+  // Binary frames go out base64-encoded: the JSON bridge value encoding has
+  // no raw byte transport, and the JS side already decodes base64 for
+  // type "binary".
+  QObject::connect(socket, &QWebSocket::binaryMessageReceived, [=](const QByteArray& message) {
+    d->queueMessage(this, QVariantMap{
+      {"id", socketId},
+      {"type", "binary"},
+      {"data", QString::fromLatin1(message.toBase64())}
+    });
+  });
+
+  socket->open(url);
+}
+
+void ReactWebSocket::send(const QString& message, int socketId)
+{
+  Q_D(ReactWebSocket);
+  QWebSocket* socket = d->sockets.value(socketId);
+  if (socket == nullptr) {
+    qCritical() << __PRETTY_FUNCTION__ << "Send failed; no socket for id" << socketId;
+    return;
+  }
+  socket->sendTextMessage(message);
+}
+
+void ReactWebSocket::sendBinary(const QString& base64Data, int socketId)
+{
+  Q_D(ReactWebSocket);
+  QWebSocket* socket = d->sockets.value(socketId);
+  if (socket == nullptr) {
+    qCritical() << __PRETTY_FUNCTION__ << "Send failed; no socket for id" << socketId;
+    return;
+  }
+  socket->sendBinaryMessage(QByteArray::fromBase64(base64Data.toLatin1()));
+}
+
+void ReactWebSocket::close(int code, const QString& reason, int socketId)
+{
+  Q_D(ReactWebSocket);
+  QWebSocket* socket = d->sockets.value(socketId);
+  if (socket == nullptr)
+    return;
+  socket->close(code != 0 ? static_cast<QWebSocketProtocol::CloseCode>(code)
+                          : QWebSocketProtocol::CloseCodeNormal,
+                reason);
+}
+
+
+ReactWebSocket::ReactWebSocket(QObject* parent)
+  : QObject(parent)
+  , d_ptr(new ReactWebSocketPrivate)
+{
+}
+
+ReactWebSocket::~ReactWebSocket()
+{
+  Q_D(ReactWebSocket);
+  for (QWebSocket* socket : d->sockets) {
+    socket->abort();
+  }
+}
+
+void ReactWebSocket::setBridge(ReactBridge* bridge)
+{
+  Q_D(ReactWebSocket);
+  d->bridge = bridge;
+}
+
+QString ReactWebSocket::moduleName()
+{
+  return "RCTWebSocketModule";
+}
+
+QList<ReactModuleMethod*> ReactWebSocket::methodsToExport()
+{
+  return QList<ReactModuleMethod*>{};
+}
+
+QVariantMap ReactWebSocket::constantsToExport()
+{
+  return QVariantMap{};
+}
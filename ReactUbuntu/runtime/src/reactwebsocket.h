@@ -0,0 +1,54 @@
+
+/**
+ * Copyright (C) 2016, Canonical Ltd.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ *
+ * Author: Justin McPherson <justin.mcpherson@canonical.com>
+ *
+ */
+
+#ifndef REACTWEBSOCKET_H
+#define REACTWEBSOCKET_H
+
+#include <QUrl>
+
+#include "reactmoduleinterface.h"
+
+
+class ReactWebSocketPrivate;
+class ReactWebSocket
+  : public QObject
+  , public ReactModuleInterface
+{
+  Q_OBJECT
+  Q_INTERFACES(ReactModuleInterface)
+
+  Q_INVOKABLE void connect(const QUrl& url,
+                           const QVariantList& protocols,
+                           const QVariantMap& options,
+                           int socketId);
+  Q_INVOKABLE void send(const QString& message, int socketId);
+  Q_INVOKABLE void sendBinary(const QString& base64Data, int socketId);
+  Q_INVOKABLE void close(int code, const QString& reason, int socketId);
+
+  Q_DECLARE_PRIVATE(ReactWebSocket)
+
+public:
+  ReactWebSocket(QObject* parent = 0);
+  ~ReactWebSocket();
+
+  void setBridge(ReactBridge* bridge) override;
+
+  QString moduleName() override;
+  QList<ReactModuleMethod*> methodsToExport() override;
+  QVariantMap constantsToExport() override;
+
+private:
+  QScopedPointer<ReactWebSocketPrivate> d_ptr;
+};
+
+#endif // REACTWEBSOCKET_H
@@ -120,19 +120,19 @@ QVariantMap UbuntuComponentModule::constantsToExport()
   return QVariantMap{};
 }
 
+QByteArray UbuntuComponentModule::componentSource() const
+{
+  return QString("import Ubuntu.Components %1\n%2{}").arg(m_version).arg(m_name).toLocal8Bit();
+}
+
 QQuickItem* UbuntuComponentModule::view(const QVariantMap& properties) const
 {
   // qDebug() << __PRETTY_FUNCTION__ << "begin";
-  // Should probably build a string with import statement (using version)
-  // instead of doing this
-  //  QQmlComponent component(m_bridge->qmlEngine(), m_path, QQmlComponent::PreferSynchronous);
-  QQmlComponent component(m_bridge->qmlEngine());
-  QByteArray data = QString("import Ubuntu.Components %1\n%2{}").arg(m_version).arg(m_name).toLocal8Bit();
-  component.setData(data, QUrl());
-  if (!component.isReady())
+  QQmlComponent* component = m_bridge->componentForSource(componentSource());
+  if (!component->isReady())
     qCritical() << m_name << "was not ready!";
 
-  QQuickItem* item = qobject_cast<QQuickItem*>(component.create());
+  QQuickItem* item = qobject_cast<QQuickItem*>(component->create());
   if (item == nullptr) {
     qCritical() << "Unable to construct" << m_name;
     return nullptr;
@@ -37,6 +37,8 @@ public:
 
   QQuickItem* view(const QVariantMap& properties) const override;
 
+  QByteArray componentSource() const override;
+
   // void applyProperties(QQuickItem* item, const QVariantMap& properties) const override;
 
 private:
@@ -20,6 +20,7 @@
 
 #include "ubuntudatepickermanager.h"
 #include "reactbridge.h"
+#include "reacteventdispatcher.h"
 #include "reactuimanager.h"
 #include "reactattachedproperties.h"
 #include "reactpropertyhandler.h"
@@ -163,7 +164,6 @@ void DatePickerPropertyHandler::setQmlImplicitHeight(bool qmlImplicitHeight)
 
 UbuntuDatePickerManager::UbuntuDatePickerManager(QObject* parent)
   : ReactViewManager(parent)
-  , m_id(0)
 {
 }
 
@@ -213,22 +213,24 @@ import QtQuick 2.4
 import Ubuntu.Components.Pickers 1.0
 
 DatePicker {
-  id: datepicker%1
+  id: datepicker
 }
 )COMPONENT";
 }
 
-QQuickItem* UbuntuDatePickerManager::view(const QVariantMap& properties) const
+QByteArray UbuntuDatePickerManager::componentSource() const
 {
-  QString componentString = QString(component_qml).arg(m_id++);
+  return QByteArray(component_qml);
+}
 
-  QQmlComponent component(m_bridge->qmlEngine());
-  component.setData(componentString.toLocal8Bit(), QUrl());
-  if (!component.isReady())
+QQuickItem* UbuntuDatePickerManager::view(const QVariantMap& properties) const
+{
+  QQmlComponent* component = m_bridge->componentForSource(componentSource());
+  if (!component->isReady())
     qCritical() << "Component for UbuntuDatePickerManager not ready" <<
-              componentString << component.errors();
+              component->errors();
 
-  QQuickItem* item = qobject_cast<QQuickItem*>(component.create());
+  QQuickItem* item = qobject_cast<QQuickItem*>(component->create());
   if (item == nullptr) {
     qCritical() << "Unable to create component for UbuntuDatePickerManager";
     return nullptr;
@@ -252,10 +254,10 @@ void UbuntuDatePickerManager::onDateChanged()
     return;
   }
   if (ph->onChange()) {
-    m_bridge->enqueueJSCall("RCTEventEmitter", "receiveEvent",
-                            QVariantList{ap->tag(),
-                                         normalizeInputEventName("onChange"),
-                                         QVariantMap{{"timestamp", ph->date().toMSecsSinceEpoch()}}});
+    m_bridge->eventDispatcher()->sendViewEvent(
+      ap->tag(),
+      normalizeInputEventName("onChange"),
+      QVariantList{QVariantMap{{"timestamp", ph->date().toMSecsSinceEpoch()}}});
   }
 }
 
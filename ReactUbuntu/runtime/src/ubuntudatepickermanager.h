@@ -45,12 +45,13 @@ public:
 
   QQuickItem* view(const QVariantMap& properties) const override;
 
+  QByteArray componentSource() const override;
+
 private Q_SLOTS:
   void onDateChanged();
 
 private:
   void configureView(QQuickItem* view) const;
-  mutable int m_id;
 };
 
 #endif // UBUNTUDATEPICKERMANAGER_H
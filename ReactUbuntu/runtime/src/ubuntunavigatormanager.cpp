@@ -20,8 +20,10 @@
 
 #include "ubuntunavigatormanager.h"
 #include "reactbridge.h"
+#include "reacteventdispatcher.h"
 #include "reactuimanager.h"
 #include "reactattachedproperties.h"
+#include "reactflexlayout.h"
 #include "reactpropertyhandler.h"
 #include "reactevents.h"
 
@@ -84,10 +86,35 @@ void UbuntuNavigatorManager::clear(int containerTag)
   invokeMethod("clear()", container);
 }
 
+void UbuntuNavigatorManager::prefetchRoute(int containerTag, int viewTag)
+{
+  QQuickItem* container = m_bridge->uiManager()->viewForTag(containerTag);
+  QQuickItem* view = m_bridge->uiManager()->viewForTag(viewTag);
+  if (container == nullptr || view == nullptr) {
+    // Prefetch is a hint; JS may signal a route whose page has not been
+    // rendered yet, and the eventual push pays full price as before.
+    qWarning() << __PRETTY_FUNCTION__ << "Invalid react tag passed";
+    return;
+  }
+
+  ReactFlexLayout* layout = ReactFlexLayout::get(view, false);
+  if (layout == nullptr)
+    return;
+
+  // Size the page the way the stack will and run its first layout pass now,
+  // while the page is still off-screen; trees whose measures are thread safe
+  // take the async layout path, so the GUI thread keeps rendering. By the
+  // time push() arrives the geometry is settled and the push costs a
+  // reparent plus the transition animation.
+  layout->setWidth(container->width());
+  layout->setHeight(container->height());
+  layout->setDirty(true);
+  ReactFlexLayout::polish(view);
+}
+
 
 UbuntuNavigatorManager::UbuntuNavigatorManager(QObject* parent)
   : ReactViewManager(parent)
-  , m_id(0)
 {
 }
 
@@ -137,47 +164,49 @@ import QtQuick 2.4
 import Ubuntu.Components 1.2
 
 MainView {
-  id: mainView%1
+  id: mainView
   property int numberPages: 0
   signal backTriggered();
   Component {
-    id: pageBackAction%1
+    id: pageBackAction
     Action {
-      iconName: mainView%1.numberPages > 1 ? "back" : ""
+      iconName: mainView.numberPages > 1 ? "back" : ""
     }
   }
   PageStack {
-    id: pageStack%1
+    id: pageStack
     anchors.fill: parent
   }
   function push(item) {
-    item.head.backAction = pageBackAction%1.createObject(item);
+    item.head.backAction = pageBackAction.createObject(item);
     item.head.backAction.onTriggered.connect(backTriggered);
-    pageStack%1.push(item);
-    mainView%1.numberPages += 1;
+    pageStack.push(item);
+    mainView.numberPages += 1;
   }
   function pop() {
-    pageStack%1.pop();
-    mainView%1.numberPages -= 1;
+    pageStack.pop();
+    mainView.numberPages -= 1;
   }
   function clear() {
-    pageStack%1.clear();
+    pageStack.clear();
   }
 }
 )COMPONENT";
 }
 
-QQuickItem* UbuntuNavigatorManager::view(const QVariantMap& properties) const
+QByteArray UbuntuNavigatorManager::componentSource() const
 {
-  QString componentString = QString(component_qml).arg(m_id++);
+  return QByteArray(component_qml);
+}
 
-  QQmlComponent component(m_bridge->qmlEngine());
-  component.setData(componentString.toLocal8Bit(), QUrl());
-  if (!component.isReady())
+QQuickItem* UbuntuNavigatorManager::view(const QVariantMap& properties) const
+{
+  QQmlComponent* component = m_bridge->componentForSource(componentSource());
+  if (!component->isReady())
     qCritical() << "Component for UbuntuNavigatorManager not ready" <<
-              componentString << component.errors();
+              component->errors();
 
-  QQuickItem* item = qobject_cast<QQuickItem*>(component.create());
+  QQuickItem* item = qobject_cast<QQuickItem*>(component->create());
   if (item == nullptr) {
     qCritical() << "Unable to create component for UbuntuNavigatorManager";
     return nullptr;
@@ -201,10 +230,9 @@ void UbuntuNavigatorManager::backTriggered()
     return;
   }
   if (ph->onBackButtonPress()) {
-    m_bridge->enqueueJSCall("RCTEventEmitter", "receiveEvent",
-                            QVariantList{ap->tag(),
-                                         normalizeInputEventName("onBackButtonPress"),
-                                         QVariantMap{}});
+    m_bridge->eventDispatcher()->sendViewEvent(ap->tag(),
+                                               normalizeInputEventName("onBackButtonPress"),
+                                               QVariantList{QVariantMap{}});
   }
 }
 
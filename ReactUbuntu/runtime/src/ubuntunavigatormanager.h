@@ -31,6 +31,7 @@ class UbuntuNavigatorManager : public ReactViewManager
   Q_INVOKABLE void push(int containerTag, int viewTag);
   Q_INVOKABLE void pop(int containerTag);
   Q_INVOKABLE void clear(int containerTag);
+  Q_INVOKABLE void prefetchRoute(int containerTag, int viewTag);
 
 public:
   UbuntuNavigatorManager(QObject* parent = 0);
@@ -49,6 +50,8 @@ public:
 
   QQuickItem* view(const QVariantMap& properties) const override;
 
+  QByteArray componentSource() const override;
+
 private Q_SLOTS:
   void backTriggered();
 
@@ -59,7 +62,6 @@ private:
                     const QVariantList& args = QVariantList{});
   QMetaMethod findMethod(const QString& methodSignature, QQuickItem* item);
 
-  mutable int m_id;
   QMap<QPair<QString, QQuickItem*>, QMetaMethod> m_methodCache;
 };
 
@@ -63,7 +63,6 @@ void PagePropertyHandler::setQmlAnchors(bool qmlAnchors)
 
 UbuntuPageManager::UbuntuPageManager(QObject* parent)
   : ReactViewManager(parent)
-  , m_id(0)
 {
 }
 
@@ -108,22 +107,24 @@ import QtQuick 2.4
 import Ubuntu.Components 1.2
 
 Page {
-  id: page%1
+  id: page
   visible: false
 }
 )COMPONENT";
 }
 
-QQuickItem* UbuntuPageManager::view(const QVariantMap& properties) const
+QByteArray UbuntuPageManager::componentSource() const
 {
-  QString componentString = QString(component_qml).arg(m_id++);
+  return QByteArray(component_qml);
+}
 
-  QQmlComponent component(m_bridge->qmlEngine());
-  component.setData(componentString.toLocal8Bit(), QUrl());
-  if (!component.isReady())
-    qCritical() << "Component for UbuntuPageManager not ready" << component.errors();
+QQuickItem* UbuntuPageManager::view(const QVariantMap& properties) const
+{
+  QQmlComponent* component = m_bridge->componentForSource(componentSource());
+  if (!component->isReady())
+    qCritical() << "Component for UbuntuPageManager not ready" << component->errors();
 
-  QQuickItem* item = qobject_cast<QQuickItem*>(component.create());
+  QQuickItem* item = qobject_cast<QQuickItem*>(component->create());
   if (item == nullptr) {
     qCritical() << "Unable to create component for UbuntuPageManager";
     return nullptr;
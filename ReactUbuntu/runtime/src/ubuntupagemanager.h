@@ -42,6 +42,8 @@ public:
 
   QQuickItem* view(const QVariantMap& properties) const override;
 
+  QByteArray componentSource() const override;
+
 private Q_SLOTS:
   void widthChanged();
   void heightChanged();
@@ -49,7 +51,6 @@ private Q_SLOTS:
 private:
   void configureView(QQuickItem* view) const;
 
-  mutable int m_id;
   QMap<QPair<QString, QQuickItem*>, QMetaMethod> m_methodCache;
 };
 
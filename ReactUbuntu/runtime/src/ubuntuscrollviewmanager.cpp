@@ -11,6 +11,8 @@
  *
  */
 
+#include <limits>
+
 #include <QString>
 #include <QVariant>
 #include <QQmlComponent>
@@ -22,6 +24,7 @@
 #include "reactevents.h"
 #include "ubuntuscrollviewmanager.h"
 #include "reactbridge.h"
+#include "reacteventdispatcher.h"
 #include "reactuimanager.h"
 #include "reactpropertyhandler.h"
 #include "reactevents.h"
@@ -30,15 +33,30 @@
 class ScrollViewPropertyHandler : public ReactPropertyHandler {
   Q_OBJECT
   Q_PROPERTY(bool onScroll READ onScroll WRITE setOnScroll)
+  Q_PROPERTY(bool onViewportChange READ onViewportChange WRITE setOnViewportChange)
+  Q_PROPERTY(bool removeClippedSubviews READ removeClippedSubviews WRITE setRemoveClippedSubviews)
+  Q_PROPERTY(double overscanMargin READ overscanMargin WRITE setOverscanMargin)
 public:
   ScrollViewPropertyHandler(QObject* object)
     : ReactPropertyHandler(object) {
       m_onScroll = false;
+      m_onViewportChange = false;
+      m_removeClippedSubviews = false;
+      m_overscanMargin = -1;
     }
   bool onScroll() const;
   void setOnScroll(bool backButtonPress);
+  bool onViewportChange() const;
+  void setOnViewportChange(bool onViewportChange);
+  bool removeClippedSubviews() const;
+  void setRemoveClippedSubviews(bool removeClippedSubviews);
+  double overscanMargin() const;
+  void setOverscanMargin(double overscanMargin);
 
   bool m_onScroll;
+  bool m_onViewportChange;
+  bool m_removeClippedSubviews;
+  double m_overscanMargin;
 };
 
 bool ScrollViewPropertyHandler::onScroll() const
@@ -51,6 +69,36 @@ void ScrollViewPropertyHandler::setOnScroll(bool onScroll)
   m_onScroll = onScroll;
 }
 
+bool ScrollViewPropertyHandler::onViewportChange() const
+{
+  return m_onViewportChange;
+}
+
+void ScrollViewPropertyHandler::setOnViewportChange(bool onViewportChange)
+{
+  m_onViewportChange = onViewportChange;
+}
+
+bool ScrollViewPropertyHandler::removeClippedSubviews() const
+{
+  return m_removeClippedSubviews;
+}
+
+void ScrollViewPropertyHandler::setRemoveClippedSubviews(bool removeClippedSubviews)
+{
+  m_removeClippedSubviews = removeClippedSubviews;
+}
+
+double ScrollViewPropertyHandler::overscanMargin() const
+{
+  return m_overscanMargin;
+}
+
+void ScrollViewPropertyHandler::setOverscanMargin(double overscanMargin)
+{
+  m_overscanMargin = overscanMargin;
+}
+
 
 void UbuntuScrollViewManager::scrollTo(
   int reactTag,
@@ -65,6 +113,49 @@ void UbuntuScrollViewManager::scrollTo(
   QQmlProperty(item, "contentY").write(offsetY);
 }
 
+void UbuntuScrollViewManager::bindScrollOffset(
+  int reactTag,
+  int targetTag,
+  const QString& targetProperty,
+  const QVariantMap& spec
+) {
+  ScrollBinding binding;
+  binding.targetTag = targetTag;
+  binding.property = targetProperty;
+  binding.vertical = spec.value("axis", "y").toString() != "x";
+  binding.factor = spec.contains("factor") ? spec.value("factor").toDouble() : 1;
+  binding.constant = spec.value("constant").toDouble();
+  binding.minimum = spec.contains("min")
+    ? spec.value("min").toDouble() : -std::numeric_limits<double>::infinity();
+  binding.maximum = spec.contains("max")
+    ? spec.value("max").toDouble() : std::numeric_limits<double>::infinity();
+
+  // Rebinding the same target property replaces the old expression.
+  unbindScrollOffset(reactTag, targetTag, targetProperty);
+  m_scrollBindings[reactTag].append(binding);
+
+  // Apply once immediately so the target does not wait for the next scroll.
+  QQuickItem* item = m_bridge->uiManager()->viewForTag(reactTag);
+  if (item != nullptr)
+    applyScrollBindings(reactTag, item);
+}
+
+void UbuntuScrollViewManager::unbindScrollOffset(
+  int reactTag,
+  int targetTag,
+  const QString& targetProperty
+) {
+  QList<ScrollBinding>& bindings = m_scrollBindings[reactTag];
+  for (int i = bindings.size() - 1; i >= 0; --i) {
+    if (bindings[i].targetTag == targetTag &&
+        (targetProperty.isEmpty() || bindings[i].property == targetProperty)) {
+      bindings.removeAt(i);
+    }
+  }
+  if (bindings.isEmpty())
+    m_scrollBindings.remove(reactTag);
+}
+
 
 UbuntuScrollViewManager::UbuntuScrollViewManager(QObject* parent)
   : ReactViewManager(parent)
@@ -109,7 +200,8 @@ QVariantMap UbuntuScrollViewManager::constantsToExport()
 QStringList UbuntuScrollViewManager::customDirectEventTypes()
 {
   return QStringList{"scrollBeginDrag", normalizeInputEventName("onScroll"), "scrollEndDrag", "scrollAnimationEnd",
-                     "momentumScrollBegin", "momentumScrollEnd"};
+                     "momentumScrollBegin", "momentumScrollEnd",
+                     normalizeInputEventName("onViewportChange")};
 }
 
 void UbuntuScrollViewManager::addChildItem(QQuickItem* scrollView, QQuickItem* child , int position) const
@@ -139,15 +231,19 @@ Flickable {
 )COMPONENT";
 }
 
+QByteArray UbuntuScrollViewManager::componentSource() const
+{
+  return QByteArray(component_qml);
+}
+
 QQuickItem* UbuntuScrollViewManager::view(const QVariantMap& properties) const
 {
   // qDebug() << __PRETTY_FUNCTION__ << properties;
-  QQmlComponent component(m_bridge->qmlEngine());
-  component.setData(component_qml, QUrl());
-  if (!component.isReady())
+  QQmlComponent* component = m_bridge->componentForSource(componentSource());
+  if (!component->isReady())
     qCritical() << "Component for UbuntuScrollView not ready";
 
-  QQuickItem* item = qobject_cast<QQuickItem*>(component.create());
+  QQuickItem* item = qobject_cast<QQuickItem*>(component->create());
   if (item == nullptr) {
     qCritical() << "Unable to create component for UbuntuScrollViewManager";
     return nullptr;
@@ -171,8 +267,8 @@ void UbuntuScrollViewManager::scrollBeginDrag()
   }
   int reactTag = rap->tag();
 
-  m_bridge->enqueueJSCall("RCTEventEmitter", "receiveEvent",
-                          QVariantList{reactTag, normalizeInputEventName("scrollBeginDrag")});
+  m_bridge->eventDispatcher()->sendViewEvent(reactTag,
+                                             normalizeInputEventName("scrollBeginDrag"));
 }
 
 void UbuntuScrollViewManager::scrollEndDrag()
@@ -188,8 +284,8 @@ void UbuntuScrollViewManager::scrollEndDrag()
   }
   int reactTag = rap->tag();
 
-  m_bridge->enqueueJSCall("RCTEventEmitter", "receiveEvent",
-                          QVariantList{reactTag, normalizeInputEventName("scrollEndDrag")});
+  m_bridge->eventDispatcher()->sendViewEvent(reactTag,
+                                             normalizeInputEventName("scrollEndDrag"));
 }
 
 void UbuntuScrollViewManager::scroll()
@@ -208,10 +304,9 @@ void UbuntuScrollViewManager::scroll()
     return;
   }
   if (ph->onScroll()) {
-    m_bridge->enqueueJSCall("RCTEventEmitter", "receiveEvent",
-                            QVariantList{ap->tag(),
-                                         normalizeInputEventName("onScroll"),
-                                         buildEventData(item)});
+    m_bridge->eventDispatcher()->sendViewEvent(ap->tag(),
+                                               normalizeInputEventName("onScroll"),
+                                               QVariantList{buildEventData(item)});
   }
 }
 
@@ -228,10 +323,9 @@ void UbuntuScrollViewManager::momentumScrollBegin()
   }
   int reactTag = rap->tag();
 
-  m_bridge->enqueueJSCall("RCTEventEmitter", "receiveEvent",
-                          QVariantList{reactTag,
-                                       normalizeInputEventName("momentumScrollBegin"),
-                                       buildEventData(item)});
+  m_bridge->eventDispatcher()->sendViewEvent(reactTag,
+                                             normalizeInputEventName("momentumScrollBegin"),
+                                             QVariantList{buildEventData(item)});
 }
 
 void UbuntuScrollViewManager::momentumScrollEnd()
@@ -247,10 +341,9 @@ void UbuntuScrollViewManager::momentumScrollEnd()
   }
   int reactTag = rap->tag();
 
-  m_bridge->enqueueJSCall("RCTEventEmitter", "receiveEvent",
-                          QVariantList{reactTag,
-                                       normalizeInputEventName("momentumScrollEnd"),
-                                       buildEventData(item)});
+  m_bridge->eventDispatcher()->sendViewEvent(reactTag,
+                                             normalizeInputEventName("momentumScrollEnd"),
+                                             QVariantList{buildEventData(item)});
 }
 
 namespace {
@@ -282,6 +375,95 @@ QVariantMap UbuntuScrollViewManager::buildEventData(QQuickItem* item) const
   return ed;
 }
 
+void UbuntuScrollViewManager::viewportChanged()
+{
+  QQuickItem* item = qobject_cast<QQuickItem*>(sender());
+  Q_ASSERT(item != nullptr);
+
+  ReactAttachedProperties* ap = ReactAttachedProperties::get(item, false);
+  if (ap == nullptr)
+    return;
+
+  // Native scroll bindings run first; sticky headers and parallax track the
+  // offset in the same frame that produced it, with no executor traffic.
+  applyScrollBindings(ap->tag(), item);
+
+  ScrollViewPropertyHandler* ph = qobject_cast<ScrollViewPropertyHandler*>(ap->propertyHandler());
+  if (ph == nullptr)
+    return;
+
+  // Half a viewport of overscan in every direction unless JS asked for a
+  // specific margin; children inside the margin stay live so a normal flick
+  // never reveals a blank row.
+  double margin = ph->overscanMargin();
+  if (margin < 0)
+    margin = item->height() / 2;
+
+  if (ph->onViewportChange()) {
+    QVariantMap ed = buildEventData(item);
+    ed.insert("overscanMargin", margin);
+    m_bridge->eventDispatcher()->sendViewEvent(ap->tag(),
+                                               normalizeInputEventName("onViewportChange"),
+                                               QVariantList{ed});
+  }
+
+  if (ph->removeClippedSubviews())
+    updateClippedSubviews(item, margin);
+
+  // Render-ahead: rows just beyond the overscan region arrive as createView
+  // batches at reveal time, and the fast-fling frame drops came from paying
+  // component instantiation right then. Keep the pools of the row types
+  // under this list topped up during idle slices so the reveal is a cheap
+  // pool take and attach.
+  QQuickItem* contentItem = QQmlProperty(item, "contentItem").read().value<QQuickItem*>();
+  if (contentItem != nullptr)
+    m_bridge->uiManager()->prewarmViewsFor(contentItem);
+}
+
+void UbuntuScrollViewManager::applyScrollBindings(int reactTag, QQuickItem* scrollView)
+{
+  QHash<int, QList<ScrollBinding>>::const_iterator it = m_scrollBindings.constFind(reactTag);
+  if (it == m_scrollBindings.constEnd())
+    return;
+
+  const double x = propertyValue<double>(scrollView, "contentX");
+  const double y = propertyValue<double>(scrollView, "contentY");
+
+  for (const ScrollBinding& binding : it.value()) {
+    QQuickItem* target = m_bridge->uiManager()->viewForTag(binding.targetTag);
+    if (target == nullptr)
+      continue;
+    double value = binding.factor * (binding.vertical ? y : x) + binding.constant;
+    value = qBound(binding.minimum, value, binding.maximum);
+    QQmlProperty(target, binding.property).write(value);
+  }
+}
+
+void UbuntuScrollViewManager::updateClippedSubviews(QQuickItem* scrollView, double overscanMargin) const
+{
+  QQuickItem* contentItem = QQmlProperty(scrollView, "contentItem").read().value<QQuickItem*>();
+  if (contentItem == nullptr)
+    return;
+
+  QRectF viewport(propertyValue<double>(scrollView, "contentX"),
+                  propertyValue<double>(scrollView, "contentY"),
+                  scrollView->width(),
+                  scrollView->height());
+  viewport.adjust(-overscanMargin, -overscanMargin, overscanMargin, overscanMargin);
+
+  // Children outside the overscanned viewport are dropped from the scene
+  // graph via visibility; the item and its flex layout node stay put, so
+  // scrolling them back in is a flag flip rather than a bridge round trip.
+  for (QQuickItem* child : contentItem->childItems()) {
+    if (ReactAttachedProperties::get(child, false) == nullptr)
+      continue;
+    const bool inViewport = viewport.intersects(
+      QRectF(child->x(), child->y(), child->width(), child->height()));
+    if (child->isVisible() != inViewport)
+      child->setVisible(inViewport);
+  }
+}
+
 void UbuntuScrollViewManager::configureView(QQuickItem* view) const
 {
   // This would be prettier with a Functor version, but connect doesnt support it
@@ -291,6 +473,9 @@ void UbuntuScrollViewManager::configureView(QQuickItem* view) const
 
   connect(view, SIGNAL(flickStarted()), SLOT(momentumScrollBegin()));
   connect(view, SIGNAL(flickEnded()), SLOT(momentumScrollEnd()));
+
+  connect(view, SIGNAL(contentXChanged()), SLOT(viewportChanged()));
+  connect(view, SIGNAL(contentYChanged()), SLOT(viewportChanged()));
 }
 
 #include "ubuntuscrollviewmanager.moc"
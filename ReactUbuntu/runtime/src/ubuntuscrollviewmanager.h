@@ -14,6 +14,8 @@
 #ifndef UBUNTUSCROLLVIEWMANAGER_H
 #define UBUNTUSCROLLVIEWMANAGER_H
 
+#include <QHash>
+
 #include "reactviewmanager.h"
 
 // #define QT_STATICPLUGIN
@@ -28,6 +30,13 @@ class UbuntuScrollViewManager : public ReactViewManager
                             double offsetX,
                             double offsetY,
                             bool animated);
+  Q_INVOKABLE void bindScrollOffset(int reactTag,
+                                    int targetTag,
+                                    const QString& targetProperty,
+                                    const QVariantMap& spec);
+  Q_INVOKABLE void unbindScrollOffset(int reactTag,
+                                      int targetTag,
+                                      const QString& targetProperty);
 
 public:
   UbuntuScrollViewManager(QObject* parent = 0);
@@ -48,6 +57,8 @@ public:
 
   QQuickItem* view(const QVariantMap& properties) const override;
 
+  QByteArray componentSource() const override;
+
 private Q_SLOTS:
   void scrollBeginDrag();
   void scrollEndDrag();
@@ -56,9 +67,28 @@ private Q_SLOTS:
   void momentumScrollBegin();
   void momentumScrollEnd();
 
+  void viewportChanged();
+
 private:
+  // One native binding of a target view property to the scroll offset:
+  // value = clamp(factor * offset + constant, minimum, maximum). Registered
+  // once from JS and driven entirely on this side of the executor.
+  struct ScrollBinding {
+    int targetTag;
+    QString property;
+    bool vertical;
+    double factor;
+    double constant;
+    double minimum;
+    double maximum;
+  };
+
   QVariantMap buildEventData(QQuickItem* item) const;
+  void applyScrollBindings(int reactTag, QQuickItem* scrollView);
+  void updateClippedSubviews(QQuickItem* scrollView, double overscanMargin) const;
   void configureView(QQuickItem* view) const;
+
+  QHash<int, QList<ScrollBinding>> m_scrollBindings;
 };
 
 #endif // UBUNTUSCROLLVIEWMANAGER_H
@@ -13,8 +13,10 @@
 
 #include <QString>
 #include <QVariant>
+#include <QPointer>
 #include <QQmlComponent>
 #include <QQuickItem>
+#include <QTimer>
 
 #include <QDebug>
 
@@ -22,6 +24,7 @@
 #include "reactevents.h"
 #include "ubuntutextfieldmanager.h"
 #include "reactbridge.h"
+#include "reacteventdispatcher.h"
 #include "reactpropertyhandler.h"
 #include "reactevents.h"
 
@@ -39,15 +42,11 @@ void setPropertyValue(QQuickItem* item, const QString& property, const TP& value
   QQmlProperty(item, property).write(QVariant::fromValue(value));
 }
 
-QVariantMap buildEventData(QQuickItem* item)
+QVariantMap buildEventData(QQuickItem* item, int revision)
 {
-  static int eventCount = 0;
-
-  eventCount++; // XXX:
-
   return QVariantMap{
     { "text", propertyValue<QString>(item, "text") },
-    { "eventCount", eventCount },
+    { "eventCount", revision },
   };
 }
 }
@@ -58,6 +57,8 @@ class TextFieldPropertyHandler : public ReactPropertyHandler {
   Q_PROPERTY(bool onFocus READ onFocus WRITE setOnFocus)
   Q_PROPERTY(bool onChange READ onChange WRITE setOnChange)
   Q_PROPERTY(double fontSize READ fontSize WRITE setFontSize)
+  Q_PROPERTY(QString text READ text WRITE setText)
+  Q_PROPERTY(int mostRecentEventCount READ mostRecentEventCount WRITE setMostRecentEventCount)
 public:
   TextFieldPropertyHandler(QObject* object)
     : ReactPropertyHandler(object) {
@@ -72,6 +73,28 @@ public:
 
   double fontSize() const;
   void setFontSize(double fontSize);
+
+  QString text() const;
+  void setText(const QString& text);
+
+  int mostRecentEventCount() const;
+  void setMostRecentEventCount(int eventCount);
+
+  // The field owns its text natively: every user edit bumps the native
+  // revision, change events carry it as eventCount, and a JS value write
+  // lands only when JS has acknowledged the latest native edit - a slow
+  // executor echoing stale state can no longer clobber characters typed in
+  // the meantime.
+  int m_nativeRevision = 0;
+  int m_jsRevision = 0;
+  bool m_applyingJsValue = false;
+  bool m_changePending = false;
+
+private:
+  void writeText(const QString& text);
+
+  QString m_pendingJsText;
+  bool m_hasPendingJsText = false;
 };
 
 bool TextFieldPropertyHandler::onFocus() const
@@ -104,6 +127,50 @@ void TextFieldPropertyHandler::setFontSize(double fontSize)
   setPropertyValue(qobject_cast<QQuickItem*>(m_object), "font.pointSize", fontSize);
 }
 
+QString TextFieldPropertyHandler::text() const
+{
+  return propertyValue<QString>(qobject_cast<QQuickItem*>(m_object), "text");
+}
+
+void TextFieldPropertyHandler::setText(const QString& text)
+{
+  // QVariantMap applies in key order, so mostRecentEventCount has already
+  // landed when the batch carries both.
+  if (m_jsRevision != m_nativeRevision) {
+    // Computed before the user's latest edits; park it until JS
+    // acknowledges the current revision.
+    m_pendingJsText = text;
+    m_hasPendingJsText = true;
+    return;
+  }
+  writeText(text);
+}
+
+void TextFieldPropertyHandler::writeText(const QString& text)
+{
+  m_hasPendingJsText = false;
+  if (text == this->text())
+    return;
+  m_applyingJsValue = true;
+  setPropertyValue(qobject_cast<QQuickItem*>(m_object), "text", text);
+  m_applyingJsValue = false;
+}
+
+int TextFieldPropertyHandler::mostRecentEventCount() const
+{
+  return m_jsRevision;
+}
+
+void TextFieldPropertyHandler::setMostRecentEventCount(int eventCount)
+{
+  m_jsRevision = eventCount;
+  // applyProperties skips values unchanged since the last apply, so a
+  // controlled value rejected as stale would never be resent on its own;
+  // apply the parked value once JS catches up to the revision.
+  if (m_hasPendingJsText && m_jsRevision == m_nativeRevision)
+    writeText(m_pendingJsText);
+}
+
 
 UbuntuTextFieldManager::UbuntuTextFieldManager(QObject* parent)
   : ReactViewManager(parent)
@@ -161,14 +228,18 @@ TextField {
 )COMPONENT";
 }
 
+QByteArray UbuntuTextFieldManager::componentSource() const
+{
+  return QByteArray(component_qml);
+}
+
 QQuickItem* UbuntuTextFieldManager::view(const QVariantMap& properties) const
 {
-  QQmlComponent component(m_bridge->qmlEngine());
-  component.setData(component_qml, QUrl());
-  if (!component.isReady())
+  QQmlComponent* component = m_bridge->componentForSource(componentSource());
+  if (!component->isReady())
     qCritical() << "Component for UbuntuScrollView not ready";
 
-  QQuickItem* item = qobject_cast<QQuickItem*>(component.create());
+  QQuickItem* item = qobject_cast<QQuickItem*>(component->create());
   if (item == nullptr) {
     qCritical() << "Unable to create component for UbuntuTextFieldManager";
     return nullptr;
@@ -195,10 +266,9 @@ void UbuntuTextFieldManager::activeFocusChanged()
     return;
   }
   if (ph->onFocus()) {
-    m_bridge->enqueueJSCall("RCTEventEmitter", "receiveEvent",
-                            QVariantList{ap->tag(),
-                                         normalizeInputEventName("onFocus"),
-                                         QVariantMap{}});
+    m_bridge->eventDispatcher()->sendViewEvent(ap->tag(),
+                                               normalizeInputEventName("onFocus"),
+                                               QVariantList{QVariantMap{}});
   }
 }
 
@@ -217,12 +287,28 @@ void UbuntuTextFieldManager::textChanged()
     qCritical() << __PRETTY_FUNCTION__ << "failed to find TextFieldPropertyHandler";
     return;
   }
-  if (ph->onChange()) {
-    m_bridge->enqueueJSCall("RCTEventEmitter", "receiveEvent",
-                            QVariantList{ap->tag(),
-                                         normalizeInputEventName("onChange"),
-                                         buildEventData(item)});
-  }
+  if (ph->m_applyingJsValue)
+    return; // echo of a JS value write, not a user edit
+  ph->m_nativeRevision += 1;
+  if (!ph->onChange())
+    return;
+
+  // One change event per event-loop turn however fast input arrives; the
+  // event carries the burst's final text and revision, so JS sees state it
+  // can acknowledge instead of a backlog of intermediate keystrokes.
+  if (ph->m_changePending)
+    return;
+  ph->m_changePending = true;
+  const int tag = ap->tag();
+  QPointer<TextFieldPropertyHandler> guard(ph);
+  QTimer::singleShot(0, this, [=] {
+    if (guard.isNull())
+      return;
+    guard->m_changePending = false;
+    m_bridge->eventDispatcher()->sendViewEvent(tag,
+                                               normalizeInputEventName("onChange"),
+                                               QVariantList{buildEventData(item, guard->m_nativeRevision)});
+  });
 }
 
 void UbuntuTextFieldManager::configureView(QQuickItem* view) const
@@ -39,6 +39,8 @@ public:
 
   QQuickItem* view(const QVariantMap& properties) const override;
 
+  QByteArray componentSource() const override;
+
 private Q_SLOTS:
   void activeFocusChanged();
   void textChanged();